@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// CopyTest.java
+//
+// Identification: script/testing/junit/CopyTest.java
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * COPY FROM STDIN and COPY TO STDOUT over the connection.
+ */
+
+import java.io.StringReader;
+import java.io.StringWriter;
+import java.sql.*;
+import org.junit.*;
+import org.postgresql.copy.CopyManager;
+import org.postgresql.core.BaseConnection;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+import static org.junit.Assert.fail;
+
+public class CopyTest extends PLTestBase {
+    private Connection conn;
+
+    private static final int NUM_ROWS = 5000;
+
+    private static final String SQL_DROP_TABLE =
+            "DROP TABLE IF EXISTS tbl;";
+
+    private static final String SQL_CREATE_TABLE =
+            "CREATE TABLE tbl (" +
+                    "c1 int NOT NULL PRIMARY KEY, " +
+                    "c2 varchar(32));";
+
+    @Before
+    public void Setup() throws SQLException {
+        conn = makeDefaultConnection();
+        conn.setAutoCommit(true);
+        Statement stmt = conn.createStatement();
+        stmt.execute(SQL_DROP_TABLE);
+        stmt.execute(SQL_CREATE_TABLE);
+    }
+
+    @After
+    public void Teardown() throws SQLException {
+        Statement stmt = conn.createStatement();
+        stmt.execute(SQL_DROP_TABLE);
+    }
+
+    /**
+     * The CSV data of the rows, with values that need quotes
+     */
+    private static String makeData() {
+        StringBuilder data = new StringBuilder();
+        for (int i = 0; i < NUM_ROWS; i++) {
+            data.append(i).append(",\"val, ").append(i).append("\"\n");
+        }
+        return data.toString();
+    }
+
+    @Test
+    public void testCopyIn() throws Exception {
+        CopyManager copy = new CopyManager((BaseConnection) conn);
+        long num_rows = copy.copyIn("COPY tbl FROM STDIN",
+                                    new StringReader(makeData()));
+        assertEquals(NUM_ROWS, num_rows);
+
+        Statement stmt = conn.createStatement();
+        ResultSet rs = stmt.executeQuery("SELECT c2 FROM tbl WHERE c1 = 42;");
+        assertTrue(rs.next());
+        assertEquals("val, 42", rs.getString(1));
+        assertNoMoreRows(rs);
+    }
+
+    @Test
+    public void testCopyOut() throws Exception {
+        CopyManager copy = new CopyManager((BaseConnection) conn);
+        copy.copyIn("COPY tbl FROM STDIN", new StringReader(makeData()));
+
+        StringWriter out = new StringWriter();
+        long num_rows = copy.copyOut("COPY tbl TO STDOUT", out);
+        assertEquals(NUM_ROWS, num_rows);
+
+        // The rows may come in any order
+        String [] lines = out.toString().split("\n");
+        assertEquals(NUM_ROWS, lines.length);
+        boolean [] seen = new boolean[NUM_ROWS];
+        for (String line : lines) {
+            int c1 = Integer.parseInt(line.substring(0, line.indexOf(',')));
+            assertEquals(c1 + ",\"val, " + c1 + "\"", line);
+            assertTrue(!seen[c1]);
+            seen[c1] = true;
+        }
+    }
+
+    /**
+     * Malformed data fails the COPY, and the connection goes on
+     */
+    @Test
+    public void testCopyInError() throws Exception {
+        CopyManager copy = new CopyManager((BaseConnection) conn);
+        try {
+            copy.copyIn("COPY tbl FROM STDIN",
+                        new StringReader("1,\"unterminated\n"));
+            fail();
+        } catch (SQLException e) {
+        }
+
+        Statement stmt = conn.createStatement();
+        ResultSet rs = stmt.executeQuery("SELECT COUNT(*) FROM tbl;");
+        assertTrue(rs.next());
+        assertEquals(0, rs.getInt(1));
+    }
+}
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// FetchSizeTest.java
+//
+// Identification: script/testing/junit/FetchSizeTest.java
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * Incremental fetch of query results, with a fetch size.
+ */
+
+import java.sql.*;
+import org.junit.*;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+public class FetchSizeTest extends PLTestBase {
+    private Connection conn;
+
+    private static final int NUM_ROWS = 2500;
+
+    private static final String SQL_DROP_TABLE =
+            "DROP TABLE IF EXISTS tbl;";
+
+    private static final String SQL_CREATE_TABLE =
+            "CREATE TABLE tbl (" +
+                    "c1 int NOT NULL PRIMARY KEY, " +
+                    "c2 int);";
+
+    /**
+     * Initialize the database and table for testing
+     */
+    private void InitDatabase() throws SQLException {
+        Statement stmt = conn.createStatement();
+        stmt.execute(SQL_DROP_TABLE);
+        stmt.execute(SQL_CREATE_TABLE);
+
+        PreparedStatement pstmt =
+            conn.prepareStatement("INSERT INTO tbl VALUES (?, ?);");
+        for (int i = 0; i < NUM_ROWS; i++) {
+            setValues(pstmt, new int [] {i, i * 10});
+            pstmt.addBatch();
+        }
+        pstmt.executeBatch();
+    }
+
+    @Before
+    public void Setup() throws SQLException {
+        conn = makeDefaultConnection();
+        conn.setAutoCommit(true);
+        InitDatabase();
+    }
+
+    @After
+    public void Teardown() throws SQLException {
+        conn.setAutoCommit(true);
+        Statement stmt = conn.createStatement();
+        stmt.execute(SQL_DROP_TABLE);
+    }
+
+    /**
+     * Read the whole table through the given statement, and check that
+     * every row arrives exactly once.
+     */
+    private void checkAllRows(PreparedStatement pstmt) throws SQLException {
+        boolean [] seen = new boolean[NUM_ROWS];
+        int num_rows = 0;
+        ResultSet rs = pstmt.executeQuery();
+        while (rs.next()) {
+            int c1 = rs.getInt("c1");
+            assertEquals(c1 * 10, rs.getInt("c2"));
+            assertTrue(!seen[c1]);
+            seen[c1] = true;
+            num_rows++;
+        }
+        assertEquals(NUM_ROWS, num_rows);
+        rs.close();
+    }
+
+    /**
+     * The driver only fetches rows in pages inside a transaction. Every
+     * page suspends the portal until the next one is asked for.
+     */
+    @Test
+    public void testFetchSize() throws SQLException {
+        conn.setAutoCommit(false);
+        PreparedStatement pstmt = conn.prepareStatement("SELECT * FROM tbl;");
+        pstmt.setFetchSize(100);
+        checkAllRows(pstmt);
+        conn.commit();
+    }
+
+    /**
+     * A page size that is not a divisor of the result size, and smaller
+     * than the batches of rows the server produces.
+     */
+    @Test
+    public void testOddFetchSize() throws SQLException {
+        conn.setAutoCommit(false);
+        PreparedStatement pstmt = conn.prepareStatement("SELECT * FROM tbl;");
+        pstmt.setFetchSize(7);
+        checkAllRows(pstmt);
+        conn.commit();
+    }
+
+    /**
+     * The transaction goes on once the portal is read up.
+     */
+    @Test
+    public void testFetchThenQuery() throws SQLException {
+        conn.setAutoCommit(false);
+        PreparedStatement pstmt = conn.prepareStatement("SELECT * FROM tbl;");
+        pstmt.setFetchSize(1000);
+        checkAllRows(pstmt);
+
+        Statement stmt = conn.createStatement();
+        ResultSet rs = stmt.executeQuery("SELECT c2 FROM tbl WHERE c1 = 42;");
+        assertTrue(rs.next());
+        assertEquals(420, rs.getInt(1));
+        assertNoMoreRows(rs);
+        conn.commit();
+    }
+}
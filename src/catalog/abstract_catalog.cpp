@@ -17,6 +17,7 @@
 #include "catalog/catalog.h"
 #include "catalog/database_catalog.h"
 #include "catalog/table_catalog.h"
+#include "concurrency/transaction_context.h"
 
 #include "index/index_factory.h"
 #include "optimizer/optimizer.h"
@@ -48,7 +49,8 @@ namespace catalog {
 AbstractCatalog::AbstractCatalog(storage::Database *pg_catalog,
                                  catalog::Schema *catalog_table_schema,
                                  oid_t catalog_table_oid,
-                                 std::string catalog_table_name) {
+                                 std::string catalog_table_name)
+    : is_cached_(true) {
   // set database_oid
   database_oid_ = pg_catalog->GetOid();
   // Create catalog_table_
@@ -102,6 +104,7 @@ bool AbstractCatalog::InsertTuple(concurrency::TransactionContext *txn,
                                   std::unique_ptr<storage::Tuple> tuple) {
   if (txn == nullptr)
     throw CatalogException("Insert tuple requires transaction");
+  if (is_cached_) txn->catalog_cache.SetModified();
 
   std::vector<type::Value> params;
   std::vector<std::string> columns;
@@ -143,6 +146,7 @@ bool AbstractCatalog::DeleteWithIndexScan(concurrency::TransactionContext *txn,
                                           std::vector<type::Value> values) {
   if (txn == nullptr)
     throw CatalogException("Delete tuple requires transaction");
+  if (is_cached_) txn->catalog_cache.SetModified();
 
   std::unique_ptr<executor::ExecutorContext> context(
       new executor::ExecutorContext(txn));
@@ -317,6 +321,7 @@ bool AbstractCatalog::UpdateWithIndexScan(concurrency::TransactionContext *txn,
                                           std::vector<oid_t> update_columns,
                                           std::vector<type::Value> update_values) {
   if (txn == nullptr) throw CatalogException("Scan table requires transaction");
+  if (is_cached_) txn->catalog_cache.SetModified();
 
   std::unique_ptr<executor::ExecutorContext> context(
       new executor::ExecutorContext(txn));
@@ -56,6 +56,7 @@ bool CatalogCache::InsertDatabaseObject(
  * @return  true if database_oid is found and evicted; false if not found
  */
 bool CatalogCache::EvictDatabaseObject(oid_t database_oid) {
+  modified_ = true;
   auto it = database_objects_cache_.find(database_oid);
   if (it == database_objects_cache_.end()) {
     return false;  // database oid not found in cache
@@ -73,6 +74,7 @@ bool CatalogCache::EvictDatabaseObject(oid_t database_oid) {
  * @return  true if database_name is found and evicted; false if not found
  */
 bool CatalogCache::EvictDatabaseObject(const std::string &database_name) {
+  modified_ = true;
   auto it = database_name_cache_.find(database_name);
   if (it == database_name_cache_.end()) {
     return false;  // database name not found in cache
@@ -93,7 +95,10 @@ std::shared_ptr<DatabaseCatalogEntry> CatalogCache::GetDatabaseObject(
     oid_t database_oid) {
   auto it = database_objects_cache_.find(database_oid);
   if (it == database_objects_cache_.end()) {
-    return nullptr;
+    if (!IsShareable()) return nullptr;
+    return InsertSharedDatabaseObject(
+        SharedCatalogCache::GetInstance().GetDatabaseObject(version_,
+                                                            database_oid));
   }
   return it->second;
 }
@@ -106,11 +111,29 @@ std::shared_ptr<DatabaseCatalogEntry> CatalogCache::GetDatabaseObject(
     const std::string &database_name) {
   auto it = database_name_cache_.find(database_name);
   if (it == database_name_cache_.end()) {
-    return nullptr;
+    if (!IsShareable()) return nullptr;
+    return InsertSharedDatabaseObject(
+        SharedCatalogCache::GetInstance().GetDatabaseObject(version_,
+                                                            database_name));
   }
   return it->second;
 }
 
+/*@brief   copy database catalog object of the shared cache into this cache
+ * @param   shared_object
+ * @return  database catalog object of this transaction; null if not shared
+ */
+std::shared_ptr<DatabaseCatalogEntry> CatalogCache::InsertSharedDatabaseObject(
+    std::shared_ptr<DatabaseCatalogEntry> shared_object) {
+  if (shared_object == nullptr) return nullptr;
+  auto database_object =
+      std::make_shared<DatabaseCatalogEntry>(txn_, shared_object);
+  bool success = InsertDatabaseObject(database_object);
+  PELOTON_ASSERT(success == true);
+  (void)success;
+  return database_object;
+}
+
 /*@brief   search table catalog object from all cached database objects
  * @param   table_oid
  * @return  table catalog object; if not found return null
@@ -152,5 +175,120 @@ std::shared_ptr<IndexCatalogEntry> CatalogCache::GetCachedIndexObject(const std:
   return nullptr;
 }
 
+SharedCatalogCache &SharedCatalogCache::GetInstance() {
+  static SharedCatalogCache shared_catalog_cache;
+  return shared_catalog_cache;
+}
+
+void SharedCatalogCache::BeginInvalidation() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_invalidating_++;
+  Invalidate();
+}
+
+void SharedCatalogCache::EndInvalidation() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PELOTON_ASSERT(num_invalidating_ > 0);
+  num_invalidating_--;
+  Invalidate();
+}
+
+void SharedCatalogCache::Invalidate() {
+  num_changes_++;
+  version_.store((num_changes_ << 1) | (num_invalidating_ > 0 ? 1 : 0));
+  std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>());
+}
+
+/*@brief   get shared database catalog object
+ * @param   version   the catalog version the transaction began at
+ * @param   database_oid
+ * @return  database catalog object; null if not shared at that version
+ */
+std::shared_ptr<DatabaseCatalogEntry> SharedCatalogCache::GetDatabaseObject(
+    uint64_t version, oid_t database_oid) {
+  auto snapshot = std::atomic_load(&snapshot_);
+  if (snapshot == nullptr || snapshot->version != version) return nullptr;
+  auto it = snapshot->database_objects.find(database_oid);
+  if (it == snapshot->database_objects.end()) return nullptr;
+  return it->second;
+}
+
+/*@brief   get shared database catalog object
+ * @param   version   the catalog version the transaction began at
+ * @param   database_name
+ * @return  database catalog object; null if not shared at that version
+ */
+std::shared_ptr<DatabaseCatalogEntry> SharedCatalogCache::GetDatabaseObject(
+    uint64_t version, const std::string &database_name) {
+  auto snapshot = std::atomic_load(&snapshot_);
+  if (snapshot == nullptr || snapshot->version != version) return nullptr;
+  auto it = snapshot->database_names.find(database_name);
+  if (it == snapshot->database_names.end()) return nullptr;
+  return it->second;
+}
+
+bool SharedCatalogCache::HasEntriesToShare(
+    const CatalogCache &cache,
+    const std::shared_ptr<const Snapshot> &snapshot) {
+  for (auto &it : cache.database_objects_cache_) {
+    std::shared_ptr<DatabaseCatalogEntry> shared_object;
+    if (snapshot != nullptr && snapshot->version == cache.version_) {
+      auto shared_it = snapshot->database_objects.find(it.first);
+      if (shared_it != snapshot->database_objects.end()) {
+        shared_object = shared_it->second;
+      }
+    }
+    if (it.second->HasEntriesToShare(shared_object)) return true;
+  }
+  return false;
+}
+
+void SharedCatalogCache::Publish(const CatalogCache &cache) {
+  PELOTON_ASSERT(cache.IsShareable());
+  // most transactions only look up what is shared already, so they are done
+  // without taking the lock
+  if (cache.version_ != version_.load() ||
+      !HasEntriesToShare(cache, std::atomic_load(&snapshot_))) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // the catalog changed since the transaction began, its entries may be stale
+  if (cache.version_ != version_.load()) return;
+
+  // the snapshot is dropped on every version change, so it is at this version
+  auto snapshot = std::atomic_load(&snapshot_);
+  std::shared_ptr<Snapshot> new_snapshot;
+  for (auto &it : cache.database_objects_cache_) {
+    std::shared_ptr<DatabaseCatalogEntry> shared_object;
+    if (snapshot != nullptr) {
+      auto shared_it = snapshot->database_objects.find(it.first);
+      if (shared_it != snapshot->database_objects.end()) {
+        shared_object = shared_it->second;
+      }
+    }
+
+    auto database_object = it.second->MergeForSharing(shared_object);
+    if (database_object == nullptr) continue;  // nothing new
+
+    // copy on write
+    if (new_snapshot == nullptr) {
+      new_snapshot = (snapshot == nullptr)
+                         ? std::make_shared<Snapshot>()
+                         : std::make_shared<Snapshot>(*snapshot);
+      new_snapshot->version = cache.version_;
+    }
+    new_snapshot->database_objects[database_object->GetDatabaseOid()] =
+        database_object;
+    new_snapshot->database_names[database_object->GetDatabaseName()] =
+        database_object;
+  }
+
+  if (new_snapshot != nullptr) {
+    std::atomic_store(&snapshot_,
+                      std::shared_ptr<const Snapshot>(std::move(new_snapshot)));
+  }
+}
+
 }  // namespace catalog
 }  // namespace peloton
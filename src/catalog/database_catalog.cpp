@@ -36,6 +36,116 @@ DatabaseCatalogEntry::DatabaseCatalogEntry(concurrency::TransactionContext *txn,
       valid_table_catalog_entries(false),
       txn_(txn) {}
 
+DatabaseCatalogEntry::DatabaseCatalogEntry(
+    concurrency::TransactionContext *txn,
+    std::shared_ptr<DatabaseCatalogEntry> shared_entry)
+    : database_oid_(shared_entry->database_oid_),
+      database_name_(shared_entry->database_name_),
+      table_catalog_entries_cache_(),
+      table_catalog_entries_cache_by_name(),
+      valid_table_catalog_entries(false),
+      txn_(txn),
+      shared_entry_(std::move(shared_entry)) {}
+
+/* @brief   whether a cache miss can be served by the shared catalog cache,
+ *          that is until the transaction writes the catalog
+ */
+bool DatabaseCatalogEntry::UseSharedEntry() {
+  return shared_entry_ != nullptr && txn_->catalog_cache.IsShareable();
+}
+
+/* @brief   copy table catalog object of the shared cache into this cache
+ * @param   shared_table_entry
+ * @return  table catalog object of this transaction
+ */
+std::shared_ptr<TableCatalogEntry>
+DatabaseCatalogEntry::InsertSharedTableCatalogEntry(
+    const std::shared_ptr<TableCatalogEntry> &shared_table_entry) {
+  // the index, column, layout and constraint entries are never changed, so
+  // the copy can point to the same ones
+  auto table_object = std::make_shared<TableCatalogEntry>(*shared_table_entry);
+  table_object->txn_ = txn_;
+  bool success = InsertTableCatalogEntry(table_object);
+  PELOTON_ASSERT(success == true);
+  (void)success;
+  return table_object;
+}
+
+/* @brief   whether merging this object into the shared one adds anything
+ * @param   shared_entry   the shared object, null if there is none
+ * @return  false if the shared object has all that this object has cached
+ */
+bool DatabaseCatalogEntry::HasEntriesToShare(
+    const std::shared_ptr<DatabaseCatalogEntry> &shared_entry) {
+  if (shared_entry == nullptr) return true;
+  if (valid_table_catalog_entries &&
+      !shared_entry->valid_table_catalog_entries) {
+    return true;
+  }
+  auto &shared_tables = shared_entry->table_catalog_entries_cache_;
+  for (auto &it : table_catalog_entries_cache_) {
+    auto shared_it = shared_tables.find(it.first);
+    if (shared_it == shared_tables.end() ||
+        shared_it->second->GetCachedEntryCount() <
+            it.second->GetCachedEntryCount()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* @brief   merge this object into the shared one, taking the table catalog
+ *          objects this transaction has cached more entries of
+ * @param   shared_entry   the shared object, null if there is none
+ * @return  the merged object, without transaction; null if there is nothing
+ *          to add to the shared object
+ */
+std::shared_ptr<DatabaseCatalogEntry> DatabaseCatalogEntry::MergeForSharing(
+    const std::shared_ptr<DatabaseCatalogEntry> &shared_entry) {
+  if (!HasEntriesToShare(shared_entry)) return nullptr;
+
+  std::vector<std::shared_ptr<TableCatalogEntry>> new_table_entries;
+  for (auto &it : table_catalog_entries_cache_) {
+    if (shared_entry != nullptr) {
+      auto &shared_tables = shared_entry->table_catalog_entries_cache_;
+      auto shared_it = shared_tables.find(it.first);
+      if (shared_it != shared_tables.end() &&
+          shared_it->second->GetCachedEntryCount() >=
+              it.second->GetCachedEntryCount()) {
+        continue;
+      }
+    }
+    new_table_entries.push_back(it.second);
+  }
+  bool valid = valid_table_catalog_entries ||
+               (shared_entry != nullptr &&
+                shared_entry->valid_table_catalog_entries);
+
+  auto database_object = std::make_shared<DatabaseCatalogEntry>(*this);
+  database_object->txn_ = nullptr;
+  database_object->shared_entry_ = nullptr;
+  database_object->valid_table_catalog_entries = valid;
+  if (shared_entry != nullptr) {
+    database_object->table_catalog_entries_cache_ =
+        shared_entry->table_catalog_entries_cache_;
+    database_object->table_catalog_entries_cache_by_name =
+        shared_entry->table_catalog_entries_cache_by_name;
+  } else {
+    database_object->table_catalog_entries_cache_.clear();
+    database_object->table_catalog_entries_cache_by_name.clear();
+  }
+  for (auto &table_entry : new_table_entries) {
+    auto table_object = std::make_shared<TableCatalogEntry>(*table_entry);
+    table_object->txn_ = nullptr;
+    std::string key =
+        table_object->GetSchemaName() + "." + table_object->GetTableName();
+    database_object->table_catalog_entries_cache_[table_object->GetTableOid()] =
+        table_object;
+    database_object->table_catalog_entries_cache_by_name[key] = table_object;
+  }
+  return database_object;
+}
+
 /* @brief   insert table catalog object into cache
  * @param   table_object
  * @return  false if table_name already exists in cache
@@ -72,6 +182,7 @@ bool DatabaseCatalogEntry::InsertTableCatalogEntry(
  * @return  true if table_oid is found and evicted; false if not found
  */
 bool DatabaseCatalogEntry::EvictTableCatalogEntry(oid_t table_oid) {
+  txn_->catalog_cache.SetModified();
   // find table name from table name cache
   auto it = table_catalog_entries_cache_.find(table_oid);
   if (it == table_catalog_entries_cache_.end()) {
@@ -94,6 +205,7 @@ bool DatabaseCatalogEntry::EvictTableCatalogEntry(oid_t table_oid) {
  */
 bool DatabaseCatalogEntry::EvictTableCatalogEntry(const std::string &table_name,
                                                   const std::string &schema_name) {
+  txn_->catalog_cache.SetModified();
   std::string key = schema_name + "." + table_name;
   // find table name from table name cache
   auto it = table_catalog_entries_cache_by_name.find(key);
@@ -111,6 +223,7 @@ bool DatabaseCatalogEntry::EvictTableCatalogEntry(const std::string &table_name,
 /*@brief   evict all table catalog objects in this database from cache
  */
 void DatabaseCatalogEntry::EvictAllTableCatalogEntries() {
+  txn_->catalog_cache.SetModified();
   table_catalog_entries_cache_.clear();
   table_catalog_entries_cache_by_name.clear();
 }
@@ -125,6 +238,15 @@ std::shared_ptr<TableCatalogEntry> DatabaseCatalogEntry::GetTableCatalogEntry(
   auto it = table_catalog_entries_cache_.find(table_oid);
   if (it != table_catalog_entries_cache_.end()) return it->second;
 
+  // try the shared cache before storage
+  if (UseSharedEntry()) {
+    auto &shared_tables = shared_entry_->table_catalog_entries_cache_;
+    auto shared_it = shared_tables.find(table_oid);
+    if (shared_it != shared_tables.end()) {
+      return InsertSharedTableCatalogEntry(shared_it->second);
+    }
+  }
+
   if (cached_only) {
     // cache miss return empty object
     return nullptr;
@@ -153,6 +275,15 @@ std::shared_ptr<TableCatalogEntry> DatabaseCatalogEntry::GetTableCatalogEntry(
     return it->second;
   }
 
+  // try the shared cache before storage
+  if (UseSharedEntry()) {
+    auto &shared_tables = shared_entry_->table_catalog_entries_cache_by_name;
+    auto shared_it = shared_tables.find(key);
+    if (shared_it != shared_tables.end()) {
+      return InsertSharedTableCatalogEntry(shared_it->second);
+    }
+  }
+
   if (cached_only) {
     // cache miss return empty object
     return nullptr;
@@ -223,6 +354,16 @@ std::shared_ptr<IndexCatalogEntry> DatabaseCatalogEntry::GetCachedIndexCatalogEn
     auto index_object = table_object->GetIndexCatalogEntries(index_oid, true);
     if (index_object) return index_object;
   }
+  if (UseSharedEntry()) {
+    for (auto &it : shared_entry_->table_catalog_entries_cache_) {
+      if (table_catalog_entries_cache_.count(it.first) != 0) continue;
+      auto index_object = it.second->GetIndexCatalogEntries(index_oid, true);
+      if (index_object) {
+        InsertSharedTableCatalogEntry(it.second);
+        return index_object;
+      }
+    }
+  }
   return nullptr;
 }
 
@@ -241,6 +382,20 @@ std::shared_ptr<IndexCatalogEntry> DatabaseCatalogEntry::GetCachedIndexCatalogEn
       if (index_object) return index_object;
     }
   }
+  if (UseSharedEntry()) {
+    for (auto &it : shared_entry_->table_catalog_entries_cache_) {
+      auto table_object = it.second;
+      if (table_object->GetSchemaName() != schema_name ||
+          table_catalog_entries_cache_.count(it.first) != 0) {
+        continue;
+      }
+      auto index_object = table_object->GetIndexCatalogEntry(index_name, true);
+      if (index_object) {
+        InsertSharedTableCatalogEntry(table_object);
+        return index_object;
+      }
+    }
+  }
   return nullptr;
 }
 
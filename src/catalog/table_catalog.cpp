@@ -55,6 +55,17 @@ TableCatalogEntry::TableCatalogEntry(concurrency::TransactionContext *txn,
       valid_constraint_catalog_entries_(false),
       txn_(txn) {}
 
+/* @brief   count the cached index, column, layout and constraint entries,
+ *          with complete sets counting one more than partial ones
+ * @return  the number of cached entries
+ */
+size_t TableCatalogEntry::GetCachedEntryCount() const {
+  return index_catalog_entries.size() + column_catalog_entries_.size() +
+         layout_catalog_entries_.size() + constraint_catalog_entries_.size() +
+         valid_index_catalog_entries_ + valid_column_catalog_entries_ +
+         valid_layout_catalog_entries_ + valid_constraint_catalog_entries_;
+}
+
 /* @brief   insert index catalog object into cache
  * @param   index_object
  * @return  false if index_name already exists in cache
@@ -572,6 +572,111 @@ void Aggregation::AdvanceValues(CodeGen &codegen, llvm::Value *space,
   AdvanceValues(codegen, space, next, empty);
 }
 
+bool Aggregation::SupportsPartialAggregation(
+    const std::vector<planner::AggregatePlan::AggTerm> &agg_terms) {
+  for (const auto &agg_term : agg_terms) {
+    // DISTINCT is ignored for MIN/MAX (see Setup())
+    if (agg_term.distinct &&
+        agg_term.aggtype != ExpressionType::AGGREGATE_MIN &&
+        agg_term.aggtype != ExpressionType::AGGREGATE_MAX) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Copy all the aggregate components stored in the partial space, including
+// their NULL bits, into the provided storage space
+void Aggregation::CopyPartialValues(CodeGen &codegen, llvm::Value *space,
+                                    llvm::Value *partial_space) const {
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_, space};
+  UpdateableStorage::NullBitmap partial_null_bitmap{codegen, storage_,
+                                                    partial_space};
+
+  // Initialize bitmap to all NULLs
+  null_bitmap.InitAllNull(codegen);
+
+  for (uint32_t i = 0; i < storage_.GetNumElements(); i++) {
+    codegen::Value partial_val =
+        storage_.GetValue(codegen, partial_space, i, partial_null_bitmap);
+    storage_.SetValue(codegen, space, i, partial_val, null_bitmap);
+  }
+
+  // Write the final contents of the null bitmap
+  null_bitmap.WriteBack(codegen);
+}
+
+// Merge all the partial aggregates stored in the partial space into the
+// aggregates stored in the provided storage space
+void Aggregation::MergePartialValues(CodeGen &codegen, llvm::Value *space,
+                                     llvm::Value *partial_space) const {
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_, space};
+  UpdateableStorage::NullBitmap partial_null_bitmap{codegen, storage_,
+                                                    partial_space};
+
+  for (const auto &agg_info : aggregate_infos_) {
+    // Partial DISTINCT aggregates can't be merged
+    PELOTON_ASSERT(!agg_info.is_distinct);
+
+    switch (agg_info.aggregate_type) {
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX: {
+        // Partial sums are added, partial minimums and maximums are compared
+        MergePartialValue(codegen, space, agg_info.aggregate_type,
+                          agg_info.storage_indices[0], partial_space,
+                          null_bitmap, partial_null_bitmap);
+        break;
+      }
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR: {
+        // Partial counts are added up
+        MergePartialValue(codegen, space, ExpressionType::AGGREGATE_SUM,
+                          agg_info.storage_indices[0], partial_space,
+                          null_bitmap, partial_null_bitmap);
+        break;
+      }
+      case ExpressionType::AGGREGATE_AVG: {
+        // Both the SUM and the COUNT of an AVG are added up
+        MergePartialValue(codegen, space, ExpressionType::AGGREGATE_SUM,
+                          agg_info.storage_indices[0], partial_space,
+                          null_bitmap, partial_null_bitmap);
+        MergePartialValue(codegen, space, ExpressionType::AGGREGATE_SUM,
+                          agg_info.storage_indices[1], partial_space,
+                          null_bitmap, partial_null_bitmap);
+        break;
+      }
+      default: {
+        std::string message = StringUtil::Format(
+            "Unexpected aggregate type [%s] when merging aggregator",
+            ExpressionTypeToString(agg_info.aggregate_type).c_str());
+        LOG_ERROR("%s", message.c_str());
+        throw Exception{ExceptionType::UNKNOWN_TYPE, message};
+      }
+    }
+  }
+
+  // Write the final contents of the null bitmap
+  null_bitmap.WriteBack(codegen);
+}
+
+void Aggregation::MergePartialValue(
+    CodeGen &codegen, llvm::Value *space, ExpressionType type,
+    uint32_t storage_index, llvm::Value *partial_space,
+    UpdateableStorage::NullBitmap &null_bitmap,
+    UpdateableStorage::NullBitmap &partial_null_bitmap) const {
+  codegen::Value partial_val = storage_.GetValue(
+      codegen, partial_space, storage_index, partial_null_bitmap);
+
+  // If the aggregate is not NULL-able, elide NULL check. Otherwise, a NULL
+  // partial aggregate is skipped and a NULL aggregate takes the partial one.
+  if (!null_bitmap.IsNullable(storage_index)) {
+    DoAdvanceValue(codegen, space, type, storage_index, partial_val);
+  } else {
+    DoNullCheck(codegen, space, type, storage_index, partial_val, null_bitmap);
+  }
+}
+
 // This function will compute the final values of all aggregates stored in the
 // provided storage space, populating the provided vector with these values.
 void Aggregation::FinalizeValues(
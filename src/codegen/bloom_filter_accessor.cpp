@@ -32,6 +32,12 @@ void BloomFilterAccessor::Destroy(CodeGen &codegen,
                                   llvm::Value *bloom_filter) const {
   codegen.Call(BloomFilterProxy::Destroy, {bloom_filter});
 }
+
+void BloomFilterAccessor::Merge(CodeGen &codegen, llvm::Value *bloom_filter,
+                                llvm::Value *other_bloom_filter) const {
+  codegen.Call(BloomFilterProxy::Merge, {bloom_filter, other_bloom_filter});
+}
+
 void BloomFilterAccessor::Add(CodeGen &codegen, llvm::Value *bloom_filter,
                               const std::vector<codegen::Value> &key) const {
   // Index of current hash being calculated
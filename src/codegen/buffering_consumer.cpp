@@ -95,10 +95,9 @@ void BufferingConsumer::Prepare(CompilationContext &compilation_ctx) {
 }
 
 // For each output attribute, we write out the attribute's value into the
-// currently active output tuple. When all attributes have been written, we
-// call BufferTuple(...) to append the currently active tuple into the output.
-void BufferingConsumer::ConsumeResult(ConsumerContext &ctx,
-                                      RowBatch::Row &row) const {
+// currently active output tuple.
+llvm::Value *BufferingConsumer::MaterializeTuple(ConsumerContext &ctx,
+                                                 RowBatch::Row &row) const {
   CodeGen &codegen = ctx.GetCodeGen();
 
   auto num_cols = static_cast<uint32_t>(output_ais_.size());
@@ -149,12 +148,22 @@ void BufferingConsumer::ConsumeResult(ConsumerContext &ctx,
     codegen.CallFunc(output_func, args);
   }
 
+  return tuple_buffer_;
+}
+
+// When all attributes have been written, we call BufferTuple(...) to append
+// the currently active tuple into the output.
+void BufferingConsumer::ConsumeResult(ConsumerContext &ctx,
+                                      RowBatch::Row &row) const {
+  CodeGen &codegen = ctx.GetCodeGen();
+  llvm::Value *tuple_buffer = MaterializeTuple(ctx, row);
+
   auto &query_state = ctx.GetQueryState();
   llvm::Value *buffer_ptr =
       query_state.LoadStateValue(codegen, consumer_state_id_);
 
   // Append the tuple to the output buffer (by calling BufferTuple(...))
-  std::vector<llvm::Value *> args = {buffer_ptr, tuple_buffer_,
+  std::vector<llvm::Value *> args = {buffer_ptr, tuple_buffer,
                                      codegen.Const32(output_ais_.size())};
   codegen.Call(BufferingConsumerProxy::BufferTuple, args);
 }
@@ -19,10 +19,12 @@
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_os_ostream.h"
 #include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #if LLVM_VERSION_GE(3, 9)
 #include "llvm/Transforms/Scalar/GVN.h"
 #endif
 
+#include "codegen/object_cache.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "settings/settings_manager.h"
@@ -140,6 +142,11 @@ class InstructionCounts : public llvm::ModulePass {
     return false;
   }
 
+  uint64_t GetExternalFunctionCount() const { return external_func_count_; }
+  uint64_t GetFunctionCount() const { return func_count_; }
+  uint64_t GetBasicBlockCount() const { return basic_block_count_; }
+  uint64_t GetTotalInstructionCount() const { return total_inst_counts_; }
+
   void DumpStats() const {
     LOG_INFO("# functions: %" PRId64 " (%" PRId64
              " external), # blocks: %" PRId64 ", # instructions: %" PRId64,
@@ -159,6 +166,35 @@ class InstructionCounts : public llvm::ModulePass {
   llvm::DenseMap<uint32_t, uint64_t> counts_;
 };
 
+/// Add the optimization passes we run on generated functions
+void AddOptimizationPasses(llvm::legacy::FunctionPassManager &pass_manager) {
+  pass_manager.add(llvm::createInstructionCombiningPass());
+  pass_manager.add(llvm::createReassociatePass());
+  pass_manager.add(llvm::createGVNPass());
+  pass_manager.add(llvm::createCFGSimplificationPass());
+  pass_manager.add(llvm::createAggressiveDCEPass());
+  pass_manager.add(llvm::createCFGSimplificationPass());
+}
+
+/// Create a JIT engine for the given module
+std::unique_ptr<llvm::ExecutionEngine> CreateEngine(
+    std::unique_ptr<llvm::Module> module,
+    const std::unordered_map<std::string,
+                             std::pair<llvm::Function *, CodeContext::FuncPtr>>
+        &builtins,
+    std::string &err_str) {
+  std::unique_ptr<llvm::ExecutionEngine> engine{
+      llvm::EngineBuilder(std::move(module))
+          .setEngineKind(llvm::EngineKind::JIT)
+          .setMCJITMemoryManager(
+               llvm::make_unique<PelotonMemoryManager>(builtins))
+          .setMCPU(llvm::sys::getHostCPUName())
+          .setErrorStr(&err_str)
+          .create()};
+  PELOTON_ASSERT(engine != nullptr);
+  return engine;
+}
+
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -197,23 +233,11 @@ CodeContext::CodeContext()
   // references etc.
   std::unique_ptr<llvm::Module> m{module_};
   module_ = m.get();
-  engine_.reset(llvm::EngineBuilder(std::move(m))
-                    .setEngineKind(llvm::EngineKind::JIT)
-                    .setMCJITMemoryManager(
-                         llvm::make_unique<PelotonMemoryManager>(builtins_))
-                    .setMCPU(llvm::sys::getHostCPUName())
-                    .setErrorStr(&err_str_)
-                    .create());
-  PELOTON_ASSERT(engine_ != nullptr);
+  engine_ = CreateEngine(std::move(m), builtins_, err_str_);
 
   // The set of optimization passes we include
   pass_manager_.reset(new llvm::legacy::FunctionPassManager(module_));
-  pass_manager_->add(llvm::createInstructionCombiningPass());
-  pass_manager_->add(llvm::createReassociatePass());
-  pass_manager_->add(llvm::createGVNPass());
-  pass_manager_->add(llvm::createCFGSimplificationPass());
-  pass_manager_->add(llvm::createAggressiveDCEPass());
-  pass_manager_->add(llvm::createCFGSimplificationPass());
+  AddOptimizationPasses(*pass_manager_);
 
   // Setup the common types we need once
   bool_type_ = llvm::Type::getInt1Ty(*context_);
@@ -309,6 +333,57 @@ void CodeContext::Optimize() {
   pass_manager_->doFinalization();
 }
 
+bool CodeContext::EnableObjectCache(const std::string &directory) {
+  // make sure the code is verified
+  if (!is_verified_) Verify();
+
+  if (!ObjectCache::IsCacheable(*module_)) {
+    LOG_DEBUG("Code context %" PRIu64 " cannot be cached", id_);
+    return false;
+  }
+
+  // The names of the module and its functions carry the ID of this context.
+  // Replace them so that the same query compiles to the same object in every
+  // context and in every process.
+  const std::string id_prefix = "_" + std::to_string(id_) + "_";
+  for (auto &func : *module_) {
+    if (!func.isDeclaration() && func.getName().startswith(id_prefix)) {
+      func.setName("_query_" + func.getName().substr(id_prefix.size()).str());
+    }
+  }
+  module_->setModuleIdentifier("query");
+#if LLVM_VERSION_GE(3, 9)
+  module_->setSourceFileName("query");
+#endif
+
+  // The JIT finds the compiled object through the module identifier
+  const auto key = ObjectCache::ComputeKey(*module_);
+  module_->setModuleIdentifier(key);
+
+  object_cache_.reset(new ObjectCache(directory));
+  engine_->setObjectCache(object_cache_.get());
+  return object_cache_->Contains(key);
+}
+
+void CodeContext::EnableRecompilation() {
+  // make sure the code is verified
+  if (!is_verified_) Verify();
+
+#if LLVM_VERSION_GE(7, 0)
+  recompile_module_ = llvm::CloneModule(*module_);
+#else
+  recompile_module_ = llvm::CloneModule(module_);
+#endif
+
+  // The first compilation should be fast
+  engine_->getTargetMachine()->setOptLevel(llvm::CodeGenOpt::None);
+
+  // Only the optimized code is worth caching
+  if (object_cache_ != nullptr) {
+    engine_->setObjectCache(nullptr);
+  }
+}
+
 /// JIT compile all the functions that were created in this context
 void CodeContext::Compile() {
   // make sure the code is verified
@@ -336,6 +411,60 @@ void CodeContext::Compile() {
   }
 }
 
+void CodeContext::Recompile() {
+  PELOTON_ASSERT(recompile_module_ != nullptr &&
+                 "Recompilation must be enabled before compiling");
+  PELOTON_ASSERT(recompile_engine_ == nullptr &&
+                 "The code can only be recompiled once");
+  auto *module = recompile_module_.get();
+
+  // Optimize the copy of the code
+  llvm::legacy::FunctionPassManager pass_manager{module};
+  AddOptimizationPasses(pass_manager);
+  pass_manager.doInitialization();
+  for (auto &func : *module) {
+    if (!func.isDeclaration()) {
+      pass_manager.run(func);
+    }
+  }
+  pass_manager.doFinalization();
+
+  // JIT compile it with a new engine
+  recompile_engine_ =
+      CreateEngine(std::move(recompile_module_), builtins_, err_str_);
+  if (object_cache_ != nullptr) {
+    recompile_engine_->setObjectCache(object_cache_.get());
+  }
+  recompile_engine_->finalizeObject();
+
+  // Collect the implementations in the new code, then switch to them
+  recompiled_functions_.reserve(functions_.size());
+  for (const auto &func_iter : functions_) {
+    if (func_iter.first->isDeclaration()) {
+      recompiled_functions_.push_back(func_iter.second);
+      continue;
+    }
+    auto *func = module->getFunction(func_iter.first->getName());
+    PELOTON_ASSERT(func != nullptr);
+    recompiled_functions_.push_back(
+        recompile_engine_->getPointerToFunction(func));
+  }
+  is_recompiled_.store(true, std::memory_order_release);
+}
+
+CodeContext::IRStats CodeContext::GetIRStats() const {
+  char name[] = "inst count";
+  InstructionCounts inst_count(*name);
+  inst_count.runOnModule(GetModule());
+
+  IRStats stats;
+  stats.num_functions = inst_count.GetFunctionCount();
+  stats.num_external_functions = inst_count.GetExternalFunctionCount();
+  stats.num_basic_blocks = inst_count.GetBasicBlockCount();
+  stats.num_instructions = inst_count.GetTotalInstructionCount();
+  return stats;
+}
+
 size_t CodeContext::GetTypeSize(llvm::Type *type) const {
   auto size = GetDataLayout().getTypeSizeInBits(type) / 8;
   return size != 0 ? size : 1;
@@ -361,9 +490,10 @@ size_t CodeContext::GetStructElementOffset(llvm::StructType *type,
 // TODO(marcel) same as LookupBuiltin?
 CodeContext::FuncPtr CodeContext::GetRawFunctionPointer(
     llvm::Function *fn) const {
-  for (const auto &iter : functions_) {
-    if (iter.first == fn) {
-      return iter.second;
+  bool recompiled = is_recompiled_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < functions_.size(); i++) {
+    if (functions_[i].first == fn) {
+      return recompiled ? recompiled_functions_[i] : functions_[i].second;
     }
   }
 
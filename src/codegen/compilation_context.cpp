@@ -69,6 +69,12 @@ void CompilationContext::GeneratePlan(Query &query,
   query_state_.FinalizeType(codegen_);
 
   if (stats != nullptr) {
+    for (const auto *pipeline : pipelines_) {
+      if (pipeline->IsParallel()) {
+        stats->num_parallel_pipelines++;
+      }
+    }
+
     timer.Stop();
     stats->setup_ms = timer.GetDuration();
     timer.Reset();
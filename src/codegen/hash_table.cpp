@@ -178,6 +178,53 @@ void HashTable::MergeLazyUnfinished(CodeGen &codegen, llvm::Value *global_ht,
   codegen.Call(HashTableProxy::MergeLazyUnfinished, {global_ht, local_ht});
 }
 
+void HashTable::PartitionLazy(CodeGen &codegen, llvm::Value *ht_ptr,
+                              uint32_t num_partition_bits) const {
+  codegen.Call(HashTableProxy::PartitionLazy,
+               {ht_ptr, codegen.Const32(num_partition_bits)});
+}
+
+void HashTable::PartitionLazyParallel(CodeGen &codegen, llvm::Value *ht_ptr,
+                                      llvm::Value *thread_states,
+                                      uint32_t ht_state_offset,
+                                      uint32_t num_partition_bits) const {
+  codegen.Call(HashTableProxy::PartitionLazyParallel,
+               {ht_ptr, thread_states, codegen.Const32(ht_state_offset),
+                codegen.Const32(num_partition_bits)});
+}
+
+void HashTable::BuildPartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                               llvm::Value *partition) const {
+  codegen.Call(HashTableProxy::BuildPartition, {ht_ptr, partition});
+}
+
+void HashTable::IteratePartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                                 llvm::Value *partition,
+                                 IterateCallback &callback) const {
+  llvm::Value *head =
+      codegen.Call(HashTableProxy::GetPartitionHead, {ht_ptr, partition});
+
+  llvm::Type *entry_type = EntryProxy::GetType(codegen);
+  llvm::Value *null = codegen.NullPtr(entry_type->getPointerTo());
+
+  // The entries of a partition are linked in storage order
+  lang::Loop chain_loop(codegen, codegen->CreateICmpNE(head, null),
+                        {{"entry", head}});
+  {
+    llvm::Value *entry = chain_loop.GetLoopVar(0);
+    llvm::Value *entry_data =
+        codegen->CreateConstInBoundsGEP2_32(entry_type, entry, 1, 0);
+
+    // Pull out keys and invoke callback
+    std::vector<codegen::Value> keys;
+    auto *data_area_ptr = key_storage_.LoadValues(codegen, entry_data, keys);
+    callback.ProcessEntry(codegen, keys, data_area_ptr);
+
+    entry = codegen.Load(EntryProxy::next, entry);
+    chain_loop.LoopEnd(codegen->CreateICmpNE(entry, null), {entry});
+  }
+}
+
 void HashTable::Iterate(CodeGen &codegen, llvm::Value *ht_ptr,
                         IterateCallback &callback) const {
   llvm::Value *buckets_ptr = codegen.Load(HashTableProxy::directory, ht_ptr);
@@ -20,6 +20,7 @@
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/tile.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace codegen {
@@ -54,8 +55,11 @@ void Inserter::Insert() {
   auto *txn = executor_context_->GetTransaction();
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
-  ContainerTuple<storage::TileGroup> tuple(
-      table_->GetTileGroupById(location_.block).get(), location_.offset);
+  // The tuple was written in place, so the zone map hasn't seen it yet
+  auto tile_group = table_->GetTileGroupById(location_.block);
+  tile_group->GetZoneMap()->Update(location_.offset);
+
+  ContainerTuple<storage::TileGroup> tuple(tile_group.get(), location_.offset);
   ItemPointer *index_entry_ptr = nullptr;
   bool result = table_->InsertTuple(&tuple, location_, txn, &index_entry_ptr);
   if (result == false) {
@@ -47,6 +47,17 @@ BytecodeFunction BytecodeBuilder::CreateBytecodeFunction(
   builder.TranslateFunction();
   builder.Finalize();
 
+  // Arguments of native calls are passed as 64 bit values, which is only
+  // correct if every argument is a pointer or a 64 bit integer
+  bool native_callable =
+      function->getReturnType()->isVoidTy() &&
+      function->arg_size() <= BytecodeFunction::kMaxNativeCallArguments;
+  for (const auto &argument : function->args()) {
+    auto *type = argument.getType();
+    native_callable &= (type->isPointerTy() || type->isIntegerTy(64));
+  }
+  builder.bytecode_function_.native_callable_ = native_callable;
+
   return std::move(builder.bytecode_function_);
 }
 
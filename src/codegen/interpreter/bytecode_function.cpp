@@ -42,7 +42,7 @@
 #include "storage/data_table.h"
 #include "storage/storage_manager.h"
 #include "storage/tile_group.h"
-#include "storage/zone_map_manager.h"
+#include "storage/zone_map.h"
 #include "codegen/util/buffer.h"
 
 namespace peloton {
@@ -33,24 +33,65 @@ void *
         {nullptr};
 
 BytecodeInterpreter::BytecodeInterpreter(
-    const BytecodeFunction &bytecode_function)
-    : bytecode_function_(bytecode_function) {}
+    const BytecodeFunction &bytecode_function,
+    const NativeFunctionResolver *native_resolver)
+    : bytecode_function_(bytecode_function),
+      native_resolver_(native_resolver) {}
 
 value_t BytecodeInterpreter::ExecuteFunction(
     const BytecodeFunction &bytecode_function,
-    const std::vector<value_t> &arguments) {
-  BytecodeInterpreter interpreter(bytecode_function);
+    const std::vector<value_t> &arguments,
+    const NativeFunctionResolver *native_resolver) {
+  BytecodeInterpreter interpreter(bytecode_function, native_resolver);
   interpreter.ExecuteFunction(arguments);
 
   return interpreter.GetReturnValue<value_t>();
 }
 
 void BytecodeInterpreter::ExecuteFunction(
-    const BytecodeFunction &bytecode_function, char *param) {
-  BytecodeInterpreter interpreter(bytecode_function);
+    const BytecodeFunction &bytecode_function, char *param,
+    const NativeFunctionResolver *native_resolver) {
+  BytecodeInterpreter interpreter(bytecode_function, native_resolver);
   interpreter.ExecuteFunction({reinterpret_cast<value_t &>(param)});
 }
 
+void BytecodeInterpreter::CallNativeFunction(
+    void *function, const std::vector<value_t> &arguments) {
+  // All arguments are pointers or 64 bit integers, so they are passed the
+  // same way as value_t
+  using v = value_t;
+  const auto &a = arguments;
+  switch (arguments.size()) {
+    case 0:
+      reinterpret_cast<void (*)()>(function)();
+      break;
+    case 1:
+      reinterpret_cast<void (*)(v)>(function)(a[0]);
+      break;
+    case 2:
+      reinterpret_cast<void (*)(v, v)>(function)(a[0], a[1]);
+      break;
+    case 3:
+      reinterpret_cast<void (*)(v, v, v)>(function)(a[0], a[1], a[2]);
+      break;
+    case 4:
+      reinterpret_cast<void (*)(v, v, v, v)>(function)(a[0], a[1], a[2], a[3]);
+      break;
+    case 5:
+      reinterpret_cast<void (*)(v, v, v, v, v)>(function)(a[0], a[1], a[2],
+                                                          a[3], a[4]);
+      break;
+    case 6:
+      reinterpret_cast<void (*)(v, v, v, v, v, v)>(function)(
+          a[0], a[1], a[2], a[3], a[4], a[5]);
+      break;
+    default:
+      PELOTON_ASSERT(false && "too many arguments for a native call");
+  }
+  static_assert(BytecodeFunction::kMaxNativeCallArguments == 6,
+                "CallNativeFunction must handle every native callable arity");
+}
+
 NEVER_INLINE NO_CLONE void BytecodeInterpreter::ExecuteFunction(
     const std::vector<value_t> &arguments) {
   // Fill the label_pointers_ array with the handler addresses at first
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache.cpp
+//
+// Identification: src/codegen/object_cache.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/object_cache.h"
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "common/logger.h"
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+// Does the given constant contain an integer converted to a pointer?
+bool ContainsAddress(const llvm::Constant *constant) {
+  if (auto *expr = llvm::dyn_cast<llvm::ConstantExpr>(constant)) {
+    if (expr->getOpcode() == llvm::Instruction::IntToPtr) {
+      return true;
+    }
+  }
+  for (const auto &operand : constant->operands()) {
+    auto *operand_constant = llvm::dyn_cast<llvm::Constant>(operand);
+    if (operand_constant != nullptr &&
+        !llvm::isa<llvm::GlobalValue>(operand_constant) &&
+        ContainsAddress(operand_constant)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+ObjectCache::ObjectCache(std::string directory)
+    : directory_(std::move(directory)) {}
+
+bool ObjectCache::IsCacheable(const llvm::Module &module) {
+  // Some translators pass pointers to objects of the plan or the runtime
+  // directly to the generated code. Those are only valid in this process.
+  for (const auto &global : module.globals()) {
+    if (global.hasInitializer() && ContainsAddress(global.getInitializer())) {
+      return false;
+    }
+  }
+  for (const auto &func : module) {
+    for (const auto &block : func) {
+      for (const auto &inst : block) {
+        if (llvm::isa<llvm::IntToPtrInst>(inst) &&
+            llvm::isa<llvm::Constant>(inst.getOperand(0))) {
+          return false;
+        }
+        for (const auto &operand : inst.operands()) {
+          auto *constant = llvm::dyn_cast<llvm::Constant>(operand);
+          if (constant != nullptr && !llvm::isa<llvm::GlobalValue>(constant) &&
+              ContainsAddress(constant)) {
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+std::string ObjectCache::ComputeKey(const llvm::Module &module) {
+  std::string ir;
+  llvm::raw_string_ostream ostream{ir};
+  module.print(ostream, nullptr);
+  ostream.flush();
+
+  // The machine code depends on the IR, the compiler and the target CPU
+  llvm::MD5 hash;
+  hash.update(ir);
+  hash.update(LLVM_VERSION_STRING);
+  hash.update(llvm::sys::getHostCPUName());
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  llvm::SmallString<32> key;
+  llvm::MD5::stringifyResult(result, key);
+  return key.str().str();
+}
+
+bool ObjectCache::Contains(const std::string &key) const {
+  return boost::filesystem::exists(GetPath(key));
+}
+
+void ObjectCache::notifyObjectCompiled(const llvm::Module *module,
+                                       llvm::MemoryBufferRef object) {
+  const auto path = GetPath(module->getModuleIdentifier());
+  try {
+    boost::filesystem::create_directories(directory_);
+
+    // Write to a temporary file first, then move it into place, so that
+    // concurrent readers never see a partially written object
+    auto tmp_path = path + "." +
+                    boost::filesystem::unique_path().string() + ".tmp";
+    {
+      std::ofstream out{tmp_path, std::ios::binary};
+      out.write(object.getBufferStart(), object.getBufferSize());
+      if (!out) {
+        LOG_WARN("Could not write compiled query to '%s'", tmp_path.c_str());
+        boost::filesystem::remove(tmp_path);
+        return;
+      }
+    }
+    boost::filesystem::rename(tmp_path, path);
+    LOG_DEBUG("Cached compiled query in '%s'", path.c_str());
+  } catch (const boost::filesystem::filesystem_error &e) {
+    LOG_WARN("Could not cache compiled query in '%s': %s", path.c_str(),
+             e.what());
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> ObjectCache::getObject(
+    const llvm::Module *module) {
+  const auto path = GetPath(module->getModuleIdentifier());
+  if (!boost::filesystem::exists(path)) {
+    return nullptr;
+  }
+
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    LOG_WARN("Could not read cached query from '%s'", path.c_str());
+    return nullptr;
+  }
+
+  LOG_DEBUG("Loaded compiled query from '%s'", path.c_str());
+  return std::move(buffer.get());
+}
+
+std::string ObjectCache::GetPath(const std::string &key) const {
+  return (boost::filesystem::path{directory_} / (key + ".o")).string();
+}
+
+}  // namespace codegen
+}  // namespace peloton
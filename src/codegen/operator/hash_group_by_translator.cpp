@@ -12,18 +12,26 @@
 
 #include "codegen/operator/hash_group_by_translator.h"
 
+#include <cinttypes>
+
 #include "codegen/compilation_context.h"
+#include "codegen/function_builder.h"
 #include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
 #include "codegen/proxy/oa_hash_table_proxy.h"
+#include "codegen/proxy/runtime_functions_proxy.h"
 #include "codegen/operator/projection_translator.h"
 #include "codegen/lang/vectorized_loop.h"
 #include "codegen/type/integer_type.h"
+#include "util/string_util.h"
 
 namespace peloton {
 namespace codegen {
 
 std::atomic<bool> HashGroupByTranslator::kUsePrefetch{false};
 
+const uint32_t HashGroupByTranslator::kNumMergePartitions = 16;
+
 //===----------------------------------------------------------------------===//
 // HASH GROUP BY TRANSLATOR
 //===----------------------------------------------------------------------===//
@@ -33,7 +41,10 @@ HashGroupByTranslator::HashGroupByTranslator(
     const planner::AggregatePlan &group_by, CompilationContext &context,
     Pipeline &pipeline)
     : OperatorTranslator(group_by, context, pipeline),
-      child_pipeline_(this, Pipeline::Parallelism::Serial),
+      child_pipeline_(this, Aggregation::SupportsPartialAggregation(
+                                group_by.GetUniqueAggTerms())
+                                ? Pipeline::Parallelism::Flexible
+                                : Pipeline::Parallelism::Serial),
       aggregation_(context.GetQueryState()) {
   // If we should be prefetching into the hash-table, install a boundary in the
   // pipeline at the input into this translator to ensure it receives a vector
@@ -42,15 +53,25 @@ HashGroupByTranslator::HashGroupByTranslator(
     child_pipeline_.InstallStageBoundary(this);
   }
 
-  // Register the hash-table instance in the runtime state
-  CodeGen &codegen = GetCodeGen();
-  QueryState &query_state = context.GetQueryState();
-  hash_table_id_ =
-      query_state.RegisterState("groupBy", OAHashTableProxy::GetType(codegen));
-
   // Prepare the input operator to this group by
   context.Prepare(*group_by.GetChild(0), child_pipeline_);
 
+  // Register the hash-table instance in the runtime state. If the input is
+  // consumed in parallel, every thread first aggregates into thread-local
+  // hash tables, one per partition of the hash values. The thread-local
+  // tables of each partition are then merged by a separate thread.
+  CodeGen &codegen = GetCodeGen();
+  QueryState &query_state = context.GetQueryState();
+  if (IsParallel()) {
+    auto *partitions_type = llvm::ArrayType::get(
+        OAHashTableProxy::GetType(codegen), kNumMergePartitions);
+    hash_table_id_ =
+        query_state.RegisterState("groupByPartitions", partitions_type);
+  } else {
+    hash_table_id_ = query_state.RegisterState(
+        "groupBy", OAHashTableProxy::GetType(codegen));
+  }
+
   // Prepare the predicate if one exists
   if (group_by.GetPredicate() != nullptr) {
     context.Prepare(*group_by.GetPredicate());
@@ -89,8 +110,58 @@ HashGroupByTranslator::HashGroupByTranslator(
 
 // Initialize the hash table instance
 void HashGroupByTranslator::InitializeQueryState() {
-  hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
-  aggregation_.InitializeQueryState(GetCodeGen());
+  CodeGen &codegen = GetCodeGen();
+  if (IsParallel()) {
+    IteratePartitions(LoadStatePtr(hash_table_id_),
+                      [this, &codegen](llvm::Value *partition_ht_ptr) {
+                        hash_table_.Init(codegen, partition_ht_ptr);
+                      });
+  } else {
+    hash_table_.Init(codegen, LoadStatePtr(hash_table_id_));
+  }
+  aggregation_.InitializeQueryState(codegen);
+}
+
+void HashGroupByTranslator::RegisterPipelineState(
+    PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.GetPipeline() == child_pipeline_ &&
+      pipeline_ctx.IsParallel()) {
+    auto *partitions_type = llvm::ArrayType::get(
+        OAHashTableProxy::GetType(GetCodeGen()), kNumMergePartitions);
+    hash_table_tl_id_ =
+        pipeline_ctx.RegisterState("localGroupBy", partitions_type);
+  }
+}
+
+void HashGroupByTranslator::InitializePipelineState(
+    PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.GetPipeline() == child_pipeline_ &&
+      pipeline_ctx.IsParallel()) {
+    CodeGen &codegen = GetCodeGen();
+    IteratePartitions(pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_),
+                      [this, &codegen](llvm::Value *local_ht_ptr) {
+                        hash_table_.Init(codegen, local_ht_ptr);
+                      });
+  }
+}
+
+void HashGroupByTranslator::FinishPipeline(PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.GetPipeline() == child_pipeline_ &&
+      pipeline_ctx.IsParallel()) {
+    MergePartitions(pipeline_ctx);
+  }
+}
+
+void HashGroupByTranslator::TearDownPipelineState(
+    PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.GetPipeline() == child_pipeline_ &&
+      pipeline_ctx.IsParallel()) {
+    CodeGen &codegen = GetCodeGen();
+    IteratePartitions(pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_),
+                      [this, &codegen](llvm::Value *local_ht_ptr) {
+                        hash_table_.Destroy(codegen, local_ht_ptr);
+                      });
+  }
 }
 
 // Produce!
@@ -111,8 +182,18 @@ void HashGroupByTranslator::Produce() const {
     // Iterate
     const auto &plan = GetPlanAs<planner::AggregatePlan>();
     ProduceResults produce_results{ctx, plan, aggregation_};
-    hash_table_.VectorizedIterate(codegen, LoadStatePtr(hash_table_id_),
-                                  selection_vec, produce_results);
+    if (IsParallel()) {
+      // The groups are spread over the partitions
+      IteratePartitions(LoadStatePtr(hash_table_id_),
+                        [&](llvm::Value *partition_ht_ptr) {
+                          hash_table_.VectorizedIterate(
+                              codegen, partition_ht_ptr, selection_vec,
+                              produce_results);
+                        });
+    } else {
+      hash_table_.VectorizedIterate(codegen, LoadStatePtr(hash_table_id_),
+                                    selection_vec, produce_results);
+    }
   };
 
   GetPipeline().RunSerial(producer);
@@ -160,8 +241,9 @@ void HashGroupByTranslator::Consume(ConsumerContext &context,
       hashes.SetValue(codegen, p, hash_val);
 
       // Prefetch the actual hash table bucket
-      hash_table_.PrefetchBucket(codegen, LoadStatePtr(hash_table_id_),
-                                 hash_val, OAHashTable::PrefetchType::Read,
+      hash_table_.PrefetchBucket(codegen, LoadHashTablePtr(context, hash_val),
+                                 hash_val,
+                                 OAHashTable::PrefetchType::Read,
                                  OAHashTable::Locality::Medium);
 
       // End prefetch loop
@@ -205,7 +287,7 @@ void HashGroupByTranslator::Consume(ConsumerContext &context,
 }
 
 // Consume the tuples from the context, grouping them into the hash table
-void HashGroupByTranslator::Consume(ConsumerContext &,
+void HashGroupByTranslator::Consume(ConsumerContext &context,
                                     RowBatch::Row &row) const {
   CodeGen &codegen = GetCodeGen();
 
@@ -223,15 +305,18 @@ void HashGroupByTranslator::Consume(ConsumerContext &,
     }
   }
 
-  // If the hash value is available, use it
+  // If the hash value is available, use it. Parallel aggregations need it to
+  // pick the partition.
   llvm::Value *hash = nullptr;
   if (row.HasAttribute(&OAHashTable::kHashAI)) {
     codegen::Value hash_val = row.DeriveValue(codegen, &OAHashTable::kHashAI);
     hash = hash_val.GetValue();
+  } else if (context.GetPipeline().IsParallel()) {
+    hash = hash_table_.HashKey(codegen, key);
   }
 
   // Perform the insertion into the hash table
-  llvm::Value *hash_table = LoadStatePtr(hash_table_id_);
+  llvm::Value *hash_table = LoadHashTablePtr(context, hash);
   ConsumerProbe probe{GetCompilationContext(), aggregation_, vals, key};
   ConsumerInsert insert{aggregation_, vals, key};
   hash_table_.ProbeOrInsert(codegen, hash_table, hash, key, probe, insert);
@@ -239,8 +324,16 @@ void HashGroupByTranslator::Consume(ConsumerContext &,
 
 // Cleanup by destroying the aggregation hash-table
 void HashGroupByTranslator::TearDownQueryState() {
-  hash_table_.Destroy(GetCodeGen(), LoadStatePtr(hash_table_id_));
-  aggregation_.TearDownQueryState(GetCodeGen());
+  CodeGen &codegen = GetCodeGen();
+  if (IsParallel()) {
+    IteratePartitions(LoadStatePtr(hash_table_id_),
+                      [this, &codegen](llvm::Value *partition_ht_ptr) {
+                        hash_table_.Destroy(codegen, partition_ht_ptr);
+                      });
+  } else {
+    hash_table_.Destroy(codegen, LoadStatePtr(hash_table_id_));
+  }
+  aggregation_.TearDownQueryState(codegen);
 }
 
 // Estimate the size of the dynamically constructed hash-table
@@ -255,6 +348,111 @@ bool HashGroupByTranslator::UsePrefetching() const {
   return kUsePrefetch;
 }
 
+llvm::Value *HashGroupByTranslator::LoadHashTablePtr(
+    ConsumerContext &context, llvm::Value *hash) const {
+  if (context.GetPipeline().IsParallel()) {
+    CodeGen &codegen = GetCodeGen();
+    auto *pipeline_ctx = context.GetPipelineContext();
+    llvm::Value *local_partitions =
+        pipeline_ctx->LoadStatePtr(codegen, hash_table_tl_id_);
+    return LoadPartitionPtr(local_partitions, ComputePartitionId(hash));
+  } else {
+    return LoadStatePtr(hash_table_id_);
+  }
+}
+
+llvm::Value *HashGroupByTranslator::ComputePartitionId(
+    llvm::Value *hash) const {
+  PELOTON_ASSERT(hash != nullptr);
+  CodeGen &codegen = GetCodeGen();
+
+  // The partition is taken from the high bits of the hash value, since the low
+  // bits pick the bucket within the partition's hash table
+  uint32_t partition_bits = 0;
+  while ((1u << partition_bits) < kNumMergePartitions) {
+    partition_bits++;
+  }
+  return codegen->CreateTrunc(
+      codegen->CreateLShr(hash, codegen.Const64(64 - partition_bits)),
+      codegen.Int32Type());
+}
+
+llvm::Value *HashGroupByTranslator::LoadPartitionPtr(
+    llvm::Value *partitions, llvm::Value *partition_id) const {
+  PELOTON_ASSERT(IsParallel());
+  CodeGen &codegen = GetCodeGen();
+  return codegen->CreateInBoundsGEP(partitions,
+                                    {codegen.Const32(0), partition_id});
+}
+
+void HashGroupByTranslator::IteratePartitions(
+    llvm::Value *partitions,
+    const std::function<void(llvm::Value *)> &body) const {
+  CodeGen &codegen = GetCodeGen();
+  llvm::Value *num_partitions = codegen.Const32(kNumMergePartitions);
+
+  llvm::Value *partition_id = codegen.Const32(0);
+  lang::Loop partition_loop{
+      codegen, codegen.ConstBool(true), {{"partitionId", partition_id}}};
+  {
+    partition_id = partition_loop.GetLoopVar(0);
+    body(LoadPartitionPtr(partitions, partition_id));
+
+    partition_id = codegen->CreateAdd(partition_id, codegen.Const32(1));
+    partition_loop.LoopEnd(codegen->CreateICmpULT(partition_id, num_partitions),
+                           {partition_id});
+  }
+}
+
+// Merge the thread-local hash tables into the partitions. Every partition is
+// merged by a separate task. Since the groups were already split into
+// partitions when they were aggregated, a task only iterates the thread-local
+// hash tables of its own partition, and the tasks never touch the same hash
+// table.
+void HashGroupByTranslator::MergePartitions(
+    PipelineContext &pipeline_ctx) const {
+  CodeGen &codegen = GetCodeGen();
+  CodeContext &cc = codegen.GetCodeContext();
+  QueryState &query_state = GetCompilationContext().GetQueryState();
+
+  auto name = StringUtil::Format("_%" PRId64 "_pipeline_%u_mergeGroupBy",
+                                 cc.GetID(), child_pipeline_.GetId());
+  std::vector<FunctionDeclaration::ArgumentInfo> args = {
+      {"queryState", query_state.GetType()->getPointerTo()},
+      {"partitionId", codegen.Int32Type()}};
+  FunctionDeclaration decl(cc, name, FunctionDeclaration::Visibility::Internal,
+                           codegen.VoidType(), args);
+  FunctionBuilder func(cc, decl);
+  {
+    llvm::Value *partition_id = func.GetArgumentByPosition(1);
+    llvm::Value *partition_ht_ptr =
+        LoadPartitionPtr(LoadStatePtr(hash_table_id_), partition_id);
+
+    PipelineContext::LoopOverStates loop_states{pipeline_ctx};
+    loop_states.Do([&](llvm::Value *thread_state) {
+      PipelineContext::SetState state_access(pipeline_ctx, thread_state);
+      llvm::Value *local_ht_ptr = LoadPartitionPtr(
+          pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_), partition_id);
+      MergePartition merge_partition{*this, partition_ht_ptr};
+      hash_table_.Iterate(codegen, local_ht_ptr, merge_partition);
+    });
+
+    func.ReturnAndFinish();
+  }
+
+  // Merge all partitions in parallel
+  std::vector<llvm::Value *> dispatch_args = {
+      // The (void*) query state
+      codegen->CreatePointerCast(codegen.GetState(), codegen.VoidPtrType()),
+      // The number of partitions
+      codegen.Const32(kNumMergePartitions),
+      // The function
+      codegen->CreatePointerCast(
+          func.GetFunction(),
+          proxy::TypeBuilder<void (*)(void *, uint32_t)>::GetType(codegen))};
+  codegen.Call(RuntimeFunctionsProxy::ExecutePerPartition, dispatch_args);
+}
+
 void HashGroupByTranslator::CollectHashKeys(
     RowBatch::Row &row, std::vector<codegen::Value> &key) const {
   CodeGen &codegen = GetCodeGen();
@@ -421,5 +619,57 @@ llvm::Value *HashGroupByTranslator::ConsumerInsert::GetValueSize(
   return codegen.Const32(aggregation_.GetAggregatesStorageSize());
 }
 
+//===----------------------------------------------------------------------===//
+// MERGE PROBE
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::MergeProbe::MergeProbe(const Aggregation &aggregation,
+                                              llvm::Value *partial_aggs)
+    : aggregation_(aggregation), partial_aggs_(partial_aggs) {}
+
+// The group already exists in the partition, merge the partial aggregates
+void HashGroupByTranslator::MergeProbe::ProcessEntry(
+    CodeGen &codegen, llvm::Value *data_area) const {
+  aggregation_.MergePartialValues(codegen, data_area, partial_aggs_);
+}
+
+//===----------------------------------------------------------------------===//
+// MERGE INSERT
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::MergeInsert::MergeInsert(const Aggregation &aggregation,
+                                                llvm::Value *partial_aggs)
+    : aggregation_(aggregation), partial_aggs_(partial_aggs) {}
+
+// The group is new to the partition, the partial aggregates become its initial
+// aggregates
+void HashGroupByTranslator::MergeInsert::StoreValue(CodeGen &codegen,
+                                                    llvm::Value *space) const {
+  aggregation_.CopyPartialValues(codegen, space, partial_aggs_);
+}
+
+llvm::Value *HashGroupByTranslator::MergeInsert::GetValueSize(
+    CodeGen &codegen) const {
+  return codegen.Const32(aggregation_.GetAggregatesStorageSize());
+}
+
+//===----------------------------------------------------------------------===//
+// MERGE PARTITION
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::MergePartition::MergePartition(
+    const HashGroupByTranslator &translator, llvm::Value *partition_ht_ptr)
+    : translator_(translator), partition_ht_ptr_(partition_ht_ptr) {}
+
+void HashGroupByTranslator::MergePartition::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &key,
+    llvm::Value *data_area) const {
+  const auto &hash_table = translator_.hash_table_;
+  MergeProbe probe{translator_.aggregation_, data_area};
+  MergeInsert insert{translator_.aggregation_, data_area};
+  hash_table.ProbeOrInsert(codegen, partition_ht_ptr_, nullptr, key, probe,
+                           insert);
+}
+
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
@@ -111,6 +111,48 @@ class HashJoinTranslator::InsertLeft : public HashTable::InsertCallback {
   const std::vector<codegen::Value> &values_;
 };
 
+/**
+ * The callback used when iterating over a partition of the materialized right
+ * side. Every right-side tuple probes the hash table built over the same
+ * partition of the left side.
+ */
+class HashJoinTranslator::ProbePartition : public HashTable::IterateCallback {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param join_translator The translator reference
+   * @param context The context reference
+   * @param selection_vector The (single element) selection vector of the rows
+   */
+  ProbePartition(const HashJoinTranslator &join_translator,
+                 ConsumerContext &context, Vector &selection_vector)
+      : join_translator_(join_translator),
+        context_(context),
+        selection_vector_(selection_vector) {}
+
+  /**
+   * Rebuild the row of the right side from the partition entry, and find all
+   * its join partners.
+   *
+   * @param codegen The codegen instance
+   * @param key The key of the right-side tuple
+   * @param data_area Memory space where the right-side values are stored
+   */
+  void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                    llvm::Value *data_area) const override;
+
+ private:
+  // The translator (we need lots of its state)
+  const HashJoinTranslator &join_translator_;
+
+  // The context
+  ConsumerContext &context_;
+
+  // The selection vector of the single-row batches
+  Vector &selection_vector_;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// Hash Join Translator
@@ -121,16 +163,27 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
                                        CompilationContext &context,
                                        Pipeline &pipeline)
     : OperatorTranslator(join, context, pipeline),
-      left_pipeline_(this, Pipeline::Parallelism::Flexible) {
+      left_pipeline_(this, Pipeline::Parallelism::Flexible),
+      radix_partition_bits_(join.GetRadixPartitionBits()) {
   CodeGen &codegen = GetCodeGen();
   QueryState &query_state = context.GetQueryState();
 
+  // When partitioning, the right side is materialized in a pipeline of its own
+  // and the join produces the tuples of its parent. Joining the partitions
+  // happens serially (for now ...)
+  if (UseRadixPartitioning()) {
+    pipeline.MarkSource(this, Pipeline::Parallelism::Serial);
+    right_pipeline_.reset(new Pipeline(this, Pipeline::Parallelism::Flexible));
+  }
+  Pipeline &right_pipeline =
+      UseRadixPartitioning() ? *right_pipeline_ : pipeline;
+
   // If we should be prefetching into the hash-table, install a boundary in the
   // both the left and right pipeline at the input into this translator to
   // ensure it receives a vector of input tuples
   if (UsePrefetching()) {
     left_pipeline_.InstallStageBoundary(this);
-    pipeline.InstallStageBoundary(this);
+    right_pipeline.InstallStageBoundary(this);
   }
 
   // Allocate state for our hash table and bloom filter
@@ -142,9 +195,14 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
         "bloomfilter", BloomFilterProxy::GetType(codegen));
   }
 
+  if (UseRadixPartitioning()) {
+    probe_table_id_ = query_state.RegisterState(
+        "joinProbe", HashTableProxy::GetType(codegen));
+  }
+
   // Prepare translators for the left and right input operators
   context.Prepare(*join.GetChild(0), left_pipeline_);
-  context.Prepare(*join.GetChild(1)->GetChild(0), pipeline);
+  context.Prepare(*join.GetChild(1)->GetChild(0), right_pipeline);
 
   // Prepare the expressions that produce the build-size keys
   join.GetLeftHashKeys(left_key_exprs_);
@@ -215,12 +273,40 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
   // Create the hash table
   hash_table_ =
       HashTable{codegen, left_key_type, left_value_storage_.MaxStorageSize()};
+
+  if (UseRadixPartitioning()) {
+    // Collect (unique) attributes of the right side that are materialized
+    std::unordered_set<const planner::AttributeInfo *> right_key_ais;
+    for (auto *right_key_exp : right_key_exprs_) {
+      if (right_key_exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+        auto *tve = static_cast<const expression::TupleValueExpression *>(
+            right_key_exp);
+        right_key_ais.insert(tve->GetAttributeRef());
+      }
+    }
+    std::vector<type::Type> right_value_types;
+    for (const auto *right_val_ai : join.GetRightAttributes()) {
+      if (right_key_ais.count(right_val_ai) == 0) {
+        right_val_ais_.push_back(right_val_ai);
+        right_value_types.push_back(right_val_ai->type);
+      }
+    }
+    right_value_storage_.Setup(codegen, right_value_types);
+
+    // Create the table the right side is materialized in
+    probe_table_ = HashTable{codegen, right_key_type,
+                             right_value_storage_.MaxStorageSize()};
+  }
 }
 
 // Initialize the hash-table instance
 void HashJoinTranslator::InitializeQueryState() {
   hash_table_.Init(GetCodeGen(), GetExecutorContextPtr(),
                    LoadStatePtr(hash_table_id_));
+  if (UseRadixPartitioning()) {
+    probe_table_.Init(GetCodeGen(), GetExecutorContextPtr(),
+                      LoadStatePtr(probe_table_id_));
+  }
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     bloom_filter_.Init(GetCodeGen(), LoadStatePtr(bloom_filter_id_),
                        EstimateCardinalityLeft());
@@ -235,6 +321,16 @@ void HashJoinTranslator::Produce() const {
   // Let the right child produce tuples, which we use to probe the hash table
   GetCompilationContext().Produce(*GetJoinPlan().GetChild(1)->GetChild(0));
 
+  if (UseRadixPartitioning()) {
+    // Both sides are materialized and partitioned, join them
+    auto producer = [this](ConsumerContext &ctx) { JoinPartitions(ctx); };
+
+    // We set the pipeline to be serial in the constructor. Sanity check here.
+    auto &pipeline = GetPipeline();
+    PELOTON_ASSERT(!pipeline.IsParallel());
+    pipeline.RunSerial(producer);
+  }
+
   // That's it, we've produced all the tuples
 }
 
@@ -376,82 +472,225 @@ void HashJoinTranslator::ConsumeFromLeft(ConsumerContext &ctx,
 
   // Update bloom filter, if enabled
   if (GetJoinPlan().IsBloomFilterEnabled()) {
-    bloom_filter_.Add(codegen, LoadStatePtr(bloom_filter_id_), key);
+    llvm::Value *bloom_filter_ptr = nullptr;
+    if (ctx.GetPipeline().IsParallel()) {
+      bloom_filter_ptr =
+          ctx.GetPipelineContext()->LoadStatePtr(codegen, bloom_filter_tl_id_);
+    } else {
+      bloom_filter_ptr = LoadStatePtr(bloom_filter_id_);
+    }
+    bloom_filter_.Add(codegen, bloom_filter_ptr, key);
   }
 }
 
 void HashJoinTranslator::RegisterPipelineState(PipelineContext &pipeline_ctx) {
-  if (pipeline_ctx.IsParallel() && IsLeftPipeline(pipeline_ctx.GetPipeline())) {
+  if (!pipeline_ctx.IsParallel()) {
+    return;
+  }
+
+  CodeGen &codegen = GetCodeGen();
+  if (IsLeftPipeline(pipeline_ctx.GetPipeline())) {
     hash_table_tl_id_ = pipeline_ctx.RegisterState(
-        "localHT", HashTableProxy::GetType(GetCodeGen()));
+        "localHT", HashTableProxy::GetType(codegen));
+
+    // Concurrent inserts would race on the bits of a shared bloom filter, so
+    // each thread fills its own and they're merged when the build finishes.
+    if (GetJoinPlan().IsBloomFilterEnabled()) {
+      bloom_filter_tl_id_ = pipeline_ctx.RegisterState(
+          "localBloomFilter", BloomFilterProxy::GetType(codegen));
+    }
+  } else if (IsRightPipeline(pipeline_ctx.GetPipeline())) {
+    probe_table_tl_id_ = pipeline_ctx.RegisterState(
+        "localProbeHT", HashTableProxy::GetType(codegen));
   }
 }
 
 void HashJoinTranslator::InitializePipelineState(
     PipelineContext &pipeline_ctx) {
-  if (pipeline_ctx.IsParallel() && IsLeftPipeline(pipeline_ctx.GetPipeline())) {
-    CodeGen &codegen = GetCodeGen();
+  if (!pipeline_ctx.IsParallel()) {
+    return;
+  }
+
+  CodeGen &codegen = GetCodeGen();
+  if (IsLeftPipeline(pipeline_ctx.GetPipeline())) {
     hash_table_.Init(codegen, GetExecutorContextPtr(),
                      pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_));
+    if (GetJoinPlan().IsBloomFilterEnabled()) {
+      bloom_filter_.Init(
+          codegen, pipeline_ctx.LoadStatePtr(codegen, bloom_filter_tl_id_),
+          EstimateCardinalityLeft());
+    }
+  } else if (IsRightPipeline(pipeline_ctx.GetPipeline())) {
+    probe_table_.Init(codegen, GetExecutorContextPtr(),
+                      pipeline_ctx.LoadStatePtr(codegen, probe_table_tl_id_));
   }
 }
 
 void HashJoinTranslator::FinishPipeline(PipelineContext &pipeline_ctx) {
-  if (IsLeftPipeline(pipeline_ctx.GetPipeline())) {
-    CodeGen &codegen = GetCodeGen();
-    llvm::Value *global_ht_ptr = LoadStatePtr(hash_table_id_);
-    if (!pipeline_ctx.IsParallel()) {
-      // Build the hash table over the lazily inserted tuples
-      hash_table_.BuildLazy(codegen, global_ht_ptr);
-    } else {
-      // First size the global hash table
-      hash_table_.ReserveLazy(
-          codegen, global_ht_ptr, GetThreadStatesPtr(),
-          pipeline_ctx.GetEntryOffset(codegen, hash_table_tl_id_));
-
-      // Then merge each local table in parallel
-      PipelineContext::LoopOverStates loop_states{pipeline_ctx};
-      loop_states.DoParallel([this, &pipeline_ctx, &codegen](
-          UNUSED_ATTRIBUTE llvm::Value *thread_state) {
-        llvm::Value *global_ht_ptr = LoadStatePtr(hash_table_id_);
-        llvm::Value *local_ht_ptr =
-            pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_);
-        hash_table_.MergeLazyUnfinished(codegen, global_ht_ptr, local_ht_ptr);
-      });
-    }
+  if (IsRightPipeline(pipeline_ctx.GetPipeline())) {
+    // The right side is materialized, partition it like the left side
+    PartitionTable(pipeline_ctx, probe_table_, probe_table_id_,
+                   probe_table_tl_id_);
+    return;
+  }
+
+  if (!IsLeftPipeline(pipeline_ctx.GetPipeline())) {
+    return;
+  }
+
+  CodeGen &codegen = GetCodeGen();
+  if (UseRadixPartitioning()) {
+    // Partition the left side, the hash tables are built per partition
+    PartitionTable(pipeline_ctx, hash_table_, hash_table_id_,
+                   hash_table_tl_id_);
+  } else if (!pipeline_ctx.IsParallel()) {
+    // Build the hash table over the lazily inserted tuples
+    hash_table_.BuildLazy(codegen, LoadStatePtr(hash_table_id_));
+  } else {
+    // First size the global hash table
+    hash_table_.ReserveLazy(
+        codegen, LoadStatePtr(hash_table_id_), GetThreadStatesPtr(),
+        pipeline_ctx.GetEntryOffset(codegen, hash_table_tl_id_));
+
+    // Then merge each local table in parallel
+    PipelineContext::LoopOverStates loop_states{pipeline_ctx};
+    loop_states.DoParallel([this, &pipeline_ctx, &codegen](
+        UNUSED_ATTRIBUTE llvm::Value *thread_state) {
+      llvm::Value *global_ht_ptr = LoadStatePtr(hash_table_id_);
+      llvm::Value *local_ht_ptr =
+          pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_);
+      hash_table_.MergeLazyUnfinished(codegen, global_ht_ptr, local_ht_ptr);
+    });
+  }
+
+  // Union the thread-local bloom filters into the global one. This only
+  // touches the filter bits, so it is cheap enough to do serially.
+  if (pipeline_ctx.IsParallel() && GetJoinPlan().IsBloomFilterEnabled()) {
+    PipelineContext::LoopOverStates loop_states{pipeline_ctx};
+    loop_states.Do([this, &pipeline_ctx, &codegen](llvm::Value *thread_state) {
+      PipelineContext::SetState state_access(pipeline_ctx, thread_state);
+      llvm::Value *local_bloom_filter_ptr =
+          pipeline_ctx.LoadStatePtr(codegen, bloom_filter_tl_id_);
+      bloom_filter_.Merge(codegen, LoadStatePtr(bloom_filter_id_),
+                          local_bloom_filter_ptr);
+    });
   }
 }
 
 void HashJoinTranslator::TearDownPipelineState(PipelineContext &pipeline_ctx) {
-  if (pipeline_ctx.IsParallel() && IsLeftPipeline(pipeline_ctx.GetPipeline())) {
-    CodeGen &codegen = GetCodeGen();
+  if (!pipeline_ctx.IsParallel()) {
+    return;
+  }
+
+  CodeGen &codegen = GetCodeGen();
+  if (IsLeftPipeline(pipeline_ctx.GetPipeline())) {
     auto *local_ht_ptr = pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_);
     hash_table_.Destroy(codegen, local_ht_ptr);
+    if (GetJoinPlan().IsBloomFilterEnabled()) {
+      bloom_filter_.Destroy(
+          codegen, pipeline_ctx.LoadStatePtr(codegen, bloom_filter_tl_id_));
+    }
+  } else if (IsRightPipeline(pipeline_ctx.GetPipeline())) {
+    probe_table_.Destroy(
+        codegen, pipeline_ctx.LoadStatePtr(codegen, probe_table_tl_id_));
+  }
+}
+
+void HashJoinTranslator::PartitionTable(PipelineContext &pipeline_ctx,
+                                        const HashTable &table,
+                                        QueryState::Id table_id,
+                                        PipelineContext::Id table_tl_id) const {
+  CodeGen &codegen = GetCodeGen();
+  llvm::Value *table_ptr = LoadStatePtr(table_id);
+  if (!pipeline_ctx.IsParallel()) {
+    table.PartitionLazy(codegen, table_ptr, radix_partition_bits_);
+  } else {
+    // Partition straight out of the thread-local tables
+    table.PartitionLazyParallel(
+        codegen, table_ptr, GetThreadStatesPtr(),
+        pipeline_ctx.GetEntryOffset(codegen, table_tl_id),
+        radix_partition_bits_);
+  }
+}
+
+void HashJoinTranslator::JoinPartitions(ConsumerContext &context) const {
+  CodeGen &codegen = GetCodeGen();
+
+  // Every materialized right-side tuple is sent up in a batch of one row
+  auto *raw_vec =
+      codegen.AllocateBuffer(codegen.Int32Type(), 1, "joinSelVector");
+  Vector selection_vector{raw_vec, 1, codegen.Int32Type()};
+  selection_vector.SetValue(codegen, codegen.Const32(0), codegen.Const32(0));
+
+  llvm::Value *num_partitions = codegen.Const32(1u << radix_partition_bits_);
+  llvm::Value *partition_id = codegen.Const32(0);
+  llvm::Value *loop_cond = codegen->CreateICmpULT(partition_id, num_partitions);
+  lang::Loop partition_loop{codegen, loop_cond,
+                            {{"partitionId", partition_id}}};
+  {
+    partition_id = partition_loop.GetLoopVar(0);
+
+    // Build the hash table over the left side of the partition, then probe it
+    // with the right side of the same partition
+    hash_table_.BuildPartition(codegen, LoadStatePtr(hash_table_id_),
+                               partition_id);
+    ProbePartition probe_partition{*this, context, selection_vector};
+    probe_table_.IteratePartition(codegen, LoadStatePtr(probe_table_id_),
+                                  partition_id, probe_partition);
+
+    partition_id = codegen->CreateAdd(partition_id, codegen.Const32(1));
+    partition_loop.LoopEnd(codegen->CreateICmpULT(partition_id, num_partitions),
+                           {partition_id});
   }
 }
 
 // The given row is from the right child. Probe hash-table.
 void HashJoinTranslator::ConsumeFromRight(ConsumerContext &context,
                                           RowBatch::Row &row) const {
+  CodeGen &codegen = GetCodeGen();
+
   // Pull out the values of the keys we probe the hash-table with
   std::vector<codegen::Value> key;
   CollectKeys(row, right_key_exprs_, key);
 
+  // When partitioning, the tuple is only materialized for now
+  auto probe = [this, &codegen, &context, &row, &key]() {
+    if (!UseRadixPartitioning()) {
+      CodegenHashProbe(context, row, key);
+      return;
+    }
+
+    std::vector<codegen::Value> vals;
+    CollectValues(row, right_val_ais_, vals);
+
+    llvm::Value *ht_ptr = nullptr;
+    if (context.GetPipeline().IsParallel()) {
+      ht_ptr = context.GetPipelineContext()->LoadStatePtr(codegen,
+                                                          probe_table_tl_id_);
+    } else {
+      ht_ptr = LoadStatePtr(probe_table_id_);
+    }
+
+    // InsertLeft only serializes the given values, use it for the right side
+    InsertLeft insert_right{right_value_storage_, vals};
+    probe_table_.InsertLazy(codegen, ht_ptr, nullptr, key, insert_right);
+  };
+
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     // Prefilter the tuple using Bloom Filter
-    llvm::Value *contains = bloom_filter_.Contains(
-        GetCodeGen(), LoadStatePtr(bloom_filter_id_), key);
+    llvm::Value *contains =
+        bloom_filter_.Contains(codegen, LoadStatePtr(bloom_filter_id_), key);
 
-    lang::If is_valid_row{GetCodeGen(), contains};
+    lang::If is_valid_row{codegen, contains};
     {
       // For each tuple that passes the bloom filter, probe the hash table
       // to eliminate the false positives.
-      CodegenHashProbe(context, row, key);
+      probe();
     }
     is_valid_row.EndIf();
   } else {
     // Bloom filter is not enabled. Directly probe the hash table
-    CodegenHashProbe(context, row, key);
+    probe();
   }
 }
 
@@ -470,6 +709,9 @@ void HashJoinTranslator::CodegenHashProbe(
 void HashJoinTranslator::TearDownQueryState() {
   CodeGen &codegen = GetCodeGen();
   hash_table_.Destroy(codegen, LoadStatePtr(hash_table_id_));
+  if (UseRadixPartitioning()) {
+    probe_table_.Destroy(codegen, LoadStatePtr(probe_table_id_));
+  }
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     bloom_filter_.Destroy(GetCodeGen(), LoadStatePtr(bloom_filter_id_));
   }
@@ -579,5 +821,44 @@ void HashJoinTranslator::ProbeRight::ProcessEntry(
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// ProbePartition
+///
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinTranslator::ProbePartition::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &key,
+    llvm::Value *data_area) const {
+  // Put the right-side tuple into a batch of one row
+  RowBatch batch{join_translator_.GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), selection_vector_, false};
+  RowBatch::Row row = batch.GetRowAt(codegen.Const32(0));
+
+  // Load all the values from the partition entry into the row
+  std::vector<codegen::Value> right_vals;
+  join_translator_.right_value_storage_.LoadValues(codegen, data_area,
+                                                   right_vals);
+  const auto &right_val_ais = join_translator_.right_val_ais_;
+  for (uint32_t i = 0; i < right_val_ais.size(); i++) {
+    row.RegisterAttributeValue(right_val_ais[i], right_vals[i]);
+  }
+
+  const auto &right_key_exprs = join_translator_.right_key_exprs_;
+  for (uint32_t i = 0; i < right_key_exprs.size(); i++) {
+    const auto *exp = right_key_exprs[i];
+    if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+      row.RegisterAttributeValue(tve->GetAttributeRef(), key[i]);
+    }
+  }
+
+  // Find all join partners in the left side of the partition
+  ProbeRight probe_right{join_translator_, context_, row, key};
+  join_translator_.hash_table_.FindAll(
+      codegen, join_translator_.LoadStatePtr(join_translator_.hash_table_id_),
+      key, probe_right);
+}
+
 }  // namespace codegen
-}  // namespace peloton
\ No newline at end of file
+}  // namespace peloton
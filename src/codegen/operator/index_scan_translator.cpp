@@ -0,0 +1,385 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_translator.cpp
+//
+// Identification: src/codegen/operator/index_scan_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/index_scan_translator.h"
+
+#include "codegen/lang/loop.h"
+#include "codegen/proxy/index_scanner_proxy.h"
+#include "codegen/proxy/runtime_functions_proxy.h"
+#include "codegen/proxy/storage_manager_proxy.h"
+#include "codegen/proxy/transaction_runtime_proxy.h"
+#include "codegen/type/boolean_type.h"
+#include "codegen/vector.h"
+#include "expression/expression_util.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/index_scan_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace codegen {
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// AttributeAccess
+///
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Deferred access to an attribute of a row in the tile group of the run that's
+ * currently being produced.
+ */
+class IndexScanTranslator::AttributeAccess : public RowBatch::AttributeAccess {
+ public:
+  AttributeAccess(const TileGroup::TileGroupAccess &access,
+                  const planner::AttributeInfo *ai)
+      : tile_group_access_(access), ai_(ai) {}
+
+  // Access an attribute in the given row
+  codegen::Value Access(CodeGen &codegen, RowBatch::Row &row) override {
+    auto raw_row = tile_group_access_.GetRow(row.GetTID(codegen));
+    return raw_row.LoadColumn(codegen, ai_->attribute_id);
+  }
+
+  const planner::AttributeInfo *GetAttributeRef() const { return ai_; }
+
+ private:
+  // The accessor we use to load column values
+  const TileGroup::TileGroupAccess &tile_group_access_;
+  // The attribute we will access
+  const planner::AttributeInfo *ai_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// Index Scan Translator
+///
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// If the given predicate conjunct is the condition on the key column with the
+// given comparison, return the expression providing the key's value. The
+// matching mirrors how the optimizer derives index keys from predicates.
+const expression::AbstractExpression *MatchKeyCondition(
+    const expression::AbstractExpression &conjunct, oid_t col_id,
+    ExpressionType expr_type) {
+  if (conjunct.GetChildrenSize() != 2) {
+    return nullptr;
+  }
+
+  auto is_value = [](const expression::AbstractExpression *expr) {
+    auto type = expr->GetExpressionType();
+    return type == ExpressionType::VALUE_CONSTANT ||
+           type == ExpressionType::VALUE_PARAMETER;
+  };
+  auto is_key_column = [col_id](const expression::AbstractExpression *expr) {
+    if (expr->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      return false;
+    }
+    auto *tve = static_cast<const expression::TupleValueExpression *>(expr);
+    return tve->GetColumnId() == static_cast<int>(col_id);
+  };
+
+  const auto *left = conjunct.GetChild(0);
+  const auto *right = conjunct.GetChild(1);
+  auto type = conjunct.GetExpressionType();
+  if (is_key_column(left) && is_value(right) && type == expr_type) {
+    return right;
+  }
+  if (is_value(left) && is_key_column(right) &&
+      expression::ExpressionUtil::ReverseComparisonExpressionType(type) ==
+          expr_type) {
+    return left;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+IndexScanTranslator::IndexScanTranslator(const planner::IndexScanPlan &scan,
+                                         CompilationContext &context,
+                                         Pipeline &pipeline)
+    : OperatorTranslator(scan, context, pipeline),
+      tile_group_(*scan.GetTable()->GetSchema()),
+      batch_size_(Vector::kDefaultVectorSize.load()) {
+  // Index scans produce tuples in index order, so they always run serially
+  pipeline.MarkSource(this, Pipeline::Parallelism::Serial);
+
+  // Register the index scanner instance
+  auto &query_state = context.GetQueryState();
+  scanner_id_ = query_state.RegisterState(
+      "indexScanner", IndexScannerProxy::GetType(GetCodeGen()));
+
+  // If there is a predicate, prepare a translator for it
+  const auto *predicate = scan.GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+}
+
+void IndexScanTranslator::InitializeQueryState() {
+  CodeGen &codegen = GetCodeGen();
+
+  const auto &scan = GetScanPlan();
+  const storage::DataTable &table = *scan.GetTable();
+
+  // Find where the value of each key comes from
+  std::vector<const expression::AbstractExpression *> key_values;
+  UNUSED_ATTRIBUTE bool all_keys_found =
+      GetKeyValueExpressions(scan, key_values);
+  PELOTON_ASSERT(all_keys_found);
+
+  // The key conditions are passed to the scanner as constant arrays. The key
+  // values themselves are referred to by their index in the query parameters.
+  auto &parameter_cache = GetCompilationContext().GetParameterCache();
+  std::vector<uint32_t> key_column_ids, key_param_idxs;
+  std::vector<int32_t> expr_types;
+  for (uint32_t i = 0; i < key_values.size(); i++) {
+    key_column_ids.push_back(scan.GetKeyColumnIds()[i]);
+    expr_types.push_back(static_cast<int32_t>(scan.GetExprTypes()[i]));
+    key_param_idxs.push_back(parameter_cache.GetParameterIndex(key_values[i]));
+  }
+
+  auto num_keys = static_cast<uint32_t>(key_values.size());
+  auto const_array = [&codegen, num_keys](const void *data,
+                                          const std::string &name) {
+    auto *arr_type = codegen.Int32Type()->getPointerTo();
+    if (num_keys == 0) {
+      return static_cast<llvm::Value *>(codegen.NullPtr(arr_type));
+    }
+    auto *bytes =
+        codegen.ConstGenericBytes(data, num_keys * sizeof(uint32_t), name);
+    return codegen->CreatePointerCast(bytes, arr_type);
+  };
+
+  // Load the table
+  llvm::Value *db_oid = codegen.Const32(table.GetDatabaseOid());
+  llvm::Value *table_oid = codegen.Const32(table.GetOid());
+  llvm::Value *table_ptr =
+      codegen.Call(StorageManagerProxy::GetTableWithOid,
+                   {GetStorageManagerPtr(), db_oid, table_oid});
+
+  // Call IndexScanner::Init()
+  codegen.Call(IndexScannerProxy::Init,
+               {LoadStatePtr(scanner_id_), GetExecutorContextPtr(), table_ptr,
+                codegen.Const32(scan.GetIndexId()),
+                const_array(key_column_ids.data(), "keyColumnIds"),
+                const_array(expr_types.data(), "keyExprTypes"),
+                const_array(key_param_idxs.data(), "keyParamIdxs"),
+                codegen.Const32(num_keys), codegen.Const32(batch_size_)});
+}
+
+// Produce the tuples the index scanner finds:
+//
+// @code
+// scanner.Scan()
+//
+// for (run := 0; run < scanner.GetNumRuns(); run++) {
+//   tile_group_ptr := scanner.GetTileGroup(run)
+//   sel_vec := scanner.GetTupleOffsets(run)
+//   FilterRowsByPredicate(tile_group_ptr, sel_vec)
+//   PerformReads(tile_group_ptr, sel_vec)
+//   Consume(sel_vec)
+// }
+// @endcode
+//
+void IndexScanTranslator::Produce() const {
+  auto producer = [this](ConsumerContext &ctx) {
+    CodeGen &codegen = GetCodeGen();
+    const auto &scan = GetScanPlan();
+
+    // Probe the index
+    llvm::Value *scanner_ptr = LoadStatePtr(scanner_id_);
+    codegen.Call(IndexScannerProxy::Scan, {scanner_ptr});
+
+    // The space for the layouts of the columns in the tile group of each run
+    uint32_t num_columns = scan.GetTable()->GetSchema()->GetColumnCount();
+    llvm::Value *column_layouts = codegen.AllocateBuffer(
+        ColumnLayoutInfoProxy::GetType(codegen), num_columns, "columnLayout");
+
+    llvm::Value *num_runs =
+        codegen.Call(IndexScannerProxy::GetNumRuns, {scanner_ptr});
+    llvm::Value *run_idx = codegen.Const32(0);
+    lang::Loop run_loop{codegen, codegen->CreateICmpULT(run_idx, num_runs),
+                        {{"runIdx", run_idx}}};
+    {
+      run_idx = run_loop.GetLoopVar(0);
+
+      // Set up access to the tile group of the run
+      llvm::Value *tile_group_ptr = codegen.Call(
+          IndexScannerProxy::GetTileGroup, {scanner_ptr, run_idx});
+      llvm::Value *tile_group_id =
+          tile_group_.GetTileGroupId(codegen, tile_group_ptr);
+      auto col_layouts = tile_group_.GetColumnLayouts(codegen, tile_group_ptr,
+                                                      column_layouts);
+      TileGroup::TileGroupAccess tile_group_access{tile_group_, col_layouts};
+
+      // The offsets of the tuples in the run form the selection vector
+      llvm::Value *offsets = codegen.Call(IndexScannerProxy::GetTupleOffsets,
+                                          {scanner_ptr, run_idx});
+      llvm::Value *num_tuples =
+          codegen.Call(IndexScannerProxy::GetNumTuples, {scanner_ptr, run_idx});
+      Vector selection_vector{offsets, batch_size_, codegen.Int32Type()};
+      selection_vector.SetNumElements(num_tuples);
+
+      // 1. Filter rows by the given predicate (if one exists)
+      if (scan.GetPredicate() != nullptr) {
+        FilterRowsByPredicate(codegen, tile_group_access, tile_group_id,
+                              num_tuples, selection_vector);
+      }
+
+      // 2. Record reads for all of the tuples that pass the predicate
+      PerformReads(codegen, tile_group_ptr, selection_vector);
+
+      // 3. Setup the (filtered) row batch and setup attribute accessors
+      RowBatch batch{ctx.GetCompilationContext(), tile_group_id,
+                     codegen.Const32(0), num_tuples, selection_vector, true};
+
+      std::vector<const planner::AttributeInfo *> ais;
+      scan.GetAttributes(ais);
+      const auto &output_col_ids = scan.GetColumnIds();
+
+      std::vector<AttributeAccess> attribute_accesses;
+      for (oid_t col_idx = 0; col_idx < output_col_ids.size(); col_idx++) {
+        attribute_accesses.emplace_back(tile_group_access,
+                                        ais[output_col_ids[col_idx]]);
+      }
+      for (oid_t col_idx = 0; col_idx < output_col_ids.size(); col_idx++) {
+        batch.AddAttribute(ais[output_col_ids[col_idx]],
+                           &attribute_accesses[col_idx]);
+      }
+
+      // 4. Push the batch into the pipeline
+      ctx.Consume(batch);
+
+      // Move to the next run
+      run_idx = codegen->CreateAdd(run_idx, codegen.Const32(1));
+      run_loop.LoopEnd(codegen->CreateICmpULT(run_idx, num_runs), {run_idx});
+    }
+  };
+
+  // Execute serially
+  GetPipeline().RunSerial(producer);
+}
+
+void IndexScanTranslator::TearDownQueryState() {
+  auto *scanner_ptr = LoadStatePtr(scanner_id_);
+  GetCodeGen().Call(IndexScannerProxy::Destroy, {scanner_ptr});
+}
+
+void IndexScanTranslator::FilterRowsByPredicate(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tile_group_id, llvm::Value *num_tuples,
+    Vector &selection_vector) const {
+  // The batch we're filtering
+  RowBatch batch{GetCompilationContext(), tile_group_id, codegen.Const32(0),
+                 num_tuples, selection_vector, true};
+
+  // Determine the attributes the predicate needs
+  const auto *predicate = GetScanPlan().GetPredicate();
+
+  std::unordered_set<const planner::AttributeInfo *> used_attributes;
+  predicate->GetUsedAttributes(used_attributes);
+
+  // Setup the row batch with attribute accessors for the predicate
+  std::vector<AttributeAccess> attribute_accessors;
+  for (const auto *ai : used_attributes) {
+    attribute_accessors.emplace_back(access, ai);
+  }
+  for (uint32_t i = 0; i < attribute_accessors.size(); i++) {
+    auto &accessor = attribute_accessors[i];
+    batch.AddAttribute(accessor.GetAttributeRef(), &accessor);
+  }
+
+  // Iterate over the batch using a scalar loop
+  batch.Iterate(codegen, [&](RowBatch::Row &row) {
+    // Evaluate the predicate to determine row validity
+    codegen::Value valid_row = row.DeriveValue(codegen, *predicate);
+
+    // Reify the boolean value since it may be NULL
+    PELOTON_ASSERT(valid_row.GetType().GetSqlType() ==
+                   type::Boolean::Instance());
+    llvm::Value *bool_val = type::Boolean::Instance().Reify(codegen, valid_row);
+
+    // Set the validity of the row
+    row.SetValidity(codegen, bool_val);
+  });
+}
+
+void IndexScanTranslator::PerformReads(CodeGen &codegen,
+                                       llvm::Value *tile_group_ptr,
+                                       Vector &selection_vector) const {
+  auto &compilation_ctx = GetCompilationContext();
+  ExecutionConsumer &ec = compilation_ctx.GetExecutionConsumer();
+  llvm::Value *txn = ec.GetTransactionPtr(compilation_ctx);
+  llvm::Value *raw_sel_vec = selection_vector.GetVectorPtr();
+
+  llvm::Value *is_for_update = codegen.ConstBool(GetScanPlan().IsForUpdate());
+  llvm::Value *end_idx = selection_vector.GetNumElements();
+
+  // Invoke TransactionRuntime::PerformVectorizedRead(...)
+  llvm::Value *out_idx =
+      codegen.Call(TransactionRuntimeProxy::PerformVectorizedRead,
+                   {txn, tile_group_ptr, raw_sel_vec, end_idx, is_for_update});
+  selection_vector.SetNumElements(out_idx);
+}
+
+bool IndexScanTranslator::GetKeyValueExpressions(
+    const planner::IndexScanPlan &scan,
+    std::vector<const expression::AbstractExpression *> &key_values) {
+  key_values.clear();
+
+  // Collect the conjuncts of the predicate, in order
+  std::vector<const expression::AbstractExpression *> conjuncts;
+  std::vector<const expression::AbstractExpression *> stack;
+  if (scan.GetPredicate() != nullptr) {
+    stack.push_back(scan.GetPredicate());
+  }
+  while (!stack.empty()) {
+    const auto *expr = stack.back();
+    stack.pop_back();
+    if (expr->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+      for (size_t i = expr->GetChildrenSize(); i > 0; i--) {
+        stack.push_back(expr->GetChild(i - 1));
+      }
+    } else {
+      conjuncts.push_back(expr);
+    }
+  }
+
+  // Match every key condition with a distinct conjunct
+  const auto &key_column_ids = scan.GetKeyColumnIds();
+  const auto &expr_types = scan.GetExprTypes();
+  std::vector<bool> used(conjuncts.size(), false);
+  for (uint32_t i = 0; i < key_column_ids.size(); i++) {
+    const expression::AbstractExpression *key_value = nullptr;
+    for (uint32_t j = 0; j < conjuncts.size() && key_value == nullptr; j++) {
+      if (!used[j]) {
+        key_value =
+            MatchKeyCondition(*conjuncts[j], key_column_ids[i], expr_types[i]);
+        used[j] = (key_value != nullptr);
+      }
+    }
+    if (key_value == nullptr) {
+      return false;
+    }
+    key_values.push_back(key_value);
+  }
+  return true;
+}
+
+const planner::IndexScanPlan &IndexScanTranslator::GetScanPlan() const {
+  return GetPlanAs<planner::IndexScanPlan>();
+}
+
+}  // namespace codegen
+}  // namespace peloton
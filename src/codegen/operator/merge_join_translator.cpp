@@ -0,0 +1,316 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator.cpp
+//
+// Identification: src/codegen/operator/merge_join_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/merge_join_translator.h"
+
+#include <unordered_set>
+
+#include "codegen/compilation_context.h"
+#include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
+#include "codegen/operator/projection_translator.h"
+#include "codegen/proxy/buffer_proxy.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/merge_join_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// The psuedocode for an INNER merge join is:
+///
+/// function main():
+///   Buffer b
+///   for r in R:
+///     b.insert(r)
+///
+///   cursor = 0
+///   for s in S:
+///     while cursor < b.size() and b[cursor].key < s.key:
+///       cursor++
+///     for i in [cursor, b.size()) while b[i].key == s.key:
+///       if pred(b[i], s):
+///         emit(b[i], s)
+///
+/// Tuples with a NULL key never join, so they're skipped on both sides.
+///
+////////////////////////////////////////////////////////////////////////////////
+
+MergeJoinTranslator::MergeJoinTranslator(const planner::MergeJoinPlan &join,
+                                         CompilationContext &context,
+                                         Pipeline &pipeline)
+    : OperatorTranslator(join, context, pipeline),
+      left_pipeline_(this, Pipeline::Parallelism::Serial) {
+  PELOTON_ASSERT(join.GetChildrenSize() == 2 &&
+                 "Merge join must have exactly two children");
+
+  // The right side moves the cursor, so it must be consumed in order
+  pipeline.SetSerial();
+
+  // Prepare children
+  context.Prepare(*join.GetChild(0), left_pipeline_);
+  context.Prepare(*join.GetChild(1), pipeline);
+
+  // Prepare the keys of both sides
+  for (const auto &join_clause : *join.GetJoinClauses()) {
+    context.Prepare(*join_clause.left_);
+    context.Prepare(*join_clause.right_);
+    left_key_exprs_.push_back(join_clause.left_.get());
+    right_key_exprs_.push_back(join_clause.right_.get());
+  }
+  PELOTON_ASSERT(!left_key_exprs_.empty());
+
+  // Prepare join predicate (if one exists)
+  auto *predicate = join.GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+
+  // Prepare projection (if one exists)
+  auto *projection = join.GetProjInfo();
+  if (projection != nullptr) {
+    ProjectionTranslator::PrepareProjection(context, *projection);
+  }
+
+  // Collect (unique) attributes that are buffered along with the keys
+  std::unordered_set<const planner::AttributeInfo *> left_key_ais;
+  for (const auto *left_key_exp : left_key_exprs_) {
+    if (left_key_exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto *tve =
+          static_cast<const expression::TupleValueExpression *>(left_key_exp);
+      left_key_ais.insert(tve->GetAttributeRef());
+    }
+  }
+  for (const auto *left_val_ai : join.GetLeftAttributes()) {
+    if (left_key_ais.count(left_val_ai) == 0) {
+      left_val_ais_.push_back(left_val_ai);
+    }
+  }
+
+  // Construct the layout of tuples we store in our buffer
+  std::vector<type::Type> left_input_desc;
+  for (const auto *left_key_exp : left_key_exprs_) {
+    left_input_desc.push_back(left_key_exp->ResultType());
+  }
+  for (const auto *left_val_ai : left_val_ais_) {
+    left_input_desc.push_back(left_val_ai->type);
+  }
+
+  // Allocate the buffer and the cursor in the runtime state
+  CodeGen &codegen = GetCodeGen();
+  QueryState &query_state = context.GetQueryState();
+  buffer_id_ =
+      query_state.RegisterState("mjBuffer", BufferProxy::GetType(codegen));
+  cursor_id_ = query_state.RegisterState("mjCursor", codegen.Int64Type());
+  buffer_ = BufferAccessor(codegen, left_input_desc);
+}
+
+void MergeJoinTranslator::InitializeQueryState() {
+  CodeGen &codegen = GetCodeGen();
+  buffer_.Init(codegen, LoadStatePtr(buffer_id_));
+  codegen->CreateStore(codegen.Const64(0), LoadStatePtr(cursor_id_));
+}
+
+void MergeJoinTranslator::TearDownQueryState() {
+  buffer_.Destroy(GetCodeGen(), LoadStatePtr(buffer_id_));
+}
+
+void MergeJoinTranslator::Produce() const {
+  // Let the left child produce tuples which we buffer
+  GetCompilationContext().Produce(*GetPlan().GetChild(0));
+
+  // Let the right child produce tuples, which we merge with the buffer
+  GetCompilationContext().Produce(*GetPlan().GetChild(1));
+}
+
+void MergeJoinTranslator::Consume(ConsumerContext &context,
+                                  RowBatch::Row &row) const {
+  if (IsFromLeftChild(context.GetPipeline())) {
+    ConsumeFromLeft(context, row);
+  } else {
+    ConsumeFromRight(context, row);
+  }
+}
+
+void MergeJoinTranslator::ConsumeFromLeft(
+    UNUSED_ATTRIBUTE ConsumerContext &context, RowBatch::Row &row) const {
+  CodeGen &codegen = GetCodeGen();
+
+  // Construct tuple
+  std::vector<codegen::Value> tuple;
+  for (const auto *left_key_exp : left_key_exprs_) {
+    tuple.push_back(row.DeriveValue(codegen, *left_key_exp));
+  }
+  for (const auto *left_val_ai : left_val_ais_) {
+    tuple.push_back(row.DeriveValue(codegen, left_val_ai));
+  }
+
+  // Append tuple to buffer
+  buffer_.Append(codegen, LoadStatePtr(buffer_id_), tuple);
+}
+
+void MergeJoinTranslator::ConsumeFromRight(ConsumerContext &context,
+                                           RowBatch::Row &row) const {
+  CodeGen &codegen = GetCodeGen();
+
+  // Pull out the values of the keys we merge on
+  std::vector<codegen::Value> right_key;
+  llvm::Value *null_key = codegen.ConstBool(false);
+  for (const auto *right_key_exp : right_key_exprs_) {
+    right_key.push_back(row.DeriveValue(codegen, *right_key_exp));
+    null_key = codegen->CreateOr(null_key, right_key.back().IsNull(codegen));
+  }
+
+  lang::If has_key{codegen, codegen->CreateNot(null_key)};
+  {
+    auto *buffer_ptr = LoadStatePtr(buffer_id_);
+    auto *start = codegen.Load(BufferProxy::buffer_start, buffer_ptr);
+    auto *end = codegen.Load(BufferProxy::buffer_pos, buffer_ptr);
+    auto *cursor = codegen->CreateInBoundsGEP(codegen.ByteType(), start,
+                                              LoadStateValue(cursor_id_));
+
+    // Skip left tuples whose keys are smaller than (or can't equal) ours
+    lang::Loop advance_loop{
+        codegen, codegen->CreateICmpNE(cursor, end), {{"leftPos", cursor}}};
+    {
+      auto *pos = advance_loop.GetLoopVar(0);
+
+      std::vector<codegen::Value> left_vals;
+      LoadLeftTuple(codegen, pos, left_vals);
+
+      llvm::Value *skip = codegen->CreateICmpSLT(
+          CompareKeys(codegen, left_vals, right_key), codegen.Const32(0));
+      for (uint32_t i = 0; i < left_key_exprs_.size(); i++) {
+        skip = codegen->CreateOr(skip, left_vals[i].IsNull(codegen));
+      }
+
+      lang::If found_start{codegen, codegen->CreateNot(skip)};
+      { advance_loop.Break(); }
+      found_start.EndIf();
+
+      auto *next =
+          codegen->CreateConstInBoundsGEP1_64(pos, buffer_.GetTupleSize());
+      advance_loop.LoopEnd(codegen->CreateICmpNE(next, end), {next});
+    }
+
+    std::vector<llvm::Value *> final_vals;
+    advance_loop.CollectFinalLoopVariables(final_vals);
+    cursor = final_vals[0];
+
+    // Remember where the next right tuple starts looking
+    auto *offset =
+        codegen->CreateSub(codegen->CreatePtrToInt(cursor, codegen.Int64Type()),
+                           codegen->CreatePtrToInt(start, codegen.Int64Type()));
+    codegen->CreateStore(offset, LoadStatePtr(cursor_id_));
+
+    // Join with every left tuple with an equal key
+    lang::Loop match_loop{
+        codegen, codegen->CreateICmpNE(cursor, end), {{"matchPos", cursor}}};
+    {
+      auto *pos = match_loop.GetLoopVar(0);
+
+      std::vector<codegen::Value> left_vals;
+      LoadLeftTuple(codegen, pos, left_vals);
+
+      auto *cmp = CompareKeys(codegen, left_vals, right_key);
+      lang::If no_match{codegen,
+                        codegen->CreateICmpNE(cmp, codegen.Const32(0))};
+      { match_loop.Break(); }
+      no_match.EndIf();
+
+      JoinRow(codegen, context, row, left_vals);
+
+      auto *next =
+          codegen->CreateConstInBoundsGEP1_64(pos, buffer_.GetTupleSize());
+      match_loop.LoopEnd(codegen->CreateICmpNE(next, end), {next});
+    }
+  }
+  has_key.EndIf();
+}
+
+void MergeJoinTranslator::LoadLeftTuple(
+    CodeGen &codegen, llvm::Value *pos,
+    std::vector<codegen::Value> &vals) const {
+  const auto &storage_format = buffer_.GetStorageFormat();
+  UpdateableStorage::NullBitmap null_bitmap(codegen, storage_format, pos);
+  for (uint32_t col_id = 0; col_id < storage_format.GetNumElements();
+       col_id++) {
+    vals.push_back(storage_format.GetValue(codegen, pos, col_id, null_bitmap));
+  }
+}
+
+llvm::Value *MergeJoinTranslator::CompareKeys(
+    CodeGen &codegen, const std::vector<codegen::Value> &left_vals,
+    const std::vector<codegen::Value> &right_key) const {
+  // The first pair of keys that differs decides the order
+  llvm::Value *result = nullptr;
+  for (uint32_t i = right_key.size(); i-- > 0;) {
+    auto *cmp = left_vals[i].CompareForSort(codegen, right_key[i]).GetValue();
+    if (result == nullptr) {
+      result = cmp;
+    } else {
+      auto *differs = codegen->CreateICmpNE(cmp, codegen.Const32(0));
+      result = codegen->CreateSelect(differs, cmp, result);
+    }
+  }
+  return result;
+}
+
+void MergeJoinTranslator::JoinRow(
+    CodeGen &codegen, ConsumerContext &context, RowBatch::Row &row,
+    const std::vector<codegen::Value> &left_vals) const {
+  // Put the values of the left tuple directly into the row
+  const uint32_t num_keys = static_cast<uint32_t>(left_key_exprs_.size());
+  for (uint32_t i = 0; i < num_keys; i++) {
+    const auto *exp = left_key_exprs_[i];
+    if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+      row.RegisterAttributeValue(tve->GetAttributeRef(), left_vals[i]);
+    }
+  }
+  for (uint32_t i = 0; i < left_val_ais_.size(); i++) {
+    row.RegisterAttributeValue(left_val_ais_[i], left_vals[num_keys + i]);
+  }
+
+  auto consume = [&context, &row, this]() {
+    const auto *projection_info = GetJoinPlan().GetProjInfo();
+    std::vector<RowBatch::ExpressionAccess> derived_attribute_access;
+    if (projection_info != nullptr) {
+      ProjectionTranslator::AddNonTrivialAttributes(
+          row.GetBatch(), *projection_info, derived_attribute_access);
+    }
+    context.Consume(row);
+  };
+
+  // Check predicate if one exists
+  auto *predicate = GetJoinPlan().GetPredicate();
+  if (predicate != nullptr) {
+    auto valid_row = row.DeriveValue(codegen, *predicate);
+    lang::If is_valid_row{codegen, valid_row};
+    {
+      // Send row up to the parent
+      consume();
+    }
+    is_valid_row.EndIf();
+  } else {
+    // Send the row up to the parent
+    consume();
+  }
+}
+
+const planner::MergeJoinPlan &MergeJoinTranslator::GetJoinPlan() const {
+  return GetPlanAs<planner::MergeJoinPlan>();
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,255 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// sort_group_by_translator.cpp
+//
+// Identification: src/codegen/operator/sort_group_by_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/sort_group_by_translator.h"
+
+#include "codegen/compilation_context.h"
+#include "codegen/lang/if.h"
+#include "codegen/operator/projection_translator.h"
+#include "codegen/vector.h"
+#include "planner/aggregate_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+SortGroupByTranslator::SortGroupByTranslator(
+    const planner::AggregatePlan &group_by, CompilationContext &context,
+    Pipeline &pipeline)
+    : OperatorTranslator(group_by, context, pipeline),
+      aggregation_(context.GetQueryState()) {
+  // Groups are only adjacent if the input is consumed in order, hence the
+  // serial pipeline. The last group is complete once the input runs out.
+  pipeline.SetSerial();
+  pipeline.InstallFlush(this);
+
+  // Prepare the input operator to this group by
+  context.Prepare(*group_by.GetChild(0), pipeline);
+
+  // Prepare the predicate if one exists
+  if (group_by.GetPredicate() != nullptr) {
+    context.Prepare(*group_by.GetPredicate());
+  }
+
+  // Prepare all the aggregation expressions
+  auto &aggregates = group_by.GetUniqueAggTerms();
+  for (const auto &agg_term : aggregates) {
+    if (agg_term.expression != nullptr) {
+      context.Prepare(*agg_term.expression);
+    }
+  }
+
+  // Prepare the projection (if one exists)
+  const auto *projection_info = group_by.GetProjectInfo();
+  if (projection_info != nullptr) {
+    ProjectionTranslator::PrepareProjection(context, *projection_info);
+  }
+
+  // Setup the storage format of the grouping keys
+  CodeGen &codegen = GetCodeGen();
+  std::vector<type::Type> key_type;
+  for (const auto *grouping_ai : group_by.GetGroupbyAIs()) {
+    key_type.push_back(grouping_ai->type);
+    key_storage_.AddType(grouping_ai->type);
+  }
+  key_storage_.Finalize(codegen);
+
+  // Setup the aggregation logic for this group by
+  aggregation_.Setup(codegen, aggregates, false, key_type);
+
+  // The group is stored as its keys followed by its aggregates, which we
+  // keep 8-byte aligned
+  aggregates_offset_ = (key_storage_.GetStorageSize() + 7) & ~7u;
+  entry_size_ = (aggregates_offset_ +
+                 aggregation_.GetAggregatesStorageSize() + 7) & ~7u;
+
+  // Register the current group in the runtime state
+  QueryState &query_state = context.GetQueryState();
+  group_id_ = query_state.RegisterState(
+      "sgbGroup", llvm::ArrayType::get(codegen.Int64Type(), entry_size_ / 8));
+  has_group_id_ = query_state.RegisterState("sgbHasGroup", codegen.BoolType());
+}
+
+void SortGroupByTranslator::InitializeQueryState() {
+  CodeGen &codegen = GetCodeGen();
+  codegen->CreateStore(codegen.ConstBool(false), LoadStatePtr(has_group_id_));
+  aggregation_.InitializeQueryState(codegen);
+}
+
+void SortGroupByTranslator::Produce() const {
+  // Let the child produce its tuples, the groups go up as they complete
+  GetCompilationContext().Produce(*GetPlan().GetChild(0));
+}
+
+// Consume the tuples from the context, grouping them into the current group
+void SortGroupByTranslator::Consume(ConsumerContext &context,
+                                    RowBatch::Row &row) const {
+  CodeGen &codegen = GetCodeGen();
+  const auto &plan = GetPlanAs<planner::AggregatePlan>();
+
+  // Collect the grouping keys
+  std::vector<codegen::Value> key;
+  for (const auto *gb_ai : plan.GetGroupbyAIs()) {
+    key.push_back(row.DeriveValue(codegen, gb_ai));
+  }
+
+  // Collect the values of the expressions
+  auto &aggregates = plan.GetUniqueAggTerms();
+  std::vector<codegen::Value> vals{aggregates.size()};
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    const auto &agg_term = aggregates[i];
+    if (agg_term.expression != nullptr) {
+      vals[i] = row.DeriveValue(codegen, *agg_term.expression);
+    }
+  }
+
+  auto *group = GetGroupPtr(codegen);
+  auto *has_group_ptr = LoadStatePtr(has_group_id_);
+  auto *has_group = codegen->CreateLoad(has_group_ptr);
+
+  llvm::Value *same_group = nullptr;
+  lang::If check_group{codegen, has_group};
+  {
+    // NULL keys are grouped together, which is what sorting them does
+    std::vector<codegen::Value> group_key;
+    LoadKeys(codegen, group, group_key);
+    llvm::Value *equal = codegen.ConstBool(true);
+    for (uint32_t i = 0; i < key.size(); i++) {
+      auto cmp = group_key[i].CompareForSort(codegen, key[i]);
+      equal = codegen->CreateAnd(
+          equal, codegen->CreateICmpEQ(cmp.GetValue(), codegen.Const32(0)));
+    }
+    same_group = equal;
+  }
+  check_group.EndIf();
+  same_group = check_group.BuildPHI(same_group, codegen.ConstBool(false));
+
+  lang::If in_group{codegen, same_group};
+  {
+    // Advance the aggregates of the current group
+    aggregation_.AdvanceValues(codegen, GetAggregateSpace(codegen, group),
+                               vals, key);
+  }
+  in_group.ElseBlock();
+  {
+    // The row starts a new group, so the current one is complete
+    lang::If group_complete{codegen, has_group};
+    {
+      ProduceGroup(context, group);
+    }
+    group_complete.EndIf();
+
+    // Start the new group in its place
+    UpdateableStorage::NullBitmap null_bitmap(codegen, key_storage_, group);
+    for (uint32_t i = 0; i < key.size(); i++) {
+      key_storage_.SetValue(codegen, group, i, key[i], null_bitmap);
+    }
+    null_bitmap.WriteBack(codegen);
+    aggregation_.CreateInitialValues(
+        codegen, GetAggregateSpace(codegen, group), vals, key);
+    codegen->CreateStore(codegen.ConstBool(true), has_group_ptr);
+  }
+  in_group.EndIf();
+}
+
+// Send the last group up, if the input had any rows
+void SortGroupByTranslator::Flush(ConsumerContext &context) const {
+  CodeGen &codegen = GetCodeGen();
+  auto *has_group = codegen->CreateLoad(LoadStatePtr(has_group_id_));
+  lang::If group_complete{codegen, has_group};
+  {
+    ProduceGroup(context, GetGroupPtr(codegen));
+  }
+  group_complete.EndIf();
+}
+
+// Cleanup by destroying the aggregation
+void SortGroupByTranslator::TearDownQueryState() {
+  aggregation_.TearDownQueryState(GetCodeGen());
+}
+
+void SortGroupByTranslator::ProduceGroup(ConsumerContext &context,
+                                         llvm::Value *entry) const {
+  CodeGen &codegen = GetCodeGen();
+  const auto &plan = GetPlanAs<planner::AggregatePlan>();
+
+  // The group is sent up in a batch of one row
+  auto *raw_vec = codegen.AllocateBuffer(codegen.Int32Type(), 1, "sgbSelVector");
+  Vector selection_vector{raw_vec, 1, codegen.Int32Type()};
+  selection_vector.SetValue(codegen, codegen.Const32(0), codegen.Const32(0));
+
+  RowBatch batch{GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), selection_vector, false};
+
+  // The keys of the group, followed by its finalized aggregates
+  std::vector<codegen::Value> group_vals;
+  LoadKeys(codegen, entry, group_vals);
+  aggregation_.FinalizeValues(codegen, GetAggregateSpace(codegen, entry),
+                              group_vals);
+
+  const auto &grouping_ais = plan.GetGroupbyAIs();
+  const auto &aggregates = plan.GetUniqueAggTerms();
+  PELOTON_ASSERT(group_vals.size() == grouping_ais.size() + aggregates.size());
+
+  std::vector<GroupValueAccess> accessors;
+  for (uint32_t i = 0; i < group_vals.size(); i++) {
+    accessors.emplace_back(group_vals, i);
+  }
+  for (uint32_t i = 0; i < grouping_ais.size(); i++) {
+    batch.AddAttribute(grouping_ais[i], &accessors[i]);
+  }
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    batch.AddAttribute(&aggregates[i].agg_ai,
+                       &accessors[i + grouping_ais.size()]);
+  }
+
+  std::vector<RowBatch::ExpressionAccess> derived_attribute_accessors;
+  const auto *project_info = plan.GetProjectInfo();
+  if (project_info != nullptr) {
+    ProjectionTranslator::AddNonTrivialAttributes(batch, *project_info,
+                                                  derived_attribute_accessors);
+  }
+
+  auto *predicate = plan.GetPredicate();
+  if (predicate != nullptr) {
+    RowBatch::Row row = batch.GetRowAt(codegen.Const32(0));
+    codegen::Value valid_row = row.DeriveValue(codegen, *predicate);
+    lang::If is_valid_row{codegen, valid_row};
+    {
+      // The group is valid, send it along the pipeline
+      context.Consume(row);
+    }
+    is_valid_row.EndIf();
+  } else {
+    context.Consume(batch);
+  }
+}
+
+llvm::Value *SortGroupByTranslator::GetGroupPtr(CodeGen &codegen) const {
+  return codegen->CreatePointerCast(LoadStatePtr(group_id_),
+                                    codegen.CharPtrType());
+}
+
+llvm::Value *SortGroupByTranslator::GetAggregateSpace(
+    CodeGen &codegen, llvm::Value *entry) const {
+  return codegen->CreateConstInBoundsGEP1_64(entry, aggregates_offset_);
+}
+
+void SortGroupByTranslator::LoadKeys(CodeGen &codegen, llvm::Value *entry,
+                                     std::vector<codegen::Value> &key) const {
+  UpdateableStorage::NullBitmap null_bitmap(codegen, key_storage_, entry);
+  for (uint32_t i = 0; i < key_storage_.GetNumElements(); i++) {
+    key.push_back(key_storage_.GetValue(codegen, entry, i, null_bitmap));
+  }
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -17,7 +17,6 @@
 #include "codegen/proxy/runtime_functions_proxy.h"
 #include "codegen/proxy/storage_manager_proxy.h"
 #include "codegen/proxy/transaction_runtime_proxy.h"
-#include "codegen/proxy/zone_map_proxy.h"
 #include "codegen/type/boolean_type.h"
 #include "codegen/vector.h"
 #include "planner/seq_scan_plan.h"
@@ -165,8 +164,18 @@ llvm::Value *TableScanTranslator::LoadTablePtr(CodeGen &codegen) const {
 }
 
 void TableScanTranslator::ProduceSerial() const {
-  auto producer = [this](ConsumerContext &ctx) {
-    CodeGen &codegen = GetCodeGen();
+  CodeGen &codegen = GetCodeGen();
+
+  // The scan is split into morsels of tile groups, each handled by one call of
+  // the pipeline function
+  auto *num_tile_groups =
+      table_.GetTileGroupCount(codegen, LoadTablePtr(codegen));
+
+  auto producer = [this, &codegen](ConsumerContext &ctx,
+                                   const std::vector<llvm::Value *> &params) {
+    PELOTON_ASSERT(params.size() == 2);
+    llvm::Value *tilegroup_start = params[0];
+    llvm::Value *tilegroup_end = params[1];
 
     // Load the table
     auto *table_ptr = LoadTablePtr(codegen);
@@ -183,21 +192,17 @@ void TableScanTranslator::ProduceSerial() const {
         codegen.Const64((int64_t)predicate),
         AbstractExpressionProxy::GetType(codegen)->getPointerTo());
     size_t num_preds = 0;
-
-    auto *zone_map_manager = storage::ZoneMapManager::GetInstance();
-    if (predicate != nullptr && zone_map_manager->ZoneMapTableExists()) {
-      if (predicate->IsZoneMappable()) {
-        num_preds = predicate->GetNumberofParsedPredicates();
-      }
+    if (predicate != nullptr && predicate->IsZoneMappable()) {
+      num_preds = predicate->GetNumberofParsedPredicates();
     }
 
     ScanConsumer scan_consumer{ctx, GetScanPlan(), position_list};
-    table_.GenerateScan(codegen, table_ptr, nullptr, nullptr, vec_size,
-                        predicate_ptr, num_preds, scan_consumer);
+    table_.GenerateScan(codegen, table_ptr, tilegroup_start, tilegroup_end,
+                        vec_size, predicate_ptr, num_preds, scan_consumer);
   };
 
-  // Execute serially
-  GetPipeline().RunSerial(producer);
+  // Execute serially, one morsel at a time
+  GetPipeline().RunSerial(num_tile_groups, kTileGroupsPerMorsel, producer);
 }
 
 void TableScanTranslator::ProduceParallel() const {
@@ -240,12 +245,8 @@ void TableScanTranslator::ProduceParallel() const {
         codegen.Const64((int64_t)predicate),
         AbstractExpressionProxy::GetType(codegen)->getPointerTo());
     size_t num_preds = 0;
-
-    auto *zone_map_manager = storage::ZoneMapManager::GetInstance();
-    if (predicate != nullptr && zone_map_manager->ZoneMapTableExists()) {
-      if (predicate->IsZoneMappable()) {
-        num_preds = predicate->GetNumberofParsedPredicates();
-      }
+    if (predicate != nullptr && predicate->IsZoneMappable()) {
+      num_preds = predicate->GetNumberofParsedPredicates();
     }
 
     // Scan the given range of the table
@@ -331,6 +331,14 @@ bool Pipeline::AtStageBoundary() const {
                    pipeline_index_) != stage_boundaries_.end();
 }
 
+// Install a flush of the rows the given translator holds back
+void Pipeline::InstallFlush(
+    UNUSED_ATTRIBUTE const OperatorTranslator *translator) {
+  // Validate the assumption
+  PELOTON_ASSERT(pipeline_[pipeline_index_] == translator);
+  flush_points_.push_back(pipeline_index_);
+}
+
 uint32_t Pipeline::GetNumStages() const {
   return static_cast<uint32_t>(stage_boundaries_.size()) + 1;
 }
@@ -471,13 +479,23 @@ void Pipeline::CompletePipeline(PipelineContext &pipeline_ctx) {
 }
 
 void Pipeline::RunSerial(const std::function<void(ConsumerContext &)> &body) {
-  Run(nullptr, {}, {},
+  Run(nullptr, {}, {}, nullptr, 0,
       [&body](ConsumerContext &ctx,
               UNUSED_ATTRIBUTE const std::vector<llvm::Value *> &args) {
         body(ctx);
       });
 }
 
+void Pipeline::RunSerial(
+    llvm::Value *num_tasks, uint32_t morsel_size,
+    const std::function<void(ConsumerContext &,
+                             const std::vector<llvm::Value *> &)> &body) {
+  PELOTON_ASSERT(!IsParallel() && morsel_size > 0);
+  CodeGen &codegen = compilation_ctx_.GetCodeGen();
+  Run(nullptr, {}, {codegen.Int64Type(), codegen.Int64Type()}, num_tasks,
+      morsel_size, body);
+}
+
 void Pipeline::RunParallel(
     llvm::Function *dispatch_func,
     const std::vector<llvm::Value *> &dispatch_args,
@@ -485,13 +503,14 @@ void Pipeline::RunParallel(
     const std::function<void(ConsumerContext &,
                              const std::vector<llvm::Value *> &)> &body) {
   PELOTON_ASSERT(IsParallel());
-  Run(dispatch_func, dispatch_args, pipeline_args_types, body);
+  Run(dispatch_func, dispatch_args, pipeline_args_types, nullptr, 0, body);
 }
 
 void Pipeline::Run(
     llvm::Function *dispatch_func,
     const std::vector<llvm::Value *> &dispatch_args,
     const std::vector<llvm::Type *> &pipeline_arg_types,
+    llvm::Value *num_tasks, uint32_t morsel_size,
     const std::function<void(ConsumerContext &,
                              const std::vector<llvm::Value *> &)> &body) {
   // Create context
@@ -501,7 +520,15 @@ void Pipeline::Run(
   InitializePipeline(pipeline_ctx);
 
   // Generate pipeline
-  DoRun(pipeline_ctx, dispatch_func, dispatch_args, pipeline_arg_types, body);
+  DoRun(pipeline_ctx, dispatch_func, dispatch_args, pipeline_arg_types,
+        num_tasks, morsel_size, body);
+
+  // Flush the operators holding back rows. Operators are installed top-down,
+  // so the ones closer to the source go first and their rows reach the others.
+  for (auto riter = flush_points_.rbegin(), rend = flush_points_.rend();
+       riter != rend; ++riter) {
+    DoFlush(pipeline_ctx, *riter);
+  }
 
   // Finish
   CompletePipeline(pipeline_ctx);
@@ -511,6 +538,7 @@ void Pipeline::DoRun(
     PipelineContext &pipeline_ctx, llvm::Function *dispatch_func,
     const std::vector<llvm::Value *> &dispatch_args,
     const std::vector<llvm::Type *> &pipeline_args_types,
+    llvm::Value *num_tasks, uint32_t morsel_size,
     const std::function<void(ConsumerContext &,
                              const std::vector<llvm::Value *> &)> &body) {
   CodeGen &codegen = compilation_ctx_.GetCodeGen();
@@ -586,6 +614,9 @@ void Pipeline::DoRun(
   //
   // Finally, if the pipeline is run through a dispatcher function, the last
   // argument is a function pointer to the pipeline function we generated.
+  //
+  // A serial pipeline run over a number of tasks is called once per morsel,
+  // with the start and end of the morsel as the last two arguments.
 
   std::vector<llvm::Value *> invoke_args = {codegen.GetState()};
   if (IsParallel()) {
@@ -606,11 +637,69 @@ void Pipeline::DoRun(
     invoke_args.push_back(
         codegen->CreateBitCast(func.GetFunction(), codegen.VoidPtrType()));
     codegen.CallFunc(dispatch_func, invoke_args);
+  } else if (num_tasks != nullptr) {
+    // Each morsel is a separate call, so that an interpreted query can move
+    // on to the compiled pipeline function in the middle of the scan
+    llvm::Value *morsel_start = codegen.Const64(0);
+    lang::Loop morsel_loop{codegen,
+                           codegen->CreateICmpULT(morsel_start, num_tasks),
+                           {{"morselStart", morsel_start}}};
+    {
+      morsel_start = morsel_loop.GetLoopVar(0);
+      llvm::Value *morsel_end =
+          codegen->CreateAdd(morsel_start, codegen.Const64(morsel_size));
+      morsel_end = codegen->CreateSelect(
+          codegen->CreateICmpULT(morsel_end, num_tasks), morsel_end, num_tasks);
+
+      std::vector<llvm::Value *> morsel_args = invoke_args;
+      morsel_args.push_back(morsel_start);
+      morsel_args.push_back(morsel_end);
+      codegen.CallFunc(func.GetFunction(), morsel_args);
+
+      morsel_loop.LoopEnd(codegen->CreateICmpULT(morsel_end, num_tasks),
+                          {morsel_end});
+    }
   } else {
     codegen.CallFunc(func.GetFunction(), invoke_args);
   }
 }
 
+void Pipeline::DoFlush(PipelineContext &pipeline_ctx, uint32_t flush_index) {
+  PELOTON_ASSERT(!IsParallel() && "Only serial pipelines can be flushed");
+  CodeGen &codegen = compilation_ctx_.GetCodeGen();
+  QueryState &query_state = compilation_ctx_.GetQueryState();
+  CodeContext &cc = codegen.GetCodeContext();
+
+  // The flush function has the signature of a serial pipeline function
+  std::string func_name = CreateUniqueFunctionName(*this, "serialFlush");
+  auto visibility = FunctionDeclaration::Visibility::Internal;
+  auto *ret_type = codegen.VoidType();
+  std::vector<FunctionDeclaration::ArgumentInfo> args = {
+      {"queryState", query_state.GetType()->getPointerTo()},
+      {"threadState", codegen.CharPtrType()}};
+
+  FunctionDeclaration declaration(cc, func_name, visibility, ret_type, args);
+  FunctionBuilder func(cc, declaration);
+  {
+    PipelineContext::SetState state_access(pipeline_ctx,
+                                           func.GetArgumentByPosition(1));
+
+    auto &execution_consumer = compilation_ctx_.GetExecutionConsumer();
+    execution_consumer.InitializePipelineState(pipeline_ctx);
+
+    // The rows of the flushing operator go through the operators above it
+    pipeline_index_ = flush_index;
+    ConsumerContext ctx(compilation_ctx_, *this, &pipeline_ctx,
+                        func.GetExitBlock());
+    pipeline_[flush_index]->Flush(ctx);
+
+    func.ReturnAndFinish();
+  }
+
+  codegen.CallFunc(func.GetFunction(),
+                   {codegen.GetState(), codegen.NullPtr(codegen.CharPtrType())});
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// Utils
@@ -20,6 +20,7 @@ DEFINE_TYPE(BloomFilter, "peloton::BloomFilter", num_hash_funcs, bytes,
 
 DEFINE_METHOD(peloton::codegen::util, BloomFilter, Init);
 DEFINE_METHOD(peloton::codegen::util, BloomFilter, Destroy);
+DEFINE_METHOD(peloton::codegen::util, BloomFilter, Merge);
 
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
@@ -42,7 +42,8 @@ DEFINE_MEMBER(dummy, Entry, hash);
 DEFINE_MEMBER(dummy, Entry, next);
 
 DEFINE_TYPE(HashTable, "peloton::HashTable", memory, directory, size, mask,
-            entry_buffer, num_elems, capacity, stats);
+            entry_buffer, num_elems, capacity, partition_entries,
+            partition_offsets, num_partition_bits);
 
 DEFINE_METHOD(peloton::codegen::util, HashTable, Init);
 DEFINE_METHOD(peloton::codegen::util, HashTable, Insert);
@@ -50,6 +51,10 @@ DEFINE_METHOD(peloton::codegen::util, HashTable, InsertLazy);
 DEFINE_METHOD(peloton::codegen::util, HashTable, BuildLazy);
 DEFINE_METHOD(peloton::codegen::util, HashTable, ReserveLazy);
 DEFINE_METHOD(peloton::codegen::util, HashTable, MergeLazyUnfinished);
+DEFINE_METHOD(peloton::codegen::util, HashTable, PartitionLazy);
+DEFINE_METHOD(peloton::codegen::util, HashTable, PartitionLazyParallel);
+DEFINE_METHOD(peloton::codegen::util, HashTable, BuildPartition);
+DEFINE_METHOD(peloton::codegen::util, HashTable, GetPartitionHead);
 DEFINE_METHOD(peloton::codegen::util, HashTable, Destroy);
 
 }  // namespace codegen
@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scanner_proxy.cpp
+//
+// Identification: src/codegen/proxy/index_scanner_proxy.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/index_scanner_proxy.h"
+
+#include "codegen/proxy/data_table_proxy.h"
+#include "codegen/proxy/executor_context_proxy.h"
+#include "codegen/proxy/tile_group_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_TYPE(IndexScanner, "util::IndexScanner", opaque);
+
+DEFINE_METHOD(peloton::codegen::util, IndexScanner, Init);
+DEFINE_METHOD(peloton::codegen::util, IndexScanner, Destroy);
+DEFINE_METHOD(peloton::codegen::util, IndexScanner, Scan);
+DEFINE_METHOD(peloton::codegen::util, IndexScanner, GetNumRuns);
+DEFINE_METHOD(peloton::codegen::util, IndexScanner, GetTileGroup);
+DEFINE_METHOD(peloton::codegen::util, IndexScanner, GetTupleOffsets);
+DEFINE_METHOD(peloton::codegen::util, IndexScanner, GetNumTuples);
+
+}  // namespace codegen
+}  // namespace peloton
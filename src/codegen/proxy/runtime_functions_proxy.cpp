@@ -33,8 +33,10 @@ DEFINE_METHOD(peloton::codegen, RuntimeFunctions, HashCrc64);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetTileGroup);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetTileGroupLayout);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, FillPredicateArray);
+DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ShouldScanTileGroup);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ExecuteTableScan);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ExecutePerState);
+DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ExecutePerPartition);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ThrowDivideByZeroException);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ThrowOverflowException);
 
@@ -12,18 +12,11 @@
 
 #include "codegen/proxy/zone_map_proxy.h"
 
-#include "codegen/proxy/value_proxy.h"
-#include "codegen/proxy/data_table_proxy.h"
-
 namespace peloton {
 namespace codegen {
 
-DEFINE_TYPE(PredicateInfo, "peloton::storage::PredicateInfo", col_id,
-            comparison_operator, predicate_value);
-DEFINE_TYPE(ZoneMapManager, "peloton::storage::ZoneMapManager", opaque);
-
-DEFINE_METHOD(peloton::storage, ZoneMapManager, ShouldScanTileGroup);
-DEFINE_METHOD(peloton::storage, ZoneMapManager, GetInstance);
+DEFINE_TYPE(PredicateRange, "peloton::storage::PredicateRange", col_id, low,
+            high);
 
 }  // namespace codegen
-}  // namespace peloton
\ No newline at end of file
+}  // namespace peloton
@@ -20,20 +20,74 @@
 #include "executor/executor_context.h"
 #include "storage/storage_manager.h"
 #include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
+#include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
 namespace codegen {
 
+namespace {
+
+// The number of compilations submitted to the compilation pool that have not
+// finished yet
+std::atomic<int32_t> num_pending_compilations{0};
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// The bytecode of the query's init, plan and tear down functions
+//===----------------------------------------------------------------------===//
+struct Query::BytecodeFunctions {
+  BytecodeFunctions(CodeContext &code_context, const LLVMFunctions &funcs)
+      : init(interpreter::BytecodeBuilder::CreateBytecodeFunction(
+            code_context, funcs.init_func)),
+        plan(interpreter::BytecodeBuilder::CreateBytecodeFunction(
+            code_context, funcs.plan_func)),
+        tear_down(interpreter::BytecodeBuilder::CreateBytecodeFunction(
+            code_context, funcs.tear_down_func)) {}
+
+  interpreter::BytecodeFunction init;
+  interpreter::BytecodeFunction plan;
+  interpreter::BytecodeFunction tear_down;
+};
+
+//===----------------------------------------------------------------------===//
+// Hands the interpreter the native code of functions that have been compiled
+//===----------------------------------------------------------------------===//
+class Query::NativeFunctionResolver
+    : public interpreter::NativeFunctionResolver {
+ public:
+  explicit NativeFunctionResolver(const Query &query) : query_(query) {}
+
+  void *GetNativeFunction(const std::string &function_name) const override {
+    void *native_function = query_.GetNativeFunction(function_name);
+    if (native_function != nullptr) {
+      num_native_calls_++;
+    }
+    return native_function;
+  }
+
+  uint64_t GetNumNativeCalls() const { return num_native_calls_; }
+
+ private:
+  const Query &query_;
+
+  // The number of calls handed over to native code
+  mutable uint64_t num_native_calls_ = 0;
+};
+
 // Constructor
 Query::Query(const planner::AbstractPlan &query_plan)
     : query_plan_(query_plan) {}
 
+Query::~Query() {
+  // The compilations use the code context, so they have to finish first
+  WaitForBackgroundCompilation();
+}
+
 void Query::Execute(executor::ExecutorContext &executor_context,
                     ExecutionConsumer &consumer, RuntimeStats *stats) {
-  CodeGen codegen{code_context_};
-
-  llvm::Type *query_state_type = query_state_.GetType();
-  size_t parameter_size = codegen.SizeOf(query_state_type);
+  size_t parameter_size = query_state_size_;
   PELOTON_ASSERT((parameter_size % 8 == 0) &&
       "parameter size not multiple of 8");
 
@@ -49,9 +103,13 @@ void Query::Execute(executor::ExecutorContext &executor_context,
 
   bool force_interpreter = settings::SettingsManager::GetBool(
       settings::SettingId::codegen_interpreter);
+  bool adaptive = settings::SettingsManager::GetBool(
+      settings::SettingId::codegen_adaptive);
 
   if (is_compiled_ && !force_interpreter) {
     ExecuteNative(func_args, stats);
+  } else if (adaptive && !force_interpreter) {
+    ExecuteAdaptive(func_args, stats);
   } else {
     try {
       ExecuteInterpreter(func_args, stats);
@@ -69,19 +127,46 @@ void Query::Prepare(const LLVMFunctions &query_funcs) {
   // but we do not want to mix up the timings, so do it here
   code_context_.Verify();
 
+  // Use the persistent cache of compiled queries, if configured. If it holds
+  // the compiled code already, there is no need to optimize the functions.
+  bool is_cached = false;
+  auto cache_directory = settings::SettingsManager::GetString(
+      settings::SettingId::codegen_cache_directory);
+  if (!cache_directory.empty()) {
+    is_cached = code_context_.EnableObjectCache(cache_directory);
+  }
+
   // optimize the functions
   // TODO(marcel): add switch to enable/disable optimization
   // TODO(marcel): add timer to measure time used for optimization (see
   // RuntimeStats)
-  code_context_.Optimize();
+  // With tiered compilation, the query is first compiled without any
+  // optimizations. It is optimized once it turns out to be hot.
+  is_tiered_ = !is_cached &&
+               settings::SettingsManager::GetBool(
+                   settings::SettingId::codegen_tiered_compilation);
+  if (is_tiered_) {
+    code_context_.EnableRecompilation();
+  } else if (!is_cached) {
+    code_context_.Optimize();
+  }
+
+  // Compute the size of the query state now, the layout of the module must
+  // not be touched while the query is compiled in the background
+  CodeGen codegen{code_context_};
+  query_state_size_ = codegen.SizeOf(query_state_.GetType());
 
   is_compiled_ = false;
 }
 
 void Query::Compile(CompileStats *stats) {
+  bool collect_metrics =
+      static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID;
+
   // Timer
   Timer<std::milli> timer;
-  if (stats != nullptr) {
+  if (stats != nullptr || collect_metrics) {
     timer.Start();
   }
 
@@ -90,35 +175,156 @@ void Query::Compile(CompileStats *stats) {
   code_context_.Compile();
 
   // Get pointers to the JITed functions
-  compiled_functions_.init_func =
-      (compiled_function_t)code_context_.GetRawFunctionPointer(
-          llvm_functions_.init_func);
-  PELOTON_ASSERT(compiled_functions_.init_func != nullptr);
-
-  compiled_functions_.plan_func =
-      (compiled_function_t)code_context_.GetRawFunctionPointer(
-          llvm_functions_.plan_func);
-  PELOTON_ASSERT(compiled_functions_.plan_func != nullptr);
-
-  compiled_functions_.tear_down_func =
-      (compiled_function_t)code_context_.GetRawFunctionPointer(
-          llvm_functions_.tear_down_func);
-  PELOTON_ASSERT(compiled_functions_.tear_down_func != nullptr);
+  compiled_functions_ = LookupCompiledFunctions();
+
+  // Remember all functions by name, so interpreted code can call them
+  for (auto &func : code_context_.GetModule()) {
+    if (!func.isDeclaration()) {
+      auto *func_ptr = code_context_.GetRawFunctionPointer(&func);
+      if (func_ptr != nullptr) {
+        native_functions_[func.getName().str()] = func_ptr;
+      }
+    }
+  }
 
+  // Publish the compiled code. Executions started from here on, and
+  // interpreted executions reaching their next function call, use it.
   is_compiled_ = true;
 
   LOG_TRACE("Compilation finished.");
 
   // Timer for JIT compilation
-  if (stats != nullptr) {
+  if (stats != nullptr || collect_metrics) {
     timer.Stop();
+  }
+  if (stats != nullptr) {
     stats->compile_ms = timer.GetDuration();
-    timer.Reset();
+  }
+  if (collect_metrics) {
+    auto ir_stats = code_context_.GetIRStats();
+    stats::BackendStatsContext::GetInstance()
+        ->GetCompilationMetric()
+        .RecordCompilation(static_cast<int64_t>(timer.GetDuration() * 1000),
+                           ir_stats.num_functions, ir_stats.num_basic_blocks,
+                           ir_stats.num_instructions);
+  }
+}
+
+void Query::RecordCacheHit() {
+  if (!is_tiered_) {
+    return;
+  }
+
+  // Optimize the query once it is hot
+  auto threshold = settings::SettingsManager::GetInt(
+      settings::SettingId::codegen_tier_up_threshold);
+  if (++num_cache_hits_ < static_cast<uint64_t>(threshold) || is_optimized_) {
+    return;
+  }
+
+  // If the compilation pool is busy, this is tried again on the next hit
+  std::lock_guard<std::mutex> lock{adaptive_mutex_};
+  if (!optimized_compile_.valid()) {
+    optimized_compile_ = SubmitCompileTask([this]() { CompileOptimized(); });
   }
 }
 
+void Query::WaitForBackgroundCompilation() {
+  std::shared_future<void> compile, optimized_compile;
+  {
+    std::lock_guard<std::mutex> lock{adaptive_mutex_};
+    compile = background_compile_;
+    optimized_compile = optimized_compile_;
+  }
+  if (compile.valid()) {
+    compile.wait();
+  }
+  if (optimized_compile.valid()) {
+    optimized_compile.wait();
+  }
+}
+
+void Query::CompileOptimized() {
+  // The first compilation may still be running in the background
+  std::shared_future<void> compile;
+  {
+    std::lock_guard<std::mutex> lock{adaptive_mutex_};
+    compile = background_compile_;
+  }
+  if (compile.valid()) {
+    compile.wait();
+  }
+  if (!is_compiled_) {
+    // Nothing to optimize yet. Drop this task so that a later cache hit can
+    // submit it again once the query is compiled.
+    std::lock_guard<std::mutex> lock{adaptive_mutex_};
+    optimized_compile_ = std::shared_future<void>();
+    return;
+  }
+
+  Timer<std::milli> timer;
+  timer.Start();
+
+  LOG_TRACE("Starting optimized Query compilation ...");
+  code_context_.Recompile();
+  optimized_functions_ = LookupCompiledFunctions();
+
+  // Publish the optimized code. Executions started from here on use it.
+  is_optimized_ = true;
+
+  LOG_TRACE("Optimized compilation finished.");
+
+  timer.Stop();
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()
+        ->GetCompilationMetric()
+        .RecordRecompilation(static_cast<int64_t>(timer.GetDuration() * 1000));
+  }
+}
+
+Query::CompiledFunctions Query::LookupCompiledFunctions() const {
+  CompiledFunctions funcs;
+  funcs.init_func = (compiled_function_t)code_context_.GetRawFunctionPointer(
+      llvm_functions_.init_func);
+  PELOTON_ASSERT(funcs.init_func != nullptr);
+
+  funcs.plan_func = (compiled_function_t)code_context_.GetRawFunctionPointer(
+      llvm_functions_.plan_func);
+  PELOTON_ASSERT(funcs.plan_func != nullptr);
+
+  funcs.tear_down_func =
+      (compiled_function_t)code_context_.GetRawFunctionPointer(
+          llvm_functions_.tear_down_func);
+  PELOTON_ASSERT(funcs.tear_down_func != nullptr);
+  return funcs;
+}
+
+std::shared_future<void> Query::SubmitCompileTask(std::function<void()> task) {
+  auto max_pending = settings::SettingsManager::GetInt(
+      settings::SettingId::codegen_compile_task_queue_size);
+  if (++num_pending_compilations > max_pending) {
+    num_pending_compilations--;
+    return std::shared_future<void>();
+  }
+
+  auto packaged_task =
+      std::make_shared<std::packaged_task<void()>>(std::move(task));
+  auto future = packaged_task->get_future().share();
+  threadpool::MonoQueuePool::GetCompilationInstance().SubmitTask(
+      [packaged_task]() {
+        (*packaged_task)();
+        num_pending_compilations--;
+      });
+  return future;
+}
+
 void Query::ExecuteNative(FunctionArguments *function_arguments,
                           RuntimeStats *stats) {
+  // Use the optimized code, if there is any already
+  const auto &compiled_functions =
+      is_optimized_ ? optimized_functions_ : compiled_functions_;
+
   // Start timer
   Timer<std::milli> timer;
   if (stats != nullptr) {
@@ -128,10 +334,10 @@ void Query::ExecuteNative(FunctionArguments *function_arguments,
   // Call init
   LOG_TRACE("Calling query's init() ...");
   try {
-    compiled_functions_.init_func(function_arguments);
+    compiled_functions.init_func(function_arguments);
   } catch (...) {
     // Cleanup if an exception is encountered
-    compiled_functions_.tear_down_func(function_arguments);
+    compiled_functions.tear_down_func(function_arguments);
     throw;
   }
 
@@ -146,10 +352,10 @@ void Query::ExecuteNative(FunctionArguments *function_arguments,
   // Execute the query!
   LOG_TRACE("Calling query's plan() ...");
   try {
-    compiled_functions_.plan_func(function_arguments);
+    compiled_functions.plan_func(function_arguments);
   } catch (...) {
     // Cleanup if an exception is encountered
-    compiled_functions_.tear_down_func(function_arguments);
+    compiled_functions.tear_down_func(function_arguments);
     throw;
   }
 
@@ -163,7 +369,7 @@ void Query::ExecuteNative(FunctionArguments *function_arguments,
 
   // Clean up
   LOG_TRACE("Calling query's tearDown() ...");
-  compiled_functions_.tear_down_func(function_arguments);
+  compiled_functions.tear_down_func(function_arguments);
 
   // No need to cleanup if we get an exception while cleaning up...
   if (stats != nullptr) {
@@ -250,5 +456,137 @@ void Query::ExecuteInterpreter(FunctionArguments *function_arguments,
   }
 }
 
+void Query::ExecuteAdaptive(FunctionArguments *function_arguments,
+                            RuntimeStats *stats) {
+  // Timer
+  Timer<std::milli> timer;
+  if (stats != nullptr) {
+    timer.Start();
+  }
+
+  // Translate the query to bytecode on the first execution. This has to
+  // happen before the background compilation starts, both read the module.
+  const BytecodeFunctions *bytecode = nullptr;
+  std::shared_future<void> compile;
+  {
+    std::lock_guard<std::mutex> lock{adaptive_mutex_};
+    if (bytecode_functions_ == nullptr && !bytecode_not_supported_) {
+      try {
+        bytecode_functions_.reset(
+            new BytecodeFunctions(code_context_, llvm_functions_));
+      } catch (interpreter::NotSupportedException &e) {
+        LOG_DEBUG("query not supported by interpreter: %s", e.what());
+        bytecode_not_supported_ = true;
+      }
+    }
+    StartBackgroundCompile();
+    bytecode = bytecode_functions_.get();
+    compile = background_compile_;
+  }
+
+  // Queries the interpreter can't handle wait for the compiled code
+  if (bytecode == nullptr) {
+    if (compile.valid()) {
+      compile.get();
+    }
+    ExecuteNative(function_arguments, stats);
+    return;
+  }
+
+  if (stats != nullptr) {
+    timer.Stop();
+    stats->interpreter_prepare_ms = timer.GetDuration();
+    timer.Reset();
+    timer.Start();
+  }
+
+  // Each of the query functions runs natively if the compilation has finished
+  // by the time it is called. Interpreted functions switch to native code at
+  // every call of a compiled function, e.g., at the start of each pipeline or
+  // of each morsel of a serial scan.
+  NativeFunctionResolver resolver{*this};
+  auto *arg = reinterpret_cast<char *>(function_arguments);
+  auto call = [this, arg, &resolver](
+      compiled_function_t CompiledFunctions::*native_func,
+      const interpreter::BytecodeFunction &bytecode_func) {
+    if (is_compiled_) {
+      const auto &compiled_functions =
+          is_optimized_ ? optimized_functions_ : compiled_functions_;
+      (compiled_functions.*native_func)(
+          reinterpret_cast<FunctionArguments *>(arg));
+    } else {
+      interpreter::BytecodeInterpreter::ExecuteFunction(bytecode_func, arg,
+                                                        &resolver);
+    }
+  };
+
+  // Call init
+  LOG_TRACE("Calling query's init() ...");
+  try {
+    call(&CompiledFunctions::init_func, bytecode->init);
+  } catch (...) {
+    call(&CompiledFunctions::tear_down_func, bytecode->tear_down);
+    throw;
+  }
+
+  if (stats != nullptr) {
+    timer.Stop();
+    stats->init_ms = timer.GetDuration();
+    timer.Reset();
+    timer.Start();
+  }
+
+  // Execute the query!
+  LOG_TRACE("Calling query's plan() ...");
+  try {
+    call(&CompiledFunctions::plan_func, bytecode->plan);
+  } catch (...) {
+    call(&CompiledFunctions::tear_down_func, bytecode->tear_down);
+    throw;
+  }
+
+  // Timer plan execution
+  if (stats != nullptr) {
+    timer.Stop();
+    stats->plan_ms = timer.GetDuration();
+    timer.Reset();
+    timer.Start();
+  }
+
+  // Clean up
+  LOG_TRACE("Calling query's tearDown() ...");
+  call(&CompiledFunctions::tear_down_func, bytecode->tear_down);
+
+  // No need to cleanup if we get an exception while cleaning up...
+  if (stats != nullptr) {
+    timer.Stop();
+    stats->tear_down_ms = timer.GetDuration();
+    stats->num_native_calls = resolver.GetNumNativeCalls();
+  }
+}
+
+void Query::StartBackgroundCompile() {
+  // Must be called with adaptive_mutex_ held
+  if (background_compile_.valid() || is_compiled_) {
+    return;
+  }
+  background_compile_ = SubmitCompileTask([this]() { Compile(); });
+
+  // With the compilation pool busy, a query the interpreter can run is tried
+  // again on its next execution. Any other is compiled right here, which
+  // can't race with a background compilation while the lock is held.
+  if (!background_compile_.valid() && bytecode_not_supported_) {
+    Compile();
+  }
+}
+
+CodeContext::FuncPtr Query::GetNativeFunction(const std::string &name) const {
+  if (!is_compiled_) {
+    return nullptr;
+  }
+  auto iter = native_functions_.find(name);
+  return iter != native_functions_.end() ? iter->second : nullptr;
+}
+
 }  // namespace codegen
 }  // namespace peloton
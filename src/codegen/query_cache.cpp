@@ -30,6 +30,9 @@ Query* QueryCache::Find(const std::shared_ptr<planner::AbstractPlan> &key) {
   query_list_.splice(query_list_.begin(), query_list_, it->second);
   auto *query = it->second->second.get();
   cache_lock_.Unlock();
+
+  // Let the query know it is in use, hot queries are optimized further
+  query->RecordCacheHit();
   return query;
 }
 
@@ -13,8 +13,11 @@
 #include "codegen/query_compiler.h"
 
 #include "codegen/compilation_context.h"
+#include "codegen/operator/index_scan_translator.h"
 #include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
+#include "planner/index_scan_plan.h"
+#include "planner/merge_join_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 
@@ -55,6 +58,17 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
     case PlanNodeType::AGGREGATE_V2: {
       break;
     }
+    case PlanNodeType::INDEXSCAN: {
+      // Limits pushed into the index scan are only handled by the interpreter,
+      // and every key condition must be backed by a predicate conjunct.
+      auto &scan_plan = static_cast<const planner::IndexScanPlan &>(plan);
+      std::vector<const expression::AbstractExpression *> key_values;
+      if (scan_plan.GetLimit() ||
+          !IndexScanTranslator::GetKeyValueExpressions(scan_plan, key_values)) {
+        return false;
+      }
+      break;
+    }
     case PlanNodeType::PROJECTION: {
       // TODO(pmenon): Why does this check exists?
       if (plan.GetChildren().empty()) {
@@ -73,7 +87,8 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       break;
     }
     case PlanNodeType::NESTLOOP:
-    case PlanNodeType::HASHJOIN: {
+    case PlanNodeType::HASHJOIN:
+    case PlanNodeType::MERGEJOIN: {
       const auto &join = static_cast<const planner::AbstractJoinPlan &>(plan);
       // Right now, only support inner joins
       if (join.GetJoinType() == JoinType::INNER) {
@@ -94,6 +109,11 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       pred = scan_plan.GetPredicate();
       break;
     }
+    case PlanNodeType::INDEXSCAN: {
+      auto &scan_plan = static_cast<const planner::IndexScanPlan &>(plan);
+      pred = scan_plan.GetPredicate();
+      break;
+    }
     case PlanNodeType::AGGREGATE_V2: {
       auto &agg_plan = static_cast<const planner::AggregatePlan &>(plan);
       pred = agg_plan.GetPredicate();
@@ -104,6 +124,11 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       pred = hj_plan.GetPredicate();
       break;
     }
+    case PlanNodeType::MERGEJOIN: {
+      auto &mj_plan = static_cast<const planner::MergeJoinPlan &>(plan);
+      pred = mj_plan.GetPredicate();
+      break;
+    }
     default: { break; }
   }
 
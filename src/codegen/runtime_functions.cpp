@@ -12,6 +12,7 @@
 
 #include "codegen/runtime_functions.h"
 
+#include <functional>
 #include <nmmintrin.h>
 
 #include "murmur3/MurmurHash3.h"
@@ -26,6 +27,8 @@
 #include "storage/storage_manager.h"
 #include "storage/tile.h"
 #include "storage/tile_group.h"
+#include "storage/zone_map.h"
+#include "storage/zone_map_manager.h"
 #include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
@@ -83,25 +86,35 @@ storage::TileGroup *RuntimeFunctions::GetTileGroup(storage::DataTable *table,
 
 //===----------------------------------------------------------------------===//
 // Fills in the Predicate Array for the Zone Map to compare against.
-// Predicates are converted into an array of struct.
-// Each struct contains the column id, operator id and predicate value.
+// Predicates are encoded into the ranges of zone map keys they accept, which
+// needs the types of the columns they're on. Predicates that can't be checked
+// against a zone map are left out.
 //===----------------------------------------------------------------------===//
-void RuntimeFunctions::FillPredicateArray(
-    const expression::AbstractExpression *expr,
-    storage::PredicateInfo *predicate_array) {
-  const std::vector<storage::PredicateInfo> *parsed_predicates;
-  parsed_predicates = expr->GetParsedPredicates();
-  size_t num_preds = parsed_predicates->size();
-  size_t i;
-  for (i = 0; i < num_preds; i++) {
-    predicate_array[i].col_id = (*parsed_predicates)[i].col_id;
-    predicate_array[i].comparison_operator =
-        (*parsed_predicates)[i].comparison_operator;
-    predicate_array[i].predicate_value =
-        (*parsed_predicates)[i].predicate_value;
+int32_t RuntimeFunctions::FillPredicateArray(
+    const expression::AbstractExpression *expr, storage::DataTable *table,
+    storage::PredicateRange *predicate_array) {
+  const std::vector<storage::PredicateInfo> *parsed_predicates =
+      expr->GetParsedPredicates();
+  return storage::ZoneMapManager::EncodePredicates(
+      parsed_predicates->data(),
+      static_cast<int32_t>(parsed_predicates->size()), *table->GetSchema(),
+      predicate_array);
+}
+
+//===----------------------------------------------------------------------===//
+// Check whether any tuple of the tile group can satisfy the predicates, using
+// the zone map kept in memory with the tile group. The compressed columns of a
+// frozen tile group are checked too, without decompressing its tuples.
+//===----------------------------------------------------------------------===//
+bool RuntimeFunctions::ShouldScanTileGroup(
+    storage::TileGroup *tile_group, const storage::PredicateRange *predicates,
+    int32_t num_predicates) {
+  auto count = static_cast<uint32_t>(num_predicates);
+  if (!tile_group->GetZoneMap()->ShouldScan(predicates, count)) {
+    return false;
   }
-  auto temp_expr = (expression::AbstractExpression *)expr;
-  temp_expr->ClearParsedPredicates();
+  return !tile_group->IsFrozen() ||
+         tile_group->ShouldScanFrozen(predicates, count);
 }
 
 //===----------------------------------------------------------------------===//
@@ -113,6 +126,10 @@ void RuntimeFunctions::FillPredicateArray(
 void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
                                           ColumnLayoutInfo *infos,
                                           UNUSED_ATTRIBUTE uint32_t num_cols) {
+  // The scan reads the tuples through the returned pointers, so a frozen tile
+  // group's uncompressed tuples must stay around
+  tile_group->MarkAccessed();
+
   const auto &layout = tile_group->GetLayout();
   UNUSED_ATTRIBUTE oid_t last_col_idx = INVALID_OID;
 
@@ -208,45 +225,68 @@ void RuntimeFunctions::ExecuteTableScan(
   latch.Await(0);
 }
 
-void RuntimeFunctions::ExecutePerState(
-    void *query_state, executor::ExecutorContext::ThreadStates &thread_states,
-    void (*work_func)(void *, void *)) {
+namespace {
+
+// Invoke task(i) for every i in [0, num_tasks) on the execution pool, and wait
+// for all of them to complete
+void ExecuteInParallel(uint32_t num_tasks, const char *task_name,
+                       const std::function<void(uint32_t)> &task) {
   // The worker pool
   auto &worker_pool = threadpool::MonoQueuePool::GetExecutionInstance();
 
   // Create count down latch
-  uint32_t num_tasks = thread_states.NumThreads();
   common::synchronization::CountDownLatch latch{num_tasks};
 
-  // Loop over states
-  for (uint32_t tid = 0; tid < num_tasks; tid++) {
-    worker_pool.SubmitTask(
-        [&query_state, &work_func, &thread_states, &latch, tid]() {
-          LOG_DEBUG("Processing thread state %u ...", tid);
-
-          // Time this
-          Timer<std::milli> timer;
-          timer.Start();
+  // Loop over tasks
+  for (uint32_t task_id = 0; task_id < num_tasks; task_id++) {
+    worker_pool.SubmitTask([&task, &latch, task_name, task_id]() {
+      LOG_DEBUG("Processing %s %u ...", task_name, task_id);
 
-          // Pull out the thread state
-          auto *thread_state = thread_states.AccessThreadState(tid);
+      // Time this
+      Timer<std::milli> timer;
+      timer.Start();
 
-          // Invoke work function on this thread state
-          work_func(query_state, thread_state);
+      // Invoke work function on this task
+      task(task_id);
 
-          // Count down the latch
-          latch.CountDown();
+      // Count down the latch
+      latch.CountDown();
 
-          timer.Stop();
-          LOG_DEBUG("Finished processing thread state %u (%.2lf ms) ...", tid,
-                    timer.GetDuration());
-        });
+      timer.Stop();
+      LOG_DEBUG("Finished processing %s %u (%.2lf ms) ...", task_name, task_id,
+                timer.GetDuration());
+    });
   }
 
   // Wait for all tasks to complete
   latch.Await(0);
 }
 
+}  // namespace
+
+void RuntimeFunctions::ExecutePerState(
+    void *query_state, executor::ExecutorContext::ThreadStates &thread_states,
+    void (*work_func)(void *, void *)) {
+  ExecuteInParallel(thread_states.NumThreads(), "thread state",
+                    [query_state, work_func, &thread_states](uint32_t tid) {
+                      // Pull out the thread state
+                      auto *thread_state = thread_states.AccessThreadState(tid);
+
+                      // Invoke work function on this thread state
+                      work_func(query_state, thread_state);
+                    });
+}
+
+void RuntimeFunctions::ExecutePerPartition(void *query_state,
+                                           uint32_t num_partitions,
+                                           void (*work_func)(void *,
+                                                             uint32_t)) {
+  ExecuteInParallel(num_partitions, "partition",
+                    [query_state, work_func](uint32_t partition_id) {
+                      work_func(query_state, partition_id);
+                    });
+}
+
 void RuntimeFunctions::ThrowDivideByZeroException() {
   throw DivideByZeroException("ERROR: division by zero");
 }
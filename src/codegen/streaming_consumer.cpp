@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// streaming_consumer.cpp
+//
+// Identification: src/codegen/streaming_consumer.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/streaming_consumer.h"
+
+#include "codegen/proxy/proxy.h"
+#include "network/postgres_value_format.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// StreamTuple() Proxy
+//===----------------------------------------------------------------------===//
+
+PROXY(StreamingConsumer) { DECLARE_METHOD(StreamTuple); };
+
+DEFINE_METHOD(peloton::codegen, StreamingConsumer, StreamTuple);
+
+//===----------------------------------------------------------------------===//
+// STREAMING CONSUMER
+//===----------------------------------------------------------------------===//
+
+StreamingConsumer::StreamingConsumer(const std::vector<oid_t> &cols,
+                                     const planner::BindingContext &context,
+                                     const std::vector<int> &result_format,
+                                     BatchCallback on_batch,
+                                     uint32_t batch_size)
+    : BufferingConsumer(cols, context) {
+  PELOTON_ASSERT(batch_size > 0);
+  // Columns without a format code go out as text
+  stream_.result_format = result_format;
+  stream_.result_format.resize(cols.size(),
+                               network::PostgresValueFormat::TEXT_FORMAT);
+  stream_.num_rows = 0;
+  stream_.batch_size = batch_size;
+  stream_.on_batch = std::move(on_batch);
+  stream_.cancelled = false;
+}
+
+// Append the encoded values of the tuple to the current batch, and hand the
+// batch over when it is full. The callback may block until the batch is
+// consumed, which in turn holds back the other threads of the query.
+void StreamingConsumer::StreamTuple(char *state, char *tuple,
+                                    uint32_t num_cols) {
+  auto *stream = reinterpret_cast<Stream *>(state);
+  auto *vals = reinterpret_cast<peloton::type::Value *>(tuple);
+  std::lock_guard<std::mutex> lock{stream->mutex};
+  // Don't bother encoding rows nobody reads
+  if (stream->cancelled) return;
+  stream->batch.BeginRow();
+  auto &buffer = stream->batch.GetBuffer();
+  for (uint32_t i = 0; i < num_cols; i++) {
+    network::PostgresValueFormat::AppendColumn(buffer, vals[i],
+                                               stream->result_format[i]);
+  }
+  if (++stream->num_rows == stream->batch_size) {
+    ResultBatch batch;
+    std::swap(batch, stream->batch);
+    stream->num_rows = 0;
+    stream->cancelled = !stream->on_batch(std::move(batch));
+  }
+}
+
+// Same as the buffering consumer, except that the tuple is handed to
+// StreamTuple(...)
+void StreamingConsumer::ConsumeResult(ConsumerContext &ctx,
+                                      RowBatch::Row &row) const {
+  CodeGen &codegen = ctx.GetCodeGen();
+  llvm::Value *tuple_buffer = MaterializeTuple(ctx, row);
+
+  auto &query_state = ctx.GetQueryState();
+  llvm::Value *stream_ptr =
+      query_state.LoadStateValue(codegen, consumer_state_id_);
+
+  std::vector<llvm::Value *> args = {stream_ptr, tuple_buffer,
+                                     codegen.Const32(output_ais_.size())};
+  codegen.Call(StreamingConsumerProxy::StreamTuple, args);
+}
+
+void StreamingConsumer::FlushBatch() {
+  std::lock_guard<std::mutex> lock{stream_.mutex};
+  if (stream_.num_rows == 0 || stream_.cancelled) return;
+  stream_.num_rows = 0;
+  stream_.on_batch(std::move(stream_.batch));
+  stream_.batch.Clear();
+}
+
+char *StreamingConsumer::GetConsumerState() {
+  return reinterpret_cast<char *>(&stream_);
+}
+
+}  // namespace codegen
+}  // namespace peloton
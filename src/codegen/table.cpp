@@ -40,25 +40,22 @@ llvm::Value *Table::GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
                       {table_ptr, tile_group_id});
 }
 
-// We acquire a Zone Map manager instance
-llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
-  return codegen.Call(ZoneMapManagerProxy::GetInstance, {});
-}
-
 // Generate a scan over all tile groups.
 //
 // @code
 // column_layouts := alloca<peloton::ColumnLayoutInfo>(
 //     table.GetSchema().GetColumnCount())
-// predicate_array := alloca<peloton::PredicateInfo>(
+// predicate_array := alloca<peloton::PredicateRange>(
 //     num_predicates)
+// num_ranges := FillPredicateArray(predicate, table_ptr, predicate_array)
 //
 // oid_t tile_group_idx := 0
 // num_tile_groups = GetTileGroupCount(table_ptr)
 //
 // for (; tile_group_idx < num_tile_groups; ++tile_group_idx) {
-//   if (ShouldScanTileGroup(predicate_array, tile_group_idx)) {
-//      tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
+//   tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
+//   if (tile_group_ptr != nullptr &&
+//       ShouldScanTileGroup(tile_group_ptr, predicate_array, num_ranges)) {
 //      consumer.TileGroupStart(tile_group_ptr);
 //      tile_group.TidScan(tile_group_ptr, column_layouts, vector_size,
 //                         consumer);
@@ -67,6 +64,9 @@ llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
 // }
 //
 // @endcode
+//
+// Tile groups dropped by compaction leave their offset empty. The zone map
+// check is left out entirely when there are no predicates.
 void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
                          llvm::Value *tilegroup_start,
                          llvm::Value *tilegroup_end, uint32_t batch_size,
@@ -78,14 +78,15 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
   llvm::Value *column_layouts = codegen.AllocateBuffer(
       ColumnLayoutInfoProxy::GetType(codegen), num_columns, "columnLayout");
 
-  // Allocate some space for the parsed predicates (if need be!)
-  llvm::Value *predicate_array =
-      codegen.NullPtr(PredicateInfoProxy::GetType(codegen)->getPointerTo());
+  // Allocate some space for the encoded predicates (if need be!)
+  llvm::Value *predicate_array = nullptr;
+  llvm::Value *num_ranges = nullptr;
   if (num_predicates != 0) {
-    predicate_array = codegen.AllocateBuffer(
-        PredicateInfoProxy::GetType(codegen), num_predicates, "predicateInfo");
-    codegen.Call(RuntimeFunctionsProxy::FillPredicateArray,
-                 {predicate_ptr, predicate_array});
+    predicate_array =
+        codegen.AllocateBuffer(PredicateRangeProxy::GetType(codegen),
+                               num_predicates, "predicateRange");
+    num_ranges = codegen.Call(RuntimeFunctionsProxy::FillPredicateArray,
+                              {predicate_ptr, table_ptr, predicate_array});
   }
 
   // Get the number of tile groups in the given table
@@ -103,17 +104,11 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
     tile_group_idx = loop.GetLoopVar(0);
     llvm::Value *tile_group_ptr =
         GetTileGroup(codegen, table_ptr, tile_group_idx);
-    llvm::Value *tile_group_id =
-        tile_group_.GetTileGroupId(codegen, tile_group_ptr);
 
-    // Check zone map
-    llvm::Value *cond = codegen.Call(
-        ZoneMapManagerProxy::ShouldScanTileGroup,
-        {GetZoneMapManager(codegen), predicate_array,
-         codegen.Const32(num_predicates), table_ptr, tile_group_idx});
+    auto scan_tile_group = [&]() {
+      llvm::Value *tile_group_id =
+          tile_group_.GetTileGroupId(codegen, tile_group_ptr);
 
-    codegen::lang::If should_scan_tilegroup{codegen, cond};
-    {
       // Inform the consumer that we're starting iteration over the tile group
       consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
 
@@ -123,8 +118,25 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
 
       // Inform the consumer that we've finished iteration over the tile group
       consumer.TileGroupFinish(codegen, tile_group_ptr);
+    };
+
+    codegen::lang::If tile_group_exists{
+        codegen, codegen->CreateIsNotNull(tile_group_ptr)};
+    {
+      if (num_predicates != 0) {
+        // Check zone map
+        llvm::Value *cond =
+            codegen.Call(RuntimeFunctionsProxy::ShouldScanTileGroup,
+                         {tile_group_ptr, predicate_array, num_ranges});
+
+        codegen::lang::If should_scan_tilegroup{codegen, cond};
+        { scan_tile_group(); }
+        should_scan_tilegroup.EndIf();
+      } else {
+        scan_tile_group();
+      }
     }
-    should_scan_tilegroup.EndIf();
+    tile_group_exists.EndIf();
 
     // Move to next tile group in the table
     tile_group_idx = codegen->CreateAdd(tile_group_idx, codegen.Const64(1));
@@ -34,6 +34,8 @@ uint32_t TransactionRuntime::PerformVisibilityCheck(
   // Check visibility of tuples in the range [tid_start, tid_end), storing all
   // visible tuple IDs in the provided selection vector
   uint32_t out_idx = 0;
+  uint32_t garbage_count = 0;
+  cid_t read_id = txn.GetReadId();
   for (uint32_t i = tid_start; i < tid_end; i++) {
     // Perform the visibility check
     auto visibility = txn_manager.IsVisible(&txn, tile_group_header, i);
@@ -41,6 +43,14 @@ uint32_t TransactionRuntime::PerformVisibilityCheck(
     // Update the output position
     selection_vector[out_idx] = i;
     out_idx += (visibility == VisibilityType::OK);
+
+    // Versions that stopped being current before we began are garbage no one
+    // has collected yet
+    garbage_count += (visibility == VisibilityType::INVISIBLE &&
+                      tile_group_header->GetEndCommitId(i) <= read_id);
+  }
+  if (garbage_count > 0) {
+    txn.RecordGarbageVersions(garbage_count);
   }
   return out_idx;
 }
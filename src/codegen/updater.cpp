@@ -20,6 +20,7 @@
 #include "storage/tile_group.h"
 #include "storage/tile.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 #include "type/abstract_pool.h"
 #include "common/internal_types.h"
 #include "type/value.h"
@@ -139,6 +140,7 @@ void Updater::Update() {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   // Either update in-place
   if (is_owner_ == true) {
+    tile_group->GetZoneMap()->Update(old_location_.offset);
     txn_manager.PerformUpdate(txn, old_location_);
     // we do not need to add any item pointer to statement-level write set
     // here, because we do not generate any new version
@@ -147,8 +149,10 @@ void Updater::Update() {
   }
 
   // Or, update with a new version
-  ContainerTuple<storage::TileGroup> new_tuple(
-    table_->GetTileGroupById(new_location_.block).get(), new_location_.offset);
+  auto *new_tile_group = table_->GetTileGroupById(new_location_.block).get();
+  new_tile_group->GetZoneMap()->Update(new_location_.offset);
+  ContainerTuple<storage::TileGroup> new_tuple(new_tile_group,
+                                               new_location_.offset);
   ItemPointer *indirection =
       tile_group_header->GetIndirection(old_location_.offset);
   auto result = table_->InstallVersion(&new_tuple, target_list_, txn,
@@ -174,6 +178,7 @@ void Updater::UpdatePK() {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
   // Insert a new tuple
+  tile_group->GetZoneMap()->Update(new_location_.offset);
   ContainerTuple<storage::TileGroup> tuple(tile_group, new_location_.offset);
   ItemPointer *index_entry_ptr = nullptr;
   bool result = table_->InsertTuple(&tuple, new_location_, txn,
@@ -76,6 +76,16 @@ void BloomFilter::Destroy() {
   delete[] bytes_;
 }
 
+void BloomFilter::Merge(BloomFilter &other) {
+  PELOTON_ASSERT(num_bits_ == other.num_bits_);
+  PELOTON_ASSERT(num_hash_funcs_ == other.num_hash_funcs_);
+
+  uint64_t num_bytes = (num_bits_ + 7) / 8;
+  for (uint64_t i = 0; i < num_bytes; i++) {
+    bytes_[i] |= other.bytes_[i];
+  }
+}
+
 }  // namespace util
 }  // namespace codegen
 }  // namespace peloton
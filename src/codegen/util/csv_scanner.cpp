@@ -31,6 +31,7 @@ CSVScanner::CSVScanner(peloton::type::AbstractPool &pool,
     : memory_(pool),
       file_path_(file_path),
       file_(),
+      input_(nullptr),
       buffer_(nullptr),
       buffer_pos_(0),
       buffer_end_(0),
@@ -83,6 +84,11 @@ void CSVScanner::Init(CSVScanner &scanner,
   new (&scanner)
       CSVScanner(*executor_context.GetPool(), file_path, col_types, num_cols,
                  func, opaque_state, delimiter, quote, escape);
+
+  // Without a path, we read what the client sends
+  if (scanner.file_path_.empty()) {
+    scanner.input_ = executor_context.GetCopyInput();
+  }
 }
 
 void CSVScanner::Destroy(CSVScanner &scanner) {
@@ -101,20 +107,28 @@ void CSVScanner::Produce() {
 }
 
 void CSVScanner::Initialize() {
-  // Let's first perform a few validity checks
-  boost::filesystem::path path(file_path_);
-
-  if (!boost::filesystem::exists(path)) {
-    throw ExecutorException(StringUtil::Format("input path '%s' does not exist",
-                                               file_path_.c_str()));
-  } else if (!boost::filesystem::is_regular_file(file_path_)) {
-    auto msg =
-        StringUtil::Format("unable to read file '%s'", file_path_.c_str());
-    throw ExecutorException(msg);
-  }
+  if (file_path_.empty()) {
+    // The data comes from the client, over the connection
+    if (input_ == nullptr) {
+      throw ExecutorException(
+          "COPY FROM STDIN is only supported in a simple query");
+    }
+  } else {
+    // Let's first perform a few validity checks
+    boost::filesystem::path path(file_path_);
+
+    if (!boost::filesystem::exists(path)) {
+      throw ExecutorException(StringUtil::Format(
+          "input path '%s' does not exist", file_path_.c_str()));
+    } else if (!boost::filesystem::is_regular_file(file_path_)) {
+      auto msg =
+          StringUtil::Format("unable to read file '%s'", file_path_.c_str());
+      throw ExecutorException(msg);
+    }
 
-  // The path looks okay, let's try opening it
-  file_.Open(file_path_, peloton::util::File::AccessMode::ReadOnly);
+    // The path looks okay, let's try opening it
+    file_.Open(file_path_, peloton::util::File::AccessMode::ReadOnly);
+  }
 
   // Allocate buffer space
   buffer_ = static_cast<char *>(memory_.Allocate(kDefaultBufferSize));
@@ -132,7 +146,13 @@ void CSVScanner::Initialize() {
 bool CSVScanner::NextBuffer() {
   // Do read
   buffer_pos_ = 0;
-  buffer_end_ = static_cast<uint32_t>(file_.Read(buffer_, kDefaultBufferSize));
+  if (input_ != nullptr) {
+    buffer_end_ =
+        static_cast<uint32_t>(input_->Read(buffer_, kDefaultBufferSize));
+  } else {
+    buffer_end_ =
+        static_cast<uint32_t>(file_.Read(buffer_, kDefaultBufferSize));
+  }
 
   // Update stats
   stats_.num_reads++;
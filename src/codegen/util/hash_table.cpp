@@ -12,6 +12,8 @@
 
 #include "codegen/util/hash_table.h"
 
+#include <algorithm>
+
 #include "common/platform.h"
 #include "type/abstract_pool.h"
 
@@ -91,10 +93,14 @@ void HashTable::EntryBuffer::TransferMemoryBlocks(
     tail = tail->next;
   }
 
-  // Transfer everything to the target entry buffer
+  // Transfer everything to the target entry buffer. The head of the target
+  // chain must only be read once per attempt, otherwise a concurrent transfer
+  // that lands between linking and swapping would be lost.
+  MemoryBlock *target_head;
   do {
-    tail->next = target.block_;
-  } while (!::peloton::atomic_cas(&target.block_, target.block_, block_));
+    target_head = target.block_;
+    tail->next = target_head;
+  } while (!::peloton::atomic_cas(&target.block_, target_head, block_));
 
   // Success
   block_ = nullptr;
@@ -114,7 +120,10 @@ HashTable::HashTable(::peloton::type::AbstractPool &memory, uint32_t key_size,
       directory_mask_(0),
       entry_buffer_(memory, Entry::Size(key_size, value_size)),
       num_elems_(0),
-      capacity_(kDefaultNumElements) {
+      capacity_(kDefaultNumElements),
+      partition_entries_(nullptr),
+      partition_offsets_(nullptr),
+      num_partition_bits_(0) {
   // Upon creation, we allocate room for kDefaultNumElements in the hash table.
   // We assume 50% load factor on the directory, thus the directory size is
   // twice the number of elements.
@@ -133,6 +142,16 @@ HashTable::~HashTable() {
     memory_.Free(directory_);
     directory_ = nullptr;
   }
+
+  // Free the partitions
+  if (partition_entries_ != nullptr) {
+    memory_.Free(partition_entries_);
+    partition_entries_ = nullptr;
+  }
+  if (partition_offsets_ != nullptr) {
+    memory_.Free(partition_offsets_);
+    partition_offsets_ = nullptr;
+  }
 }
 
 void HashTable::Init(HashTable &table, executor::ExecutorContext &exec_ctx,
@@ -235,6 +254,9 @@ void HashTable::ReserveLazy(
     total_size += hash_table->NumElements();
   }
 
+  // Nothing was inserted, the directory allocated on construction is valid
+  if (total_size == 0) return;
+
   // TODO: Combine sketches to estimate the true unique # of elements
 
   // Perfectly size the hash table
@@ -244,6 +266,9 @@ void HashTable::ReserveLazy(
   directory_size_ = capacity_ * 2;
   directory_mask_ = directory_size_ - 1;
 
+  // Release the directory allocated on construction
+  memory_.Free(directory_);
+
   uint64_t alloc_size = sizeof(Entry *) * directory_size_;
   directory_ = static_cast<Entry **>(memory_.Allocate(alloc_size));
   PELOTON_MEMSET(directory_, 0, alloc_size);
@@ -279,6 +304,121 @@ void HashTable::MergeLazyUnfinished(HashTable &other) {
   other.entry_buffer_.TransferMemoryBlocks(entry_buffer_);
 }
 
+void HashTable::PartitionLazy(uint32_t num_partition_bits) {
+  PartitionEntries({this}, num_partition_bits);
+}
+
+void HashTable::PartitionLazyParallel(
+    const executor::ExecutorContext::ThreadStates &thread_states,
+    uint32_t hash_table_offset, uint32_t num_partition_bits) {
+  std::vector<const HashTable *> tables;
+  for (uint32_t i = 0; i < thread_states.NumThreads(); i++) {
+    tables.push_back(reinterpret_cast<HashTable *>(
+        thread_states.AccessThreadState(i) + hash_table_offset));
+  }
+  PartitionEntries(tables, num_partition_bits);
+}
+
+void HashTable::PartitionEntries(const std::vector<const HashTable *> &tables,
+                                 uint32_t num_partition_bits) {
+  PELOTON_ASSERT(partition_entries_ == nullptr);
+  PELOTON_ASSERT(num_partition_bits < 32);
+
+  num_partition_bits_ = num_partition_bits;
+  uint32_t num_partitions = NumPartitions();
+  uint32_t entry_size = entry_buffer_.EntrySize();
+
+  // First pass: build the histogram of the partitions. Lazily inserted
+  // entries are linked from the first slot in the directory.
+  std::vector<uint64_t> histogram(num_partitions, 0);
+  for (const auto *table : tables) {
+    PELOTON_ASSERT(table->entry_buffer_.EntrySize() == entry_size);
+    for (auto *entry = table->directory_[0]; entry != nullptr;
+         entry = entry->next) {
+      histogram[PartitionOf(entry->hash)]++;
+    }
+  }
+
+  // Turn the histogram into the start offsets of every partition
+  uint64_t offsets_size = sizeof(uint64_t) * (num_partitions + 1);
+  partition_offsets_ = static_cast<uint64_t *>(memory_.Allocate(offsets_size));
+  uint64_t total_size = 0, max_partition_size = 0;
+  for (uint32_t i = 0; i < num_partitions; i++) {
+    partition_offsets_[i] = total_size;
+    total_size += histogram[i];
+    max_partition_size = std::max(max_partition_size, histogram[i]);
+  }
+  partition_offsets_[num_partitions] = total_size;
+
+  // Second pass: scatter the entries into their partitions
+  partition_entries_ = static_cast<char *>(
+      memory_.Allocate(std::max(total_size, 1ul) * entry_size));
+  std::vector<uint64_t> write_pos(partition_offsets_,
+                                  partition_offsets_ + num_partitions);
+  for (const auto *table : tables) {
+    for (auto *entry = table->directory_[0]; entry != nullptr;
+         entry = entry->next) {
+      uint64_t partition = PartitionOf(entry->hash);
+      uint64_t pos = write_pos[partition]++;
+      auto *copy =
+          reinterpret_cast<Entry *>(partition_entries_ + pos * entry_size);
+      PELOTON_MEMCPY(copy, entry, entry_size);
+
+      // Link the entries of a partition in storage order
+      copy->next = nullptr;
+      if (pos + 1 < partition_offsets_[partition + 1]) {
+        copy->next = reinterpret_cast<Entry *>(
+            partition_entries_ + (pos + 1) * entry_size);
+      }
+    }
+  }
+  num_elems_ = total_size;
+
+  // Allocate a directory large enough for the largest partition. It is reused
+  // by every partition that is built.
+  memory_.Free(directory_);
+  directory_size_ = NextPowerOf2(std::max(max_partition_size, 1ul)) * 2;
+  directory_mask_ = directory_size_ - 1;
+  uint64_t alloc_size = sizeof(Entry *) * directory_size_;
+  directory_ = static_cast<Entry **>(memory_.Allocate(alloc_size));
+  PELOTON_MEMSET(directory_, 0, alloc_size);
+}
+
+void HashTable::BuildPartition(uint32_t partition) {
+  PELOTON_ASSERT(partition_offsets_ != nullptr);
+  PELOTON_ASSERT(partition < NumPartitions());
+
+  uint64_t begin = partition_offsets_[partition];
+  uint64_t end = partition_offsets_[partition + 1];
+
+  // Size the directory for this partition with 50% load factor. It is never
+  // larger than the one allocated for the largest partition.
+  directory_size_ = NextPowerOf2(std::max(end - begin, 1ul)) * 2;
+  directory_mask_ = directory_size_ - 1;
+  PELOTON_MEMSET(directory_, 0, sizeof(Entry *) * directory_size_);
+
+  uint32_t entry_size = entry_buffer_.EntrySize();
+  for (uint64_t pos = begin; pos < end; pos++) {
+    auto *entry =
+        reinterpret_cast<Entry *>(partition_entries_ + pos * entry_size);
+    uint64_t index = entry->hash & directory_mask_;
+    entry->next = directory_[index];
+    directory_[index] = entry;
+  }
+}
+
+HashTable::Entry *HashTable::GetPartitionHead(uint32_t partition) const {
+  PELOTON_ASSERT(partition_offsets_ != nullptr);
+  PELOTON_ASSERT(partition < NumPartitions());
+
+  uint64_t begin = partition_offsets_[partition];
+  if (begin == partition_offsets_[partition + 1]) {
+    return nullptr;
+  }
+  return reinterpret_cast<Entry *>(partition_entries_ +
+                                   begin * entry_buffer_.EntrySize());
+}
+
 void HashTable::Resize() {
   // Sanity check
   PELOTON_ASSERT(NeedsResize());
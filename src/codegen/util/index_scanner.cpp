@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scanner.cpp
+//
+// Identification: src/codegen/util/index_scanner.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/index_scanner.h"
+
+#include "catalog/schema.h"
+#include "codegen/query_parameters.h"
+#include "common/container_tuple.h"
+#include "concurrency/transaction_context.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "index/index.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
+#include "storage/data_table.h"
+#include "storage/masked_tuple.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+IndexScanner::IndexScanner(executor::ExecutorContext &executor_context,
+                           storage::DataTable &table, uint32_t index_oid,
+                           const uint32_t *key_column_ids,
+                           const int32_t *expr_types,
+                           const uint32_t *key_param_idxs, uint32_t num_keys,
+                           uint32_t max_run_size)
+    : txn_(executor_context.GetTransaction()),
+      index_(table.GetIndexWithOid(index_oid)),
+      max_run_size_(max_run_size) {
+  PELOTON_ASSERT(index_ != nullptr);
+  PELOTON_ASSERT(max_run_size_ > 0);
+
+  if (index_->GetIndexType() != IndexConstraintType::PRIMARY_KEY) {
+    indexed_columns_ = index_->GetKeySchema()->GetIndexedColumns();
+  }
+
+  // The key values are parameters of the query, cast to the type of the
+  // column they are compared with
+  const auto &params = executor_context.GetParams().GetParameterValues();
+  const auto *schema = table.GetSchema();
+  for (uint32_t i = 0; i < num_keys; i++) {
+    auto col_type = schema->GetColumn(key_column_ids[i]).GetType();
+    key_column_ids_.push_back(key_column_ids[i]);
+    expr_types_.push_back(static_cast<ExpressionType>(expr_types[i]));
+    values_.push_back(params[key_param_idxs[i]].CastAs(col_type));
+  }
+
+  if (!key_column_ids_.empty()) {
+    index_predicate_.AddConjunctionScanPredicate(index_.get(), values_,
+                                                 key_column_ids_, expr_types_);
+  }
+}
+
+void IndexScanner::Init(IndexScanner &scanner,
+                        executor::ExecutorContext &executor_context,
+                        storage::DataTable &table, uint32_t index_oid,
+                        const uint32_t *key_column_ids,
+                        const int32_t *expr_types,
+                        const uint32_t *key_param_idxs, uint32_t num_keys,
+                        uint32_t max_run_size) {
+  // Forward to constructor
+  new (&scanner)
+      IndexScanner(executor_context, table, index_oid, key_column_ids,
+                   expr_types, key_param_idxs, num_keys, max_run_size);
+}
+
+void IndexScanner::Destroy(IndexScanner &scanner) {
+  // Forward to destructor
+  scanner.~IndexScanner();
+}
+
+void IndexScanner::Scan() {
+  runs_.clear();
+
+  // Probe the index
+  std::vector<ItemPointer *> tuple_location_ptrs;
+  if (key_column_ids_.empty()) {
+    index_->ScanAllKeys(tuple_location_ptrs);
+  } else {
+    index_->Scan(values_, key_column_ids_, expr_types_,
+                 ScanDirectionType::FORWARD, tuple_location_ptrs,
+                 &index_predicate_.GetConjunctionList()[0]);
+  }
+
+  auto *storage_manager = storage::StorageManager::GetInstance();
+  std::shared_ptr<storage::TileGroup> tile_group;
+  size_t num_versions = 0;
+  for (auto *tuple_location_ptr : tuple_location_ptrs) {
+    ItemPointer location = *tuple_location_ptr;
+    if (tile_group == nullptr ||
+        tile_group->GetTileGroupId() != location.block) {
+      tile_group = storage_manager->GetTileGroup(location.block);
+    }
+
+    bool visible = false;
+    if (!FindVisibleVersion(location, tile_group, visible, num_versions)) {
+      // There must be a visible version in every chain we reach through the
+      // index. If there isn't, the scan (and its transaction) fails.
+      auto &txn_manager =
+          concurrency::TransactionManagerFactory::GetInstance();
+      txn_manager.SetTransactionResult(txn_, ResultType::FAILURE);
+      runs_.clear();
+      return;
+    }
+
+    if (visible && KeyMatches(location, tile_group)) {
+      AppendToRun(location, tile_group);
+    }
+  }
+
+  if (!tuple_location_ptrs.empty() &&
+      static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()
+        ->GetGCMetric()
+        .RecordVersionChains(tuple_location_ptrs.size(), num_versions);
+  }
+}
+
+bool IndexScanner::FindVisibleVersion(
+    ItemPointer &location, std::shared_ptr<storage::TileGroup> &tile_group,
+    bool &visible, size_t &num_versions) const {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *storage_manager = storage::StorageManager::GetInstance();
+  auto *tile_group_header = tile_group->GetHeader();
+
+  size_t chain_length = 0;
+  while (true) {
+    ++chain_length;
+    ++num_versions;
+
+    auto visibility =
+        txn_manager.IsVisible(txn_, tile_group_header, location.offset);
+    if (visibility == VisibilityType::DELETED) {
+      visible = false;
+      return true;
+    }
+    if (visibility == VisibilityType::OK) {
+      visible = true;
+      return true;
+    }
+
+    PELOTON_ASSERT(visibility == VisibilityType::INVISIBLE);
+
+    bool is_acquired = (tile_group_header->GetTransactionId(location.offset) ==
+                        INITIAL_TXN_ID);
+    bool is_alive = (tile_group_header->GetEndCommitId(location.offset) <=
+                     txn_->GetReadId());
+    if (is_acquired && is_alive) {
+      // Some other transaction modified the version chain and the version we
+      // hold has expired. Start over from the head of the chain.
+      location = *(tile_group_header->GetIndirection(location.offset));
+      chain_length = 0;
+    } else {
+      location = tile_group_header->GetNextItemPointer(location.offset);
+      if (location.IsNull()) {
+        // A lone invisible version simply isn't produced, but a chain without
+        // a visible version is an error
+        visible = false;
+        return chain_length == 1;
+      }
+    }
+
+    tile_group = storage_manager->GetTileGroup(location.block);
+    tile_group_header = tile_group->GetHeader();
+  }
+}
+
+bool IndexScanner::KeyMatches(
+    const ItemPointer &location,
+    const std::shared_ptr<storage::TileGroup> &tile_group) const {
+  if (indexed_columns_.empty() || key_column_ids_.empty()) {
+    return true;
+  }
+  ContainerTuple<storage::TileGroup> tuple(tile_group.get(), location.offset);
+  storage::MaskedTuple key_tuple(&tuple, indexed_columns_);
+  return index_->Compare(key_tuple, key_column_ids_, expr_types_, values_);
+}
+
+void IndexScanner::AppendToRun(
+    const ItemPointer &location,
+    const std::shared_ptr<storage::TileGroup> &tile_group) {
+  // Start a new run when the tile group changes or the current run is full
+  if (runs_.empty() ||
+      runs_.back().tile_group->GetTileGroupId() != location.block ||
+      runs_.back().offsets.size() >= max_run_size_) {
+    runs_.push_back(Run{tile_group, {}});
+  }
+  runs_.back().offsets.push_back(location.offset);
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
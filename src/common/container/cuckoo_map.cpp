@@ -18,6 +18,7 @@
 #include "common/item_pointer.h"
 #include "common/logger.h"
 #include "common/macros.h"
+#include "index/index_key.h"
 
 namespace peloton {
 
@@ -54,6 +55,13 @@ void CUCKOO_MAP_TYPE::Upsert(const KeyType &key, ValueType value) {
   cuckoo_map.upsert(key, update_fn, value);
 }
 
+CUCKOO_MAP_TEMPLATE_ARGUMENTS
+void CUCKOO_MAP_TYPE::UpsertFn(const KeyType &key,
+                               std::function<void(ValueType &)> update_fn,
+                               ValueType value) {
+  cuckoo_map.upsert(key, update_fn, value);
+}
+
 CUCKOO_MAP_TEMPLATE_ARGUMENTS
 bool CUCKOO_MAP_TYPE::Update(const KeyType &key, ValueType value) {
   auto status = cuckoo_map.update(key, value);
@@ -61,6 +69,14 @@ bool CUCKOO_MAP_TYPE::Update(const KeyType &key, ValueType value) {
   return status;
 }
 
+CUCKOO_MAP_TEMPLATE_ARGUMENTS
+bool CUCKOO_MAP_TYPE::UpdateFn(const KeyType &key,
+                               std::function<void(ValueType &)> update_fn) {
+  auto status = cuckoo_map.update_fn(key, update_fn);
+  LOG_TRACE("update status : %d", status);
+  return status;
+}
+
 CUCKOO_MAP_TEMPLATE_ARGUMENTS
 bool CUCKOO_MAP_TYPE::Erase(const KeyType &key) {
   auto status = cuckoo_map.erase(key);
@@ -86,6 +102,11 @@ void CUCKOO_MAP_TYPE::Clear() { cuckoo_map.clear(); }
 CUCKOO_MAP_TEMPLATE_ARGUMENTS
 size_t CUCKOO_MAP_TYPE::GetSize() const { return cuckoo_map.size(); }
 
+CUCKOO_MAP_TEMPLATE_ARGUMENTS
+size_t CUCKOO_MAP_TYPE::GetCapacity() const {
+  return cuckoo_map.bucket_count() * cuckoo_map_t::slot_per_bucket;
+}
+
 CUCKOO_MAP_TEMPLATE_ARGUMENTS
 bool CUCKOO_MAP_TYPE::IsEmpty() const { return cuckoo_map.empty(); }
 
@@ -125,4 +146,36 @@ template class CuckooMap<std::shared_ptr<oid_t>, std::shared_ptr<oid_t>>;
 // Used in StatementCacheManager
 template class CuckooMap<StatementCache *, StatementCache *>;
 
+// Used in HashIndex
+template class CuckooMap<index::CompactIntsKey<1>, std::vector<ItemPointer *>,
+                         index::CompactIntsHasher<1>,
+                         index::CompactIntsEqualityChecker<1>>;
+template class CuckooMap<index::CompactIntsKey<2>, std::vector<ItemPointer *>,
+                         index::CompactIntsHasher<2>,
+                         index::CompactIntsEqualityChecker<2>>;
+template class CuckooMap<index::CompactIntsKey<3>, std::vector<ItemPointer *>,
+                         index::CompactIntsHasher<3>,
+                         index::CompactIntsEqualityChecker<3>>;
+template class CuckooMap<index::CompactIntsKey<4>, std::vector<ItemPointer *>,
+                         index::CompactIntsHasher<4>,
+                         index::CompactIntsEqualityChecker<4>>;
+template class CuckooMap<index::GenericKey<4>, std::vector<ItemPointer *>,
+                         index::GenericHasher<4>,
+                         index::GenericEqualityChecker<4>>;
+template class CuckooMap<index::GenericKey<8>, std::vector<ItemPointer *>,
+                         index::GenericHasher<8>,
+                         index::GenericEqualityChecker<8>>;
+template class CuckooMap<index::GenericKey<16>, std::vector<ItemPointer *>,
+                         index::GenericHasher<16>,
+                         index::GenericEqualityChecker<16>>;
+template class CuckooMap<index::GenericKey<64>, std::vector<ItemPointer *>,
+                         index::GenericHasher<64>,
+                         index::GenericEqualityChecker<64>>;
+template class CuckooMap<index::GenericKey<256>, std::vector<ItemPointer *>,
+                         index::GenericHasher<256>,
+                         index::GenericEqualityChecker<256>>;
+template class CuckooMap<index::TupleKey, std::vector<ItemPointer *>,
+                         index::TupleKeyHasher,
+                         index::TupleKeyEqualityChecker>;
+
 }  // namespace peloton
@@ -16,15 +16,23 @@
 #include <google/protobuf/stubs/common.h>
 
 #include "catalog/catalog.h"
+#include "catalog/database_catalog.h"
+#include "common/exception.h"
 #include "common/statement_cache_manager.h"
 #include "common/thread_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "logging/checkpoint_manager_factory.h"
+#include "logging/log_manager_factory.h"
+#include "logging/logical_recovery_manager.h"
 #include "settings/settings_manager.h"
+#include "storage/tile_group_compactor.h"
+#include "storage/tile_group_freezer.h"
 #include "threadpool/mono_queue_pool.h"
 #include "tuning/index_tuner.h"
 #include "tuning/layout_tuner.h"
+#include "util/string_util.h"
 
 namespace peloton {
 
@@ -33,7 +41,8 @@ ThreadPool thread_pool;
 void PelotonInit::Initialize() {
   CONNECTION_THREAD_COUNT = settings::SettingsManager::GetInt(
       settings::SettingId::connection_thread_count);
-  LOGGING_THREAD_COUNT = 1;
+  LOGGING_THREAD_COUNT =
+      settings::SettingsManager::GetInt(settings::SettingId::log_num_threads);
   GC_THREAD_COUNT = 1;
   EPOCH_THREAD_COUNT = 1;
 
@@ -51,6 +60,12 @@ void PelotonInit::Initialize() {
   // start parallel execution pool
   threadpool::MonoQueuePool::GetExecutionInstance().Startup();
 
+  // start background query compilation pool
+  threadpool::MonoQueuePool::GetCompilationInstance().Startup();
+
+  // start background table analysis pool
+  threadpool::MonoQueuePool::GetAnalyzeInstance().Startup();
+
   int parallelism = (CONNECTION_THREAD_COUNT + 3) / 4;
   storage::DataTable::SetActiveTileGroupCount(parallelism);
   storage::DataTable::SetActiveIndirectionArrayCount(parallelism);
@@ -62,6 +77,87 @@ void PelotonInit::Initialize() {
   gc::GCManagerFactory::Configure(settings::SettingsManager::GetInt(settings::SettingId::gc_num_threads));
   gc::GCManagerFactory::GetInstance().StartGC();
 
+  // configure logging. the log is only written once the recovery is done.
+  bool logging =
+      settings::SettingsManager::GetBool(settings::SettingId::logging);
+  std::vector<std::string> log_directories;
+  if (logging) {
+    logging::LogManagerFactory::Configure(LOGGING_THREAD_COUNT);
+    auto &log_manager =
+        logging::LogicalLogManager::GetInstance(LOGGING_THREAD_COUNT);
+    log_directories = StringUtil::Split(
+        settings::SettingsManager::GetString(
+            settings::SettingId::log_directory),
+        ',');
+    log_manager.SetDirectories(log_directories);
+    log_manager.SetSyncCommit(settings::SettingsManager::GetBool(
+        settings::SettingId::log_sync_commit));
+  } else {
+    logging::LogManagerFactory::Configure(0);
+  }
+
+  // configure checkpointing. the recovery checkpoints the recovered state
+  // even if periodic checkpoints are off, as the replayed logs can only be
+  // dropped once a checkpoint covers them.
+  bool checkpointing =
+      settings::SettingsManager::GetBool(settings::SettingId::checkpointing);
+  if (logging || checkpointing) {
+    int checkpoint_thread_count = settings::SettingsManager::GetInt(
+        settings::SettingId::checkpoint_num_threads);
+    logging::CheckpointManagerFactory::Configure(checkpoint_thread_count);
+    auto &checkpoint_manager =
+        logging::LogicalCheckpointManager::GetInstance(checkpoint_thread_count);
+    checkpoint_manager.SetDirectory(settings::SettingsManager::GetString(
+        settings::SettingId::checkpoint_directory));
+    checkpoint_manager.SetCheckpointInterval(settings::SettingsManager::GetInt(
+        settings::SettingId::checkpoint_interval));
+  } else {
+    logging::CheckpointManagerFactory::Configure(0);
+  }
+
+  // Initialize catalog
+  auto pg_catalog = catalog::Catalog::GetInstance();
+  pg_catalog->Bootstrap();  // Additional catalogs
+  settings::SettingsManager::GetInstance().InitializeCatalog();
+
+  // recover the schema and the data of the previous runs.
+  if (logging) {
+    logging::LogicalRecoveryManager recovery_manager(
+        settings::SettingsManager::GetString(
+            settings::SettingId::checkpoint_directory),
+        log_directories, LOGGING_THREAD_COUNT);
+    if (recovery_manager.DoRecovery() == false) {
+      throw Exception("Failed to recover from the log");
+    }
+  }
+
+  // start logging.
+  if (logging) {
+    logging::LogicalLogManager::GetInstance(LOGGING_THREAD_COUNT)
+        .StartLogging();
+  }
+
+  // start checkpointing.
+  if (checkpointing) {
+    logging::CheckpointManagerFactory::GetInstance().StartCheckpointing();
+  }
+
+  // start tile group freezer
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::tile_group_freezing)) {
+    storage::TileGroupFreezer::GetInstance().StartFreezing(
+        settings::SettingsManager::GetInt(
+            settings::SettingId::tile_group_freeze_interval));
+  }
+
+  // start tile group compactor
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::tile_group_compaction)) {
+    storage::TileGroupCompactor::GetInstance().StartCompacting(
+        settings::SettingsManager::GetInt(
+            settings::SettingId::tile_group_compaction_interval));
+  }
+
   // start index tuner
   if (settings::SettingsManager::GetBool(settings::SettingId::index_tuner)) {
     // Set the default visibility flag for all indexes to false
@@ -76,18 +172,17 @@ void PelotonInit::Initialize() {
     layout_tuner.Start();
   }
 
-  // Initialize catalog
-  auto pg_catalog = catalog::Catalog::GetInstance();
-  pg_catalog->Bootstrap();  // Additional catalogs
-  settings::SettingsManager::GetInstance().InitializeCatalog();
-
   // begin a transaction
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
 
   // initialize the catalog and add the default database, so we don't do this on
-  // the first query
-  pg_catalog->CreateDatabase(txn, DEFAULT_DB_NAME);
+  // the first query. it may have been recovered already.
+  try {
+    pg_catalog->GetDatabaseCatalogEntry(txn, DEFAULT_DB_NAME);
+  } catch (CatalogException &e) {
+    pg_catalog->CreateDatabase(txn, DEFAULT_DB_NAME);
+  }
 
   txn_manager.CommitTransaction(txn);
 
@@ -108,6 +203,21 @@ void PelotonInit::Shutdown() {
     layout_tuner.Stop();
   }
 
+  // shut down background table analysis, it runs transactions
+  threadpool::MonoQueuePool::GetAnalyzeInstance().Shutdown();
+
+  // shut down tile group compactor
+  storage::TileGroupCompactor::GetInstance().StopCompacting();
+
+  // shut down tile group freezer
+  storage::TileGroupFreezer::GetInstance().StopFreezing();
+
+  // shut down checkpointing.
+  logging::CheckpointManagerFactory::GetInstance().StopCheckpointing();
+
+  // shut down logging.
+  logging::LogManagerFactory::GetInstance().StopLogging();
+
   // shut down GC.
   gc::GCManagerFactory::GetInstance().StopGC();
 
@@ -117,6 +227,10 @@ void PelotonInit::Shutdown() {
   // shutdown execution thread pool
   threadpool::MonoQueuePool::GetExecutionInstance().Shutdown();
 
+  // shutdown background query compilation pool, once it compiled the queued
+  // queries
+  threadpool::MonoQueuePool::GetCompilationInstance().Shutdown();
+
   // stop worker pool
   threadpool::MonoQueuePool::GetInstance().Shutdown();
 
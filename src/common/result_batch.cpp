@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// result_batch.cpp
+//
+// Identification: src/common/result_batch.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/result_batch.h"
+
+namespace peloton {
+
+size_t ResultBatch::GetRowSize(size_t row) const {
+  size_t end = (row + 1 < row_offsets_.size()) ? row_offsets_[row + 1]
+                                                : data_.size();
+  return end - row_offsets_[row];
+}
+
+const char *ResultBatch::ReadColumn(const char *pos, const char *&data,
+                                    int32_t &len) {
+  uint32_t bits = 0;
+  for (size_t i = 0; i < sizeof(bits); i++) {
+    bits = (bits << 8) | static_cast<unsigned char>(pos[i]);
+  }
+  len = static_cast<int32_t>(bits);
+  data = pos + sizeof(bits);
+  return data + (len > 0 ? len : 0);
+}
+
+void ResultBatch::DropRows(size_t num_rows) {
+  if (num_rows >= row_offsets_.size()) {
+    Clear();
+    return;
+  }
+  size_t num_bytes = row_offsets_[num_rows];
+  data_.erase(0, num_bytes);
+  row_offsets_.erase(row_offsets_.begin(), row_offsets_.begin() + num_rows);
+  for (auto &offset : row_offsets_) {
+    offset -= num_bytes;
+  }
+}
+
+void ResultBatch::GetValues(std::vector<ResultValue> &values) const {
+  const char *pos = data_.data();
+  const char *end = pos + data_.size();
+  while (pos < end) {
+    const char *data;
+    int32_t len;
+    pos = ReadColumn(pos, data, len);
+    if (len < 0) {
+      values.emplace_back();
+    } else {
+      values.emplace_back(data, len);
+    }
+  }
+}
+
+}  // namespace peloton
@@ -24,9 +24,12 @@ namespace concurrency {
 
     if (ts_type == TimestampType::SNAPSHOT_READ) {
 
-      local_epochs_.at(thread_id)->EnterEpoch(snapshot_global_epoch_id_, ts_type);
+      // the snapshot epoch may move forward meanwhile, so it's read once.
+      eid_t snapshot_epoch_id = snapshot_global_epoch_id_.load();
 
-      return (snapshot_global_epoch_id_ << 32) | 0x0;
+      local_epochs_.at(thread_id)->EnterEpoch(snapshot_epoch_id, ts_type);
+
+      return (snapshot_epoch_id << 32) | 0x0;
 
     } else {
 
@@ -76,9 +79,20 @@ namespace concurrency {
     // if we observe that global_expired_eid is larger than snapshot_global_epoch,
     // then it means the current thread's progress is too slow.
     // we should directly update it to global_expired_eid + 1.
-    if (global_expired_eid != MAX_EID && 
-        global_expired_eid >= snapshot_global_epoch_id_) {
-      snapshot_global_epoch_id_ = global_expired_eid + 1;
+    // several threads may compute the expired epoch concurrently, so both
+    // the snapshot epoch and the published value only move forward.
+    if (global_expired_eid != MAX_EID) {
+      eid_t snapshot_eid = snapshot_global_epoch_id_.load();
+      while (global_expired_eid >= snapshot_eid &&
+             snapshot_global_epoch_id_.compare_exchange_weak(
+                 snapshot_eid, global_expired_eid + 1) == false) {
+      }
+
+      eid_t last_expired_eid = last_expired_epoch_id_.load();
+      while (global_expired_eid > last_expired_eid &&
+             last_expired_epoch_id_.compare_exchange_weak(
+                 last_expired_eid, global_expired_eid) == false) {
+      }
     }
 
     return global_expired_eid;
@@ -22,11 +22,33 @@
 #include "concurrency/transaction_context.h"
 #include "gc/gc_manager_factory.h"
 #include "logging/log_manager_factory.h"
+#include "optimizer/stats/stats_storage.h"
 #include "settings/settings_manager.h"
 
 namespace peloton {
 namespace concurrency {
 
+namespace {
+
+// add the tuples of a table modified by a committing transaction to its
+// counts. a transaction modifies few tables, so the counts are a vector.
+void CountModifications(
+    std::vector<std::pair<storage::AbstractTable *, size_t>> &modified_counts,
+    storage::AbstractTable *table, size_t modified_count) {
+  if (table == nullptr || modified_count == 0) {
+    return;
+  }
+  for (auto &entry : modified_counts) {
+    if (entry.first == table) {
+      entry.second += modified_count;
+      return;
+    }
+  }
+  modified_counts.emplace_back(table, modified_count);
+}
+
+}  // namespace
+
 bool TimestampOrderingTransactionManager::SetLastReaderCommitId(
     const storage::TileGroupHeader *const tile_group_header,
     const oid_t &tuple_id, const cid_t &current_cid, const bool is_owner) {
@@ -360,6 +382,7 @@ void TimestampOrderingTransactionManager::PerformInsert(
   tile_group_header->SetTransactionId(tuple_id, transaction_id);
   tile_group_header->SetLastReaderCommitId(tuple_id,
                                            current_txn->GetCommitId());
+  tile_group_header->RecordWrite(current_txn->GetEpochId());
 
   // no need to set next item pointer.
 
@@ -417,6 +440,10 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   new_tile_group_header->SetLastReaderCommitId(new_location.offset,
                                                current_txn->GetCommitId());
 
+  // keep both tile groups from being frozen while they're written to
+  tile_group_header->RecordWrite(current_txn->GetEpochId());
+  new_tile_group_header->RecordWrite(current_txn->GetEpochId());
+
   // we should guarantee that the newer version is all set before linking the
   // newer version to older version.
   COMPILER_MEMORY_FENCE;
@@ -524,6 +551,10 @@ void TimestampOrderingTransactionManager::PerformDelete(
 
   new_tile_group_header->SetEndCommitId(new_location.offset, INVALID_CID);
 
+  // keep both tile groups from being frozen while they're written to
+  tile_group_header->RecordWrite(current_txn->GetEpochId());
+  new_tile_group_header->RecordWrite(current_txn->GetEpochId());
+
   // we should guarantee that the newer version is all set before linking the
   // newer version to older version.
   COMPILER_MEMORY_FENCE;
@@ -579,6 +610,18 @@ void TimestampOrderingTransactionManager::PerformDelete(
   }
 }
 
+void TimestampOrderingTransactionManager::RecordModifications(
+    const std::vector<std::pair<storage::AbstractTable *, size_t>>
+        &modified_counts) {
+  for (auto &entry : modified_counts) {
+    auto data_table = dynamic_cast<storage::DataTable *>(entry.first);
+    if (data_table != nullptr) {
+      optimizer::StatsStorage::RecordTableModifications(data_table,
+                                                        entry.second);
+    }
+  }
+}
+
 ResultType TimestampOrderingTransactionManager::CommitTransaction(
     TransactionContext *const current_txn) {
   LOG_TRACE("Committing peloton txn : %" PRId64,
@@ -597,13 +640,29 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
   //////////////////////////////////////////////////////////
 
   auto storage_manager = storage::StorageManager::GetInstance();
-  auto &log_manager = logging::LogManager::GetInstance();
+  auto &log_manager = logging::LogManagerFactory::GetInstance();
+
+  // once the log has failed, nothing can be made durable anymore. the
+  // transaction is rolled back before any of its versions become visible.
+  if (log_manager.HasFailed() == true) {
+    LOG_ERROR("The log has failed, aborting txn %" PRId64,
+              current_txn->GetTransactionId());
+    AbortTransaction(current_txn);
+    return ResultType::FAILURE;
+  }
 
-  log_manager.StartLogging();
+  // the shared catalog cache must not be used while the catalog changes of
+  // the transaction become visible
+  bool is_catalog_change = current_txn->catalog_cache.IsModified();
+  if (is_catalog_change) {
+    catalog::SharedCatalogCache::GetInstance().BeginInvalidation();
+  }
 
   // generate transaction id.
   cid_t end_commit_id = current_txn->GetCommitId();
 
+  log_manager.LogBegin(end_commit_id);
+
   auto &rw_set = current_txn->GetReadWriteSet();
   auto &rw_object_set = current_txn->GetCreateDropSet();
 
@@ -628,15 +687,30 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
   oid_t last_tile_group_id = INVALID_OID;
   storage::TileGroupHeader *tile_group_header = nullptr;
 
+  // count the modified tuples of each table, for its stats to be refreshed
+  // once they are all installed. only auto analyze needs the counts.
+  bool count_modifications =
+      settings::SettingsManager::GetBool(settings::SettingId::auto_analyze);
+  std::vector<std::pair<storage::AbstractTable *, size_t>> modified_counts;
+  storage::AbstractTable *last_table = nullptr;
+  size_t modified_count = 0;
+
   for (const auto &tuple_entry : rw_set) {
     ItemPointer item_ptr = tuple_entry.first;
     oid_t tile_group_id = item_ptr.block;
     oid_t tuple_slot = item_ptr.offset;
 
     if (tile_group_id != last_tile_group_id) {
-      tile_group_header =
-          storage_manager->GetTileGroup(tile_group_id)->GetHeader();
+      auto tile_group = storage_manager->GetTileGroup(tile_group_id);
+      tile_group_header = tile_group->GetHeader();
       last_tile_group_id = tile_group_id;
+
+      if (count_modifications &&
+          tile_group->GetAbstractTable() != last_table) {
+        CountModifications(modified_counts, last_table, modified_count);
+        last_table = tile_group->GetAbstractTable();
+        modified_count = 0;
+      }
     }
 
     if (tuple_entry.second == RWType::READ_OWN) {
@@ -645,6 +719,8 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
       // Yield the ownership
       YieldOwnership(current_txn, tile_group_header, tuple_slot);
     } else if (tuple_entry.second == RWType::UPDATE) {
+      modified_count++;
+
       // we must guarantee that, at any time point, only one version is
       // visible.
       ItemPointer new_version =
@@ -679,6 +755,8 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
       log_manager.LogUpdate(new_version);
 
     } else if (tuple_entry.second == RWType::DELETE) {
+      modified_count++;
+
       ItemPointer new_version =
           tile_group_header->GetPrevItemPointer(tuple_slot);
 
@@ -712,6 +790,8 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
       log_manager.LogDelete(ItemPointer(tile_group_id, tuple_slot));
 
     } else if (tuple_entry.second == RWType::INSERT) {
+      modified_count++;
+
       PELOTON_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
                      current_txn->GetTransactionId());
       // set the begin commit id to persist insert
@@ -748,12 +828,31 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
     }
   }
 
+  if (count_modifications) {
+    CountModifications(modified_counts, last_table, modified_count);
+    RecordModifications(modified_counts);
+  }
+
   ResultType result = current_txn->GetResult();
 
   log_manager.LogEnd();
 
+  if (is_catalog_change) {
+    catalog::SharedCatalogCache::GetInstance().EndInvalidation();
+  }
+
   EndTransaction(current_txn);
 
+  // the commit is only acknowledged once its records are durable. by now
+  // its versions are visible to other transactions, so a commit that cannot
+  // be persisted cannot be reported as aborted either. it is reported as a
+  // failure, and the log manager stays failed so that no later transaction
+  // commits.
+  if (log_manager.WaitForPersistence() == false) {
+    LOG_ERROR("Failed to persist the log of commit %" PRId64, end_commit_id);
+    return ResultType::FAILURE;
+  }
+
   return result;
 }
 
@@ -78,6 +78,8 @@ void TransactionContext::Init(const size_t thread_id,
 
   is_written_ = false;
 
+  garbage_version_count_ = 0;
+
   isolation_level_ = isolation;
 
   gc_set_ = std::make_shared<GCSet>();
@@ -35,6 +35,11 @@ TransactionContext *TransactionManager::BeginTransaction(
     const size_t thread_id, const IsolationLevelType type, bool read_only) {
   TransactionContext *txn = nullptr;
 
+  // the transaction may use the shared catalog cache only if no catalog
+  // change committed while it got its read id
+  auto &shared_catalog_cache = catalog::SharedCatalogCache::GetInstance();
+  uint64_t catalog_version = shared_catalog_cache.GetVersion();
+
   if (type == IsolationLevelType::SNAPSHOT) {
     // transaction processing with decentralized epoch manager
     // the DBMS must acquire
@@ -65,6 +70,10 @@ TransactionContext *TransactionManager::BeginTransaction(
     txn->SetReadOnly();
   }
 
+  if (shared_catalog_cache.GetVersion() == catalog_version) {
+    txn->catalog_cache.EnableSharing(txn, catalog_version);
+  }
+
   txn->SetTimestamp(function::DateFunctions::Now());
 
   return txn;
@@ -74,6 +83,12 @@ void TransactionManager::EndTransaction(TransactionContext *current_txn) {
   // fire all on commit triggers
   if (current_txn->GetResult() == ResultType::SUCCESS) {
     current_txn->ExecOnCommitTriggers();
+
+    // let the next transactions use the catalog entries it looked up
+    if (current_txn->catalog_cache.IsShareable()) {
+      catalog::SharedCatalogCache::GetInstance().Publish(
+          current_txn->catalog_cache);
+    }
   }
 
   // log RWSet and result stats
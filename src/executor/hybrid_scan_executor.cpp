@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "storage/storage_manager.h"
 #include "executor/hybrid_scan_executor.h"
 #include "common/container_tuple.h"
@@ -115,16 +117,24 @@ bool HybridScanExecutor::DInit() {
       current_tile_group_offset_ = START_OID;
     } else {
       current_tile_group_offset_ = indexed_tile_offset_ + 1;
+      oid_t offset = std::min(current_tile_group_offset_,
+                              table_tile_group_count_ - 1);
+
+      // Skip tile groups dropped by compaction
       std::shared_ptr<storage::TileGroup> tile_group;
-      if (current_tile_group_offset_ < table_tile_group_count_) {
-        tile_group = table_->GetTileGroup(current_tile_group_offset_);
-      } else {
-        tile_group = table_->GetTileGroup(table_tile_group_count_ - 1);
+      while (offset < table_tile_group_count_ && tile_group == nullptr) {
+        tile_group = table_->GetTileGroup(offset++);
       }
 
-      oid_t tuple_id = 0;
-      ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-      block_threshold = location.block;
+      if (tile_group != nullptr) {
+        oid_t tuple_id = 0;
+        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+        block_threshold = location.block;
+      } else {
+        // No tile group is left past the indexed ones, scan all of them and
+        // skip the tuples the index already found
+        current_tile_group_offset_ = START_OID;
+      }
     }
 
     result_itr_ = START_OID;
@@ -189,6 +199,10 @@ bool HybridScanExecutor::SeqScanUtil() {
   while (current_tile_group_offset_ < table_tile_group_count_) {
     LOG_TRACE("Current tile group offset : %u", current_tile_group_offset_);
     auto tile_group = table_->GetTileGroup(current_tile_group_offset_++);
+    // Skip tile groups dropped by compaction
+    if (tile_group == nullptr) {
+      continue;
+    }
     auto tile_group_header = tile_group->GetHeader();
 
     oid_t active_tuple_count = tile_group->GetNextTupleSlot();
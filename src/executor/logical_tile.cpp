@@ -15,6 +15,7 @@
 
 #include "catalog/schema.h"
 #include "common/macros.h"
+#include "network/postgres_value_format.h"
 #include "storage/data_table.h"
 #include "storage/layout.h"
 #include "storage/tile.h"
@@ -450,37 +451,14 @@ std::vector<std::vector<std::string>> LogicalTile::GetAllValuesAsStrings(
         val = cp.base_tile->GetValue(base_tuple_id, cp.origin_column_id);
       }
 
-      // LM: I put varchar here because we don't need to do endian conversion
-      // for them, and assuming binary and text for a varchar are the same.
-      if (result_format[column_itr] == 0 ||
-          cp.base_tile->GetSchema()->GetType(cp.origin_column_id) ==
-              type::TypeId::VARCHAR) {
-        // don't let to_string function decide what NULL value is
-        if (use_to_string_null == false && val.IsNull() == true) {
-          // materialize Null values as 0B string
-          row.push_back(empty_string);
-        } else {
-          // otherwise, materialize using ToString
-          row.push_back(val.ToString());
-        }
+      if (val.IsNull() == true) {
+        // don't let to_string function decide what NULL value is, unless
+        // asked to. Otherwise materialize Null values as 0B string
+        row.push_back(use_to_string_null ? val.ToString() : empty_string);
       } else {
-        auto data_length =
-            cp.base_tile->GetSchema()->GetLength(cp.origin_column_id);
-        LOG_TRACE("data length: %ld", data_length);
-        char *val_binary = new char[data_length];
-        bool is_inlined = false;
-
-        val.SerializeTo(val_binary, is_inlined, nullptr);
-
-        // convert little endian to big endian...
-        // TODO: This is stupid.... But I think this hack is fine for now.
-        for (size_t i = 0; i < (data_length >> 1); ++i) {
-          auto tmp_char = val_binary[i];
-          val_binary[i] = val_binary[data_length - i - 1];
-          val_binary[data_length - i - 1] = tmp_char;
-        }
-
-        row.push_back(std::string(val_binary, data_length));
+        // materialize in the format requested for the column
+        row.push_back(network::PostgresValueFormat::EncodeValue(
+            val, result_format[column_itr]));
       }
     }
     string_tile.push_back(row);
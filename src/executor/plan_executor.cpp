@@ -12,7 +12,7 @@
 
 #include "executor/plan_executor.h"
 
-#include "codegen/buffering_consumer.h"
+#include "codegen/streaming_consumer.h"
 #include "codegen/query.h"
 #include "codegen/query_cache.h"
 #include "codegen/query_compiler.h"
@@ -20,6 +20,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
 #include "executor/executors.h"
+#include "network/postgres_value_format.h"
 #include "settings/settings_manager.h"
 #include "storage/tuple_iterator.h"
 
@@ -36,22 +37,36 @@ static void CompileAndExecutePlan(
     std::shared_ptr<planner::AbstractPlan> plan,
     concurrency::TransactionContext *txn,
     const std::vector<type::Value> &params,
+    const std::vector<int> &result_format,
+    std::function<bool(ResultBatch &&)> on_result_batch,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    util::Pipe *copy_input) {
   LOG_TRACE("Compiling and executing query ...");
 
   // Perform binding
   planner::BindingContext context;
   plan->PerformBinding(context);
 
-  // Prepare output buffer
+  // Without a batch callback, the batches add up to the whole result
+  std::vector<ResultValue> values;
+  if (!on_result_batch) {
+    on_result_batch = [&values](ResultBatch &&batch) {
+      batch.GetValues(values);
+      return true;
+    };
+  }
+
+  // Prepare output stream
   std::vector<oid_t> columns;
   plan->GetOutputColumns(columns);
-  codegen::BufferingConsumer consumer{columns, context};
+  codegen::StreamingConsumer consumer{columns, context, result_format,
+                                      on_result_batch};
 
   // The executor context for this execution
   executor::ExecutorContext executor_context{
       txn, codegen::QueryParameters(*plan, params)};
+  executor_context.SetCopyInput(copy_input);
 
   // Check if we have a cached compiled plan already
   codegen::Query *query = codegen::QueryCache::Instance().Find(plan);
@@ -59,7 +74,12 @@ static void CompileAndExecutePlan(
     codegen::QueryCompiler compiler;
     auto compiled_query = compiler.Compile(
         *plan, executor_context.GetParams().GetQueryParametersMap(), consumer);
-    compiled_query->Compile();
+    // With adaptive execution the query starts out interpreted and is
+    // compiled in the background on its first execution
+    if (!settings::SettingsManager::GetBool(
+            settings::SettingId::codegen_adaptive)) {
+      compiled_query->Compile();
+    }
 
     // Grab an instance to the plan
     query = compiled_query.get();
@@ -70,23 +90,13 @@ static void CompileAndExecutePlan(
 
   // Execute the query!
   query->Execute(executor_context, consumer);
+  consumer.FlushBatch();
 
   // Execution complete, setup the results
   executor::ExecutionResult result;
   result.m_processed = executor_context.num_processed;
   result.m_result = ResultType::SUCCESS;
 
-  // Iterate over results
-  std::vector<ResultValue> values;
-  for (const auto &tuple : consumer.GetOutputTuples()) {
-    for (uint32_t i = 0; i < tuple.tuple_.size(); i++) {
-      auto column_val = tuple.GetValue(i);
-      auto str = column_val.IsNull() ? "" : column_val.ToString();
-      LOG_TRACE("column content: [%s]", str.c_str());
-      values.push_back(std::move(str));
-    }
-  }
-
   // Done, invoke callback
   plan->ClearParameterValues();
   on_complete(result, std::move(values));
@@ -97,13 +107,17 @@ static void InterpretPlan(
     concurrency::TransactionContext *txn,
     const std::vector<type::Value> &params,
     const std::vector<int> &result_format,
+    std::function<bool(ResultBatch &&)> on_result_batch,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    util::Pipe *copy_input) {
   executor::ExecutionResult result;
   std::vector<ResultValue> values;
+  ResultBatch batch;
 
   std::unique_ptr<executor::ExecutorContext> executor_context(
       new executor::ExecutorContext(txn, params));
+  executor_context->SetCopyInput(copy_input);
 
   bool status;
   std::unique_ptr<executor::AbstractExecutor> executor_tree(
@@ -127,19 +141,31 @@ static void InterpretPlan(
     // Some executors don't return logical tiles (e.g., Update).
     if (tile.get() != nullptr) {
       LOG_TRACE("Final Answer: %s", tile->GetInfo().c_str());
-      std::vector<std::vector<std::string>> tuples;
-      tuples = tile->GetAllValuesAsStrings(result_format, false);
-
-      // Construct the returned results
-      for (auto &tuple : tuples) {
-        for (unsigned int i = 0; i < tile->GetColumnCount(); i++) {
-          LOG_TRACE("column content: %s",
-                    tuple[i].c_str() != nullptr ? tuple[i].c_str() : "-empty-");
-          values.push_back(std::move(tuple[i]));
+      // Encode the rows in the format requested for their columns
+      for (oid_t tuple_id : *tile) {
+        batch.BeginRow();
+        for (oid_t col_id = 0; col_id < tile->GetColumnCount(); col_id++) {
+          network::PostgresValueFormat::AppendColumn(
+              batch.GetBuffer(), tile->GetValue(tuple_id, col_id),
+              result_format[col_id]);
         }
       }
     }
+
+    // Hand the rows over once there are enough of them
+    if (on_result_batch && batch.NumRows() >= RESULT_BATCH_SIZE) {
+      bool more_rows = on_result_batch(std::move(batch));
+      batch.Clear();
+      // Nobody reads the rest of the rows
+      if (more_rows == false) break;
+    }
+  }
+  if (on_result_batch && !batch.IsEmpty()) {
+    on_result_batch(std::move(batch));
+    batch.Clear();
   }
+  // Without a batch callback, the rows go to on_complete
+  batch.GetValues(values);
 
   result.m_processed = executor_context->num_processed;
   result.m_result = ResultType::SUCCESS;
@@ -155,6 +181,18 @@ void PlanExecutor::ExecutePlan(
     const std::vector<int> &result_format,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
         on_complete) {
+  ExecutePlan(plan, txn, params, result_format, nullptr, on_complete);
+}
+
+void PlanExecutor::ExecutePlan(
+    std::shared_ptr<planner::AbstractPlan> plan,
+    concurrency::TransactionContext *txn,
+    const std::vector<type::Value> &params,
+    const std::vector<int> &result_format,
+    std::function<bool(ResultBatch &&)> on_result_batch,
+    std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
+        on_complete,
+    util::Pipe *copy_input) {
   PELOTON_ASSERT(plan != nullptr && txn != nullptr);
   LOG_TRACE("PlanExecutor Start (Txn ID=%" PRId64 ")", txn->GetTransactionId());
 
@@ -163,9 +201,11 @@ void PlanExecutor::ExecutePlan(
 
   try {
     if (codegen_enabled && codegen::QueryCompiler::IsSupported(*plan)) {
-      CompileAndExecutePlan(plan, txn, params, on_complete);
+      CompileAndExecutePlan(plan, txn, params, result_format, on_result_batch,
+                            on_complete, copy_input);
     } else {
-      InterpretPlan(plan, txn, params, result_format, on_complete);
+      InterpretPlan(plan, txn, params, result_format, on_result_batch,
+                    on_complete, copy_input);
     }
   } catch (Exception &e) {
     ExecutionResult result;
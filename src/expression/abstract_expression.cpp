@@ -158,8 +158,15 @@ hash_t AbstractExpression::HashForExactMatch() const {
 }
 
 bool AbstractExpression::IsZoneMappable() {
+  std::vector<storage::PredicateInfo> predicates;
   bool is_zone_mappable =
-      ExpressionUtil::GetPredicateForZoneMap(parsed_predicates, this);
+      ExpressionUtil::GetPredicateForZoneMap(predicates, this);
+
+  // Compiled scans read the parsed predicates every time they run, so they're
+  // only set the first time rather than on every compilation of the plan
+  if (is_zone_mappable && parsed_predicates.empty()) {
+    parsed_predicates = std::move(predicates);
+  }
   return is_zone_mappable;
 }
 
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 #include "gc/gc_manager.h"
 
+#include <mutex>
+
 #include "catalog/schema.h"
 #include "common/internal_types.h"
 #include "concurrency/transaction_context.h"
@@ -36,6 +38,17 @@ void GCManager::CheckAndReclaimVarlenColumns(storage::TileGroup *tile_group,
     storage::Tile *tile = tile_group->GetTile(tile_itr);
     PELOTON_ASSERT(tile);
     const catalog::Schema *schema = tile->GetSchema();
+    if (schema->IsInlined()) {
+      continue;
+    }
+
+    // A frozen tile keeps its own copy of the varlen values, and its pool is
+    // freed as a whole when its uncompressed tuples are released
+    std::lock_guard<std::mutex> lock(tile->freeze_mutex);
+    if (tile->IsFrozen()) {
+      continue;
+    }
+
     tile_col_count = schema->GetColumnCount();
     for (oid_t tile_col_itr = 0; tile_col_itr < tile_col_count;
          ++tile_col_itr) {
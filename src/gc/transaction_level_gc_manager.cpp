@@ -19,6 +19,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "index/index.h"
 #include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/database.h"
 #include "storage/storage_manager.h"
 #include "storage/tile_group.h"
@@ -64,8 +65,12 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
       continue;
     }
 
-    int reclaimed_count = Reclaim(thread_id, expired_eid);
-    int unlinked_count = Unlink(thread_id, expired_eid);
+    int reclaimed_count, unlinked_count;
+    {
+      std::lock_guard<std::mutex> lock(partition_latches_[thread_id]);
+      reclaimed_count = Reclaim(thread_id, expired_eid);
+      unlinked_count = Unlink(thread_id, expired_eid);
+    }
 
     if (is_running_ == false) {
       return;
@@ -95,16 +100,49 @@ void TransactionLevelGCManager::RecycleTransaction(
     txn->SetEpochId(epoch_manager.GetNextEpochId());
   }
 
+  // The context may be freed as soon as it is queued
+  size_t garbage_count = txn->GetGarbageVersionCount();
+  unsigned int thread_id = HashToThread(txn->GetThreadId());
+
   // Add the transaction context to the lock-free queue
-  unlink_queues_[HashToThread(txn->GetThreadId())]->Enqueue(txn);
+  unlink_queues_[thread_id]->Enqueue(txn);
+
+  // Transactions that had to skip a lot of old versions help collect them
+  if (garbage_count > 0) {
+    auto threshold = static_cast<size_t>(settings::SettingsManager::GetInt(
+        settings::SettingId::gc_cooperative_threshold));
+    if (threshold > 0 && garbage_count >= threshold) {
+      AssistCollection(thread_id);
+    }
+  }
+}
+
+void TransactionLevelGCManager::AssistCollection(const int thread_id) {
+  std::unique_lock<std::mutex> lock(partition_latches_[thread_id],
+                                    std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
+  }
+
+  // the epochs are left for the gc thread to move forward.
+  auto expired_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetLastExpiredEpochId();
+  if (expired_eid == INVALID_EID) {
+    return;
+  }
+
+  Reclaim(thread_id, expired_eid);
+  Unlink(thread_id, expired_eid, MAX_ASSIST_COUNT, true);
 }
 
 int TransactionLevelGCManager::Unlink(const int &thread_id,
-                                      const eid_t &expired_eid) {
+                                      const eid_t &expired_eid,
+                                      const size_t max_count,
+                                      const bool cooperative) {
   int tuple_counter = 0;
 
   // check if any garbage can be unlinked from indexes.
-  // every time we garbage collect at most MAX_ATTEMPT_COUNT tuples.
+  // every time we garbage collect at most max_count tuples.
   std::vector<concurrency::TransactionContext *> garbages;
 
   // First iterate the local unlink queue
@@ -122,7 +160,7 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
         return res;
       });
 
-  for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
+  for (size_t i = 0; i < max_count; ++i) {
     concurrency::TransactionContext *txn_ctx;
     // if there's no more tuples in the queue, then break.
     if (unlink_queues_[thread_id]->Dequeue(txn_ctx) == false) {
@@ -175,9 +213,21 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
   eid_t safe_expired_eid =
       concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
 
+  int64_t lag_epochs = 0;
   for (auto &item : garbages) {
+    // aborted transactions are stamped with the next epoch
+    if (item->GetEpochId() < safe_expired_eid) {
+      lag_epochs += safe_expired_eid - item->GetEpochId();
+    }
     reclaim_maps_[thread_id].insert(std::make_pair(safe_expired_eid, item));
   }
+
+  if (!garbages.empty() &&
+      static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->GetGCMetric().RecordUnlink(
+        garbages.size(), lag_epochs, cooperative);
+  }
   LOG_TRACE("Marked %d tuples as garbage", tuple_counter);
   return tuple_counter;
 }
@@ -300,6 +350,7 @@ ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
 }
 
 void TransactionLevelGCManager::ClearGarbage(int thread_id) {
+  std::lock_guard<std::mutex> lock(partition_latches_[thread_id]);
   while (!unlink_queues_[thread_id]->IsEmpty() ||
          !local_unlink_queues_[thread_id].empty()) {
     Unlink(thread_id, MAX_CID);
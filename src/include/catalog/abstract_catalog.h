@@ -100,6 +100,10 @@ class AbstractCatalog {
   std::atomic<oid_t> oid_ = ATOMIC_VAR_INIT(START_OID + OID_OFFSET);
 
   storage::DataTable *catalog_table_;
+
+  // Whether the catalog cache holds entries of this catalog, so that writing
+  // it keeps the transaction from sharing its cached entries
+  bool is_cached_ = false;
 };
 
 }  // namespace catalog
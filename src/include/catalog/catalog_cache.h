@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
@@ -19,6 +21,10 @@
 
 namespace peloton {
 
+namespace concurrency {
+class TransactionContext;
+}  // namespace concurrency
+
 namespace planner {
 class PlanUtil;
 }  // namespace planner
@@ -29,6 +35,11 @@ class DatabaseCatalogEntry;
 class TableCatalogEntry;
 class IndexCatalogEntry;
 
+/**
+ * The catalog entries a transaction has looked up. On a miss the cache first
+ * copies the entry from the SharedCatalogCache, if the transaction began at
+ * the version of the shared cache and has not changed the catalog itself.
+ */
 class CatalogCache {
   friend class Transaction;
   friend class DatabaseCatalog;
@@ -38,11 +49,33 @@ class CatalogCache {
   friend class TableCatalogEntry;
   friend class IndexCatalogEntry;
   friend class planner::PlanUtil;
+  friend class SharedCatalogCache;
 
  public:
   CatalogCache() {}
   DISALLOW_COPY(CatalogCache)
 
+  /**
+   * Let the cache of the transaction take entries from, and give entries to,
+   * the shared cache at the given catalog version
+   */
+  void EnableSharing(concurrency::TransactionContext *txn, uint64_t version) {
+    txn_ = txn;
+    version_ = version;
+  }
+
+  /**
+   * Record that the transaction wrote the system catalogs, so its entries
+   * may differ from what other transactions see
+   */
+  void SetModified() { modified_ = true; }
+
+  bool IsModified() const { return modified_; }
+
+  bool IsShareable() const {
+    return txn_ != nullptr && (version_ & 1) == 0 && !modified_;
+  }
+
  private:
   std::shared_ptr<DatabaseCatalogEntry> GetDatabaseObject(oid_t database_oid);
   std::shared_ptr<DatabaseCatalogEntry> GetDatabaseObject(
@@ -67,6 +100,83 @@ class CatalogCache {
       database_objects_cache_;
   std::unordered_map<std::string, std::shared_ptr<DatabaseCatalogEntry>>
       database_name_cache_;
+
+  // copy an entry of the shared cache into this cache
+  std::shared_ptr<DatabaseCatalogEntry> InsertSharedDatabaseObject(
+      std::shared_ptr<DatabaseCatalogEntry> shared_object);
+
+  // the transaction owning the cache, if it may use the shared cache
+  concurrency::TransactionContext *txn_ = nullptr;
+  // the version of the shared cache the transaction began at
+  uint64_t version_ = 1;
+  // whether the transaction wrote the system catalogs
+  bool modified_ = false;
+};
+
+/**
+ * The catalog entries every transaction may use, as of one version of the
+ * catalog.
+ *
+ * The version changes when a transaction that wrote the system catalogs
+ * begins and ends its commit, and is odd while any such commit is in
+ * progress. Each change drops all the shared entries. A transaction that
+ * began at the current version publishes the entries it looked up when it
+ * commits, so the next transactions find them without scanning pg_database
+ * and pg_table. The entries are never changed once published; a publish
+ * swaps in a new snapshot, so lookups never wait for a writer.
+ */
+class SharedCatalogCache {
+ public:
+  // Global Singleton
+  static SharedCatalogCache &GetInstance();
+
+  uint64_t GetVersion() const { return version_.load(); }
+
+  /**
+   * Called before and after the changes of a transaction that wrote the
+   * system catalogs become visible
+   */
+  void BeginInvalidation();
+  void EndInvalidation();
+
+  std::shared_ptr<DatabaseCatalogEntry> GetDatabaseObject(uint64_t version,
+                                                          oid_t database_oid);
+  std::shared_ptr<DatabaseCatalogEntry> GetDatabaseObject(
+      uint64_t version, const std::string &database_name);
+
+  /**
+   * Share the entries in the cache of a committed transaction that are not
+   * shared yet
+   */
+  void Publish(const CatalogCache &cache);
+
+ private:
+  SharedCatalogCache() {}
+
+  struct Snapshot {
+    uint64_t version;
+    std::unordered_map<oid_t, std::shared_ptr<DatabaseCatalogEntry>>
+        database_objects;
+    std::unordered_map<std::string, std::shared_ptr<DatabaseCatalogEntry>>
+        database_names;
+  };
+
+  // update version_ and drop the shared entries, with the lock held
+  void Invalidate();
+
+  // whether the cache has entries the snapshot lacks
+  static bool HasEntriesToShare(
+      const CatalogCache &cache,
+      const std::shared_ptr<const Snapshot> &snapshot);
+
+  std::mutex mutex_;
+  // the number of version changes, and of commits in progress
+  uint64_t num_changes_ = 0;
+  uint32_t num_invalidating_ = 0;
+  // num_changes_ * 2, plus 1 while a commit is in progress
+  std::atomic<uint64_t> version_{0};
+  // only accessed with std::atomic_load and std::atomic_store
+  std::shared_ptr<const Snapshot> snapshot_;
 };
 
 }  // namespace catalog
@@ -40,11 +40,16 @@ class DatabaseCatalogEntry {
   friend class DatabaseCatalog;
   friend class TableCatalog;
   friend class CatalogCache;
+  friend class SharedCatalogCache;
 
  public:
   DatabaseCatalogEntry(concurrency::TransactionContext *txn,
                        executor::LogicalTile *tile);
 
+  // The entry of a transaction for an entry of the shared catalog cache
+  DatabaseCatalogEntry(concurrency::TransactionContext *txn,
+                       std::shared_ptr<DatabaseCatalogEntry> shared_entry);
+
   void EvictAllTableCatalogEntries();
 
   std::shared_ptr<TableCatalogEntry> GetTableCatalogEntry(oid_t table_oid,
@@ -88,6 +93,23 @@ class DatabaseCatalogEntry {
   std::shared_ptr<IndexCatalogEntry> GetCachedIndexCatalogEntry(
       const std::string &index_name, const std::string &schema_name);
 
+  // Whether table catalog entries can be taken from shared_entry_
+  bool UseSharedEntry();
+
+  // Copy a table catalog entry of the shared cache into this entry
+  std::shared_ptr<TableCatalogEntry> InsertSharedTableCatalogEntry(
+      const std::shared_ptr<TableCatalogEntry> &shared_table_entry);
+
+  // Whether this entry has table catalog entries that shared_entry lacks,
+  // or has fewer entries of
+  bool HasEntriesToShare(
+      const std::shared_ptr<DatabaseCatalogEntry> &shared_entry);
+
+  // A copy of this entry and shared_entry, with the table catalog entries of
+  // both, for the shared cache; null if this entry has nothing new
+  std::shared_ptr<DatabaseCatalogEntry> MergeForSharing(
+      const std::shared_ptr<DatabaseCatalogEntry> &shared_entry);
+
   // cache for table name to oid translation
   std::unordered_map<oid_t, std::shared_ptr<TableCatalogEntry>>
       table_catalog_entries_cache_;
@@ -98,6 +120,9 @@ class DatabaseCatalogEntry {
   // Pointer to its corresponding transaction
   // This object is only visible during this transaction
   concurrency::TransactionContext *txn_;
+
+  // The entry of the shared catalog cache this entry was copied from
+  std::shared_ptr<DatabaseCatalogEntry> shared_entry_;
 };
 
 class DatabaseCatalog : public AbstractCatalog {
@@ -48,6 +48,7 @@ class ColumnCatalogEntry;
 class ConstraintCatalogEntry;
 
 class TableCatalogEntry {
+  friend class DatabaseCatalogEntry;
   friend class TableCatalog;
   friend class IndexCatalog;
   friend class ColumnCatalog;
@@ -146,6 +147,9 @@ class TableCatalogEntry {
     valid_constraint_catalog_entries_ = valid;
   }
 
+  // The number of entries cached in this table catalog entry
+  size_t GetCachedEntryCount() const;
+
   // cache for *all* index catalog entries in this table
   std::unordered_map<oid_t, std::shared_ptr<IndexCatalogEntry>> index_catalog_entries;
   std::unordered_map<std::string, std::shared_ptr<IndexCatalogEntry>>
@@ -78,6 +78,17 @@ class Aggregation {
   void AdvanceValues(CodeGen &codegen, llvm::Value *space,
                      const std::vector<codegen::Value> &next) const;
 
+  // Copy the partial aggregates stored in the provided partial space as the
+  // initial values of the aggregates stored in the provided storage space
+  void CopyPartialValues(CodeGen &codegen, llvm::Value *space,
+                         llvm::Value *partial_space) const;
+
+  // Merge the partial aggregates stored in the provided partial space into the
+  // aggregates stored in the provided storage space. This is used to combine
+  // the results of thread-local aggregations.
+  void MergePartialValues(CodeGen &codegen, llvm::Value *space,
+                          llvm::Value *partial_space) const;
+
   // Compute the final values of all the aggregates stored in the provided
   // storage space, inserting them into the provided output vector.
   void FinalizeValues(CodeGen &codegen, llvm::Value *space,
@@ -92,6 +103,12 @@ class Aggregation {
   // Get the storage format of the aggregates this class is configured to handle
   const UpdateableStorage &GetAggregateStorage() const { return storage_; }
 
+  // Can the provided aggregates be computed as partial aggregates that are
+  // merged afterwards? This isn't possible for DISTINCT aggregates since their
+  // partial results don't track which values they have already seen.
+  static bool SupportsPartialAggregation(
+      const std::vector<planner::AggregatePlan::AggTerm> &agg_terms);
+
  private:
   bool IsGlobal() const { return is_global_; }
 
@@ -157,6 +174,14 @@ class Aggregation {
                     const Aggregation::AggregateInfo &agg,
                     UpdateableStorage::NullBitmap &null_bitmap) const;
 
+  // Merge a partial aggregate component into the aggregate component stored at
+  // the given index, using the given aggregate type to combine them.
+  void MergePartialValue(
+      CodeGen &codegen, llvm::Value *space, ExpressionType type,
+      uint32_t storage_index, llvm::Value *partial_space,
+      UpdateableStorage::NullBitmap &null_bitmap,
+      UpdateableStorage::NullBitmap &partial_null_bitmap) const;
+
  private:
   // Is this a global aggregation?
   bool is_global_;
@@ -32,6 +32,10 @@ class BloomFilterAccessor {
   // Codegen the bloom filter destroy
   void Destroy(CodeGen &codegen, llvm::Value *bloom_filter) const;
 
+  // Codegen the merge of another bloom filter into the given one
+  void Merge(CodeGen &codegen, llvm::Value *bloom_filter,
+             llvm::Value *other_bloom_filter) const;
+
   // Codegen the bloom filter insert
   void Add(CodeGen &codegen, llvm::Value *bloom_filter,
            const std::vector<codegen::Value> &key) const;
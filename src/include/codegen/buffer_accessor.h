@@ -42,6 +42,8 @@ class BufferAccessor {
 
   uint32_t GetTupleSize() const { return storage_format_.GetStorageSize(); }
 
+  const UpdateableStorage &GetStorageFormat() const { return storage_format_; }
+
   struct IterateCallback {
     virtual void ProcessEntry(
         CodeGen &codegen, const std::vector<codegen::Value> &vals) const = 0;
@@ -78,19 +78,26 @@ class BufferingConsumer : public ExecutionConsumer {
 
   const std::vector<WrappedTuple> &GetOutputTuples() const;
 
- private:
+ protected:
+  // Write the output attributes of the row into an on-stack array of values,
+  // returning a pointer to the array
+  llvm::Value *MaterializeTuple(ConsumerContext &ctx,
+                                RowBatch::Row &row) const;
+
   // The attributes we want to output
   std::vector<const planner::AttributeInfo *> output_ais_;
 
+  // The slot in the runtime state to find our state context
+  QueryState::Id consumer_state_id_;
+
+ private:
+
   // The thread-safe buffer of output tuples
   struct Buffer {
     std::mutex mutex;
     std::vector<WrappedTuple> output;
   };
   Buffer buffer_;
-
-  // The slot in the runtime state to find our state context
-  QueryState::Id consumer_state_id_;
 };
 
 }  // namespace codegen
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <unordered_map>
 
@@ -33,6 +34,7 @@ namespace peloton {
 namespace codegen {
 
 class FunctionBuilder;
+class ObjectCache;
 
 namespace interpreter {
 class BytecodeBuilder;
@@ -52,6 +54,14 @@ class CodeContext {
  public:
   using FuncPtr = void *;
 
+  /// Statistics on the IR contained in a context
+  struct IRStats {
+    uint64_t num_functions = 0;
+    uint64_t num_external_functions = 0;
+    uint64_t num_basic_blocks = 0;
+    uint64_t num_instructions = 0;
+  };
+
   CodeContext();
   ~CodeContext();
 
@@ -82,9 +92,31 @@ class CodeContext {
   /// Optimize all the code contained in this context
   void Optimize();
 
+  /// Cache the compiled code of this context in the given directory, so that
+  /// it can be loaded instead of compiled by later contexts with the same
+  /// code, also after a restart. Must be called before the code is optimized.
+  /// Returns true if the compiled code is already in the cache, in which case
+  /// the code need not be optimized.
+  bool EnableObjectCache(const std::string &directory);
+
+  /// Keep an unoptimized copy of the code in this context, so that it can be
+  /// compiled again with all optimizations by Recompile(). The code itself
+  /// is then compiled quickly, without optimizations in the code generator.
+  /// Must be called before the code is optimized.
+  void EnableRecompilation();
+
   /// Compile all the code contained in this context
   void Compile();
 
+  /// Optimize and compile the copy of the code kept by EnableRecompilation()
+  /// and switch the function pointers of this context to the new code, all at
+  /// once for concurrent lookups. The previously compiled code remains valid
+  /// as long as this context lives.
+  void Recompile();
+
+  /// Collect statistics on the IR contained in this context
+  IRStats GetIRStats() const;
+
   /// Retrieve the raw function pointer to the provided compiled LLVM function
   FuncPtr GetRawFunctionPointer(llvm::Function *fn) const;
 
@@ -162,10 +194,19 @@ class CodeContext {
   // The optimization pass manager
   std::unique_ptr<llvm::legacy::FunctionPassManager> pass_manager_;
 
+  // The persistent cache of the compiled code, if enabled. The engine refers
+  // to it, so it must outlive the engine.
+  std::unique_ptr<ObjectCache> object_cache_;
+
   // The JIT compilation engine
   std::string err_str_;
   std::unique_ptr<llvm::ExecutionEngine> engine_;
 
+  // The copy of the code to compile again with all optimizations, and the JIT
+  // compilation engine that compiled it
+  std::unique_ptr<llvm::Module> recompile_module_;
+  std::unique_ptr<llvm::ExecutionEngine> recompile_engine_;
+
   // Handy types we reuse often enough to cache here
   llvm::Type *bool_type_;
   llvm::Type *int8_type_;
@@ -187,6 +228,11 @@ class CodeContext {
   // function pointers are populated in Compile()
   std::vector<std::pair<llvm::Function *, FuncPtr>> functions_;
 
+  // The implementations of functions_ in the code compiled by Recompile(), in
+  // the same order. They are never changed once is_recompiled_ is set.
+  std::vector<FuncPtr> recompiled_functions_;
+  std::atomic<bool> is_recompiled_{false};
+
   // Shows if the Verify() has been run
   bool is_verified_;
 };
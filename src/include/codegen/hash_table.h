@@ -216,6 +216,21 @@ class HashTable {
   void MergeLazyUnfinished(CodeGen &codegen, llvm::Value *global_ht,
                            llvm::Value *local_ht) const;
 
+  void PartitionLazy(CodeGen &codegen, llvm::Value *ht_ptr,
+                     uint32_t num_partition_bits) const;
+
+  void PartitionLazyParallel(CodeGen &codegen, llvm::Value *ht_ptr,
+                             llvm::Value *thread_states,
+                             uint32_t ht_state_offset,
+                             uint32_t num_partition_bits) const;
+
+  void BuildPartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                      llvm::Value *partition) const;
+
+  void IteratePartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                        llvm::Value *partition,
+                        IterateCallback &callback) const;
+
   virtual void Iterate(CodeGen &codegen, llvm::Value *ht_ptr,
                        IterateCallback &callback) const;
 
@@ -154,6 +154,27 @@ class BytecodeFunction {
    */
   static const char *GetOpcodeString(Opcode opcode);
 
+  /**
+   * The maximum number of arguments of a function that can be called natively
+   * from the interpreter (see IsNativeCallable())
+   */
+  static constexpr size_t kMaxNativeCallArguments = 6;
+
+  /**
+   * Returns the name of the LLVM function this bytecode was created from
+   * @return the function name
+   */
+  const std::string &GetFunctionName() const { return function_name_; }
+
+  /**
+   * Returns true if the interpreter can swap this function for its native
+   * implementation when calling it. This is the case for functions that
+   * return nothing and take at most kMaxNativeCallArguments arguments, all of
+   * which are pointers or 64 bit integers.
+   * @return true if the function can be called natively
+   */
+  bool IsNativeCallable() const { return native_callable_; }
+
   /**
    * Returns the overall number of existing Opcodes (not trivial, as the Opcodes
    * are created with expanding macros)
@@ -301,6 +322,11 @@ class BytecodeFunction {
    */
   size_t number_function_arguments_;
 
+  /**
+   * Whether the function can be replaced by its native implementation
+   */
+  bool native_callable_ = false;
+
   /**
    * Constants needed during runtime.
    */
@@ -43,7 +43,7 @@
 #include "storage/data_table.h"
 #include "storage/storage_manager.h"
 #include "storage/tile_group.h"
-#include "storage/zone_map_manager.h"
+#include "storage/zone_map.h"
 #include "codegen/util/buffer.h"
 
 namespace peloton {
@@ -109,6 +109,25 @@ static ALWAYS_INLINE inline constexpr type_t ConvertPointerToReference(
   return source;
 };
 
+/**
+ * Provides native implementations of functions while they are interpreted.
+ * Before interpreting a call to a function that can be called natively (see
+ * BytecodeFunction::IsNativeCallable()), the interpreter asks the resolver for
+ * an implementation and, if there is one, calls it instead. This allows
+ * execution to leave the interpreter as soon as compiled code is available.
+ */
+class NativeFunctionResolver {
+ public:
+  virtual ~NativeFunctionResolver() = default;
+
+  /**
+   * Returns the native implementation of the given function, or nullptr if
+   * the function has to be interpreted.
+   * @param function_name name of the function that is about to be called
+   */
+  virtual void *GetNativeFunction(const std::string &function_name) const = 0;
+};
+
 class BytecodeInterpreter {
  public:
   /**
@@ -117,22 +136,39 @@ class BytecodeInterpreter {
    * @param arguments vector of function arguments (stored as value_t). The
    * number of arguments must match the number expected by the executed
    * function.
+   * @param native_resolver optional source of native implementations for the
+   * functions called by the executed function
    * @return return Value of the LLVM function or undefined if void.
    */
-  static value_t ExecuteFunction(const BytecodeFunction &bytecode_function,
-                                 const std::vector<value_t> &arguments);
+  static value_t ExecuteFunction(
+      const BytecodeFunction &bytecode_function,
+      const std::vector<value_t> &arguments,
+      const NativeFunctionResolver *native_resolver = nullptr);
   /**
    * Executes a translated function with the interpreter
    * (Wrapper for usage with a single char* argument)
    * @param bytecode_function  bytecode function that shall be executed, must
    * expect one argument.
    * @param arguments Char pointer argument of the function.
+   * @param native_resolver optional source of native implementations for the
+   * functions called by the executed function
    */
-  static void ExecuteFunction(const BytecodeFunction &bytecode_function,
-                              char *param);
+  static void ExecuteFunction(
+      const BytecodeFunction &bytecode_function, char *param,
+      const NativeFunctionResolver *native_resolver = nullptr);
 
  private:
-  explicit BytecodeInterpreter(const BytecodeFunction &bytecode_function);
+  BytecodeInterpreter(const BytecodeFunction &bytecode_function,
+                      const NativeFunctionResolver *native_resolver);
+
+  /**
+   * Calls the native implementation of a function that returns nothing and
+   * takes only 64 bit arguments.
+   * @param function pointer to the native function
+   * @param arguments the function arguments
+   */
+  static void CallNativeFunction(void *function,
+                                 const std::vector<value_t> &arguments);
 
   /**
    * Executes a function with the given arguments. The return value can
@@ -905,10 +941,23 @@ class BytecodeInterpreter {
       arguments[i] = GetValue<value_t>(call_instruction->args[i]);
     }
 
-    value_t result = ExecuteFunction(
-        bytecode_function_.sub_functions_[call_instruction->sub_function],
-        arguments);
-    SetValue(call_instruction->dest_slot, result);
+    const auto &sub_function =
+        bytecode_function_.sub_functions_[call_instruction->sub_function];
+
+    // Leave the interpreter if the function is available as native code
+    void *native_function = nullptr;
+    if (native_resolver_ != nullptr && sub_function.IsNativeCallable()) {
+      native_function =
+          native_resolver_->GetNativeFunction(sub_function.GetFunctionName());
+    }
+
+    if (native_function != nullptr) {
+      CallNativeFunction(native_function, arguments);
+    } else {
+      value_t result =
+          ExecuteFunction(sub_function, arguments, native_resolver_);
+      SetValue(call_instruction->dest_slot, result);
+    }
 
     return AdvanceIP(
         instruction,
@@ -1250,6 +1299,11 @@ class BytecodeInterpreter {
    */
   const BytecodeFunction &bytecode_function_;
 
+  /**
+   * Source of native implementations for called functions (may be null).
+   */
+  const NativeFunctionResolver *native_resolver_;
+
  private:
   // This class cannot be copy or move-constructed
   DISALLOW_COPY_AND_MOVE(BytecodeInterpreter);
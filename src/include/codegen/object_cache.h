@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache.h
+//
+// Identification: src/include/codegen/object_cache.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "llvm/ExecutionEngine/ObjectCache.h"
+
+namespace llvm {
+class Module;
+}  // namespace llvm
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// An on-disk cache of the machine code compiled for query modules. Compiled
+// objects survive restarts, so a query whose code was compiled once (by any
+// process sharing the cache directory) is only loaded, not optimized and
+// compiled again.
+//
+// Objects are keyed by a fingerprint of the module's unoptimized IR, the LLVM
+// version and the host CPU. Changes to the plan or to the schemas it touches
+// that affect the generated code therefore lead to a different key, while
+// stale entries are simply never looked up again.
+//
+// Only modules that don't embed addresses of objects in the current process
+// can be cached. External functions are resolved by name when the object is
+// loaded, so calls into the engine are fine.
+//===----------------------------------------------------------------------===//
+class ObjectCache : public llvm::ObjectCache {
+ public:
+  /// Constructor
+  explicit ObjectCache(std::string directory);
+
+  /// Can the compiled code of the given module be cached?
+  static bool IsCacheable(const llvm::Module &module);
+
+  /// Compute the key the compiled code of the given module is cached under
+  static std::string ComputeKey(const llvm::Module &module);
+
+  /// Is there compiled code for the given key in the cache?
+  bool Contains(const std::string &key) const;
+
+  /// Called by the JIT after compiling a module. Stores the compiled object.
+  void notifyObjectCompiled(const llvm::Module *module,
+                            llvm::MemoryBufferRef object) override;
+
+  /// Called by the JIT before compiling a module. Returns the compiled object
+  /// if the cache has one, or nullptr if the module has to be compiled.
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module *module) override;
+
+ private:
+  // Get the path of the file storing the object with the given key
+  std::string GetPath(const std::string &key) const;
+
+ private:
+  // The directory the cached objects are stored in
+  std::string directory_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
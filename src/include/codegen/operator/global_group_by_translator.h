@@ -47,6 +47,11 @@ class GlobalGroupByTranslator : public OperatorTranslator {
   // Consume!
   void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
 
+  // Thread-local aggregates for parallel aggregations
+  void RegisterPipelineState(PipelineContext &pipeline_ctx) override;
+  void InitializePipelineState(PipelineContext &pipeline_ctx) override;
+  void FinishPipeline(PipelineContext &pipeline_ctx) override;
+
   // No state to tear down
   void TearDownQueryState() override;
 
@@ -80,8 +85,15 @@ class GlobalGroupByTranslator : public OperatorTranslator {
   // The class responsible for handling the aggregation for all our aggregates
   Aggregation aggregation_;
 
+  // The type of the materialization buffer
+  llvm::Type *mat_buffer_type_;
+
   // The ID of our materialization buffer in the runtime state
   QueryState::Id mat_buffer_id_;
+
+  // The ID of the thread-local materialization buffer for parallel
+  // aggregations
+  PipelineContext::Id mat_buffer_tl_id_;
 };
 
 }  // namespace codegen
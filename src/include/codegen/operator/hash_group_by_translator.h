@@ -33,6 +33,10 @@ class HashGroupByTranslator : public OperatorTranslator {
   // Global/configurable variable controlling whether hash aggregations prefetch
   static std::atomic<bool> kUsePrefetch;
 
+  // The number of partitions the results of a parallel aggregation are merged
+  // into. This must be a power of two.
+  static const uint32_t kNumMergePartitions;
+
   // Constructor
   HashGroupByTranslator(const planner::AggregatePlan &group_by,
                         CompilationContext &context, Pipeline &pipeline);
@@ -50,6 +54,12 @@ class HashGroupByTranslator : public OperatorTranslator {
   void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
   void Consume(ConsumerContext &context, RowBatch &batch) const override;
 
+  // Thread-local hash tables for parallel aggregations
+  void RegisterPipelineState(PipelineContext &pipeline_ctx) override;
+  void InitializePipelineState(PipelineContext &pipeline_ctx) override;
+  void FinishPipeline(PipelineContext &pipeline_ctx) override;
+  void TearDownPipelineState(PipelineContext &pipeline_ctx) override;
+
   // Codegen any cleanup work for this translator
   void TearDownQueryState() override;
 
@@ -166,9 +176,96 @@ class HashGroupByTranslator : public OperatorTranslator {
     uint32_t agg_index_;
   };
 
+  //===--------------------------------------------------------------------===//
+  // The callback used when merging the partial aggregates of a thread-local
+  // hash table into a partition whose hash table already has the group.
+  //===--------------------------------------------------------------------===//
+  class MergeProbe : public HashTable::ProbeCallback {
+   public:
+    // Constructor
+    MergeProbe(const Aggregation &aggregation, llvm::Value *partial_aggs);
+
+    // The callback
+    void ProcessEntry(CodeGen &codegen, llvm::Value *data_area) const override;
+
+   private:
+    // The guy that handles the computation of the aggregates
+    const Aggregation &aggregation_;
+    // The partial aggregates of the thread-local hash table
+    llvm::Value *partial_aggs_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when merging the partial aggregates of a thread-local
+  // hash table into a partition that doesn't have the group yet.
+  //===--------------------------------------------------------------------===//
+  class MergeInsert : public HashTable::InsertCallback {
+   public:
+    // Constructor
+    MergeInsert(const Aggregation &aggregation, llvm::Value *partial_aggs);
+
+    // Copy the partial aggregates into the provided storage
+    void StoreValue(CodeGen &codegen, llvm::Value *data_space) const override;
+
+    llvm::Value *GetValueSize(CodeGen &codegen) const override;
+
+   private:
+    // The guy that handles the computation of the aggregates
+    const Aggregation &aggregation_;
+    // The partial aggregates of the thread-local hash table
+    llvm::Value *partial_aggs_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when iterating a thread-local hash table of a partition
+  // to merge its groups into the hash table of the partition.
+  //===--------------------------------------------------------------------===//
+  class MergePartition : public HashTable::IterateCallback {
+   public:
+    // Constructor
+    MergePartition(const HashGroupByTranslator &translator,
+                   llvm::Value *partition_ht_ptr);
+
+    // The callback
+    void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                      llvm::Value *data_area) const override;
+
+   private:
+    // The translator
+    const HashGroupByTranslator &translator_;
+    // The hash table of the partition being merged
+    llvm::Value *partition_ht_ptr_;
+  };
+
   void CollectHashKeys(RowBatch::Row &row,
                        std::vector<codegen::Value> &key) const;
 
+  // Is the input to this aggregation consumed in parallel?
+  bool IsParallel() const { return child_pipeline_.IsParallel(); }
+
+  // Load a pointer to the hash table tuples from the context are aggregated
+  // in. For parallel aggregations, this is the thread-local hash table of the
+  // partition the hash value belongs to.
+  llvm::Value *LoadHashTablePtr(ConsumerContext &context,
+                                llvm::Value *hash) const;
+
+  // Compute the partition a hash value belongs to
+  llvm::Value *ComputePartitionId(llvm::Value *hash) const;
+
+  // Load a pointer to the hash table of the given partition, out of the array
+  // of hash tables at the given address
+  llvm::Value *LoadPartitionPtr(llvm::Value *partitions,
+                                llvm::Value *partition_id) const;
+
+  // Generate a loop over the hash tables of all the partitions in the array
+  // of hash tables at the given address
+  void IteratePartitions(
+      llvm::Value *partitions,
+      const std::function<void(llvm::Value *partition_ht_ptr)> &body) const;
+
+  // Merge all thread-local hash tables into the partitions in parallel
+  void MergePartitions(PipelineContext &pipeline_ctx) const;
+
   // Estimate the size of the constructed hash table
   uint64_t EstimateHashTableSize() const;
 
@@ -179,9 +276,15 @@ class HashGroupByTranslator : public OperatorTranslator {
   // The pipeline forming all child operators of this aggregation
   Pipeline child_pipeline_;
 
-  // The ID of the hash-table in the runtime state
+  // The ID of the hash-table in the runtime state. For parallel aggregations,
+  // this is an array of hash tables, one per partition.
   QueryState::Id hash_table_id_;
 
+  // The ID of the thread-local hash-tables for parallel aggregations. Every
+  // thread aggregates into one hash table per partition, so that a partition
+  // only merges the thread-local hash tables of its own groups.
+  PipelineContext::Id hash_table_tl_id_;
+
   // The hash table
   OAHashTable hash_table_;
 
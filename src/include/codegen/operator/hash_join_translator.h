@@ -28,7 +28,14 @@ class HashJoinPlan;
 namespace codegen {
 
 //===----------------------------------------------------------------------===//
-// The translator for a hash-join operator
+// The translator for a hash-join operator.
+//
+// By default, the left (build) side is materialized into a hash table which is
+// probed by the right side in a streaming fashion. If the plan requests radix
+// partitioning, both sides are instead materialized and partitioned on the
+// high bits of the hash of their keys, and then joined one partition at a time
+// so that the hash table of a partition stays in cache. The join is the source
+// of its parent pipeline in that case.
 //===----------------------------------------------------------------------===//
 class HashJoinTranslator : public OperatorTranslator {
  public:
@@ -64,6 +71,20 @@ class HashJoinTranslator : public OperatorTranslator {
     return pipeline == left_pipeline_;
   }
 
+  bool IsRightPipeline(const Pipeline &pipeline) const {
+    return right_pipeline_ != nullptr && pipeline == *right_pipeline_;
+  }
+
+  bool UseRadixPartitioning() const { return radix_partition_bits_ > 0; }
+
+  // Partition the tuples materialized by the given (finished) pipeline
+  void PartitionTable(PipelineContext &pipeline_ctx, const HashTable &table,
+                      QueryState::Id table_id,
+                      PipelineContext::Id table_tl_id) const;
+
+  // Join the partitions of both sides, sending the results to the context
+  void JoinPartitions(ConsumerContext &context) const;
+
   bool IsFromLeftChild(ConsumerContext &context) const {
     return IsLeftPipeline(context.GetPipeline());
   }
@@ -100,16 +121,26 @@ class HashJoinTranslator : public OperatorTranslator {
   /// Callback used when inserting a tuple in the hash table during build
   class InsertLeft;
 
+  /// Callback used to probe the build side with a partition of the right side
+  class ProbePartition;
+
  private:
   // The build-side pipeline
   Pipeline left_pipeline_;
 
+  // The probe-side pipeline, only when the inputs are radix partitioned
+  std::unique_ptr<Pipeline> right_pipeline_;
+
+  // The number of hash bits the inputs are partitioned on, or zero
+  uint32_t radix_partition_bits_;
+
   // The ID of the hash-table in the runtime state
   QueryState::Id hash_table_id_;
   PipelineContext::Id hash_table_tl_id_;
 
   // The ID of the bloom filter in the runtime state
   QueryState::Id bloom_filter_id_;
+  PipelineContext::Id bloom_filter_tl_id_;
 
   // The hash table we use to perform the join
   HashTable hash_table_;
@@ -127,6 +158,14 @@ class HashJoinTranslator : public OperatorTranslator {
   // The storage format used to store build-attributes in hash-table
   CompactStorage left_value_storage_;
 
+  // When partitioning, the materialized right side, the (unique) set of its
+  // attributes that are stored, and their storage format
+  QueryState::Id probe_table_id_;
+  PipelineContext::Id probe_table_tl_id_;
+  HashTable probe_table_;
+  std::vector<const planner::AttributeInfo *> right_val_ais_;
+  CompactStorage right_value_storage_;
+
   // Does this join need an output vector
   bool needs_output_vector_;
 };
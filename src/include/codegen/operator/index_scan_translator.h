@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_translator.h
+//
+// Identification: src/include/codegen/operator/index_scan_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/consumer_context.h"
+#include "codegen/operator/operator_translator.h"
+#include "codegen/query_state.h"
+#include "codegen/tile_group.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace planner {
+class IndexScanPlan;
+}  // namespace planner
+
+namespace codegen {
+
+class Vector;
+
+//===----------------------------------------------------------------------===//
+// A translator for index scans. The index is probed through a
+// util::IndexScanner that hands back the visible tuples in index order, in
+// runs of tuples from the same tile group. Each run is filtered and pushed
+// through the pipeline as a single batch.
+//===----------------------------------------------------------------------===//
+class IndexScanTranslator : public OperatorTranslator {
+ public:
+  // Constructor
+  IndexScanTranslator(const planner::IndexScanPlan &scan,
+                      CompilationContext &context, Pipeline &pipeline);
+
+  // Initialize the index scanner
+  void InitializeQueryState() override;
+
+  // Index scans don't rely on any auxiliary functions
+  void DefineAuxiliaryFunctions() override {}
+
+  // The method that produces new tuples
+  void Produce() const override;
+
+  // Scans are leaves in the query plan and, hence, do not consume tuples
+  void Consume(ConsumerContext &, RowBatch &) const override {}
+  void Consume(ConsumerContext &, RowBatch::Row &) const override {}
+
+  // Destroy the index scanner
+  void TearDownQueryState() override;
+
+  // Find the expression providing the value of each key condition of the given
+  // index scan. The key values must come from the scan's predicate for the
+  // compiled query to be reusable with different constants and parameters.
+  // Returns false if any key doesn't have a matching predicate conjunct.
+  static bool GetKeyValueExpressions(
+      const planner::IndexScanPlan &scan,
+      std::vector<const expression::AbstractExpression *> &key_values);
+
+ private:
+  // Filter the rows in the current batch by the scan predicate
+  void FilterRowsByPredicate(CodeGen &codegen,
+                             const TileGroup::TileGroupAccess &access,
+                             llvm::Value *tile_group_id,
+                             llvm::Value *num_tuples,
+                             Vector &selection_vector) const;
+
+  // Record reads for all the rows in the current batch
+  void PerformReads(CodeGen &codegen, llvm::Value *tile_group_ptr,
+                    Vector &selection_vector) const;
+
+  // Plan accessor
+  const planner::IndexScanPlan &GetScanPlan() const;
+
+ private:
+  // Helper class declarations (defined in implementation)
+  class AttributeAccess;
+
+ private:
+  // The code-generating tile group instance
+  TileGroup tile_group_;
+
+  // The maximum number of tuples produced in a single batch
+  uint32_t batch_size_;
+
+  // The scanner state ID
+  QueryState::Id scanner_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator.h
+//
+// Identification: src/include/codegen/operator/merge_join_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/buffer_accessor.h"
+#include "codegen/operator/operator_translator.h"
+
+namespace peloton {
+
+namespace planner {
+class MergeJoinPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for a merge join operator.
+//
+// Both inputs must arrive sorted (ascending) on their join keys. The left side
+// is buffered in its input order. Every tuple from the right side then first
+// advances a cursor into the buffer past all left tuples with smaller keys, and
+// joins with the run of left tuples with equal keys that starts there. Since
+// the right side is sorted, the cursor only ever moves forward.
+//===----------------------------------------------------------------------===//
+class MergeJoinTranslator : public OperatorTranslator {
+ public:
+  MergeJoinTranslator(const planner::MergeJoinPlan &join,
+                      CompilationContext &context, Pipeline &pipeline);
+
+  void InitializeQueryState() override;
+
+  void DefineAuxiliaryFunctions() override {}
+
+  void TearDownQueryState() override;
+
+  void Produce() const override;
+
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+ private:
+  bool IsFromLeftChild(const Pipeline &pipeline) const {
+    return pipeline == left_pipeline_;
+  }
+
+  void ConsumeFromLeft(ConsumerContext &context, RowBatch::Row &row) const;
+  void ConsumeFromRight(ConsumerContext &context, RowBatch::Row &row) const;
+
+  // Load the keys and values of the buffered left tuple at the given position
+  void LoadLeftTuple(CodeGen &codegen, llvm::Value *pos,
+                     std::vector<codegen::Value> &vals) const;
+
+  // Compare the keys of a left tuple with the keys of a right tuple, returning
+  // an integer whose sign is the order of the left keys relative to the right
+  llvm::Value *CompareKeys(CodeGen &codegen,
+                           const std::vector<codegen::Value> &left_vals,
+                           const std::vector<codegen::Value> &right_key) const;
+
+  // Put the given left tuple into the row, and send the row to the parent if
+  // it satisfies the join predicate
+  void JoinRow(CodeGen &codegen, ConsumerContext &context, RowBatch::Row &row,
+               const std::vector<codegen::Value> &left_vals) const;
+
+  const planner::MergeJoinPlan &GetJoinPlan() const;
+
+ private:
+  // The pipeline for the left subtree of the plan
+  Pipeline left_pipeline_;
+
+  // The left and right key expressions
+  std::vector<const expression::AbstractExpression *> left_key_exprs_;
+  std::vector<const expression::AbstractExpression *> right_key_exprs_;
+
+  // The (unique) set of non-key attributes from the left side that are buffered
+  std::vector<const planner::AttributeInfo *> left_val_ais_;
+
+  // The buffer of left tuples. Each one is stored as its keys followed by the
+  // values of the attributes above.
+  QueryState::Id buffer_id_;
+  BufferAccessor buffer_;
+
+  // The byte offset of the first left tuple the next right tuple can match
+  QueryState::Id cursor_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
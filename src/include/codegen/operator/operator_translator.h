@@ -89,6 +89,10 @@ class OperatorTranslator {
   virtual void Consume(ConsumerContext &context, RowBatch &batch) const;
   virtual void Consume(ConsumerContext &context, RowBatch::Row &row) const = 0;
 
+  /// Send along the rows held back until the input ran out. Only called for
+  /// operators that installed a flush into their pipeline.
+  virtual void Flush(ConsumerContext &) const {}
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// sort_group_by_translator.h
+//
+// Identification: src/include/codegen/operator/sort_group_by_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/aggregation.h"
+#include "codegen/operator/operator_translator.h"
+#include "codegen/pipeline.h"
+#include "codegen/updateable_storage.h"
+
+namespace peloton {
+
+namespace planner {
+class AggregatePlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for a sort-based group-by operator.
+//
+// The input must arrive sorted on the grouping columns, so all tuples of a
+// group are adjacent. Only the current group is kept: every input tuple either
+// advances its aggregates, or completes it and starts a new one. A completed
+// group is sent along the pipeline right away, and the last group once the
+// input runs out. No hash table is built, nothing is buffered, and the groups
+// are produced in input order.
+//===----------------------------------------------------------------------===//
+class SortGroupByTranslator : public OperatorTranslator {
+ public:
+  // Constructor
+  SortGroupByTranslator(const planner::AggregatePlan &group_by,
+                        CompilationContext &context, Pipeline &pipeline);
+
+  // Codegen any initialization work for this operator
+  void InitializeQueryState() override;
+
+  // No helper functions
+  void DefineAuxiliaryFunctions() override {}
+
+  // The method that produces new tuples
+  void Produce() const override;
+
+  // The method that consumes tuples from child operators
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+  // Send the last group along the pipeline
+  void Flush(ConsumerContext &context) const override;
+
+  // Codegen any cleanup work for this translator
+  void TearDownQueryState() override;
+
+ private:
+  // Send the group stored at the given entry along the pipeline
+  void ProduceGroup(ConsumerContext &context, llvm::Value *entry) const;
+
+  // Return a pointer to the current group in the runtime state
+  llvm::Value *GetGroupPtr(CodeGen &codegen) const;
+
+  // Return a pointer to the aggregates of the group stored at the given entry
+  llvm::Value *GetAggregateSpace(CodeGen &codegen, llvm::Value *entry) const;
+
+  // Load the grouping keys of the group stored at the given entry
+  void LoadKeys(CodeGen &codegen, llvm::Value *entry,
+                std::vector<codegen::Value> &key) const;
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // An accessor into a single value of the group being produced
+  //===--------------------------------------------------------------------===//
+  class GroupValueAccess : public RowBatch::AttributeAccess {
+   public:
+    // Constructor
+    GroupValueAccess(const std::vector<codegen::Value> &group_vals,
+                     uint32_t index)
+        : group_vals_(group_vals), index_(index) {}
+
+    Value Access(CodeGen &, RowBatch::Row &) override {
+      return group_vals_[index_];
+    }
+
+   private:
+    // The keys and aggregates of the group
+    const std::vector<codegen::Value> &group_vals_;
+
+    // The value this accessor is for
+    uint32_t index_;
+  };
+
+ private:
+  // The class responsible for handling the aggregation for all our aggregates
+  Aggregation aggregation_;
+
+  // The storage format of the grouping keys of a group
+  UpdateableStorage key_storage_;
+
+  // The offset of the aggregates in a group, and the size of a group
+  uint32_t aggregates_offset_;
+  uint32_t entry_size_;
+
+  // The IDs of the current group and whether there is one in the runtime state
+  QueryState::Id group_id_;
+  QueryState::Id has_group_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -67,6 +67,10 @@ class TableScanTranslator : public OperatorTranslator {
   const planner::SeqScanPlan &GetScanPlan() const;
 
  private:
+  // The number of tile groups a serial scan processes per call of its
+  // pipeline function
+  static constexpr uint32_t kTileGroupsPerMorsel = 1;
+
   // Helper class declarations (defined in implementation)
   class AttributeAccess;
   class ScanConsumer;
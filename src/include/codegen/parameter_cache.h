@@ -42,6 +42,12 @@ class ParameterCache {
   codegen::Value GetValue(uint32_t index) const;
   codegen::Value GetValue(const expression::AbstractExpression *expr) const;
 
+  // Get the index of the query parameter for the given expression
+  uint32_t GetParameterIndex(
+      const expression::AbstractExpression *expr) const {
+    return parameters_map_.GetIndex(expr);
+  }
+
   // Clear all cache parameter values
   void Reset();
 
@@ -177,6 +177,10 @@ class Pipeline {
 
   uint32_t GetTranslatorStage(const OperatorTranslator *translator) const;
 
+  /// Have the given translator send along the rows it holds back, once the
+  /// pipeline has consumed all of its input. Only serial pipelines flush.
+  void InstallFlush(const OperatorTranslator *translator);
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Serial/Parallel execution
@@ -187,6 +191,15 @@ class Pipeline {
 
   void RunSerial(const std::function<void(ConsumerContext &)> &body);
 
+  /// Run the pipeline serially over the tasks [0, num_tasks). The pipeline
+  /// function is called once per morsel of at most morsel_size tasks, and
+  /// receives the start and end of the morsel as its arguments. Interpreted
+  /// queries can switch to native code between two morsels.
+  void RunSerial(
+      llvm::Value *num_tasks, uint32_t morsel_size,
+      const std::function<void(ConsumerContext &,
+                               const std::vector<llvm::Value *> &)> &body);
+
   void RunParallel(
       llvm::Function *dispatch_func,
       const std::vector<llvm::Value *> &dispatch_args,
@@ -223,13 +236,16 @@ class Pipeline {
   void Run(llvm::Function *dispatch_func,
            const std::vector<llvm::Value *> &dispatch_args,
            const std::vector<llvm::Type *> &pipeline_arg_types,
+           llvm::Value *num_tasks, uint32_t morsel_size,
            const std::function<void(ConsumerContext &,
                                     const std::vector<llvm::Value *> &)> &body);
   void DoRun(PipelineContext &pipeline_ctx, llvm::Function *dispatch_func,
              const std::vector<llvm::Value *> &dispatch_args,
              const std::vector<llvm::Type *> &pipeline_args_types,
+             llvm::Value *num_tasks, uint32_t morsel_size,
              const std::function<void(
                  ConsumerContext &, const std::vector<llvm::Value *> &)> &body);
+  void DoFlush(PipelineContext &pipeline_ctx, uint32_t flush_index);
 
   /// Return the total number of stages in the pipeline
   uint32_t GetNumStages() const;
@@ -252,6 +268,10 @@ class Pipeline {
   // i-1 and i in the pipeline.
   std::vector<uint32_t> stage_boundaries_;
 
+  // Positions of the operators in the pipeline that hold back rows until all
+  // the input has been consumed, in the order they were installed
+  std::vector<uint32_t> flush_points_;
+
   // Level of parallelism
   Parallelism parallelism_;
 };
@@ -31,6 +31,7 @@ PROXY(BloomFilter) {
   // Methods
   DECLARE_METHOD(Init);
   DECLARE_METHOD(Destroy);
+  DECLARE_METHOD(Merge);
 };
 
 TYPE_BUILDER(BloomFilter, util::BloomFilter);
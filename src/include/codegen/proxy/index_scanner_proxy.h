@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scanner_proxy.h
+//
+// Identification: src/include/codegen/proxy/index_scanner_proxy.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "codegen/util/index_scanner.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(IndexScanner) {
+  DECLARE_MEMBER(0, char[sizeof(codegen::util::IndexScanner)], opaque);
+  DECLARE_TYPE;
+
+  DECLARE_METHOD(Init);
+  DECLARE_METHOD(Destroy);
+  DECLARE_METHOD(Scan);
+  DECLARE_METHOD(GetNumRuns);
+  DECLARE_METHOD(GetTileGroup);
+  DECLARE_METHOD(GetTupleOffsets);
+  DECLARE_METHOD(GetNumTuples);
+};
+
+TYPE_BUILDER(IndexScanner, codegen::util::IndexScanner);
+
+}  // namespace codegen
+}  // namespace peloton
@@ -44,8 +44,10 @@ PROXY(RuntimeFunctions) {
   DECLARE_METHOD(GetTileGroup);
   DECLARE_METHOD(GetTileGroupLayout);
   DECLARE_METHOD(FillPredicateArray);
+  DECLARE_METHOD(ShouldScanTileGroup);
   DECLARE_METHOD(ExecuteTableScan);
   DECLARE_METHOD(ExecutePerState);
+  DECLARE_METHOD(ExecutePerPartition);
   DECLARE_METHOD(ThrowDivideByZeroException);
   DECLARE_METHOD(ThrowOverflowException);
 };
@@ -13,28 +13,19 @@
 #pragma once
 
 #include "codegen/proxy/proxy.h"
-#include "storage/zone_map_manager.h"
-#include "type/value.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace codegen {
 
-PROXY(PredicateInfo) {
-  DECLARE_MEMBER(0, int, col_id);
-  DECLARE_MEMBER(1, int, comparison_operator);
-  DECLARE_MEMBER(2, peloton::type::Value, predicate_value);
+PROXY(PredicateRange) {
+  DECLARE_MEMBER(0, uint32_t, col_id);
+  DECLARE_MEMBER(1, int64_t, low);
+  DECLARE_MEMBER(2, int64_t, high);
   DECLARE_TYPE;
 };
 
-PROXY(ZoneMapManager) {
-  DECLARE_MEMBER(0, char[sizeof(storage::ZoneMapManager)], opaque);
-  DECLARE_TYPE;
-  DECLARE_METHOD(ShouldScanTileGroup);
-  DECLARE_METHOD(GetInstance);
-};
-
-TYPE_BUILDER(PredicateInfo, storage::PredicateInfo);
-TYPE_BUILDER(ZoneMapManager, storage::ZoneMapManager);
+TYPE_BUILDER(PredicateRange, storage::PredicateRange);
 
 }  // namespace codegen
-}  // namespace peloton
\ No newline at end of file
+}  // namespace peloton
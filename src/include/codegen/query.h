@@ -12,6 +12,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include "codegen/code_context.h"
 #include "codegen/parameter_cache.h"
 #include "codegen/query_parameters.h"
@@ -50,6 +57,8 @@ class Query {
     double init_ms = 0.0;
     double plan_ms = 0.0;
     double tear_down_ms = 0.0;
+    // Calls from interpreted code to compiled code in an adaptive execution
+    uint64_t num_native_calls = 0;
   };
 
   // We use this handy class for the parameters to the llvm functions
@@ -77,6 +86,9 @@ class Query {
   /// This class cannot be copy or move-constructed
   DISALLOW_COPY_AND_MOVE(Query);
 
+  /// Destructor. Waits for a background compilation to finish.
+  ~Query();
+
   /**
    * @brief Setup this query with the given JITed function components
    *
@@ -97,6 +109,16 @@ class Query {
   void Execute(executor::ExecutorContext &executor_context,
                ExecutionConsumer &consumer, RuntimeStats *stats = nullptr);
 
+  /**
+   * @brief Record that the query was found in the query cache. With tiered
+   * compilation, a query that is hit often enough is compiled again with all
+   * optimizations in the background.
+   */
+  void RecordCacheHit();
+
+  /// Wait until all compilations of this query in the background are done
+  void WaitForBackgroundCompilation();
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
@@ -112,6 +134,9 @@ class Query {
   /// The class tracking all the state needed by this query
   QueryState &GetQueryState() { return query_state_; }
 
+  /// Has the query been compiled again with all optimizations?
+  bool IsOptimized() const { return is_optimized_; }
+
  private:
   friend class QueryCompiler;
 
@@ -126,7 +151,35 @@ class Query {
   void ExecuteInterpreter(FunctionArguments *function_arguments,
                           RuntimeStats *stats);
 
+  // Execute the query in the interpreter while it is compiled to native code
+  // in the background, switching to native code once it is available
+  void ExecuteAdaptive(FunctionArguments *function_arguments,
+                       RuntimeStats *stats);
+
+  // Start compiling the query in the background, if not already started
+  void StartBackgroundCompile();
+
+  // Compile the query again with all optimizations (tiered compilation)
+  void CompileOptimized();
+
+  // Get the pointers to the init, plan and tear down functions from the code
+  // context
+  CompiledFunctions LookupCompiledFunctions() const;
+
+  // Run the given compilation task on the compilation thread pool. Returns an
+  // invalid future, and drops the task, while codegen_compile_task_queue_size
+  // compilations are pending.
+  static std::shared_future<void> SubmitCompileTask(std::function<void()> task);
+
+  // Return the native implementation of the function with the given name, or
+  // nullptr if the query has not been compiled yet
+  CodeContext::FuncPtr GetNativeFunction(const std::string &name) const;
+
  private:
+  // The bytecode of the query functions, used for adaptive execution
+  struct BytecodeFunctions;
+
+  class NativeFunctionResolver;
   // The query plan
   const planner::AbstractPlan &query_plan_;
 
@@ -136,14 +189,47 @@ class Query {
   // The size of the parameter the functions take
   QueryState query_state_;
 
+  // The size of the query state in bytes, computed when the query is prepared
+  size_t query_state_size_ = 0;
+
   // LLVM IR of the query functions
   LLVMFunctions llvm_functions_;
 
   // Pointers to the compiled query functions
   CompiledFunctions compiled_functions_;
 
+  // Pointers to the query functions compiled with all optimizations
+  CompiledFunctions optimized_functions_;
+
+  // Pointers to all compiled functions in the code context, by name
+  std::unordered_map<std::string, CodeContext::FuncPtr> native_functions_;
+
   // Shows if the query has been compiled to native code
-  bool is_compiled_;
+  std::atomic<bool> is_compiled_{false};
+
+  // Shows if the query is compiled in tiers, and if it has been compiled with
+  // all optimizations already
+  bool is_tiered_ = false;
+  std::atomic<bool> is_optimized_{false};
+
+  // The number of times the query was found in the query cache
+  std::atomic<uint64_t> num_cache_hits_{0};
+
+  // Protects the state used for adaptive execution and compilations in the
+  // background below
+  std::mutex adaptive_mutex_;
+
+  // The bytecode of the query, built on the first adaptive execution
+  std::unique_ptr<BytecodeFunctions> bytecode_functions_;
+
+  // Shows if the interpreter failed to translate the query
+  bool bytecode_not_supported_ = false;
+
+  // The compilation running in the background, if one was started
+  std::shared_future<void> background_compile_;
+
+  // The compilation with all optimizations, if one was started
+  std::shared_future<void> optimized_compile_;
 };
 
 }  // namespace codegen
@@ -45,6 +45,9 @@ class QueryCompiler {
 
     // Time consumed by LLVM Optimizer
     double optimize_ms = 0.0;
+
+    // The number of pipelines that were set up for parallel execution
+    uint32_t num_parallel_pipelines = 0;
   };
 
   // Constructor
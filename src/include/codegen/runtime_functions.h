@@ -22,9 +22,7 @@ namespace peloton {
 namespace storage {
 class DataTable;
 class TileGroup;
-class ZoneMap;
-class ZoneMapManager;
-struct PredicateInfo;
+struct PredicateRange;
 }  // namespace storage
 
 namespace expression {
@@ -49,8 +47,16 @@ class RuntimeFunctions {
   static storage::TileGroup *GetTileGroup(storage::DataTable *table,
                                           uint64_t tile_group_index);
 
-  static void FillPredicateArray(const expression::AbstractExpression *expr,
-                                 storage::PredicateInfo *predicate_array);
+  // Encode the zone-mappable predicates of the given scan predicate on the
+  // table into the provided array. Returns the number of encoded predicates.
+  static int32_t FillPredicateArray(const expression::AbstractExpression *expr,
+                                    storage::DataTable *table,
+                                    storage::PredicateRange *predicate_array);
+
+  // Check the encoded predicates against the zone map of the given tile group
+  static bool ShouldScanTileGroup(storage::TileGroup *tile_group,
+                                  const storage::PredicateRange *predicates,
+                                  int32_t num_predicates);
 
   // This struct represents the layout (or configuration) of a column in a
   // tile group. A configuration is characterized by two properties: its
@@ -106,6 +112,18 @@ class RuntimeFunctions {
       void *query_state, executor::ExecutorContext::ThreadStates &thread_states,
       void (*work_func)(void *, void *));
 
+  /**
+   * Invoke a function for each partition in the range [0, num_partitions) in
+   * parallel.
+   *
+   * @param query_state An opaque (but usually a JITed struct) state used during
+   * query execution.
+   * @param num_partitions The number of partitions.
+   * @param work_func Callback function called for each partition.
+   */
+  static void ExecutePerPartition(void *query_state, uint32_t num_partitions,
+                                  void (*work_func)(void *, uint32_t));
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Exception related functions
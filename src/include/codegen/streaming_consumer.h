@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// streaming_consumer.h
+//
+// Identification: src/include/codegen/streaming_consumer.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "codegen/buffering_consumer.h"
+#include "common/result_batch.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A query consumer that hands the output over in batches of rows while the
+// query runs, rather than buffering the whole output until the query is done.
+// Every row is encoded into the buffer of the batch in the wire format
+// requested for its columns as soon as it is produced, so at most one batch
+// of rows is kept in memory, and no value is kept as an object of its own.
+//===----------------------------------------------------------------------===//
+class StreamingConsumer : public BufferingConsumer {
+ public:
+  /// Callback invoked with every full batch of rows. It returns false once it
+  /// wants no more rows.
+  using BatchCallback = std::function<bool(ResultBatch &&)>;
+
+  /// Constructor
+  StreamingConsumer(const std::vector<oid_t> &cols,
+                    const planner::BindingContext &context,
+                    const std::vector<int> &result_format,
+                    BatchCallback on_batch,
+                    uint32_t batch_size = RESULT_BATCH_SIZE);
+
+  void ConsumeResult(ConsumerContext &ctx, RowBatch::Row &row) const override;
+
+  // Called from compiled query code to add the tuple to the current batch
+  static void StreamTuple(char *state, char *tuple, uint32_t num_cols);
+
+  // Hand over the rows of the last batch, once the query is done
+  void FlushBatch();
+
+  //===--------------------------------------------------------------------===//
+  // ACCESSORS
+  //===--------------------------------------------------------------------===//
+
+  char *GetConsumerState() override;
+
+ private:
+  // The batch of rows that is being filled. Parallel query threads fill it
+  // under the mutex, which also keeps the batches in order.
+  struct Stream {
+    std::mutex mutex;
+    ResultBatch batch;
+    // The format code of every output column
+    std::vector<int> result_format;
+    uint32_t num_rows;
+    uint32_t batch_size;
+    BatchCallback on_batch;
+    // Whether the callback wants no more rows, which are then dropped
+    bool cancelled;
+  };
+  Stream stream_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
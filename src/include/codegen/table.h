@@ -45,7 +45,7 @@ class Table {
   /// should be notified when ready to generate the scan loop body.
   void GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
                     llvm::Value *tilegroup_start, llvm::Value *tilegroup_end,
-                    uint32_t batch_size, llvm::Value *predicate_array,
+                    uint32_t batch_size, llvm::Value *predicate_ptr,
                     size_t num_predicates, ScanCallback &consumer) const;
 
   /// Given a table instance, return the number of tile groups in the table.
@@ -57,8 +57,6 @@ class Table {
   llvm::Value *GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
                             llvm::Value *tile_group_id) const;
 
-  llvm::Value *GetZoneMapManager(CodeGen &codegen) const;
-
  private:
   // The table associated with this generator
   storage::DataTable &table_;
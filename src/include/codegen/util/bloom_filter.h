@@ -43,6 +43,10 @@ class BloomFilter {
   // Destroy the bloom filter states
   void Destroy();
 
+  // Add all the elements of the other bloom filter to this one. Both filters
+  // must have been initialized with the same estimated number of tuples.
+  void Merge(BloomFilter &other);
+
  private:
   // Number of hash functions to use
   uint64_t num_hash_funcs_;
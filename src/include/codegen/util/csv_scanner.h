@@ -17,6 +17,7 @@
 
 #include "codegen/type/type.h"
 #include "util/file.h"
+#include "util/pipe.h"
 
 namespace peloton {
 
@@ -117,7 +118,8 @@ class CSVScanner {
    *
    * @param scanner The scanner we're initializing
    * @param memory A memory pool where all allocations are sourced from
-   * @param file_path The full path to the CSV file
+   * @param file_path The full path to the CSV file. If empty, the CSV data is
+   * read from the copy input of the executor context (i.e., COPY FROM STDIN).
    * @param col_types A description of the rows stored in the CSV
    * @param num_cols The number of columns to expect
    * @param func The callback function to invoke per row/line in the CSV
@@ -180,6 +182,9 @@ class CSVScanner {
   // The CSV file handle
   peloton::util::File file_;
 
+  // The data sent by the client, read instead of the file if there's no path
+  peloton::util::Pipe *input_;
+
   // The temporary read-buffer where raw file contents are first read into
   // TODO: make these unique_ptr's with a customer deleter
   char *buffer_;
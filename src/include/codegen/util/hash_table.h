@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 #include "executor/executor_context.h"
 
@@ -45,9 +46,19 @@ namespace util {
  * thread-local hash tables to. Finally, calls to MergeLazyUnfinished() are
  * made concurrently from multiple threads to merge lazily-built thread-local
  * hash tables.
+ *
+ * Instead of building one directory over all lazily inserted entries, the
+ * entries can also be radix partitioned on the high bits of their hash with
+ * PartitionLazy() (or PartitionLazyParallel() after a parallel build). Each
+ * partition is then probed on its own after building a directory over only
+ * its entries with BuildPartition(), so that directories and entries of a
+ * partition fit in cache. The entries of a partition can also be walked from
+ * GetPartitionHead() through their next pointers.
  */
 class HashTable {
  public:
+  struct Entry;
+
   /** Constructor */
   HashTable(::peloton::type::AbstractPool &memory, uint32_t key_size,
             uint32_t value_size);
@@ -135,6 +146,48 @@ class HashTable {
    */
   void MergeLazyUnfinished(HashTable &other);
 
+  /**
+   * Radix partition all the lazily inserted entries into 2^num_partition_bits
+   * partitions on the high bits of their hash. The entries of each partition
+   * are copied next to each other, and linked in storage order through their
+   * next pointers.
+   *
+   * @param num_partition_bits The number of hash bits to partition on
+   */
+  void PartitionLazy(uint32_t num_partition_bits);
+
+  /**
+   * Like PartitionLazy(), but partitions the entries that were lazily inserted
+   * into each of the thread-local hash tables stored in the thread states.
+   * The thread-local tables are left untouched.
+   *
+   * @param thread_states Where thread-local hash tables are located
+   * @param hash_table_offset The offset into each state where the thread-local
+   * hash table can be found.
+   * @param num_partition_bits The number of hash bits to partition on
+   */
+  void PartitionLazyParallel(
+      const executor::ExecutorContext::ThreadStates &thread_states,
+      uint32_t hash_table_offset, uint32_t num_partition_bits);
+
+  /**
+   * Build the directory over the entries of the given partition only. This
+   * replaces the directory of the previous partition, and re-links the
+   * entries of the partition into bucket chains.
+   *
+   * @param partition The partition to build the directory of
+   */
+  void BuildPartition(uint32_t partition);
+
+  /**
+   * Return the first entry of the given partition, or NULL if the partition
+   * is empty. Must not be used after BuildPartition() on this partition.
+   *
+   * @param partition The partition
+   * @return The first entry of the partition
+   */
+  Entry *GetPartitionHead(uint32_t partition) const;
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
@@ -143,6 +196,7 @@ class HashTable {
 
   uint64_t NumElements() const { return num_elems_; }
   uint64_t Capacity() const { return capacity_; }
+  uint32_t NumPartitions() const { return 1u << num_partition_bits_; }
   double LoadFactor() const { return num_elems_ / 1.0 / directory_size_; }
 
   //////////////////////////////////////////////////////////////////////////////
@@ -245,6 +299,11 @@ class HashTable {
      */
     void TransferMemoryBlocks(EntryBuffer &target);
 
+    /**
+     * Return the size of the entries in this buffer.
+     */
+    uint32_t EntrySize() const { return entry_size_; }
+
    private:
     // This struct represents a chunk of heap memory. We chain together these
     // chunks to avoid the need for a std::vector.
@@ -276,6 +335,15 @@ class HashTable {
   // Resize the hash table
   void Resize();
 
+  // Radix partition the lazily inserted entries of all the given tables
+  void PartitionEntries(const std::vector<const HashTable *> &tables,
+                        uint32_t num_partition_bits);
+
+  // Return the partition an entry with the given hash belongs to
+  uint64_t PartitionOf(uint64_t hash) const {
+    return num_partition_bits_ == 0 ? 0 : hash >> (64 - num_partition_bits_);
+  }
+
  private:
   // The memory allocator used for all allocations in this hash table
   ::peloton::type::AbstractPool &memory_;
@@ -293,8 +361,11 @@ class HashTable {
   uint64_t num_elems_;
   uint64_t capacity_;
 
-  // Info about partitions
-  // ...
+  // Info about partitions. The entries of partition p are stored in
+  // [partition_offsets_[p], partition_offsets_[p + 1]) of partition_entries_.
+  char *partition_entries_;
+  uint64_t *partition_offsets_;
+  uint32_t num_partition_bits_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
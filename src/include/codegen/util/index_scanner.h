@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scanner.h
+//
+// Identification: src/include/codegen/util/index_scanner.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "index/scan_optimizer.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace concurrency {
+class TransactionContext;
+}  // namespace concurrency
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace index {
+class Index;
+}  // namespace index
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}  // namespace storage
+
+namespace codegen {
+namespace util {
+
+/**
+ * This class probes a table's index on behalf of compiled index scans. A probe
+ * collects the locations of all matching tuples, resolves each location to the
+ * version visible to the scanning transaction, and groups the results into
+ * runs of consecutive tuples that live in the same tile group. Runs preserve
+ * the order the index returned the tuples in, so scans that provide a sort
+ * order to their parents keep doing so.
+ *
+ * The compiled code is responsible for evaluating the scan predicate and for
+ * recording the reads of the tuples in each run.
+ */
+class IndexScanner {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param executor_context The context of the query the scan belongs to
+   * @param table The table the index belongs to
+   * @param index_oid The ID of the index to probe
+   * @param key_column_ids The table columns the scan places conditions on
+   * @param expr_types The comparison applied to each key column
+   * @param key_param_idxs The query parameter holding each key's value
+   * @param num_keys The number of key conditions
+   * @param max_run_size The maximum number of tuples in a single run
+   */
+  IndexScanner(executor::ExecutorContext &executor_context,
+               storage::DataTable &table, uint32_t index_oid,
+               const uint32_t *key_column_ids, const int32_t *expr_types,
+               const uint32_t *key_param_idxs, uint32_t num_keys,
+               uint32_t max_run_size);
+
+  /**
+   * Initialization function. This is the entry point from codegen to initialize
+   * scanner instances.
+   *
+   * @param scanner The scanner we're initializing
+   *
+   * The remaining arguments are forwarded to the constructor.
+   */
+  static void Init(IndexScanner &scanner,
+                   executor::ExecutorContext &executor_context,
+                   storage::DataTable &table, uint32_t index_oid,
+                   const uint32_t *key_column_ids, const int32_t *expr_types,
+                   const uint32_t *key_param_idxs, uint32_t num_keys,
+                   uint32_t max_run_size);
+
+  /**
+   * Destruction function. This is the entry point from codegen when cleaning up
+   * and reclaiming memory from scanner instances.
+   *
+   * @param scanner The scanner we're destroying.
+   */
+  static void Destroy(IndexScanner &scanner);
+
+  /**
+   * Probe the index and collect the visible tuples into runs, replacing the
+   * runs of any previous probe.
+   */
+  void Scan();
+
+  /// Return the number of runs the last probe produced
+  uint32_t GetNumRuns() const { return static_cast<uint32_t>(runs_.size()); }
+
+  /// Return the tile group the tuples of the given run belong to
+  storage::TileGroup *GetTileGroup(uint32_t run_idx) const {
+    return runs_[run_idx].tile_group.get();
+  }
+
+  /// Return the offsets of the tuples in the given run. The compiled scan uses
+  /// this array as its selection vector and is free to overwrite it.
+  uint32_t *GetTupleOffsets(uint32_t run_idx) {
+    return runs_[run_idx].offsets.data();
+  }
+
+  /// Return the number of tuples in the given run
+  uint32_t GetNumTuples(uint32_t run_idx) const {
+    return static_cast<uint32_t>(runs_[run_idx].offsets.size());
+  }
+
+ private:
+  // Follow the version chain starting at the given location to the version
+  // visible to our transaction, adding the versions visited to num_versions.
+  // Returns false if the chain is broken.
+  bool FindVisibleVersion(ItemPointer &location,
+                          std::shared_ptr<storage::TileGroup> &tile_group,
+                          bool &visible, size_t &num_versions) const;
+
+  // Check that the (secondary) key of the given version matches the scan keys
+  bool KeyMatches(const ItemPointer &location,
+                  const std::shared_ptr<storage::TileGroup> &tile_group) const;
+
+  // Append the tuple at the given location to the current run
+  void AppendToRun(const ItemPointer &location,
+                   const std::shared_ptr<storage::TileGroup> &tile_group);
+
+ private:
+  // A run of tuples stored in the same tile group
+  struct Run {
+    std::shared_ptr<storage::TileGroup> tile_group;
+    std::vector<uint32_t> offsets;
+  };
+
+  // The transaction performing the scan
+  concurrency::TransactionContext *txn_;
+
+  // The index we probe
+  std::shared_ptr<index::Index> index_;
+
+  // The table columns the index is built on. Only set for secondary indexes,
+  // whose entries may point to versions that no longer carry the key.
+  std::vector<oid_t> indexed_columns_;
+
+  // The key conditions
+  std::vector<oid_t> key_column_ids_;
+  std::vector<ExpressionType> expr_types_;
+  std::vector<peloton::type::Value> values_;
+
+  // The scan predicate the index is probed with
+  index::IndexScanPredicate index_predicate_;
+
+  // The maximum number of tuples in a run
+  uint32_t max_run_size_;
+
+  // The runs of the last probe
+  std::vector<Run> runs_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -16,6 +16,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
+#include <functional>
 
 #include "libcuckoo/cuckoohash_map.hh"
 #include "libcuckoo/default_hasher.hh"
@@ -55,9 +56,18 @@ class CuckooMap {
   // Upsert operations always succeed
   void Upsert(const KeyType &key, ValueType value);
 
+  // Runs update_fn on the value of the key if present, inserts the item
+  // otherwise. Both happen under the lock of the key's buckets
+  void UpsertFn(const KeyType &key,
+                std::function<void(ValueType &)> update_fn, ValueType value);
+
   // Extracts item with high priority
   bool Update(const KeyType &key, ValueType value);
 
+  // Runs update_fn on the value of the key under the lock of its buckets.
+  // Returns false if the key is not present
+  bool UpdateFn(const KeyType &key, std::function<void(ValueType &)> update_fn);
+
   // Extracts the corresponding value
   bool Find(const KeyType &key, ValueType &value) const;
 
@@ -73,6 +83,9 @@ class CuckooMap {
   // Returns item count in the cuckoo_map
   size_t GetSize() const;
 
+  // Returns the number of items the cuckoo_map has room for
+  size_t GetCapacity() const;
+
   // Checks if the cuckoo_map is empty
   bool IsEmpty() const;
 
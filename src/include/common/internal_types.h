@@ -339,6 +339,12 @@ enum class NetworkMessageType : unsigned char {
   READY_FOR_QUERY = 'Z',
   ROW_DESCRIPTION = 'T',
   DATA_ROW = 'D',
+  PORTAL_SUSPENDED = 's',
+  COPY_IN_RESPONSE = 'G',
+  COPY_OUT_RESPONSE = 'H',
+  // Both ways during COPY
+  COPY_DATA = 'd',
+  COPY_DONE = 'c',
   // Errors
   HUMAN_READABLE_ERROR = 'M',
   SQLSTATE_CODE_ERROR = 'C',
@@ -351,6 +357,8 @@ enum class NetworkMessageType : unsigned char {
   PARSE_COMMAND = 'P',
   SIMPLE_QUERY_COMMAND = 'Q',
   CLOSE_COMMAND = 'C',
+  FLUSH_COMMAND = 'H',
+  COPY_FAIL_COMMAND = 'f',
   // SSL willingness
   SSL_YES = 'S',
   SSL_NO = 'N',
@@ -1081,6 +1089,10 @@ enum class MetricType {
   QUERY = 9,
   // Statistics for CPU
   PROCESSOR = 10,
+  // Statistics for the compilation of generated code
+  COMPILATION = 11,
+  // Statistics for garbage collection
+  GC = 12,
 };
 
 // All builtin operators we currently support
@@ -1363,9 +1375,11 @@ enum class RuleType : uint32_t {
   INSERT_TO_PHYSICAL,
   INSERT_SELECT_TO_PHYSICAL,
   AGGREGATE_TO_HASH_AGGREGATE,
+  AGGREGATE_TO_SORT_AGGREGATE,
   AGGREGATE_TO_PLAIN_AGGREGATE,
   INNER_JOIN_TO_NL_JOIN,
   INNER_JOIN_TO_HASH_JOIN,
+  INNER_JOIN_TO_MERGE_JOIN,
   IMPLEMENT_DISTINCT,
   IMPLEMENT_LIMIT,
   EXPORT_EXTERNAL_FILE_TO_PHYSICAL,
@@ -1434,6 +1448,12 @@ typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
 //===--------------------------------------------------------------------===//
 #define SOCKET_BUFFER_SIZE 8192
 
+// Number of rows in a batch of a streamed query result
+#define RESULT_BATCH_SIZE 1024
+
+// Number of result batches a query can produce ahead of its connection
+#define MAX_PENDING_RESULT_BATCHES 4
+
 /* byte type */
 typedef unsigned char uchar;
 
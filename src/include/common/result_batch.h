@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// result_batch.h
+//
+// Identification: src/include/common/result_batch.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/statement.h"
+
+namespace peloton {
+
+/**
+ * A batch of result rows, in the format of the columns of a Postgres DataRow
+ * message. Every value is stored as its length, a 4-byte integer in network
+ * byte order that is -1 for NULL, followed by its bytes. The rows are kept
+ * back to back in a single buffer rather than as one string per value, and
+ * go out to the client as they are.
+ */
+class ResultBatch {
+ public:
+  ResultBatch() = default;
+
+  /**
+   * Start a new row. Its columns are appended to GetBuffer() next, e.g. with
+   * network::PostgresValueFormat::AppendColumn().
+   */
+  void BeginRow() { row_offsets_.push_back(data_.size()); }
+
+  std::string &GetBuffer() { return data_; }
+
+  size_t NumRows() const { return row_offsets_.size(); }
+
+  bool IsEmpty() const { return row_offsets_.empty(); }
+
+  /**
+   * @return The columns of the row
+   */
+  const char *GetRow(size_t row) const {
+    return data_.data() + row_offsets_[row];
+  }
+
+  /**
+   * @return The number of bytes of the columns of the row
+   */
+  size_t GetRowSize(size_t row) const;
+
+  /**
+   * Read the column at the given position of a row.
+   *
+   * @param pos Where the column starts
+   * @param[out] data The bytes of the value
+   * @param[out] len The number of bytes of the value, -1 for NULL
+   * @return Where the next column starts
+   */
+  static const char *ReadColumn(const char *pos, const char *&data,
+                                int32_t &len);
+
+  /**
+   * Append the values of all the rows, as one string per value. NULL turns
+   * into an empty string.
+   */
+  void GetValues(std::vector<ResultValue> &values) const;
+
+  /**
+   * Drop the first rows of the batch, e.g. once they were sent.
+   */
+  void DropRows(size_t num_rows);
+
+  void Clear() {
+    data_.clear();
+    row_offsets_.clear();
+  }
+
+ private:
+  // The columns of all the rows, and where every row starts
+  std::string data_;
+  std::vector<size_t> row_offsets_;
+};
+
+}  // namespace peloton
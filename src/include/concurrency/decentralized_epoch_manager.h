@@ -39,6 +39,7 @@ public:
     current_global_epoch_id_(1), 
     next_txn_id_(0),
     snapshot_global_epoch_id_(1),
+    last_expired_epoch_id_(INVALID_EID),
     is_running_(false) {
       // register a default thread for handling catalog stuffs.
       RegisterThread(0);
@@ -70,6 +71,7 @@ public:
     current_global_epoch_id_ = current_epoch_id;
     next_txn_id_ = 0;
     snapshot_global_epoch_id_ = 1;
+    last_expired_epoch_id_ = INVALID_EID;
     local_epochs_.clear();
     
     RegisterThread(0);
@@ -165,6 +167,10 @@ public:
    */
   virtual eid_t GetExpiredEpochId() override;
 
+  virtual eid_t GetLastExpiredEpochId() override {
+    return last_expired_epoch_id_.load();
+  }
+
   /**
    * @brief      Gets the next epoch identifier.
    *
@@ -224,7 +230,10 @@ private:
    * Snapshot epoch is an epoch where the corresponding tuples may be still
    * visible to on-the-fly transactions
    */
-  eid_t snapshot_global_epoch_id_;
+  std::atomic<eid_t> snapshot_global_epoch_id_;
+
+  /** The largest epoch identifier returned by GetExpiredEpochId so far. */
+  std::atomic<eid_t> last_expired_epoch_id_;
 
   bool is_running_;
 
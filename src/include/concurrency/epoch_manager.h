@@ -83,6 +83,17 @@ public:
    */
   virtual eid_t GetExpiredEpochId() = 0;
 
+  /**
+   * @brief      Gets the expired epoch identifier most recently computed by
+   *             GetExpiredEpochId, without computing it again. Unlike
+   *             GetExpiredEpochId, it doesn't move the snapshot epoch
+   *             forward, so it's what threads other than the GC call.
+   *
+   * @return     The last expired epoch identifier, or INVALID_EID if none
+   *             was computed yet.
+   */
+  virtual eid_t GetLastExpiredEpochId() = 0;
+
   /**
    * @brief      Gets the next epoch identifier.
    *
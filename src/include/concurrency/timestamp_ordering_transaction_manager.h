@@ -252,6 +252,18 @@ class TimestampOrderingTransactionManager : public TransactionManager {
   bool SetLastReaderCommitId(
       const storage::TileGroupHeader *const tile_group_header,
       const oid_t &tuple_id, const cid_t &current_cid, const bool is_owner);
+
+  /**
+   * @brief      Count the tuples of each table modified by a committing
+   *             transaction, which triggers refreshing the tables' stats.
+   *             Only needed while auto_analyze is on.
+   *
+   * @param[in]  modified_counts  The tables and their numbers of modified
+   *                              tuples
+   */
+  void RecordModifications(
+      const std::vector<std::pair<storage::AbstractTable *, size_t>>
+          &modified_counts);
 };
 }
 }
@@ -132,6 +132,27 @@ class TransactionContext : public Printable {
    * @param[in]  epoch_id  The epoch identifier
    */
   inline void SetEpochId(const eid_t epoch_id) { epoch_id_ = epoch_id; }
+
+  /**
+   * @brief      Records versions the transaction skipped because they were
+   *             deleted or replaced before it began, and wait to be garbage
+   *             collected. Parallel scans of the transaction may record them
+   *             concurrently.
+   *
+   * @param[in]  count  The number of versions
+   */
+  inline void RecordGarbageVersions(const size_t count) {
+    garbage_version_count_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief      Gets the number of garbage versions the transaction skipped.
+   *
+   * @return     The number of garbage versions.
+   */
+  inline size_t GetGarbageVersionCount() const {
+    return garbage_version_count_.load(std::memory_order_relaxed);
+  }
   
   /**
    * @brief      Sets the timestamp.
@@ -338,6 +359,9 @@ class TransactionContext : public Printable {
 
   bool is_written_;
 
+  /** versions awaiting garbage collection the transaction skipped */
+  std::atomic<size_t> garbage_version_count_;
+
   std::unique_ptr<trigger::TriggerSet> on_commit_triggers_;
 
   /** one default transaction is NOT 'read only' unless it is marked 'read only' explicitly*/
@@ -26,6 +26,10 @@ namespace storage {
 class StorageManager;
 }  // namespace storage
 
+namespace util {
+class Pipe;
+}  // namespace util
+
 namespace executor {
 
 /**
@@ -61,6 +65,12 @@ class ExecutorContext {
   /// Return the memory pool for this particular query execution
   type::EphemeralPool *GetPool();
 
+  /// Return the data of a COPY FROM STDIN, if this execution has any
+  util::Pipe *GetCopyInput() const { return copy_input_; }
+
+  /// Set the data of a COPY FROM STDIN
+  void SetCopyInput(util::Pipe *copy_input) { copy_input_ = copy_input; }
+
   class ThreadStates {
    public:
     explicit ThreadStates(type::EphemeralPool &pool);
@@ -105,6 +115,8 @@ class ExecutorContext {
   type::EphemeralPool pool_;
   // Container for all states of all thread participating in this execution
   ThreadStates thread_states_;
+  // The data sent by the client for a COPY FROM STDIN
+  util::Pipe *copy_input_ = nullptr;
 };
 
 template <typename T>
@@ -13,6 +13,7 @@
 #pragma once
 
 #include "common/internal_types.h"
+#include "common/result_batch.h"
 #include "common/statement.h"
 #include "executor/logical_tile.h"
 
@@ -26,6 +27,10 @@ namespace type {
 class Value;
 }  // namespace type
 
+namespace util {
+class Pipe;
+}  // namespace util
+
 namespace executor {
 
 /**
@@ -68,6 +73,27 @@ class PlanExecutor {
       std::function<void(executor::ExecutionResult,
                          std::vector<ResultValue> &&)> on_complete);
 
+  /**
+   * Same as above, except that the result rows are handed to on_result_batch
+   * in batches of about RESULT_BATCH_SIZE rows while the query runs, instead
+   * of being collected for on_complete. The callback may block to hold the
+   * query back until the previous batches are consumed.
+   *
+   * @param on_result_batch The callback function to invoke with every batch
+   * of result rows, which returns false once it wants no more of them and the
+   * query may stop. If empty, all the values are passed to on_complete.
+   * @param copy_input The data of a COPY FROM STDIN, if the plan reads any
+   */
+  static void ExecutePlan(
+      std::shared_ptr<planner::AbstractPlan> plan,
+      concurrency::TransactionContext *txn,
+      const std::vector<type::Value> &params,
+      const std::vector<int> &result_format,
+      std::function<bool(ResultBatch &&)> on_result_batch,
+      std::function<void(executor::ExecutionResult,
+                         std::vector<ResultValue> &&)> on_complete,
+      util::Pipe *copy_input = nullptr);
+
   /**
    * @brief When a peloton node recvs a query plan, this function is invoked
    *
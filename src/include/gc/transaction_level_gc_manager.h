@@ -14,6 +14,8 @@
 
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -32,11 +34,14 @@ namespace gc {
 
 #define MAX_QUEUE_LENGTH 100000
 #define MAX_ATTEMPT_COUNT 100000
+#define MAX_ASSIST_COUNT 1000
 
 class TransactionLevelGCManager : public GCManager {
  public:
   TransactionLevelGCManager(const int thread_count)
-      : gc_thread_count_(thread_count), reclaim_maps_(thread_count) {
+      : gc_thread_count_(thread_count),
+        partition_latches_(new std::mutex[thread_count]),
+        reclaim_maps_(thread_count) {
     unlink_queues_.reserve(thread_count);
     for (int i = 0; i < gc_thread_count_; ++i) {
       std::shared_ptr<LockFreeQueue<concurrency::TransactionContext* >>
@@ -125,10 +130,21 @@ class TransactionLevelGCManager : public GCManager {
 
   virtual size_t GetTableCount() override { return recycle_queue_map_.size(); }
 
-  int Unlink(const int &thread_id, const eid_t &expired_eid);
+  // Unlink the garbage of at most max_count transactions queued for the
+  // given GC thread. Cooperative unlinking is done by a transaction helping
+  // the GC threads rather than by the thread itself.
+  int Unlink(const int &thread_id, const eid_t &expired_eid,
+             const size_t max_count = MAX_ATTEMPT_COUNT,
+             const bool cooperative = false);
 
   int Reclaim(const int &thread_id, const eid_t &expired_eid);
 
+  // The latch a gc thread holds while it works on its queues. Transactions
+  // don't help the thread while it's taken.
+  std::mutex &GetPartitionLatch(const int thread_id) {
+    return partition_latches_[thread_id];
+  }
+
  private:
   inline unsigned int HashToThread(const size_t &thread_id) {
     return (unsigned int)thread_id % gc_thread_count_;
@@ -144,6 +160,14 @@ class TransactionLevelGCManager : public GCManager {
 
   void Running(const int &thread_id);
 
+  /**
+   * @brief Have a transaction that skipped a lot of garbage help the GC
+   * thread its garbage is queued for, unless that thread is busy.
+   *
+   * @return No return value.
+   */
+  void AssistCollection(const int thread_id);
+
   void AddToRecycleMap(concurrency::TransactionContext *txn_ctx);
 
   bool ResetTuple(const ItemPointer &);
@@ -163,6 +187,11 @@ class TransactionLevelGCManager : public GCManager {
 
   int gc_thread_count_;
 
+  // latches serializing the work on the queues of each gc thread between the
+  // thread and the transactions helping it.
+  // # partition_latches == # gc_threads
+  std::unique_ptr<std::mutex[]> partition_latches_;
+
   // queues for to-be-unlinked tuples.
   // # unlink_queues == # gc_threads
   std::vector<std::shared_ptr<
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.h
+//
+// Identification: src/include/index/hash_index.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "common/container/cuckoo_map.h"
+#include "common/internal_types.h"
+#include "common/platform.h"
+#include "common/synchronization/spin_latch.h"
+#include "index/index.h"
+
+#define HASH_INDEX_TEMPLATE_ARGUMENTS                                  \
+  template <typename KeyType, typename ValueType, typename KeyHasher, \
+            typename KeyEqualityChecker, typename ValueEqualityChecker>
+
+#define HASH_INDEX_TYPE                                           \
+  HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker, \
+            ValueEqualityChecker>
+
+namespace peloton {
+namespace index {
+
+/**
+ * Hash index for equality lookups, built on the concurrent cuckoo hash map.
+ *
+ * Every key maps to the list of its values. Lookups copy the list of the key
+ * out of the map under the lock of its buckets. Changes to the list of a key
+ * additionally hold one of a fixed set of key latches, so that a key can be
+ * dropped from the map together with its last value without racing with an
+ * insert of the same key. The map thus never holds empty lists.
+ *
+ * The index has no order. Scans other than point queries return all the
+ * values of the index, which the index scan executor then filters, so the
+ * optimizer only picks a hash index when every key column is bound by an
+ * equality predicate.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, typename KeyHasher,
+          typename KeyEqualityChecker, typename ValueEqualityChecker>
+class HashIndex : public Index {
+  friend class IndexFactory;
+
+  using MapType = CuckooMap<KeyType, std::vector<ValueType>, KeyHasher,
+                            KeyEqualityChecker>;
+
+ public:
+  HashIndex(IndexMetadata *metadata);
+
+  ~HashIndex();
+
+  bool InsertEntry(const storage::Tuple *key, ItemPointer *value);
+
+  bool DeleteEntry(const storage::Tuple *key, ItemPointer *value);
+
+  bool CondInsertEntry(const storage::Tuple *key, ItemPointer *value,
+                       std::function<bool(const void *)> predicate);
+
+  void Scan(const std::vector<type::Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            ScanDirectionType scan_direction, std::vector<ValueType> &result,
+            const ConjunctionScanPredicate *csp_p);
+
+  void ScanLimit(const std::vector<type::Value> &values,
+                 const std::vector<oid_t> &key_column_ids,
+                 const std::vector<ExpressionType> &expr_types,
+                 ScanDirectionType scan_direction,
+                 std::vector<ValueType> &result,
+                 const ConjunctionScanPredicate *csp_p, uint64_t limit,
+                 uint64_t offset);
+
+  void ScanAllKeys(std::vector<ValueType> &result);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ValueType> &result);
+
+  std::string GetTypeName() const;
+
+  size_t GetMemoryFootprint();
+
+  // Deleted values are freed right away
+  bool NeedGC() { return false; }
+
+  void PerformGC() { return; }
+
+ protected:
+  // The number of latches that serialize the changes to the same key
+  static constexpr size_t kNumKeyLatches = 256;
+
+  // Return the latch of the given key
+  common::synchronization::SpinLatch &GetKeyLatch(const KeyType &key) {
+    return key_latches_[key_hasher_(key) % kNumKeyLatches];
+  }
+
+  // value equality checker
+  ValueEqualityChecker value_equals;
+
+  // container
+  MapType container;
+
+  // Latches for changing the list of a key, striped by the hash of the key
+  KeyHasher key_hasher_;
+  common::synchronization::SpinLatch key_latches_[kNumKeyLatches];
+
+  // The number of values over all the keys
+  std::atomic<size_t> num_values_;
+};
+
+}  // namespace index
+}  // namespace peloton
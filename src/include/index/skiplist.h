@@ -12,6 +12,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "common/macros.h"
+
 namespace peloton {
 namespace index {
 
@@ -21,10 +31,721 @@ namespace index {
 #define SKIPLIST_TEMPLATE_ARGUMENTS                                       \
   template <typename KeyType, typename ValueType, typename KeyComparator, \
             typename KeyEqualityChecker, typename ValueEqualityChecker>
+
+/*
+ * class SkipList - Lock-free multi-map ordered by key
+ *
+ * Every key-value pair is a node of its own, and the nodes with equal keys
+ * form a run on the bottom level. A new node is always linked in front of
+ * the run of its key, so that all the inserts of a key go through the same
+ * CAS on the bottom level, which is what makes the unique key and the
+ * duplicate pair checks safe under concurrent inserts.
+ *
+ * Nodes are deleted in the usual way: the next pointers of the node are
+ * marked from the top level down to the bottom one, and the thread that
+ * marks the bottom level owns the deletion. Marked nodes are unlinked by
+ * whichever writer passes them first, and the owner makes sure the node is
+ * gone from every level before it hands the node over to the epoch manager.
+ * A node is only freed once no thread that may still hold a pointer to it
+ * is inside the skip list anymore.
+ *
+ * Readers never write to the list. Range scans walk the bottom level, and
+ * reverse scans search for the predecessor of every key they emit, as the
+ * nodes do not have back pointers.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator,
           typename KeyEqualityChecker, typename ValueEqualityChecker>
 class SkipList {
-  // TODO: Add your declarations here
+ public:
+  // Highest level of a node. With a branching factor of 4 this covers
+  // billions of keys before the upper levels get crowded
+  static constexpr uint32_t MAX_HEIGHT = 16;
+
+  // One out of BRANCHING_FACTOR nodes of a level is promoted to the next one
+  static constexpr uint32_t BRANCHING_FACTOR = 4;
+
+  // Number of deleted nodes after which a writer tries to advance the epoch
+  static constexpr size_t GC_THRESHOLD = 1024;
+
+ private:
+  /*
+   * struct Node - A key-value pair together with its tower of next pointers
+   *
+   * The tower is allocated together with the node, so the size of a node
+   * depends on its height. The lowest bit of a next pointer marks the node
+   * as deleted on that level.
+   */
+  struct Node {
+    KeyType key;
+    ValueType value;
+    uint32_t height;
+
+    // Set once the node is linked on all of its levels. Deletes wait for it
+    // so that a node is never linked on a level after it was removed from it
+    std::atomic<bool> fully_linked;
+
+    // Link of the garbage list once the node has been deleted
+    Node *next_garbage;
+
+    std::atomic<Node *> next[1];
+
+    Node(const KeyType &p_key, const ValueType &p_value, uint32_t p_height)
+        : key{p_key},
+          value{p_value},
+          height{p_height},
+          fully_linked{false},
+          next_garbage{nullptr} {}
+  };
+
+  //===--------------------------------------------------------------------===//
+  // Pointer marking
+  //===--------------------------------------------------------------------===//
+
+  static inline bool IsMarked(const Node *node_p) {
+    return (reinterpret_cast<uintptr_t>(node_p) & 0x1) != 0;
+  }
+
+  static inline Node *Marked(const Node *node_p) {
+    return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(node_p) | 0x1);
+  }
+
+  static inline Node *Unmarked(const Node *node_p) {
+    return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(node_p) &
+                                    ~static_cast<uintptr_t>(0x1));
+  }
+
+ public:
+  /*
+   * class EpochManager - Epoch based reclamation of deleted nodes
+   *
+   * Every operation joins the current epoch and leaves it when it is done.
+   * A deleted node is put on the garbage list of the epoch its deleter has
+   * joined. The global epoch only moves from e to e + 1 when no thread is
+   * left in epoch e - 1, and at that point nothing can reach the nodes
+   * deleted in epoch e - 2 anymore, so they are freed. Three epochs are in
+   * use at any time, and the counters and garbage lists are reused round
+   * robin.
+   */
+  class EpochManager {
+   public:
+    EpochManager(SkipList *p_list_p) : list_p{p_list_p}, global_epoch{0} {
+      for (uint32_t i = 0; i < EPOCH_COUNT; i++) {
+        active_thread_count[i] = 0;
+        garbage_list_p[i] = nullptr;
+        garbage_count[i] = 0;
+      }
+      gc_flag.clear();
+    }
+
+    ~EpochManager() {
+      // All the threads have left, so everything can go
+      for (uint32_t i = 0; i < EPOCH_COUNT; i++) {
+        FreeGarbage(i);
+      }
+    }
+
+    /*
+     * JoinEpoch() - Enter the current epoch and return it
+     *
+     * The thread only counts as being in the epoch if the global epoch did
+     * not move while it was registering. Otherwise the epoch manager might
+     * have missed it, so it tries again.
+     */
+    inline uint64_t JoinEpoch() {
+      while (true) {
+        uint64_t epoch = global_epoch.load();
+        active_thread_count[epoch % EPOCH_COUNT].fetch_add(1);
+        if (global_epoch.load() == epoch) {
+          return epoch;
+        }
+        active_thread_count[epoch % EPOCH_COUNT].fetch_sub(1);
+      }
+    }
+
+    inline void LeaveEpoch(uint64_t epoch) {
+      active_thread_count[epoch % EPOCH_COUNT].fetch_sub(1);
+    }
+
+    /*
+     * AddGarbageNode() - Hand over a node that is no longer reachable
+     *
+     * The epoch must be the one the calling thread has joined
+     */
+    void AddGarbageNode(uint64_t epoch, Node *node_p) {
+      uint32_t slot = epoch % EPOCH_COUNT;
+      node_p->next_garbage = garbage_list_p[slot].load();
+      while (garbage_list_p[slot].compare_exchange_weak(
+                 node_p->next_garbage, node_p) == false) {
+      }
+      garbage_count[slot].fetch_add(1);
+    }
+
+    /*
+     * NeedGarbageCollection() - Whether there are nodes waiting to be freed
+     */
+    bool NeedGarbageCollection() const {
+      for (uint32_t i = 0; i < EPOCH_COUNT; i++) {
+        if (garbage_count[i].load() != 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /*
+     * GetGarbageCount() - Number of nodes of the current epoch waiting to be
+     *                     freed
+     */
+    size_t GetGarbageCount() const {
+      return garbage_count[global_epoch.load() % EPOCH_COUNT].load();
+    }
+
+    /*
+     * PerformGarbageCollection() - Try to advance the global epoch
+     *
+     * Only one thread advances the epoch at a time; the others return right
+     * away instead of waiting for it
+     */
+    void PerformGarbageCollection() {
+      if (gc_flag.test_and_set() == true) {
+        return;
+      }
+
+      uint64_t epoch = global_epoch.load();
+      if (active_thread_count[(epoch + EPOCH_COUNT - 1) % EPOCH_COUNT]
+              .load() == 0) {
+        // The garbage of epoch - 2 shares its slot with epoch + 1
+        FreeGarbage((epoch + 1) % EPOCH_COUNT);
+        global_epoch.store(epoch + 1);
+      }
+
+      gc_flag.clear();
+    }
+
+   private:
+    static constexpr uint32_t EPOCH_COUNT = 3;
+
+    void FreeGarbage(uint32_t slot) {
+      Node *node_p = garbage_list_p[slot].exchange(nullptr);
+      while (node_p != nullptr) {
+        Node *next_p = node_p->next_garbage;
+        list_p->FreeNode(node_p);
+        node_p = next_p;
+      }
+      garbage_count[slot] = 0;
+    }
+
+    SkipList *list_p;
+
+    std::atomic<uint64_t> global_epoch;
+
+    std::atomic<int64_t> active_thread_count[EPOCH_COUNT];
+
+    std::atomic<Node *> garbage_list_p[EPOCH_COUNT];
+
+    std::atomic<size_t> garbage_count[EPOCH_COUNT];
+
+    // Held by the thread advancing the epoch
+    std::atomic_flag gc_flag;
+  };
+
+  /*
+   * class EpochGuard - Keeps the calling thread in an epoch for its scope
+   */
+  class EpochGuard {
+   public:
+    EpochGuard(EpochManager &p_epoch_manager)
+        : epoch_manager(p_epoch_manager),
+          epoch{p_epoch_manager.JoinEpoch()} {}
+
+    ~EpochGuard() { epoch_manager.LeaveEpoch(epoch); }
+
+    uint64_t GetEpoch() const { return epoch; }
+
+   private:
+    EpochManager &epoch_manager;
+    uint64_t epoch;
+  };
+
+ public:
+  SkipList(const KeyComparator &p_key_cmp_obj = KeyComparator{},
+           const KeyEqualityChecker &p_key_eq_obj = KeyEqualityChecker{},
+           const ValueEqualityChecker &p_value_eq_obj = ValueEqualityChecker{})
+      : key_cmp_obj{p_key_cmp_obj},
+        key_eq_obj{p_key_eq_obj},
+        value_eq_obj{p_value_eq_obj},
+        memory_footprint{0},
+        current_height{1},
+        epoch_manager{this} {
+    head_p = AllocateNode(KeyType{}, ValueType{}, MAX_HEIGHT);
+  }
+
+  ~SkipList() {
+    // Nodes still linked on the bottom level were never handed over to the
+    // epoch manager, which frees the deleted ones itself
+    Node *node_p = head_p;
+    while (node_p != nullptr) {
+      Node *next_p = Unmarked(node_p->next[0].load());
+      FreeNode(node_p);
+      node_p = next_p;
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Modifications
+  //===--------------------------------------------------------------------===//
+
+  /*
+   * Insert() - Insert a key-value pair
+   *
+   * Returns false if the pair already exists, or if unique_key is set and
+   * there is already a value for the key
+   */
+  bool Insert(const KeyType &key, const ValueType &value, bool unique_key) {
+    return ConditionalInsert(key, value, unique_key,
+                             [](const ValueType &) { return false; }, nullptr);
+  }
+
+  /*
+   * ConditionalInsert() - Insert a key-value pair unless one of the values of
+   *                       the key satisfies the predicate
+   *
+   * predicate_satisfied, if given, tells whether the insert failed because of
+   * the predicate
+   */
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         bool unique_key,
+                         std::function<bool(const ValueType &)> predicate,
+                         bool *predicate_satisfied) {
+    EpochGuard guard{epoch_manager};
+
+    if (predicate_satisfied != nullptr) {
+      *predicate_satisfied = false;
+    }
+
+    Node *preds[MAX_HEIGHT];
+    Node *succs[MAX_HEIGHT];
+    Node *node_p = nullptr;
+
+    while (true) {
+      FindPosition(key, preds, succs);
+
+      // Every insert of this key has to CAS the bottom level link in front
+      // of the run, so the run cannot change unnoticed while we check it
+      for (Node *run_p = succs[0];
+           run_p != nullptr && KeyCmpEqual(run_p->key, key);
+           run_p = Unmarked(run_p->next[0].load())) {
+        if (IsMarked(run_p->next[0].load()) == true) {
+          continue;
+        }
+
+        bool satisfied = predicate(run_p->value);
+        if (satisfied == true || unique_key == true ||
+            value_eq_obj(run_p->value, value) == true) {
+          if (predicate_satisfied != nullptr) {
+            *predicate_satisfied = satisfied;
+          }
+          if (node_p != nullptr) {
+            FreeNode(node_p);
+          }
+          return false;
+        }
+      }
+
+      if (node_p == nullptr) {
+        node_p = AllocateNode(key, value, RandomHeight());
+      }
+
+      node_p->next[0].store(succs[0]);
+      Node *expected_p = succs[0];
+      if (preds[0]->next[0].compare_exchange_strong(expected_p, node_p) ==
+          true) {
+        break;
+      }
+    }
+
+    // The pair is in from now on; the upper levels only speed up searches
+    for (uint32_t level = 1; level < node_p->height; level++) {
+      while (true) {
+        node_p->next[level].store(succs[level]);
+        Node *expected_p = succs[level];
+        if (preds[level]->next[level].compare_exchange_strong(
+                expected_p, node_p) == true) {
+          break;
+        }
+        FindPosition(key, preds, succs);
+      }
+    }
+
+    node_p->fully_linked.store(true);
+    return true;
+  }
+
+  /*
+   * Delete() - Remove a key-value pair
+   *
+   * Returns false if the pair does not exist
+   */
+  bool Delete(const KeyType &key, const ValueType &value) {
+    EpochGuard guard{epoch_manager};
+
+    Node *preds[MAX_HEIGHT];
+    Node *succs[MAX_HEIGHT];
+    FindPosition(key, preds, succs);
+
+    Node *node_p = succs[0];
+    while (node_p != nullptr && KeyCmpEqual(node_p->key, key)) {
+      if (IsMarked(node_p->next[0].load()) == false &&
+          value_eq_obj(node_p->value, value) == true) {
+        break;
+      }
+      node_p = Unmarked(node_p->next[0].load());
+    }
+
+    if (node_p == nullptr || KeyCmpEqual(node_p->key, key) == false) {
+      return false;
+    }
+
+    while (node_p->fully_linked.load() == false) {
+      std::this_thread::yield();
+    }
+
+    // The upper levels first, so that the node stays reachable for whoever
+    // unlinks it from the bottom level
+    for (uint32_t level = node_p->height - 1; level > 0; level--) {
+      Node *next_p = node_p->next[level].load();
+      while (IsMarked(next_p) == false &&
+             node_p->next[level].compare_exchange_weak(
+                 next_p, Marked(next_p)) == false) {
+      }
+    }
+
+    // Whoever marks the bottom level has deleted the pair
+    Node *next_p = node_p->next[0].load();
+    while (true) {
+      if (IsMarked(next_p) == true) {
+        return false;
+      }
+      if (node_p->next[0].compare_exchange_weak(next_p, Marked(next_p)) ==
+          true) {
+        break;
+      }
+    }
+
+    UnlinkNode(node_p);
+    epoch_manager.AddGarbageNode(guard.GetEpoch(), node_p);
+
+    if (epoch_manager.GetGarbageCount() >= GC_THRESHOLD) {
+      epoch_manager.PerformGarbageCollection();
+    }
+    return true;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Lookups
+  //===--------------------------------------------------------------------===//
+
+  /*
+   * GetValue() - Append all the values of a key to the result
+   */
+  void GetValue(const KeyType &key, std::vector<ValueType> &result) {
+    EpochGuard guard{epoch_manager};
+
+    for (Node *node_p = FindGreaterOrEqual(&key);
+         node_p != nullptr && KeyCmpEqual(node_p->key, key);
+         node_p = Unmarked(node_p->next[0].load())) {
+      if (IsMarked(node_p->next[0].load()) == false) {
+        result.push_back(node_p->value);
+      }
+    }
+  }
+
+  /*
+   * ForwardScan() - Visit the pairs in [low_key, high_key] in ascending key
+   *                 order until the callback returns false
+   *
+   * A nullptr bound leaves that end of the range open
+   */
+  void ForwardScan(const KeyType *low_key_p, const KeyType *high_key_p,
+                   std::function<bool(const ValueType &)> callback) {
+    EpochGuard guard{epoch_manager};
+
+    for (Node *node_p = FindGreaterOrEqual(low_key_p); node_p != nullptr;
+         node_p = Unmarked(node_p->next[0].load())) {
+      if (high_key_p != nullptr && KeyCmpLess(*high_key_p, node_p->key)) {
+        break;
+      }
+      if (IsMarked(node_p->next[0].load()) == true) {
+        continue;
+      }
+      if (callback(node_p->value) == false) {
+        break;
+      }
+    }
+  }
+
+  /*
+   * ReverseScan() - Visit the pairs in [low_key, high_key] in descending key
+   *                 order until the callback returns false
+   *
+   * Each key costs one predecessor search and one search for the start of
+   * its run
+   */
+  void ReverseScan(const KeyType *low_key_p, const KeyType *high_key_p,
+                   std::function<bool(const ValueType &)> callback) {
+    EpochGuard guard{epoch_manager};
+
+    std::vector<ValueType> run;
+    Node *last_p = FindLast(high_key_p, true);
+    while (last_p != nullptr) {
+      const KeyType &key = last_p->key;
+      if (low_key_p != nullptr && KeyCmpLess(key, *low_key_p)) {
+        break;
+      }
+
+      // The run is singly linked, so collect it before emitting it backwards
+      run.clear();
+      for (Node *node_p = FindGreaterOrEqual(&key);
+           node_p != nullptr && KeyCmpEqual(node_p->key, key);
+           node_p = Unmarked(node_p->next[0].load())) {
+        if (IsMarked(node_p->next[0].load()) == false) {
+          run.push_back(node_p->value);
+        }
+      }
+      for (auto it = run.rbegin(); it != run.rend(); ++it) {
+        if (callback(*it) == false) {
+          return;
+        }
+      }
+
+      last_p = FindLast(&key, false);
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Maintenance
+  //===--------------------------------------------------------------------===//
+
+  size_t GetMemoryFootprint() const { return memory_footprint.load(); }
+
+  bool NeedGarbageCollection() const {
+    return epoch_manager.NeedGarbageCollection();
+  }
+
+  void PerformGarbageCollection() { epoch_manager.PerformGarbageCollection(); }
+
+  inline bool KeyCmpLess(const KeyType &key1, const KeyType &key2) const {
+    return key_cmp_obj(key1, key2);
+  }
+
+  inline bool KeyCmpEqual(const KeyType &key1, const KeyType &key2) const {
+    return key_eq_obj(key1, key2);
+  }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // Node management
+  //===--------------------------------------------------------------------===//
+
+  Node *AllocateNode(const KeyType &key, const ValueType &value,
+                     uint32_t height) {
+    size_t size = NodeSize(height);
+    void *memory = ::operator new(size);
+    Node *node_p = new (memory) Node{key, value, height};
+    for (uint32_t level = 0; level < height; level++) {
+      new (&node_p->next[level]) std::atomic<Node *>{nullptr};
+    }
+    memory_footprint.fetch_add(size);
+    return node_p;
+  }
+
+  void FreeNode(Node *node_p) {
+    memory_footprint.fetch_sub(NodeSize(node_p->height));
+    node_p->~Node();
+    ::operator delete(node_p);
+  }
+
+  static inline size_t NodeSize(uint32_t height) {
+    return sizeof(Node) + (height - 1) * sizeof(std::atomic<Node *>);
+  }
+
+  /*
+   * RandomHeight() - Pick the height of a new node
+   *
+   * Also raises the height searches start from, which never shrinks
+   */
+  uint32_t RandomHeight() {
+    static thread_local std::minstd_rand generator{std::random_device{}()};
+
+    uint32_t height = 1;
+    while (height < MAX_HEIGHT && generator() % BRANCHING_FACTOR == 0) {
+      height++;
+    }
+
+    uint32_t old_height = current_height.load();
+    while (height > old_height &&
+           current_height.compare_exchange_weak(old_height, height) == false) {
+    }
+    return height;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Searches
+  //===--------------------------------------------------------------------===//
+
+  /*
+   * FindPosition() - Find the last node before the key and the first one
+   *                  not before it on every level
+   *
+   * Marked nodes on the way are unlinked. Levels above the current height
+   * get the head and nullptr.
+   */
+  void FindPosition(const KeyType &key, Node **preds, Node **succs) {
+  retry:
+    uint32_t height = current_height.load();
+    for (uint32_t level = height; level < MAX_HEIGHT; level++) {
+      preds[level] = head_p;
+      succs[level] = Unmarked(head_p->next[level].load());
+    }
+
+    Node *pred_p = head_p;
+    for (int level = height - 1; level >= 0; level--) {
+      Node *curr_p = pred_p->next[level].load();
+      if (IsMarked(curr_p) == true) {
+        // The predecessor got deleted under us
+        goto retry;
+      }
+
+      while (curr_p != nullptr) {
+        Node *next_p = curr_p->next[level].load();
+        if (IsMarked(next_p) == true) {
+          Node *expected_p = curr_p;
+          if (pred_p->next[level].compare_exchange_strong(
+                  expected_p, Unmarked(next_p)) == false) {
+            goto retry;
+          }
+          curr_p = Unmarked(next_p);
+          continue;
+        }
+
+        if (KeyCmpLess(curr_p->key, key) == false) {
+          break;
+        }
+        pred_p = curr_p;
+        curr_p = next_p;
+      }
+
+      preds[level] = pred_p;
+      succs[level] = curr_p;
+    }
+  }
+
+  /*
+   * UnlinkNode() - Make sure a deleted node is unreachable on all levels
+   *
+   * The node is looked for within the run of its key on every level, as it
+   * need not be at the front of the run.
+   */
+  void UnlinkNode(Node *node_p) {
+    Node *preds[MAX_HEIGHT];
+    Node *succs[MAX_HEIGHT];
+
+    for (int level = node_p->height - 1; level >= 0; level--) {
+      bool unlinked = false;
+      while (unlinked == false) {
+        FindPosition(node_p->key, preds, succs);
+
+        Node *pred_p = preds[level];
+        Node *curr_p = succs[level];
+        unlinked = true;
+        while (curr_p != nullptr && KeyCmpEqual(curr_p->key, node_p->key)) {
+          Node *next_p = curr_p->next[level].load();
+          if (IsMarked(next_p) == false) {
+            pred_p = curr_p;
+            curr_p = next_p;
+            continue;
+          }
+
+          // Help with the other deleted nodes of the run on the way, so
+          // that the predecessor is never a marked node
+          Node *expected_p = curr_p;
+          if (pred_p->next[level].compare_exchange_strong(
+                  expected_p, Unmarked(next_p)) == false) {
+            unlinked = false;
+            break;
+          }
+          if (curr_p == node_p) {
+            break;
+          }
+          curr_p = Unmarked(next_p);
+        }
+      }
+    }
+  }
+
+  /*
+   * FindGreaterOrEqual() - The first node on the bottom level whose key is
+   *                        not less than the given one
+   *
+   * A nullptr key stands for the smallest key. Read only, so deleted nodes
+   * may be passed but are never unlinked here.
+   */
+  Node *FindGreaterOrEqual(const KeyType *key_p) const {
+    if (key_p == nullptr) {
+      return Unmarked(head_p->next[0].load());
+    }
+
+    Node *pred_p = head_p;
+    for (int level = current_height.load() - 1; level >= 0; level--) {
+      Node *curr_p = Unmarked(pred_p->next[level].load());
+      while (curr_p != nullptr && KeyCmpLess(curr_p->key, *key_p)) {
+        pred_p = curr_p;
+        curr_p = Unmarked(curr_p->next[level].load());
+      }
+      if (level == 0) {
+        return curr_p;
+      }
+    }
+    return nullptr;
+  }
+
+  /*
+   * FindLast() - The last node on the bottom level whose key is less than
+   *              (or equal to, if inclusive) the given one
+   *
+   * A nullptr key stands for the largest key. Returns nullptr if there is no
+   * such node.
+   */
+  Node *FindLast(const KeyType *key_p, bool inclusive) const {
+    Node *pred_p = head_p;
+    for (int level = current_height.load() - 1; level >= 0; level--) {
+      Node *curr_p = Unmarked(pred_p->next[level].load());
+      while (curr_p != nullptr &&
+             (key_p == nullptr ||
+              (inclusive ? !KeyCmpLess(*key_p, curr_p->key)
+                         : KeyCmpLess(curr_p->key, *key_p)))) {
+        pred_p = curr_p;
+        curr_p = Unmarked(curr_p->next[level].load());
+      }
+    }
+    return pred_p == head_p ? nullptr : pred_p;
+  }
+
+ private:
+  KeyComparator key_cmp_obj;
+  KeyEqualityChecker key_eq_obj;
+  ValueEqualityChecker value_eq_obj;
+
+  // Bytes held by the nodes, including the ones waiting to be freed
+  std::atomic<size_t> memory_footprint;
+
+  // Sentinel of all levels; its key and value are never looked at
+  Node *head_p;
+
+  // Highest level any node has reached so far
+  std::atomic<uint32_t> current_height;
+
+  EpochManager epoch_manager;
 };
 
 }  // namespace index
@@ -40,9 +40,6 @@ template <typename KeyType, typename ValueType, typename KeyComparator,
 class SkipListIndex : public Index {
   friend class IndexFactory;
 
-  // typedef SkipList<KeyType, ValueType, KeyComparator, KeyEqualityChecker,
-  // ValueEqualityChecker> MapType;
-
   using MapType = SkipList<KeyType, ValueType, KeyComparator,
                            KeyEqualityChecker, ValueEqualityChecker>;
 
@@ -78,14 +75,14 @@ class SkipListIndex : public Index {
 
   std::string GetTypeName() const;
 
-  // TODO: Implement this
-  size_t GetMemoryFootprint() { return 0; }
+  size_t GetMemoryFootprint() { return container.GetMemoryFootprint(); }
 
-  // TODO: Implement this
-  bool NeedGC() { return false; }
+  bool NeedGC() { return container.NeedGarbageCollection(); }
 
-  // TODO: Implement this
-  void PerformGC() { return; }
+  void PerformGC() {
+    container.PerformGarbageCollection();
+    return;
+  }
 
  protected:
   // equality checker and comparator
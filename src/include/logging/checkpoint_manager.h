@@ -55,9 +55,11 @@ class CheckpointManager {
 
   virtual void StopCheckpointing() {}
 
-  virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
+  virtual void RegisterTable(const oid_t &database_id UNUSED_ATTRIBUTE,
+                             const oid_t &table_id UNUSED_ATTRIBUTE) {}
 
-  virtual void DeregisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
+  virtual void DeregisterTable(const oid_t &database_id UNUSED_ATTRIBUTE,
+                               const oid_t &table_id UNUSED_ATTRIBUTE) {}
 
   virtual size_t GetTableCount() { return 0; }
 
@@ -52,6 +52,8 @@ public:
 
   inline bool Empty() { return size_ == 0; }
 
+  static inline size_t GetCapacity() { return log_buffer_capacity_; }
+
   bool WriteData(const char *data, size_t len);
 
 private:
@@ -44,7 +44,7 @@ class LogManager {
     return log_manager;
   }
 
-  void Reset() { is_running_ = false; }
+  virtual void Reset() { is_running_ = false; }
 
   // Get status of whether logging threads are running or not
   bool GetStatus() { return this->is_running_; }
@@ -61,10 +61,18 @@ class LogManager {
 
   virtual size_t GetTableCount() { return 0; }
 
-  virtual void LogBegin() {}
+  virtual void LogBegin(const cid_t &commit_id UNUSED_ATTRIBUTE) {}
 
   virtual void LogEnd() {}
 
+  // block until the transaction that the current thread committed last is
+  // durable. returns false if the log failed to persist it.
+  virtual bool WaitForPersistence() { return true; }
+
+  // whether the log failed to persist its records. once it has, no commit
+  // can be acknowledged anymore.
+  virtual bool HasFailed() { return false; }
+
   virtual void LogInsert(const ItemPointer & UNUSED_ATTRIBUTE) {}
   
   virtual void LogUpdate(const ItemPointer & UNUSED_ATTRIBUTE) {}
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logging_util.h
+//
+// Identification: src/include/logging/logging_util.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// LoggingUtil
+//===--------------------------------------------------------------------===//
+
+class LoggingUtil {
+ public:
+  //===--------------------------------------------------------------------===//
+  // File system related operations
+  //===--------------------------------------------------------------------===//
+
+  static bool CreateDirectory(const char *dir_name, int mode);
+
+  static bool CheckDirectoryExistence(const char *dir_name);
+
+  // remove the directory. if only_remove_file is true, then only the files
+  // inside the directory are removed and the directory itself is kept.
+  static bool RemoveDirectory(const char *dir_name, bool only_remove_file);
+
+  // get the names of all the files in the directory whose names start with
+  // the given prefix.
+  static bool GetDirectoryList(const char *dir_name, const std::string &prefix,
+                               std::vector<std::string> &files);
+
+  // atomically rename a file or a directory.
+  static bool RenameFile(const char *old_name, const char *new_name);
+
+  // force the entries of the directory, such as created or renamed files,
+  // to the disk.
+  static bool FsyncDirectory(const char *dir_name);
+
+  static bool OpenFile(const char *name, const char *mode,
+                       FileHandle &file_handle);
+
+  static bool CloseFile(FileHandle &file_handle);
+
+  // flush the user-space buffer of the file and force it to the disk.
+  // returns false if the data may not have reached the disk.
+  static bool FFlushFsync(FileHandle &file_handle);
+
+  static bool IsFileTruncated(FileHandle &file_handle, size_t size_to_read);
+
+  static size_t GetFileSize(FileHandle &file_handle);
+
+  static bool ReadNBytesFromFile(FileHandle &file_handle, void *bytes_read,
+                                 size_t n);
+};
+
+}  // namespace logging
+}  // namespace peloton
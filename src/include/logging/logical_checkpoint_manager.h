@@ -12,15 +12,63 @@
 
 #pragma once
 
+#include <atomic>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "common/synchronization/readwrite_latch.h"
+#include "common/synchronization/spin_latch.h"
 #include "logging/checkpoint_manager.h"
+#include "type/serializeio.h"
 
 namespace peloton {
+
+namespace concurrency {
+class TransactionContext;
+}  // namespace concurrency
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}  // namespace storage
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
 // logical checkpoint Manager
 //===--------------------------------------------------------------------===//
 
+/**
+ * checkpoint directory layout :
+ *
+ * dir_name + "/" + "checkpoint_" + commit_id + "/" +
+ *   "table_" + database_id + "_" + table_id
+ *
+ * checkpoint file layout :
+ *
+ *  -----------------------------------------------------------------------
+ *  | tile_group_id | tuple_count | tuple_slot | values | tuple_slot | ...
+ *  -----------------------------------------------------------------------
+ *
+ * A checkpoint is a snapshot of all the registered tables, including the
+ * catalog tables, as of a commit id. It is taken by a read-only snapshot
+ * transaction, so a tuple version is written iff it is visible at that
+ * commit id according to its begin and end commit ids. Writers are never
+ * blocked, and the transaction keeps the GC from reclaiming the versions it
+ * still has to read.
+ *
+ * Only the tile groups that have visible tuples are written, and every tuple
+ * keeps its tile group id and slot, so that the log records that follow the
+ * checkpoint refer to the same locations after recovery.
+ *
+ * The files are first written into "tmp_checkpoint_" + commit_id, which is
+ * renamed once all of them are durable. The directories are forced to the
+ * disk around the rename. Recovery hence only ever sees complete
+ * checkpoints, and must replay the transactions whose commit id is larger
+ * than the one of the checkpoint. Once a checkpoint is durable, the log files
+ * and pepoch entries that it covers are removed.
+ */
 class LogicalCheckpointManager : public CheckpointManager {
  public:
   LogicalCheckpointManager(const LogicalCheckpointManager &) = delete;
@@ -28,7 +76,12 @@ class LogicalCheckpointManager : public CheckpointManager {
   LogicalCheckpointManager(LogicalCheckpointManager &&) = delete;
   LogicalCheckpointManager &operator=(LogicalCheckpointManager &&) = delete;
 
-  LogicalCheckpointManager(const int thread_count) : checkpointer_thread_count_(thread_count) {}
+  LogicalCheckpointManager(const int thread_count)
+      : checkpointer_thread_count_(thread_count),
+        checkpoint_interval_(30),
+        checkpoint_dir_("./peloton_checkpoint"),
+        checkpointer_thread_(nullptr),
+        last_checkpoint_cid_(INVALID_CID) {}
 
   virtual ~LogicalCheckpointManager() {}
 
@@ -37,23 +90,109 @@ class LogicalCheckpointManager : public CheckpointManager {
     return checkpoint_manager;
   }
 
-  virtual void Reset() { is_running_ = false; }
+  // set the directory of the checkpoints.
+  // if it does not exist, then create the directory. the incomplete
+  // checkpoints left behind by a crash are removed.
+  void SetDirectory(const std::string &checkpoint_dir);
+
+  const std::string &GetDirectory() { return checkpoint_dir_; }
+
+  // the number of seconds between two checkpoints.
+  void SetCheckpointInterval(const int checkpoint_interval) {
+    checkpoint_interval_ = checkpoint_interval;
+  }
+
+  virtual void Reset() override;
+
+  virtual void StartCheckpointing() override;
+
+  virtual void StopCheckpointing() override;
+
+  virtual void RegisterTable(const oid_t &database_id,
+                             const oid_t &table_id) override;
+
+  // waits until no tile group of the table is being checkpointed.
+  virtual void DeregisterTable(const oid_t &database_id,
+                               const oid_t &table_id) override;
+
+  virtual size_t GetTableCount() override;
+
+  // take a checkpoint of all the registered tables, and remove the older
+  // checkpoints. return the commit id of the checkpoint, or INVALID_CID if
+  // it failed.
+  cid_t DoCheckpoint();
+
+  cid_t GetLastCheckpointCommitId() const {
+    return last_checkpoint_cid_.load();
+  }
+
+  std::string GetCheckpointDirFullPath(const cid_t commit_id) const {
+    return checkpoint_dir_ + "/" + checkpoint_dir_prefix_ +
+           std::to_string(commit_id);
+  }
+
+  static std::string GetCheckpointFileName(const oid_t database_id,
+                                           const oid_t table_id) {
+    return "table_" + std::to_string(database_id) + "_" +
+           std::to_string(table_id);
+  }
+
+ private:
+  void Run();
+
+  std::string GetWorkingCheckpointDirFullPath(const cid_t commit_id) const {
+    return checkpoint_dir_ + "/tmp_" + checkpoint_dir_prefix_ +
+           std::to_string(commit_id);
+  }
 
-  virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> & UNUSED_ATTRIBUTE) {}
+  // checkpoint every thread_count-th table starting from thread_id.
+  bool CheckpointTables(
+      const std::vector<std::pair<oid_t, oid_t>> &tables,
+      const size_t thread_id, const size_t thread_count,
+      concurrency::TransactionContext *txn, const std::string &dir);
 
-  virtual void StartLogging() {}
+  bool IsTableRegistered(const oid_t database_id, const oid_t table_id);
 
-  virtual void StopLogging() {}
+  bool CheckpointTable(const oid_t database_id, const oid_t table_id,
+                       concurrency::TransactionContext *txn,
+                       const std::string &dir);
 
-  virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
+  // serialize the tuples of the tile group that are visible to the
+  // transaction. return false if there are none.
+  bool CheckpointTileGroup(storage::TileGroup *tile_group,
+                           concurrency::TransactionContext *txn,
+                           CopySerializeOutput &output);
 
-  virtual void DeregisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
+  // remove the checkpoints that are older than the given one.
+  void RemoveOldCheckpoints(const cid_t commit_id);
 
-  virtual size_t GetTableCount() { return 0; }
+  // remove the working directories of the checkpoints that never completed.
+  void RemoveWorkingCheckpoints();
 
  private:
   int checkpointer_thread_count_;
 
+  int checkpoint_interval_;
+
+  std::string checkpoint_dir_;
+
+  std::unique_ptr<std::thread> checkpointer_thread_;
+
+  std::atomic<cid_t> last_checkpoint_cid_;
+
+  // protects the set of registered tables.
+  common::synchronization::SpinLatch tables_lock_;
+
+  std::set<std::pair<oid_t, oid_t>> tables_;
+
+  // held in read mode while a tile group is being checkpointed, and in write
+  // mode while a table is deregistered, so that a table is never dropped
+  // while it is being read.
+  common::synchronization::ReadWriteLatch checkpoint_latch_;
+
+  const std::string checkpoint_dir_prefix_ = "checkpoint_";
+
+  const int sleep_period_ms_ = 100;
 };
 
 }  // namespace logging
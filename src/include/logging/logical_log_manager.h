@@ -12,7 +12,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/synchronization/spin_latch.h"
 #include "logging/log_manager.h"
+#include "logging/log_record.h"
+#include "logging/logical_logger.h"
+#include "logging/worker_context.h"
 
 namespace peloton {
 namespace logging {
@@ -24,8 +36,8 @@ namespace logging {
 
 /**
  * logging file name layout :
- * 
- * dir_name + "/" + prefix + "_" + epoch_id
+ *
+ * dir_name + "/" + prefix + "_" + logger_id + "_" + epoch_id
  *
  *
  * logging file layout :
@@ -38,6 +50,40 @@ namespace logging {
  *
  * NOTE: tuple length can be obtained from the table schema.
  *
+ * Every record is prefixed with its length and its LogRecordType:
+ *
+ *  TRANSACTION_BEGIN/COMMIT : commit_id
+ *  TUPLE_INSERT             : database_id | table_id | location | values
+ *  TUPLE_UPDATE             : database_id | table_id | old_location |
+ *                             location | values
+ *  TUPLE_DELETE             : database_id | table_id | location
+ *  EPOCH_BEGIN/END          : epoch_id
+ *
+ * The records of each worker are buffered in its LogBuffers, tagged with the
+ * epoch during which they were written. In group-commit mode the logger only
+ * persists an epoch once no worker can write to it anymore, and a single
+ * fsync covers every transaction of all the epochs it writes. In
+ * synchronous mode every commit forces its own records to the disk, and an
+ * epoch is persisted once every worker has left it.
+ *
+ * The workers are spread over several loggers, each with its own thread and
+ * its own directory, so that the log can be striped across devices. Logger i
+ * writes into directory i modulo the number of directories, and worker w is
+ * drained by logger w modulo the number of loggers. As the loggers progress
+ * independently, a transaction is only durable once every logger has
+ * persisted its epoch. The pepoch thread periodically appends the smallest
+ * epoch persisted by all the loggers to the pepoch file, which lives in the
+ * first directory:
+ *
+ * pepoch file layout :
+ *
+ *  -----------------------------------
+ *  | epoch_id | epoch_id | ... (uint64)
+ *  -----------------------------------
+ *
+ * The last complete entry of the file is the persistent epoch. Recovery must
+ * ignore every epoch beyond it, so a commit is only acknowledged once the
+ * persistent epoch has reached the epoch of the transaction.
  */
 
 class LogicalLogManager : public LogManager {
@@ -47,7 +93,15 @@ class LogicalLogManager : public LogManager {
   LogicalLogManager(LogicalLogManager &&) = delete;
   LogicalLogManager &operator=(LogicalLogManager &&) = delete;
 
-  LogicalLogManager(const int thread_count) : logger_thread_count_(thread_count) {}
+  LogicalLogManager(const int thread_count)
+      : logger_thread_count_(thread_count),
+        sync_commit_(false),
+        worker_count_(0),
+        worker_generation_(1),
+        is_pepoch_running_(false),
+        pepoch_handle_(),
+        persist_epoch_id_(INVALID_EID),
+        has_failed_(false) {}
 
   virtual ~LogicalLogManager() {}
 
@@ -56,73 +110,136 @@ class LogicalLogManager : public LogManager {
     return log_manager;
   }
 
-  // virtual void SetDirectories(const std::vector<std::string> &logging_dirs) override {
-  //   logger_dirs_ = logging_dirs;
+  // set the directories of the log files, and create one logger per
+  // directory, or per logger thread if there are fewer directories.
+  // if a directory does not exist, then create it.
+  void SetDirectories(const std::vector<std::string> &logging_dirs);
+
+  const std::vector<std::string> &GetDirectories() { return logger_dirs_; }
+
+  size_t GetLoggerCount() const { return loggers_.size(); }
+
+  std::string GetPepochFileFullPath() const {
+    return pepoch_dir_ + "/" + pepoch_filename_;
+  }
+
+  // force the log to the disk at every commit rather than once per group of
+  // epochs. must be set before the logging starts.
+  void SetSyncCommit(const bool sync_commit) { sync_commit_ = sync_commit; }
+
+  bool IsSyncCommit() const { return sync_commit_; }
+
+  // the largest epoch whose transactions are durable on all the loggers.
+  size_t GetPersistEpochId() const { return persist_epoch_id_.load(); }
+
+  // drop the parts of the log that a checkpoint made obsolete: the log files
+  // that only contain epochs older than epoch_id, and all the entries of the
+  // pepoch file but the last one. only done while logging is running.
+  void RemoveLogsBefore(const eid_t epoch_id);
+
+  virtual void Reset() override;
+
+  virtual void StartLogging() override;
 
-  //   if (logging_dirs.size() > 0) {
-  //     pepoch_dir_ = logging_dirs.at(0);
-  //   }
-  //   // check the existence of logging directories.
-  //   // if not exists, then create the directory.
-  //   for (auto logging_dir : logging_dirs) {
-  //     if (LoggingUtil::CheckDirectoryExistence(logging_dir.c_str()) == false) {
-  //       LOG_INFO("Logging directory %s is not accessible or does not exist", logging_dir.c_str());
-  //       bool res = LoggingUtil::CreateDirectory(logging_dir.c_str(), 0700);
-  //       if (res == false) {
-  //         LOG_ERROR("Cannot create directory: %s", logging_dir.c_str());
-  //       }
-  //     }
-  //   }
+  virtual void StopLogging() override;
 
-  //   logger_count_ = logging_dirs.size();
-  //   for (size_t i = 0; i < logger_count_; ++i) {
-  //     loggers_.emplace_back(new PhyLogLogger(i, logging_dirs.at(i)));
-  //   }
-  // }
+  virtual void LogBegin(const cid_t &commit_id) override;
 
-  // virtual const std::vector<std::string> &GetDirectories() override {
-  //   return logger_dirs_;
-  // }
+  virtual void LogEnd() override;
 
+  virtual bool WaitForPersistence() override;
 
-  virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> & UNUSED_ATTRIBUTE) override {}
+  virtual bool HasFailed() override { return has_failed_.load(); }
 
-  virtual void StartLogging() override {}
+  // stop acknowledging commits, and wake up the waiting ones.
+  void SetFailed();
 
-  virtual void StopLogging() override {}
+  virtual void LogInsert(const ItemPointer &tuple_pos) override;
 
-  virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) override {}
+  virtual void LogUpdate(const ItemPointer &tuple_pos) override;
 
-  virtual void DeregisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) override {}
+  virtual void LogDelete(const ItemPointer &tuple_pos_deleted) override;
 
-  virtual size_t GetTableCount() override { return 0; }
+ private:
+  // get the logging context of the current thread, registering a new worker
+  // if the thread has not logged anything yet.
+  WorkerContext *GetWorkerContext();
+
+  // get the logging context of the current thread if it is in the middle of
+  // logging a transaction, and nullptr otherwise.
+  WorkerContext *GetActiveWorkerContext();
+
+  void WriteRecordToBuffer(WorkerContext *worker_ctx, LogRecord &record);
 
-  virtual void LogBegin() override {}
+  // hand the current buffer of the worker over to the logger.
+  void SealCurrentBuffer(WorkerContext *worker_ctx);
+
+  LogicalLogger *GetLogger(WorkerContext *worker_ctx) {
+    return loggers_[worker_ctx->worker_id % loggers_.size()].get();
+  }
 
-  virtual void LogEnd() override {}
+  void RunPepochLogger();
 
-  virtual void LogInsert(const ItemPointer & UNUSED_ATTRIBUTE) override {}
-  
-  virtual void LogUpdate(const ItemPointer & UNUSED_ATTRIBUTE) override {}
-  
-  virtual void LogDelete(const ItemPointer & UNUSED_ATTRIBUTE) override { }
+  // the smallest epoch persisted by all the loggers.
+  eid_t GetMinPersistEpochId();
+
+  // persist the smallest epoch persisted by all the loggers, if it is newer
+  // than the persistent epoch.
+  void AdvancePepoch();
+
+  // append the epoch to the pepoch file and force it to the disk.
+  void PersistPepoch(const eid_t epoch_id);
+
+  // replace the pepoch file with one that only holds the persistent epoch.
+  void TruncatePepoch();
 
  private:
   int logger_thread_count_;
 
-  // std::atomic<oid_t> worker_count_;
+  bool sync_commit_;
+
+  std::atomic<oid_t> worker_count_;
+
+  // incremented whenever the workers are reset, so that threads can tell
+  // that their cached worker context is stale.
+  std::atomic<size_t> worker_generation_;
+
+  common::synchronization::SpinLatch worker_lock_;
+
+  std::vector<std::shared_ptr<WorkerContext>> worker_ctxs_;
+
+  std::vector<std::string> logger_dirs_;
+
+  std::vector<std::unique_ptr<LogicalLogger>> loggers_;
+
+  /* Persistent epoch related */
+  std::string pepoch_dir_;
+
+  std::unique_ptr<std::thread> pepoch_thread_;
+  volatile bool is_pepoch_running_;
+
+  // serializes the writes to the pepoch file, which may come from the pepoch
+  // thread or from committing workers in synchronous mode.
+  std::mutex pepoch_lock_;
+  FileHandle pepoch_handle_;
 
-  // std::vector<std::string> logger_dirs_;
+  // the epoch most recently written to the pepoch file.
+  std::atomic<size_t> persist_epoch_id_;
 
-  // std::vector<std::shared_ptr<PhyLogLogger>> loggers_;
+  // whether writing the log or the pepoch file has failed.
+  std::atomic<bool> has_failed_;
 
-  // std::unique_ptr<std::thread> pepoch_thread_;
-  // volatile bool is_running_;
+  // committing workers wait on this until the persistent epoch reaches
+  // their own epoch.
+  std::mutex persist_lock_;
+  std::condition_variable persist_cv_;
 
-  // std::string pepoch_dir_;
+  const std::string pepoch_filename_ = "pepoch";
 
-  // const std::string pepoch_filename_ = "pepoch";
+  const size_t pepoch_sleep_period_us_ = 40000;
 
+  // how often a synchronous commit re-checks whether its epoch is complete.
+  const size_t sync_wait_period_us_ = 1000;
 };
 
 }  // namespace logging
@@ -12,137 +12,168 @@
 
 #pragma once
 
-#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
-#include <list>
-#include <stack>
 #include <unordered_map>
+#include <vector>
 
-#include "concurrency/transaction_context.h"
-#include "concurrency/epoch_manager.h"
+#include "common/internal_types.h"
+#include "common/logger.h"
+#include "common/synchronization/spin_latch.h"
 #include "logging/log_buffer.h"
-#include "logging/log_record.h"
 #include "logging/log_buffer_pool.h"
-#include "logging/log_manager.h"
 #include "logging/worker_context.h"
-#include "type/types.h"
-#include "common/serializer.h"
-#include "common/lockfree_queue.h"
-#include "common/logger.h"
-#include "common/pool.h"
-#include "common/synchronization/spin_lock.h"
+#include "type/serializeio.h"
 
 namespace peloton {
-  
-namespace storage {
-  class TileGroupHeader;
-}
-
 namespace logging {
 
-  class PhyLogLogger {
+//===--------------------------------------------------------------------===//
+// LogicalLogger
+//===--------------------------------------------------------------------===//
+
+/**
+ * A logger drains the sealed log buffers of its workers into log files.
+ *
+ * In group-commit mode the logger thread wakes up periodically, computes the
+ * largest epoch that no registered worker can still append to, and writes all
+ * the buffers up to that epoch followed by a single fsync. In synchronous
+ * mode the workers call PersistWorker() themselves at every commit.
+ *
+ * Every epoch written to a file is framed by an EPOCH_BEGIN and an EPOCH_END
+ * record. A new file is started every new_file_interval_ milliseconds, named
+ * after the first epoch it contains.
+ */
+class LogicalLogger {
+ public:
+  LogicalLogger(const size_t &logger_id, const std::string &log_dir)
+      : logger_id_(logger_id),
+        log_dir_(log_dir),
+        logger_thread_(nullptr),
+        is_running_(false),
+        file_handle_(),
+        file_eid_(INVALID_EID),
+        logger_output_buffer_(),
+        persist_epoch_id_(INVALID_EID),
+        has_failed_(false),
+        worker_map_lock_(),
+        worker_map_() {}
+
+  ~LogicalLogger() {}
+
+  void StartLogging() {
+    is_running_ = true;
+    logger_thread_.reset(new std::thread(&LogicalLogger::Run, this));
+  }
 
-  public:
-    PhyLogLogger(const size_t &logger_id, const std::string &log_dir) :
-      logger_id_(logger_id),
-      log_dir_(log_dir),
-      logger_thread_(nullptr),
-      is_running_(false),
-      logger_output_buffer_(), 
-      persist_epoch_id_(INVALID_EID),
-      worker_map_lock_(), 
-      worker_map_() {}
+  void StopLogging() {
+    is_running_ = false;
+    logger_thread_->join();
+    logger_thread_.reset();
+  }
+
+  void RegisterWorker(std::shared_ptr<WorkerContext> worker_ctx);
+  void DeregisterWorker(WorkerContext *worker_ctx);
 
-    ~PhyLogLogger() {}
+  // persist the sealed buffers of a single worker and force them to the disk.
+  // this function is invoked by the worker thread in synchronous mode.
+  // returns false if the buffers could not be made durable.
+  bool PersistWorker(WorkerContext *worker_ctx);
 
-    void StartRecovery(const size_t checkpoint_eid, const size_t persist_eid, const size_t recovery_thread_count);
-    void StartIndexRebulding(const size_t logger_count);
+  // persist every buffer that has been handed over to this logger, including
+  // those of idle workers. invoked once the logger thread has stopped.
+  void PersistAll();
 
-    void WaitForRecovery();
-    void WaitForIndexRebuilding();
+  size_t GetPersistEpochId() const { return persist_epoch_id_.load(); }
 
-    void StartLogging() {
-      is_running_ = true;
-      logger_thread_.reset(new std::thread(&PhyLogLogger::Run, this));
-    }
+  // in synchronous mode the workers force their own records before they
+  // leave their epoch, so an epoch is persisted as soon as none of them can
+  // write to it anymore. invoked periodically instead of running the thread.
+  void CatchUpPersistEpochId();
 
-    void StopLogging() {
-      is_running_ = false;
-      logger_thread_->join();
-    }
+  // whether a write to the log has failed. a failed logger never advances
+  // its persistent epoch again, and only discards the buffers it collects.
+  bool HasFailed() const { return has_failed_.load(); }
 
-    void RegisterWorker(WorkerContext *phylog_worker_ctx);
-    void DeregisterWorker(WorkerContext *phylog_worker_ctx);
+  size_t GetLoggerId() const { return logger_id_; }
 
-    size_t GetPersistEpochId() const {
-      return persist_epoch_id_;
-    }
+  const std::string &GetLogDirectory() const { return log_dir_; }
 
+  // remove the log files that only contain epochs older than epoch_id. the
+  // file that is being written is always kept.
+  void RemoveFilesBefore(const eid_t epoch_id);
 
-private:
+  std::string GetLogFileFullPath(size_t epoch_id) const {
+    return log_dir_ + "/" + logging_filename_prefix_ + "_" +
+           std::to_string(logger_id_) + "_" + std::to_string(epoch_id);
+  }
+
+ private:
   void Run();
 
-  void PersistEpochBegin(FileHandle &file_handle, const size_t epoch_id);
-  void PersistEpochEnd(FileHandle &file_handle, const size_t epoch_id);
-  void PersistLogBuffer(FileHandle &file_handle, std::unique_ptr<LogBuffer> log_buffer);
+  // compute the largest epoch that none of the workers can still write to.
+  eid_t GetMaxPersistableEpochId();
 
-  std::string GetLogFileFullPath(size_t epoch_id) {
-    return log_dir_ + "/" + logging_filename_prefix_ + "_" + std::to_string(logger_id_) + "_" + std::to_string(epoch_id);
-  }
+  // persist all the buffers up to max_eid, and fsync once.
+  void PersistEpochs(const eid_t max_eid);
 
-  void GetSortedLogFileIdList(const size_t checkpoint_eid, const size_t persist_eid);
-  
-  void RunRecoveryThread(const size_t thread_id, const size_t checkpoint_eid, const size_t persist_eid);
+  // collect the buffers of a worker whose epochs are no larger than max_eid.
+  void CollectBuffers(WorkerContext *worker_ctx, const eid_t max_eid,
+                      std::vector<std::unique_ptr<LogBuffer>> &buffers);
 
-  void RunSecIndexRebuildThread(const size_t logger_count);
+  // write the buffers, which must be ordered by epoch, into the log file and
+  // force them to the disk. returns false if any write fails.
+  bool WriteBuffers(std::vector<std::unique_ptr<LogBuffer>> &buffers);
 
-  void RebuildSecIndexForTable(const size_t logger_count, storage::DataTable *table);
+  bool PersistEpochBegin(FileHandle &file_handle, const size_t epoch_id);
+  bool PersistEpochEnd(FileHandle &file_handle, const size_t epoch_id);
+  bool PersistLogBuffer(FileHandle &file_handle, LogBuffer *log_buffer);
 
-  bool ReplayLogFile(const size_t thread_id, FileHandle &file_handle, size_t checkpoint_eid, size_t pepoch_eid);
-  bool InstallTupleRecord(LogRecordType type, storage::Tuple *tuple, storage::DataTable *table, cid_t cur_cid);
+  // open a new log file if there is none, or the current one is old enough.
+  bool PrepareLogFile(const size_t epoch_id);
 
-  // Return value is the swapped txn id, either INVALID_TXNID or INITIAL_TXNID
-  txn_id_t LockTuple(storage::TileGroupHeader *tg_header, oid_t tuple_offset);
-  void UnlockTuple(storage::TileGroupHeader *tg_header, oid_t tuple_offset, txn_id_t new_txn_id);
+  // return the buffers to the buffer pools of the workers.
+  void ReturnBuffers(std::vector<std::unique_ptr<LogBuffer>> &buffers);
 
-  private:
-    size_t logger_id_;
-    std::string log_dir_;
+ private:
+  size_t logger_id_;
+  std::string log_dir_;
 
-    // recovery threads
-    std::vector<std::unique_ptr<std::thread>> recovery_threads_;
-    std::vector<size_t> file_eids_;
-    std::atomic<int> max_replay_file_id_;
+  // logger thread
+  std::unique_ptr<std::thread> logger_thread_;
+  volatile bool is_running_;
 
-    /* Recovery */
-    // TODO: Check if we can discard the recovery pool after the recovery is done.
-    // Since every thing is copied to the tile group and tile group related pool
-    std::vector<std::unique_ptr<VarlenPool>> recovery_pools_;
-    
-    // logger thread
-    std::unique_ptr<std::thread> logger_thread_;
-    volatile bool is_running_;
+  /* File system related */
+  // serializes the writes to the log file, which may come from the logger
+  // thread or from workers in synchronous mode.
+  std::mutex file_lock_;
+  FileHandle file_handle_;
+  size_t file_eid_;
+  std::chrono::steady_clock::time_point file_start_time_;
+  CopySerializeOutput logger_output_buffer_;
 
-    /* File system related */
-    CopySerializeOutput logger_output_buffer_;
+  // the largest epoch that has been persisted by this logger.
+  std::atomic<size_t> persist_epoch_id_;
 
-    /* Log buffers */
-    size_t persist_epoch_id_;
+  std::atomic<bool> has_failed_;
 
-    // The spin lock to protect the worker map.
-    // We only update this map when creating/terminating a new worker
-    common::synchronization::SpinLatch worker_map_lock_;
+  // The spin lock to protect the worker map.
+  // We only update this map when creating/terminating a new worker
+  common::synchronization::SpinLatch worker_map_lock_;
 
-    // map from worker id to the worker's context.
-    std::unordered_map<oid_t, std::shared_ptr<WorkerContext>> worker_map_;
-  
-    const std::string logging_filename_prefix_ = "log";
+  // map from worker id to the worker's context.
+  std::unordered_map<oid_t, std::shared_ptr<WorkerContext>> worker_map_;
 
-    const size_t sleep_period_us_ = 40000;
+  const std::string logging_filename_prefix_ = "log";
 
-    const int new_file_interval_ = 500; // 500 milliseconds.
-  };
+  const size_t sleep_period_us_ = 40000;
 
+  const int new_file_interval_ = 500;  // 500 milliseconds.
+};
 
-}
-}
\ No newline at end of file
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,327 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_recovery_manager.h
+//
+// Identification: src/include/logging/logical_recovery_manager.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/item_pointer.h"
+#include "common/synchronization/spin_latch.h"
+
+namespace peloton {
+
+namespace concurrency {
+class TransactionContext;
+}  // namespace concurrency
+
+namespace executor {
+class LogicalTile;
+}  // namespace executor
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}  // namespace storage
+
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// logical recovery Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * Rebuilds the database from the latest checkpoint and the log files written
+ * after it.
+ *
+ * The schema is recovered first. The catalog tables that describe the
+ * databases, schemas, tables, columns, indexes and constraints are loaded
+ * into private copies, and every database, schema and table they describe
+ * that does not exist yet is created again through the catalog, under new
+ * oids. The catalog tables of pg_catalog, and the system tables of each
+ * database, are bootstrapped by the catalog itself and never recovered.
+ * Tables of databases that the recovered catalog does not know about must
+ * have been created with the same oids before the recovery starts.
+ *
+ * The data is then recovered in three phases, each spread over thread_count
+ * threads:
+ *
+ * 1. The checkpoint files are loaded, one table per task. Every tile group
+ *    of the checkpoint is re-created with AddTileGroupWithOidForRecovery and
+ *    its tuples are put back into their original slots.
+ *
+ * 2. The log files are replayed, one file per task. Only the committed
+ *    transactions whose epoch is covered by the pepoch file and whose commit
+ *    id is larger than the one of the checkpoint are applied. Every file is
+ *    read and split into transactions once, before the schema recovery, and
+ *    kept in memory until the data has been replayed. As the files are
+ *    replayed concurrently, every new version is first installed unless its
+ *    slot already holds a newer one, and the versions that the transactions
+ *    replaced or deleted are only invalidated, and linked to the versions
+ *    that replaced them, once all the files have been read.
+ *
+ * 3. The indexes are rebuilt from the visible tuples, one table per task,
+ *    rather than being maintained during the replay. Each task has its own
+ *    transaction. The versions that were replaced or deleted are then handed
+ *    to the GC, so that their slots get reused.
+ *
+ * Tile group ids are not stable across restarts, so every tile group of the
+ * checkpoint and the log is mapped, per table, to a freshly allocated one.
+ * Once the recovery is done, the epoch manager is moved past every epoch of
+ * the log, and a checkpoint of the recovered state is taken. Only then are
+ * the replayed log files removed, so that the next recovery never mixes the
+ * tile group ids of two runs. Without a checkpoint manager, the log files
+ * are kept. The pepoch file is always kept.
+ */
+class LogicalRecoveryManager {
+ public:
+  LogicalRecoveryManager(const LogicalRecoveryManager &) = delete;
+  LogicalRecoveryManager &operator=(const LogicalRecoveryManager &) = delete;
+  LogicalRecoveryManager(LogicalRecoveryManager &&) = delete;
+  LogicalRecoveryManager &operator=(LogicalRecoveryManager &&) = delete;
+
+  LogicalRecoveryManager(const std::string &checkpoint_dir,
+                         const std::vector<std::string> &log_dirs,
+                         const int thread_count)
+      : checkpoint_dir_(checkpoint_dir),
+        log_dirs_(log_dirs),
+        recovery_thread_count_(std::max(thread_count, 1)),
+        checkpoint_cid_(INVALID_CID),
+        persist_epoch_id_(INVALID_EID),
+        max_epoch_id_(INVALID_EID),
+        recovered_txn_count_(0),
+        recovery_cid_(INVALID_CID),
+        recovering_catalog_(false) {}
+
+  ~LogicalRecoveryManager();
+
+  // recover the schema and all the tables. returns false if any of the
+  // files could not be read, or if the recovered state could not be
+  // checkpointed.
+  bool DoRecovery();
+
+  // the commit id of the checkpoint the recovery started from.
+  cid_t GetCheckpointCommitId() const { return checkpoint_cid_; }
+
+  // the number of transactions replayed from the log.
+  size_t GetRecoveredTxnCount() const { return recovered_txn_count_.load(); }
+
+ private:
+  // an update or delete that ends the lifetime of a version. the new
+  // location is the version that replaced it, or INVALID_ITEMPOINTER for a
+  // delete.
+  struct Invalidation {
+    cid_t commit_id;
+    oid_t database_id;
+    oid_t table_id;
+    ItemPointer location;
+    ItemPointer new_location;
+  };
+
+  // the records of a committed transaction that is replayed.
+  struct LogTxn {
+    cid_t commit_id;
+    const char *begin;
+    const char *end;
+  };
+
+  // a log file read into memory, with the transactions to replay.
+  struct LogFile {
+    std::unique_ptr<char[]> data;
+    std::vector<LogTxn> txns;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // Schema recovery
+  //===--------------------------------------------------------------------===//
+
+  // create the databases and tables described by the recovered catalog.
+  bool RebuildSchema();
+
+  void RebuildDatabase(const oid_t old_database_oid,
+                       const std::string &database_name,
+                       concurrency::TransactionContext *txn);
+
+  // call row_func with a single row logical tile for every visible row of a
+  // recovered catalog table.
+  void ScanCatalogTable(
+      const oid_t database_id, const oid_t table_id,
+      concurrency::TransactionContext *txn,
+      const std::function<void(executor::LogicalTile *)> &row_func);
+
+  //===--------------------------------------------------------------------===//
+  // Checkpoint recovery
+  //===--------------------------------------------------------------------===//
+
+  // find the latest complete checkpoint, whose commit id the logs are
+  // filtered with.
+  void FindCheckpoint();
+
+  // load the checkpoint found by FindCheckpoint.
+  bool LoadCheckpoint();
+
+  bool LoadCheckpointFile(const std::string &file_name, const oid_t database_id,
+                          const oid_t table_id);
+
+  //===--------------------------------------------------------------------===//
+  // Log recovery
+  //===--------------------------------------------------------------------===//
+
+  // the last epoch written to the pepoch file, or INVALID_EID if there is none.
+  eid_t ReadPersistEpochId();
+
+  void ListLogFiles();
+
+  // read every log file and find the transactions to replay.
+  bool LoadLogFiles();
+
+  bool LoadLogFile(const std::string &file_name, LogFile &log_file);
+
+  bool ReplayLogs();
+
+  // install the new versions of a committed transaction.
+  void ReplayTxn(const cid_t commit_id, const char *begin, const char *end,
+                 std::vector<Invalidation> &invalidations);
+
+  //===--------------------------------------------------------------------===//
+  // Index recovery
+  //===--------------------------------------------------------------------===//
+
+  // move the epoch manager past every recovered epoch, so that a new
+  // transaction sees all the recovered versions.
+  void MoveEpochPastRecovery();
+
+  void RebuildIndexes();
+
+  // returns the commit id of the transaction the indexes were rebuilt in.
+  cid_t RebuildTableIndexes(storage::DataTable *table);
+
+  // hand the versions that the replay replaced or deleted to the GC.
+  void RecycleReplacedVersions();
+
+  //===--------------------------------------------------------------------===//
+  // Utility
+  //===--------------------------------------------------------------------===//
+
+  // the catalog tables that are bootstrapped rather than recovered.
+  static bool IsCatalogTable(const oid_t database_id, const oid_t table_id);
+
+  // the catalog tables that the schema is recovered from.
+  static bool IsSchemaTable(const oid_t database_id, const oid_t table_id);
+
+  // get the table that the records of a table of the previous run go to in
+  // the current phase, or nullptr if they are skipped.
+  storage::DataTable *GetTable(const oid_t database_id, const oid_t table_id);
+
+  // get the private copy of a recovered catalog table, creating it if needed.
+  storage::DataTable *GetSchemaTable(const oid_t database_id,
+                                     const oid_t table_id);
+
+  // get the tile group that stands for a tile group of the previous run,
+  // creating it if needed.
+  storage::TileGroup *GetRecoveryTileGroup(const oid_t database_id,
+                                           storage::DataTable *table,
+                                           const oid_t old_table_id,
+                                           const oid_t old_tile_group_id);
+
+  // get the tile group that stands for a tile group of the previous run, or
+  // nullptr if there is none.
+  storage::TileGroup *GetRecoveryTileGroup(const oid_t database_id,
+                                           const oid_t table_id,
+                                           const oid_t old_tile_group_id);
+
+  // run task(i) for all i in [0, task_count) over the recovery threads.
+  // returns false if any of the tasks failed.
+  bool RunParallel(const size_t task_count,
+                   const std::function<bool(size_t)> &task);
+
+  static bool ReadFile(const std::string &file_name,
+                       std::unique_ptr<char[]> &data, size_t &size);
+
+  // wait until a snapshot transaction sees every recovered version.
+  bool WaitForRecoverySnapshot();
+
+  // take a checkpoint of the recovered state, and drop the replayed logs.
+  bool FinishRecovery();
+
+ private:
+  std::string checkpoint_dir_;
+
+  std::vector<std::string> log_dirs_;
+
+  int recovery_thread_count_;
+
+  cid_t checkpoint_cid_;
+
+  eid_t persist_epoch_id_;
+
+  std::atomic<eid_t> max_epoch_id_;
+
+  std::atomic<size_t> recovered_txn_count_;
+
+  // the largest commit id of the transactions of the recovery itself.
+  cid_t recovery_cid_;
+
+  // whether the catalog tables or the user tables are being recovered.
+  bool recovering_catalog_;
+
+  // the log files of the previous runs.
+  std::vector<std::string> log_files_;
+
+  // the contents of log_files_, until the data has been replayed.
+  std::vector<LogFile> loaded_log_files_;
+
+  // the versions of the user tables that the replay replaced or deleted.
+  std::vector<std::pair<ItemPointer, GCVersionType>> replaced_versions_;
+
+  // protects the tile group map, the set of recovered tables and the
+  // private copies of the catalog tables.
+  common::synchronization::SpinLatch tile_group_lock_;
+
+  // map from the (database, table, tile group) ids of the previous run to
+  // the current tile group ids. tile group ids are only unique within a
+  // run, and the logs of several runs may be replayed together.
+  std::map<std::tuple<oid_t, oid_t, oid_t>, oid_t> tile_group_map_;
+
+  std::unordered_set<storage::DataTable *> recovered_tables_;
+
+  // the private copies of the recovered catalog tables.
+  std::map<std::pair<oid_t, oid_t>, std::unique_ptr<storage::DataTable>>
+      schema_tables_;
+
+  // the databases described by the recovered catalog, by their old oids.
+  std::unordered_set<oid_t> recovered_database_oids_;
+
+  // map from the (database, table) oids of the previous run to the tables
+  // that were created for them.
+  std::map<std::pair<oid_t, oid_t>, storage::DataTable *> table_map_;
+
+  const std::string checkpoint_dir_prefix_ = "checkpoint_";
+
+  const std::string logging_filename_prefix_ = "log_";
+
+  const std::string pepoch_filename_ = "pepoch";
+
+  // how many epochs to wait for the snapshot of the recovered state.
+  const size_t snapshot_wait_retry_count_ = 250;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// worker_context.h
+//
+// Identification: src/include/logging/worker_context.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "common/synchronization/spin_latch.h"
+#include "logging/log_buffer.h"
+#include "logging/log_buffer_pool.h"
+#include "type/serializeio.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// WorkerContext
+//===--------------------------------------------------------------------===//
+
+/**
+ * Per-worker logging state. A worker thread appends its log records to its
+ * own LogBuffer, tagged with the epoch in which the records were written.
+ * Full buffers, and buffers of epochs the worker has left behind, are sealed
+ * and handed over to the logger, which persists them epoch by epoch and
+ * then returns them to the worker's buffer pool.
+ */
+struct WorkerContext {
+  WorkerContext(const oid_t id)
+      : worker_id(id),
+        current_eid(MAX_EID),
+        current_cid(INVALID_CID),
+        txn_begun(false),
+        commit_eid(INVALID_EID),
+        buffer_pool(id),
+        current_buffer(nullptr),
+        output_buffer() {}
+
+  ~WorkerContext() {}
+
+  oid_t worker_id;
+
+  // the epoch of the transaction that is currently being logged.
+  // MAX_EID indicates that the worker is idle.
+  std::atomic<eid_t> current_eid;
+
+  // the commit id of the transaction that is currently being logged.
+  cid_t current_cid;
+
+  // whether a transaction-begin record has been written for the current
+  // transaction. records are only emitted for transactions that modify data.
+  bool txn_begun;
+
+  // the epoch that must be persisted before the last transaction committed
+  // by the worker can be acknowledged. INVALID_EID if it logged nothing.
+  eid_t commit_eid;
+
+  LogBufferPool buffer_pool;
+
+  // the buffer the worker is currently appending to. it is only accessed by
+  // the worker, except when the worker is idle, in which case the logger may
+  // seal it while holding the latch.
+  std::unique_ptr<LogBuffer> current_buffer;
+
+  // the latch protecting the sealed buffers, and the current buffer while the
+  // worker is idle.
+  common::synchronization::SpinLatch latch;
+
+  // buffers that are ready to be persisted, ordered by epoch id.
+  std::vector<std::unique_ptr<LogBuffer>> sealed_buffers;
+
+  // serialization buffer for a single log record.
+  CopySerializeOutput output_buffer;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -97,6 +97,7 @@ class ConnectionHandle {
   Transition TryWrite();
   Transition Process();
   Transition GetResult();
+  Transition FlushResponses();
   Transition TrySslHandshake();
   Transition TryCloseConnection();
 
@@ -193,6 +194,8 @@ class ConnectionHandle {
   tcop::TrafficCop tcop_;
   // TODO(Tianyu): Put this into protocol handler in a later refactor
   unsigned int next_response_ = 0;
+  // Whether the rows of the queued statement are being sent while it runs
+  bool streaming_result_ = false;
 };
 }  // namespace network
 }  // namespace peloton
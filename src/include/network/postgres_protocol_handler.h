@@ -69,7 +69,7 @@ class PostgresProtocolHandler : public ProtocolHandler {
 
   void Reset();
 
-  void GetResult();
+  ProcessResult GetResult();
 
  private:
   //===--------------------------------------------------------------------===//
@@ -140,9 +140,51 @@ class PostgresProtocolHandler : public ProtocolHandler {
   // Sends the attribute headers required by SELECT queries
   void PutTupleDescriptor(const std::vector<FieldInfo> &tuple_descriptor);
 
-  // Send each row, one packet at a time, used by SELECT queries
+  // Send each row, one packet at a time, used by SELECT queries. The rows
+  // sent are removed from the results.
   void SendDataRows(std::vector<ResultValue> &results, int colcount);
 
+  // Send the rows of the fetched batches of a streamed result, which are
+  // already encoded like the columns of DataRow messages. The rows of a
+  // streamed result are sent over several calls. The rows sent are removed
+  // from the batches, which keep the rows beyond the row limit of the portal.
+  void SendResultBatches(int colcount);
+
+  // The number of rows in the fetched batches
+  size_t NumFetchedRows();
+
+  // Whether the rows the statement produced so far exceed the row limit of
+  // the portal being executed
+  bool ExceedsRowLimit();
+
+  // Tell the client that the portal reached its row limit. The statement
+  // stays blocked on its next rows until the portal is executed again.
+  void SuspendPortal();
+
+  // Whether the packet ends the suspended portal, if any: it runs in the
+  // transaction of the portal or replaces the plan it executes
+  bool EndsSuspendedPortal(InputPacket *pkt);
+
+  // Finish the statement of the suspended portal, if any, dropping the rows
+  // it has not sent. The statement is cancelled rather than waited for, so
+  // this returns false until it completed, see GetResult().
+  bool CloseSuspendedPortal();
+
+  // Tell the client the number of columns of a COPY FROM STDIN or COPY TO
+  // STDOUT, all of them in the text format
+  void SendCopyResponse(NetworkMessageType msg_type, int colcount);
+
+  // Send the rows of the fetched batches of a COPY TO STDOUT as CSV lines,
+  // one packet per row. The COPY starts with the first rows, like a SELECT
+  // that sends its tuple descriptor.
+  void SendCopyOutRows(int colcount);
+
+  // Format a row of a result batch as a CSV line of a COPY TO STDOUT
+  std::string EncodeCopyRow(const char *row, int colcount);
+
+  // Stop the COPY FROM STDIN in progress, if any, and finish its statement
+  void AbortCopyIn();
+
   // Used to send a packet that indicates the completion of a query. Also has
   // txn state mgmt
   void CompleteCommand(const QueryType &query_type, int rows);
@@ -165,6 +207,9 @@ class PostgresProtocolHandler : public ProtocolHandler {
   /* Execute a Simple query protocol message */
   ProcessResult ExecQueryMessage(InputPacket *pkt, const size_t thread_id);
 
+  /* Process the messages of the client during a COPY FROM STDIN */
+  ProcessResult ProcessCopyInPacket(InputPacket *pkt);
+
   /* Execute a EXPLAIN query message */
   ResultType ExecQueryExplain(const std::string &query,
                               parser::ExplainStatement &explain_stmt);
@@ -202,6 +247,37 @@ class PostgresProtocolHandler : public ProtocolHandler {
   // global txn state
   NetworkTransactionStateType txn_state_;
 
+  // The number of result rows of the current statement sent so far
+  size_t rows_sent_ = 0;
+
+  // The row limit of the portal being executed, 0 if it has none
+  size_t max_rows_ = 0;
+
+  // The portal whose statement executes, and whether it reached its row
+  // limit
+  std::string executing_portal_;
+  bool portal_suspended_ = false;
+
+  // Whether the statement of the suspended portal is being cancelled. The
+  // packet that ended the portal stays in request_ meanwhile, and is
+  // processed with the thread id once the statement completed.
+  bool portal_closing_ = false;
+  size_t closing_thread_id_ = 0;
+
+  // Whether a COPY exchanges its data with the client, and which way
+  enum class CopyMode { NONE, COPY_IN, COPY_OUT };
+  CopyMode copy_mode_ = CopyMode::NONE;
+
+  // The CSV format of the COPY
+  char copy_delimiter_ = ',';
+  char copy_quote_ = '"';
+  char copy_escape_ = '"';
+
+  // The data of the COPY FROM STDIN, and whether the client has to wait for
+  // the statement to read it before sending more
+  std::shared_ptr<util::Pipe> copy_input_;
+  bool copy_in_waiting_ = false;
+
   // state to manage skipped queries
   bool skipped_stmt_ = false;
   std::string skipped_query_string_;
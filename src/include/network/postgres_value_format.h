@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// postgres_value_format.h
+//
+// Identification: src/include/network/postgres_value_format.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "common/internal_types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace network {
+
+/**
+ * Conversions between Peloton values and the formats that the Postgres wire
+ * protocol uses for result columns and statement parameters.
+ *
+ * Format code 0 is the text format, which is what Value::ToString() returns.
+ * Format code 1 is the binary format of the Postgres type that the column
+ * is described with (see TrafficCop::GetColumnFieldForValueType()): network
+ * byte order integers and floats, raw bytes for strings, and dates and
+ * timestamps relative to 2000-01-01.
+ */
+class PostgresValueFormat {
+ public:
+  /// Format codes of the Postgres protocol
+  static constexpr int TEXT_FORMAT = 0;
+  static constexpr int BINARY_FORMAT = 1;
+
+  /// Julian day of 2000-01-01, the epoch of Postgres dates and timestamps
+  static constexpr int32_t POSTGRES_EPOCH_JDATE = 2451545;
+
+  /**
+   * Encode a non-NULL value for a result row.
+   *
+   * @param val The value to encode
+   * @param format The format code requested for the column
+   * @return The bytes of the column in the data row
+   */
+  static std::string EncodeValue(const type::Value &val, int format);
+
+  /**
+   * Append a column of a data row: the length of the encoded value, -1 for
+   * NULL, followed by its bytes.
+   *
+   * @param out Where the column is appended
+   * @param val The value of the column
+   * @param format The format code requested for the column
+   */
+  static void AppendColumn(std::string &out, const type::Value &val,
+                           int format);
+
+  /**
+   * Encode a non-NULL value in the binary format of its column type.
+   */
+  static std::string EncodeBinary(const type::Value &val);
+
+  /**
+   * Decode a parameter sent in the binary format.
+   *
+   * @param type The Postgres type of the parameter
+   * @param data The bytes of the parameter
+   * @param len The number of bytes of the parameter
+   * @param[out] result Where the decoded value is written
+   * @return false if the type is not supported or the length does not match
+   * the type, true otherwise
+   */
+  static bool DecodeBinary(PostgresValueType type, const uchar *data,
+                           size_t len, type::Value &result);
+
+  /**
+   * Convert a Peloton timestamp into microseconds since 2000-01-01,
+   * ignoring its time zone.
+   */
+  static int64_t TimestampToPostgres(uint64_t timestamp);
+
+  /**
+   * Convert microseconds since 2000-01-01 into a UTC Peloton timestamp.
+   */
+  static uint64_t TimestampFromPostgres(int64_t micros);
+};
+
+}  // namespace network
+}  // namespace peloton
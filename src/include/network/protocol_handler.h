@@ -39,7 +39,12 @@ class ProtocolHandler {
 
   virtual void Reset();
 
-  virtual void GetResult();
+  /**
+   * Pick up the result of the queued statement.
+   * @return PROCESSING while the statement still executes, after some of its
+   * result was put into the responses, COMPLETE once it has completed.
+   */
+  virtual ProcessResult GetResult();
 
   void SetFlushFlag(bool flush) { force_flush_ = flush; }
 
@@ -14,6 +14,7 @@
 
 #include "optimizer/cost_model/abstract_cost_model.h"
 #include "expression/tuple_value_expression.h"
+#include "catalog/index_catalog.h"
 #include "catalog/table_catalog.h"
 #include "optimizer/memo.h"
 #include "optimizer/operators.h"
@@ -51,7 +52,7 @@ class DefaultCostModel : public AbstractCostModel {
     }
     output_cost_ = table_stats->num_rows * DEFAULT_TUPLE_COST;
   }
-  void Visit(UNUSED_ATTRIBUTE const PhysicalIndexScan *op) {
+  void Visit(const PhysicalIndexScan *op) {
     auto table_stats = std::dynamic_pointer_cast<TableStats>(
         StatsStorage::GetInstance()->GetTableStats(
             op->table_->GetDatabaseOid(), op->table_->GetTableOid(), txn_));
@@ -59,8 +60,15 @@ class DefaultCostModel : public AbstractCostModel {
       output_cost_ = 0.f;
       return;
     }
-    // Index search cost + scan cost
-    output_cost_ = std::log2(table_stats->num_rows) * DEFAULT_INDEX_TUPLE_COST +
+    // Index search cost + scan cost. A hash lookup does not depend on the
+    // size of the table
+    auto index_type =
+        op->table_->GetIndexCatalogEntries(op->index_id)->GetIndexType();
+    double search_cost = (index_type == IndexType::HASH)
+                             ? DEFAULT_INDEX_TUPLE_COST
+                             : std::log2(table_stats->num_rows) *
+                                   DEFAULT_INDEX_TUPLE_COST;
+    output_cost_ = search_cost +
         memo_->GetGroupByID(gexpr_->GetGroupID())->GetNumRows() *
             DEFAULT_TUPLE_COST;
   }
@@ -69,7 +77,7 @@ class DefaultCostModel : public AbstractCostModel {
     output_cost_ = 0.f;
   }
 
-  void Visit(const PhysicalOrderBy *) { SortCost(); }
+  void Visit(const PhysicalOrderBy *) { output_cost_ = SortCost(); }
 
   void Visit(const PhysicalLimit *op) {
     auto child_num_rows =
@@ -97,6 +105,15 @@ class DefaultCostModel : public AbstractCostModel {
     // TODO(boweic): Build (left) table should have different cost to probe table
     output_cost_ = (left_child_rows + right_child_rows) * DEFAULT_TUPLE_COST;
   }
+  void Visit(UNUSED_ATTRIBUTE const PhysicalInnerMergeJoin *op) {
+    auto left_child_rows =
+        memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
+    auto right_child_rows =
+        memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
+    // Both inputs arrive sorted, so merging them builds no hash table
+    output_cost_ =
+        (left_child_rows + right_child_rows) * DEFAULT_TUPLE_COST * 0.5;
+  }
   void Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) {}
@@ -15,6 +15,7 @@
 
 #include "optimizer/cost_model/abstract_cost_model.h"
 #include "expression/tuple_value_expression.h"
+#include "catalog/index_catalog.h"
 #include "catalog/table_catalog.h"
 #include "optimizer/memo.h"
 #include "optimizer/operators.h"
@@ -66,8 +67,15 @@ class PostgresCostModel : public AbstractCostModel {
       output_cost_ = 0.f;
       return;
     }
-    // Index search cost + scan cost
-    output_cost_ = std::log2(table_stats->num_rows) * DEFAULT_INDEX_TUPLE_COST +
+    // Index search cost + scan cost. A hash lookup does not depend on the
+    // size of the table
+    auto index_type =
+        op->table_->GetIndexCatalogEntries(op->index_id)->GetIndexType();
+    double search_cost = (index_type == IndexType::HASH)
+                             ? DEFAULT_INDEX_TUPLE_COST
+                             : std::log2(table_stats->num_rows) *
+                                   DEFAULT_INDEX_TUPLE_COST;
+    output_cost_ = search_cost +
         memo_->GetGroupByID(gexpr_->GetGroupID())->GetNumRows() *
             DEFAULT_TUPLE_COST;
   }
@@ -78,7 +86,7 @@ class PostgresCostModel : public AbstractCostModel {
   }
 
   void Visit(UNUSED_ATTRIBUTE const PhysicalOrderBy *) override {
-    SortCost();
+    output_cost_ = SortCost();
   }
 
   void Visit(const PhysicalLimit *op) override {
@@ -175,6 +183,15 @@ class PostgresCostModel : public AbstractCostModel {
 
   }
 
+  // Merging two sorted inputs touches every tuple of both once
+  void Visit(UNUSED_ATTRIBUTE const PhysicalInnerMergeJoin *op) override {
+    auto left_child_rows =
+        memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
+    auto right_child_rows =
+        memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
+    output_cost_ = (left_child_rows + right_child_rows) * DEFAULT_TUPLE_COST;
+  }
+
   void Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) override {}
@@ -26,7 +26,7 @@
 // This cost model is meant to just be a trivial cost model. The decisions it makes are as follows
 // * Always choose index scan (cost of 0) over sequential scan (cost of 1)
 // * Choose NL if left rows is a single record (for single record lookup queries), else choose hash join
-// * Choose hash group by over sort group by
+// * Choose hash group by over sort group by and hash join over merge join
 
 namespace peloton {
 namespace optimizer {
@@ -87,6 +87,10 @@ class TrivialCostModel : public AbstractCostModel {
     output_cost_ = 1.f;
   }
 
+  void Visit(UNUSED_ATTRIBUTE const PhysicalInnerMergeJoin *op) override {
+    output_cost_ = 2.f;
+  }
+
   void Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) override {}
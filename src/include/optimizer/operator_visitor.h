@@ -41,6 +41,7 @@ class OperatorVisitor {
   virtual void Visit(const PhysicalLeftHashJoin *) {}
   virtual void Visit(const PhysicalRightHashJoin *) {}
   virtual void Visit(const PhysicalOuterHashJoin *) {}
+  virtual void Visit(const PhysicalInnerMergeJoin *) {}
   virtual void Visit(const PhysicalInsert *) {}
   virtual void Visit(const PhysicalInsertSelect *) {}
   virtual void Visit(const PhysicalDelete *) {}
@@ -79,6 +79,8 @@ class PlanGenerator : public OperatorVisitor {
 
   void Visit(const PhysicalOuterHashJoin *) override;
 
+  void Visit(const PhysicalInnerMergeJoin *) override;
+
   void Visit(const PhysicalInsert *) override;
 
   void Visit(const PhysicalInsertSelect *) override;
@@ -144,6 +146,16 @@ class PlanGenerator : public OperatorVisitor {
       std::unique_ptr<const planner::ProjectInfo> &proj_info,
       std::shared_ptr<const catalog::Schema> &proj_schema);
 
+  /**
+   * @brief Choose the number of hash bits a hash join radix partitions its
+   *  inputs on, such that every partition of the build side fits in cache
+   *
+   * @param build_cardinality The estimated number of build-side tuples
+   *
+   * @return The number of partition bits, or zero to not partition at all
+   */
+  uint32_t GenerateRadixPartitionBits(int build_cardinality);
+
   /**
    * @brief Check required columns and output_cols, see if we need to add
    *  projection on top of the current output plan, this should be done after
@@ -206,6 +206,21 @@ class LogicalGroupByToHashGroupBy : public Rule {
                  OptimizeContext *context) const override;
 };
 
+/**
+ * @brief (Logical Group by -> Sort Group by)
+ */
+class LogicalGroupByToSortGroupBy : public Rule {
+ public:
+  LogicalGroupByToSortGroupBy();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
 /**
  * @brief (Logical Aggregate -> Physical Aggregate)
  */
@@ -251,6 +266,21 @@ class InnerJoinToInnerHashJoin : public Rule {
                  OptimizeContext *context) const override;
 };
 
+/**
+ * @brief (Logical Inner Join -> Inner Merge Join)
+ */
+class InnerJoinToInnerMergeJoin : public Rule {
+ public:
+  InnerJoinToInnerMergeJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
 /**
  * @brief (Logical Distinct -> Physical Distinct)
  */
@@ -46,13 +46,21 @@ class ColumnStatsCollector {
 
   void AddValue(const type::Value& value);
 
+  // Fold the stats another collector gathered on the same column into this
+  // one. The collectors must have been created with the same parameters.
+  void Merge(const ColumnStatsCollector& other);
+
+  // Set the fraction of the table's tuples the values were sampled from. The
+  // value frequencies and the cardinality are scaled up to the whole table.
+  inline void SetSampleRatio(double sample_ratio) {
+    sample_ratio_ = sample_ratio;
+  }
+
   double GetFracNull();
 
-  inline std::vector<ValueFrequencyPair> GetCommonValueAndFrequency() {
-    return topk_.GetAllOrderedMaxFirst();
-  }
+  std::vector<ValueFrequencyPair> GetCommonValueAndFrequency();
 
-  inline uint64_t GetCardinality() { return hll_.EstimateCardinality(); }
+  uint64_t GetCardinality();
 
   inline double GetCardinalityError() { return hll_.RelativeError(); }
 
@@ -80,6 +88,8 @@ class ColumnStatsCollector {
   size_t null_count_ = 0;
   size_t total_count_ = 0;
 
+  double sample_ratio_ = 1.0;
+
   ColumnStatsCollector(const ColumnStatsCollector&);
   void operator=(const ColumnStatsCollector&);
 };
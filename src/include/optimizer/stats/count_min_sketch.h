@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
@@ -120,6 +121,20 @@ class CountMinSketch {
     }
   }
 
+  // Add the counts of another sketch with the same dimensions to this one.
+  // Items are hashed the same way in every sketch, so the result is the
+  // sketch of both inputs combined. The number of distinct items can't be
+  // recovered from the tables, the larger of the two is kept.
+  void Merge(const CountMinSketch& other) {
+    assert(depth == other.depth && width == other.width);
+    for (int i = 0; i < depth; i++) {
+      for (int j = 0; j < width; j++) {
+        table[i][j] += other.table[i][j];
+      }
+    }
+    size = std::max(size, other.size);
+  }
+
   uint64_t EstimateItemCount(int64_t item) {
     uint64_t count = UINT64_MAX;
     std::vector<int> bins = getHashBins(item);
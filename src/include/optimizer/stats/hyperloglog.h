@@ -41,6 +41,14 @@ class HyperLogLog {
     hll_->Update(StatsUtil::HashValue(value));
   }
 
+  // Fold the registers of another HyperLogLog of the same precision into this
+  // one, which then estimates the cardinality of the union of both inputs
+  void Merge(const HyperLogLog& other) {
+    PELOTON_ASSERT(precision_ == other.precision_);
+    UNUSED_ATTRIBUTE int status = hll_->Merge(other.hll_);
+    PELOTON_ASSERT(status == 0);
+  }
+
   uint64_t EstimateCardinality() {
     uint64_t cardinality = hll_->Estimate();
     LOG_TRACE("Estimated cardinality: %" PRId64, cardinality);
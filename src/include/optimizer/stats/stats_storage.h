@@ -81,6 +81,12 @@ class StatsStorage {
   ResultType AnalayzeStatsForColumns(storage::DataTable *table,
                                      std::vector<std::string> column_names);
 
+  // Count the tuples of a table modified by a committed transaction, while
+  // auto_analyze is on. Once enough of them are, the table is analyzed again
+  // in the background.
+  static void RecordTableModifications(storage::DataTable *table,
+                                       size_t modified_count);
+
  private:
   std::unique_ptr<type::AbstractPool> pool_;
 
@@ -19,10 +19,20 @@
 #include "storage/data_table.h"
 
 namespace peloton {
+
+namespace storage {
+class TileGroupHeader;
+}  // namespace storage
+
 namespace optimizer {
 
 //===--------------------------------------------------------------------===//
 // TableStatsCollector
+//
+// Collects the stats of every column of a table. Tables larger than the
+// analyze_sample_size setting are sampled a tile group at a time, and the
+// tile groups are spread over analyze_num_threads threads. Every thread
+// feeds its own sketches, which are merged once all threads are done.
 //===--------------------------------------------------------------------===//
 class TableStatsCollector {
  public:
@@ -34,21 +44,43 @@ class TableStatsCollector {
 
   inline size_t GetActiveTupleCount() { return active_tuple_count_; }
 
+  inline size_t GetSampledTupleCount() { return sampled_tuple_count_; }
+
   inline size_t GetColumnCount() { return column_count_; }
 
   ColumnStatsCollector* GetColumnStats(oid_t column_id);
 
  private:
+  using ColumnStatsCollectors =
+      std::vector<std::unique_ptr<ColumnStatsCollector>>;
+
   storage::DataTable* table_;
   catalog::Schema* schema_;
-  std::vector<std::unique_ptr<ColumnStatsCollector>> column_stats_collectors_;
+  ColumnStatsCollectors column_stats_collectors_;
   size_t active_tuple_count_;
+  size_t sampled_tuple_count_;
   size_t column_count_;
 
   TableStatsCollector(const TableStatsCollector&);
   void operator=(const TableStatsCollector&);
 
-  void InitColumnStatsCollectors();
+  void InitColumnStatsCollectors(ColumnStatsCollectors& collectors);
+
+  // Pick the offsets of the tile groups to collect the stats from
+  std::vector<oid_t> SampleTileGroups();
+
+  // Whether the stats are collected from the tuple in the given slot. The
+  // tuple counts the sample is scaled by use the same test.
+  static bool IsCollected(storage::TileGroupHeader* tile_group_header,
+                          oid_t tuple_id);
+
+  // Count the tuples the stats are collected from in the tile group
+  static size_t CountCollectedTuples(const storage::TileGroup& tile_group);
+
+  // Collect the stats of the tile groups assigned to one thread
+  void CollectTileGroupStats(const std::vector<oid_t>& tile_group_offsets,
+                             size_t thread_id, size_t thread_count,
+                             ColumnStatsCollectors& collectors);
 };
 
 }  // namespace optimizer
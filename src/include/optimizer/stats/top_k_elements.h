@@ -641,6 +641,29 @@ class TopKElements {
     DecrFreqItem(e);
   }
 
+  /*
+   * Merge another TopKElements into this one
+   * The sketches are combined and the candidates of both queues are
+   * re-ranked by their counts in the combined sketch
+   */
+  void Merge(const TopKElements& other) {
+    cmsketch.Merge(other.cmsketch);
+
+    std::vector<ApproxTopEntry> candidates = tkq.retrieve_all();
+    std::vector<ApproxTopEntry> other_candidates = other.tkq.retrieve_all();
+    candidates.insert(candidates.end(), other_candidates.begin(),
+                      other_candidates.end());
+    for (auto& entry : candidates) {
+      const ApproxTopEntryElem& elem = entry.approx_top_elem;
+      if (elem.item_type == ApproxTopEntryElem::ElemType::INT_TYPE) {
+        entry.approx_count = cmsketch.EstimateItemCount(elem.int_item);
+      } else {
+        entry.approx_count = cmsketch.EstimateItemCount(elem.str_item.c_str());
+      }
+      AddFreqItem(entry);
+    }
+  }
+
   /*
    * Top K Elements Retrieval Functions
    */
@@ -55,6 +55,12 @@ class HashJoinPlan : public AbstractJoinPlan {
 
   void SetBloomFilterFlag(bool flag) { build_bloomfilter_ = flag; }
 
+  // The number of hash bits both inputs are radix partitioned on before they
+  // are joined partition by partition, or zero if they're not partitioned
+  uint32_t GetRadixPartitionBits() const { return radix_partition_bits_; }
+
+  void SetRadixPartitionBits(uint32_t bits) { radix_partition_bits_ = bits; }
+
   const std::string GetInfo() const override { return "HashJoinPlan"; }
 
   void GetLeftHashKeys(
@@ -87,6 +93,9 @@ class HashJoinPlan : public AbstractJoinPlan {
 
   // Flag indicating whether we build a bloom filter
   bool build_bloomfilter_;
+
+  // The number of hash bits to radix partition the inputs on
+  uint32_t radix_partition_bits_;
 };
 
 }  // namespace planner
@@ -57,10 +57,12 @@ class MergeJoinPlan : public AbstractJoinPlan {
 
   void HandleSubplanBinding(bool from_left,
                             const BindingContext &input) override {
+    // The right key of a clause refers to the second (right) tuple when the
+    // interpreter evaluates it, so make the input available at either index
     for (auto &join_clause : *GetJoinClauses()) {
       auto &exp = from_left ? join_clause.left_ : join_clause.right_;
       const_cast<expression::AbstractExpression *>(exp.get())
-          ->PerformBinding({&input});
+          ->PerformBinding({&input, &input});
     }
   }
 
@@ -74,6 +76,10 @@ class MergeJoinPlan : public AbstractJoinPlan {
 
   const std::string GetInfo() const override { return "MergeJoinPlan"; }
 
+  hash_t Hash() const override;
+
+  bool operator==(const AbstractPlan &rhs) const override;
+
   std::unique_ptr<AbstractPlan> Copy() const override {
     std::vector<JoinClause> new_join_clauses;
     for (size_t i = 0; i < join_clauses_.size(); i++) {
@@ -83,7 +89,7 @@ class MergeJoinPlan : public AbstractJoinPlan {
     }
 
     std::unique_ptr<const expression::AbstractExpression> predicate_copy(
-        GetPredicate()->Copy());
+        GetPredicate() ? GetPredicate()->Copy() : nullptr);
     std::shared_ptr<const catalog::Schema> schema_copy(
         catalog::Schema::CopySchema(GetSchema()));
     MergeJoinPlan *new_plan = new MergeJoinPlan(
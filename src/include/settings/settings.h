@@ -116,6 +116,13 @@ SETTING_int(gc_num_threads,
             1, 128,
             true, true)
 
+// Number of old versions a transaction must skip before it helps the GC
+SETTING_int(gc_cooperative_threshold,
+            "The number of versions awaiting garbage collection a transaction must skip before it helps unlink and reclaim garbage as it ends, 0 disables (default: 1K)",
+            1000,
+            0, std::numeric_limits<int32_t>::max(),
+            true, true)
+
 SETTING_bool(parallel_execution,
              "Enable parallel execution of queries (default: true)",
              true,
@@ -127,10 +134,105 @@ SETTING_int(min_parallel_table_scan_size,
             1, std::numeric_limits<int32_t>::max(),
             true, true)
 
+// Enable or disable compressing cold tile groups in the background
+SETTING_bool(tile_group_freezing,
+             "Compress full tile groups that are no longer written to in the background (default: false)",
+             false,
+             true, true)
+
+// Number of seconds between two passes of the tile group freezer
+SETTING_int(tile_group_freeze_interval,
+            "The number of seconds between two passes of the tile group freezer, which also releases decompressed copies of frozen tile groups (default: 60)",
+            60,
+            1, 86400,
+            true, true)
+
+// Number of epochs without writes after which a full tile group is cold
+SETTING_int(tile_group_cold_epochs,
+            "The number of epochs nothing must be written to a full tile group before the tile group freezer makes it immutable and compresses it (default: 1500, a minute)",
+            1500,
+            1, std::numeric_limits<int32_t>::max(),
+            true, true)
+
+// Enable or disable compacting sparse tile groups in the background
+SETTING_bool(tile_group_compaction,
+             "Move the live tuples of sparse tile groups into other tile groups in the background, and drop the emptied tile groups (default: false)",
+             false,
+             true, true)
+
+// Number of seconds between two passes of the tile group compactor
+SETTING_int(tile_group_compaction_interval,
+            "The number of seconds between two passes of the tile group compactor (default: 60)",
+            60,
+            1, 86400,
+            true, true)
+
+// Fraction of live tuples below which a full tile group is compacted
+SETTING_double(tile_group_compaction_threshold,
+               "The fraction of its slots holding live tuples below which a full tile group is compacted (default: 0.25)",
+               0.25,
+               0.0, 1.0,
+               true, true)
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
 
+// Enable or disable the write-ahead log
+SETTING_bool(logging,
+             "Enable write-ahead logging (default: false)",
+             false,
+             false, false)
+
+// Directories of the write-ahead log files, separated by commas
+SETTING_string(log_directory,
+               "Comma-separated directories of the write-ahead log files (default: ./peloton_log)",
+               "./peloton_log",
+               false, false)
+
+// Number of logger threads
+SETTING_int(log_num_threads,
+            "The number of logger threads (default: 1)",
+            1,
+            1, 128,
+            false, false)
+
+// Force the log to disk at every commit instead of once per group of epochs
+SETTING_bool(log_sync_commit,
+             "Fsync the log at every commit instead of group commit (default: false)",
+             false,
+             false, false)
+
+//===----------------------------------------------------------------------===//
+// CHECKPOINTS
+//===----------------------------------------------------------------------===//
+
+// Enable or disable the background checkpointer
+SETTING_bool(checkpointing,
+             "Enable periodic checkpoints (default: false)",
+             false,
+             false, false)
+
+// Directory of the checkpoints
+SETTING_string(checkpoint_directory,
+               "Directory of the checkpoints (default: ./peloton_checkpoint)",
+               "./peloton_checkpoint",
+               false, false)
+
+// Number of seconds between two checkpoints
+SETTING_int(checkpoint_interval,
+            "The number of seconds between two checkpoints (default: 30)",
+            30,
+            1, 86400,
+            false, false)
+
+// Number of checkpointer threads
+SETTING_int(checkpoint_num_threads,
+            "The number of threads that write a checkpoint (default: 1)",
+            1,
+            1, 128,
+            false, false)
+
 //===----------------------------------------------------------------------===//
 // ERROR REPORTING AND LOGGING
 //===----------------------------------------------------------------------===//
@@ -146,6 +248,54 @@ SETTING_int(stats_mode,
            0, 16,
            true, true)
 
+// Number of threads that collect the stats of a table
+SETTING_int(analyze_num_threads,
+            "The number of threads that collect the stats of a table (default: 4)",
+            4,
+            1, 128,
+            true, true)
+
+// Number of tuples sampled to collect the stats of a table
+SETTING_int(analyze_sample_size,
+            "The number of tuples sampled to collect the stats of a table, smaller tables are read in full (default: 30K)",
+            30 * 1000,
+            1, std::numeric_limits<int32_t>::max(),
+            true, true)
+
+// Enable or disable re-collecting the stats of modified tables
+SETTING_bool(auto_analyze,
+             "Re-collect the stats of a table once enough of its tuples are modified (default: false)",
+             false,
+             true, true)
+
+// Number of modified tuples after which a table's stats are re-collected
+SETTING_int(auto_analyze_threshold,
+            "The number of tuples that must be modified before a table's stats are re-collected (default: 1K)",
+            1000,
+            0, std::numeric_limits<int32_t>::max(),
+            true, true)
+
+// Fraction of a table that must be modified before its stats are re-collected
+SETTING_double(auto_analyze_scale_factor,
+               "The fraction of a table's tuples added to auto_analyze_threshold (default: 0.1)",
+               0.1,
+               0.0, 100.0,
+               true, true)
+
+// Size of the queue of tables waiting to be re-analyzed
+SETTING_int(auto_analyze_task_queue_size,
+            "Auto Analyze Task Queue Size (default: 32)",
+            32,
+            1, 128,
+            false, false)
+
+// Number of threads re-analyzing modified tables in the background
+SETTING_int(auto_analyze_worker_pool_size,
+            "Auto Analyze Worker Pool Size (default: 1)",
+            1,
+            1, 16,
+            false, false)
+
 //===----------------------------------------------------------------------===//
 // AI
 //===----------------------------------------------------------------------===//
@@ -204,6 +354,45 @@ SETTING_bool(codegen_interpreter,
              "Force interpretation of generated llvm code (default: false)",
              false, true, true)
 
+SETTING_bool(codegen_adaptive,
+             "Start executing generated code in the interpreter and switch to "
+             "native code once it has been compiled in the background "
+             "(default: false)",
+             false, true, true)
+
+SETTING_bool(codegen_tiered_compilation,
+             "Compile queries without optimizations first, and again with all "
+             "optimizations in the background once they are hot "
+             "(default: false)",
+             false, true, true)
+
+SETTING_int(codegen_tier_up_threshold,
+            "Number of query cache hits after which a query is hot "
+            "(default: 100)",
+            100,
+            1, 1000000,
+            true, true)
+
+SETTING_int(codegen_compile_task_queue_size,
+            "Maximum number of queries queued or running for compilation in "
+            "the background; any more are compiled later (default: 32)",
+            32,
+            8, 128,
+            false, false)
+
+SETTING_int(codegen_compile_worker_pool_size,
+            "Number of threads compiling queries in the background "
+            "(default: 2)",
+            2,
+            1, 16,
+            false, false)
+
+SETTING_string(codegen_cache_directory,
+               "Directory of the persistent cache of compiled queries, "
+               "disabled if empty (default: \"\")",
+               "",
+               false, false)
+
 SETTING_bool(print_ir_stats,
              "Print statistics on generated IR (default: false)",
              false,
@@ -227,6 +416,18 @@ SETTING_bool(hash_join_bloom_filter,
              false,
              true, true)
 
+SETTING_bool(hash_join_radix_partitioning,
+             "Enable radix-partitioned hash joins in codegen (default: true)",
+             true,
+             true, true)
+
+SETTING_int(min_radix_join_build_size,
+            "Minimum estimated number of build-side tuples before a hash join "
+                "radix partitions its inputs (default: 1M)",
+            1000 * 1000,
+            1, std::numeric_limits<int32_t>::max(),
+            true, true)
+
 SETTING_int(task_execution_timeout,
             "Maximum allowed length of time (in ms) for task "
                 "execution step of optimizer, "
@@ -21,7 +21,9 @@
 #include "common/container/lock_free_queue.h"
 #include "common/platform.h"
 #include "common/synchronization/spin_latch.h"
+#include "statistics/compilation_metric.h"
 #include "statistics/database_metric.h"
+#include "statistics/gc_metric.h"
 #include "statistics/index_metric.h"
 #include "statistics/latency_metric.h"
 #include "statistics/query_metric.h"
@@ -79,6 +81,12 @@ class BackendStatsContext {
   // Returns the latency metric
   LatencyMetric &GetTxnLatencyMetric();
 
+  // Returns the metric of the compilation of generated code
+  CompilationMetric &GetCompilationMetric() { return compilation_metric_; }
+
+  // Returns the metric of the garbage collection
+  GCMetric &GetGCMetric() { return gc_metric_; }
+
   // Increment the read stat for given tile group
   void IncrementTableReads(oid_t tile_group_id);
 
@@ -170,6 +178,12 @@ class BackendStatsContext {
   // Latencies recorded by this worker
   LatencyMetric txn_latencies_;
 
+  // Compilation of generated code done by this worker
+  CompilationMetric compilation_metric_{MetricType::COMPILATION};
+
+  // Garbage collection done and version chains walked by this worker
+  GCMetric gc_metric_{MetricType::GC};
+
   // Whether this context is registered to the global aggregator
   bool is_registered_to_aggregator_;
 
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compilation_metric.h
+//
+// Identification: src/statistics/compilation_metric.h
+//
+// Copyright (c) 2015-18, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <sstream>
+
+#include "common/internal_types.h"
+#include "statistics/counter_metric.h"
+#include "statistics/abstract_metric.h"
+
+namespace peloton {
+namespace stats {
+
+/**
+ * Metrics of the compilation of generated query code: the number of queries
+ * compiled per tier, the time spent compiling them, and the size of the
+ * generated IR.
+ */
+class CompilationMetric : public AbstractMetric {
+ public:
+  CompilationMetric(MetricType type);
+
+  //===--------------------------------------------------------------------===//
+  // ACCESSORS
+  //===--------------------------------------------------------------------===//
+
+  // Record a query compiled for the first time, along with the size of its IR
+  inline void RecordCompilation(int64_t compile_us, int64_t num_functions,
+                                int64_t num_basic_blocks,
+                                int64_t num_instructions) {
+    compilations_.Increment();
+    compile_us_.Increment(compile_us);
+    functions_.Increment(num_functions);
+    basic_blocks_.Increment(num_basic_blocks);
+    instructions_.Increment(num_instructions);
+  }
+
+  // Record a hot query compiled again with all optimizations
+  inline void RecordRecompilation(int64_t compile_us) {
+    recompilations_.Increment();
+    recompile_us_.Increment(compile_us);
+  }
+
+  inline CounterMetric &GetCompilations() { return compilations_; }
+
+  inline CounterMetric &GetCompileTime() { return compile_us_; }
+
+  inline CounterMetric &GetRecompilations() { return recompilations_; }
+
+  inline CounterMetric &GetRecompileTime() { return recompile_us_; }
+
+  inline CounterMetric &GetFunctions() { return functions_; }
+
+  inline CounterMetric &GetBasicBlocks() { return basic_blocks_; }
+
+  inline CounterMetric &GetInstructions() { return instructions_; }
+
+  //===--------------------------------------------------------------------===//
+  // HELPER METHODS
+  //===--------------------------------------------------------------------===//
+
+  inline void Reset() {
+    compilations_.Reset();
+    compile_us_.Reset();
+    recompilations_.Reset();
+    recompile_us_.Reset();
+    functions_.Reset();
+    basic_blocks_.Reset();
+    instructions_.Reset();
+  }
+
+  void Aggregate(AbstractMetric &source);
+
+  const std::string GetInfo() const;
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // Count of the number of queries compiled, and the time it took (in us)
+  CounterMetric compilations_{MetricType::COUNTER};
+  CounterMetric compile_us_{MetricType::COUNTER};
+
+  // Count of the number of hot queries compiled again with all optimizations,
+  // and the time it took (in us)
+  CounterMetric recompilations_{MetricType::COUNTER};
+  CounterMetric recompile_us_{MetricType::COUNTER};
+
+  // The size of the IR of all compiled queries
+  CounterMetric functions_{MetricType::COUNTER};
+  CounterMetric basic_blocks_{MetricType::COUNTER};
+  CounterMetric instructions_{MetricType::COUNTER};
+};
+
+}  // namespace stats
+}  // namespace peloton
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gc_metric.h
+//
+// Identification: src/statistics/gc_metric.h
+//
+// Copyright (c) 2015-18, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <sstream>
+
+#include "common/internal_types.h"
+#include "statistics/counter_metric.h"
+#include "statistics/abstract_metric.h"
+
+namespace peloton {
+namespace stats {
+
+/**
+ * Metrics of garbage collection: how far the unlinking of old versions lags
+ * behind the transactions that produced them, how much of it transactions did
+ * themselves, and how long the version chains readers walk are.
+ */
+class GCMetric : public AbstractMetric {
+ public:
+  GCMetric(MetricType type);
+
+  //===--------------------------------------------------------------------===//
+  // ACCESSORS
+  //===--------------------------------------------------------------------===//
+
+  // Record the garbage of a number of transactions unlinked, and the number
+  // of epochs it waited for in total
+  inline void RecordUnlink(int64_t num_txns, int64_t lag_epochs,
+                           bool cooperative) {
+    unlinked_txns_.Increment(num_txns);
+    lag_epochs_.Increment(lag_epochs);
+    if (cooperative) {
+      cooperative_txns_.Increment(num_txns);
+    }
+  }
+
+  // Record version chains walked by a reader, and the versions it visited
+  inline void RecordVersionChains(int64_t num_chains, int64_t num_versions) {
+    version_chains_.Increment(num_chains);
+    chain_versions_.Increment(num_versions);
+  }
+
+  inline CounterMetric &GetUnlinkedTxns() { return unlinked_txns_; }
+
+  inline CounterMetric &GetLagEpochs() { return lag_epochs_; }
+
+  inline CounterMetric &GetCooperativeTxns() { return cooperative_txns_; }
+
+  inline CounterMetric &GetVersionChains() { return version_chains_; }
+
+  inline CounterMetric &GetChainVersions() { return chain_versions_; }
+
+  //===--------------------------------------------------------------------===//
+  // HELPER METHODS
+  //===--------------------------------------------------------------------===//
+
+  inline void Reset() {
+    unlinked_txns_.Reset();
+    lag_epochs_.Reset();
+    cooperative_txns_.Reset();
+    version_chains_.Reset();
+    chain_versions_.Reset();
+  }
+
+  void Aggregate(AbstractMetric &source);
+
+  const std::string GetInfo() const;
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // Count of the transactions whose garbage was unlinked, and the epochs
+  // between their end and the unlinking summed over all of them
+  CounterMetric unlinked_txns_{MetricType::COUNTER};
+  CounterMetric lag_epochs_{MetricType::COUNTER};
+
+  // Count of the transactions whose garbage was unlinked by a transaction
+  // helping the GC threads
+  CounterMetric cooperative_txns_{MetricType::COUNTER};
+
+  // Count of the version chains walked by index lookups, and of the versions
+  // visited on them
+  CounterMetric version_chains_{MetricType::COUNTER};
+  CounterMetric chain_versions_{MetricType::COUNTER};
+};
+
+}  // namespace stats
+}  // namespace peloton
@@ -156,6 +156,13 @@ class DataTable : public AbstractTable {
 
   size_t GetTileGroupCount() const;
 
+  // Remove a tile group that no longer holds any version from the table. Its
+  // offset stays taken, and GetTileGroup() returns null for it from now on.
+  // The storage manager keeps it until the table is dropped, as the index
+  // entries of deleted tuples may still lead to its slots. Returns false if
+  // the tile group doesn't belong to the table.
+  bool DropTileGroup(const oid_t &tile_group_id);
+
   // Get a tile group with given layout
   TileGroup *GetTileGroupWithLayout(std::shared_ptr<const Layout> layout);
 
@@ -230,6 +237,14 @@ class DataTable : public AbstractTable {
 
   void ResetDirty();
 
+  // Returns the number of committed modifications since the last reset
+  size_t IncreaseModifiedTupleCount(const size_t &amount);
+
+  size_t GetModifiedTupleCount() const;
+
+  // Returns the number of modifications before the reset
+  size_t ResetModifiedTupleCount();
+
   //===--------------------------------------------------------------------===//
   // LAYOUT TUNER
   //===--------------------------------------------------------------------===//
@@ -275,6 +290,8 @@ class DataTable : public AbstractTable {
   // deprecated, use catalog::TableCatalog::GetInstance()->GetDatabaseOid()
   inline oid_t GetDatabaseOid() const { return (database_oid); }
 
+  inline bool IsCatalogTable() const { return is_catalog_; }
+
   // try to insert into all indexes.
   // the last argument is the index entry in primary index holding the new
   // tuple.
@@ -282,6 +299,11 @@ class DataTable : public AbstractTable {
                        concurrency::TransactionContext *transaction,
                        ItemPointer **index_entry_ptr);
 
+  // insert the given tuples of a tile group into all indexes, without any
+  // constraint check. used by recovery.
+  void InsertInIndexesForRecovery(storage::TileGroup *tile_group,
+                                  const std::vector<oid_t> &tuple_ids);
+
   inline static size_t GetActiveTileGroupCount() {
     return default_active_tilegroup_count_;
   }
@@ -333,6 +355,9 @@ class DataTable : public AbstractTable {
 
   oid_t AddDefaultIndirectionArray(const size_t &active_indirection_array_id);
 
+  // allocate an indirection that points to the given location
+  ItemPointer *AllocateIndirection(const ItemPointer &location);
+
   // Drop all tile groups of the table. Used by recovery
   void DropTileGroups();
 
@@ -378,6 +403,9 @@ class DataTable : public AbstractTable {
 
   const oid_t database_oid;
 
+  // whether the table is one of the system catalogs
+  const bool is_catalog_;
+
   // deprecated, use catalog::TableCatalog::GetInstance()->GetTableName()
   std::string table_name;
 
@@ -391,6 +419,9 @@ class DataTable : public AbstractTable {
 
   std::atomic<size_t> tile_group_count_ = ATOMIC_VAR_INIT(0);
 
+  // tile groups removed from the table by compaction
+  std::vector<oid_t> dropped_tile_groups_;
+
   // INDIRECTIONS
   std::vector<std::shared_ptr<storage::IndirectionArray>>
       active_indirection_arrays_;
@@ -411,6 +442,10 @@ class DataTable : public AbstractTable {
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
+  // # of tuples inserted, updated or deleted by committed transactions since
+  // the stats of the table were last collected.
+  std::atomic<size_t> modified_tuple_count_ = ATOMIC_VAR_INIT(0);
+
   // Last used layout_oid. Used while creating new layouts
   // Initialized to COLUMN_STORE_OID since its the highest predefined value.
   std::atomic<oid_t> current_layout_oid_;
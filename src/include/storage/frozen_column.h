@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_column.h
+//
+// Identification: src/include/storage/frozen_column.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "type/abstract_pool.h"
+
+namespace peloton {
+namespace storage {
+
+struct PredicateRange;
+
+//===--------------------------------------------------------------------===//
+// Frozen Column
+//
+// The compressed copy of one column of a frozen tile. Fixed-length columns
+// of at most eight bytes are encoded as 64-bit words, either with a
+// dictionary of the distinct words, as runs of equal words, or bit-packed
+// relative to the smallest word, whichever is smallest. All other columns
+// are encoded as byte strings with a dictionary, or stored one after the
+// other when most values are distinct. Varlen values are copied into the
+// column, so it doesn't depend on the tile's pool.
+//
+// Slots that don't hold a tuple are encoded like their predecessor, the
+// value they decode to is meaningless.
+//===--------------------------------------------------------------------===//
+class FrozenColumn {
+ public:
+  enum class Encoding { DICTIONARY, RUN_LENGTH, BIT_PACKED, PLAIN };
+
+  FrozenColumn(type::TypeId type, size_t offset, size_t length);
+
+  DISALLOW_COPY_AND_MOVE(FrozenColumn);
+
+  // Encode the column from the tuple slots of a tile. Only the slots marked
+  // live are read.
+  void Encode(const char *data, size_t tuple_length,
+              const std::vector<bool> &live);
+
+  // Write the column back into the tuple slots of a tile, allocating its
+  // varlen values from the given pool
+  void Decode(char *data, size_t tuple_length, type::AbstractPool *pool) const;
+
+  // Can any value of the column fall in the predicate's range? This is exact
+  // for dictionary and run-length encoded columns of types zone maps track,
+  // and conservative for everything else.
+  bool MayMatch(const PredicateRange &predicate) const;
+
+  Encoding GetEncoding() const { return encoding_; }
+
+  // The bytes used by the encoded values
+  size_t GetSize() const;
+
+ private:
+  void EncodeWords(const char *data, size_t tuple_length,
+                   const std::vector<bool> &live);
+  void EncodeBytes(const char *data, size_t tuple_length,
+                   const std::vector<bool> &live);
+  void DecodeWords(char *data, size_t tuple_length) const;
+  void DecodeBytes(char *data, size_t tuple_length,
+                   type::AbstractPool *pool) const;
+
+ private:
+  // The column's place in the tile
+  type::TypeId type_;
+  size_t offset_;
+  size_t length_;
+
+  // Varlen columns hold pointers to their values, other columns of at most
+  // eight bytes are encoded as words
+  bool is_varlen_;
+  bool is_word_;
+
+  Encoding encoding_;
+  oid_t num_slots_;
+
+  // Bit-packed codes of the slots. For dictionaries these index the
+  // dictionary, for bit-packed words they are the offset from base_.
+  std::vector<uint64_t> codes_;
+  uint32_t code_width_;
+  uint64_t base_;
+
+  // The dictionary, or the value of every run
+  std::vector<uint64_t> words_;
+
+  // One past the last slot of every run
+  std::vector<oid_t> run_ends_;
+
+  // The dictionary of byte strings, or the values of all slots back to back
+  std::vector<std::string> strings_;
+  std::string heap_;
+  std::vector<uint32_t> heap_offsets_;
+
+  // NULL varlen slots, empty when there are none
+  std::vector<bool> nulls_;
+
+  // The sorted zone map keys of the distinct non-NULL values of dictionary
+  // and run-length encoded columns, if the zone map tracks their type
+  bool has_keys_;
+  std::vector<int64_t> keys_;
+};
+
+}  // namespace storage
+}  // namespace peloton
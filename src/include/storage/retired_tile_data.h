@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// retired_tile_data.h
+//
+// Identification: src/include/storage/retired_tile_data.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+
+namespace peloton {
+
+namespace type {
+class AbstractPool;
+}  // namespace type
+
+namespace storage {
+
+// The uncompressed tuple slots and varlen pool handed over by a frozen tile,
+// to be freed once no reader can still be using them
+struct RetiredTileData {
+  char *data;
+  type::AbstractPool *pool;
+};
+
+//===--------------------------------------------------------------------===//
+// Retired Tile Data List
+//
+// Holds the tuples released by tile groups along with the epoch they were
+// released in. Readers that got them started in that epoch or before, so
+// they're freed once it has expired. Used by a single background thread.
+//===--------------------------------------------------------------------===//
+class RetiredTileDataList {
+ public:
+  RetiredTileDataList() = default;
+
+  ~RetiredTileDataList() { Free(MAX_EID); }
+
+  DISALLOW_COPY_AND_MOVE(RetiredTileDataList);
+
+  // Keep the tuples released in the given epoch
+  void Retire(const std::vector<RetiredTileData> &released, eid_t epoch_id);
+
+  // Free the released tuples no reader can still use
+  void Free(eid_t expired_epoch_id);
+
+  size_t GetSize() const { return retired_.size(); }
+
+ private:
+  std::vector<std::pair<eid_t, RetiredTileData>> retired_;
+};
+
+}  // namespace storage
+}  // namespace peloton
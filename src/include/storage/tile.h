@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 #include "catalog/manager.h"
 #include "catalog/schema.h"
 #include "common/item_pointer.h"
+#include "common/macros.h"
 #include "common/printable.h"
+#include "storage/retired_tile_data.h"
 #include "type/abstract_pool.h"
 #include "type/serializeio.h"
 #include "type/serializer.h"
@@ -38,6 +42,7 @@ class Tuple;
 class TileGroup;
 class TileGroupHeader;
 class TupleIterator;
+class FrozenColumn;
 
 /**
  * Represents a Tile.
@@ -177,6 +182,26 @@ class Tile : public Printable {
   // Sync the contents
   void Sync();
 
+  //===--------------------------------------------------------------------===//
+  // Freezing
+  //===--------------------------------------------------------------------===//
+
+  // Compress the tuples of the tile. Its tuples must no longer be written.
+  // Returns false if the tile was already frozen.
+  bool Freeze();
+
+  bool IsFrozen() const { return frozen.load(std::memory_order_acquire); }
+
+  // The compressed copy of a column of a frozen tile
+  const FrozenColumn &GetFrozenColumn(const oid_t column_id) const {
+    return *frozen_columns[column_id];
+  }
+
+  // Hand over the uncompressed tuples of a frozen tile, if it has them. They
+  // are decompressed again the next time they're accessed, which marks the
+  // tile group as accessed.
+  void ReleaseTupleData(std::vector<RetiredTileData> &retired);
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -194,14 +219,17 @@ class Tile : public Printable {
   // tile schema
   catalog::Schema schema;
 
-  // set of fixed-length tuple slots
-  char *data;
+  // set of fixed-length tuple slots, released while the tile is frozen. It is
+  // only swapped under freeze_mutex, and a released copy is freed once no
+  // reader can still use it. Readers load it without the mutex, so it's
+  // published with a release store once the decompressed tuples are in place.
+  mutable std::atomic<char *> data;
 
   // relevant tile group
   TileGroup *tile_group;
 
   // storage pool for uninlined data
-  type::AbstractPool *pool;
+  mutable type::AbstractPool *pool;
 
   // number of tuple slots allocated
   oid_t num_tuple_slots;
@@ -228,12 +256,28 @@ class Tile : public Printable {
    * This is maintained by shared Tile Header.
    */
   TileGroupHeader *tile_group_header;
+
+  // The compressed columns of a frozen tile
+  std::vector<std::unique_ptr<FrozenColumn>> frozen_columns;
+  std::atomic<bool> frozen;
+
+  // Serializes freezing and decompressing the tile, and the GC freeing
+  // varlen values from its pool
+  mutable std::mutex freeze_mutex;
+
+ private:
+  // Decompress the tuples of a frozen tile that were released
+  char *Thaw() const;
 };
 
 // Returns a pointer to the tuple requested. No checks are done that the index
 // is valid.
 inline char *Tile::GetTupleLocation(const oid_t tuple_offset) const {
-  char *tuple_location = data + (tuple_offset * tuple_length);
+  char *tile_data = data.load(std::memory_order_acquire);
+  if (unlikely_branch(tile_data == nullptr)) {
+    tile_data = Thaw();
+  }
+  char *tuple_location = tile_data + (tuple_offset * tuple_length);
 
   return tuple_location;
 }
@@ -241,17 +285,20 @@ inline char *Tile::GetTupleLocation(const oid_t tuple_offset) const {
 // Finds index of tuple for a given tuple address.
 // Returns -1 if no matching tuple was found
 inline int Tile::GetTupleOffset(const char *tuple_address) const {
+  const char *tile_data = data.load(std::memory_order_acquire);
+
   // check if address within tile bounds
-  if ((tuple_address < data) || (tuple_address >= (data + tile_size)))
+  if ((tile_data == nullptr) || (tuple_address < tile_data) ||
+      (tuple_address >= (tile_data + tile_size)))
     return -1;
 
   int tuple_id = 0;
 
   // check if address is at an offset that is an integral multiple of tuple
   // length
-  tuple_id = (tuple_address - data) / tuple_length;
+  tuple_id = (tuple_address - tile_data) / tuple_length;
 
-  if (tuple_id * tuple_length + data == tuple_address) return tuple_id;
+  if (tuple_id * tuple_length + tile_data == tuple_address) return tuple_id;
 
   return -1;
 }
@@ -53,6 +53,9 @@ class TileGroupHeader;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
+class ZoneMap;
+struct PredicateRange;
+struct RetiredTileData;
 
 /**
  * Represents a group of tiles logically horizontally contiguous.
@@ -106,6 +109,19 @@ class TileGroup : public Printable {
   oid_t InsertTupleFromCheckpoint(oid_t tuple_slot_id, const Tuple *tuple,
                                   cid_t commit_id);
 
+  // end the lifetime of the version at specific tuple slot as of commit_id,
+  // and point it to the version that replaced it, unless the slot holds a
+  // version newer than commit_id. returns INVALID_OID if the version is kept.
+  // used by recovery mode
+  oid_t InvalidateTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
+                                    ItemPointer new_location);
+
+  // point the version that commit_id created at specific tuple slot to the
+  // version it replaced, unless the slot holds another version.
+  // used by recovery mode
+  oid_t LinkTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
+                              ItemPointer old_location);
+
   //===--------------------------------------------------------------------===//
   // Utilities
   //===--------------------------------------------------------------------===//
@@ -164,6 +180,42 @@ class TileGroup : public Printable {
   // Get the layout of the TileGroup. Used to locate columns.
   const storage::Layout &GetLayout() const { return *tile_group_layout_; }
 
+  // Get the zone map of the TileGroup. Used to skip it in scans.
+  ZoneMap *GetZoneMap() const { return zone_map_.get(); }
+
+  //===--------------------------------------------------------------------===//
+  // Freezing
+  //===--------------------------------------------------------------------===//
+
+  // Compress the tiles of an immutable tile group. The caller must make sure
+  // no tuple is still being written to it. Returns false if the tile group
+  // was already frozen.
+  bool Freeze();
+
+  bool IsFrozen() const { return frozen_.load(std::memory_order_acquire); }
+
+  // Hand over the uncompressed tuples of a frozen tile group's tiles
+  void ReleaseTupleData(std::vector<RetiredTileData> &retired);
+
+  // Note that a reader uses the uncompressed tuples of a frozen tile group,
+  // so the freezer keeps them for another pass
+  void MarkAccessed() const {
+    if (IsFrozen() && !accessed_.load(std::memory_order_relaxed)) {
+      accessed_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Was the tile group accessed since the last call?
+  bool ClearAccessed() {
+    return accessed_.load(std::memory_order_relaxed) &&
+           accessed_.exchange(false, std::memory_order_relaxed);
+  }
+
+  // Can any tuple of a frozen tile group satisfy all the given predicates?
+  // Unlike the zone map, this also rules out values between the min and max.
+  bool ShouldScanFrozen(const PredicateRange *predicates,
+                        uint32_t num_predicates) const;
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -196,6 +248,16 @@ class TileGroup : public Printable {
 
   // Refernce to the layout of the TileGroup
   std::shared_ptr<const Layout> tile_group_layout_;
+
+  // The min/max of every column, maintained as tuples are written
+  std::unique_ptr<ZoneMap> zone_map_;
+
+  // Whether the tiles were compressed
+  std::atomic<bool> frozen_;
+
+  // Whether the tuples of a frozen tile group were read since the freezer's
+  // last pass
+  mutable std::atomic<bool> accessed_;
 };
 
 }  // namespace storage
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor.h
+//
+// Identification: src/include/storage/tile_group_compactor.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "storage/retired_tile_data.h"
+
+namespace peloton {
+
+namespace concurrency {
+class TransactionContext;
+}  // namespace concurrency
+
+namespace storage {
+
+class DataTable;
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Compactor
+//
+// Moves the live tuples of sparse tile groups into other tile groups in the
+// background, and drops the tile groups once they are empty. A tile group is
+// sparse once all its slots were handed out and less than the compaction
+// threshold of them hold live tuples.
+//
+// A sparse tile group is first made immutable, so the GC stops recycling its
+// slots. Once every transaction that was running at the time has finished,
+// its live tuples are moved by updating them to an identical new version
+// elsewhere in the table. The update points their indirection to the new
+// version, so index entries stay valid. The old versions are reclaimed by the
+// GC like any other, after which the tile group holds no version and is
+// dropped from the table. Its tuples are compressed away like those of a
+// frozen tile group, and freed once the epoch they were released in has
+// expired, as scans may still be reading them.
+//===--------------------------------------------------------------------===//
+class TileGroupCompactor {
+ public:
+  static TileGroupCompactor &GetInstance();
+
+  DISALLOW_COPY_AND_MOVE(TileGroupCompactor);
+
+  // Start compacting with the given number of seconds between passes
+  void StartCompacting(int interval);
+
+  void StopCompacting();
+
+  // Go over the tile groups of all tables once
+  void CompactTileGroups();
+
+ private:
+  TileGroupCompactor() = default;
+
+  ~TileGroupCompactor();
+
+  void Running(int interval);
+
+  // Go over the tile groups of the given table once. Returns the number of
+  // tile groups dropped.
+  size_t CompactTable(DataTable *table);
+
+  // Move the live tuples of the tile group visible to the transaction.
+  // Returns the number of tuples moved.
+  size_t MoveTuples(DataTable *table, TileGroup *tile_group,
+                    concurrency::TransactionContext *txn);
+
+ private:
+  // The epoch in which each sparse tile group was made immutable
+  std::unordered_map<oid_t, eid_t> sparse_tile_groups_;
+
+  // Released tuples of dropped tile groups, with the epoch they were
+  // released in
+  RetiredTileDataList retired_;
+
+  std::thread compactor_thread_;
+  bool is_running_ = false;
+  std::mutex mutex_;
+  std::condition_variable stop_cv_;
+};
+
+}  // namespace storage
+}  // namespace peloton
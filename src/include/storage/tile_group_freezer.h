@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.h
+//
+// Identification: src/include/storage/tile_group_freezer.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "storage/retired_tile_data.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Freezer
+//
+// Compresses cold tile groups in the background. A tile group is cold once
+// all its slots were handed out and no transaction wrote to it for
+// tile_group_cold_epochs epochs. The freezer then makes it immutable, so its
+// tuples are only read from then on. It's frozen as soon as every
+// transaction that was running when it was first seen cold has finished, so
+// no tuple is still being written to it.
+//
+// Every pass also releases the uncompressed tuples of frozen tile groups
+// that weren't accessed since the last pass, including those decompressed
+// again by readers. They are freed once the epoch they were released in has
+// expired.
+//===--------------------------------------------------------------------===//
+class TileGroupFreezer {
+ public:
+  static TileGroupFreezer &GetInstance();
+
+  DISALLOW_COPY_AND_MOVE(TileGroupFreezer);
+
+  // Start freezing with the given number of seconds between passes
+  void StartFreezing(int interval);
+
+  void StopFreezing();
+
+  // Go over all the tile groups once
+  void FreezeTileGroups();
+
+ private:
+  TileGroupFreezer() = default;
+
+  ~TileGroupFreezer();
+
+  void Running(int interval);
+
+ private:
+  // The epoch in which each cold, not yet frozen tile group was first seen
+  std::unordered_map<oid_t, eid_t> cold_tile_groups_;
+
+  // Released tuples, with the epoch they were released in
+  RetiredTileDataList retired_;
+
+  std::thread freezer_thread_;
+  bool is_running_ = false;
+  std::mutex mutex_;
+  std::condition_variable stop_cv_;
+};
+
+}  // namespace storage
+}  // namespace peloton
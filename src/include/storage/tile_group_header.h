@@ -88,6 +88,7 @@ class TileGroupHeader : public Printable {
     num_tuple_slots = other.num_tuple_slots;
     next_tuple_slot.store(other.next_tuple_slot);
     immutable = other.immutable;
+    last_write_epoch_id.store(other.last_write_epoch_id.load());
 
     // copy tuple header values
     for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
@@ -263,6 +264,21 @@ class TileGroupHeader : public Printable {
 
   inline bool GetImmutability() const { return immutable; }
 
+  /*
+  * @brief Record that a transaction of the given epoch wrote to the
+  tilegroup. The freezer only makes a tilegroup immutable once nothing was
+  written to it for a while.
+  */
+  inline void RecordWrite(const eid_t epoch_id) {
+    if (last_write_epoch_id.load(std::memory_order_relaxed) < epoch_id) {
+      last_write_epoch_id.store(epoch_id, std::memory_order_relaxed);
+    }
+  }
+
+  inline eid_t GetLastWriteEpochId() const {
+    return last_write_epoch_id.load(std::memory_order_relaxed);
+  }
+
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
   // Getter for spin lock
@@ -301,6 +317,9 @@ class TileGroupHeader : public Printable {
   // Immmutable Flag. Should be set by the indextuner to be true.
   // By default it will be set to false.
   bool immutable;
+
+  // The latest epoch of a transaction that wrote to the tilegroup
+  std::atomic<eid_t> last_write_epoch_id;
 };
 
 }  // namespace storage
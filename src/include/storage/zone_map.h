@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.h
+//
+// Identification: src/include/storage/zone_map.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "common/synchronization/spin_latch.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+class TileGroup;
+struct PredicateInfo;
+
+//===--------------------------------------------------------------------===//
+// A zone-mappable predicate on a single column, encoded as the closed range
+// of zone map keys that a column's values must overlap for any of them to
+// satisfy the predicate. An empty range (low > high) matches nothing.
+//===--------------------------------------------------------------------===//
+struct PredicateRange {
+  uint32_t col_id;
+  int64_t low;
+  int64_t high;
+};
+
+//===--------------------------------------------------------------------===//
+// Zone Map
+//
+// The minimum and maximum of every fixed-length numeric column of a tile
+// group, kept in memory alongside the tile group. Values are stored as
+// order-preserving 64-bit keys in two packed arrays, so checking a scan's
+// predicates against a tile group is a few integer comparisons per predicate.
+//
+// The ranges are widened whenever a tuple is written, and never narrowed on
+// deletes or overwrites, which keeps them safe (if loose) for pruning. Writers
+// widen them with compare-and-swap, without taking a latch. They're only
+// recomputed from scratch when the tile group is frozen, since writers that
+// got a slot before it was made immutable may still be widening them until
+// then. NULLs never satisfy a comparison, so they aren't included in the
+// ranges.
+//===--------------------------------------------------------------------===//
+class ZoneMap {
+ public:
+  explicit ZoneMap(const TileGroup &tile_group);
+
+  DISALLOW_COPY_AND_MOVE(ZoneMap);
+
+  // Widen the ranges to include the tuple in the given slot
+  void Update(oid_t tuple_slot);
+
+  // Widen the range of a column to include its value in the given slot
+  void UpdateColumn(oid_t column_id, oid_t tuple_slot);
+
+  // Recompute the ranges from all the tuples in the tile group. Nothing may
+  // write the tile group meanwhile or later on, i.e., it is being frozen or
+  // not published yet. Writes racing a rebuild would be lost.
+  void Rebuild();
+
+  // Can any tuple in the tile group satisfy all the given predicates?
+  bool ShouldScan(const PredicateRange *predicates, uint32_t num_predicates);
+
+  // Is the given column tracked by the zone map?
+  bool IsTracked(oid_t column_id) const {
+    return IsTrackedType(columns_[column_id].type);
+  }
+
+  // Does the given column have no non-NULL values?
+  bool IsEmpty(oid_t column_id) const;
+
+  // The minimum and maximum of a tracked, non-empty column
+  type::Value GetMinValue(oid_t column_id) const;
+  type::Value GetMaxValue(oid_t column_id) const;
+
+  // Encode a parsed predicate on a column of the given type. Returns false if
+  // the predicate can't be checked against a zone map.
+  static bool EncodePredicate(type::TypeId column_type,
+                              const PredicateInfo &predicate,
+                              PredicateRange &range);
+
+  // Do zone maps track columns of the given type?
+  static bool IsTrackedType(type::TypeId type);
+
+  // Encode the value of the given type stored at the given location. Returns
+  // false if the value is NULL or its type isn't tracked.
+  static bool EncodeKey(type::TypeId type, const char *data, int64_t &key);
+
+ private:
+  // Read the key of a column in the given tuple slot. Returns false if the
+  // value is NULL.
+  bool ReadKey(oid_t column_id, oid_t tuple_slot, int64_t &key) const;
+
+  static int64_t EncodeDecimal(double val);
+  static double DecodeDecimal(int64_t key);
+
+  type::Value DecodeKey(oid_t column_id, int64_t key) const;
+
+ private:
+  // Where the values of a column live in the tile group
+  struct ColumnInfo {
+    type::TypeId type;
+    oid_t tile_offset;
+    size_t offset;
+  };
+
+  // The tile group this zone map is for
+  const TileGroup &tile_group_;
+
+  std::vector<ColumnInfo> columns_;
+
+  // The columns whose ranges are kept
+  std::vector<oid_t> tracked_columns_;
+
+  // The packed ranges, indexed by column. Untracked columns have the full
+  // range, and columns without values an empty one.
+  std::unique_ptr<std::atomic<int64_t>[]> min_;
+  std::unique_ptr<std::atomic<int64_t>[]> max_;
+
+  // Serializes rebuilds of the ranges
+  common::synchronization::SpinLatch latch_;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -20,6 +20,10 @@
 
 namespace peloton {
 
+namespace catalog {
+class Schema;
+}  // namespace catalog
+
 namespace concurrency {
 class TransactionContext;
 }  // namespace concurrency
@@ -28,6 +32,7 @@ namespace storage {
 
 class DataTable;
 class TileGroup;
+struct PredicateRange;
 
 struct PredicateInfo {
   int col_id;
@@ -70,6 +75,10 @@ class ZoneMapManager {
                            int32_t num_predicates, storage::DataTable *table,
                            int64_t tile_group_id);
 
+  static int32_t EncodePredicates(
+      const storage::PredicateInfo *parsed_predicates, int32_t num_predicates,
+      const catalog::Schema &schema, storage::PredicateRange *predicate_ranges);
+
   bool ZoneMapTableExists();
 
  private:
@@ -86,35 +95,6 @@ class ZoneMapManager {
   std::unique_ptr<ZoneMapManager::ColumnStatistics> GetResultVectorAsZoneMap(
       std::unique_ptr<std::vector<type::Value>> &result_vector);
 
-  static bool CheckEqual(const type::Value &predicate_val,
-                         ColumnStatistics *stats) {
-    const type::Value &min = stats->min;
-    const type::Value &max = stats->max;
-    return (min.CompareLessThanEquals(predicate_val)) == CmpBool::CmpTrue &&
-           (max.CompareGreaterThanEquals(predicate_val) == CmpBool::CmpTrue);
-  }
-
-  static bool CheckLessThan(const type::Value &predicate_val,
-                            ColumnStatistics *stats) {
-    return predicate_val.CompareGreaterThan(stats->min) == CmpBool::CmpTrue;
-  }
-
-  static bool CheckLessThanEquals(const type::Value &predicate_val,
-                                  ColumnStatistics *stats) {
-    return predicate_val.CompareGreaterThanEquals(stats->min) ==
-           CmpBool::CmpTrue;
-  }
-
-  static bool CheckGreaterThan(const type::Value &predicate_val,
-                               ColumnStatistics *stats) {
-    return predicate_val.CompareLessThan(stats->max) == CmpBool::CmpTrue;
-  }
-
-  static bool CheckGreaterThanEquals(const type::Value &predicate_val,
-                                     ColumnStatistics *stats) {
-    return predicate_val.CompareLessThanEquals(stats->max) == CmpBool::CmpTrue;
-  }
-
   //===--------------------------------------------------------------------===//
   // Data Members
   //===--------------------------------------------------------------------===//
@@ -42,6 +42,8 @@ class MonoQueuePool {
   // TODO(Tianyu): Rename to (Brain)QueryHistoryLog or something
   static MonoQueuePool &GetBrainInstance();
   static MonoQueuePool &GetExecutionInstance();
+  static MonoQueuePool &GetCompilationInstance();
+  static MonoQueuePool &GetAnalyzeInstance();
 
  private:
   TaskQueue task_queue_;
@@ -137,5 +139,39 @@ inline MonoQueuePool &MonoQueuePool::GetExecutionInstance() {
   return brain_queue_pool;
 }
 
+inline MonoQueuePool &MonoQueuePool::GetCompilationInstance() {
+  int32_t task_queue_size = settings::SettingsManager::GetInt(
+      settings::SettingId::codegen_compile_task_queue_size);
+  int32_t worker_pool_size = settings::SettingsManager::GetInt(
+      settings::SettingId::codegen_compile_worker_pool_size);
+
+  PELOTON_ASSERT(task_queue_size > 0);
+  PELOTON_ASSERT(worker_pool_size > 0);
+
+  std::string name = "compilation-pool";
+
+  static MonoQueuePool compilation_queue_pool(
+      name, static_cast<uint32_t>(task_queue_size),
+      static_cast<uint32_t>(worker_pool_size));
+  return compilation_queue_pool;
+}
+
+inline MonoQueuePool &MonoQueuePool::GetAnalyzeInstance() {
+  int32_t task_queue_size = settings::SettingsManager::GetInt(
+      settings::SettingId::auto_analyze_task_queue_size);
+  int32_t worker_pool_size = settings::SettingsManager::GetInt(
+      settings::SettingId::auto_analyze_worker_pool_size);
+
+  PELOTON_ASSERT(task_queue_size > 0);
+  PELOTON_ASSERT(worker_pool_size > 0);
+
+  std::string name = "analyze-pool";
+
+  static MonoQueuePool analyze_queue_pool(
+      name, static_cast<uint32_t>(task_queue_size),
+      static_cast<uint32_t>(worker_pool_size));
+  return analyze_queue_pool;
+}
+
 }  // namespace threadpool
 }  // namespace peloton
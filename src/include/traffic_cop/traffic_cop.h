@@ -12,8 +12,12 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
 #include <stack>
+#include <thread>
 #include <vector>
 
 // Libevent 2.0
@@ -22,6 +26,7 @@
 #include "catalog/column.h"
 #include "common/internal_types.h"
 #include "common/portal.h"
+#include "common/result_batch.h"
 #include "common/statement.h"
 #include "executor/plan_executor.h"
 #include "optimizer/abstract_optimizer.h"
@@ -127,6 +132,40 @@ class TrafficCop {
 
   std::vector<ResultValue> &GetResult() { return result_; }
 
+  // Hand the result rows of queued statements over in batches while they
+  // execute, rather than all at once when they complete. The task callback
+  // is then invoked for every batch, besides the completion. Such statements
+  // run on a thread of this traffic cop's own, see stream_thread_.
+  void SetStreamResults(bool stream_results) {
+    stream_results_ = stream_results;
+  }
+
+  bool GetStreamResults() { return stream_results_; }
+
+  // Move the result batches produced so far to the end of
+  // GetResultBatches(). Returns true once the statement has completed, and
+  // all of its rows are there.
+  bool FetchResultBatches();
+
+  // The fetched batches of rows of a streamed result
+  std::deque<ResultBatch> &GetResultBatches() { return fetched_batches_; }
+
+  // Make the executing statement drop the rows it has yet to hand over and
+  // stop producing more, without waiting for it. FetchResultBatches() tells
+  // once it completed, and its result is then collected as usual, e.g. with
+  // ExecuteStatementPlanGetResult().
+  void CancelResultStream();
+
+  // Same as above, except that it waits for the statement to complete
+  void DiscardResultBatches();
+
+  // Create the pipe that feeds the client's data to the next statement that
+  // is executed, a COPY FROM STDIN. The task callback is invoked when the
+  // pipe has room again, after a write found it full. The statement reads
+  // the pipe on the stream thread, so it never holds up a pool worker while
+  // it waits for the client.
+  std::shared_ptr<util::Pipe> OpenCopyInput();
+
   void SetParamVal(std::vector<type::Value> param_values) {
     param_values_ = std::move(param_values);
   }
@@ -174,6 +213,35 @@ class TrafficCop {
 
   std::vector<ResultValue> result_;
 
+  // Whether result rows are streamed, and the batches of the executing
+  // statement that are yet to be fetched. The producing thread waits while
+  // MAX_PENDING_RESULT_BATCHES are pending.
+  bool stream_results_ = false;
+  std::mutex result_batch_mutex_;
+  std::condition_variable result_batch_cv_;
+  std::deque<ResultBatch> result_batches_;
+  bool execution_done_ = true;
+  bool result_stream_closed_ = false;
+
+  // The batches fetched by the connection, which it has yet to send
+  std::deque<ResultBatch> fetched_batches_;
+
+  // The thread that executes the statements whose results are streamed, and
+  // those that read a COPY FROM STDIN. These wait on the client whenever it
+  // reads slower than they produce rows, leaves their portal suspended, or
+  // has yet to send the data, so they must not hold up a worker of the
+  // shared pool. The thread is started by the first of them,
+  // and picks up stream_task_ under result_batch_mutex_.
+  std::thread stream_thread_;
+  std::condition_variable stream_task_cv_;
+  std::function<void()> stream_task_;
+  bool stream_thread_stop_ = false;
+
+  // The input of the COPY FROM STDIN that is about to be executed, and of
+  // the one that executes
+  std::shared_ptr<util::Pipe> copy_input_;
+  std::shared_ptr<util::Pipe> executing_copy_input_;
+
   // The current callback to be invoked after execution completes.
   void (*task_callback_)(void *);
   void *task_callback_arg_;
@@ -191,6 +259,19 @@ class TrafficCop {
 
   ResultType AbortQueryHelper();
 
+  // Called from the thread executing the statement. Returns false once the
+  // stream is cancelled, and the statement may stop producing rows.
+  bool PushResultBatch(ResultBatch &&batch);
+
+  // Execute the task on the stream thread, starting it if needed. The
+  // previous task has completed by the time the next one is submitted.
+  void RunStreamTask(std::function<void()> task);
+
+  void StreamThreadMain();
+
+  // Stop the stream thread, once its task has completed
+  void StopStreamThread();
+
   // Get all data tables from a TableRef.
   // For multi-way join
   // still a HACK
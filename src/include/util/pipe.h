@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// pipe.h
+//
+// Identification: src/include/util/pipe.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "common/macros.h"
+
+namespace peloton {
+namespace util {
+
+/**
+ * An in-memory stream of bytes from one thread to another, e.g. the data of a
+ * COPY FROM STDIN from the connection to the thread that executes the COPY.
+ *
+ * The writer never blocks. Once the pipe holds more than its capacity, Write()
+ * tells the writer to hold back, and the room callback is invoked when the
+ * reader has drained the pipe below its capacity again. The reader blocks
+ * until there is data, or the writer closes or fails the pipe.
+ */
+class Pipe {
+ public:
+  // 1MB of pending data
+  static constexpr uint64_t kDefaultCapacity = (1ul << 20ul);
+
+  explicit Pipe(uint64_t capacity = kDefaultCapacity) : capacity_(capacity) {}
+
+  DISALLOW_COPY_AND_MOVE(Pipe);
+
+  /**
+   * Append bytes to the pipe.
+   *
+   * @return false if the pipe is full, and the writer should wait for the
+   * room callback before writing more
+   */
+  bool Write(const void *data, uint64_t len);
+
+  /**
+   * Signal the end of the data. Read() returns 0 once the pipe is drained.
+   */
+  void Close();
+
+  /**
+   * Signal that the data is incomplete. Read() throws with the message.
+   */
+  void Fail(const std::string &message);
+
+  /**
+   * Read up to len bytes, waiting until some are available.
+   *
+   * @return The number of bytes read, 0 at the end of the data
+   */
+  uint64_t Read(void *data, uint64_t len);
+
+  /**
+   * Does the pipe have room for more bytes
+   */
+  bool HasRoom();
+
+  /**
+   * Set the function invoked from the reader when the pipe has room again,
+   * after a Write() returned false
+   */
+  void SetRoomCallback(std::function<void()> on_room) {
+    on_room_ = std::move(on_room);
+  }
+
+ private:
+  // The maximum number of pending bytes before the writer is held back
+  const uint64_t capacity_;
+
+  std::mutex mutex_;
+  std::condition_variable data_cv_;
+
+  // The chunks written but not yet read, the number of bytes of the first
+  // chunk that have been read, and the number of pending bytes
+  std::deque<std::string> chunks_;
+  uint64_t chunk_pos_ = 0;
+  uint64_t size_ = 0;
+
+  bool closed_ = false;
+  bool failed_ = false;
+  std::string error_message_;
+
+  // Whether the writer waits for the room callback
+  bool writer_waiting_ = false;
+  std::function<void()> on_room_;
+};
+
+}  // namespace util
+}  // namespace peloton
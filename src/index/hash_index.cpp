@@ -0,0 +1,322 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.cpp
+//
+// Identification: src/index/hash_index.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "index/hash_index.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "index/index_key.h"
+#include "index/index_util.h"
+#include "index/scan_optimizer.h"
+#include "settings/settings_manager.h"
+#include "statistics/stats_aggregator.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace index {
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+HASH_INDEX_TYPE::HashIndex(IndexMetadata *metadata)
+    :  // Base class
+      Index{metadata},
+      // Value equality checker
+      value_equals{},
+      // The hash map itself
+      container{},
+      key_hasher_{},
+      num_values_{0} {
+  return;
+}
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+HASH_INDEX_TYPE::~HashIndex() {}
+
+/*
+ * IsStatsEnabled() - Whether index accesses are counted
+ */
+static inline bool IsStatsEnabled() {
+  return static_cast<StatsType>(settings::SettingsManager::GetInt(
+             settings::SettingId::stats_mode)) != StatsType::INVALID;
+}
+
+/*
+ * InsertEntry() - insert a key-value pair into the map
+ *
+ * If the key value pair already exists in the map, or the index has unique
+ * keys and the key already exists, just return false
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
+                                  ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool unique_keys = HasUniqueKeys();
+  bool ret = true;
+  auto &latch = GetKeyLatch(index_key);
+  latch.Lock();
+  container.UpsertFn(index_key,
+                     [&](std::vector<ValueType> &values) {
+                       for (auto &existing_value : values) {
+                         if (unique_keys == true ||
+                             value_equals(existing_value, value) == true) {
+                           ret = false;
+                           return;
+                         }
+                       }
+                       values.push_back(value);
+                     },
+                     std::vector<ValueType>{value});
+  latch.Unlock();
+
+  if (ret == true) {
+    num_values_.fetch_add(1);
+  }
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  LOG_TRACE("InsertEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(), (ret ? "SUCCESS" : "FAIL"));
+
+  return ret;
+}
+
+/*
+ * DeleteEntry() - Removes a key-value pair
+ *
+ * If the key-value pair does not exists yet in the map return false
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
+                                  ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = false;
+  bool is_empty = false;
+  auto &latch = GetKeyLatch(index_key);
+  latch.Lock();
+  container.UpdateFn(index_key, [&](std::vector<ValueType> &values) {
+    for (auto it = values.begin(); it != values.end(); ++it) {
+      if (value_equals(*it, value) == true) {
+        values.erase(it);
+        ret = true;
+        break;
+      }
+    }
+    is_empty = values.empty();
+  });
+  // The key goes away together with its last value. No insert of the key can
+  // happen in between, since it needs the latch of the key
+  if (is_empty == true) {
+    container.Erase(index_key);
+  }
+  latch.Unlock();
+
+  if (ret == true) {
+    num_values_.fetch_sub(1);
+  }
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
+        (ret ? 1 : 0), metadata);
+  }
+
+  LOG_TRACE("DeleteEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(), (ret ? "SUCCESS" : "FAIL"));
+
+  return ret;
+}
+
+/*
+ * CondInsertEntry() - insert a key-value pair unless the predicate holds for
+ *                     one of the values of the key
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::CondInsertEntry(
+    const storage::Tuple *key, ItemPointer *value,
+    std::function<bool(const void *)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = true;
+  auto &latch = GetKeyLatch(index_key);
+  latch.Lock();
+  container.UpsertFn(index_key,
+                     [&](std::vector<ValueType> &values) {
+                       for (auto &existing_value : values) {
+                         if (predicate(existing_value) == true ||
+                             value_equals(existing_value, value) == true) {
+                           ret = false;
+                           return;
+                         }
+                       }
+                       values.push_back(value);
+                     },
+                     std::vector<ValueType>{value});
+  latch.Unlock();
+
+  if (ret == true) {
+    num_values_.fetch_add(1);
+  }
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  return ret;
+}
+
+/*
+ * Scan() - Scans the index using index scan optimizer
+ *
+ * Only point queries can use the hash map. Everything else returns all the
+ * values of the index, and the executor filters them
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::Scan(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
+    std::vector<ValueType> &result, const ConjunctionScanPredicate *csp_p) {
+  if (csp_p->IsPointQuery() == true) {
+    ScanKey(csp_p->GetPointQueryKey(), result);
+  } else {
+    LOG_TRACE("Hash index %s has to scan all keys", GetName().c_str());
+    ScanAllKeys(result);
+  }
+
+  return;
+}
+
+/*
+ * ScanLimit() - Scan the index with predicate and limit/offset
+ *
+ * The values of a point query all match the key, so any offset + limit of
+ * them are returned, and the executor skips the offset. Like the Bw-Tree,
+ * the index cannot tell which of them are visible. Other scans have to
+ * return every value for the executor to filter
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanLimit(
+    const std::vector<type::Value> &value_list,
+    const std::vector<oid_t> &tuple_column_id_list,
+    const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p, uint64_t limit, uint64_t offset) {
+  if (csp_p->IsPointQuery() == true && limit != 0) {
+    std::vector<ValueType> values;
+    ScanKey(csp_p->GetPointQueryKey(), values);
+    size_t num_values = std::min<uint64_t>(values.size(), offset + limit);
+    result.insert(result.end(), values.begin(), values.begin() + num_values);
+  } else {
+    Scan(value_list, tuple_column_id_list, expr_list, scan_direction, result,
+         csp_p);
+  }
+
+  return;
+}
+
+/*
+ * ScanAllKeys() - Return all the values of the index
+ *
+ * This locks the whole map for the duration of the scan
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
+  size_t old_size = result.size();
+  {
+    auto locked_table = container.GetIterator();
+    for (auto &entry : locked_table) {
+      result.insert(result.end(), entry.second.begin(), entry.second.end());
+    }
+  }
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size() - old_size, metadata);
+  }
+  return;
+}
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanKey(const storage::Tuple *key,
+                              std::vector<ValueType> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  size_t old_size = result.size();
+  std::vector<ValueType> values;
+  if (container.Find(index_key, values) == true) {
+    result.insert(result.end(), values.begin(), values.end());
+  }
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size() - old_size, metadata);
+  }
+
+  return;
+}
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+std::string HASH_INDEX_TYPE::GetTypeName() const { return "Hash"; }
+
+/*
+ * GetMemoryFootprint() - The slots of the map plus the values of all keys
+ *
+ * Unused capacity of the value lists is not counted
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+size_t HASH_INDEX_TYPE::GetMemoryFootprint() {
+  return container.GetCapacity() *
+             (sizeof(KeyType) + sizeof(std::vector<ValueType>)) +
+         num_values_.load() * sizeof(ValueType);
+}
+
+// IMPORTANT: Make sure you don't exceed CompactIntegerKey_MAX_SLOTS
+
+template class HashIndex<CompactIntsKey<1>, ItemPointer *,
+                         CompactIntsHasher<1>, CompactIntsEqualityChecker<1>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<2>, ItemPointer *,
+                         CompactIntsHasher<2>, CompactIntsEqualityChecker<2>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<3>, ItemPointer *,
+                         CompactIntsHasher<3>, CompactIntsEqualityChecker<3>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<4>, ItemPointer *,
+                         CompactIntsHasher<4>, CompactIntsEqualityChecker<4>,
+                         ItemPointerComparator>;
+
+// Generic key
+template class HashIndex<GenericKey<4>, ItemPointer *, GenericHasher<4>,
+                         GenericEqualityChecker<4>, ItemPointerComparator>;
+template class HashIndex<GenericKey<8>, ItemPointer *, GenericHasher<8>,
+                         GenericEqualityChecker<8>, ItemPointerComparator>;
+template class HashIndex<GenericKey<16>, ItemPointer *, GenericHasher<16>,
+                         GenericEqualityChecker<16>, ItemPointerComparator>;
+template class HashIndex<GenericKey<64>, ItemPointer *, GenericHasher<64>,
+                         GenericEqualityChecker<64>, ItemPointerComparator>;
+template class HashIndex<GenericKey<256>, ItemPointer *, GenericHasher<256>,
+                         GenericEqualityChecker<256>, ItemPointerComparator>;
+
+// Tuple key
+template class HashIndex<TupleKey, ItemPointer *, TupleKeyHasher,
+                         TupleKeyEqualityChecker, ItemPointerComparator>;
+
+}  // namespace index
+}  // namespace peloton
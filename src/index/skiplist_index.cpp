@@ -11,9 +11,12 @@
 //===----------------------------------------------------------------------===//
 #include "index/skiplist_index.h"
 
+#include "common/exception.h"
 #include "common/logger.h"
 #include "index/index_key.h"
+#include "index/index_util.h"
 #include "index/scan_optimizer.h"
+#include "settings/settings_manager.h"
 #include "statistics/stats_aggregator.h"
 #include "storage/tuple.h"
 
@@ -27,25 +30,43 @@ SKIPLIST_INDEX_TYPE::SkipListIndex(IndexMetadata *metadata)
       // Key "less than" relation comparator
       comparator{},
       // Key equality checker
-      equals{} {
-  // TODO: Add your implementation here
+      equals{},
+      // The skip list itself
+      container{comparator, equals} {
   return;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
 SKIPLIST_INDEX_TYPE::~SkipListIndex() {}
 
+/*
+ * IsStatsEnabled() - Whether index accesses are counted
+ */
+static inline bool IsStatsEnabled() {
+  return static_cast<StatsType>(settings::SettingsManager::GetInt(
+             settings::SettingId::stats_mode)) != StatsType::INVALID;
+}
+
 /*
  * InsertEntry() - insert a key-value pair into the map
  *
  * If the key value pair already exists in the map, just return false
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
-bool SKIPLIST_INDEX_TYPE::InsertEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value) {
-  bool ret = false;
-  // TODO: Add your implementation here
+bool SKIPLIST_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
+                                      ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Insert(index_key, value, HasUniqueKeys());
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  LOG_TRACE("InsertEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(), (ret ? "SUCCESS" : "FAIL"));
+
   return ret;
 }
 
@@ -55,69 +76,186 @@ bool SKIPLIST_INDEX_TYPE::InsertEntry(
  * If the key-value pair does not exists yet in the map return false
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
-bool SKIPLIST_INDEX_TYPE::DeleteEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value) {
-  bool ret = false;
-  // TODO: Add your implementation here
+bool SKIPLIST_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
+                                      ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Delete(index_key, value);
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
+        (ret ? 1 : 0), metadata);
+  }
+
+  LOG_TRACE("DeleteEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(), (ret ? "SUCCESS" : "FAIL"));
+
   return ret;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
 bool SKIPLIST_INDEX_TYPE::CondInsertEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value,
-    UNUSED_ATTRIBUTE std::function<bool(const void *)> predicate) {
-  bool ret = false;
-  // TODO: Add your implementation here
+    const storage::Tuple *key, ItemPointer *value,
+    std::function<bool(const void *)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool predicate_satisfied = false;
+
+  // The insert fails if the predicate holds for any value of the key, or if
+  // the pair already exists
+  bool ret = container.ConditionalInsert(
+      index_key, value, false,
+      [&predicate](const ValueType &existing_value) {
+        return predicate(existing_value);
+      },
+      &predicate_satisfied);
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
   return ret;
 }
 
 /*
  * Scan() - Scans a range inside the index using index scan optimizer
  *
+ * The scan optimizer specifies whether a scan is point query, full scan
+ * or interval scan. Forward scans return the values in ascending key order
+ * and backward scans in descending key order
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
 void SKIPLIST_INDEX_TYPE::Scan(
     UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
     UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
     UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
-    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result,
-    UNUSED_ATTRIBUTE const ConjunctionScanPredicate *csp_p) {
-  // TODO: Add your implementation here
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  LOG_TRACE("Scan() Point Query = %d; Full Scan = %d ", csp_p->IsPointQuery(),
+            csp_p->IsFullIndexScan());
+
+  auto collect = [&result](const ValueType &value) {
+    result.push_back(value);
+    return true;
+  };
+
+  if (csp_p->IsPointQuery() == true) {
+    KeyType point_query_key;
+    point_query_key.SetFromKey(csp_p->GetPointQueryKey());
+
+    container.GetValue(point_query_key, result);
+  } else if (csp_p->IsFullIndexScan() == true) {
+    if (scan_direction == ScanDirectionType::FORWARD) {
+      container.ForwardScan(nullptr, nullptr, collect);
+    } else {
+      container.ReverseScan(nullptr, nullptr, collect);
+    }
+  } else {
+    const storage::Tuple *low_key_p = csp_p->GetLowKey();
+    const storage::Tuple *high_key_p = csp_p->GetHighKey();
+
+    LOG_TRACE("Partial scan low key: %s\n high key: %s",
+              low_key_p->GetInfo().c_str(), high_key_p->GetInfo().c_str());
+
+    KeyType index_low_key;
+    KeyType index_high_key;
+    index_low_key.SetFromKey(low_key_p);
+    index_high_key.SetFromKey(high_key_p);
+
+    if (scan_direction == ScanDirectionType::FORWARD) {
+      container.ForwardScan(&index_low_key, &index_high_key, collect);
+    } else {
+      container.ReverseScan(&index_low_key, &index_high_key, collect);
+    }
+  }
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
   return;
 }
 
 /*
  * ScanLimit() - Scan the index with predicate and limit/offset
  *
+ * Like the Bw-Tree, only limit == 1 and offset == 0 is answered by the index
+ * alone, since that is what min() and max() get translated to. The first
+ * qualified key of the scan direction is returned without checking the
+ * non-exact bounds, which is left to the executor
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
 void SKIPLIST_INDEX_TYPE::ScanLimit(
-    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
-    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
-    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
-    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result,
-    UNUSED_ATTRIBUTE const ConjunctionScanPredicate *csp_p,
-    UNUSED_ATTRIBUTE uint64_t limit, UNUSED_ATTRIBUTE uint64_t offset) {
-  // TODO: Add your implementation here
+    const std::vector<type::Value> &value_list,
+    const std::vector<oid_t> &tuple_column_id_list,
+    const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p, uint64_t limit, uint64_t offset) {
+  if (csp_p->IsPointQuery() == false && limit == 1 && offset == 0 &&
+      scan_direction != ScanDirectionType::INVALID) {
+    auto take_first = [&result](const ValueType &value) {
+      result.push_back(value);
+      return false;
+    };
+
+    const KeyType *low_key_p = nullptr;
+    const KeyType *high_key_p = nullptr;
+    KeyType index_low_key;
+    KeyType index_high_key;
+    if (csp_p->IsFullIndexScan() == false) {
+      index_low_key.SetFromKey(csp_p->GetLowKey());
+      index_high_key.SetFromKey(csp_p->GetHighKey());
+      low_key_p = &index_low_key;
+      high_key_p = &index_high_key;
+    }
+
+    if (scan_direction == ScanDirectionType::FORWARD) {
+      container.ForwardScan(low_key_p, high_key_p, take_first);
+    } else {
+      container.ReverseScan(low_key_p, high_key_p, take_first);
+    }
+  } else {
+    Scan(value_list, tuple_column_id_list, expr_list, scan_direction, result,
+         csp_p);
+  }
+
   return;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
-void SKIPLIST_INDEX_TYPE::ScanAllKeys(
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result) {
-  // TODO: Add your implementation here
+void SKIPLIST_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
+  container.ForwardScan(nullptr, nullptr, [&result](const ValueType &value) {
+    result.push_back(value);
+    return true;
+  });
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
   return;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
-void SKIPLIST_INDEX_TYPE::ScanKey(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result) {
-  // TODO: Add your implementation here
+void SKIPLIST_INDEX_TYPE::ScanKey(const storage::Tuple *key,
+                                  std::vector<ValueType> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container.GetValue(index_key, result);
+
+  if (IsStatsEnabled() == true) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
   return;
 }
 
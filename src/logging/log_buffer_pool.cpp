@@ -18,22 +18,21 @@ namespace peloton {
 namespace logging {
 
   // Acquire a log buffer from the buffer pool.
-  // This function will be blocked until there is an available buffer.
+  // If the pool is empty, a new buffer is allocated outside of it. The logger
+  // only returns the buffers of an epoch once no worker can write to it, so
+  // a transaction that fills more buffers than the pool holds within one
+  // epoch would otherwise wait for itself.
   // Note that only the corresponding worker thread can call this function.
   std::unique_ptr<LogBuffer> LogBufferPool::GetBuffer(size_t current_eid) {
-    size_t head_idx = head_ % buffer_queue_size_;
-    while (true) {
-      if (head_.load() < tail_.load() - 1) {
-        if (local_buffer_queue_[head_idx].get() == nullptr) {
-          // Not any buffer allocated now
-          local_buffer_queue_[head_idx].reset(new LogBuffer(thread_id_, current_eid));
-        }
-        break;
-      }
-
-      // sleep a while, and try to get a new buffer
-      _mm_pause();
+    if (head_.load() >= tail_.load()) {
       LOG_TRACE("Worker %d uses up its buffer", (int) thread_id_);
+      return std::unique_ptr<LogBuffer>(new LogBuffer(thread_id_, current_eid));
+    }
+
+    size_t head_idx = head_ % buffer_queue_size_;
+    if (local_buffer_queue_[head_idx].get() == nullptr) {
+      // Not any buffer allocated now
+      local_buffer_queue_[head_idx].reset(new LogBuffer(thread_id_, current_eid));
     }
 
     head_.fetch_add(1, std::memory_order_relaxed);
@@ -46,10 +45,14 @@ namespace logging {
     PELOTON_ASSERT(buf.get() != nullptr);
     PELOTON_ASSERT(buf->GetThreadId() == thread_id_);
 
+    // A buffer allocated while the pool was empty is released once the pool
+    // is full again.
+    if (tail_.load() - head_.load() >= buffer_queue_size_) {
+      return;
+    }
+
     size_t tail_idx = tail_ % buffer_queue_size_;
     
-    // The buffer pool must not be full
-    PELOTON_ASSERT(tail_idx != head_ % buffer_queue_size_);
     // The tail pos must be null
     PELOTON_ASSERT(local_buffer_queue_[tail_idx].get() == nullptr);
     // The returned buffer must be empty
@@ -16,7 +16,7 @@
 namespace peloton {
 namespace logging {
 
-LoggingType LogManagerFactory::logging_type_ = LoggingType::ON;
+LoggingType LogManagerFactory::logging_type_ = LoggingType::OFF;
 
 int LogManagerFactory::logging_thread_count_ = 1;
 
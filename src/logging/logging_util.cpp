@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logging_util.cpp
+//
+// Identification: src/logging/logging_util.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+
+#include "common/logger.h"
+#include "logging/logging_util.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// File system related operations
+//===--------------------------------------------------------------------===//
+
+bool LoggingUtil::CreateDirectory(const char *dir_name, int mode) {
+  int return_val = mkdir(dir_name, mode);
+  if (return_val == 0) {
+    LOG_TRACE("Created directory %s successfully", dir_name);
+  } else if (errno == EEXIST) {
+    LOG_TRACE("Directory %s already exists", dir_name);
+  } else {
+    LOG_ERROR("Creating directory failed: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool LoggingUtil::CheckDirectoryExistence(const char *dir_name) {
+  struct stat info;
+  int return_val = stat(dir_name, &info);
+  return return_val == 0 && S_ISDIR(info.st_mode);
+}
+
+bool LoggingUtil::RemoveDirectory(const char *dir_name, bool only_remove_file) {
+  struct dirent *file;
+  DIR *dir;
+
+  dir = opendir(dir_name);
+  if (dir == nullptr) {
+    return true;
+  }
+
+  while ((file = readdir(dir)) != nullptr) {
+    if (strcmp(file->d_name, ".") == 0 || strcmp(file->d_name, "..") == 0) {
+      continue;
+    }
+    std::string complete_path = std::string(dir_name) + "/" + file->d_name;
+    LOG_TRACE("Deleting file: %s", complete_path.c_str());
+    auto ret_val = remove(complete_path.c_str());
+    if (ret_val != 0) {
+      LOG_ERROR("Failed to delete file: %s, error: %s", complete_path.c_str(),
+                strerror(errno));
+    }
+  }
+  closedir(dir);
+
+  if (!only_remove_file) {
+    auto ret_val = remove(dir_name);
+    if (ret_val != 0) {
+      LOG_ERROR("Failed to delete dir: %s, error: %s", dir_name,
+                strerror(errno));
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LoggingUtil::GetDirectoryList(const char *dir_name,
+                                   const std::string &prefix,
+                                   std::vector<std::string> &files) {
+  struct dirent *file;
+  DIR *dir;
+
+  dir = opendir(dir_name);
+  if (dir == nullptr) {
+    LOG_ERROR("Failed to open directory %s: %s", dir_name, strerror(errno));
+    return false;
+  }
+
+  while ((file = readdir(dir)) != nullptr) {
+    std::string file_name(file->d_name);
+    if (file_name.compare(0, prefix.size(), prefix) == 0) {
+      files.push_back(file_name);
+    }
+  }
+  closedir(dir);
+  return true;
+}
+
+bool LoggingUtil::RenameFile(const char *old_name, const char *new_name) {
+  int return_val = rename(old_name, new_name);
+  if (return_val != 0) {
+    LOG_ERROR("Failed to rename %s to %s: %s", old_name, new_name,
+              strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool LoggingUtil::FsyncDirectory(const char *dir_name) {
+  int fd = open(dir_name, O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    LOG_ERROR("Failed to open directory %s: %s", dir_name, strerror(errno));
+    return false;
+  }
+  int return_val = fsync(fd);
+  if (return_val != 0) {
+    LOG_ERROR("Failed to fsync directory %s: %s", dir_name, strerror(errno));
+  }
+  close(fd);
+  return return_val == 0;
+}
+
+bool LoggingUtil::OpenFile(const char *name, const char *mode,
+                           FileHandle &file_handle) {
+  auto file = fopen(name, mode);
+  if (file == nullptr) {
+    LOG_ERROR("Failed to open file %s: %s", name, strerror(errno));
+    return false;
+  } else {
+    file_handle.file = file;
+  }
+
+  // also, get the descriptor
+  auto fd = fileno(file);
+  if (fd == INVALID_FILE_DESCRIPTOR) {
+    LOG_ERROR("file fd is -1");
+    return false;
+  } else {
+    file_handle.fd = fd;
+  }
+
+  file_handle.size = GetFileSize(file_handle);
+  return true;
+}
+
+bool LoggingUtil::CloseFile(FileHandle &file_handle) {
+  PELOTON_ASSERT(file_handle.file != nullptr &&
+                 file_handle.fd != INVALID_FILE_DESCRIPTOR);
+  int ret = fclose(file_handle.file);
+
+  if (ret == 0) {
+    file_handle.file = nullptr;
+    file_handle.fd = INVALID_FILE_DESCRIPTOR;
+  } else {
+    LOG_ERROR("Error occured when closing the file: %s", strerror(errno));
+  }
+
+  return ret == 0;
+}
+
+bool LoggingUtil::FFlushFsync(FileHandle &file_handle) {
+  // First, flush
+  PELOTON_ASSERT(file_handle.fd != INVALID_FILE_DESCRIPTOR);
+  if (file_handle.fd == INVALID_FILE_DESCRIPTOR) return false;
+  int ret = fflush(file_handle.file);
+  if (ret != 0) {
+    LOG_ERROR("Error occured in fflush(%d)", ret);
+    return false;
+  }
+  // Finally, sync
+  ret = fsync(file_handle.fd);
+  if (ret != 0) {
+    LOG_ERROR("Error occured in fsync(%d)", ret);
+    return false;
+  }
+  return true;
+}
+
+bool LoggingUtil::IsFileTruncated(FileHandle &file_handle,
+                                  size_t size_to_read) {
+  // Cache current position
+  size_t current_position = ftell(file_handle.file);
+
+  // Check if the actual file size is less than the expected file size
+  // Current position: position right after header
+  return (current_position + size_to_read) > file_handle.size;
+}
+
+size_t LoggingUtil::GetFileSize(FileHandle &file_handle) {
+  struct stat file_stats;
+  fstat(file_handle.fd, &file_stats);
+  return file_stats.st_size;
+}
+
+bool LoggingUtil::ReadNBytesFromFile(FileHandle &file_handle, void *bytes_read,
+                                     size_t n) {
+  PELOTON_ASSERT(file_handle.fd != INVALID_FILE_DESCRIPTOR &&
+                 file_handle.file != nullptr);
+  int res = fread(bytes_read, n, 1, file_handle.file);
+  return res == 1;
+}
+
+}  // namespace logging
+}  // namespace peloton
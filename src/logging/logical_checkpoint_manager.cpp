@@ -0,0 +1,350 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_checkpoint_manager.cpp
+//
+// Identification: src/logging/logical_checkpoint_manager.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_checkpoint_manager.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "catalog/schema.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "logging/log_manager_factory.h"
+#include "logging/logging_util.h"
+#include "storage/data_table.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace logging {
+
+void LogicalCheckpointManager::SetDirectory(const std::string &checkpoint_dir) {
+  PELOTON_ASSERT(is_running_ == false);
+
+  // check the existence of checkpoint directory.
+  // if not exists, then create the directory.
+  if (LoggingUtil::CheckDirectoryExistence(checkpoint_dir.c_str()) == false) {
+    LOG_INFO("Checkpoint directory %s is not accessible or does not exist",
+             checkpoint_dir.c_str());
+    bool res = LoggingUtil::CreateDirectory(checkpoint_dir.c_str(), 0700);
+    if (res == false) {
+      LOG_ERROR("Cannot create directory: %s", checkpoint_dir.c_str());
+    }
+  }
+
+  checkpoint_dir_ = checkpoint_dir;
+
+  RemoveWorkingCheckpoints();
+}
+
+void LogicalCheckpointManager::Reset() {
+  if (is_running_ == true) {
+    StopCheckpointing();
+  }
+
+  last_checkpoint_cid_ = INVALID_CID;
+  is_running_ = false;
+}
+
+void LogicalCheckpointManager::StartCheckpointing() {
+  is_running_ = true;
+  checkpointer_thread_.reset(
+      new std::thread(&LogicalCheckpointManager::Run, this));
+}
+
+void LogicalCheckpointManager::StopCheckpointing() {
+  if (is_running_ == false) {
+    return;
+  }
+
+  is_running_ = false;
+  checkpointer_thread_->join();
+  checkpointer_thread_.reset();
+}
+
+void LogicalCheckpointManager::RegisterTable(const oid_t &database_id,
+                                             const oid_t &table_id) {
+  tables_lock_.Lock();
+  tables_.insert(std::make_pair(database_id, table_id));
+  tables_lock_.Unlock();
+}
+
+void LogicalCheckpointManager::DeregisterTable(const oid_t &database_id,
+                                               const oid_t &table_id) {
+  checkpoint_latch_.WriteLock();
+  tables_lock_.Lock();
+  tables_.erase(std::make_pair(database_id, table_id));
+  tables_lock_.Unlock();
+  checkpoint_latch_.Unlock();
+}
+
+size_t LogicalCheckpointManager::GetTableCount() {
+  tables_lock_.Lock();
+  size_t table_count = tables_.size();
+  tables_lock_.Unlock();
+  return table_count;
+}
+
+void LogicalCheckpointManager::Run() {
+  auto last_checkpoint_time = std::chrono::steady_clock::now();
+
+  while (is_running_ == true) {
+    // sleep in short periods, so that stopping does not wait for a whole
+    // checkpoint interval.
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_period_ms_));
+
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+        now - last_checkpoint_time);
+    if (elapsed.count() < checkpoint_interval_) {
+      continue;
+    }
+
+    DoCheckpoint();
+    last_checkpoint_time = std::chrono::steady_clock::now();
+  }
+}
+
+cid_t LogicalCheckpointManager::DoCheckpoint() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // the snapshot transaction reads as of a commit id that no running
+  // transaction can commit before anymore. the GC moves that snapshot
+  // forward whenever it finds that older epochs have finished.
+  auto txn = txn_manager.BeginTransaction(0, IsolationLevelType::SNAPSHOT,
+                                          true);
+  cid_t checkpoint_cid = txn->GetReadId();
+
+  std::string working_dir = GetWorkingCheckpointDirFullPath(checkpoint_cid);
+  if (LoggingUtil::CreateDirectory(working_dir.c_str(), 0700) == false) {
+    txn_manager.CommitTransaction(txn);
+    return INVALID_CID;
+  }
+
+  std::vector<std::pair<oid_t, oid_t>> tables;
+  tables_lock_.Lock();
+  tables.assign(tables_.begin(), tables_.end());
+  tables_lock_.Unlock();
+
+  // the tables are spread over the checkpointer threads.
+  bool success = true;
+  size_t thread_count = std::max(checkpointer_thread_count_, 1);
+  if (thread_count == 1) {
+    success = CheckpointTables(tables, 0, 1, txn, working_dir);
+  } else {
+    std::vector<std::thread> threads;
+    std::vector<char> results(thread_count, false);
+    for (size_t thread_id = 0; thread_id < thread_count; ++thread_id) {
+      threads.emplace_back([&, thread_id] {
+        results[thread_id] = CheckpointTables(tables, thread_id, thread_count,
+                                              txn, working_dir);
+      });
+    }
+    for (size_t thread_id = 0; thread_id < thread_count; ++thread_id) {
+      threads[thread_id].join();
+      success = success && results[thread_id];
+    }
+  }
+
+  txn_manager.CommitTransaction(txn);
+
+  if (success == false) {
+    LOG_ERROR("Failed to take checkpoint %d", (int)checkpoint_cid);
+    LoggingUtil::RemoveDirectory(working_dir.c_str(), false);
+    return INVALID_CID;
+  }
+
+  // the checkpoint only becomes visible once all of its files are durable,
+  // and it only survives a crash once the rename itself is durable.
+  std::string checkpoint_dir = GetCheckpointDirFullPath(checkpoint_cid);
+  if (LoggingUtil::FsyncDirectory(working_dir.c_str()) == false ||
+      LoggingUtil::RenameFile(working_dir.c_str(), checkpoint_dir.c_str()) ==
+          false) {
+    LoggingUtil::RemoveDirectory(working_dir.c_str(), false);
+    return INVALID_CID;
+  }
+  if (LoggingUtil::FsyncDirectory(checkpoint_dir_.c_str()) == false) {
+    return INVALID_CID;
+  }
+
+  last_checkpoint_cid_ = checkpoint_cid;
+  LOG_INFO("Took checkpoint %s", checkpoint_dir.c_str());
+
+  RemoveOldCheckpoints(checkpoint_cid);
+
+  // recovery only replays the transactions that committed after the
+  // checkpoint. a transaction logs in an epoch no older than the one of its
+  // commit id, so the epochs before the checkpoint's are fully covered.
+  if (LogManagerFactory::GetLoggingType() == LoggingType::ON) {
+    LogicalLogManager::GetInstance().RemoveLogsBefore(
+        (eid_t)(checkpoint_cid >> 32));
+  }
+
+  return checkpoint_cid;
+}
+
+bool LogicalCheckpointManager::CheckpointTables(
+    const std::vector<std::pair<oid_t, oid_t>> &tables, const size_t thread_id,
+    const size_t thread_count, concurrency::TransactionContext *txn,
+    const std::string &dir) {
+  for (size_t table_itr = thread_id; table_itr < tables.size();
+       table_itr += thread_count) {
+    bool res = CheckpointTable(tables[table_itr].first,
+                               tables[table_itr].second, txn, dir);
+    if (res == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LogicalCheckpointManager::IsTableRegistered(const oid_t database_id,
+                                                 const oid_t table_id) {
+  tables_lock_.Lock();
+  bool registered =
+      tables_.find(std::make_pair(database_id, table_id)) != tables_.end();
+  tables_lock_.Unlock();
+  return registered;
+}
+
+bool LogicalCheckpointManager::CheckpointTable(
+    const oid_t database_id, const oid_t table_id,
+    concurrency::TransactionContext *txn, const std::string &dir) {
+  std::string file_name =
+      dir + "/" + GetCheckpointFileName(database_id, table_id);
+  FileHandle file_handle;
+  if (LoggingUtil::OpenFile(file_name.c_str(), "wb", file_handle) == false) {
+    return false;
+  }
+
+  // the tile groups are written one at a time, so that the memory footprint
+  // does not depend on the size of the table. the latch is only held for one
+  // tile group at a time, so that dropping the table does not wait for the
+  // whole table to be written.
+  CopySerializeOutput output;
+  bool success = true;
+  bool dropped = false;
+  for (size_t tile_group_offset = 0;; ++tile_group_offset) {
+    checkpoint_latch_.ReadLock();
+
+    // the table may have been dropped since the checkpoint started.
+    if (IsTableRegistered(database_id, table_id) == false) {
+      checkpoint_latch_.Unlock();
+      dropped = true;
+      break;
+    }
+
+    auto table = storage::StorageManager::GetInstance()->GetTableWithOid(
+        database_id, table_id);
+    if (tile_group_offset >= table->GetTileGroupCount()) {
+      checkpoint_latch_.Unlock();
+      break;
+    }
+
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr ||
+        CheckpointTileGroup(tile_group.get(), txn, output) == false) {
+      checkpoint_latch_.Unlock();
+      continue;
+    }
+    checkpoint_latch_.Unlock();
+
+    size_t res = fwrite((const void *)(output.Data()), output.Size(), 1,
+                        file_handle.file);
+    if (res != 1) {
+      LOG_ERROR("Failed to write checkpoint file %s", file_name.c_str());
+      success = false;
+      break;
+    }
+  }
+
+  if (LoggingUtil::FFlushFsync(file_handle) == false) {
+    success = false;
+  }
+  LoggingUtil::CloseFile(file_handle);
+
+  // a dropped table is left out of the checkpoint.
+  if (dropped == true) {
+    std::remove(file_name.c_str());
+  }
+  return success;
+}
+
+bool LogicalCheckpointManager::CheckpointTileGroup(
+    storage::TileGroup *tile_group, concurrency::TransactionContext *txn,
+    CopySerializeOutput &output) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto tile_group_header = tile_group->GetHeader();
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+  oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+  output.Reset();
+  output.WriteInt(tile_group->GetTileGroupId());
+  size_t count_position = output.Position();
+  output.WriteInt(0);
+
+  int32_t tuple_count = 0;
+  for (oid_t tuple_id = 0; tuple_id < active_tuple_count; ++tuple_id) {
+    if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+        VisibilityType::OK) {
+      continue;
+    }
+
+    output.WriteInt(tuple_id);
+    for (oid_t column_id = 0; column_id < column_count; ++column_id) {
+      tile_group->GetValue(tuple_id, column_id).SerializeTo(output);
+    }
+    ++tuple_count;
+  }
+
+  if (tuple_count == 0) {
+    return false;
+  }
+
+  output.WriteIntAt(count_position, tuple_count);
+  return true;
+}
+
+void LogicalCheckpointManager::RemoveOldCheckpoints(const cid_t commit_id) {
+  std::vector<std::string> dirs;
+  if (LoggingUtil::GetDirectoryList(checkpoint_dir_.c_str(),
+                                    checkpoint_dir_prefix_, dirs) == false) {
+    return;
+  }
+
+  for (auto &dir : dirs) {
+    cid_t dir_cid = std::stoull(dir.substr(checkpoint_dir_prefix_.size()));
+    if (dir_cid < commit_id) {
+      std::string full_path = checkpoint_dir_ + "/" + dir;
+      LoggingUtil::RemoveDirectory(full_path.c_str(), false);
+    }
+  }
+}
+
+void LogicalCheckpointManager::RemoveWorkingCheckpoints() {
+  std::vector<std::string> dirs;
+  std::string working_dir_prefix = "tmp_" + checkpoint_dir_prefix_;
+  if (LoggingUtil::GetDirectoryList(checkpoint_dir_.c_str(),
+                                    working_dir_prefix, dirs) == false) {
+    return;
+  }
+
+  for (auto &dir : dirs) {
+    std::string full_path = checkpoint_dir_ + "/" + dir;
+    LOG_INFO("Removing incomplete checkpoint %s", full_path.c_str());
+    LoggingUtil::RemoveDirectory(full_path.c_str(), false);
+  }
+}
+
+}  // namespace logging
+}  // namespace peloton
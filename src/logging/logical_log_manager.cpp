@@ -0,0 +1,561 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_manager.cpp
+//
+// Identification: src/logging/logical_log_manager.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_log_manager.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "catalog/schema.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "logging/logging_util.h"
+#include "storage/abstract_table.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace logging {
+
+// the logging context of the current worker thread.
+static thread_local WorkerContext *tl_worker_ctx = nullptr;
+// the generation in which tl_worker_ctx was registered.
+static thread_local size_t tl_worker_generation = 0;
+
+void LogicalLogManager::SetDirectories(
+    const std::vector<std::string> &logging_dirs) {
+  PELOTON_ASSERT(is_running_ == false);
+  PELOTON_ASSERT(logging_dirs.empty() == false);
+
+  // check the existence of logging directories.
+  // if not exists, then create the directory.
+  for (auto &logging_dir : logging_dirs) {
+    if (LoggingUtil::CheckDirectoryExistence(logging_dir.c_str()) == false) {
+      LOG_INFO("Logging directory %s is not accessible or does not exist",
+               logging_dir.c_str());
+      bool res = LoggingUtil::CreateDirectory(logging_dir.c_str(), 0700);
+      if (res == false) {
+        LOG_ERROR("Cannot create directory: %s", logging_dir.c_str());
+      }
+    }
+  }
+
+  logger_dirs_ = logging_dirs;
+  pepoch_dir_ = logger_dirs_.front();
+
+  // several loggers may share a directory if there are fewer directories
+  // than logger threads.
+  size_t logger_count = std::max(logger_dirs_.size(),
+                                 (size_t)std::max(logger_thread_count_, 1));
+
+  loggers_.clear();
+  for (size_t logger_id = 0; logger_id < logger_count; ++logger_id) {
+    loggers_.emplace_back(new LogicalLogger(
+        logger_id, logger_dirs_[logger_id % logger_dirs_.size()]));
+  }
+}
+
+void LogicalLogManager::Reset() {
+  if (is_running_ == true) {
+    StopLogging();
+  }
+
+  worker_lock_.Lock();
+  for (auto &worker_ctx : worker_ctxs_) {
+    if (loggers_.empty() == false) {
+      GetLogger(worker_ctx.get())->DeregisterWorker(worker_ctx.get());
+    }
+  }
+  worker_ctxs_.clear();
+  worker_generation_++;
+  worker_lock_.Unlock();
+
+  worker_count_ = 0;
+  sync_commit_ = false;
+  persist_epoch_id_ = INVALID_EID;
+  has_failed_ = false;
+  is_running_ = false;
+}
+
+void LogicalLogManager::StartLogging() {
+  if (loggers_.empty() == true) {
+    LOG_ERROR("Logging directory is not set");
+    return;
+  }
+
+  // the pepoch file is written in both modes, as recovery ignores every
+  // epoch beyond it.
+  bool res = LoggingUtil::OpenFile(GetPepochFileFullPath().c_str(), "ab",
+                                   pepoch_handle_);
+  if (res == false) {
+    LOG_ERROR("Cannot open pepoch file %s", GetPepochFileFullPath().c_str());
+    return;
+  }
+
+  // in synchronous mode the workers persist their own records.
+  if (sync_commit_ == false) {
+    for (auto &logger : loggers_) {
+      logger->StartLogging();
+    }
+  }
+
+  is_pepoch_running_ = true;
+  pepoch_thread_.reset(
+      new std::thread(&LogicalLogManager::RunPepochLogger, this));
+
+  is_running_ = true;
+}
+
+void LogicalLogManager::StopLogging() {
+  if (is_running_ == false) {
+    return;
+  }
+
+  is_running_ = false;
+
+  is_pepoch_running_ = false;
+  pepoch_thread_->join();
+  pepoch_thread_.reset();
+
+  if (sync_commit_ == false) {
+    for (auto &logger : loggers_) {
+      logger->StopLogging();
+    }
+  }
+
+  // write down everything that is left in the buffers.
+  for (auto &logger : loggers_) {
+    logger->PersistAll();
+  }
+
+  if (has_failed_ == false) {
+    PersistPepoch(GetMinPersistEpochId());
+  }
+
+  pepoch_lock_.lock();
+  LoggingUtil::CloseFile(pepoch_handle_);
+  pepoch_lock_.unlock();
+}
+
+void LogicalLogManager::RunPepochLogger() {
+  while (is_pepoch_running_ == true) {
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(pepoch_sleep_period_us_));
+
+    AdvancePepoch();
+  }
+}
+
+void LogicalLogManager::AdvancePepoch() {
+  for (auto &logger : loggers_) {
+    if (logger->HasFailed() == true) {
+      SetFailed();
+    }
+    if (sync_commit_ == true) {
+      logger->CatchUpPersistEpochId();
+    }
+  }
+
+  // nothing beyond the failure can become durable.
+  if (has_failed_ == true) {
+    return;
+  }
+
+  eid_t min_eid = GetMinPersistEpochId();
+
+  if (min_eid == INVALID_EID || min_eid <= persist_epoch_id_) {
+    return;
+  }
+
+  PersistPepoch(min_eid);
+}
+
+eid_t LogicalLogManager::GetMinPersistEpochId() {
+  eid_t min_eid = MAX_EID;
+  for (auto &logger : loggers_) {
+    eid_t logger_eid = logger->GetPersistEpochId();
+    if (logger_eid < min_eid) {
+      min_eid = logger_eid;
+    }
+  }
+  return min_eid;
+}
+
+void LogicalLogManager::PersistPepoch(const eid_t epoch_id) {
+  std::lock_guard<std::mutex> pepoch_guard(pepoch_lock_);
+
+  // another thread may have persisted a newer epoch in the meantime, or
+  // logging may have stopped.
+  if (epoch_id <= persist_epoch_id_ || pepoch_handle_.file == nullptr) {
+    return;
+  }
+
+  uint64_t pepoch = (uint64_t)epoch_id;
+  size_t res = fwrite((const void *)&pepoch, sizeof(pepoch), 1,
+                      pepoch_handle_.file);
+  if (res != 1 || LoggingUtil::FFlushFsync(pepoch_handle_) == false) {
+    LOG_ERROR("Failed to write pepoch %d", (int)epoch_id);
+    SetFailed();
+    return;
+  }
+
+  // the epoch is only exposed once it is durable.
+  persist_lock_.lock();
+  persist_epoch_id_ = epoch_id;
+  persist_lock_.unlock();
+  persist_cv_.notify_all();
+  LOG_TRACE("Persisted pepoch %d", (int)epoch_id);
+}
+
+void LogicalLogManager::RemoveLogsBefore(const eid_t epoch_id) {
+  if (is_running_ == false) {
+    return;
+  }
+
+  for (auto &logger : loggers_) {
+    logger->RemoveFilesBefore(epoch_id);
+  }
+
+  TruncatePepoch();
+}
+
+void LogicalLogManager::TruncatePepoch() {
+  std::lock_guard<std::mutex> pepoch_guard(pepoch_lock_);
+
+  // logging may have stopped in the meantime.
+  eid_t epoch_id = persist_epoch_id_.load();
+  if (pepoch_handle_.file == nullptr || epoch_id == INVALID_EID ||
+      has_failed_ == true) {
+    return;
+  }
+
+  // the new file is written aside and renamed over the old one, so that a
+  // crash leaves either of them in place.
+  std::string file_name = GetPepochFileFullPath();
+  std::string tmp_file_name = file_name + "_tmp";
+  FileHandle tmp_handle;
+  if (LoggingUtil::OpenFile(tmp_file_name.c_str(), "wb", tmp_handle) ==
+      false) {
+    return;
+  }
+  uint64_t pepoch = (uint64_t)epoch_id;
+  size_t res =
+      fwrite((const void *)&pepoch, sizeof(pepoch), 1, tmp_handle.file);
+  bool success = res == 1 && LoggingUtil::FFlushFsync(tmp_handle) == true;
+  LoggingUtil::CloseFile(tmp_handle);
+
+  if (success == false ||
+      LoggingUtil::RenameFile(tmp_file_name.c_str(), file_name.c_str()) ==
+          false) {
+    LOG_ERROR("Failed to truncate pepoch file %s", file_name.c_str());
+    std::remove(tmp_file_name.c_str());
+    return;
+  }
+  LoggingUtil::FsyncDirectory(pepoch_dir_.c_str());
+
+  // the old handle still refers to the replaced file.
+  LoggingUtil::CloseFile(pepoch_handle_);
+  if (LoggingUtil::OpenFile(file_name.c_str(), "ab", pepoch_handle_) ==
+      false) {
+    LOG_ERROR("Cannot open pepoch file %s", file_name.c_str());
+    SetFailed();
+  }
+}
+
+void LogicalLogManager::SetFailed() {
+  if (has_failed_ == true) {
+    return;
+  }
+  persist_lock_.lock();
+  has_failed_ = true;
+  persist_lock_.unlock();
+  persist_cv_.notify_all();
+}
+
+bool LogicalLogManager::WaitForPersistence() {
+  auto worker_ctx = tl_worker_ctx;
+  if (worker_ctx == nullptr ||
+      tl_worker_generation != worker_generation_.load() ||
+      worker_ctx->commit_eid == INVALID_EID) {
+    return true;
+  }
+
+  eid_t commit_eid = worker_ctx->commit_eid;
+  worker_ctx->commit_eid = INVALID_EID;
+
+  // even in synchronous mode, where the records were forced at commit, the
+  // transaction is not recovered until the persistent epoch covers it.
+  std::unique_lock<std::mutex> lock(persist_lock_);
+  if (sync_commit_ == false) {
+    persist_cv_.wait(lock, [this, commit_eid] {
+      return persist_epoch_id_.load() >= commit_eid || has_failed_ == true;
+    });
+    return persist_epoch_id_.load() >= commit_eid;
+  }
+
+  // a synchronous commit does not wait for the pepoch thread. it persists
+  // the pepoch itself as soon as no worker can write to its epoch anymore,
+  // and one fsync of the pepoch file covers every commit waiting for it.
+  while (persist_epoch_id_.load() < commit_eid && has_failed_ == false) {
+    lock.unlock();
+    AdvancePepoch();
+    lock.lock();
+
+    persist_cv_.wait_for(
+        lock, std::chrono::microseconds(sync_wait_period_us_),
+        [this, commit_eid] {
+          return persist_epoch_id_.load() >= commit_eid || has_failed_ == true;
+        });
+  }
+  return persist_epoch_id_.load() >= commit_eid;
+}
+
+WorkerContext *LogicalLogManager::GetWorkerContext() {
+  if (tl_worker_ctx != nullptr &&
+      tl_worker_generation == worker_generation_.load()) {
+    return tl_worker_ctx;
+  }
+
+  std::shared_ptr<WorkerContext> worker_ctx(
+      new WorkerContext(worker_count_.fetch_add(1)));
+
+  worker_lock_.Lock();
+  worker_ctxs_.push_back(worker_ctx);
+  tl_worker_generation = worker_generation_.load();
+  worker_lock_.Unlock();
+
+  GetLogger(worker_ctx.get())->RegisterWorker(worker_ctx);
+
+  tl_worker_ctx = worker_ctx.get();
+  LOG_TRACE("Registered logging worker %d", (int)tl_worker_ctx->worker_id);
+  return tl_worker_ctx;
+}
+
+WorkerContext *LogicalLogManager::GetActiveWorkerContext() {
+  if (tl_worker_ctx == nullptr ||
+      tl_worker_generation != worker_generation_.load() ||
+      tl_worker_ctx->current_eid.load() == MAX_EID) {
+    return nullptr;
+  }
+  return tl_worker_ctx;
+}
+
+void LogicalLogManager::LogBegin(const cid_t &commit_id) {
+  if (is_running_ == false) {
+    return;
+  }
+
+  auto worker_ctx = GetWorkerContext();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  worker_ctx->current_cid = commit_id;
+  worker_ctx->txn_begun = false;
+  worker_ctx->commit_eid = INVALID_EID;
+
+  // publish the epoch that this transaction writes to. the epoch is re-read
+  // after publishing, so that the logger never considers an epoch complete
+  // while this worker can still append to it.
+  worker_ctx->latch.Lock();
+  while (true) {
+    eid_t current_eid = epoch_manager.GetCurrentEpochId();
+    worker_ctx->current_eid.store(current_eid);
+    if (epoch_manager.GetCurrentEpochId() == current_eid) {
+      break;
+    }
+  }
+  worker_ctx->latch.Unlock();
+}
+
+void LogicalLogManager::LogEnd() {
+  auto worker_ctx = GetActiveWorkerContext();
+  if (worker_ctx == nullptr) {
+    return;
+  }
+
+  // nothing is logged for transactions that did not modify anything.
+  if (worker_ctx->txn_begun == true) {
+    LogRecord record = LogRecordFactory::CreateTxnRecord(
+        LogRecordType::TRANSACTION_COMMIT, worker_ctx->current_cid);
+    WriteRecordToBuffer(worker_ctx, record);
+
+    worker_ctx->commit_eid = worker_ctx->current_eid.load();
+
+    if (sync_commit_ == true) {
+      SealCurrentBuffer(worker_ctx);
+      if (GetLogger(worker_ctx)->PersistWorker(worker_ctx) == false) {
+        SetFailed();
+      }
+    }
+  }
+
+  worker_ctx->latch.Lock();
+  worker_ctx->current_eid.store(MAX_EID);
+  worker_ctx->current_cid = INVALID_CID;
+  worker_ctx->txn_begun = false;
+  worker_ctx->latch.Unlock();
+
+  // leaving the epoch may complete it for the synchronous commits waiting on
+  // it.
+  if (sync_commit_ == true) {
+    persist_cv_.notify_all();
+  }
+}
+
+void LogicalLogManager::LogInsert(const ItemPointer &tuple_pos) {
+  auto worker_ctx = GetActiveWorkerContext();
+  if (worker_ctx == nullptr) {
+    return;
+  }
+
+  LogRecord record =
+      LogRecordFactory::CreateTupleRecord(LogRecordType::TUPLE_INSERT, tuple_pos);
+  WriteRecordToBuffer(worker_ctx, record);
+}
+
+void LogicalLogManager::LogUpdate(const ItemPointer &tuple_pos) {
+  auto worker_ctx = GetActiveWorkerContext();
+  if (worker_ctx == nullptr) {
+    return;
+  }
+
+  LogRecord record =
+      LogRecordFactory::CreateTupleRecord(LogRecordType::TUPLE_UPDATE, tuple_pos);
+  WriteRecordToBuffer(worker_ctx, record);
+}
+
+void LogicalLogManager::LogDelete(const ItemPointer &tuple_pos_deleted) {
+  auto worker_ctx = GetActiveWorkerContext();
+  if (worker_ctx == nullptr) {
+    return;
+  }
+
+  LogRecord record = LogRecordFactory::CreateTupleRecord(
+      LogRecordType::TUPLE_DELETE, tuple_pos_deleted);
+  WriteRecordToBuffer(worker_ctx, record);
+}
+
+void LogicalLogManager::SealCurrentBuffer(WorkerContext *worker_ctx) {
+  if (worker_ctx->current_buffer == nullptr) {
+    return;
+  }
+
+  worker_ctx->latch.Lock();
+  worker_ctx->sealed_buffers.push_back(std::move(worker_ctx->current_buffer));
+  worker_ctx->latch.Unlock();
+}
+
+void LogicalLogManager::WriteRecordToBuffer(WorkerContext *worker_ctx,
+                                            LogRecord &record) {
+  // the begin record is only emitted once the transaction modifies a tuple.
+  if (worker_ctx->txn_begun == false &&
+      record.GetType() != LogRecordType::TRANSACTION_BEGIN) {
+    worker_ctx->txn_begun = true;
+    LogRecord begin_record = LogRecordFactory::CreateTxnRecord(
+        LogRecordType::TRANSACTION_BEGIN, worker_ctx->current_cid);
+    WriteRecordToBuffer(worker_ctx, begin_record);
+  }
+
+  CopySerializeOutput &output = worker_ctx->output_buffer;
+
+  output.Reset();
+
+  // reserve space for the length of the record.
+  size_t start = output.Position();
+  output.WriteInt(0);
+  output.WriteEnumInSingleByte(static_cast<int>(record.GetType()));
+
+  switch (record.GetType()) {
+    case LogRecordType::TUPLE_INSERT:
+    case LogRecordType::TUPLE_UPDATE: {
+      auto &tuple_pos = record.GetItemPointer();
+      auto tile_group =
+          storage::StorageManager::GetInstance()->GetTileGroup(tuple_pos.block);
+      auto schema = tile_group->GetAbstractTable()->GetSchema();
+
+      output.WriteInt(tile_group->GetDatabaseId());
+      output.WriteInt(tile_group->GetTableId());
+
+      if (record.GetType() == LogRecordType::TUPLE_UPDATE) {
+        // the new version points to the version it replaces.
+        ItemPointer old_pos =
+            tile_group->GetHeader()->GetNextItemPointer(tuple_pos.offset);
+        output.WriteInt(old_pos.block);
+        output.WriteInt(old_pos.offset);
+      }
+
+      output.WriteInt(tuple_pos.block);
+      output.WriteInt(tuple_pos.offset);
+
+      for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+           ++column_id) {
+        tile_group->GetValue(tuple_pos.offset, column_id).SerializeTo(output);
+      }
+      break;
+    }
+    case LogRecordType::TUPLE_DELETE: {
+      auto &tuple_pos = record.GetItemPointer();
+      auto tile_group =
+          storage::StorageManager::GetInstance()->GetTileGroup(tuple_pos.block);
+
+      output.WriteInt(tile_group->GetDatabaseId());
+      output.WriteInt(tile_group->GetTableId());
+      output.WriteInt(tuple_pos.block);
+      output.WriteInt(tuple_pos.offset);
+      break;
+    }
+    case LogRecordType::TRANSACTION_BEGIN:
+    case LogRecordType::TRANSACTION_COMMIT: {
+      output.WriteLong(record.GetCommitId());
+      break;
+    }
+    default: {
+      LOG_ERROR("Unsupported log record type %s",
+                LogRecordTypeToString(record.GetType()).c_str());
+      PELOTON_ASSERT(false);
+    }
+  }
+
+  output.WriteIntAt(start, output.Position() - start - sizeof(int32_t));
+
+  // the records of a buffer must all belong to the same epoch.
+  eid_t current_eid = worker_ctx->current_eid.load();
+  if (worker_ctx->current_buffer != nullptr &&
+      worker_ctx->current_buffer->GetEpochId() != current_eid) {
+    SealCurrentBuffer(worker_ctx);
+  }
+
+  if (worker_ctx->current_buffer == nullptr) {
+    worker_ctx->current_buffer = worker_ctx->buffer_pool.GetBuffer(current_eid);
+  }
+
+  bool res = worker_ctx->current_buffer->WriteData(output.Data(), output.Size());
+  if (res == false) {
+    // the buffer is full. hand it over to the logger and get a new one. a
+    // record larger than a whole buffer is spread over consecutive buffers of
+    // the same epoch, which the logger writes out back to back.
+    const char *data = output.Data();
+    size_t remaining = output.Size();
+    while (remaining > 0) {
+      SealCurrentBuffer(worker_ctx);
+      worker_ctx->current_buffer =
+          worker_ctx->buffer_pool.GetBuffer(current_eid);
+
+      size_t chunk_size = std::min(remaining, LogBuffer::GetCapacity());
+      worker_ctx->current_buffer->WriteData(data, chunk_size);
+      data += chunk_size;
+      remaining -= chunk_size;
+    }
+  }
+}
+
+}  // namespace logging
+}  // namespace peloton
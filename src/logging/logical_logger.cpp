@@ -0,0 +1,351 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_logger.cpp
+//
+// Identification: src/logging/logical_logger.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+
+#include "concurrency/epoch_manager_factory.h"
+#include "logging/logical_logger.h"
+#include "logging/logging_util.h"
+
+namespace peloton {
+namespace logging {
+
+void LogicalLogger::RegisterWorker(std::shared_ptr<WorkerContext> worker_ctx) {
+  worker_map_lock_.Lock();
+  worker_map_[worker_ctx->worker_id] = worker_ctx;
+  worker_map_lock_.Unlock();
+}
+
+void LogicalLogger::DeregisterWorker(WorkerContext *worker_ctx) {
+  worker_map_lock_.Lock();
+  worker_map_.erase(worker_ctx->worker_id);
+  worker_map_lock_.Unlock();
+}
+
+void LogicalLogger::Run() {
+  while (is_running_ == true) {
+    std::this_thread::sleep_for(std::chrono::microseconds(sleep_period_us_));
+
+    eid_t max_eid = GetMaxPersistableEpochId();
+
+    // nothing new can be persisted yet.
+    if (max_eid == INVALID_EID || max_eid <= persist_epoch_id_) {
+      continue;
+    }
+
+    PersistEpochs(max_eid);
+  }
+}
+
+eid_t LogicalLogger::GetMaxPersistableEpochId() {
+  // the global epoch must be read before the workers' epochs. a worker that
+  // publishes its epoch concurrently re-reads the global epoch afterwards,
+  // so it either shows up here or picks an epoch no smaller than this one.
+  eid_t current_global_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  eid_t max_eid = current_global_eid - 1;
+
+  worker_map_lock_.Lock();
+  for (auto &entry : worker_map_) {
+    eid_t worker_eid = entry.second->current_eid.load();
+    if (worker_eid != MAX_EID && worker_eid - 1 < max_eid) {
+      max_eid = worker_eid - 1;
+    }
+  }
+  worker_map_lock_.Unlock();
+
+  return max_eid;
+}
+
+void LogicalLogger::CatchUpPersistEpochId() {
+  eid_t max_eid = GetMaxPersistableEpochId();
+  if (has_failed_ == false && max_eid != INVALID_EID &&
+      max_eid > persist_epoch_id_) {
+    persist_epoch_id_ = max_eid;
+  }
+}
+
+void LogicalLogger::PersistEpochs(const eid_t max_eid) {
+  std::vector<std::unique_ptr<LogBuffer>> buffers;
+
+  worker_map_lock_.Lock();
+  for (auto &entry : worker_map_) {
+    CollectBuffers(entry.second.get(), max_eid, buffers);
+  }
+  worker_map_lock_.Unlock();
+
+  if (buffers.empty() == false) {
+    // the buffers of a single worker are already ordered by epoch.
+    // a stable sort keeps the order of each worker's records within an epoch.
+    std::stable_sort(buffers.begin(), buffers.end(),
+                     [](const std::unique_ptr<LogBuffer> &lhs,
+                        const std::unique_ptr<LogBuffer> &rhs) {
+                       return lhs->GetEpochId() < rhs->GetEpochId();
+                     });
+
+    // once a write has failed, the records that follow it can never become
+    // durable, so they are dropped rather than kept forever.
+    if (has_failed_ == false) {
+      file_lock_.lock();
+      // a single fsync for the whole group of epochs.
+      bool res = WriteBuffers(buffers);
+      file_lock_.unlock();
+
+      if (res == false) {
+        LOG_ERROR("Logger %d failed to persist epoch %d", (int)logger_id_,
+                  (int)max_eid);
+        has_failed_ = true;
+      }
+    }
+
+    ReturnBuffers(buffers);
+  }
+
+  if (max_eid != MAX_EID && has_failed_ == false) {
+    persist_epoch_id_ = max_eid;
+  }
+  LOG_TRACE("Logger %d persisted epoch %d", (int)logger_id_, (int)max_eid);
+}
+
+bool LogicalLogger::PersistWorker(WorkerContext *worker_ctx) {
+  std::vector<std::unique_ptr<LogBuffer>> buffers;
+
+  CollectBuffers(worker_ctx, MAX_EID, buffers);
+
+  if (buffers.empty() == true) {
+    return has_failed_ == false;
+  }
+
+  bool res = false;
+  file_lock_.lock();
+  if (has_failed_ == false) {
+    res = WriteBuffers(buffers);
+    if (res == false) {
+      LOG_ERROR("Logger %d failed to persist worker %d", (int)logger_id_,
+                (int)worker_ctx->worker_id);
+      has_failed_ = true;
+    }
+  }
+  file_lock_.unlock();
+
+  for (auto &buffer : buffers) {
+    buffer->Reset();
+    worker_ctx->buffer_pool.PutBuffer(std::move(buffer));
+  }
+  return res;
+}
+
+void LogicalLogger::PersistAll() {
+  // the workers are quiescent, so everything before the current epoch is
+  // persisted once all their buffers are written.
+  eid_t current_global_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+
+  PersistEpochs(MAX_EID);
+  if (has_failed_ == false) {
+    persist_epoch_id_ = current_global_eid;
+  }
+
+  file_lock_.lock();
+  if (file_handle_.file != nullptr) {
+    LoggingUtil::FFlushFsync(file_handle_);
+    LoggingUtil::CloseFile(file_handle_);
+  }
+  file_lock_.unlock();
+}
+
+void LogicalLogger::RemoveFilesBefore(const eid_t epoch_id) {
+  std::string file_prefix =
+      logging_filename_prefix_ + "_" + std::to_string(logger_id_) + "_";
+
+  // a file is never written again once a newer one is open, and every file
+  // is named after its first epoch. so a file only holds epochs older than
+  // the first epoch of the file that follows it. the files are listed under
+  // the file lock, so the last one listed is the one that may be open.
+  file_lock_.lock();
+  std::vector<std::string> file_names;
+  bool res = LoggingUtil::GetDirectoryList(log_dir_.c_str(), file_prefix,
+                                           file_names);
+  file_lock_.unlock();
+  if (res == false) {
+    return;
+  }
+
+  std::vector<eid_t> file_eids;
+  for (auto &file_name : file_names) {
+    file_eids.push_back(std::stoull(file_name.substr(file_prefix.size())));
+  }
+  std::sort(file_eids.begin(), file_eids.end());
+
+  bool removed = false;
+  for (size_t file_itr = 0; file_itr + 1 < file_eids.size(); ++file_itr) {
+    if (file_eids[file_itr + 1] > epoch_id) {
+      break;
+    }
+    std::string file_name = GetLogFileFullPath(file_eids[file_itr]);
+    if (std::remove(file_name.c_str()) != 0) {
+      LOG_ERROR("Failed to remove log file %s", file_name.c_str());
+      break;
+    }
+    removed = true;
+  }
+
+  if (removed == true) {
+    LoggingUtil::FsyncDirectory(log_dir_.c_str());
+  }
+}
+
+void LogicalLogger::CollectBuffers(
+    WorkerContext *worker_ctx, const eid_t max_eid,
+    std::vector<std::unique_ptr<LogBuffer>> &buffers) {
+  worker_ctx->latch.Lock();
+
+  auto &sealed_buffers = worker_ctx->sealed_buffers;
+  size_t count = 0;
+  while (count < sealed_buffers.size() &&
+         sealed_buffers[count]->GetEpochId() <= max_eid) {
+    buffers.push_back(std::move(sealed_buffers[count]));
+    ++count;
+  }
+  sealed_buffers.erase(sealed_buffers.begin(), sealed_buffers.begin() + count);
+
+  // an idle worker does not seal its last buffer by itself.
+  if (worker_ctx->current_eid.load() == MAX_EID &&
+      worker_ctx->current_buffer != nullptr &&
+      worker_ctx->current_buffer->GetEpochId() <= max_eid) {
+    buffers.push_back(std::move(worker_ctx->current_buffer));
+  }
+
+  worker_ctx->latch.Unlock();
+}
+
+bool LogicalLogger::WriteBuffers(
+    std::vector<std::unique_ptr<LogBuffer>> &buffers) {
+  size_t buffer_itr = 0;
+  while (buffer_itr < buffers.size()) {
+    size_t epoch_id = buffers[buffer_itr]->GetEpochId();
+
+    if (PrepareLogFile(epoch_id) == false ||
+        PersistEpochBegin(file_handle_, epoch_id) == false) {
+      return false;
+    }
+    while (buffer_itr < buffers.size() &&
+           buffers[buffer_itr]->GetEpochId() == epoch_id) {
+      if (PersistLogBuffer(file_handle_, buffers[buffer_itr].get()) == false) {
+        return false;
+      }
+      ++buffer_itr;
+    }
+    if (PersistEpochEnd(file_handle_, epoch_id) == false) {
+      return false;
+    }
+  }
+
+  return LoggingUtil::FFlushFsync(file_handle_);
+}
+
+bool LogicalLogger::PrepareLogFile(const size_t epoch_id) {
+  auto now = std::chrono::steady_clock::now();
+
+  if (file_handle_.file != nullptr) {
+    auto file_age = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - file_start_time_);
+    if (file_age.count() < new_file_interval_) {
+      return true;
+    }
+    // everything in the old file must be durable before we move on.
+    bool res = LoggingUtil::FFlushFsync(file_handle_);
+    LoggingUtil::CloseFile(file_handle_);
+    if (res == false) {
+      return false;
+    }
+  }
+
+  std::string file_name = GetLogFileFullPath(epoch_id);
+  bool res = LoggingUtil::OpenFile(file_name.c_str(), "ab", file_handle_);
+  if (res == false) {
+    LOG_ERROR("Cannot open log file %s", file_name.c_str());
+    return false;
+  }
+
+  file_eid_ = epoch_id;
+  file_start_time_ = now;
+  return true;
+}
+
+bool LogicalLogger::PersistEpochBegin(FileHandle &file_handle,
+                                      const size_t epoch_id) {
+  // Write down the epoch begin record
+  logger_output_buffer_.Reset();
+
+  size_t start = logger_output_buffer_.Position();
+  logger_output_buffer_.WriteInt(0);
+  logger_output_buffer_.WriteEnumInSingleByte(
+      static_cast<int>(LogRecordType::EPOCH_BEGIN));
+  logger_output_buffer_.WriteLong((uint64_t)epoch_id);
+  logger_output_buffer_.WriteIntAt(
+      start, logger_output_buffer_.Position() - start - sizeof(int32_t));
+
+  return fwrite((const void *)(logger_output_buffer_.Data()),
+                logger_output_buffer_.Size(), 1, file_handle.file) == 1;
+}
+
+bool LogicalLogger::PersistEpochEnd(FileHandle &file_handle,
+                                    const size_t epoch_id) {
+  // Write down the epoch end record
+  logger_output_buffer_.Reset();
+
+  size_t start = logger_output_buffer_.Position();
+  logger_output_buffer_.WriteInt(0);
+  logger_output_buffer_.WriteEnumInSingleByte(
+      static_cast<int>(LogRecordType::EPOCH_END));
+  logger_output_buffer_.WriteLong((uint64_t)epoch_id);
+  logger_output_buffer_.WriteIntAt(
+      start, logger_output_buffer_.Position() - start - sizeof(int32_t));
+
+  return fwrite((const void *)(logger_output_buffer_.Data()),
+                logger_output_buffer_.Size(), 1, file_handle.file) == 1;
+}
+
+bool LogicalLogger::PersistLogBuffer(FileHandle &file_handle,
+                                     LogBuffer *log_buffer) {
+  if (log_buffer->Empty() == true) {
+    return true;
+  }
+
+  size_t res = fwrite((const void *)(log_buffer->GetData()),
+                      log_buffer->GetSize(), 1, file_handle.file);
+  if (res != 1) {
+    LOG_ERROR("Failed to write log buffer of worker %d",
+              (int)log_buffer->GetThreadId());
+    return false;
+  }
+  return true;
+}
+
+void LogicalLogger::ReturnBuffers(
+    std::vector<std::unique_ptr<LogBuffer>> &buffers) {
+  worker_map_lock_.Lock();
+  for (auto &buffer : buffers) {
+    auto worker_itr = worker_map_.find(buffer->GetThreadId());
+    buffer->Reset();
+    // the buffer of a deregistered worker is simply released.
+    if (worker_itr != worker_map_.end()) {
+      worker_itr->second->buffer_pool.PutBuffer(std::move(buffer));
+    }
+  }
+  worker_map_lock_.Unlock();
+}
+
+}  // namespace logging
+}  // namespace peloton
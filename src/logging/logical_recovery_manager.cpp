@@ -0,0 +1,1029 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_recovery_manager.cpp
+//
+// Identification: src/logging/logical_recovery_manager.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_recovery_manager.h"
+
+#include <cstdio>
+#include <thread>
+
+#include "catalog/catalog.h"
+#include "catalog/column_catalog.h"
+#include "catalog/constraint_catalog.h"
+#include "catalog/database_catalog.h"
+#include "catalog/index_catalog.h"
+#include "catalog/schema.h"
+#include "catalog/schema_catalog.h"
+#include "catalog/system_catalogs.h"
+#include "catalog/table_catalog.h"
+#include "common/exception.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "gc/gc_manager_factory.h"
+#include "index/index.h"
+#include "logging/checkpoint_manager_factory.h"
+#include "logging/log_record.h"
+#include "logging/logging_util.h"
+#include "storage/data_table.h"
+#include "storage/storage_manager.h"
+#include "storage/table_factory.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/serializeio.h"
+
+namespace peloton {
+namespace logging {
+
+LogicalRecoveryManager::~LogicalRecoveryManager() {}
+
+bool LogicalRecoveryManager::DoRecovery() {
+  persist_epoch_id_ = ReadPersistEpochId();
+  // the checkpoint goes first, as the logs skip the transactions it holds.
+  FindCheckpoint();
+  ListLogFiles();
+  if (LoadLogFiles() == false) {
+    return false;
+  }
+
+  // the schema comes first, as the tables that the data goes to are created
+  // from it.
+  recovering_catalog_ = true;
+  if (LoadCheckpoint() == false || ReplayLogs() == false ||
+      RebuildSchema() == false) {
+    return false;
+  }
+
+  recovering_catalog_ = false;
+  bool res = LoadCheckpoint() == true && ReplayLogs() == true;
+  loaded_log_files_.clear();
+  if (res == false) {
+    return false;
+  }
+
+  RebuildIndexes();
+
+  LOG_INFO("Recovered %d transactions on top of checkpoint %d",
+           (int)recovered_txn_count_.load(), (int)checkpoint_cid_);
+
+  return FinishRecovery();
+}
+
+//===--------------------------------------------------------------------===//
+// Schema recovery
+//===--------------------------------------------------------------------===//
+
+bool LogicalRecoveryManager::RebuildSchema() {
+  MoveEpochPastRecovery();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  cid_t commit_id = txn->GetCommitId();
+
+  bool res = true;
+  if (schema_tables_.empty() == false) {
+    try {
+      ScanCatalogTable(CATALOG_DATABASE_OID, DATABASE_CATALOG_OID, txn,
+                       [&](executor::LogicalTile *tile) {
+                         catalog::DatabaseCatalogEntry database_entry(txn,
+                                                                      tile);
+                         RebuildDatabase(database_entry.GetDatabaseOid(),
+                                         database_entry.GetDatabaseName(),
+                                         txn);
+                       });
+    } catch (CatalogException &e) {
+      LOG_ERROR("Failed to rebuild the schema : %s", e.what());
+      res = false;
+    }
+  }
+
+  if (res == true) {
+    txn_manager.CommitTransaction(txn);
+    recovery_cid_ = std::max(recovery_cid_, commit_id);
+  } else {
+    txn_manager.AbortTransaction(txn);
+  }
+
+  // the private copies of the catalog tables are not needed anymore.
+  tile_group_lock_.Lock();
+  tile_group_map_.clear();
+  recovered_tables_.clear();
+  schema_tables_.clear();
+  tile_group_lock_.Unlock();
+
+  return res;
+}
+
+void LogicalRecoveryManager::RebuildDatabase(
+    const oid_t old_database_oid, const std::string &database_name,
+    concurrency::TransactionContext *txn) {
+  // pg_catalog is bootstrapped.
+  if (old_database_oid == CATALOG_DATABASE_OID) {
+    return;
+  }
+  recovered_database_oids_.insert(old_database_oid);
+
+  auto pg_catalog = catalog::Catalog::GetInstance();
+  try {
+    pg_catalog->GetDatabaseCatalogEntry(txn, database_name);
+    LOG_INFO("Database %s already exists and is not recovered",
+             database_name.c_str());
+    return;
+  } catch (CatalogException &e) {
+    // the database is missing and is recreated below.
+  }
+
+  pg_catalog->CreateDatabase(txn, database_name);
+  oid_t database_oid =
+      pg_catalog->GetDatabaseCatalogEntry(txn, database_name)
+          ->GetDatabaseOid();
+  auto system_catalogs = pg_catalog->GetSystemCatalogs(database_oid);
+
+  ScanCatalogTable(old_database_oid, SCHEMA_CATALOG_OID, txn,
+                   [&](executor::LogicalTile *tile) {
+                     catalog::SchemaCatalogEntry schema_entry(txn, tile);
+                     auto &schema_name = schema_entry.GetSchemaName();
+                     if (system_catalogs->GetSchemaCatalog()
+                             ->GetSchemaCatalogEntry(txn, schema_name) ==
+                         nullptr) {
+                       pg_catalog->CreateSchema(txn, database_name,
+                                                schema_name);
+                     }
+                   });
+
+  // the rows of the other catalog tables, by the old table oid.
+  std::map<oid_t, std::vector<std::shared_ptr<catalog::ColumnCatalogEntry>>>
+      columns;
+  ScanCatalogTable(old_database_oid, COLUMN_CATALOG_OID, txn,
+                   [&](executor::LogicalTile *tile) {
+                     std::shared_ptr<catalog::ColumnCatalogEntry> column_entry(
+                         new catalog::ColumnCatalogEntry(tile));
+                     columns[column_entry->GetTableOid()].push_back(
+                         column_entry);
+                   });
+
+  std::map<oid_t, std::shared_ptr<catalog::IndexCatalogEntry>> indexes;
+  ScanCatalogTable(old_database_oid, INDEX_CATALOG_OID, txn,
+                   [&](executor::LogicalTile *tile) {
+                     std::shared_ptr<catalog::IndexCatalogEntry> index_entry(
+                         new catalog::IndexCatalogEntry(tile));
+                     indexes[index_entry->GetIndexOid()] = index_entry;
+                   });
+
+  // constraints are added back in the order they were created.
+  std::map<oid_t, std::shared_ptr<catalog::ConstraintCatalogEntry>>
+      constraints;
+  ScanCatalogTable(
+      old_database_oid, CONSTRAINT_CATALOG_OID, txn,
+      [&](executor::LogicalTile *tile) {
+        std::shared_ptr<catalog::ConstraintCatalogEntry> constraint_entry(
+            new catalog::ConstraintCatalogEntry(tile));
+        constraints[constraint_entry->GetConstraintOid()] = constraint_entry;
+      });
+
+  // the system tables of the database were bootstrapped with it.
+  std::map<oid_t, oid_t> table_oids;
+  ScanCatalogTable(
+      old_database_oid, TABLE_CATALOG_OID, txn,
+      [&](executor::LogicalTile *tile) {
+        catalog::TableCatalogEntry table_entry(txn, tile);
+        oid_t old_table_oid = table_entry.GetTableOid();
+        if (IsCatalogTable(old_database_oid, old_table_oid) ||
+            table_entry.GetSchemaName() == CATALOG_SCHEMA_NAME) {
+          return;
+        }
+
+        auto &table_columns = columns[old_table_oid];
+        std::sort(table_columns.begin(), table_columns.end(),
+                  [](const std::shared_ptr<catalog::ColumnCatalogEntry> &lhs,
+                     const std::shared_ptr<catalog::ColumnCatalogEntry> &rhs) {
+                    return lhs->GetColumnId() < rhs->GetColumnId();
+                  });
+        std::vector<catalog::Column> schema_columns;
+        for (auto &column_entry : table_columns) {
+          catalog::Column column(column_entry->GetColumnType(),
+                                 column_entry->GetColumnLength(),
+                                 column_entry->GetColumnName(),
+                                 column_entry->IsInlined());
+          if (column_entry->IsNotNull() == true) {
+            column.SetNotNull();
+          }
+          if (column_entry->HasDefault() == true) {
+            column.SetDefaultValue(column_entry->GetDefaultValue());
+          }
+          schema_columns.push_back(column);
+        }
+
+        std::unique_ptr<catalog::Schema> schema(
+            new catalog::Schema(schema_columns));
+        pg_catalog->CreateTable(txn, database_name,
+                                table_entry.GetSchemaName(), std::move(schema),
+                                table_entry.GetTableName(), false);
+        oid_t table_oid =
+            pg_catalog->GetTableCatalogEntry(txn, database_name,
+                                             table_entry.GetSchemaName(),
+                                             table_entry.GetTableName())
+                ->GetTableOid();
+
+        table_oids[old_table_oid] = table_oid;
+        table_map_[std::make_pair(old_database_oid, old_table_oid)] =
+            storage::StorageManager::GetInstance()->GetTableWithOid(
+                database_oid, table_oid);
+      });
+
+  for (auto &entry : constraints) {
+    auto &constraint_entry = entry.second;
+    auto table_itr = table_oids.find(constraint_entry->GetTableOid());
+    if (table_itr == table_oids.end()) {
+      continue;
+    }
+
+    switch (constraint_entry->GetConstraintType()) {
+      case ConstraintType::PRIMARY:
+        pg_catalog->AddPrimaryKeyConstraint(
+            txn, database_oid, table_itr->second,
+            constraint_entry->GetColumnIds(),
+            constraint_entry->GetConstraintName());
+        break;
+      case ConstraintType::UNIQUE:
+        pg_catalog->AddUniqueConstraint(txn, database_oid, table_itr->second,
+                                        constraint_entry->GetColumnIds(),
+                                        constraint_entry->GetConstraintName());
+        break;
+      case ConstraintType::FOREIGN: {
+        auto sink_itr = table_oids.find(constraint_entry->GetFKSinkTableOid());
+        if (sink_itr == table_oids.end()) {
+          break;
+        }
+        pg_catalog->AddForeignKeyConstraint(
+            txn, database_oid, table_itr->second,
+            constraint_entry->GetColumnIds(), sink_itr->second,
+            constraint_entry->GetFKSinkColumnIds(),
+            constraint_entry->GetFKUpdateAction(),
+            constraint_entry->GetFKDeleteAction(),
+            constraint_entry->GetConstraintName());
+        break;
+      }
+      case ConstraintType::CHECK:
+        pg_catalog->AddCheckConstraint(txn, database_oid, table_itr->second,
+                                       constraint_entry->GetColumnIds(),
+                                       constraint_entry->GetCheckExp(),
+                                       constraint_entry->GetConstraintName());
+        break;
+      default:
+        break;
+    }
+  }
+
+  // the indexes that were not created along with a constraint.
+  for (auto &entry : indexes) {
+    auto &index_entry = entry.second;
+    auto table_itr = table_oids.find(index_entry->GetTableOid());
+    if (table_itr == table_oids.end()) {
+      continue;
+    }
+
+    auto table = storage::StorageManager::GetInstance()->GetTableWithOid(
+        database_oid, table_itr->second);
+    bool exists = false;
+    for (oid_t index_itr = 0; index_itr < table->GetIndexCount();
+         ++index_itr) {
+      auto index = table->GetIndex(index_itr);
+      if (index != nullptr && index->GetName() == index_entry->GetIndexName()) {
+        exists = true;
+        break;
+      }
+    }
+    if (exists == false) {
+      pg_catalog->CreateIndex(txn, database_oid, index_entry->GetSchemaName(),
+                              table_itr->second, false,
+                              system_catalogs->GetIndexCatalog()->GetNextOid(),
+                              index_entry->GetIndexName(),
+                              index_entry->GetKeyAttrs(),
+                              index_entry->HasUniqueKeys(),
+                              index_entry->GetIndexType(),
+                              index_entry->GetIndexConstraint());
+    }
+  }
+}
+
+void LogicalRecoveryManager::ScanCatalogTable(
+    const oid_t database_id, const oid_t table_id,
+    concurrency::TransactionContext *txn,
+    const std::function<void(executor::LogicalTile *)> &row_func) {
+  auto table_itr = schema_tables_.find(std::make_pair(database_id, table_id));
+  if (table_itr == schema_tables_.end()) {
+    return;
+  }
+  auto table = table_itr->second.get();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::vector<oid_t> column_ids;
+  for (oid_t column_id = 0; column_id < table->GetSchema()->GetColumnCount();
+       ++column_id) {
+    column_ids.push_back(column_id);
+  }
+
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       ++tile_group_offset) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; ++tuple_id) {
+      if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+          VisibilityType::OK) {
+        continue;
+      }
+
+      // the catalog entries are built from the first row of a logical tile.
+      std::unique_ptr<executor::LogicalTile> tile(
+          executor::LogicalTileFactory::GetTile());
+      tile->AddColumns(tile_group, column_ids);
+      tile->AddPositionList(std::vector<oid_t>(1, tuple_id));
+      row_func(tile.get());
+    }
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Checkpoint recovery
+//===--------------------------------------------------------------------===//
+
+void LogicalRecoveryManager::FindCheckpoint() {
+  std::vector<std::string> dirs;
+  if (LoggingUtil::CheckDirectoryExistence(checkpoint_dir_.c_str()) == false ||
+      LoggingUtil::GetDirectoryList(checkpoint_dir_.c_str(),
+                                    checkpoint_dir_prefix_, dirs) == false) {
+    return;
+  }
+
+  // only complete checkpoints carry the prefix, so the latest one is used.
+  for (auto &dir : dirs) {
+    cid_t dir_cid = std::stoull(dir.substr(checkpoint_dir_prefix_.size()));
+    if (checkpoint_cid_ == INVALID_CID || dir_cid > checkpoint_cid_) {
+      checkpoint_cid_ = dir_cid;
+    }
+  }
+}
+
+bool LogicalRecoveryManager::LoadCheckpoint() {
+  if (checkpoint_cid_ == INVALID_CID) {
+    LOG_INFO("No checkpoint to recover from");
+    return true;
+  }
+
+  std::string dir_name = checkpoint_dir_ + "/" + checkpoint_dir_prefix_ +
+                         std::to_string(checkpoint_cid_);
+  std::vector<std::string> files;
+  if (LoggingUtil::GetDirectoryList(dir_name.c_str(), "table_", files) ==
+      false) {
+    return false;
+  }
+
+  // one task per table.
+  return RunParallel(files.size(), [&](size_t file_itr) {
+    // file name layout : table_<database_id>_<table_id>
+    auto &file_name = files[file_itr];
+    size_t separator = file_name.find('_', 6);
+    oid_t database_id = std::stoul(file_name.substr(6, separator - 6));
+    oid_t table_id = std::stoul(file_name.substr(separator + 1));
+    if (recovering_catalog_ != IsSchemaTable(database_id, table_id) ||
+        (recovering_catalog_ == false &&
+         IsCatalogTable(database_id, table_id))) {
+      return true;
+    }
+    return LoadCheckpointFile(dir_name + "/" + file_name, database_id,
+                              table_id);
+  });
+}
+
+bool LogicalRecoveryManager::LoadCheckpointFile(const std::string &file_name,
+                                                const oid_t database_id,
+                                                const oid_t table_id) {
+  auto table = GetTable(database_id, table_id);
+  if (table == nullptr) {
+    LOG_INFO("Table %d of the checkpoint does not exist", (int)table_id);
+    return true;
+  }
+
+  std::unique_ptr<char[]> data;
+  size_t size = 0;
+  if (ReadFile(file_name, data, size) == false) {
+    return false;
+  }
+
+  auto schema = table->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+
+  ReferenceSerializeInput input(data.get(), size);
+  const char *end = data.get() + size;
+  while (input.getRawPointer(0) < end) {
+    oid_t old_tile_group_id = input.ReadInt();
+    int32_t tuple_count = input.ReadInt();
+
+    auto tile_group = GetRecoveryTileGroup(database_id, table, table_id,
+                                           old_tile_group_id);
+
+    // the values are copied into the tile group, so the variable-length
+    // ones only need to live until the tile group is loaded.
+    type::EphemeralPool pool;
+    storage::Tuple tuple(schema, true);
+    for (int32_t tuple_itr = 0; tuple_itr < tuple_count; ++tuple_itr) {
+      oid_t tuple_slot_id = input.ReadInt();
+      for (oid_t column_id = 0; column_id < column_count; ++column_id) {
+        type::Value value = type::Value::DeserializeFrom(
+            input, schema->GetColumn(column_id).GetType(), &pool);
+        tuple.SetValue(column_id, value, &pool);
+      }
+      tile_group->InsertTupleFromCheckpoint(tuple_slot_id, &tuple,
+                                            checkpoint_cid_);
+    }
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Log recovery
+//===--------------------------------------------------------------------===//
+
+eid_t LogicalRecoveryManager::ReadPersistEpochId() {
+  // the pepoch file is written in both logging modes. without a complete
+  // entry, no epoch is known to be durable and nothing is replayed.
+  if (log_dirs_.empty() == true) {
+    return INVALID_EID;
+  }
+  std::string file_name = log_dirs_.front() + "/" + pepoch_filename_;
+  std::unique_ptr<char[]> data;
+  size_t size = 0;
+  if (ReadFile(file_name, data, size) == false || size < sizeof(uint64_t)) {
+    return INVALID_EID;
+  }
+
+  // the last complete entry is the persistent epoch.
+  uint64_t pepoch = INVALID_EID;
+  size_t last_entry = (size / sizeof(uint64_t) - 1) * sizeof(uint64_t);
+  memcpy(&pepoch, data.get() + last_entry, sizeof(uint64_t));
+  return pepoch;
+}
+
+void LogicalRecoveryManager::ListLogFiles() {
+  log_files_.clear();
+  for (auto &log_dir : log_dirs_) {
+    std::vector<std::string> dir_files;
+    if (LoggingUtil::CheckDirectoryExistence(log_dir.c_str()) == false ||
+        LoggingUtil::GetDirectoryList(log_dir.c_str(), logging_filename_prefix_,
+                                      dir_files) == false) {
+      continue;
+    }
+    for (auto &file_name : dir_files) {
+      log_files_.push_back(log_dir + "/" + file_name);
+    }
+  }
+}
+
+bool LogicalRecoveryManager::LoadLogFiles() {
+  // one task per log file. a transaction never spans several files, so
+  // every file can be split on its own.
+  loaded_log_files_.clear();
+  loaded_log_files_.resize(log_files_.size());
+  return RunParallel(log_files_.size(), [&](size_t file_itr) {
+    return LoadLogFile(log_files_[file_itr], loaded_log_files_[file_itr]);
+  });
+}
+
+bool LogicalRecoveryManager::LoadLogFile(const std::string &file_name,
+                                         LogFile &log_file) {
+  size_t size = 0;
+  if (ReadFile(file_name, log_file.data, size) == false) {
+    return false;
+  }
+
+  eid_t current_eid = INVALID_EID;
+  const char *txn_begin = nullptr;
+  const char *position = log_file.data.get();
+  const char *end = log_file.data.get() + size;
+
+  while (position + sizeof(int32_t) + 1 <= end) {
+    ReferenceSerializeInput input(position, end - position);
+    int32_t length = input.ReadInt();
+
+    // the tail of the file may be torn.
+    if (length <= 0 || position + sizeof(int32_t) + length > end) {
+      break;
+    }
+
+    const char *record = position;
+    position += sizeof(int32_t) + length;
+
+    auto type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+    switch (type) {
+      case LogRecordType::EPOCH_BEGIN: {
+        current_eid = input.ReadLong();
+        txn_begin = nullptr;
+
+        // the epochs that are not durable count too, so that the commit ids
+        // of the next run never overlap with the ones in the files.
+        eid_t max_eid = max_epoch_id_.load();
+        while (current_eid > max_eid &&
+               max_epoch_id_.compare_exchange_weak(max_eid, current_eid)) {
+        }
+        break;
+      }
+      case LogRecordType::EPOCH_END: {
+        txn_begin = nullptr;
+        break;
+      }
+      case LogRecordType::TRANSACTION_BEGIN: {
+        txn_begin = position;
+        break;
+      }
+      case LogRecordType::TRANSACTION_COMMIT: {
+        cid_t commit_id = input.ReadLong();
+        // the transactions of epochs that are not durable on all the
+        // loggers, or that are already in the checkpoint, are skipped.
+        if (txn_begin != nullptr && current_eid <= persist_epoch_id_ &&
+            (checkpoint_cid_ == INVALID_CID || commit_id > checkpoint_cid_)) {
+          log_file.txns.push_back({commit_id, txn_begin, record});
+        }
+        txn_begin = nullptr;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  recovered_txn_count_ += log_file.txns.size();
+  return true;
+}
+
+bool LogicalRecoveryManager::ReplayLogs() {
+  // one task per log file.
+  std::vector<std::vector<Invalidation>> invalidations(
+      loaded_log_files_.size());
+  bool res = RunParallel(loaded_log_files_.size(), [&](size_t file_itr) {
+    for (auto &txn : loaded_log_files_[file_itr].txns) {
+      ReplayTxn(txn.commit_id, txn.begin, txn.end, invalidations[file_itr]);
+    }
+    return true;
+  });
+  if (res == false) {
+    return false;
+  }
+
+  // every new version is in place, so that ending the lifetime of the old
+  // versions cannot be undone by a version installed later on.
+  std::vector<std::vector<std::pair<ItemPointer, GCVersionType>>> replaced(
+      invalidations.size());
+  res = RunParallel(invalidations.size(), [&](size_t file_itr) {
+    for (auto &invalidation : invalidations[file_itr]) {
+      auto tile_group = GetRecoveryTileGroup(invalidation.database_id,
+                                             invalidation.table_id,
+                                             invalidation.location.block);
+      if (tile_group == nullptr) {
+        continue;
+      }
+
+      storage::TileGroup *new_tile_group = nullptr;
+      ItemPointer new_location = INVALID_ITEMPOINTER;
+      if (invalidation.new_location.IsNull() == false) {
+        new_tile_group = GetRecoveryTileGroup(invalidation.database_id,
+                                              invalidation.table_id,
+                                              invalidation.new_location.block);
+        if (new_tile_group != nullptr) {
+          new_location = ItemPointer(new_tile_group->GetTileGroupId(),
+                                     invalidation.new_location.offset);
+        }
+      }
+
+      // the slot may hold a version of a later transaction.
+      if (tile_group->InvalidateTupleFromRecovery(
+              invalidation.commit_id, invalidation.location.offset,
+              new_location) == INVALID_OID) {
+        continue;
+      }
+
+      ItemPointer location(tile_group->GetTileGroupId(),
+                           invalidation.location.offset);
+      if (new_tile_group != nullptr) {
+        new_tile_group->LinkTupleFromRecovery(
+            invalidation.commit_id, new_location.offset, location);
+      }
+      replaced[file_itr].emplace_back(
+          location, new_location.IsNull() ? GCVersionType::COMMIT_DELETE
+                                          : GCVersionType::COMMIT_UPDATE);
+    }
+    return true;
+  });
+
+  // the private copies of the catalog tables are dropped with their
+  // versions.
+  if (recovering_catalog_ == false) {
+    for (auto &file_replaced : replaced) {
+      replaced_versions_.insert(replaced_versions_.end(),
+                                file_replaced.begin(), file_replaced.end());
+    }
+  }
+  return res;
+}
+
+void LogicalRecoveryManager::ReplayTxn(
+    const cid_t commit_id, const char *begin, const char *end,
+    std::vector<Invalidation> &invalidations) {
+  type::EphemeralPool pool;
+  const char *position = begin;
+  while (position < end) {
+    ReferenceSerializeInput input(position, end - position);
+    int32_t length = input.ReadInt();
+    position += sizeof(int32_t) + length;
+
+    auto type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+    oid_t database_id = input.ReadInt();
+    oid_t table_id = input.ReadInt();
+
+    ItemPointer old_location;
+    if (type == LogRecordType::TUPLE_UPDATE) {
+      old_location.block = input.ReadInt();
+      old_location.offset = input.ReadInt();
+    }
+
+    ItemPointer location;
+    location.block = input.ReadInt();
+    location.offset = input.ReadInt();
+
+    // the records of the tables that are not recovered in this phase are
+    // skipped.
+    auto table = GetTable(database_id, table_id);
+    if (table == nullptr) {
+      continue;
+    }
+
+    if (type == LogRecordType::TUPLE_DELETE) {
+      invalidations.push_back(
+          {commit_id, database_id, table_id, location, INVALID_ITEMPOINTER});
+      continue;
+    }
+
+    if (type == LogRecordType::TUPLE_UPDATE) {
+      invalidations.push_back(
+          {commit_id, database_id, table_id, old_location, location});
+    }
+
+    auto schema = table->GetSchema();
+    storage::Tuple tuple(schema, true);
+    for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+         ++column_id) {
+      type::Value value = type::Value::DeserializeFrom(
+          input, schema->GetColumn(column_id).GetType(), &pool);
+      tuple.SetValue(column_id, value, &pool);
+    }
+
+    auto tile_group =
+        GetRecoveryTileGroup(database_id, table, table_id, location.block);
+    tile_group->InsertTupleFromRecovery(commit_id, location.offset, &tuple);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Index recovery
+//===--------------------------------------------------------------------===//
+
+void LogicalRecoveryManager::MoveEpochPastRecovery() {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t max_eid = max_epoch_id_.load();
+  if (checkpoint_cid_ != INVALID_CID) {
+    max_eid = std::max(max_eid, (eid_t)(checkpoint_cid_ >> 32));
+  }
+  if (persist_epoch_id_ != INVALID_EID) {
+    max_eid = std::max(max_eid, persist_epoch_id_);
+  }
+  if (max_eid != INVALID_EID && epoch_manager.GetCurrentEpochId() <= max_eid) {
+    epoch_manager.SetCurrentEpochId(max_eid + 1);
+  }
+}
+
+void LogicalRecoveryManager::RebuildIndexes() {
+  std::vector<storage::DataTable *> tables(recovered_tables_.begin(),
+                                           recovered_tables_.end());
+
+  // the recovered versions are all older than the current epoch, so a
+  // transaction started now sees all of them.
+  MoveEpochPastRecovery();
+
+  // one task per table.
+  std::vector<cid_t> commit_ids(tables.size(), INVALID_CID);
+  RunParallel(tables.size(), [&](size_t table_itr) {
+    commit_ids[table_itr] = RebuildTableIndexes(tables[table_itr]);
+    return true;
+  });
+
+  for (auto commit_id : commit_ids) {
+    recovery_cid_ = std::max(recovery_cid_, commit_id);
+  }
+
+  RecycleReplacedVersions();
+}
+
+cid_t LogicalRecoveryManager::RebuildTableIndexes(storage::DataTable *table) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  cid_t commit_id = txn->GetCommitId();
+
+  // the entries of a tile group are inserted one index at a time.
+  std::vector<oid_t> tuple_ids;
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       ++tile_group_offset) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+    tuple_ids.clear();
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; ++tuple_id) {
+      if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) ==
+          VisibilityType::OK) {
+        tuple_ids.push_back(tuple_id);
+      }
+    }
+
+    table->InsertInIndexesForRecovery(tile_group.get(), tuple_ids);
+  }
+
+  txn_manager.CommitTransaction(txn);
+  return commit_id;
+}
+
+void LogicalRecoveryManager::RecycleReplacedVersions() {
+  if (replaced_versions_.empty() == true) {
+    return;
+  }
+
+  // the versions are handed over as the garbage of a transaction that ends
+  // after all of them.
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  cid_t commit_id = txn->GetCommitId();
+
+  auto gc_set = txn->GetGCSetPtr();
+  for (auto &replaced_version : replaced_versions_) {
+    auto &location = replaced_version.first;
+    gc_set->operator[](location.block)[location.offset] =
+        replaced_version.second;
+  }
+  replaced_versions_.clear();
+
+  txn_manager.CommitTransaction(txn);
+  recovery_cid_ = std::max(recovery_cid_, commit_id);
+}
+
+//===--------------------------------------------------------------------===//
+// Utility
+//===--------------------------------------------------------------------===//
+
+bool LogicalRecoveryManager::IsCatalogTable(const oid_t database_id,
+                                            const oid_t table_id) {
+  // the oids below OID_OFFSET are reserved for the catalog tables.
+  return database_id == CATALOG_DATABASE_OID ||
+         (table_id >= TABLE_OID_MASK && table_id < (TABLE_OID_MASK | OID_OFFSET));
+}
+
+bool LogicalRecoveryManager::IsSchemaTable(const oid_t database_id,
+                                           const oid_t table_id) {
+  if (database_id == CATALOG_DATABASE_OID) {
+    return table_id == DATABASE_CATALOG_OID;
+  }
+  return table_id == SCHEMA_CATALOG_OID || table_id == TABLE_CATALOG_OID ||
+         table_id == COLUMN_CATALOG_OID || table_id == INDEX_CATALOG_OID ||
+         table_id == CONSTRAINT_CATALOG_OID;
+}
+
+storage::DataTable *LogicalRecoveryManager::GetTable(const oid_t database_id,
+                                                     const oid_t table_id) {
+  if (recovering_catalog_ == true) {
+    if (IsSchemaTable(database_id, table_id) == false) {
+      return nullptr;
+    }
+    return GetSchemaTable(database_id, table_id);
+  }
+
+  if (IsCatalogTable(database_id, table_id) == true) {
+    return nullptr;
+  }
+
+  // the tables of the recovered databases were created under new oids. the
+  // ones that are missing were dropped.
+  if (recovered_database_oids_.count(database_id) != 0) {
+    auto table_itr = table_map_.find(std::make_pair(database_id, table_id));
+    if (table_itr == table_map_.end()) {
+      return nullptr;
+    }
+    return table_itr->second;
+  }
+
+  try {
+    return storage::StorageManager::GetInstance()->GetTableWithOid(database_id,
+                                                                  table_id);
+  } catch (CatalogException &e) {
+    return nullptr;
+  }
+}
+
+storage::DataTable *LogicalRecoveryManager::GetSchemaTable(
+    const oid_t database_id, const oid_t table_id) {
+  tile_group_lock_.Lock();
+  auto key = std::make_pair(database_id, table_id);
+  auto table_itr = schema_tables_.find(key);
+  if (table_itr != schema_tables_.end()) {
+    auto table = table_itr->second.get();
+    tile_group_lock_.Unlock();
+    return table;
+  }
+
+  // every database has its own copy of these catalog tables, with the same
+  // layout as the ones of pg_catalog.
+  storage::DataTable *catalog_table = nullptr;
+  try {
+    catalog_table = storage::StorageManager::GetInstance()->GetTableWithOid(
+        CATALOG_DATABASE_OID, table_id);
+  } catch (CatalogException &e) {
+    tile_group_lock_.Unlock();
+    return nullptr;
+  }
+
+  auto table = storage::TableFactory::GetDataTable(
+      database_id, table_id,
+      catalog::Schema::CopySchema(catalog_table->GetSchema()),
+      catalog_table->GetName(), DEFAULT_TUPLES_PER_TILEGROUP, true, false,
+      true);
+  schema_tables_[key].reset(table);
+  tile_group_lock_.Unlock();
+  return table;
+}
+
+storage::TileGroup *LogicalRecoveryManager::GetRecoveryTileGroup(
+    const oid_t database_id, storage::DataTable *table,
+    const oid_t old_table_id, const oid_t old_tile_group_id) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto key = std::make_tuple(database_id, old_table_id, old_tile_group_id);
+
+  tile_group_lock_.Lock();
+  auto tile_group_itr = tile_group_map_.find(key);
+  oid_t tile_group_id;
+  if (tile_group_itr != tile_group_map_.end()) {
+    tile_group_id = tile_group_itr->second;
+  } else {
+    tile_group_id = storage_manager->GetNextTileGroupId();
+    table->AddTileGroupWithOidForRecovery(tile_group_id);
+    tile_group_map_[key] = tile_group_id;
+    recovered_tables_.insert(table);
+  }
+  tile_group_lock_.Unlock();
+
+  return storage_manager->GetTileGroup(tile_group_id).get();
+}
+
+storage::TileGroup *LogicalRecoveryManager::GetRecoveryTileGroup(
+    const oid_t database_id, const oid_t table_id,
+    const oid_t old_tile_group_id) {
+  tile_group_lock_.Lock();
+  auto tile_group_itr = tile_group_map_.find(
+      std::make_tuple(database_id, table_id, old_tile_group_id));
+  if (tile_group_itr == tile_group_map_.end()) {
+    tile_group_lock_.Unlock();
+    return nullptr;
+  }
+  oid_t tile_group_id = tile_group_itr->second;
+  tile_group_lock_.Unlock();
+
+  return storage::StorageManager::GetInstance()->GetTileGroup(tile_group_id)
+      .get();
+}
+
+bool LogicalRecoveryManager::RunParallel(
+    const size_t task_count, const std::function<bool(size_t)> &task) {
+  size_t thread_count =
+      std::min((size_t)recovery_thread_count_, std::max(task_count, (size_t)1));
+  std::vector<char> results(thread_count, true);
+  std::vector<std::thread> threads;
+
+  for (size_t thread_id = 0; thread_id < thread_count; ++thread_id) {
+    threads.emplace_back([&, thread_id] {
+      for (size_t task_itr = thread_id; task_itr < task_count;
+           task_itr += thread_count) {
+        if (task(task_itr) == false) {
+          results[thread_id] = false;
+        }
+      }
+    });
+  }
+
+  bool success = true;
+  for (size_t thread_id = 0; thread_id < thread_count; ++thread_id) {
+    threads[thread_id].join();
+    success = success && results[thread_id];
+  }
+  return success;
+}
+
+bool LogicalRecoveryManager::ReadFile(const std::string &file_name,
+                                      std::unique_ptr<char[]> &data,
+                                      size_t &size) {
+  FileHandle file_handle;
+  if (LoggingUtil::OpenFile(file_name.c_str(), "rb", file_handle) == false) {
+    return false;
+  }
+
+  size = file_handle.size;
+  data.reset(new char[size]);
+  bool res = size == 0 ||
+             LoggingUtil::ReadNBytesFromFile(file_handle, data.get(), size);
+  LoggingUtil::CloseFile(file_handle);
+
+  if (res == false) {
+    LOG_ERROR("Failed to read file %s", file_name.c_str());
+  }
+  return res;
+}
+
+bool LogicalRecoveryManager::WaitForRecoverySnapshot() {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // the snapshot epoch moves forward once the older epochs have finished.
+  for (size_t retry = 0; retry < snapshot_wait_retry_count_; ++retry) {
+    auto txn =
+        txn_manager.BeginTransaction(0, IsolationLevelType::SNAPSHOT, true);
+    cid_t read_id = txn->GetReadId();
+    txn_manager.CommitTransaction(txn);
+    if (read_id > recovery_cid_) {
+      return true;
+    }
+
+    // without a GC, nothing else moves it forward.
+    if (gc::GCManagerFactory::GetGCType() != GarbageCollectionType::ON) {
+      epoch_manager.GetExpiredEpochId();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH));
+  }
+  return false;
+}
+
+bool LogicalRecoveryManager::FinishRecovery() {
+  if (checkpoint_cid_ == INVALID_CID && log_files_.empty() == true) {
+    return true;
+  }
+
+  // without a checkpoint of the recovered state, the logs must be kept.
+  if (CheckpointManagerFactory::GetCheckpointingType() !=
+      CheckpointingType::ON) {
+    LOG_INFO("No checkpoint manager, keeping the recovered log files");
+    return true;
+  }
+
+  // the checkpoint has to cover every recovered version before the files
+  // they came from can go.
+  if (WaitForRecoverySnapshot() == false) {
+    LOG_ERROR("Cannot checkpoint the recovered state, keeping the log files");
+    return false;
+  }
+
+  auto &checkpoint_manager = LogicalCheckpointManager::GetInstance();
+  if (checkpoint_manager.DoCheckpoint() == INVALID_CID) {
+    LOG_ERROR("Cannot checkpoint the recovered state, keeping the log files");
+    return false;
+  }
+
+  // every transaction of the replayed files is in the checkpoint, or was
+  // never durable. the pepoch file is kept, as this run appends to it.
+  for (auto &file_name : log_files_) {
+    if (std::remove(file_name.c_str()) != 0) {
+      LOG_ERROR("Failed to remove log file %s", file_name.c_str());
+    }
+  }
+  for (auto &log_dir : log_dirs_) {
+    LoggingUtil::FsyncDirectory(log_dir.c_str());
+  }
+  return true;
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -132,6 +132,8 @@ DEF_TRANSITION_GRAPH
         // Client connections are ignored while we wait on peloton
         // to execute the query
         ON(NEED_RESULT) SET_STATE_TO(PROCESS) AND_WAIT_ON_PELOTON
+          // The rows of a streamed result are blocked on a slow client
+        ON(NEED_WRITE) SET_STATE_TO(PROCESS) AND_WAIT_ON_WRITE
         ON(NEED_SSL_HANDSHAKE) SET_STATE_TO(SSL_INIT) AND_INVOKE(TrySslHandshake)
     END_STATE_DEF
 
@@ -216,11 +218,29 @@ Transition ConnectionHandle::Process() {
 
 Transition ConnectionHandle::GetResult() {
   EventUtil::EventAdd(network_event_, nullptr);
-  protocol_handler_->GetResult();
+  // Write out the rows streamed so far before fetching more of them, which
+  // holds the query back while the client is slow
+  if (streaming_result_ && HasResponse()) {
+    auto write_ret = FlushResponses();
+    if (write_ret != Transition::PROCEED) return write_ret;
+  }
+  if (protocol_handler_->GetResult() == ProcessResult::PROCESSING) {
+    streaming_result_ = true;
+    auto write_ret = FlushResponses();
+    if (write_ret != Transition::PROCEED) return write_ret;
+    return Transition::NEED_RESULT;
+  }
+  streaming_result_ = false;
   tcop_.SetQueuing(false);
   return Transition::PROCEED;
 }
 
+Transition ConnectionHandle::FlushResponses() {
+  auto write_ret = TryWrite();
+  if (write_ret != Transition::PROCEED) return write_ret;
+  return io_wrapper_->FlushWriteBuffer();
+}
+
 Transition ConnectionHandle::TrySslHandshake() {
   // Flush out all the response first
   if (HasResponse()) {
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <cstdio>
 #include <unordered_map>
@@ -22,6 +23,7 @@
 #include "network/marshal.h"
 #include "network/peloton_server.h"
 #include "network/postgres_protocol_handler.h"
+#include "network/postgres_value_format.h"
 #include "parser/postgresparser.h"
 #include "parser/statements.h"
 #include "planner/plan_util.h"
@@ -29,6 +31,7 @@
 #include "traffic_cop/traffic_cop.h"
 #include "type/value.h"
 #include "type/value_factory.h"
+#include "util/pipe.h"
 #include "util/string_util.h"
 
 #define SSL_MESSAGE_VERNO 80877103
@@ -58,7 +61,10 @@ const std::unordered_map<std::string, std::string>
 PostgresProtocolHandler::PostgresProtocolHandler(tcop::TrafficCop *traffic_cop)
     : ProtocolHandler(traffic_cop),
       init_stage_(true),
-      txn_state_(NetworkTransactionStateType::IDLE) {}
+      txn_state_(NetworkTransactionStateType::IDLE) {
+  // Send the rows of large results while the query still runs
+  traffic_cop_->SetStreamResults(true);
+}
 
 PostgresProtocolHandler::~PostgresProtocolHandler() {}
 
@@ -151,6 +157,8 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
   QueryType query_type =
       StatementTypeToQueryType(sql_stmt->GetType(), sql_stmt.get());
   protocol_type_ = NetworkProtocolType::POSTGRES_PSQL;
+  rows_sent_ = 0;
+  max_rows_ = 0;
 
   switch (query_type) {
     case QueryType::QUERY_PREPARE: {
@@ -225,6 +233,14 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
       return ProcessResult::COMPLETE;
     }
     default: {
+      // A COPY without a file exchanges its data with the client. The
+      // statement is owned by the prepared statement below.
+      parser::CopyStatement *copy_stmt = nullptr;
+      if (query_type == QueryType::QUERY_COPY) {
+        copy_stmt = static_cast<parser::CopyStatement *>(sql_stmt.get());
+        if (!copy_stmt->file_path.empty()) copy_stmt = nullptr;
+      }
+
       std::string stmt_name = "unamed";
       std::unique_ptr<parser::SQLStatementList> unnamed_sql_stmt_list(
           new parser::SQLStatementList());
@@ -241,10 +257,29 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
       bool unnamed = false;
       result_format_ = std::vector<int>(
           traffic_cop_->GetStatement()->GetTupleDescriptor().size(), 0);
+
+      if (copy_stmt != nullptr) {
+        copy_mode_ =
+            copy_stmt->is_from ? CopyMode::COPY_IN : CopyMode::COPY_OUT;
+        copy_delimiter_ = copy_stmt->delimiter;
+        copy_quote_ = copy_stmt->quote;
+        copy_escape_ = copy_stmt->escape;
+        if (copy_mode_ == CopyMode::COPY_IN) {
+          copy_input_ = traffic_cop_->OpenCopyInput();
+        }
+      }
+
       auto status = traffic_cop_->ExecuteStatement(
           traffic_cop_->GetStatement(), traffic_cop_->GetParamVal(), unnamed,
           nullptr, result_format_, traffic_cop_->GetResult(), thread_id);
       if (traffic_cop_->GetQueuing()) {
+        if (copy_mode_ == CopyMode::COPY_IN) {
+          // The statement reads the data while the client sends it. The
+          // binder expanded the table into the columns to expect.
+          SendCopyResponse(NetworkMessageType::COPY_IN_RESPONSE,
+                           copy_stmt->select_list.size());
+          return ProcessResult::COMPLETE;
+        }
         return ProcessResult::PROCESSING;
       }
       ExecQueryMessageGetResult(status);
@@ -278,6 +313,12 @@ ResultType PostgresProtocolHandler::ExecQueryExplain(
 }
 
 void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
+  // The COPY of the statement, if any, ends with it
+  bool copy_out = (copy_mode_ == CopyMode::COPY_OUT);
+  copy_mode_ = CopyMode::NONE;
+  copy_input_.reset();
+  copy_in_waiting_ = false;
+
   std::vector<FieldInfo> tuple_descriptor;
   if (status == ResultType::SUCCESS) {
     tuple_descriptor = traffic_cop_->GetStatement()->GetTupleDescriptor();
@@ -296,11 +337,22 @@ void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
     return;
   }
 
-  // send the attribute names
-  PutTupleDescriptor(tuple_descriptor);
+  if (copy_out) {
+    // send the remaining rows as CSV, and end the data
+    SendCopyOutRows(tuple_descriptor.size());
+    std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+    pkt->msg_type = NetworkMessageType::COPY_DONE;
+    responses_.push_back(std::move(pkt));
+  } else {
+    // send the attribute names, unless they went out with the first rows
+    if (rows_sent_ == 0) {
+      PutTupleDescriptor(tuple_descriptor);
+    }
 
-  // send the result rows
-  SendDataRows(traffic_cop_->GetResult(), tuple_descriptor.size());
+    // send the result rows
+    SendDataRows(traffic_cop_->GetResult(), tuple_descriptor.size());
+    SendResultBatches(tuple_descriptor.size());
+  }
 
   CompleteCommand(traffic_cop_->GetStatement()->GetQueryType(),
                   traffic_cop_->getRowsAffected());
@@ -638,80 +690,18 @@ size_t PostgresProtocolHandler::ReadParamValue(
         PostgresValueType pg_value_type =
             static_cast<PostgresValueType>(param_types[param_idx]);
         LOG_TRACE("Postgres Protocol Conversion [param_idx=%d]", param_idx);
-        switch (pg_value_type) {
-          case PostgresValueType::TINYINT: {
-            int8_t int_val = 0;
-            for (size_t i = 0; i < sizeof(int8_t); ++i) {
-              int_val = (int_val << 8) | param[i];
-            }
-            bind_parameters[param_idx] =
-                std::make_pair(type::TypeId::TINYINT, std::to_string(int_val));
-            param_values[param_idx] =
-                type::ValueFactory::GetTinyIntValue(int_val).Copy();
-            break;
-          }
-          case PostgresValueType::SMALLINT: {
-            int16_t int_val = 0;
-            for (size_t i = 0; i < sizeof(int16_t); ++i) {
-              int_val = (int_val << 8) | param[i];
-            }
-            bind_parameters[param_idx] =
-                std::make_pair(type::TypeId::SMALLINT, std::to_string(int_val));
-            param_values[param_idx] =
-                type::ValueFactory::GetSmallIntValue(int_val).Copy();
-            break;
-          }
-          case PostgresValueType::INTEGER: {
-            int32_t int_val = 0;
-            for (size_t i = 0; i < sizeof(int32_t); ++i) {
-              int_val = (int_val << 8) | param[i];
-            }
-            bind_parameters[param_idx] =
-                std::make_pair(type::TypeId::INTEGER, std::to_string(int_val));
-            param_values[param_idx] =
-                type::ValueFactory::GetIntegerValue(int_val).Copy();
-            break;
-          }
-          case PostgresValueType::BIGINT: {
-            int64_t int_val = 0;
-            for (size_t i = 0; i < sizeof(int64_t); ++i) {
-              int_val = (int_val << 8) | param[i];
-            }
-            bind_parameters[param_idx] =
-                std::make_pair(type::TypeId::BIGINT, std::to_string(int_val));
-            param_values[param_idx] =
-                type::ValueFactory::GetBigIntValue(int_val).Copy();
-            break;
-          }
-          case PostgresValueType::DOUBLE: {
-            double float_val = 0;
-            unsigned long buf = 0;
-            for (size_t i = 0; i < sizeof(double); ++i) {
-              buf = (buf << 8) | param[i];
-            }
-            PELOTON_MEMCPY(&float_val, &buf, sizeof(double));
-            bind_parameters[param_idx] = std::make_pair(
-                type::TypeId::DECIMAL, std::to_string(float_val));
-            param_values[param_idx] =
-                type::ValueFactory::GetDecimalValue(float_val).Copy();
-            break;
-          }
-          case PostgresValueType::VARBINARY: {
-            bind_parameters[param_idx] = std::make_pair(
-                type::TypeId::VARBINARY,
-                std::string(reinterpret_cast<char *>(&param[0]), param_len));
-            param_values[param_idx] = type::ValueFactory::GetVarbinaryValue(
-                &param[0], param_len, true);
-            break;
-          }
-          default: {
-            LOG_ERROR(
-                "Binary Postgres protocol does not support data type '%s' [%d]",
-                PostgresValueTypeToString(pg_value_type).c_str(),
-                param_types[param_idx]);
-            break;
-          }
+        auto &param_value = param_values[param_idx];
+        if (!PostgresValueFormat::DecodeBinary(pg_value_type, param.data(),
+                                               param_len, param_value)) {
+          LOG_ERROR(
+              "Binary Postgres protocol does not support data type '%s' [%d]",
+              PostgresValueTypeToString(pg_value_type).c_str(),
+              param_types[param_idx]);
         }
+        // Keep the raw bytes, the value is the only thing that gets executed
+        bind_parameters[param_idx] = std::make_pair(
+            param_value.GetTypeId(),
+            std::string(reinterpret_cast<char *>(param.data()), param_len));
         PELOTON_ASSERT(param_values[param_idx].GetTypeId() !=
                        type::TypeId::INVALID);
       }
@@ -769,8 +759,21 @@ ProcessResult PostgresProtocolHandler::ExecExecuteMessage(
     InputPacket *pkt, const size_t thread_id) {
   // EXECUTE message
   protocol_type_ = NetworkProtocolType::POSTGRES_JDBC;
+  rows_sent_ = 0;
   std::string error_message, portal_name;
   GetStringToken(pkt, portal_name);
+  // The maximum number of rows to return, 0 for all of them
+  int max_rows = PacketGetInt(pkt, 4);
+  max_rows_ = max_rows > 0 ? max_rows : 0;
+
+  if (portal_suspended_) {
+    // Any other portal closed the suspended one before, see Process()
+    PELOTON_ASSERT(portal_name == executing_portal_);
+    // Pick up where the last execution of the portal stopped
+    portal_suspended_ = false;
+    traffic_cop_->SetStatement(portals_[portal_name]->GetStatement());
+    return GetResult();
+  }
 
   // covers weird JDBC edge case of sending double BEGIN statements. Don't
   // execute them
@@ -808,6 +811,7 @@ ProcessResult PostgresProtocolHandler::ExecExecuteMessage(
   bool unnamed = statement_name.empty();
   traffic_cop_->SetParamVal(portal->GetParameters());
 
+  executing_portal_ = portal_name;
   auto status = traffic_cop_->ExecuteStatement(
       traffic_cop_->GetStatement(), traffic_cop_->GetParamVal(), unnamed,
       param_stat, result_format_, traffic_cop_->GetResult(), thread_id);
@@ -853,13 +857,56 @@ void PostgresProtocolHandler::ExecExecuteMessageGetResult(ResultType status) {
       auto tuple_descriptor =
           traffic_cop_->GetStatement()->GetTupleDescriptor();
       SendDataRows(traffic_cop_->GetResult(), tuple_descriptor.size());
+      SendResultBatches(tuple_descriptor.size());
       CompleteCommand(query_type, traffic_cop_->getRowsAffected());
       return;
     }
   }
 }
 
-void PostgresProtocolHandler::GetResult() {
+ProcessResult PostgresProtocolHandler::GetResult() {
+  if (portal_closing_) {
+    // Go on with the packet that ended the suspended portal, once its
+    // statement completed
+    if (CloseSuspendedPortal() == false) return ProcessResult::PROCESSING;
+    ProcessResult process_status =
+        ProcessNormalPacket(&request_, closing_thread_id_);
+    request_.Reset();
+    return process_status;
+  }
+
+  if (copy_in_waiting_) {
+    // Go on reading the data of the client once the statement made room for
+    // it, or stopped reading it
+    if (!copy_input_->HasRoom() && !traffic_cop_->FetchResultBatches()) {
+      return ProcessResult::PROCESSING;
+    }
+    copy_in_waiting_ = false;
+    return ProcessResult::COMPLETE;
+  }
+
+  bool execution_done = traffic_cop_->FetchResultBatches();
+  auto tuple_descriptor = traffic_cop_->GetStatement()->GetTupleDescriptor();
+  if (!execution_done || ExceedsRowLimit()) {
+    // The statement still executes, or has more rows than the portal may
+    // return. Send the rows it produced so far, up to the row limit.
+    bool has_rows = !traffic_cop_->GetResultBatches().empty();
+    if (has_rows && copy_mode_ == CopyMode::COPY_OUT) {
+      SendCopyOutRows(tuple_descriptor.size());
+    } else if (has_rows) {
+      if (protocol_type_ == NetworkProtocolType::POSTGRES_PSQL &&
+          rows_sent_ == 0) {
+        PutTupleDescriptor(tuple_descriptor);
+      }
+      SendResultBatches(tuple_descriptor.size());
+    }
+    if (max_rows_ > 0 && rows_sent_ == max_rows_) {
+      SuspendPortal();
+      return ProcessResult::COMPLETE;
+    }
+    return ProcessResult::PROCESSING;
+  }
+
   traffic_cop_->ExecuteStatementPlanGetResult();
   auto status = traffic_cop_->ExecuteStatementGetResult();
   switch (protocol_type_) {
@@ -871,6 +918,7 @@ void PostgresProtocolHandler::GetResult() {
       LOG_TRACE("PSQL result");
       ExecQueryMessageGetResult(status);
   }
+  return ProcessResult::COMPLETE;
 }
 
 void PostgresProtocolHandler::ExecCloseMessage(InputPacket *pkt) {
@@ -1049,6 +1097,14 @@ ProcessResult PostgresProtocolHandler::Process(ReadBuffer &rbuf,
   if (!ParseInputPacket(rbuf, request_, init_stage_))
     return ProcessResult::MORE_DATA_REQUIRED;
 
+  if (init_stage_ == false && EndsSuspendedPortal(&request_) &&
+      CloseSuspendedPortal() == false) {
+    // Keep the packet until the statement of the portal completed, without
+    // blocking the connection thread
+    closing_thread_id_ = thread_id;
+    return ProcessResult::PROCESSING;
+  }
+
   ProcessResult process_status =
       init_stage_ ? ProcessInitialPacket(&request_)
                   : ProcessNormalPacket(&request_, thread_id);
@@ -1061,6 +1117,9 @@ ProcessResult PostgresProtocolHandler::Process(ReadBuffer &rbuf,
 ProcessResult PostgresProtocolHandler::ProcessNormalPacket(
     InputPacket *pkt, const size_t thread_id) {
   LOG_TRACE("Message type: %c", static_cast<unsigned char>(pkt->msg_type));
+  if (copy_mode_ == CopyMode::COPY_IN) {
+    return ProcessCopyInPacket(pkt);
+  }
   // We don't set force_flush to true for `PBDE` messages because they're
   // part of the extended protocol. Buffer responses and don't flush until
   // we see a SYNC
@@ -1113,6 +1172,52 @@ ProcessResult PostgresProtocolHandler::ProcessNormalPacket(
   }
   return ProcessResult::COMPLETE;
 }
+ProcessResult PostgresProtocolHandler::ProcessCopyInPacket(InputPacket *pkt) {
+  switch (pkt->msg_type) {
+    case NetworkMessageType::COPY_DATA: {
+      LOG_TRACE("COPY_DATA");
+      // Once the statement finished, e.g. with an error, the rest of the
+      // data is dropped
+      if (pkt->len == 0 || traffic_cop_->FetchResultBatches()) {
+        return ProcessResult::COMPLETE;
+      }
+      if (!copy_input_->Write(&*pkt->Begin(), pkt->len)) {
+        // Wait for the statement to catch up
+        copy_in_waiting_ = true;
+        return ProcessResult::PROCESSING;
+      }
+      return ProcessResult::COMPLETE;
+    }
+    case NetworkMessageType::COPY_DONE: {
+      LOG_TRACE("COPY_DONE");
+      SetFlushFlag(true);
+      copy_input_->Close();
+      return GetResult();
+    }
+    case NetworkMessageType::COPY_FAIL_COMMAND: {
+      LOG_TRACE("COPY_FAIL_COMMAND");
+      std::string message;
+      GetStringToken(pkt, message);
+      SetFlushFlag(true);
+      copy_input_->Fail("COPY from stdin failed: " + message);
+      return GetResult();
+    }
+    case NetworkMessageType::FLUSH_COMMAND:
+    case NetworkMessageType::SYNC_COMMAND:
+      // Ignored until the COPY ends
+      return ProcessResult::COMPLETE;
+    default: {
+      LOG_ERROR("Unexpected message type during COPY from stdin: %c",
+                static_cast<unsigned char>(pkt->msg_type));
+      SetFlushFlag(true);
+      copy_input_->Fail(StringUtil::Format(
+          "unexpected message type 0x%02X during COPY from stdin",
+          static_cast<int>(pkt->msg_type)));
+      return GetResult();
+    }
+  }
+}
+
 void PostgresProtocolHandler::MakeHardcodedParameterStatus(
     const std::pair<std::string, std::string> &kv) {
   std::unique_ptr<OutputPacket> response(new OutputPacket());
@@ -1130,7 +1235,8 @@ void PostgresProtocolHandler::PutTupleDescriptor(
   pkt->msg_type = NetworkMessageType::ROW_DESCRIPTION;
   PacketPutInt(pkt.get(), tuple_descriptor.size(), 2);
 
-  for (auto col : tuple_descriptor) {
+  for (size_t col_idx = 0; col_idx < tuple_descriptor.size(); col_idx++) {
+    const auto &col = tuple_descriptor[col_idx];
     PacketPutStringWithTerminator(pkt.get(), std::get<0>(col));
     // TODO: Table Oid (int32)
     PacketPutInt(pkt.get(), 0, 4);
@@ -1142,17 +1248,26 @@ void PostgresProtocolHandler::PutTupleDescriptor(
     PacketPutInt(pkt.get(), std::get<2>(col), 2);
     // Type modifier (int32)
     PacketPutInt(pkt.get(), -1, 4);
-    // Format code for text
-    PacketPutInt(pkt.get(), 0, 2);
+    // Format code of the column, as requested when binding the portal
+    int format = PostgresValueFormat::TEXT_FORMAT;
+    if (col_idx < result_format_.size()) {
+      format = result_format_[col_idx];
+    }
+    PacketPutInt(pkt.get(), format, 2);
   }
   responses_.push_back(std::move(pkt));
 }
 
 void PostgresProtocolHandler::SendDataRows(std::vector<ResultValue> &results,
                                            int colcount) {
-  if (results.empty() || colcount == 0) return;
+  if (colcount == 0) return;
 
   size_t numrows = results.size() / colcount;
+  if (max_rows_ > 0) {
+    numrows = std::min(numrows, max_rows_ - rows_sent_);
+  }
+  rows_sent_ += numrows;
+  if (rows_sent_ == 0) return;
 
   // 1 packet per row
   for (size_t i = 0; i < numrows; i++) {
@@ -1160,7 +1275,7 @@ void PostgresProtocolHandler::SendDataRows(std::vector<ResultValue> &results,
     pkt->msg_type = NetworkMessageType::DATA_ROW;
     PacketPutInt(pkt.get(), colcount, 2);
     for (int j = 0; j < colcount; j++) {
-      auto content = results[i * colcount + j];
+      const auto &content = results[i * colcount + j];
       if (content.size() == 0) {
         // content is NULL
         PacketPutInt(pkt.get(), NULL_CONTENT_SIZE, 4);
@@ -1174,7 +1289,193 @@ void PostgresProtocolHandler::SendDataRows(std::vector<ResultValue> &results,
     }
     responses_.push_back(std::move(pkt));
   }
-  traffic_cop_->setRowsAffected(numrows);
+  results.erase(results.begin(), results.begin() + numrows * colcount);
+  traffic_cop_->setRowsAffected(rows_sent_);
+}
+
+void PostgresProtocolHandler::SendResultBatches(int colcount) {
+  if (colcount == 0) return;
+
+  auto &batches = traffic_cop_->GetResultBatches();
+  while (!batches.empty()) {
+    auto &batch = batches.front();
+    size_t numrows = batch.NumRows();
+    if (max_rows_ > 0) {
+      numrows = std::min(numrows, max_rows_ - rows_sent_);
+    }
+
+    // 1 packet per row, whose columns are in the batch as they go out
+    for (size_t i = 0; i < numrows; i++) {
+      std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+      pkt->msg_type = NetworkMessageType::DATA_ROW;
+      PacketPutInt(pkt.get(), colcount, 2);
+      PacketPutCbytes(pkt.get(), reinterpret_cast<const uchar *>(batch.GetRow(i)),
+                      batch.GetRowSize(i));
+      responses_.push_back(std::move(pkt));
+    }
+    rows_sent_ += numrows;
+
+    if (numrows < batch.NumRows()) {
+      // The portal reached its row limit
+      batch.DropRows(numrows);
+      break;
+    }
+    batches.pop_front();
+  }
+  if (rows_sent_ > 0) {
+    traffic_cop_->setRowsAffected(rows_sent_);
+  }
+}
+
+size_t PostgresProtocolHandler::NumFetchedRows() {
+  size_t num_rows = 0;
+  for (auto &batch : traffic_cop_->GetResultBatches()) {
+    num_rows += batch.NumRows();
+  }
+  return num_rows;
+}
+
+bool PostgresProtocolHandler::ExceedsRowLimit() {
+  if (max_rows_ == 0) return false;
+  return rows_sent_ + NumFetchedRows() > max_rows_;
+}
+
+void PostgresProtocolHandler::SuspendPortal() {
+  LOG_TRACE("Suspending portal %s", executing_portal_.c_str());
+  portal_suspended_ = true;
+  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  pkt->msg_type = NetworkMessageType::PORTAL_SUSPENDED;
+  responses_.push_back(std::move(pkt));
+}
+
+bool PostgresProtocolHandler::EndsSuspendedPortal(InputPacket *pkt) {
+  if (!portal_suspended_) return false;
+  switch (pkt->msg_type) {
+    case NetworkMessageType::SIMPLE_QUERY_COMMAND:
+    case NetworkMessageType::PARSE_COMMAND:
+    case NetworkMessageType::BIND_COMMAND:
+      return true;
+    case NetworkMessageType::EXECUTE_COMMAND:
+    case NetworkMessageType::CLOSE_COMMAND: {
+      // Peek at the portal the packet names
+      size_t start = pkt->ptr;
+      uchar close_type = 'P';
+      if (pkt->msg_type == NetworkMessageType::CLOSE_COMMAND) {
+        PacketGetByte(pkt, close_type);
+      }
+      std::string name;
+      GetStringToken(pkt, name);
+      pkt->ptr = start;
+      if (pkt->msg_type == NetworkMessageType::EXECUTE_COMMAND) {
+        return name != executing_portal_;
+      }
+      return close_type == 'P' && name == executing_portal_;
+    }
+    case NetworkMessageType::SYNC_COMMAND:
+      // A portal outlives the sync only inside a transaction block
+      return txn_state_ != NetworkTransactionStateType::BLOCK;
+    default:
+      return false;
+  }
+}
+
+bool PostgresProtocolHandler::CloseSuspendedPortal() {
+  if (!portal_suspended_) return true;
+  if (!portal_closing_) {
+    LOG_TRACE("Closing suspended portal %s", executing_portal_.c_str());
+    portal_closing_ = true;
+    traffic_cop_->CancelResultStream();
+  }
+  if (traffic_cop_->FetchResultBatches() == false) return false;
+  portal_suspended_ = false;
+  portal_closing_ = false;
+  traffic_cop_->GetResultBatches().clear();
+  // Commit or abort the statement like any other
+  traffic_cop_->ExecuteStatementPlanGetResult();
+  traffic_cop_->ExecuteStatementGetResult();
+  // The portal cannot run again from the start as if nothing happened
+  portals_.erase(executing_portal_);
+  return true;
+}
+
+void PostgresProtocolHandler::SendCopyResponse(NetworkMessageType msg_type,
+                                               int colcount) {
+  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  pkt->msg_type = msg_type;
+  // Overall format, then the format of each column
+  PacketPutByte(pkt.get(), PostgresValueFormat::TEXT_FORMAT);
+  PacketPutInt(pkt.get(), colcount, 2);
+  for (int i = 0; i < colcount; i++) {
+    PacketPutInt(pkt.get(), PostgresValueFormat::TEXT_FORMAT, 2);
+  }
+  responses_.push_back(std::move(pkt));
+}
+
+void PostgresProtocolHandler::SendCopyOutRows(int colcount) {
+  if (rows_sent_ == 0) {
+    SendCopyResponse(NetworkMessageType::COPY_OUT_RESPONSE, colcount);
+  }
+  if (colcount == 0) return;
+
+  auto &batches = traffic_cop_->GetResultBatches();
+  for (auto &batch : batches) {
+    for (size_t i = 0; i < batch.NumRows(); i++) {
+      std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+      pkt->msg_type = NetworkMessageType::COPY_DATA;
+      PacketPutString(pkt.get(), EncodeCopyRow(batch.GetRow(i), colcount));
+      responses_.push_back(std::move(pkt));
+    }
+    rows_sent_ += batch.NumRows();
+  }
+  batches.clear();
+  if (rows_sent_ > 0) {
+    traffic_cop_->setRowsAffected(rows_sent_);
+  }
+}
+
+std::string PostgresProtocolHandler::EncodeCopyRow(const char *row,
+                                                   int colcount) {
+  const char special[] = {copy_delimiter_, copy_quote_, '\n', '\r'};
+  const char *special_end = special + sizeof(special);
+  std::string line;
+  for (int i = 0; i < colcount; i++) {
+    if (i > 0) line.push_back(copy_delimiter_);
+    const char *value;
+    int32_t len;
+    row = ResultBatch::ReadColumn(row, value, len);
+    // NULL is an empty value, so an empty string is quoted to tell them apart
+    if (len < 0) continue;
+    const char *value_end = value + len;
+    if (len > 0 && std::find_first_of(value, value_end, special,
+                                      special_end) == value_end) {
+      line.append(value, len);
+      continue;
+    }
+    // Quote the value, and escape the quotes and escapes in it
+    line.push_back(copy_quote_);
+    for (const char *c = value; c != value_end; c++) {
+      if (*c == copy_quote_ || *c == copy_escape_) {
+        line.push_back(copy_escape_);
+      }
+      line.push_back(*c);
+    }
+    line.push_back(copy_quote_);
+  }
+  line.push_back('\n');
+  return line;
+}
+
+void PostgresProtocolHandler::AbortCopyIn() {
+  if (copy_mode_ != CopyMode::COPY_IN) return;
+  LOG_TRACE("Aborting COPY from stdin");
+  copy_input_->Fail("COPY from stdin aborted");
+  traffic_cop_->DiscardResultBatches();
+  // Commit or abort the statement like any other
+  traffic_cop_->ExecuteStatementPlanGetResult();
+  traffic_cop_->ExecuteStatementGetResult();
+  copy_mode_ = CopyMode::NONE;
+  copy_input_.reset();
+  copy_in_waiting_ = false;
 }
 
 void PostgresProtocolHandler::CompleteCommand(const QueryType &query_type,
@@ -1250,6 +1551,11 @@ void PostgresProtocolHandler::SendReadyForQuery(
 }
 
 void PostgresProtocolHandler::Reset() {
+  // The connection goes away, so waiting for the cancelled statement is fine
+  if (portal_suspended_) traffic_cop_->DiscardResultBatches();
+  CloseSuspendedPortal();
+  AbortCopyIn();
+  copy_mode_ = CopyMode::NONE;
   ProtocolHandler::Reset();
   statement_cache_.Clear();
   result_format_.clear();
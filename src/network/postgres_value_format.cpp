@@ -0,0 +1,241 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// postgres_value_format.cpp
+//
+// Identification: src/network/postgres_value_format.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "network/postgres_value_format.h"
+
+#include <cstring>
+
+#include "function/date_functions.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace network {
+
+constexpr int PostgresValueFormat::TEXT_FORMAT;
+constexpr int PostgresValueFormat::BINARY_FORMAT;
+constexpr int32_t PostgresValueFormat::POSTGRES_EPOCH_JDATE;
+
+namespace {
+
+constexpr int64_t USECS_PER_SEC = 1000000;
+constexpr int64_t USECS_PER_DAY = 86400 * USECS_PER_SEC;
+
+// The unsigned integer type with the given number of bytes
+template <size_t N>
+struct UnsignedBits {};
+template <>
+struct UnsignedBits<1> {
+  using type = uint8_t;
+};
+template <>
+struct UnsignedBits<2> {
+  using type = uint16_t;
+};
+template <>
+struct UnsignedBits<4> {
+  using type = uint32_t;
+};
+template <>
+struct UnsignedBits<8> {
+  using type = uint64_t;
+};
+
+// Append the bytes of the value in network byte order
+template <typename T>
+void AppendBigEndian(std::string &out, T val) {
+  typename UnsignedBits<sizeof(T)>::type bits;
+  PELOTON_MEMCPY(&bits, &val, sizeof(T));
+  for (size_t i = sizeof(T); i > 0; i--) {
+    out.push_back(static_cast<char>((bits >> ((i - 1) * 8)) & 0xFF));
+  }
+}
+
+// Read a value of the given type stored in network byte order
+template <typename T>
+T ReadBigEndian(const uchar *data) {
+  typename UnsignedBits<sizeof(T)>::type bits = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    bits = (bits << 8) | data[i];
+  }
+  T val;
+  PELOTON_MEMCPY(&val, &bits, sizeof(T));
+  return val;
+}
+
+// Append the binary format of a non-NULL value
+void AppendBinary(std::string &out, const type::Value &val) {
+  switch (val.GetTypeId()) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+      out.push_back(static_cast<char>(val.GetAs<int8_t>()));
+      break;
+    case type::TypeId::SMALLINT:
+      AppendBigEndian(out, val.GetAs<int16_t>());
+      break;
+    case type::TypeId::INTEGER:
+      AppendBigEndian(out, val.GetAs<int32_t>());
+      break;
+    case type::TypeId::BIGINT:
+      AppendBigEndian(out, val.GetAs<int64_t>());
+      break;
+    case type::TypeId::DECIMAL:
+      AppendBigEndian(out, val.GetAs<double>());
+      break;
+    case type::TypeId::DATE:
+      AppendBigEndian(out, val.GetAs<int32_t>() -
+                               PostgresValueFormat::POSTGRES_EPOCH_JDATE);
+      break;
+    case type::TypeId::TIMESTAMP:
+      AppendBigEndian(out, PostgresValueFormat::TimestampToPostgres(
+                               val.GetAs<uint64_t>()));
+      break;
+    default:
+      // The binary format of text and bytea is their raw bytes
+      out.append(val.ToString());
+      break;
+  }
+}
+
+}  // namespace
+
+void PostgresValueFormat::AppendColumn(std::string &out,
+                                       const type::Value &val, int format) {
+  // NULL has no bytes, and the length -1
+  if (val.IsNull()) {
+    AppendBigEndian(out, static_cast<int32_t>(-1));
+    return;
+  }
+
+  // Leave room for the length, which is known once the value is there
+  size_t len_pos = out.size();
+  AppendBigEndian(out, static_cast<int32_t>(0));
+  if (format == TEXT_FORMAT) {
+    out.append(val.ToString());
+  } else {
+    AppendBinary(out, val);
+  }
+  auto len = static_cast<uint32_t>(out.size() - len_pos - sizeof(int32_t));
+  for (size_t i = 0; i < sizeof(int32_t); i++) {
+    out[len_pos + i] = static_cast<char>((len >> ((3 - i) * 8)) & 0xFF);
+  }
+}
+
+std::string PostgresValueFormat::EncodeValue(const type::Value &val,
+                                             int format) {
+  if (format == TEXT_FORMAT) {
+    return val.ToString();
+  }
+  return EncodeBinary(val);
+}
+
+std::string PostgresValueFormat::EncodeBinary(const type::Value &val) {
+  std::string out;
+  AppendBinary(out, val);
+  return out;
+}
+
+bool PostgresValueFormat::DecodeBinary(PostgresValueType type,
+                                       const uchar *data, size_t len,
+                                       type::Value &result) {
+  switch (type) {
+    case PostgresValueType::BOOLEAN:
+      if (len != 1) return false;
+      result = type::ValueFactory::GetBooleanValue(data[0] != 0);
+      return true;
+    case PostgresValueType::SMALLINT:
+      if (len != sizeof(int16_t)) return false;
+      result =
+          type::ValueFactory::GetSmallIntValue(ReadBigEndian<int16_t>(data));
+      return true;
+    case PostgresValueType::INTEGER:
+      if (len != sizeof(int32_t)) return false;
+      result =
+          type::ValueFactory::GetIntegerValue(ReadBigEndian<int32_t>(data));
+      return true;
+    case PostgresValueType::BIGINT:
+      if (len != sizeof(int64_t)) return false;
+      result = type::ValueFactory::GetBigIntValue(ReadBigEndian<int64_t>(data));
+      return true;
+    case PostgresValueType::REAL:
+      if (len != sizeof(float)) return false;
+      result = type::ValueFactory::GetDecimalValue(ReadBigEndian<float>(data));
+      return true;
+    case PostgresValueType::DOUBLE:
+      if (len != sizeof(double)) return false;
+      result = type::ValueFactory::GetDecimalValue(ReadBigEndian<double>(data));
+      return true;
+    case PostgresValueType::TEXT:
+    case PostgresValueType::BPCHAR:
+    case PostgresValueType::BPCHAR2:
+    case PostgresValueType::VARCHAR:
+    case PostgresValueType::VARCHAR2:
+      result = type::ValueFactory::GetVarcharValue(
+          std::string(reinterpret_cast<const char *>(data), len));
+      return true;
+    case PostgresValueType::VARBINARY:
+      result = type::ValueFactory::GetVarbinaryValue(data, len, true);
+      return true;
+    case PostgresValueType::DATE:
+      if (len != sizeof(int32_t)) return false;
+      result = type::ValueFactory::GetDateValue(ReadBigEndian<int32_t>(data) +
+                                                POSTGRES_EPOCH_JDATE);
+      return true;
+    case PostgresValueType::TIMESTAMPS:
+    case PostgresValueType::TIMESTAMPS2:
+      if (len != sizeof(int64_t)) return false;
+      result = type::ValueFactory::GetTimestampValue(
+          TimestampFromPostgres(ReadBigEndian<int64_t>(data)));
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t PostgresValueFormat::TimestampToPostgres(uint64_t timestamp) {
+  // See ValueFactory::CastAsTimestamp() for the layout of a timestamp
+  int64_t micro = timestamp % 1000000;
+  timestamp /= 1000000;
+  int64_t sec = timestamp % 100000;
+  timestamp /= 100000;
+  int32_t year = timestamp % 10000;
+  timestamp /= 10000;
+  timestamp /= 27;  // skip time zone
+  int32_t day = timestamp % 32;
+  timestamp /= 32;
+  int32_t month = timestamp;
+
+  int64_t days =
+      function::DateFunctions::DateToJulian(year, month, day) -
+      POSTGRES_EPOCH_JDATE;
+  return days * USECS_PER_DAY + sec * USECS_PER_SEC + micro;
+}
+
+uint64_t PostgresValueFormat::TimestampFromPostgres(int64_t micros) {
+  int64_t days = micros / USECS_PER_DAY;
+  int64_t time = micros % USECS_PER_DAY;
+  if (time < 0) {
+    time += USECS_PER_DAY;
+    days--;
+  }
+
+  int32_t year, month, day;
+  function::DateFunctions::JulianToDate(days + POSTGRES_EPOCH_JDATE, year,
+                                        month, day);
+
+  // UTC is stored as time zone 12
+  uint64_t res = ((static_cast<uint64_t>(month) * 32 + day) * 27 + 12) * 10000;
+  res = (res + year) * 100000 + time / USECS_PER_SEC;
+  return res * 1000000 + time % USECS_PER_SEC;
+}
+
+}  // namespace network
+}  // namespace peloton
@@ -33,6 +33,6 @@ void ProtocolHandler::Reset() {
   request_.Reset();
 }
 
-void ProtocolHandler::GetResult() {}
+ProcessResult ProtocolHandler::GetResult() { return ProcessResult::COMPLETE; }
 }  // namespace network
 }  // namespace peloton
@@ -69,7 +69,16 @@ void ChildPropertyDeriver::Visit(const PhysicalIndexScan *op) {
         }
       }
       if (!can_fulfill) break;
+      // A hash index has no order, so a scan on it cannot provide any
+      auto scanned_index = target_table->GetIndexCatalogEntries(op->index_id);
+      if (scanned_index != nullptr &&
+          scanned_index->GetIndexType() == IndexType::HASH) {
+        break;
+      }
       for (auto &index : target_table->GetIndexCatalogEntries()) {
+        if (index.second->GetIndexType() == IndexType::HASH) {
+          continue;
+        }
         auto key_oids = index.second->GetKeyAttrs();
         // If the sort column size is larger, then can't be fulfill by the index
         if (sort_col_size > key_oids.size()) {
@@ -169,6 +178,26 @@ void ChildPropertyDeriver::Visit(const PhysicalInnerHashJoin *) {
 void ChildPropertyDeriver::Visit(const PhysicalLeftHashJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalRightHashJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalOuterHashJoin *) {}
+
+void ChildPropertyDeriver::Visit(const PhysicalInnerMergeJoin *op) {
+  // Both children must be sorted (ascending) on their join keys. Equal keys
+  // are joined in key order, so the output is sorted on the left keys.
+  vector<expression::AbstractExpression *> left_sort_cols;
+  for (auto &key : op->left_keys) left_sort_cols.push_back(key.get());
+  vector<expression::AbstractExpression *> right_sort_cols;
+  for (auto &key : op->right_keys) right_sort_cols.push_back(key.get());
+
+  shared_ptr<PropertySet> left_prop_set = make_shared<PropertySet>(
+      vector<shared_ptr<Property>>{make_shared<PropertySort>(
+          left_sort_cols, vector<bool>(left_sort_cols.size(), true))});
+  shared_ptr<PropertySet> right_prop_set = make_shared<PropertySet>(
+      vector<shared_ptr<Property>>{make_shared<PropertySort>(
+          right_sort_cols, vector<bool>(right_sort_cols.size(), true))});
+  output_.push_back(make_pair(
+      left_prop_set,
+      vector<shared_ptr<PropertySet>>{left_prop_set, right_prop_set}));
+}
+
 void ChildPropertyDeriver::Visit(const PhysicalInsert *) {
   vector<shared_ptr<PropertySet>> child_input_properties;
 
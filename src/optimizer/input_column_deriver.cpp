@@ -167,6 +167,10 @@ void InputColumnDeriver::Visit(const PhysicalRightHashJoin *) {}
 
 void InputColumnDeriver::Visit(const PhysicalOuterHashJoin *) {}
 
+void InputColumnDeriver::Visit(const PhysicalInnerMergeJoin *op) {
+  JoinHelper(op);
+}
+
 void InputColumnDeriver::Visit(const PhysicalInsert *) {
   output_input_cols_ =
       pair<vector<AbstractExpression *>, vector<vector<AbstractExpression *>>>{
@@ -284,6 +288,11 @@ void InputColumnDeriver::JoinHelper(const BaseOperatorNode *op) {
     join_conds = &(join_op->join_predicates);
     left_keys = &(join_op->left_keys);
     right_keys = &(join_op->right_keys);
+  } else if (op->GetType() == OpType::InnerMergeJoin) {
+    auto join_op = reinterpret_cast<const PhysicalInnerMergeJoin *>(op);
+    join_conds = &(join_op->join_predicates);
+    left_keys = &(join_op->left_keys);
+    right_keys = &(join_op->right_keys);
   }
 
   ExprSet input_cols_set;
@@ -29,6 +29,7 @@
 #include "planner/index_scan_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/limit_plan.h"
+#include "planner/merge_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/projection_plan.h"
@@ -52,6 +53,13 @@ using std::pair;
 namespace peloton {
 namespace optimizer {
 
+// The number of build-side tuples of a radix partition. With the default
+// entry sizes, a partition of the hash table fits in the L2 cache.
+static const uint64_t kRadixJoinPartitionSize = 16 * 1024;
+
+// The largest fan-out partitioned in a single pass before TLB misses dominate
+static const uint32_t kMaxRadixJoinPartitionBits = 11;
+
 PlanGenerator::PlanGenerator() {}
 
 unique_ptr<planner::AbstractPlan> PlanGenerator::ConvertOpExpression(
@@ -222,7 +230,7 @@ void PlanGenerator::Visit(const PhysicalHashGroupBy *op) {
 void PlanGenerator::Visit(const PhysicalSortGroupBy *op) {
   auto having_predicates =
       expression::ExpressionUtil::JoinAnnotatedExprs(op->having);
-  BuildAggregatePlan(AggregateType::HASH, &op->columns,
+  BuildAggregatePlan(AggregateType::SORTED, &op->columns,
                      std::move(having_predicates));
 }
 
@@ -326,10 +334,12 @@ void PlanGenerator::Visit(const PhysicalInnerHashJoin *op) {
   unique_ptr<planner::HashPlan> hash_plan(new planner::HashPlan(hash_keys));
   hash_plan->AddChild(move(children_plans_[1]));
 
-  auto join_plan = unique_ptr<planner::AbstractPlan>(new planner::HashJoinPlan(
+  auto join_plan = unique_ptr<planner::HashJoinPlan>(new planner::HashJoinPlan(
       JoinType::INNER, move(join_predicate), move(proj_info), proj_schema,
       left_keys, right_keys, settings::SettingsManager::GetBool(
                                  settings::SettingId::hash_join_bloom_filter)));
+  join_plan->SetRadixPartitionBits(
+      GenerateRadixPartitionBits(children_plans_[0]->GetCardinality()));
 
   join_plan->AddChild(move(children_plans_[0]));
   join_plan->AddChild(move(hash_plan));
@@ -342,6 +352,41 @@ void PlanGenerator::Visit(const PhysicalRightHashJoin *) {}
 
 void PlanGenerator::Visit(const PhysicalOuterHashJoin *) {}
 
+void PlanGenerator::Visit(const PhysicalInnerMergeJoin *op) {
+  std::unique_ptr<const planner::ProjectInfo> proj_info;
+  std::shared_ptr<const catalog::Schema> proj_schema;
+  GenerateProjectionForJoin(proj_info, proj_schema);
+
+  auto join_predicate =
+      expression::ExpressionUtil::JoinAnnotatedExprs(op->join_predicates);
+  expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                 join_predicate.get());
+  expression::ExpressionUtil::ConvertToTvExpr(join_predicate.get(),
+                                              children_expr_map_);
+
+  // The left key of every clause is evaluated against the left tuple and the
+  // right key against the right tuple
+  vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+  for (size_t i = 0; i < op->left_keys.size(); i++) {
+    auto left_key = op->left_keys[i]->Copy();
+    auto right_key = op->right_keys[i]->Copy();
+    expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                   left_key);
+    expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                   right_key);
+    join_clauses.emplace_back(left_key, right_key, false);
+  }
+
+  auto join_plan =
+      unique_ptr<planner::MergeJoinPlan>(new planner::MergeJoinPlan(
+          JoinType::INNER, move(join_predicate), move(proj_info), proj_schema,
+          join_clauses));
+
+  join_plan->AddChild(move(children_plans_[0]));
+  join_plan->AddChild(move(children_plans_[1]));
+  output_plan_ = move(join_plan);
+}
+
 void PlanGenerator::Visit(const PhysicalInsert *op) {
   unique_ptr<planner::AbstractPlan> insert_plan(new planner::InsertPlan(
       storage::StorageManager::GetInstance()->GetTableWithOid(
@@ -639,5 +684,28 @@ void PlanGenerator::GenerateProjectionForJoin(
       new planner::ProjectInfo(move(tl), move(dml)));
   proj_schema = std::make_shared<const catalog::Schema>(columns);
 }
+
+uint32_t PlanGenerator::GenerateRadixPartitionBits(int build_cardinality) {
+  if (!settings::SettingsManager::GetBool(
+          settings::SettingId::hash_join_radix_partitioning)) {
+    return 0;
+  }
+
+  // Small build sides are cache resident anyway, partitioning only adds cost.
+  // Unknown cardinalities are negative.
+  auto min_build_size = settings::SettingsManager::GetInt(
+      settings::SettingId::min_radix_join_build_size);
+  if (build_cardinality < min_build_size) {
+    return 0;
+  }
+
+  uint32_t bits = 1;
+  while (bits < kMaxRadixJoinPartitionBits &&
+         (static_cast<uint64_t>(build_cardinality) >> bits) >
+             kRadixJoinPartitionSize) {
+    bits++;
+  }
+  return bits;
+}
 }  // namespace optimizer
 }  // namespace peloton
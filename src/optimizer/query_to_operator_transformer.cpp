@@ -400,11 +400,15 @@ void QueryToOperatorTransformer::Visit(parser::CopyStatement *op) {
     } else {
       op->table->Accept(this);
     }
-    auto export_op =
-        std::make_shared<OperatorExpression>(LogicalExportExternalFile::make(
-            op->format, op->file_path, op->delimiter, op->quote, op->escape));
-    export_op->PushChild(output_expr_);
-    output_expr_ = export_op;
+    // Without a file, the rows go to the client like those of a query, and
+    // the connection writes them out as CSV
+    if (!op->file_path.empty()) {
+      auto export_op =
+          std::make_shared<OperatorExpression>(LogicalExportExternalFile::make(
+              op->format, op->file_path, op->delimiter, op->quote, op->escape));
+      export_op->PushChild(output_expr_);
+      output_expr_ = export_op;
+    }
   }
 }
 
@@ -284,6 +284,10 @@ void GetToIndexScan::Transform(
       for (auto &index_id_object_pair : get->table->GetIndexCatalogEntries()) {
         auto &index_id = index_id_object_pair.first;
         auto &index = index_id_object_pair.second;
+        // A hash index does not keep its keys in order
+        if (index->GetIndexType() == IndexType::HASH) {
+          continue;
+        }
         auto &index_col_ids = index->GetKeyAttrs();
         // We want to ensure that Sort(a, b, c, d, e) can fit Sort(a, b, c)
         size_t l_num_sort_columns = index_col_ids.size();
@@ -392,6 +396,20 @@ void GetToIndexScan::Transform(
           index_value_list.push_back(value_list[offset]);
         }
       }
+      // A hash index only serves lookups that bind every key column with an
+      // equality predicate
+      if (index_object->GetIndexType() == IndexType::HASH) {
+        std::unordered_set<oid_t> eq_col_set;
+        for (size_t offset = 0; offset < index_key_column_id_list.size();
+             offset++) {
+          if (index_expr_type_list[offset] == ExpressionType::COMPARE_EQUAL) {
+            eq_col_set.insert(index_key_column_id_list[offset]);
+          }
+        }
+        if (eq_col_set.size() != index_col_set.size()) {
+          continue;
+        }
+      }
       // Add transformed plan
       if (!index_key_column_id_list.empty()) {
         auto index_scan_op = PhysicalIndexScan::make(
@@ -606,6 +624,47 @@ void LogicalGroupByToHashGroupBy::Transform(
   transformed.push_back(result);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// LogicalGroupByToSortGroupBy
+LogicalGroupByToSortGroupBy::LogicalGroupByToSortGroupBy() {
+  type_ = RuleType::AGGREGATE_TO_SORT_AGGREGATE;
+  match_pattern = std::make_shared<Pattern>(OpType::LogicalAggregateAndGroupBy);
+  std::shared_ptr<Pattern> child(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern->AddChild(child);
+}
+
+bool LogicalGroupByToSortGroupBy::Check(
+    std::shared_ptr<OperatorExpression> plan,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  const LogicalAggregateAndGroupBy *agg_op =
+      plan->Op().As<LogicalAggregateAndGroupBy>();
+  if (agg_op->columns.empty()) {
+    return false;
+  }
+
+  // The child is sorted on the grouping columns, which only base columns can
+  // be (either by an index or by a sort below the aggregation)
+  for (auto &col : agg_op->columns) {
+    if (col->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void LogicalGroupByToSortGroupBy::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  const LogicalAggregateAndGroupBy *agg_op =
+      input->Op().As<LogicalAggregateAndGroupBy>();
+  auto result = std::make_shared<OperatorExpression>(
+      PhysicalSortGroupBy::make(agg_op->columns, agg_op->having));
+  PELOTON_ASSERT(input->Children().size() == 1);
+  result->PushChild(input->Children().at(0));
+  transformed.push_back(result);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// LogicalAggregateToPhysical
 LogicalAggregateToPhysical::LogicalAggregateToPhysical() {
@@ -756,6 +815,60 @@ void InnerJoinToInnerHashJoin::Transform(
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinToInnerMergeJoin
+InnerJoinToInnerMergeJoin::InnerJoinToInnerMergeJoin() {
+  type_ = RuleType::INNER_JOIN_TO_MERGE_JOIN;
+
+  std::shared_ptr<Pattern> left_child(std::make_shared<Pattern>(OpType::Leaf));
+  std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
+
+  match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
+  match_pattern->AddChild(left_child);
+  match_pattern->AddChild(right_child);
+}
+
+bool InnerJoinToInnerMergeJoin::Check(
+    UNUSED_ATTRIBUTE std::shared_ptr<OperatorExpression> plan,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  return true;
+}
+
+void InnerJoinToInnerMergeJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  const LogicalInnerJoin *inner_join = input->Op().As<LogicalInnerJoin>();
+
+  auto children = input->Children();
+  PELOTON_ASSERT(children.size() == 2);
+  auto left_group_id = children[0]->Op().As<LeafOperator>()->origin_group;
+  auto right_group_id = children[1]->Op().As<LeafOperator>()->origin_group;
+  auto &left_group_alias =
+      context->metadata->memo.GetGroupByID(left_group_id)->GetTableAliases();
+  auto &right_group_alias =
+      context->metadata->memo.GetGroupByID(right_group_id)->GetTableAliases();
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+
+  // Both inputs are merged in the order of the equi-join keys, so there must
+  // be at least one of them
+  util::ExtractEquiJoinKeys(inner_join->join_predicates, left_keys, right_keys,
+                            left_group_alias, right_group_alias);
+
+  PELOTON_ASSERT(right_keys.size() == left_keys.size());
+  if (!left_keys.empty()) {
+    auto result_plan =
+        std::make_shared<OperatorExpression>(PhysicalInnerMergeJoin::make(
+            inner_join->join_predicates, left_keys, right_keys));
+
+    result_plan->PushChild(children[0]);
+    result_plan->PushChild(children[1]);
+
+    transformed.push_back(result_plan);
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// ImplementDistinct
 ImplementDistinct::ImplementDistinct() {
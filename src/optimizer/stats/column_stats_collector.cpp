@@ -12,6 +12,8 @@
 
 #include "optimizer/stats/column_stats_collector.h"
 
+#include <algorithm>
+
 #include "common/macros.h"
 
 namespace peloton {
@@ -52,6 +54,15 @@ void ColumnStatsCollector::AddValue(const type::Value &value) {
   }
 }
 
+void ColumnStatsCollector::Merge(const ColumnStatsCollector &other) {
+  PELOTON_ASSERT(column_id_ == other.column_id_);
+  total_count_ += other.total_count_;
+  null_count_ += other.null_count_;
+  hll_.Merge(other.hll_);
+  hist_.Merge(other.hist_);
+  topk_.Merge(other.topk_);
+}
+
 double ColumnStatsCollector::GetFracNull() {
   if (total_count_ == 0) {
     LOG_TRACE("Cannot calculate stats for table size 0.");
@@ -60,5 +71,32 @@ double ColumnStatsCollector::GetFracNull() {
   return (static_cast<double>(null_count_) / total_count_);
 }
 
+std::vector<ColumnStatsCollector::ValueFrequencyPair>
+ColumnStatsCollector::GetCommonValueAndFrequency() {
+  std::vector<ValueFrequencyPair> common_values = topk_.GetAllOrderedMaxFirst();
+  for (auto &common_value : common_values) {
+    common_value.second /= sample_ratio_;
+  }
+  return common_values;
+}
+
+uint64_t ColumnStatsCollector::GetCardinality() {
+  uint64_t cardinality = hll_.EstimateCardinality();
+  size_t sampled_count = total_count_ - null_count_;
+  if (sample_ratio_ >= 1 || sampled_count == 0) {
+    return cardinality;
+  }
+
+  // A column whose values repeat within the sample likely had all of them
+  // sampled, while the distinct values of a column that is unique within the
+  // sample grow with the table. Scale between the two by how unique the
+  // sample is.
+  double uniqueness =
+      std::min(static_cast<double>(cardinality) / sampled_count, 1.0);
+  double estimate = cardinality * (1 + (1 / sample_ratio_ - 1) * uniqueness);
+  return static_cast<uint64_t>(
+      std::min(estimate, sampled_count / sample_ratio_));
+}
+
 }  // namespace optimizer
 }  // namespace peloton
@@ -14,10 +14,13 @@
 
 #include "catalog/catalog.h"
 #include "catalog/column_stats_catalog.h"
+#include "common/exception.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "optimizer/stats/column_stats.h"
 #include "optimizer/stats/table_stats.h"
+#include "settings/settings_manager.h"
 #include "storage/storage_manager.h"
+#include "threadpool/mono_queue_pool.h"
 #include "type/ephemeral_pool.h"
 
 namespace peloton {
@@ -324,6 +327,59 @@ ResultType StatsStorage::AnalyzeStatsForTable(
   return ResultType::SUCCESS;
 }
 
+/**
+ * RecordTableModifications - Count the tuples of a table modified by a
+ * committed transaction, while auto_analyze is on. Once more than
+ * auto_analyze_threshold tuples plus auto_analyze_scale_factor of the table
+ * are modified since its stats were collected, they are collected again on
+ * the worker pool.
+ */
+void StatsStorage::RecordTableModifications(storage::DataTable *table,
+                                            size_t modified_count) {
+  if (table->GetDatabaseOid() == CATALOG_DATABASE_OID) {
+    return;
+  }
+  size_t total_modified = table->IncreaseModifiedTupleCount(modified_count);
+
+  double threshold =
+      settings::SettingsManager::GetInt(
+          settings::SettingId::auto_analyze_threshold) +
+      settings::SettingsManager::GetDouble(
+          settings::SettingId::auto_analyze_scale_factor) *
+          table->GetTupleCount();
+  if (total_modified < threshold) {
+    return;
+  }
+
+  // Only the transaction that claims the modifications schedules the analysis.
+  // Anyone else hands back what was counted after they were claimed.
+  size_t claimed_count = table->ResetModifiedTupleCount();
+  if (claimed_count < threshold) {
+    table->IncreaseModifiedTupleCount(claimed_count);
+    return;
+  }
+
+  LOG_DEBUG("Scheduling analysis of table: %s", table->GetName().c_str());
+  oid_t database_oid = table->GetDatabaseOid();
+  oid_t table_oid = table->GetOid();
+  // The analysis runs in its own pool, not on the workers running queries
+  auto &pool = threadpool::MonoQueuePool::GetAnalyzeInstance();
+  pool.SubmitTask([database_oid, table_oid] {
+    storage::DataTable *table;
+    try {
+      table = storage::StorageManager::GetInstance()->GetTableWithOid(
+          database_oid, table_oid);
+    } catch (CatalogException &e) {
+      // The table was dropped in the meantime
+      return;
+    }
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    GetInstance()->AnalyzeStatsForTable(table, txn);
+    txn_manager.CommitTransaction(txn);
+  });
+}
+
 // TODO: Implement it.
 ResultType StatsStorage::AnalayzeStatsForColumns(
     UNUSED_ATTRIBUTE storage::DataTable *table,
@@ -12,9 +12,15 @@
 
 #include "optimizer/stats/table_stats_collector.h"
 
+#include <algorithm>
 #include <memory>
+#include <random>
+#include <thread>
 
 #include "common/macros.h"
+#include "settings/settings_manager.h"
+#include "storage/layout.h"
+#include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
 #include "common/internal_types.h"
@@ -27,6 +33,7 @@ TableStatsCollector::TableStatsCollector(storage::DataTable *table)
     : table_(table),
       column_stats_collectors_{},
       active_tuple_count_{0},
+      sampled_tuple_count_{0},
       column_count_{0} {}
 
 TableStatsCollector::~TableStatsCollector() {}
@@ -40,45 +47,178 @@ void TableStatsCollector::CollectColumnStats() {
     return;
   }
 
-  InitColumnStatsCollectors();
+  // The stats collected now cover every modification made so far
+  table_->ResetModifiedTupleCount();
 
-  size_t tile_group_count = table_->GetTileGroupCount();
-  // Collect stats for all tile groups.
-  for (size_t offset = 0; offset < tile_group_count; offset++) {
-    std::shared_ptr<storage::TileGroup> tile_group =
-        table_->GetTileGroup(offset);
-    storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
-    oid_t tuple_count = tile_group->GetAllocatedTupleCount();
-    active_tuple_count_ += tile_group_header->GetActiveTupleCount();
-    // Collect stats for all tuples in the tile group.
-    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
-      txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
-      if (tuple_txn_id != INVALID_TXN_ID) {
-        // Collect stats for all columns.
-        for (oid_t column_id = 0; column_id < column_count_; column_id++) {
-          type::Value value = tile_group->GetValue(tuple_id, column_id);
-          column_stats_collectors_[column_id]->AddValue(value);
-        } /* column */
+  InitColumnStatsCollectors(column_stats_collectors_);
+
+  std::vector<oid_t> tile_group_offsets = SampleTileGroups();
+
+  // The tile groups are spread over the threads, each collecting into its
+  // own column stats collectors
+  size_t thread_count = std::min<size_t>(
+      settings::SettingsManager::GetInt(
+          settings::SettingId::analyze_num_threads),
+      tile_group_offsets.size());
+  if (thread_count <= 1) {
+    CollectTileGroupStats(tile_group_offsets, 0, 1, column_stats_collectors_);
+  } else {
+    std::vector<ColumnStatsCollectors> thread_collectors(thread_count);
+    for (auto &collectors : thread_collectors) {
+      InitColumnStatsCollectors(collectors);
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t thread_id = 0; thread_id < thread_count; ++thread_id) {
+      threads.emplace_back([&, thread_id] {
+        CollectTileGroupStats(tile_group_offsets, thread_id, thread_count,
+                              thread_collectors[thread_id]);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    // Merge the stats of all threads
+    for (const auto &collectors : thread_collectors) {
+      for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+        column_stats_collectors_[column_id]->Merge(*collectors[column_id]);
       }
-    } /* tuple */
-  }   /* tile group */
+    }
+  }
+
+  // Scale the stats of a sample up to the whole table
+  if (sampled_tuple_count_ < active_tuple_count_) {
+    double sample_ratio =
+        static_cast<double>(sampled_tuple_count_) / active_tuple_count_;
+    for (auto &collector : column_stats_collectors_) {
+      collector->SetSampleRatio(sample_ratio);
+    }
+  }
 }
 
-void TableStatsCollector::InitColumnStatsCollectors() {
+void TableStatsCollector::InitColumnStatsCollectors(
+    ColumnStatsCollectors &collectors) {
   oid_t database_id = table_->GetDatabaseOid();
   oid_t table_id = table_->GetOid();
   for (oid_t column_id = 0; column_id < column_count_; column_id++) {
     std::unique_ptr<ColumnStatsCollector> colstats(new ColumnStatsCollector(
         database_id, table_id, column_id, schema_->GetType(column_id),
         table_->GetName()+"."+schema_->GetColumn(column_id).GetName()));
-    column_stats_collectors_.push_back(std::move(colstats));
+    collectors.push_back(std::move(colstats));
   }
 
   // Set indexes in the column stats collectors.
   for (auto &column_set : table_->GetIndexColumns()) {
     auto column_id = *(column_set.begin());
-    column_stats_collectors_[column_id]->SetColumnIndexed();
+    collectors[column_id]->SetColumnIndexed();
+  }
+}
+
+std::vector<oid_t> TableStatsCollector::SampleTileGroups() {
+  size_t tile_group_count = table_->GetTileGroupCount();
+  std::vector<size_t> tuple_counts(tile_group_count);
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    auto tile_group = table_->GetTileGroup(offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    tuple_counts[offset] = CountCollectedTuples(*tile_group);
+    active_tuple_count_ += tuple_counts[offset];
+  }
+
+  std::vector<oid_t> tile_group_offsets(tile_group_count);
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    tile_group_offsets[offset] = offset;
   }
+
+  // Small tables are read in full
+  size_t sample_size = settings::SettingsManager::GetInt(
+      settings::SettingId::analyze_sample_size);
+  if (active_tuple_count_ <= sample_size) {
+    sampled_tuple_count_ = active_tuple_count_;
+    return tile_group_offsets;
+  }
+
+  // Otherwise whole tile groups are drawn at random until they hold enough
+  // tuples. Reading them in full is much cheaper than reading the same number
+  // of tuples scattered over the table.
+  std::mt19937 generator{std::random_device{}()};
+  size_t sampled_count = 0;
+  while (sampled_tuple_count_ < sample_size) {
+    std::uniform_int_distribution<size_t> distribution{sampled_count,
+                                                       tile_group_count - 1};
+    std::swap(tile_group_offsets[sampled_count],
+              tile_group_offsets[distribution(generator)]);
+    sampled_tuple_count_ += tuple_counts[tile_group_offsets[sampled_count]];
+    sampled_count++;
+  }
+  tile_group_offsets.resize(sampled_count);
+
+  // Visit the sampled tile groups in the order they were created
+  std::sort(tile_group_offsets.begin(), tile_group_offsets.end());
+  return tile_group_offsets;
+}
+
+bool TableStatsCollector::IsCollected(
+    storage::TileGroupHeader *tile_group_header, oid_t tuple_id) {
+  return tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID;
+}
+
+size_t TableStatsCollector::CountCollectedTuples(
+    const storage::TileGroup &tile_group) {
+  storage::TileGroupHeader *tile_group_header = tile_group.GetHeader();
+  oid_t tuple_count = tile_group.GetAllocatedTupleCount();
+  size_t collected_count = 0;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (IsCollected(tile_group_header, tuple_id)) {
+      collected_count++;
+    }
+  }
+  return collected_count;
+}
+
+void TableStatsCollector::CollectTileGroupStats(
+    const std::vector<oid_t> &tile_group_offsets, size_t thread_id,
+    size_t thread_count, ColumnStatsCollectors &collectors) {
+  std::vector<storage::Tile *> tiles(column_count_);
+  std::vector<size_t> column_offsets(column_count_);
+  std::vector<bool> column_inlined(column_count_);
+
+  for (size_t itr = thread_id; itr < tile_group_offsets.size();
+       itr += thread_count) {
+    std::shared_ptr<storage::TileGroup> tile_group =
+        table_->GetTileGroup(tile_group_offsets[itr]);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
+    oid_t tuple_count = tile_group->GetAllocatedTupleCount();
+
+    // Locate every column once, so values are read straight from the tiles
+    const storage::Layout &layout = tile_group->GetLayout();
+    for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+      oid_t tile_offset, tile_column_id;
+      layout.LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+      tiles[column_id] = tile_group->GetTile(tile_offset);
+      const catalog::Schema *tile_schema = tiles[column_id]->GetSchema();
+      column_offsets[column_id] = tile_schema->GetOffset(tile_column_id);
+      column_inlined[column_id] = tile_schema->IsInlined(tile_column_id);
+    }
+
+    // Collect stats for all tuples in the tile group.
+    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+      if (IsCollected(tile_group_header, tuple_id)) {
+        // Collect stats for all columns.
+        for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+          type::Value value = tiles[column_id]->GetValueFast(
+              tuple_id, column_offsets[column_id], schema_->GetType(column_id),
+              column_inlined[column_id]);
+          collectors[column_id]->AddValue(value);
+        } /* column */
+      }
+    } /* tuple */
+  }   /* tile group */
 }
 
 ColumnStatsCollector *TableStatsCollector::GetColumnStats(oid_t column_id) {
@@ -33,7 +33,8 @@ HashJoinPlan::HashJoinPlan(JoinType join_type, ExpressionPtr &&predicate,
                        proj_schema),
       left_hash_keys_(std::move(left_hash_keys)),
       right_hash_keys_(std::move(right_hash_keys)),
-      build_bloomfilter_(build_bloomfilter) {}
+      build_bloomfilter_(build_bloomfilter),
+      radix_partition_bits_(0) {}
 
 void HashJoinPlan::GetLeftHashKeys(
     std::vector<const expression::AbstractExpression *> &keys) const {
@@ -81,6 +82,7 @@ std::unique_ptr<AbstractPlan> HashJoinPlan::Copy() const {
       new HashJoinPlan(GetJoinType(), std::move(predicate_copy),
                        GetProjInfo()->Copy(), schema_copy, left_hash_keys_copy,
                        right_hash_keys_copy, build_bloomfilter_);
+  new_plan->SetRadixPartitionBits(radix_partition_bits_);
   return std::unique_ptr<AbstractPlan>(new_plan);
 }
 
@@ -99,6 +101,8 @@ hash_t HashJoinPlan::Hash() const {
     hash = HashUtil::CombineHashes(hash, keys[i]->Hash());
   }
 
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&radix_partition_bits_));
+
   return HashUtil::CombineHashes(hash, AbstractPlan::Hash());
 }
 
@@ -142,6 +146,10 @@ bool HashJoinPlan::operator==(const AbstractPlan &rhs) const {
     }
   }
 
+  if (GetRadixPartitionBits() != other.GetRadixPartitionBits()) {
+    return false;
+  }
+
   return AbstractPlan::operator==(rhs);
 }
 
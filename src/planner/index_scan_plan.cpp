@@ -94,5 +94,102 @@ void IndexScanPlan::SetParameterValues(std::vector<type::Value> *values) {
   }
 }
 
+hash_t IndexScanPlan::Hash() const {
+  auto type = GetPlanNodeType();
+  hash_t hash = HashUtil::Hash(&type);
+
+  hash = HashUtil::CombineHashes(hash, GetTable()->Hash());
+  if (GetPredicate() != nullptr) {
+    hash = HashUtil::CombineHashes(hash, GetPredicate()->Hash());
+  }
+
+  for (auto &column_id : GetColumnIds()) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&column_id));
+  }
+
+  // The key values are left out on purpose. They come from the predicate, so
+  // plans that only differ in them share the same compiled query.
+  auto index_id = GetIndexId();
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&index_id));
+  for (auto &key_column_id : GetKeyColumnIds()) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&key_column_id));
+  }
+  for (auto &expr_type : GetExprTypes()) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&expr_type));
+  }
+
+  auto is_update = IsForUpdate();
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&is_update));
+
+  auto limit = GetLimit();
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&limit));
+  if (limit) {
+    auto limit_number = GetLimitNumber();
+    auto limit_offset = GetLimitOffset();
+    auto descend = GetDescend();
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&limit_number));
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&limit_offset));
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&descend));
+  }
+
+  return HashUtil::CombineHashes(hash, AbstractPlan::Hash());
+}
+
+bool IndexScanPlan::operator==(const AbstractPlan &rhs) const {
+  if (GetPlanNodeType() != rhs.GetPlanNodeType())
+    return false;
+
+  auto &other = static_cast<const planner::IndexScanPlan &>(rhs);
+  auto *table = GetTable();
+  auto *other_table = other.GetTable();
+  PELOTON_ASSERT(table && other_table);
+  if (*table != *other_table)
+    return false;
+
+  // Predicate
+  auto *pred = GetPredicate();
+  auto *other_pred = other.GetPredicate();
+  if ((pred == nullptr && other_pred != nullptr) ||
+      (pred != nullptr && other_pred == nullptr))
+    return false;
+  if (pred && *pred != *other_pred)
+    return false;
+
+  // Column Ids
+  if (GetColumnIds() != other.GetColumnIds())
+    return false;
+
+  // Index and key conditions
+  if (GetIndexId() != other.GetIndexId() ||
+      GetKeyColumnIds() != other.GetKeyColumnIds() ||
+      GetExprTypes() != other.GetExprTypes())
+    return false;
+
+  if (IsForUpdate() != other.IsForUpdate())
+    return false;
+
+  // Limit
+  if (GetLimit() != other.GetLimit())
+    return false;
+  if (GetLimit() && (GetLimitNumber() != other.GetLimitNumber() ||
+                     GetLimitOffset() != other.GetLimitOffset() ||
+                     GetDescend() != other.GetDescend()))
+    return false;
+
+  return AbstractPlan::operator==(rhs);
+}
+
+void IndexScanPlan::VisitParameters(
+    codegen::QueryParametersMap &map, std::vector<peloton::type::Value> &values,
+    const std::vector<peloton::type::Value> &values_from_user) {
+  AbstractPlan::VisitParameters(map, values, values_from_user);
+
+  auto *predicate =
+      const_cast<expression::AbstractExpression *>(GetPredicate());
+  if (predicate != nullptr) {
+    predicate->VisitParameters(map, values, values_from_user);
+  }
+}
+
 }  // namespace planner
 }  // namespace peloton
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_plan.cpp
+//
+// Identification: src/planner/merge_join_plan.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "planner/merge_join_plan.h"
+
+namespace peloton {
+namespace planner {
+
+hash_t MergeJoinPlan::Hash() const {
+  hash_t hash = AbstractJoinPlan::Hash();
+
+  for (const auto &join_clause : join_clauses_) {
+    hash = HashUtil::CombineHashes(hash, join_clause.left_->Hash());
+    hash = HashUtil::CombineHashes(hash, join_clause.right_->Hash());
+    hash = HashUtil::CombineHashes(hash,
+                                   HashUtil::Hash(&join_clause.reversed_));
+  }
+
+  return HashUtil::CombineHashes(hash, AbstractPlan::Hash());
+}
+
+bool MergeJoinPlan::operator==(const AbstractPlan &rhs) const {
+  if (!AbstractJoinPlan::operator==(rhs)) {
+    return false;
+  }
+
+  const auto &other = static_cast<const MergeJoinPlan &>(rhs);
+
+  // Join clauses
+  const auto &other_clauses = *other.GetJoinClauses();
+  if (join_clauses_.size() != other_clauses.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < join_clauses_.size(); i++) {
+    const auto &clause = join_clauses_[i];
+    const auto &other_clause = other_clauses[i];
+    if (*clause.left_ != *other_clause.left_ ||
+        *clause.right_ != *other_clause.right_ ||
+        clause.reversed_ != other_clause.reversed_) {
+      return false;
+    }
+  }
+
+  return AbstractPlan::operator==(rhs);
+}
+
+}  // namespace planner
+}  // namespace peloton
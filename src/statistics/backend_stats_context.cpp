@@ -239,6 +239,8 @@ void BackendStatsContext::Aggregate(BackendStatsContext &source) {
   // Aggregate all global metrics
   txn_latencies_.Aggregate(source.txn_latencies_);
   txn_latencies_.ComputeLatencies();
+  compilation_metric_.Aggregate(source.compilation_metric_);
+  gc_metric_.Aggregate(source.gc_metric_);
 
   // Aggregate all per-database metrics
   for (auto &database_item : source.database_metrics_) {
@@ -273,6 +275,8 @@ void BackendStatsContext::Aggregate(BackendStatsContext &source) {
 
 void BackendStatsContext::Reset() {
   txn_latencies_.Reset();
+  compilation_metric_.Reset();
+  gc_metric_.Reset();
 
   for (auto &database_item : database_metrics_) {
     database_item.second->Reset();
@@ -334,6 +338,8 @@ std::string BackendStatsContext::ToString() const {
   std::stringstream ss;
 
   ss << txn_latencies_.GetInfo() << std::endl;
+  ss << compilation_metric_.GetInfo() << std::endl;
+  ss << gc_metric_.GetInfo() << std::endl;
 
   for (auto &database_item : database_metrics_) {
     oid_t database_id = database_item.second->GetDatabaseId();
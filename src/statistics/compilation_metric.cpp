@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compilation_metric.cpp
+//
+// Identification: src/statistics/compilation_metric.cpp
+//
+// Copyright (c) 2015-18, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "util/string_util.h"
+#include "statistics/compilation_metric.h"
+#include "common/macros.h"
+
+namespace peloton {
+namespace stats {
+
+CompilationMetric::CompilationMetric(MetricType type) : AbstractMetric(type) {}
+
+void CompilationMetric::Aggregate(AbstractMetric &source) {
+  PELOTON_ASSERT(source.GetType() == MetricType::COMPILATION);
+
+  auto &compilation_metric = static_cast<CompilationMetric &>(source);
+  compilations_.Aggregate(compilation_metric.GetCompilations());
+  compile_us_.Aggregate(compilation_metric.GetCompileTime());
+  recompilations_.Aggregate(compilation_metric.GetRecompilations());
+  recompile_us_.Aggregate(compilation_metric.GetRecompileTime());
+  functions_.Aggregate(compilation_metric.GetFunctions());
+  basic_blocks_.Aggregate(compilation_metric.GetBasicBlocks());
+  instructions_.Aggregate(compilation_metric.GetInstructions());
+}
+
+const std::string CompilationMetric::GetInfo() const {
+  std::stringstream ss;
+  ss << peloton::GETINFO_THICK_LINE << std::endl;
+  ss << "// QUERY COMPILATION" << std::endl;
+  ss << peloton::GETINFO_THICK_LINE << std::endl;
+  ss << "# queries compiled:   " << compilations_.GetInfo() << std::endl;
+  ss << "compile time (us):    " << compile_us_.GetInfo() << std::endl;
+  ss << "# queries optimized:  " << recompilations_.GetInfo() << std::endl;
+  ss << "optimize time (us):   " << recompile_us_.GetInfo() << std::endl;
+  ss << "# functions:          " << functions_.GetInfo() << std::endl;
+  ss << "# basic blocks:       " << basic_blocks_.GetInfo() << std::endl;
+  ss << "# instructions:       " << instructions_.GetInfo();
+  return ss.str();
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gc_metric.cpp
+//
+// Identification: src/statistics/gc_metric.cpp
+//
+// Copyright (c) 2015-18, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "util/string_util.h"
+#include "statistics/gc_metric.h"
+#include "common/macros.h"
+
+namespace peloton {
+namespace stats {
+
+GCMetric::GCMetric(MetricType type) : AbstractMetric(type) {}
+
+void GCMetric::Aggregate(AbstractMetric &source) {
+  PELOTON_ASSERT(source.GetType() == MetricType::GC);
+
+  auto &gc_metric = static_cast<GCMetric &>(source);
+  unlinked_txns_.Aggregate(gc_metric.GetUnlinkedTxns());
+  lag_epochs_.Aggregate(gc_metric.GetLagEpochs());
+  cooperative_txns_.Aggregate(gc_metric.GetCooperativeTxns());
+  version_chains_.Aggregate(gc_metric.GetVersionChains());
+  chain_versions_.Aggregate(gc_metric.GetChainVersions());
+}
+
+const std::string GCMetric::GetInfo() const {
+  auto unlinked_txns = unlinked_txns_.GetCounter();
+  auto version_chains = version_chains_.GetCounter();
+  double avg_lag =
+      unlinked_txns == 0
+          ? 0.0
+          : static_cast<double>(lag_epochs_.GetCounter()) / unlinked_txns;
+  double avg_chain_length =
+      version_chains == 0
+          ? 0.0
+          : static_cast<double>(chain_versions_.GetCounter()) / version_chains;
+
+  std::stringstream ss;
+  ss << peloton::GETINFO_THICK_LINE << std::endl;
+  ss << "// GARBAGE COLLECTION" << std::endl;
+  ss << peloton::GETINFO_THICK_LINE << std::endl;
+  ss << "# txns unlinked:       " << unlinked_txns_.GetInfo() << std::endl;
+  ss << "# txns unlinked coop:  " << cooperative_txns_.GetInfo() << std::endl;
+  ss << "avg lag (epochs):      " << avg_lag << std::endl;
+  ss << "# version chains:      " << version_chains_.GetInfo() << std::endl;
+  ss << "avg chain length:      " << avg_chain_length;
+  return ss.str();
+}
+
+}  // namespace stats
+}  // namespace peloton
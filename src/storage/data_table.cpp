@@ -36,6 +36,7 @@
 #include "storage/tile_group_factory.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 #include "tuning/clusterer.h"
 #include "tuning/sample.h"
 
@@ -64,6 +65,7 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
                      const peloton::LayoutType layout_type)
     : AbstractTable(table_oid, schema, own_schema, layout_type),
       database_oid(database_oid),
+      is_catalog_(is_catalog),
       table_name(table_name),
       tuples_per_tilegroup_(tuples_per_tilegroup),
       current_layout_oid_(ATOMIC_VAR_INIT(COLUMN_STORE_LAYOUT_OID)),
@@ -108,6 +110,9 @@ DataTable::~DataTable() {
       storage_manager->DropTileGroup(tile_group_id);
     }
   }
+  for (auto tile_group_id : dropped_tile_groups_) {
+    storage_manager->DropTileGroup(tile_group_id);
+  }
 
   // drop all indirection arrays
   for (auto indirection_array : active_indirection_arrays_) {
@@ -211,14 +216,20 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   // check if there are recycled tuple slots
   auto &gc_manager = gc::GCManagerFactory::GetInstance();
   auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
-  if (free_item_pointer.IsNull() == false) {
-    // when inserting a tuple
-    if (tuple != nullptr) {
-      auto tile_group = storage::StorageManager::GetInstance()->GetTileGroup(
-          free_item_pointer.block);
-      tile_group->CopyTuple(tuple, free_item_pointer.offset);
+  while (free_item_pointer.IsNull() == false) {
+    auto tile_group = storage::StorageManager::GetInstance()->GetTileGroup(
+        free_item_pointer.block);
+    // slots recycled before their tile group was set aside for compaction
+    // are not reused
+    if (tile_group != nullptr &&
+        tile_group->GetHeader()->GetImmutability() == false) {
+      // when inserting a tuple
+      if (tuple != nullptr) {
+        tile_group->CopyTuple(tuple, free_item_pointer.offset);
+      }
+      return free_item_pointer;
     }
-    return free_item_pointer;
+    free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
   }
   //====================================================
 
@@ -403,29 +414,7 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
                                 ItemPointer **index_entry_ptr) {
   int index_count = GetIndexCount();
 
-  size_t active_indirection_array_id =
-      number_of_tuples_ % active_indirection_array_count_;
-
-  size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
-
-  while (true) {
-    auto active_indirection_array =
-        active_indirection_arrays_[active_indirection_array_id];
-    indirection_offset = active_indirection_array->AllocateIndirection();
-
-    if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
-      *index_entry_ptr =
-          active_indirection_array->GetIndirectionByOffset(indirection_offset);
-      break;
-    }
-  }
-
-  (*index_entry_ptr)->block = location.block;
-  (*index_entry_ptr)->offset = location.offset;
-
-  if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
-    AddDefaultIndirectionArray(active_indirection_array_id);
-  }
+  *index_entry_ptr = AllocateIndirection(location);
 
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
@@ -477,6 +466,81 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
   return true;
 }
 
+/**
+ * @brief Insert tuples of a tile group into all indexes, one index at a
+ * time. Used by recovery, where the tuples are known to satisfy all the
+ * constraints, so that nothing is checked.
+ */
+void DataTable::InsertInIndexesForRecovery(
+    storage::TileGroup *tile_group, const std::vector<oid_t> &tuple_ids) {
+  if (tuple_ids.empty() == true) {
+    return;
+  }
+
+  int index_count = GetIndexCount();
+  if (index_count == 0) {
+    IncreaseTupleCount(tuple_ids.size());
+    return;
+  }
+
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+
+  std::vector<ItemPointer *> index_entry_ptrs;
+  index_entry_ptrs.reserve(tuple_ids.size());
+  for (auto tuple_id : tuple_ids) {
+    auto index_entry_ptr =
+        AllocateIndirection(ItemPointer(tile_group_id, tuple_id));
+    tile_group_header->SetIndirection(tuple_id, index_entry_ptr);
+    index_entry_ptrs.push_back(index_entry_ptr);
+  }
+
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr) continue;
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+    storage::Tuple key(index_schema, true);
+
+    for (size_t tuple_itr = 0; tuple_itr < tuple_ids.size(); ++tuple_itr) {
+      ContainerTuple<storage::TileGroup> tuple(tile_group,
+                                               tuple_ids[tuple_itr]);
+      key.SetFromTuple(&tuple, indexed_columns, index->GetPool());
+      index->InsertEntry(&key, index_entry_ptrs[tuple_itr]);
+    }
+  }
+
+  IncreaseTupleCount(tuple_ids.size());
+}
+
+ItemPointer *DataTable::AllocateIndirection(const ItemPointer &location) {
+  size_t active_indirection_array_id =
+      number_of_tuples_ % active_indirection_array_count_;
+
+  size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
+  ItemPointer *index_entry_ptr = nullptr;
+
+  while (true) {
+    auto active_indirection_array =
+        active_indirection_arrays_[active_indirection_array_id];
+    indirection_offset = active_indirection_array->AllocateIndirection();
+
+    if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
+      index_entry_ptr =
+          active_indirection_array->GetIndirectionByOffset(indirection_offset);
+      break;
+    }
+  }
+
+  index_entry_ptr->block = location.block;
+  index_entry_ptr->offset = location.offset;
+
+  if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
+    AddDefaultIndirectionArray(active_indirection_array_id);
+  }
+  return index_entry_ptr;
+}
+
 bool DataTable::InsertInSecondaryIndexes(
     const AbstractTuple *tuple, const TargetList *targets_ptr,
     concurrency::TransactionContext *transaction,
@@ -840,6 +904,32 @@ bool DataTable::IsDirty() const { return dirty_; }
  */
 void DataTable::ResetDirty() { dirty_ = false; }
 
+/**
+ * @brief Count tuples modified by a committed transaction
+ * @param amount number of modified tuples
+ * @return number of modified tuples since the last reset
+ */
+size_t DataTable::IncreaseModifiedTupleCount(const size_t &amount) {
+  return modified_tuple_count_.fetch_add(amount, std::memory_order_relaxed) +
+         amount;
+}
+
+/**
+ * @brief Get the number of tuples modified since the last reset
+ * @return number of modified tuples
+ */
+size_t DataTable::GetModifiedTupleCount() const {
+  return modified_tuple_count_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reset the number of modified tuples
+ * @return number of modified tuples before the reset
+ */
+size_t DataTable::ResetModifiedTupleCount() {
+  return modified_tuple_count_.exchange(0, std::memory_order_relaxed);
+}
+
 //===--------------------------------------------------------------------===//
 // TILE GROUP
 //===--------------------------------------------------------------------===//
@@ -988,6 +1078,25 @@ std::shared_ptr<storage::TileGroup> DataTable::GetTileGroupById(
   return storage_manager->GetTileGroup(tile_group_id);
 }
 
+bool DataTable::DropTileGroup(const oid_t &tile_group_id) {
+  auto tile_groups_size = tile_groups_.GetSize();
+  for (std::size_t tile_groups_itr = 0; tile_groups_itr < tile_groups_size;
+       tile_groups_itr++) {
+    if (tile_groups_.Find(tile_groups_itr) == tile_group_id) {
+      // the tile group count is left alone, as it's the number of offsets
+      // scans go over
+      tile_groups_.Erase(tile_groups_itr, invalid_tile_group_id);
+      {
+        std::lock_guard<std::mutex> lock(data_table_mutex_);
+        dropped_tile_groups_.push_back(tile_group_id);
+      }
+      LOG_TRACE("Dropped tile group : %u ", tile_group_id);
+      return true;
+    }
+  }
+  return false;
+}
+
 void DataTable::DropTileGroups() {
   auto storage_manager = storage::StorageManager::GetInstance();
   auto tile_groups_size = tile_groups_.GetSize();
@@ -1003,6 +1112,11 @@ void DataTable::DropTileGroups() {
     }
   }
 
+  for (auto tile_group_id : dropped_tile_groups_) {
+    storage_manager->DropTileGroup(tile_group_id);
+  }
+  dropped_tile_groups_.clear();
+
   // Clear array
   tile_groups_.Clear();
 
@@ -1196,6 +1310,9 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
   auto header = orig_tile_group->GetHeader();
   auto new_header = new_tile_group->GetHeader();
   *new_header = *header;
+
+  // The tuples were copied around the zone map, so compute it from scratch
+  new_tile_group->GetZoneMap()->Rebuild();
 }
 
 storage::TileGroup *DataTable::TransformTileGroup(
@@ -1212,6 +1329,9 @@ storage::TileGroup *DataTable::TransformTileGroup(
   // Get orig tile group from catalog
   auto storage_tilegroup = storage::StorageManager::GetInstance();
   auto tile_group = storage_tilegroup->GetTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    return nullptr;
+  }
   auto diff = tile_group->GetLayout().GetLayoutDifference(*default_layout_);
 
   // Check threshold for transformation
@@ -17,6 +17,7 @@
 #include "common/logger.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "logging/checkpoint_manager_factory.h"
 #include "storage/database.h"
 #include "storage/table_factory.h"
 
@@ -28,7 +29,9 @@ Database::Database(const oid_t database_oid) : database_oid(database_oid) {}
 Database::~Database() {
   // Clean up all the tables
   LOG_TRACE("Deleting tables from database");
+  auto &checkpoint_manager = logging::CheckpointManagerFactory::GetInstance();
   for (auto table : tables) {
+    checkpoint_manager.DeregisterTable(database_oid, table->GetOid());
     delete table;
   }
 
@@ -50,6 +53,11 @@ void Database::AddTable(storage::DataTable *table, bool is_catalog) {
       assert(gc_manager != nullptr);
       gc_manager->RegisterTable(table->GetOid());
     }
+
+    // Register table to checkpoint manager. The catalog tables are
+    // checkpointed too, as recovery rebuilds the schema from them.
+    logging::CheckpointManagerFactory::GetInstance().RegisterTable(
+        database_oid, table->GetOid());
   }
 }
 
@@ -75,6 +83,10 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     PELOTON_ASSERT(gc_manager != nullptr);
     gc_manager->DeregisterTable(table_oid);
 
+    // Deregister table from checkpoint manager.
+    logging::CheckpointManagerFactory::GetInstance().DeregisterTable(
+        database_oid, table_oid);
+
     // Deregister table from Query Cache manager
     codegen::QueryCache::Instance().Remove(table_oid);
 
@@ -0,0 +1,344 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_column.cpp
+//
+// Identification: src/storage/frozen_column.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/frozen_column.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+#include "storage/zone_map.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// The number of bits needed to store values up to the given one
+uint32_t BitWidth(uint64_t max_value) {
+  uint32_t width = 0;
+  while (width < 64 && (max_value >> width) != 0) {
+    width++;
+  }
+  return width;
+}
+
+void PackCodes(const std::vector<uint64_t> &values, uint32_t width,
+               std::vector<uint64_t> &codes) {
+  codes.assign((values.size() * width + 63) / 64, 0);
+  if (width == 0) {
+    return;
+  }
+  for (size_t i = 0; i < values.size(); i++) {
+    uint64_t bit = i * width;
+    uint32_t shift = bit % 64;
+    codes[bit / 64] |= values[i] << shift;
+    if (shift + width > 64) {
+      codes[bit / 64 + 1] |= values[i] >> (64 - shift);
+    }
+  }
+}
+
+uint64_t UnpackCode(const std::vector<uint64_t> &codes, uint32_t width,
+                    oid_t slot) {
+  if (width == 0) {
+    return 0;
+  }
+  uint64_t bit = uint64_t{slot} * width;
+  uint32_t shift = bit % 64;
+  uint64_t code = codes[bit / 64] >> shift;
+  if (shift + width > 64) {
+    code |= codes[bit / 64 + 1] << (64 - shift);
+  }
+  return width == 64 ? code : code & ((uint64_t{1} << width) - 1);
+}
+
+bool IsIntegerType(type::TypeId type) {
+  return type == type::TypeId::TINYINT || type == type::TypeId::SMALLINT ||
+         type == type::TypeId::INTEGER || type == type::TypeId::BIGINT;
+}
+
+}  // namespace
+
+FrozenColumn::FrozenColumn(type::TypeId type, size_t offset, size_t length)
+    : type_(type),
+      offset_(offset),
+      length_(length),
+      is_varlen_(type == type::TypeId::VARCHAR ||
+                 type == type::TypeId::VARBINARY),
+      is_word_(!is_varlen_ && length <= sizeof(uint64_t)),
+      encoding_(Encoding::PLAIN),
+      num_slots_(0),
+      code_width_(0),
+      base_(0),
+      has_keys_(false) {}
+
+void FrozenColumn::Encode(const char *data, size_t tuple_length,
+                          const std::vector<bool> &live) {
+  num_slots_ = static_cast<oid_t>(live.size());
+  if (is_word_) {
+    EncodeWords(data, tuple_length, live);
+  } else {
+    EncodeBytes(data, tuple_length, live);
+  }
+}
+
+void FrozenColumn::Decode(char *data, size_t tuple_length,
+                          type::AbstractPool *pool) const {
+  if (is_word_) {
+    DecodeWords(data, tuple_length);
+  } else {
+    DecodeBytes(data, tuple_length, pool);
+  }
+}
+
+void FrozenColumn::EncodeWords(const char *data, size_t tuple_length,
+                               const std::vector<bool> &live) {
+  // Integers are sign-extended, so small negative ones stay small relative to
+  // the smallest word
+  uint32_t extend = IsIntegerType(type_) ? 64 - 8 * length_ : 0;
+  std::vector<uint64_t> values(num_slots_);
+  uint64_t word = 0;
+  for (oid_t slot = 0; slot < num_slots_; slot++) {
+    if (live[slot]) {
+      word = 0;
+      std::memcpy(&word, data + slot * tuple_length + offset_, length_);
+      if (extend != 0) {
+        word = static_cast<uint64_t>(static_cast<int64_t>(word << extend) >>
+                                     extend);
+      }
+    }
+    values[slot] = word;
+  }
+
+  std::vector<uint64_t> dictionary = values;
+  std::sort(dictionary.begin(), dictionary.end());
+  dictionary.erase(std::unique(dictionary.begin(), dictionary.end()),
+                   dictionary.end());
+
+  size_t num_runs = values.empty() ? 0 : 1;
+  for (oid_t slot = 1; slot < num_slots_; slot++) {
+    num_runs += (values[slot] != values[slot - 1]);
+  }
+
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  for (uint64_t value : values) {
+    min = std::min(min, static_cast<int64_t>(value));
+    max = std::max(max, static_cast<int64_t>(value));
+  }
+
+  // Pick the encoding needing the fewest bits
+  uint32_t dictionary_width =
+      BitWidth(dictionary.empty() ? 0 : dictionary.size() - 1);
+  uint32_t packed_width =
+      values.empty() ? 0 : BitWidth(static_cast<uint64_t>(max) -
+                                    static_cast<uint64_t>(min));
+  size_t dictionary_bits =
+      dictionary.size() * 64 + size_t{num_slots_} * dictionary_width;
+  size_t run_length_bits = num_runs * (64 + 8 * sizeof(oid_t));
+  size_t packed_bits = 64 + size_t{num_slots_} * packed_width;
+
+  if (dictionary_bits <= run_length_bits && dictionary_bits < packed_bits) {
+    encoding_ = Encoding::DICTIONARY;
+    code_width_ = dictionary_width;
+    std::vector<uint64_t> indexes(num_slots_);
+    for (oid_t slot = 0; slot < num_slots_; slot++) {
+      indexes[slot] = std::lower_bound(dictionary.begin(), dictionary.end(),
+                                       values[slot]) -
+                      dictionary.begin();
+    }
+    PackCodes(indexes, code_width_, codes_);
+    words_ = std::move(dictionary);
+  } else if (run_length_bits < packed_bits) {
+    encoding_ = Encoding::RUN_LENGTH;
+    for (oid_t slot = 0; slot < num_slots_; slot++) {
+      if (slot == 0 || values[slot] != values[slot - 1]) {
+        words_.push_back(values[slot]);
+        run_ends_.push_back(slot + 1);
+      } else {
+        run_ends_.back() = slot + 1;
+      }
+    }
+    dictionary.clear();
+  } else {
+    encoding_ = Encoding::BIT_PACKED;
+    code_width_ = packed_width;
+    base_ = static_cast<uint64_t>(min);
+    for (auto &value : values) {
+      value -= base_;
+    }
+    PackCodes(values, code_width_, codes_);
+    return;
+  }
+
+  // Few distinct values, remember their keys to check predicates exactly
+  if (ZoneMap::IsTrackedType(type_)) {
+    has_keys_ = true;
+    for (uint64_t value : words_) {
+      int64_t key;
+      if (ZoneMap::EncodeKey(type_, reinterpret_cast<const char *>(&value),
+                             key)) {
+        keys_.push_back(key);
+      }
+    }
+    std::sort(keys_.begin(), keys_.end());
+    keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+  }
+}
+
+void FrozenColumn::DecodeWords(char *data, size_t tuple_length) const {
+  switch (encoding_) {
+    case Encoding::DICTIONARY: {
+      for (oid_t slot = 0; slot < num_slots_; slot++) {
+        uint64_t word = words_[UnpackCode(codes_, code_width_, slot)];
+        std::memcpy(data + slot * tuple_length + offset_, &word, length_);
+      }
+      break;
+    }
+    case Encoding::RUN_LENGTH: {
+      oid_t slot = 0;
+      for (size_t run = 0; run < words_.size(); run++) {
+        for (; slot < run_ends_[run]; slot++) {
+          std::memcpy(data + slot * tuple_length + offset_, &words_[run],
+                      length_);
+        }
+      }
+      break;
+    }
+    default: {
+      for (oid_t slot = 0; slot < num_slots_; slot++) {
+        uint64_t word = base_ + UnpackCode(codes_, code_width_, slot);
+        std::memcpy(data + slot * tuple_length + offset_, &word, length_);
+      }
+      break;
+    }
+  }
+}
+
+void FrozenColumn::EncodeBytes(const char *data, size_t tuple_length,
+                               const std::vector<bool> &live) {
+  // A varlen value is stored as its length followed by its bytes, and the
+  // tuple holds a pointer to it
+  std::vector<std::string> values(num_slots_);
+  std::vector<bool> nulls(num_slots_, false);
+  bool has_nulls = false;
+  for (oid_t slot = 0; slot < num_slots_; slot++) {
+    if (!live[slot]) {
+      if (slot > 0) {
+        values[slot] = values[slot - 1];
+        nulls[slot] = nulls[slot - 1];
+      } else if (is_varlen_) {
+        nulls[slot] = has_nulls = true;
+      } else {
+        values[slot].assign(length_, '\0');
+      }
+      continue;
+    }
+    const char *field = data + slot * tuple_length + offset_;
+    if (!is_varlen_) {
+      values[slot].assign(field, length_);
+      continue;
+    }
+    const char *varlen = *reinterpret_cast<const char *const *>(field);
+    if (varlen == nullptr) {
+      nulls[slot] = has_nulls = true;
+    } else {
+      uint32_t len;
+      std::memcpy(&len, varlen, sizeof(len));
+      values[slot].assign(varlen, sizeof(len) + len);
+    }
+  }
+  if (has_nulls) {
+    nulls_ = std::move(nulls);
+  }
+
+  std::unordered_map<std::string, uint64_t> dictionary;
+  for (const auto &value : values) {
+    dictionary.emplace(value, dictionary.size());
+  }
+
+  if (!dictionary.empty() && dictionary.size() * 2 <= num_slots_) {
+    encoding_ = Encoding::DICTIONARY;
+    code_width_ = BitWidth(dictionary.size() - 1);
+    strings_.resize(dictionary.size());
+    for (auto &entry : dictionary) {
+      strings_[entry.second] = entry.first;
+    }
+    std::vector<uint64_t> indexes(num_slots_);
+    for (oid_t slot = 0; slot < num_slots_; slot++) {
+      indexes[slot] = dictionary[values[slot]];
+    }
+    PackCodes(indexes, code_width_, codes_);
+  } else {
+    encoding_ = Encoding::PLAIN;
+    heap_offsets_.reserve(num_slots_ + 1);
+    for (const auto &value : values) {
+      heap_offsets_.push_back(static_cast<uint32_t>(heap_.size()));
+      heap_ += value;
+    }
+    heap_offsets_.push_back(static_cast<uint32_t>(heap_.size()));
+  }
+}
+
+void FrozenColumn::DecodeBytes(char *data, size_t tuple_length,
+                               type::AbstractPool *pool) const {
+  for (oid_t slot = 0; slot < num_slots_; slot++) {
+    char *field = data + slot * tuple_length + offset_;
+    if (!nulls_.empty() && nulls_[slot]) {
+      *reinterpret_cast<char **>(field) = nullptr;
+      continue;
+    }
+
+    const char *value;
+    size_t size;
+    if (encoding_ == Encoding::DICTIONARY) {
+      const auto &entry = strings_[UnpackCode(codes_, code_width_, slot)];
+      value = entry.data();
+      size = entry.size();
+    } else {
+      value = heap_.data() + heap_offsets_[slot];
+      size = heap_offsets_[slot + 1] - heap_offsets_[slot];
+    }
+
+    if (!is_varlen_) {
+      std::memcpy(field, value, length_);
+    } else {
+      auto *varlen = reinterpret_cast<char *>(pool->Allocate(size));
+      std::memcpy(varlen, value, size);
+      *reinterpret_cast<char **>(field) = varlen;
+    }
+  }
+}
+
+bool FrozenColumn::MayMatch(const PredicateRange &predicate) const {
+  if (!has_keys_) {
+    return true;
+  }
+  auto iter = std::lower_bound(keys_.begin(), keys_.end(), predicate.low);
+  return iter != keys_.end() && *iter <= predicate.high;
+}
+
+size_t FrozenColumn::GetSize() const {
+  size_t size = (codes_.size() + words_.size()) * sizeof(uint64_t) +
+                run_ends_.size() * sizeof(oid_t) + heap_.size() +
+                heap_offsets_.size() * sizeof(uint32_t) + nulls_.size() / 8 +
+                keys_.size() * sizeof(int64_t);
+  for (const auto &entry : strings_) {
+    size += entry.size();
+  }
+  return size;
+}
+
+}  // namespace storage
+}  // namespace peloton
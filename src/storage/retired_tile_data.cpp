@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// retired_tile_data.cpp
+//
+// Identification: src/storage/retired_tile_data.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/retired_tile_data.h"
+
+#include "type/abstract_pool.h"
+
+namespace peloton {
+namespace storage {
+
+void RetiredTileDataList::Retire(const std::vector<RetiredTileData> &released,
+                                 eid_t epoch_id) {
+  for (const auto &tile_data : released) {
+    retired_.emplace_back(epoch_id, tile_data);
+  }
+}
+
+void RetiredTileDataList::Free(eid_t expired_epoch_id) {
+  size_t kept = 0;
+  for (auto &entry : retired_) {
+    if (entry.first > expired_epoch_id) {
+      retired_[kept++] = entry;
+      continue;
+    }
+    delete[] entry.second.data;
+    delete entry.second.pool;
+  }
+  retired_.resize(kept);
+}
+
+}  // namespace storage
+}  // namespace peloton
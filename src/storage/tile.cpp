@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
 #include <sstream>
 
@@ -21,7 +22,9 @@
 #include "type/ephemeral_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/backend_manager.h"
+#include "storage/frozen_column.h"
 #include "storage/tile.h"
+#include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
 #include "storage/tuple_iterator.h"
@@ -38,7 +41,7 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
       tile_id(INVALID_OID),
       backend_type(backend_type),
       schema(tuple_schema),
-      data(NULL),
+      data(nullptr),
       tile_group(tile_group),
       pool(NULL),
       num_tuple_slots(tuple_count),
@@ -47,7 +50,8 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
       uninlined_data_size(0),
       column_header(NULL),
       column_header_size(INVALID_OID),
-      tile_group_header(tile_header) {
+      tile_group_header(tile_header),
+      frozen(false) {
   PELOTON_ASSERT(tuple_count > 0);
 
   tile_size = tuple_count * tuple_length;
@@ -61,7 +65,7 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   PELOTON_ASSERT(data != NULL);
 
   // zero out the data
-  PELOTON_MEMSET(data, 0, tile_size);
+  PELOTON_MEMSET(data.load(), 0, tile_size);
 
   // allocate pool for blob storage if schema not inlined
   // if (schema.IsInlined() == false) {
@@ -74,8 +78,8 @@ Tile::~Tile() {
   // auto &storage_manager = storage::StorageManager::GetInstance();
   // storage_manager.Release(backend_type, data);
 
-  delete[] data;
-  data = NULL;
+  delete[] data.load();
+  data = nullptr;
 
   // reclaim the tile memory (UNINLINED data)
   // if (schema.IsInlined() == false) {
@@ -100,7 +104,7 @@ void Tile::InsertTuple(const oid_t tuple_offset, Tuple *tuple) {
   PELOTON_ASSERT(tuple_offset < GetAllocatedTupleCount());
 
   // Find slot location
-  char *location = tuple_offset * tuple_length + data;
+  char *location = GetTupleLocation(tuple_offset);
 
   // Copy over the tuple data into the tuple slot in the tile
   PELOTON_MEMCPY(location, tuple->tuple_data_, tuple_length);
@@ -197,8 +201,8 @@ Tile *Tile::CopyTile(BackendType backend_type) {
       backend_type, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
       new_header, *schema, tile_group, allocated_tuple_count);
 
-  PELOTON_MEMCPY(static_cast<void *>(new_tile->data), static_cast<void *>(data),
-            tile_size);
+  PELOTON_MEMCPY(static_cast<void *>(new_tile->GetTupleLocation(0)),
+                 static_cast<void *>(GetTupleLocation(0)), tile_size);
 
   // Do a deep copy if some column is uninlined, so that
   // the values in that column point to the new pool
@@ -484,6 +488,77 @@ void Tile::Sync() {
   // storage_manager.Sync(backend_type, data, tile_size);
 }
 
+//===--------------------------------------------------------------------===//
+// Freezing
+//===--------------------------------------------------------------------===//
+
+bool Tile::Freeze() {
+  std::lock_guard<std::mutex> lock(freeze_mutex);
+  if (frozen.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  // Slots the GC reclaimed may point to freed varlen values, skip them
+  std::vector<bool> live(num_tuple_slots, false);
+  oid_t next_tuple_slot =
+      std::min(tile_group_header->GetCurrentNextTupleSlot(), num_tuple_slots);
+  for (oid_t tuple_slot = 0; tuple_slot < next_tuple_slot; tuple_slot++) {
+    live[tuple_slot] =
+        tile_group_header->GetTransactionId(tuple_slot) != INVALID_TXN_ID;
+  }
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    std::unique_ptr<FrozenColumn> column{
+        new FrozenColumn(schema.GetType(column_itr),
+                         schema.GetOffset(column_itr),
+                         schema.GetLength(column_itr))};
+    column->Encode(data.load(std::memory_order_relaxed), tuple_length, live);
+    frozen_columns.push_back(std::move(column));
+  }
+
+  frozen.store(true, std::memory_order_release);
+  return true;
+}
+
+void Tile::ReleaseTupleData(std::vector<RetiredTileData> &retired) {
+  std::lock_guard<std::mutex> lock(freeze_mutex);
+  PELOTON_ASSERT(frozen.load(std::memory_order_relaxed));
+  char *tile_data = data.load(std::memory_order_relaxed);
+  if (tile_data != nullptr) {
+    retired.push_back(RetiredTileData{tile_data, pool});
+    data.store(nullptr, std::memory_order_relaxed);
+    pool = nullptr;
+  }
+}
+
+char *Tile::Thaw() const {
+  std::lock_guard<std::mutex> lock(freeze_mutex);
+
+  // Keep the decompressed tuples for as long as they're read
+  if (tile_group != nullptr) {
+    tile_group->MarkAccessed();
+  }
+
+  // Another reader may have decompressed the tuples already
+  char *tile_data = data.load(std::memory_order_relaxed);
+  if (tile_data != nullptr) {
+    return tile_data;
+  }
+
+  tile_data = new char[tile_size];
+  PELOTON_MEMSET(tile_data, 0, tile_size);
+  auto *tile_pool = new type::EphemeralPool();
+  for (const auto &column : frozen_columns) {
+    column->Decode(tile_data, tuple_length, tile_pool);
+  }
+
+  // Readers check data without the mutex, the decompressed tuples must be
+  // visible to them before it is
+  pool = tile_pool;
+  data.store(tile_data, std::memory_order_release);
+  return tile_data;
+}
+
 //===--------------------------------------------------------------------===//
 // Utilities
 //===--------------------------------------------------------------------===//
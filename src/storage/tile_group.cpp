@@ -20,10 +20,12 @@
 #include "common/logger.h"
 #include "common/platform.h"
 #include "storage/abstract_table.h"
+#include "storage/frozen_column.h"
 #include "storage/layout.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 #include "util/stringbox_util.h"
 
 namespace peloton {
@@ -40,7 +42,9 @@ TileGroup::TileGroup(BackendType backend_type,
       tile_group_header(tile_group_header),
       table(table),
       num_tuple_slots_(tuple_count),
-      tile_group_layout_(layout) {
+      tile_group_layout_(layout),
+      frozen_(false),
+      accessed_(false) {
   tile_count_ = schemas.size();
   for (oid_t tile_itr = 0; tile_itr < tile_count_; tile_itr++) {
     StorageManager *storage_manager = storage::StorageManager::GetInstance();
@@ -53,6 +57,8 @@ TileGroup::TileGroup(BackendType backend_type,
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
   }
+
+  zone_map_.reset(new ZoneMap(*this));
 }
 
 TileGroup::~TileGroup() {
@@ -125,6 +131,8 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
       column_itr++;
     }
   }
+
+  zone_map_->Update(tuple_slot_id);
 }
 
 /**
@@ -206,6 +214,7 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
       column_itr++;
     }
   }
+  zone_map_->Update(tuple_slot_id);
 
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
@@ -305,6 +314,7 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
       column_itr++;
     }
   }
+  zone_map_->Update(tuple_slot_id);
 
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
@@ -315,6 +325,44 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
   return tuple_slot_id;
 }
 
+oid_t TileGroup::InvalidateTupleFromRecovery(cid_t commit_id,
+                                             oid_t tuple_slot_id,
+                                             ItemPointer new_location) {
+  if (tuple_slot_id >= num_tuple_slots_) return INVALID_OID;
+
+  tile_group_header->GetHeaderLock().Lock();
+
+  // the slot is empty, or it has been reused by a later transaction.
+  cid_t current_begin_cid = tile_group_header->GetBeginCommitId(tuple_slot_id);
+  if (current_begin_cid == MAX_CID || current_begin_cid > commit_id) {
+    tile_group_header->GetHeaderLock().Unlock();
+    return INVALID_OID;
+  }
+
+  // Set MVCC info
+  tile_group_header->SetEndCommitId(tuple_slot_id, commit_id);
+  tile_group_header->SetPrevItemPointer(tuple_slot_id, new_location);
+  tile_group_header->GetHeaderLock().Unlock();
+  return tuple_slot_id;
+}
+
+oid_t TileGroup::LinkTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
+                                       ItemPointer old_location) {
+  if (tuple_slot_id >= num_tuple_slots_) return INVALID_OID;
+
+  tile_group_header->GetHeaderLock().Lock();
+
+  // the slot has been reused by a later transaction.
+  if (tile_group_header->GetBeginCommitId(tuple_slot_id) != commit_id) {
+    tile_group_header->GetHeaderLock().Unlock();
+    return INVALID_OID;
+  }
+
+  tile_group_header->SetNextItemPointer(tuple_slot_id, old_location);
+  tile_group_header->GetHeaderLock().Unlock();
+  return tuple_slot_id;
+}
+
 type::Value TileGroup::GetValue(oid_t tuple_id, oid_t column_id) {
   PELOTON_ASSERT(tuple_id < GetNextTupleSlot());
   oid_t tile_column_id, tile_offset;
@@ -330,12 +378,14 @@ void TileGroup::SetValue(type::Value &value, oid_t tuple_id,
   tile_group_layout_->LocateTileAndColumn(column_id, tile_offset,
                                           tile_column_id);
   GetTile(tile_offset)->SetValue(value, tuple_id, tile_column_id);
+  zone_map_->UpdateColumn(column_id, tuple_id);
 }
 
 
 std::shared_ptr<Tile> TileGroup::GetTileReference(
     const oid_t tile_offset) const {
   PELOTON_ASSERT(tile_offset < tile_count_);
+  MarkAccessed();
   return tiles[tile_offset];
 }
 
@@ -346,6 +396,50 @@ void TileGroup::Sync() {
   }
 }
 
+//===--------------------------------------------------------------------===//
+// Freezing
+//===--------------------------------------------------------------------===//
+
+bool TileGroup::Freeze() {
+  PELOTON_ASSERT(tile_group_header->GetImmutability());
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+  if (frozen_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  // No transaction writes the tile group anymore, so its zone map can be
+  // tightened for good. Do it while the tuples are still uncompressed.
+  zone_map_->Rebuild();
+
+  for (auto &tile : tiles) {
+    tile->Freeze();
+  }
+  frozen_.store(true, std::memory_order_release);
+  return true;
+}
+
+void TileGroup::ReleaseTupleData(std::vector<RetiredTileData> &retired) {
+  PELOTON_ASSERT(IsFrozen());
+  for (auto &tile : tiles) {
+    tile->ReleaseTupleData(retired);
+  }
+}
+
+bool TileGroup::ShouldScanFrozen(const PredicateRange *predicates,
+                                 uint32_t num_predicates) const {
+  PELOTON_ASSERT(IsFrozen());
+  for (uint32_t i = 0; i < num_predicates; i++) {
+    oid_t tile_offset, tile_column_id;
+    tile_group_layout_->LocateTileAndColumn(predicates[i].col_id, tile_offset,
+                                            tile_column_id);
+    const auto &column = tiles[tile_offset]->GetFrozenColumn(tile_column_id);
+    if (!column.MayMatch(predicates[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Utilities
 //===--------------------------------------------------------------------===//
@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor.cpp
+//
+// Identification: src/storage/tile_group_compactor.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_compactor.h"
+
+#include <chrono>
+
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+TileGroupCompactor &TileGroupCompactor::GetInstance() {
+  static TileGroupCompactor compactor;
+  return compactor;
+}
+
+TileGroupCompactor::~TileGroupCompactor() { StopCompacting(); }
+
+void TileGroupCompactor::StartCompacting(int interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (is_running_) {
+    return;
+  }
+  is_running_ = true;
+  compactor_thread_ =
+      std::thread(&TileGroupCompactor::Running, this, interval);
+  LOG_INFO("Started tile group compactor");
+}
+
+void TileGroupCompactor::StopCompacting() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_running_) {
+      return;
+    }
+    is_running_ = false;
+  }
+  stop_cv_.notify_all();
+  compactor_thread_.join();
+}
+
+void TileGroupCompactor::Running(int interval) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_cv_.wait_for(lock, std::chrono::seconds(interval),
+                            [this] { return !is_running_; })) {
+    lock.unlock();
+    CompactTileGroups();
+    lock.lock();
+  }
+}
+
+void TileGroupCompactor::CompactTileGroups() {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  // The GC thread moves the expired epoch forward, it's only read here
+  retired_.Free(epoch_manager.GetLastExpiredEpochId());
+
+  // Forget the tile groups of dropped tables
+  auto *storage_manager = StorageManager::GetInstance();
+  for (auto entry = sparse_tile_groups_.begin();
+       entry != sparse_tile_groups_.end();) {
+    if (storage_manager->GetTileGroup(entry->first) == nullptr) {
+      entry = sparse_tile_groups_.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+
+  size_t dropped_count = 0;
+  oid_t database_count = storage_manager->GetDatabaseCount();
+  for (oid_t database_offset = 0; database_offset < database_count;
+       database_offset++) {
+    auto *database = storage_manager->GetDatabaseWithOffset(database_offset);
+    if (database == nullptr) {
+      continue;
+    }
+    oid_t table_count = database->GetTableCount();
+    for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
+      auto *table = database->GetTable(table_offset);
+      if (table == nullptr || table->IsCatalogTable()) {
+        continue;
+      }
+      dropped_count += CompactTable(table);
+    }
+  }
+
+  if (dropped_count > 0) {
+    LOG_DEBUG("Dropped %zu compacted tile groups", dropped_count);
+  }
+}
+
+size_t TileGroupCompactor::CompactTable(DataTable *table) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  double threshold = settings::SettingsManager::GetDouble(
+      settings::SettingId::tile_group_compaction_threshold);
+
+  // The transaction also keeps the table from being freed while we use it
+  auto *txn = txn_manager.BeginTransaction();
+  eid_t expired_epoch_id = epoch_manager.GetLastExpiredEpochId();
+
+  size_t dropped_count = 0;
+  size_t moved_count = 0;
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    auto *header = tile_group->GetHeader();
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+    oid_t allocated_count = tile_group->GetAllocatedTupleCount();
+
+    auto entry = sparse_tile_groups_.find(tile_group_id);
+    if (entry == sparse_tile_groups_.end()) {
+      if (header->GetCurrentNextTupleSlot() < allocated_count) {
+        continue;
+      }
+      oid_t live_count = 0;
+      for (oid_t slot = 0; slot < allocated_count; slot++) {
+        live_count += (header->GetTransactionId(slot) != INVALID_TXN_ID &&
+                       header->GetEndCommitId(slot) == MAX_CID);
+      }
+      if (live_count >= threshold * allocated_count) {
+        continue;
+      }
+
+      // Transactions may still be writing to slots they got from the GC
+      // before the tile group is made immutable
+      header->SetImmutability();
+      sparse_tile_groups_.emplace(tile_group_id,
+                                  epoch_manager.GetCurrentEpochId());
+      continue;
+    }
+    if (entry->second > expired_epoch_id) {
+      continue;
+    }
+
+    // Drop the tile group once the GC reclaimed all its versions
+    bool is_empty = true;
+    for (oid_t slot = 0; slot < allocated_count && is_empty; slot++) {
+      is_empty = (header->GetTransactionId(slot) == INVALID_TXN_ID);
+    }
+    if (is_empty) {
+      if (table->DropTileGroup(tile_group_id)) {
+        std::vector<RetiredTileData> released;
+        tile_group->Freeze();
+        tile_group->ReleaseTupleData(released);
+        retired_.Retire(released, epoch_manager.GetCurrentEpochId());
+        dropped_count++;
+      }
+      sparse_tile_groups_.erase(entry);
+      continue;
+    }
+
+    moved_count += MoveTuples(table, tile_group.get(), txn);
+  }
+
+  if (txn_manager.CommitTransaction(txn) != ResultType::SUCCESS) {
+    LOG_DEBUG("Failed to move %zu tuples of table %u", moved_count,
+              table->GetOid());
+  } else if (moved_count > 0) {
+    LOG_DEBUG("Moved %zu tuples of table %u", moved_count, table->GetOid());
+  }
+  return dropped_count;
+}
+
+size_t TileGroupCompactor::MoveTuples(DataTable *table, TileGroup *tile_group,
+                                      concurrency::TransactionContext *txn) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *storage_manager = StorageManager::GetInstance();
+  auto *header = tile_group->GetHeader();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+
+  size_t moved_count = 0;
+  oid_t allocated_count = tile_group->GetAllocatedTupleCount();
+  for (oid_t slot = 0; slot < allocated_count; slot++) {
+    // Tuples written by other transactions are moved in a later pass
+    if (txn_manager.IsVisible(txn, header, slot) != VisibilityType::OK ||
+        !txn_manager.IsOwnable(txn, header, slot) ||
+        !txn_manager.AcquireOwnership(txn, header, slot)) {
+      continue;
+    }
+
+    ItemPointer new_location = table->AcquireVersion();
+    if (new_location.IsNull()) {
+      txn_manager.YieldOwnership(txn, header, slot);
+      break;
+    }
+
+    // The new version is a copy of the old one, so no index changes
+    auto new_tile_group = storage_manager->GetTileGroup(new_location.block);
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      auto value = tile_group->GetValue(slot, column_id);
+      new_tile_group->SetValue(value, new_location.offset, column_id);
+    }
+    txn_manager.PerformUpdate(txn, ItemPointer(tile_group_id, slot),
+                              new_location);
+    moved_count++;
+  }
+  return moved_count;
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.cpp
+//
+// Identification: src/storage/tile_group_freezer.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_freezer.h"
+
+#include <chrono>
+
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "settings/settings_manager.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+TileGroupFreezer &TileGroupFreezer::GetInstance() {
+  static TileGroupFreezer freezer;
+  return freezer;
+}
+
+TileGroupFreezer::~TileGroupFreezer() { StopFreezing(); }
+
+void TileGroupFreezer::StartFreezing(int interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (is_running_) {
+    return;
+  }
+  is_running_ = true;
+  freezer_thread_ = std::thread(&TileGroupFreezer::Running, this, interval);
+  LOG_INFO("Started tile group freezer");
+}
+
+void TileGroupFreezer::StopFreezing() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_running_) {
+      return;
+    }
+    is_running_ = false;
+  }
+  stop_cv_.notify_all();
+  freezer_thread_.join();
+}
+
+void TileGroupFreezer::Running(int interval) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_cv_.wait_for(lock, std::chrono::seconds(interval),
+                            [this] { return !is_running_; })) {
+    lock.unlock();
+    FreezeTileGroups();
+    lock.lock();
+  }
+}
+
+void TileGroupFreezer::FreezeTileGroups() {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  // The GC thread moves the expired epoch forward, it's only read here
+  eid_t expired_epoch_id = epoch_manager.GetLastExpiredEpochId();
+  retired_.Free(expired_epoch_id);
+
+  eid_t cold_epochs = static_cast<eid_t>(settings::SettingsManager::GetInt(
+      settings::SettingId::tile_group_cold_epochs));
+  std::vector<RetiredTileData> released;
+  size_t frozen_count = 0;
+  auto *storage_manager = StorageManager::GetInstance();
+  oid_t last_tile_group_id = storage_manager->GetCurrentTileGroupId();
+  for (oid_t tile_group_id = START_OID + 1;
+       tile_group_id <= last_tile_group_id; tile_group_id++) {
+    auto tile_group = storage_manager->GetTileGroup(tile_group_id);
+    if (tile_group == nullptr) {
+      cold_tile_groups_.erase(tile_group_id);
+      continue;
+    }
+
+    if (!tile_group->IsFrozen()) {
+      auto *header = tile_group->GetHeader();
+      if (header->GetCurrentNextTupleSlot() <
+          tile_group->GetAllocatedTupleCount()) {
+        continue;
+      }
+
+      // A full tile group nothing was written to for a while is cold, stop
+      // handing out its recycled slots
+      if (header->GetImmutability() == false) {
+        if (header->GetLastWriteEpochId() + cold_epochs >
+            epoch_manager.GetCurrentEpochId()) {
+          continue;
+        }
+        header->SetImmutability();
+      }
+
+      // Transactions that got a slot before the tile group was seen cold may
+      // still be writing to it
+      auto entry = cold_tile_groups_.find(tile_group_id);
+      if (entry == cold_tile_groups_.end()) {
+        cold_tile_groups_.emplace(tile_group_id,
+                                  epoch_manager.GetCurrentEpochId());
+        continue;
+      }
+      if (entry->second > expired_epoch_id) {
+        continue;
+      }
+      cold_tile_groups_.erase(entry);
+      frozen_count += tile_group->Freeze();
+    }
+
+    // Keep the uncompressed tuples readers still use
+    if (tile_group->ClearAccessed() == false) {
+      tile_group->ReleaseTupleData(released);
+    }
+  }
+
+  // Readers that got the released tuples started before now
+  retired_.Retire(released, epoch_manager.GetCurrentEpochId());
+
+  if (frozen_count > 0 || !released.empty()) {
+    LOG_DEBUG("Froze %zu tile groups, released %zu tiles", frozen_count,
+              released.size());
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -19,11 +19,14 @@ namespace peloton {
 namespace storage {
 
 bool TileGroupIterator::Next(std::shared_ptr<TileGroup> &tileGroup) {
-  if (HasNext()) {
+  while (HasNext()) {
     auto next = table_->GetTileGroup(tile_group_itr_);
-    tileGroup.swap(next);
     tile_group_itr_++;
-    return (true);
+    // Skip tile groups dropped by compaction
+    if (next != nullptr) {
+      tileGroup.swap(next);
+      return (true);
+    }
   }
   return (false);
 }
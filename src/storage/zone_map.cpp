@@ -0,0 +1,320 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.cpp
+//
+// Identification: src/storage/zone_map.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/zone_map.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "storage/layout.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/zone_map_manager.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+constexpr int64_t kMinKey = std::numeric_limits<int64_t>::min();
+constexpr int64_t kMaxKey = std::numeric_limits<int64_t>::max();
+
+// Flipping the top bit maps unsigned order onto signed order
+constexpr uint64_t kSignBit = uint64_t{1} << 63;
+
+bool IsIntegerType(type::TypeId type) {
+  return type == type::TypeId::TINYINT || type == type::TypeId::SMALLINT ||
+         type == type::TypeId::INTEGER || type == type::TypeId::BIGINT;
+}
+
+}  // namespace
+
+ZoneMap::ZoneMap(const TileGroup &tile_group)
+    : tile_group_(tile_group) {
+  const auto &layout = tile_group.GetLayout();
+  oid_t num_columns = layout.GetColumnCount();
+  min_.reset(new std::atomic<int64_t>[num_columns]);
+  max_.reset(new std::atomic<int64_t>[num_columns]);
+
+  for (oid_t col_id = 0; col_id < num_columns; col_id++) {
+    oid_t tile_offset, tile_column_id;
+    layout.LocateTileAndColumn(col_id, tile_offset, tile_column_id);
+    const auto *schema = tile_group.GetTile(tile_offset)->GetSchema();
+    columns_.push_back(ColumnInfo{schema->GetType(tile_column_id), tile_offset,
+                                  schema->GetOffset(tile_column_id)});
+
+    // Tracked columns start out empty, the rest can hold anything
+    bool tracked = IsTrackedType(columns_.back().type);
+    if (tracked) {
+      tracked_columns_.push_back(col_id);
+    }
+    min_[col_id].store(tracked ? kMaxKey : kMinKey, std::memory_order_relaxed);
+    max_[col_id].store(tracked ? kMinKey : kMaxKey, std::memory_order_relaxed);
+  }
+}
+
+void ZoneMap::Update(oid_t tuple_slot) {
+  for (oid_t col_id : tracked_columns_) {
+    UpdateColumn(col_id, tuple_slot);
+  }
+}
+
+void ZoneMap::UpdateColumn(oid_t column_id, oid_t tuple_slot) {
+  int64_t key;
+  if (!ReadKey(column_id, tuple_slot, key)) {
+    return;
+  }
+  // The bounds only ever move outwards, so a failed exchange just retries
+  // against the bound another writer stored
+  auto &min = min_[column_id];
+  int64_t cur_min = min.load(std::memory_order_relaxed);
+  while (key < cur_min &&
+         !min.compare_exchange_weak(cur_min, key, std::memory_order_relaxed)) {
+  }
+  auto &max = max_[column_id];
+  int64_t cur_max = max.load(std::memory_order_relaxed);
+  while (key > cur_max &&
+         !max.compare_exchange_weak(cur_max, key, std::memory_order_relaxed)) {
+  }
+}
+
+void ZoneMap::Rebuild() {
+  latch_.Lock();
+  oid_t num_tuple_slots = tile_group_.GetNextTupleSlot();
+  for (oid_t col_id : tracked_columns_) {
+    int64_t min = kMaxKey, max = kMinKey;
+    for (oid_t tuple_slot = 0; tuple_slot < num_tuple_slots; tuple_slot++) {
+      int64_t key;
+      if (ReadKey(col_id, tuple_slot, key)) {
+        min = std::min(min, key);
+        max = std::max(max, key);
+      }
+    }
+    min_[col_id].store(min, std::memory_order_relaxed);
+    max_[col_id].store(max, std::memory_order_relaxed);
+  }
+  latch_.Unlock();
+}
+
+bool ZoneMap::ShouldScan(const PredicateRange *predicates,
+                         uint32_t num_predicates) {
+  // Every predicate must overlap its column's range. This is kept free of
+  // branches, the predicates are few and almost always all checked anyway.
+  bool should_scan = true;
+  for (uint32_t i = 0; i < num_predicates; i++) {
+    const auto &predicate = predicates[i];
+    int64_t min = min_[predicate.col_id].load(std::memory_order_relaxed);
+    int64_t max = max_[predicate.col_id].load(std::memory_order_relaxed);
+    should_scan &= (min <= predicate.high) & (max >= predicate.low);
+  }
+  return should_scan;
+}
+
+bool ZoneMap::IsEmpty(oid_t column_id) const {
+  return min_[column_id].load(std::memory_order_relaxed) >
+         max_[column_id].load(std::memory_order_relaxed);
+}
+
+type::Value ZoneMap::GetMinValue(oid_t column_id) const {
+  PELOTON_ASSERT(IsTracked(column_id) && !IsEmpty(column_id));
+  return DecodeKey(column_id, min_[column_id].load(std::memory_order_relaxed));
+}
+
+type::Value ZoneMap::GetMaxValue(oid_t column_id) const {
+  PELOTON_ASSERT(IsTracked(column_id) && !IsEmpty(column_id));
+  return DecodeKey(column_id, max_[column_id].load(std::memory_order_relaxed));
+}
+
+bool ZoneMap::EncodePredicate(type::TypeId column_type,
+                              const PredicateInfo &predicate,
+                              PredicateRange &range) {
+  const type::Value &value = predicate.predicate_value;
+  if (value.IsNull()) {
+    return false;
+  }
+
+  // Convert the constant into a key of the column's type. Only conversions
+  // that are exact are done, predicates needing any other aren't checked.
+  type::TypeId value_type = value.GetTypeId();
+  int64_t key;
+  switch (column_type) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT: {
+      if (!IsIntegerType(value_type)) {
+        return false;
+      }
+      key = value.CastAs(type::TypeId::BIGINT).GetAs<int64_t>();
+      break;
+    }
+    case type::TypeId::DECIMAL: {
+      double val;
+      if (IsIntegerType(value_type)) {
+        int64_t int_val = value.CastAs(type::TypeId::BIGINT).GetAs<int64_t>();
+        val = static_cast<double>(int_val);
+        if (static_cast<int64_t>(val) != int_val) {
+          return false;
+        }
+      } else if (value_type == type::TypeId::DECIMAL) {
+        val = value.GetAs<double>();
+        if (std::isnan(val)) {
+          return false;
+        }
+      } else {
+        return false;
+      }
+      key = EncodeDecimal(val);
+      break;
+    }
+    case type::TypeId::TIMESTAMP: {
+      if (value_type != type::TypeId::TIMESTAMP) {
+        return false;
+      }
+      key = static_cast<int64_t>(value.GetAs<uint64_t>() ^ kSignBit);
+      break;
+    }
+    default:
+      return false;
+  }
+
+  range.col_id = static_cast<uint32_t>(predicate.col_id);
+  switch (static_cast<ExpressionType>(predicate.comparison_operator)) {
+    case ExpressionType::COMPARE_EQUAL:
+      range.low = key;
+      range.high = key;
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      range.low = (key == kMinKey ? kMaxKey : kMinKey);
+      range.high = (key == kMinKey ? kMinKey : key - 1);
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      range.low = kMinKey;
+      range.high = key;
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      range.low = (key == kMaxKey ? kMaxKey : key + 1);
+      range.high = (key == kMaxKey ? kMinKey : kMaxKey);
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      range.low = key;
+      range.high = kMaxKey;
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+bool ZoneMap::IsTrackedType(type::TypeId type) {
+  return IsIntegerType(type) || type == type::TypeId::DECIMAL ||
+         type == type::TypeId::TIMESTAMP;
+}
+
+bool ZoneMap::ReadKey(oid_t column_id, oid_t tuple_slot, int64_t &key) const {
+  const auto &column = columns_[column_id];
+  const char *data =
+      tile_group_.GetTile(column.tile_offset)->GetTupleLocation(tuple_slot) +
+      column.offset;
+  return EncodeKey(column.type, data, key);
+}
+
+bool ZoneMap::EncodeKey(type::TypeId type, const char *data, int64_t &key) {
+  switch (type) {
+    case type::TypeId::TINYINT: {
+      auto val = *reinterpret_cast<const int8_t *>(data);
+      key = val;
+      return val != type::PELOTON_INT8_NULL;
+    }
+    case type::TypeId::SMALLINT: {
+      auto val = *reinterpret_cast<const int16_t *>(data);
+      key = val;
+      return val != type::PELOTON_INT16_NULL;
+    }
+    case type::TypeId::INTEGER: {
+      auto val = *reinterpret_cast<const int32_t *>(data);
+      key = val;
+      return val != type::PELOTON_INT32_NULL;
+    }
+    case type::TypeId::BIGINT: {
+      auto val = *reinterpret_cast<const int64_t *>(data);
+      key = val;
+      return val != type::PELOTON_INT64_NULL;
+    }
+    case type::TypeId::DECIMAL: {
+      auto val = *reinterpret_cast<const double *>(data);
+      if (val == type::PELOTON_DECIMAL_NULL || std::isnan(val)) {
+        return false;
+      }
+      key = EncodeDecimal(val);
+      return true;
+    }
+    case type::TypeId::TIMESTAMP: {
+      auto val = *reinterpret_cast<const uint64_t *>(data);
+      key = static_cast<int64_t>(val ^ kSignBit);
+      return val != type::PELOTON_TIMESTAMP_NULL;
+    }
+    default:
+      return false;
+  }
+}
+
+// The bits of a non-negative double are ordered like the double itself.
+// Flipping all but the sign bit of a negative one reverses its order and
+// places it below every non-negative one.
+int64_t ZoneMap::EncodeDecimal(double val) {
+  // -0.0 and 0.0 compare equal, so they must have the same key
+  if (val == 0) {
+    val = 0;
+  }
+  int64_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return bits >= 0 ? bits : bits ^ kMaxKey;
+}
+
+double ZoneMap::DecodeDecimal(int64_t key) {
+  int64_t bits = key >= 0 ? key : key ^ kMaxKey;
+  double val;
+  std::memcpy(&val, &bits, sizeof(val));
+  return val;
+}
+
+type::Value ZoneMap::DecodeKey(oid_t column_id, int64_t key) const {
+  type::TypeId type = columns_[column_id].type;
+  switch (type) {
+    case type::TypeId::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(static_cast<int8_t>(key));
+    case type::TypeId::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(static_cast<int16_t>(key));
+    case type::TypeId::INTEGER:
+      return type::ValueFactory::GetIntegerValue(static_cast<int32_t>(key));
+    case type::TypeId::BIGINT:
+      return type::ValueFactory::GetBigIntValue(key);
+    case type::TypeId::DECIMAL:
+      return type::ValueFactory::GetDecimalValue(DecodeDecimal(key));
+    case type::TypeId::TIMESTAMP:
+      return type::ValueFactory::GetTimestampValue(
+          static_cast<uint64_t>(key) ^ kSignBit);
+    default:
+      throw Exception{"Zone maps don't track columns of type " +
+                      TypeIdToString(type)};
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
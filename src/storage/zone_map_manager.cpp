@@ -19,6 +19,8 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/storage_manager.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/zone_map.h"
 #include "type/ephemeral_pool.h"
 
 namespace peloton {
@@ -64,7 +66,9 @@ void ZoneMapManager::CreateZoneMapsForTable(
   for (size_t i = 0; i < num_tile_groups; i++) {
     auto tile_group = table->GetTileGroup(i);
     auto tile_group_ptr = tile_group.get();
-    PELOTON_ASSERT(tile_group_ptr != nullptr);
+    if (tile_group_ptr == nullptr) {
+      continue;
+    }
     auto tile_group_header = tile_group_ptr->GetHeader();
     PELOTON_ASSERT(tile_group_header != nullptr);
     bool immutable = tile_group_header->GetImmutability();
@@ -218,8 +222,8 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 }
 
 /**
- * The function compares the predicate against the zone map for the column
- * present in catalog.
+ * The function compares the predicates against the in-memory zone map of the
+ * tile group.
  *
  * @param parsed predicates array
  * @param num_predicates
@@ -231,51 +235,44 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 bool ZoneMapManager::ShouldScanTileGroup(
     storage::PredicateInfo *parsed_predicates, int32_t num_predicates,
     storage::DataTable *table, int64_t tile_group_idx) {
-  for (int32_t i = 0; i < num_predicates; i++) {
-    // Extract the col_id, operator and predicate_value
-    int col_id = parsed_predicates[i].col_id;
-    int comparison_operator = parsed_predicates[i].comparison_operator;
-    type::Value predicate_value = parsed_predicates[i].predicate_value;
-
-    oid_t database_id = table->GetDatabaseOid();
-    oid_t table_id = table->GetOid();
+  std::vector<storage::PredicateRange> predicate_ranges(num_predicates);
+  int32_t num_ranges =
+      EncodePredicates(parsed_predicates, num_predicates, *table->GetSchema(),
+                       predicate_ranges.data());
 
-    std::unique_ptr<ZoneMapManager::ColumnStatistics> stats =
-        GetZoneMapFromCatalog(database_id, table_id, tile_group_idx, col_id);
+  auto tile_group = table->GetTileGroup(tile_group_idx);
+  if (tile_group == nullptr) {
+    return false;
+  }
+  return tile_group->GetZoneMap()->ShouldScan(predicate_ranges.data(),
+                                              num_ranges);
+}
 
-    if (stats == nullptr) {
-      return true;
-    }
-    switch (comparison_operator) {
-      case (int)ExpressionType::COMPARE_EQUAL:
-        if (!CheckEqual(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_LESSTHAN:
-        if (!CheckLessThan(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_LESSTHANOREQUALTO:
-        if (!CheckLessThanEquals(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_GREATERTHAN:
-        if (!CheckGreaterThan(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_GREATERTHANOREQUALTO:
-        if (!CheckGreaterThanEquals(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      default: { throw Exception{"Invalid expression type for translation "}; }
+/**
+ * Encodes the parsed predicates on a table into ranges that are checked
+ * against the zone maps of its tile groups. Predicates that can't be checked
+ * against a zone map are dropped.
+ *
+ * @param parsed_predicates The parsed predicates
+ * @param num_predicates The number of parsed predicates
+ * @param schema The schema of the table the predicates are on
+ * @param[out] predicate_ranges Room for num_predicates encoded predicates
+ *
+ * @return  The number of encoded predicates
+ */
+int32_t ZoneMapManager::EncodePredicates(
+    const storage::PredicateInfo *parsed_predicates, int32_t num_predicates,
+    const catalog::Schema &schema, storage::PredicateRange *predicate_ranges) {
+  int32_t num_ranges = 0;
+  for (int32_t i = 0; i < num_predicates; i++) {
+    const auto &predicate = parsed_predicates[i];
+    type::TypeId column_type = schema.GetType(predicate.col_id);
+    if (ZoneMap::EncodePredicate(column_type, predicate,
+                                 predicate_ranges[num_ranges])) {
+      num_ranges++;
     }
   }
-  return true;
+  return num_ranges;
 }
 
 /**
@@ -20,9 +20,11 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "expression/expression_util.h"
 #include "optimizer/optimizer.h"
+#include "parser/copy_statement.h"
 #include "planner/plan_util.h"
 #include "settings/settings_manager.h"
 #include "threadpool/mono_queue_pool.h"
+#include "util/pipe.h"
 
 namespace peloton {
 namespace tcop {
@@ -50,6 +52,10 @@ void TrafficCop::Reset() {
 }
 
 TrafficCop::~TrafficCop() {
+  // Do not leave an executing statement blocked on its result
+  CancelResultStream();
+  StopStreamThread();
+
   // Abort all running transactions
   while (!tcop_txn_state_.empty()) {
     AbortQueryHelper();
@@ -153,6 +159,10 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
     std::shared_ptr<planner::AbstractPlan> plan,
     const std::vector<type::Value> &params, std::vector<ResultValue> &result,
     const std::vector<int> &result_format, size_t thread_id) {
+  // The pipe lives as long as the statement may read from it
+  std::shared_ptr<util::Pipe> copy_input = std::move(copy_input_);
+  executing_copy_input_ = copy_input;
+
   auto &curr_state = GetCurrentTxnState();
 
   concurrency::TransactionContext *txn;
@@ -180,21 +190,54 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
     return p_status_;
   }
 
-  auto on_complete = [&result, this](executor::ExecutionResult p_status,
-                                     std::vector<ResultValue> &&values) {
+  bool stream_results = stream_results_;
+  if (stream_results) {
+    // The rows go to fetched_batches_ as the batches are fetched
+    result_.clear();
+    fetched_batches_.clear();
+    std::lock_guard<std::mutex> lock(result_batch_mutex_);
+    result_batches_.clear();
+    execution_done_ = false;
+    result_stream_closed_ = false;
+  }
+
+  auto on_complete = [&result, stream_results, this](
+      executor::ExecutionResult p_status, std::vector<ResultValue> &&values) {
     this->p_status_ = p_status;
     // TODO (Tianyi) I would make a decision on keeping one of p_status or
     // error_message in my next PR
     this->error_message_ = std::move(p_status.m_error_message);
-    result = std::move(values);
+    if (stream_results) {
+      // All the rows went through PushResultBatch(), and the connection may
+      // be fetching them
+      std::lock_guard<std::mutex> lock(result_batch_mutex_);
+      execution_done_ = true;
+      result_batch_cv_.notify_all();
+    } else {
+      result = std::move(values);
+    }
     task_callback_(task_callback_arg_);
   };
 
-  auto &pool = threadpool::MonoQueuePool::GetInstance();
-  pool.SubmitTask([plan, txn, &params, &result_format, on_complete] {
+  std::function<bool(ResultBatch &&)> on_result_batch;
+  if (stream_results) {
+    on_result_batch = [this](ResultBatch &&batch) {
+      return PushResultBatch(std::move(batch));
+    };
+  }
+
+  auto task = [plan, txn, &params, &result_format, on_result_batch,
+               on_complete, copy_input] {
     executor::PlanExecutor::ExecutePlan(plan, txn, params, result_format,
-                                        on_complete);
-  });
+                                        on_result_batch, on_complete,
+                                        copy_input.get());
+  };
+  if (stream_results || copy_input != nullptr) {
+    // It may wait on the client, so it gets its own thread
+    RunStreamTask(task);
+  } else {
+    threadpool::MonoQueuePool::GetInstance().SubmitTask(task);
+  }
 
   is_queuing_ = true;
 
@@ -203,6 +246,107 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
   return p_status_;
 }
 
+bool TrafficCop::PushResultBatch(ResultBatch &&batch) {
+  {
+    std::unique_lock<std::mutex> lock(result_batch_mutex_);
+    result_batch_cv_.wait(lock, [this] {
+      return result_batches_.size() < MAX_PENDING_RESULT_BATCHES ||
+             result_stream_closed_;
+    });
+    if (result_stream_closed_) return false;
+    result_batches_.push_back(std::move(batch));
+  }
+  task_callback_(task_callback_arg_);
+  return true;
+}
+
+bool TrafficCop::FetchResultBatches() {
+  if (!stream_results_) return true;
+
+  bool execution_done;
+  {
+    std::lock_guard<std::mutex> lock(result_batch_mutex_);
+    for (auto &batch : result_batches_) {
+      fetched_batches_.push_back(std::move(batch));
+    }
+    result_batches_.clear();
+    execution_done = execution_done_;
+  }
+  result_batch_cv_.notify_all();
+  return execution_done;
+}
+
+void TrafficCop::DiscardResultBatches() {
+  if (!stream_results_) return;
+
+  CancelResultStream();
+  {
+    std::unique_lock<std::mutex> lock(result_batch_mutex_);
+    result_batch_cv_.wait(lock, [this] { return execution_done_; });
+  }
+  fetched_batches_.clear();
+  result_.clear();
+}
+
+void TrafficCop::CancelResultStream() {
+  {
+    // The statement drops its rows while the stream is closed, rather than
+    // waiting for them to be fetched, and stops at its next batch
+    std::lock_guard<std::mutex> lock(result_batch_mutex_);
+    result_stream_closed_ = true;
+    result_batches_.clear();
+  }
+  result_batch_cv_.notify_all();
+  // Nobody writes the rest of the data of a COPY FROM STDIN anymore
+  if (executing_copy_input_ != nullptr) {
+    executing_copy_input_->Fail("connection closed");
+  }
+}
+
+void TrafficCop::RunStreamTask(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(result_batch_mutex_);
+    PELOTON_ASSERT(!stream_task_);
+    stream_task_ = std::move(task);
+  }
+  if (!stream_thread_.joinable()) {
+    stream_thread_ = std::thread(&TrafficCop::StreamThreadMain, this);
+  }
+  stream_task_cv_.notify_one();
+}
+
+void TrafficCop::StreamThreadMain() {
+  std::unique_lock<std::mutex> lock(result_batch_mutex_);
+  while (true) {
+    stream_task_cv_.wait(
+        lock, [this] { return stream_task_ || stream_thread_stop_; });
+    if (!stream_task_) return;
+    auto task = std::move(stream_task_);
+    stream_task_ = nullptr;
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+void TrafficCop::StopStreamThread() {
+  {
+    std::lock_guard<std::mutex> lock(result_batch_mutex_);
+    stream_thread_stop_ = true;
+  }
+  stream_task_cv_.notify_one();
+  if (stream_thread_.joinable()) {
+    stream_thread_.join();
+  }
+}
+
+std::shared_ptr<util::Pipe> TrafficCop::OpenCopyInput() {
+  copy_input_ = std::make_shared<util::Pipe>();
+  copy_input_->SetRoomCallback(
+      [this] { task_callback_(task_callback_arg_); });
+  return copy_input_;
+}
+
 void TrafficCop::ExecuteStatementPlanGetResult() {
   if (p_status_.m_result == ResultType::FAILURE) return;
 
@@ -326,7 +470,8 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
         planner::PlanUtil::GetTablesReferenced(plan.get());
     statement->SetReferencedTables(table_oids);
 
-    if (query_type == QueryType::QUERY_SELECT) {
+    if (query_type == QueryType::QUERY_SELECT ||
+        query_type == QueryType::QUERY_COPY) {
       auto tuple_descriptor = GenerateTupleDescriptor(
           statement->GetStmtParseTreeList()->GetStatement(0));
       statement->SetTupleDescriptor(tuple_descriptor);
@@ -444,6 +589,22 @@ void TrafficCop::GetTableColumns(parser::TableRef *from_table,
 std::vector<FieldInfo> TrafficCop::GenerateTupleDescriptor(
     parser::SQLStatement *sql_stmt) {
   std::vector<FieldInfo> tuple_descriptor;
+  if (sql_stmt->GetType() == StatementType::COPY) {
+    // COPY TO STDOUT returns its rows like a query does
+    auto *copy_stmt = static_cast<parser::CopyStatement *>(sql_stmt);
+    if (copy_stmt->is_from || !copy_stmt->file_path.empty()) {
+      return tuple_descriptor;
+    }
+    if (copy_stmt->select_stmt != nullptr) {
+      return GenerateTupleDescriptor(copy_stmt->select_stmt.get());
+    }
+    // The binder expanded the table into all of its columns
+    for (auto &expr : copy_stmt->select_list) {
+      tuple_descriptor.push_back(GetColumnFieldForValueType(
+          expr->GetExpressionName(), expr->GetValueType()));
+    }
+    return tuple_descriptor;
+  }
   if (sql_stmt->GetType() != StatementType::SELECT) return tuple_descriptor;
   auto select_stmt = (parser::SelectStatement *)sql_stmt;
 
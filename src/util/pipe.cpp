@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// pipe.cpp
+//
+// Identification: src/util/pipe.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "util/pipe.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace peloton {
+namespace util {
+
+constexpr uint64_t Pipe::kDefaultCapacity;
+
+bool Pipe::Write(const void *data, uint64_t len) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PELOTON_ASSERT(!closed_ && !failed_);
+
+  if (len > 0) {
+    chunks_.emplace_back(static_cast<const char *>(data), len);
+    size_ += len;
+    data_cv_.notify_one();
+  }
+
+  writer_waiting_ = (size_ >= capacity_);
+  return !writer_waiting_;
+}
+
+void Pipe::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  closed_ = true;
+  data_cv_.notify_one();
+}
+
+void Pipe::Fail(const std::string &message) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  failed_ = true;
+  error_message_ = message;
+  data_cv_.notify_one();
+}
+
+uint64_t Pipe::Read(void *data, uint64_t len) {
+  bool has_room = false;
+  uint64_t bytes_read = 0;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    data_cv_.wait(lock, [this] { return size_ > 0 || closed_ || failed_; });
+    if (failed_) {
+      throw Exception(error_message_);
+    }
+
+    // Copy out of as many chunks as fit
+    auto *out = static_cast<char *>(data);
+    while (bytes_read < len && !chunks_.empty()) {
+      const auto &chunk = chunks_.front();
+      uint64_t n = std::min(len - bytes_read, chunk.size() - chunk_pos_);
+      PELOTON_MEMCPY(out + bytes_read, chunk.data() + chunk_pos_, n);
+      bytes_read += n;
+      chunk_pos_ += n;
+      if (chunk_pos_ == chunk.size()) {
+        chunks_.pop_front();
+        chunk_pos_ = 0;
+      }
+    }
+    size_ -= bytes_read;
+
+    if (writer_waiting_ && size_ < capacity_) {
+      writer_waiting_ = false;
+      has_room = true;
+    }
+  }
+
+  // Let the writer go on, without holding the lock
+  if (has_room && on_room_) {
+    on_room_();
+  }
+  return bytes_read;
+}
+
+bool Pipe::HasRoom() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_ < capacity_;
+}
+
+}  // namespace util
+}  // namespace peloton
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "catalog/catalog.h"
+#include "catalog/catalog_cache.h"
 #include "catalog/column.h"
 #include "catalog/column_catalog.h"
 #include "catalog/database_catalog.h"
@@ -200,6 +201,52 @@ TEST_F(CatalogTests, TestingCatalogCache) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(CatalogTests, SharedCatalogCache) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto catalog = catalog::Catalog::GetInstance();
+  auto &shared_cache = catalog::SharedCatalogCache::GetInstance();
+
+  // the first transaction reads the table from pg_table, and shares it
+  auto txn = txn_manager.BeginTransaction();
+  auto table_object = catalog->GetTableCatalogEntry(
+      txn, "emp_db", DEFAULT_SCHEMA_NAME, "department_table");
+  oid_t table_oid = table_object->GetTableOid();
+  txn_manager.CommitTransaction(txn);
+
+  // the shared snapshot has the table now
+  uint64_t version = shared_cache.GetVersion();
+  EXPECT_EQ(0u, version % 2);
+  auto shared_db_object = shared_cache.GetDatabaseObject(version, "emp_db");
+  ASSERT_NE(nullptr, shared_db_object);
+  EXPECT_NE(nullptr, shared_db_object->GetTableCatalogEntry(table_oid, true));
+
+  // the next one finds it there: a lookup that may not read pg_table hits
+  txn = txn_manager.BeginTransaction();
+  auto db_object = catalog->GetDatabaseCatalogEntry(txn, "emp_db");
+  ASSERT_NE(nullptr, db_object);
+  table_object = db_object->GetTableCatalogEntry(table_oid, true);
+  ASSERT_NE(nullptr, table_object);
+  EXPECT_EQ("department_table", table_object->GetTableName());
+  txn_manager.CommitTransaction(txn);
+
+  // it read nothing from storage, so it had nothing to publish
+  EXPECT_EQ(shared_db_object,
+            shared_cache.GetDatabaseObject(version, "emp_db"));
+
+  // a catalog change drops the shared entries
+  txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase(txn, "shared_cache_db");
+  txn_manager.CommitTransaction(txn);
+  EXPECT_NE(version, shared_cache.GetVersion());
+  EXPECT_EQ(0u, shared_cache.GetVersion() % 2);
+
+  txn = txn_manager.BeginTransaction();
+  db_object = catalog->GetDatabaseCatalogEntry(txn, "emp_db");
+  EXPECT_EQ(nullptr, db_object->GetTableCatalogEntry(table_oid, true));
+  catalog->DropDatabaseWithName(txn, "shared_cache_db");
+  txn_manager.CommitTransaction(txn);
+}
+
 TEST_F(CatalogTests, TableObject) {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
@@ -238,5 +238,64 @@ TEST_F(BytecodeInterpreterTest, InternalCallTest) {
   ASSERT_EQ(ret, 10);
 }
 
+namespace {
+
+void NativeBump(int64_t *counter) { *counter += 100; }
+
+// Resolves the function "bump" to NativeBump
+class TestResolver : public codegen::interpreter::NativeFunctionResolver {
+ public:
+  void *GetNativeFunction(const std::string &function_name) const override {
+    return function_name == "bump" ? reinterpret_cast<void *>(&NativeBump)
+                                   : nullptr;
+  }
+};
+
+}  // namespace
+
+TEST_F(BytecodeInterpreterTest, NativeInternalCallTest) {
+  // Call an internal function that is replaced by native code.
+
+  codegen::CodeContext code_context;
+  codegen::CodeGen cg{code_context};
+
+  codegen::FunctionBuilder bump{code_context,
+                                "bump",
+                                cg.VoidType(),
+                                {{"counter", cg.Int64Type()->getPointerTo()}}};
+  {
+    auto *counter = bump.GetArgumentByPosition(0);
+    auto *val = cg->CreateAdd(cg->CreateLoad(counter), cg.Const64(1));
+    cg->CreateStore(val, counter);
+    bump.ReturnAndFinish();
+  }
+
+  codegen::FunctionBuilder main{code_context,
+                                "main",
+                                cg.VoidType(),
+                                {{"counter", cg.Int64Type()->getPointerTo()}}};
+  {
+    auto *counter = main.GetArgumentByPosition(0);
+    cg.CallFunc(bump.GetFunction(), {counter});
+    main.ReturnAndFinish();
+  }
+
+  // create Bytecode
+  auto bytecode = codegen::interpreter::BytecodeBuilder::CreateBytecodeFunction(
+      code_context, main.GetFunction());
+
+  // Without a resolver, the function is interpreted
+  int64_t counter = 0;
+  codegen::interpreter::BytecodeInterpreter::ExecuteFunction(
+      bytecode, reinterpret_cast<char *>(&counter));
+  ASSERT_EQ(counter, 1);
+
+  // With a resolver, the native implementation is called instead
+  TestResolver resolver;
+  codegen::interpreter::BytecodeInterpreter::ExecuteFunction(
+      bytecode, reinterpret_cast<char *>(&counter), &resolver);
+  ASSERT_EQ(counter, 101);
+}
+
 }  // namespace test
-}  // namespace peloton
\ No newline at end of file
+}  // namespace peloton
@@ -455,5 +455,293 @@ TEST_F(GroupByTranslatorTest, MinAndMax) {
               CmpBool::CmpTrue);
 }
 
+TEST_F(GroupByTranslatorTest, ParallelAggregation) {
+  //
+  // SELECT a, COUNT(*), SUM(b) FROM table GROUP BY a;
+  //
+  // The scan is parallel, so each thread aggregates into its own hash table
+  // and the groups are merged into partitions afterwards.
+  //
+
+  LOG_INFO("Query: SELECT a, COUNT(*), SUM(b) FROM table1 GROUP BY a;");
+
+  // Spread the table over many tile groups
+  uint32_t num_rows = 1000;
+  LoadTestTable(TestTableId(), num_rows - 10);
+
+  // 1) Set up projection (just a direct map)
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // 2) Setup the aggregations
+  auto *count_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  auto *sum_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR, count_expr},
+      {ExpressionType::AGGREGATE_SUM, sum_expr}};
+
+  // 3) The grouping column
+  std::vector<oid_t> gb_cols = {0};
+
+  // 4) The output schema
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_A"},
+                           {type::TypeId::BIGINT, 8, "COUNT_*"},
+                           {type::TypeId::INTEGER, 4, "SUM_B"}})};
+
+  // 5) Finally, the aggregation node
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+
+  // 6) The parallel scan that feeds the aggregation
+  std::unique_ptr<planner::AbstractPlan> scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(TestTableId()), nullptr, {0, 1}, false, true)};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+
+  // Compile it all
+  CompileAndExecute(*agg_plan, buffer);
+
+  // Every row is its own group, no matter which thread aggregated it
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(num_rows, results.size());
+
+  // The values of 'b' are equal to the row ID * 10 + 1. Therefore, the sums of
+  // all groups add up to 10 * (999 * 1000 / 2) + 1000
+  type::Value const_one = type::ValueFactory::GetIntegerValue(1);
+  int64_t total_sum = 0;
+  for (const auto &tuple : results) {
+    EXPECT_TRUE(tuple.GetValue(1).CompareEquals(const_one) ==
+                CmpBool::CmpTrue);
+    total_sum += tuple.GetValue(2).GetAs<int32_t>();
+  }
+  EXPECT_EQ(4996000, total_sum);
+}
+
+TEST_F(GroupByTranslatorTest, ParallelGlobalAggregation) {
+  //
+  // SELECT COUNT(*), SUM(b), MIN(a), MAX(a) FROM table;
+  //
+  // The scan is parallel, so each thread computes its own partial aggregates
+  // which are merged afterwards.
+  //
+
+  LOG_INFO("Query: SELECT COUNT(*), SUM(b), MIN(a), MAX(a) FROM table1;");
+
+  // Spread the table over many tile groups
+  uint32_t num_rows = 1000;
+  LoadTestTable(TestTableId(), num_rows - 10);
+
+  // 1) Set up projection (just a direct map)
+  DirectMapList direct_map_list = {
+      {0, {1, 0}}, {1, {1, 1}}, {2, {1, 2}}, {3, {1, 3}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // 2) Setup the aggregations
+  auto *count_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  auto *sum_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  auto *min_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  auto *max_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR, count_expr},
+      {ExpressionType::AGGREGATE_SUM, sum_expr},
+      {ExpressionType::AGGREGATE_MIN, min_expr},
+      {ExpressionType::AGGREGATE_MAX, max_expr}};
+
+  // 3) No grouping
+  std::vector<oid_t> gb_cols = {};
+
+  // 4) The output schema
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::BIGINT, 8, "COUNT_*"},
+                           {type::TypeId::INTEGER, 4, "SUM_B"},
+                           {type::TypeId::INTEGER, 4, "MIN_A"},
+                           {type::TypeId::INTEGER, 4, "MAX_A"}})};
+
+  // 5) Finally, the aggregation node
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+
+  // 6) The parallel scan that feeds the aggregation
+  std::unique_ptr<planner::AbstractPlan> scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(TestTableId()), nullptr, {0, 1}, false, true)};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // Compile it all
+  CompileAndExecute(*agg_plan, buffer);
+
+  // There should only be a single output row, merged from all the threads
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(1, results.size());
+
+  // The values of 'a' are equal to the row ID * 10, the values of 'b' to the
+  // row ID * 10 + 1. Therefore: SUM(b) = 10 * (999 * 1000 / 2) + 1000
+  EXPECT_TRUE(results[0].GetValue(0).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(num_rows)) ==
+              CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(1).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(4996000)) ==
+              CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(2).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(0)) == CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(3).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(9990)) ==
+              CmpBool::CmpTrue);
+}
+
+
+TEST_F(GroupByTranslatorTest, SortedAggregation) {
+  //
+  // SELECT a, count(*) FROM table GROUP BY a;
+  //
+  // The table is scanned in the order of column a, so the groups are adjacent
+  // and are aggregated without a hash table.
+  //
+
+  LOG_INFO("Query: SELECT a, COUNT(*) FROM table1 GROUP BY a;");
+
+  // 1) Set up projection (just a direct map)
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // 2) Setup the aggregations
+  // For count(*) just use a TVE
+  auto *tve_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR, tve_expr}};
+
+  // 3) The grouping column
+  std::vector<oid_t> gb_cols = {0};
+
+  // 4) The output schema
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_A"},
+                           {type::TypeId::BIGINT, 8, "COUNT_A"}})};
+
+  // 5) Finally, the aggregation node
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::SORTED)};
+
+  // 6) The scan that feeds the aggregation
+  std::unique_ptr<planner::AbstractPlan> scan_plan{
+      new planner::SeqScanPlan(&GetTestTable(TestTableId()), nullptr, {0})};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // Compile and run
+  CompileAndExecute(*agg_plan, buffer);
+
+  // Check results
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(10, results.size());
+
+  // Each group has a count of one, and the groups keep the order of the input
+  type::Value const_one = type::ValueFactory::GetIntegerValue(1);
+  for (uint32_t i = 0; i < results.size(); i++) {
+    EXPECT_TRUE(results[i].GetValue(0).CompareEquals(
+                    type::ValueFactory::GetIntegerValue(10 * i)) ==
+                CmpBool::CmpTrue);
+    EXPECT_TRUE(results[i].GetValue(1).CompareEquals(const_one) ==
+                CmpBool::CmpTrue);
+  }
+}
+
+TEST_F(GroupByTranslatorTest, SortedAggregationOnNullKeys) {
+  //
+  // SELECT b, count(*) FROM table GROUP BY b;
+  //
+  // Column b is NULL in every row of the second table, which forms one group
+  //
+
+  LOG_INFO("Query: SELECT b, COUNT(*) FROM table2 GROUP BY b;");
+
+  uint32_t num_rows = 10;
+  LoadTestTable(test_table_oids[1], num_rows, true);
+
+  // 1) Set up projection (just a direct map)
+  DirectMapList direct_map_list = {{0, {0, 1}}, {1, {1, 0}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // 2) Setup the aggregations
+  // For count(*) just use a TVE
+  auto *tve_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR, tve_expr}};
+
+  // 3) The grouping column
+  std::vector<oid_t> gb_cols = {1};
+
+  // 4) The output schema
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_B"},
+                           {type::TypeId::BIGINT, 8, "COUNT_B"}})};
+
+  // 5) Finally, the aggregation node
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::SORTED)};
+
+  // 6) The scan that feeds the aggregation
+  std::unique_ptr<planner::AbstractPlan> scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(test_table_oids[1]), nullptr, {0, 1})};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // Compile and run
+  CompileAndExecute(*agg_plan, buffer);
+
+  // Check results
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(1, results.size());
+  EXPECT_TRUE(results[0].GetValue(0).IsNull());
+  EXPECT_TRUE(results[0].GetValue(1).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(num_rows)) ==
+              CmpBool::CmpTrue);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -127,5 +127,175 @@ TEST_F(HashJoinTranslatorTest, SingleHashJoinColumnTest) {
   }
 }
 
+TEST_F(HashJoinTranslatorTest, ParallelBuildTest) {
+  //
+  // SELECT
+  //   left_table.a, right_table.a, left_table.b, right_table.c,
+  // FROM
+  //   left_table
+  // JOIN
+  //   right_table ON left_table.a = right_table.a
+  //
+  // The left table is scanned in parallel, so every thread builds its own
+  // hash table and bloom filter, which are merged before the probe starts.
+  //
+
+  // Grow the build side over many tile groups
+  LoadTestTable(LeftTableId(), 980);
+
+  // Projection:  [left_table.a, right_table.a, left_table.b, right_table.c]
+  DirectMap dm1 = std::make_pair(0, std::make_pair(0, 0));
+  DirectMap dm2 = std::make_pair(1, std::make_pair(1, 0));
+  DirectMap dm3 = std::make_pair(2, std::make_pair(0, 1));
+  DirectMap dm4 = std::make_pair(3, std::make_pair(1, 2));
+  DirectMapList direct_map_list = {dm1, dm2, dm3, dm4};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // Output schema
+  auto schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(1),
+                           TestingExecutorUtil::GetColumnInfo(2)}));
+
+  // Left and right hash keys
+  std::vector<ConstExpressionPtr> left_hash_keys;
+  left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<ConstExpressionPtr> right_hash_keys;
+  right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<ConstExpressionPtr> hash_keys;
+  hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  // The join node, with a bloom filter
+  std::unique_ptr<planner::HashJoinPlan> hj_plan{
+      new planner::HashJoinPlan(JoinType::INNER, nullptr, std::move(projection),
+                                schema, left_hash_keys, right_hash_keys, true)};
+  std::unique_ptr<planner::HashPlan> hash_plan{
+      new planner::HashPlan(hash_keys)};
+
+  std::unique_ptr<planner::AbstractPlan> left_scan{
+      new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2}, false,
+                               true)};
+  std::unique_ptr<planner::AbstractPlan> right_scan{
+      new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})};
+
+  hash_plan->AddChild(std::move(right_scan));
+  hj_plan->AddChild(std::move(left_scan));
+  hj_plan->AddChild(std::move(hash_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  hj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and run
+  auto stats = CompileAndExecute(*hj_plan, buffer);
+
+  // The build side ran in parallel
+  EXPECT_EQ(1u, stats.compile_stats.num_parallel_pipelines);
+
+  // Check results
+  const auto &results = buffer.GetOutputTuples();
+  // The left table has 1000 rows, each of the 80 rows on the right matches one
+  EXPECT_EQ(80, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, RadixPartitionedJoinTest) {
+  //
+  // SELECT
+  //   left_table.a, right_table.a, left_table.b, right_table.c,
+  // FROM
+  //   left_table
+  // JOIN
+  //   right_table ON left_table.a = right_table.a
+  //
+  // Both sides are radix partitioned before they're joined. The build side is
+  // scanned in parallel, and so partitioned out of the thread-local tables.
+  //
+
+  // Grow the build side over many tile groups
+  LoadTestTable(LeftTableId(), 980);
+
+  // Projection:  [left_table.a, right_table.a, left_table.b, right_table.c]
+  DirectMap dm1 = std::make_pair(0, std::make_pair(0, 0));
+  DirectMap dm2 = std::make_pair(1, std::make_pair(1, 0));
+  DirectMap dm3 = std::make_pair(2, std::make_pair(0, 1));
+  DirectMap dm4 = std::make_pair(3, std::make_pair(1, 2));
+  DirectMapList direct_map_list = {dm1, dm2, dm3, dm4};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // Output schema
+  auto schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(1),
+                           TestingExecutorUtil::GetColumnInfo(2)}));
+
+  // Left and right hash keys
+  std::vector<ConstExpressionPtr> left_hash_keys;
+  left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<ConstExpressionPtr> right_hash_keys;
+  right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<ConstExpressionPtr> hash_keys;
+  hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  // The join node, partitioning both sides eight ways
+  std::unique_ptr<planner::HashJoinPlan> hj_plan{
+      new planner::HashJoinPlan(JoinType::INNER, nullptr, std::move(projection),
+                                schema, left_hash_keys, right_hash_keys, true)};
+  hj_plan->SetRadixPartitionBits(3);
+  std::unique_ptr<planner::HashPlan> hash_plan{
+      new planner::HashPlan(hash_keys)};
+
+  std::unique_ptr<planner::AbstractPlan> left_scan{
+      new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2}, false,
+                               true)};
+  std::unique_ptr<planner::AbstractPlan> right_scan{
+      new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})};
+
+  hash_plan->AddChild(std::move(right_scan));
+  hj_plan->AddChild(std::move(left_scan));
+  hj_plan->AddChild(std::move(hash_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  hj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and run
+  auto stats = CompileAndExecute(*hj_plan, buffer);
+
+  // The build side ran in parallel, so the partitions came out of the
+  // thread-local tables
+  EXPECT_EQ(1u, stats.compile_stats.num_parallel_pipelines);
+
+  // Check results
+  const auto &results = buffer.GetOutputTuples();
+  // The left table has 1000 rows, each of the 80 rows on the right matches one
+  EXPECT_EQ(80, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+    // The right-side values are restored from the partitions
+    auto right_c = type::ValueFactory::GetDecimalValue(
+        tuple.GetValue(1).GetAs<int32_t>() + 2);
+    EXPECT_EQ(CmpBool::CmpTrue, tuple.GetValue(3).CompareEquals(right_c));
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -221,6 +221,59 @@ TEST_F(HashTableTest, CanInsertLazilyWithDups) {
   }
 }
 
+TEST_F(HashTableTest, RadixPartition) {
+  codegen::util::HashTable table{GetMemPool(), sizeof(Key), sizeof(Value)};
+
+  constexpr uint32_t to_insert = 50000;
+  constexpr uint32_t num_partition_bits = 4;
+  constexpr uint32_t c1 = 4444;
+
+  // Partitions are chosen on the high bits of the hash, spread them out
+  auto hash_fn = [](const Key &k) { return k.Hash() * 0x9E3779B97F4A7C15ull; };
+
+  std::vector<Key> keys;
+  for (uint32_t i = 0; i < to_insert; i++) {
+    Key k{i % 7, i};
+    Value v = {.v1 = k.k2, .v2 = 2, .v3 = 3, .v4 = c1};
+    table.TypedInsertLazy(hash_fn(k), k, v);
+    keys.emplace_back(k);
+  }
+
+  table.PartitionLazy(num_partition_bits);
+  EXPECT_EQ(1u << num_partition_bits, table.NumPartitions());
+  EXPECT_EQ(to_insert, table.NumElements());
+
+  // Every entry is in the partition of its hash, and every entry is somewhere
+  uint32_t num_entries = 0;
+  for (uint32_t part = 0; part < table.NumPartitions(); part++) {
+    for (auto *entry = table.GetPartitionHead(part); entry != nullptr;
+         entry = entry->next) {
+      EXPECT_EQ(part, entry->hash >> (64 - num_partition_bits));
+      num_entries++;
+    }
+  }
+  EXPECT_EQ(to_insert, num_entries);
+
+  // Lookups succeed on the partition of the key
+  std::vector<std::vector<Key>> partition_keys{table.NumPartitions()};
+  for (const auto &key : keys) {
+    partition_keys[hash_fn(key) >> (64 - num_partition_bits)].push_back(key);
+  }
+  for (uint32_t part = 0; part < table.NumPartitions(); part++) {
+    table.BuildPartition(part);
+    for (const auto &key : partition_keys[part]) {
+      uint32_t count = 0;
+      std::function<void(const Value &v)> f = [&key, &count](const Value &v) {
+        EXPECT_EQ(key.k2, v.v1)
+            << "Value's [v1] found in table doesn't match insert key";
+        count++;
+      };
+      table.TypedProbe(hash_fn(key), key, f);
+      EXPECT_EQ(1u, count) << key << " found " << count << " times ...";
+    }
+  }
+}
+
 TEST_F(HashTableTest, ParallelMerge) {
   constexpr uint32_t num_threads = 4;
   constexpr uint32_t to_insert = 20000;
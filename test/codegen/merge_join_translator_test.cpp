@@ -0,0 +1,209 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator_test.cpp
+//
+// Identification: test/codegen/merge_join_translator_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "expression/comparison_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/merge_join_plan.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class MergeJoinTranslatorTest : public PelotonCodeGenTest {
+ public:
+  MergeJoinTranslatorTest() : PelotonCodeGenTest() {
+    // Load the test tables. Both are scanned in the order of their first
+    // column, which is what the join is performed on.
+    uint32_t num_rows = 10;
+    LoadTestTable(LeftTableId(), 2 * num_rows);
+    LoadTestTable(RightTableId(), 8 * num_rows);
+  }
+
+  oid_t LeftTableId() const { return test_table_oids[0]; }
+
+  oid_t RightTableId() const { return test_table_oids[1]; }
+
+  storage::DataTable &GetLeftTable() const {
+    return GetTestTable(LeftTableId());
+  }
+
+  storage::DataTable &GetRightTable() const {
+    return GetTestTable(RightTableId());
+  }
+
+  // SELECT left_table.a, right_table.a, left_table.b, right_table.c
+  // FROM left_table JOIN right_table ON left_table.a = right_table.a
+  // [AND predicate]
+  std::unique_ptr<planner::MergeJoinPlan> BuildJoinPlan(
+      ExpressionPtr &&predicate) {
+    return BuildJoinPlan(ColRefExpr(type::TypeId::INTEGER, true, 0),
+                         ColRefExpr(type::TypeId::INTEGER, false, 0),
+                         std::move(predicate));
+  }
+
+  // SELECT left_table.a, right_table.a, left_table.b, right_table.c
+  // FROM left_table JOIN right_table ON left_key = right_key [AND predicate]
+  std::unique_ptr<planner::MergeJoinPlan> BuildJoinPlan(
+      ExpressionPtr &&left_key, ExpressionPtr &&right_key,
+      ExpressionPtr &&predicate) {
+    // Projection:  [left_table.a, right_table.a, left_table.b, right_table.c]
+    DirectMap dm1 = std::make_pair(0, std::make_pair(0, 0));
+    DirectMap dm2 = std::make_pair(1, std::make_pair(1, 0));
+    DirectMap dm3 = std::make_pair(2, std::make_pair(0, 1));
+    DirectMap dm4 = std::make_pair(3, std::make_pair(1, 2));
+    DirectMapList direct_map_list = {dm1, dm2, dm3, dm4};
+    std::unique_ptr<planner::ProjectInfo> projection{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+    // Output schema
+    auto schema = std::shared_ptr<const catalog::Schema>(
+        new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(1),
+                             TestingExecutorUtil::GetColumnInfo(2)}));
+
+    // The join clause
+    std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+    join_clauses.emplace_back(left_key.release(), right_key.release(), false);
+
+    std::unique_ptr<const expression::AbstractExpression> join_predicate{
+        predicate.release()};
+    std::unique_ptr<planner::MergeJoinPlan> mj_plan{new planner::MergeJoinPlan(
+        JoinType::INNER, std::move(join_predicate), std::move(projection),
+        schema, join_clauses)};
+
+    std::unique_ptr<planner::AbstractPlan> left_scan{
+        new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2})};
+    std::unique_ptr<planner::AbstractPlan> right_scan{
+        new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})};
+
+    mj_plan->AddChild(std::move(left_scan));
+    mj_plan->AddChild(std::move(right_scan));
+    return mj_plan;
+  }
+};
+
+TEST_F(MergeJoinTranslatorTest, SingleMergeJoinColumnTest) {
+  auto mj_plan = BuildJoinPlan(nullptr);
+
+  // Do binding
+  planner::BindingContext context;
+  mj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and run
+  CompileAndExecute(*mj_plan, buffer);
+
+  // Check results
+  const auto &results = buffer.GetOutputTuples();
+  // The left table has 20 rows, the right has 80, all of the left ones match
+  ASSERT_EQ(20, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    const auto &tuple = results[i];
+
+    // Check that the joins keys are actually equal
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+
+    // The output is produced in the order of the keys
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(0).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(10 * i)));
+  }
+}
+
+TEST_F(MergeJoinTranslatorTest, MergeJoinWithPredicateTest) {
+  // ... AND left_table.b >= 101
+  auto left_b_col = ColRefExpr(type::TypeId::INTEGER, true, 1);
+  auto predicate = CmpGteExpr(std::move(left_b_col), ConstIntExpr(101));
+  auto mj_plan = BuildJoinPlan(std::move(predicate));
+
+  // Do binding
+  planner::BindingContext context;
+  mj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and run
+  CompileAndExecute(*mj_plan, buffer);
+
+  // Check results. Only the last 10 rows of the left table pass the predicate.
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(10, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(2).CompareGreaterThanEquals(
+                  type::ValueFactory::GetIntegerValue(101)));
+  }
+}
+
+TEST_F(MergeJoinTranslatorTest, MergeJoinDuplicateKeysTest) {
+  // ... ON left_table.a / 30 = right_table.a / 30
+  // Every key appears three times on both sides, except the last key of the
+  // left table which appears twice
+  auto left_key =
+      OpExpr(ExpressionType::OPERATOR_DIVIDE, type::TypeId::INTEGER,
+             ColRefExpr(type::TypeId::INTEGER, true, 0), ConstIntExpr(30));
+  auto right_key =
+      OpExpr(ExpressionType::OPERATOR_DIVIDE, type::TypeId::INTEGER,
+             ColRefExpr(type::TypeId::INTEGER, false, 0), ConstIntExpr(30));
+  auto mj_plan =
+      BuildJoinPlan(std::move(left_key), std::move(right_key), nullptr);
+
+  // Do binding
+  planner::BindingContext context;
+  mj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and run
+  CompileAndExecute(*mj_plan, buffer);
+
+  // Check results. The left keys are 0 to 6, each of them matches every
+  // right tuple with the same key.
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(3 * (6 * 3 + 2), results.size());
+
+  std::map<int32_t, uint32_t> matches;
+  int32_t last_key = 0;
+  for (const auto &tuple : results) {
+    int32_t left_key_val = tuple.GetValue(0).GetAs<int32_t>() / 30;
+    int32_t right_key_val = tuple.GetValue(1).GetAs<int32_t>() / 30;
+    EXPECT_EQ(left_key_val, right_key_val);
+
+    // The output is produced in the order of the keys
+    EXPECT_LE(last_key, left_key_val);
+    last_key = left_key_val;
+    matches[left_key_val]++;
+  }
+
+  ASSERT_EQ(7, matches.size());
+  for (int32_t key = 0; key < 6; key++) {
+    EXPECT_EQ(9, matches[key]);
+  }
+  EXPECT_EQ(6, matches[6]);
+}
+
+}  // namespace test
+}  // namespace peloton
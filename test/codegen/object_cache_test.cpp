@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache_test.cpp
+//
+// Identification: test/codegen/object_cache_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <boost/filesystem.hpp>
+
+#include "codegen/codegen.h"
+#include "codegen/function_builder.h"
+#include "codegen/object_cache.h"
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+class ObjectCacheTest : public PelotonTest {
+ public:
+  ObjectCacheTest()
+      : directory_(boost::filesystem::temp_directory_path() /
+                   boost::filesystem::unique_path("peloton_cache_%%%%%%%%")) {}
+
+  ~ObjectCacheTest() { boost::filesystem::remove_all(directory_); }
+
+  std::string GetDirectory() const { return directory_.string(); }
+
+  size_t NumCachedObjects() const {
+    if (!boost::filesystem::exists(directory_)) {
+      return 0;
+    }
+    return std::distance(boost::filesystem::directory_iterator{directory_},
+                         boost::filesystem::directory_iterator{});
+  }
+
+ private:
+  boost::filesystem::path directory_;
+};
+
+namespace {
+
+// Generate a function like so:
+// define i32 @add(i32 %a) {
+//   %tmp = add i32 %a, i32 <summand>
+//   ret i32 %tmp;
+// }
+llvm::Function *BuildAddFunction(codegen::CodeContext &code_context,
+                                 uint32_t summand) {
+  codegen::CodeGen cg{code_context};
+  codegen::FunctionBuilder func{
+      code_context, "add", cg.Int32Type(), {{"a", cg.Int32Type()}}};
+  {
+    auto *a = func.GetArgumentByPosition(0);
+    func.ReturnAndFinish(cg->CreateAdd(a, cg.Const32(summand)));
+  }
+  return func.GetFunction();
+}
+
+using add_func_t = int (*)(int);
+
+}  // namespace
+
+TEST_F(ObjectCacheTest, LoadCompiledCode) {
+  // The first compilation stores the code in the cache
+  {
+    codegen::CodeContext code_context;
+    auto *func = BuildAddFunction(code_context, 44);
+    EXPECT_FALSE(code_context.EnableObjectCache(GetDirectory()));
+    code_context.Compile();
+
+    auto fn = (add_func_t)code_context.GetRawFunctionPointer(func);
+    EXPECT_EQ(46, fn(2));
+  }
+  EXPECT_EQ(1u, NumCachedObjects());
+
+  // The same code is found in the cache
+  {
+    codegen::CodeContext code_context;
+    auto *func = BuildAddFunction(code_context, 44);
+    EXPECT_TRUE(code_context.EnableObjectCache(GetDirectory()));
+    code_context.Compile();
+
+    auto fn = (add_func_t)code_context.GetRawFunctionPointer(func);
+    EXPECT_EQ(46, fn(2));
+  }
+  EXPECT_EQ(1u, NumCachedObjects());
+
+  // Different code isn't
+  {
+    codegen::CodeContext code_context;
+    auto *func = BuildAddFunction(code_context, 10);
+    EXPECT_FALSE(code_context.EnableObjectCache(GetDirectory()));
+    code_context.Compile();
+
+    auto fn = (add_func_t)code_context.GetRawFunctionPointer(func);
+    EXPECT_EQ(12, fn(2));
+  }
+  EXPECT_EQ(2u, NumCachedObjects());
+}
+
+TEST_F(ObjectCacheTest, SkipCodeWithAddresses) {
+  // Code that embeds an address of this process must not be cached
+  int value = 44;
+
+  codegen::CodeContext code_context;
+  codegen::CodeGen cg{code_context};
+  codegen::FunctionBuilder func{code_context, "get", cg.Int32Type(), {}};
+  {
+    auto *ptr = cg->CreateIntToPtr(cg.Const64((int64_t)&value),
+                                   cg.Int32Type()->getPointerTo());
+    func.ReturnAndFinish(cg->CreateLoad(ptr));
+  }
+
+  EXPECT_FALSE(codegen::ObjectCache::IsCacheable(code_context.GetModule()));
+  EXPECT_FALSE(code_context.EnableObjectCache(GetDirectory()));
+  code_context.Compile();
+
+  using get_func_t = int (*)();
+  auto fn = (get_func_t)code_context.GetRawFunctionPointer(func.GetFunction());
+  EXPECT_EQ(44, fn());
+  EXPECT_EQ(0u, NumCachedObjects());
+}
+
+}  // namespace test
+}  // namespace peloton
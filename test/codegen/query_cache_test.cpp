@@ -25,6 +25,7 @@
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace test {
@@ -286,6 +287,45 @@ TEST_F(QueryCacheTest, SimpleCache) {
   EXPECT_EQ(0, codegen::QueryCache::Instance().GetCount());
 }
 
+TEST_F(QueryCacheTest, TieredCompilation) {
+  settings::SettingsManager::SetBool(
+      settings::SettingId::codegen_tiered_compilation, true);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::codegen_tier_up_threshold, 2);
+
+  // SELECT b FROM table where a >= 40;
+  std::shared_ptr<planner::SeqScanPlan> scan = GetSeqScanPlan();
+  planner::BindingContext context;
+  scan->PerformBinding(context);
+
+  // The first executions use the code compiled without optimizations, the
+  // second cache hit makes the query hot
+  bool cached;
+  for (uint32_t i = 0; i < 3; i++) {
+    codegen::BufferingConsumer buffer{{0}, context};
+    CompileAndExecuteCache(scan, buffer, cached);
+    EXPECT_EQ(i > 0, cached);
+    EXPECT_EQ(NumRowsInTestTable() - 4, buffer.GetOutputTuples().size());
+  }
+
+  auto *query = codegen::QueryCache::Instance().Find(scan);
+  ASSERT_NE(nullptr, query);
+  query->WaitForBackgroundCompilation();
+  EXPECT_TRUE(query->IsOptimized());
+
+  // The optimized code produces the same results
+  codegen::BufferingConsumer buffer{{0}, context};
+  CompileAndExecuteCache(scan, buffer, cached);
+  EXPECT_TRUE(cached);
+  EXPECT_EQ(NumRowsInTestTable() - 4, buffer.GetOutputTuples().size());
+
+  settings::SettingsManager::SetBool(
+      settings::SettingId::codegen_tiered_compilation, false);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::codegen_tier_up_threshold, 100);
+  codegen::QueryCache::Instance().Clear();
+}
+
 TEST_F(QueryCacheTest, SimpleCacheWithDiffPredicate) {
   std::shared_ptr<planner::SeqScanPlan> scan_a = GetSeqScanPlanA(false);
 
@@ -15,9 +15,11 @@
 #include "codegen/query_compiler.h"
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
 #include "expression/conjunction_expression.h"
 #include "expression/operator_expression.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
 #include "storage/storage_manager.h"
 #include "storage/table_factory.h"
 
@@ -851,5 +853,56 @@ TEST_F(TableScanTranslatorTest, MultiLayoutScan) {
   }
 }
 
+TEST_F(TableScanTranslatorTest, AdaptiveScanSwitchesToNative) {
+  //
+  // Scans a large table with adaptive execution. The query starts out in the
+  // interpreter while it is compiled in the background, and the scan moves on
+  // to the compiled code for the morsels left once that is done.
+  //
+  uint32_t tuples_per_tilegroup = 100;
+  uint32_t tilegroup_count = 1000;
+  uint32_t column_count = 10;
+  bool is_inlined = true;
+  CreateAndLoadTableWithLayout(LayoutType::ROW, tuples_per_tilegroup,
+                               tilegroup_count, column_count, is_inlined);
+
+  settings::SettingsManager::SetBool(settings::SettingId::codegen_adaptive,
+                                     true);
+
+  std::vector<oid_t> column_ids;
+  for (oid_t col_id = 0; col_id < column_count; col_id++) {
+    column_ids.push_back(col_id);
+  }
+  planner::SeqScanPlan scan(GetLayoutTable(), nullptr, column_ids);
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+  codegen::BufferingConsumer buffer{column_ids, context};
+
+  // Compile the query, but leave the native code to its first execution
+  codegen::QueryParameters parameters(scan, {});
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+  auto query = codegen::QueryCompiler().Compile(
+      scan, parameters.GetQueryParametersMap(), buffer);
+  executor::ExecutorContext exec_ctx{txn, std::move(parameters)};
+
+  codegen::Query::RuntimeStats stats;
+  query->Execute(exec_ctx, buffer, &stats);
+  txn_manager.CommitTransaction(txn);
+
+  // The scan finished in native code, and produced every tuple once
+  EXPECT_GT(stats.num_native_calls, 0u);
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(tuples_per_tilegroup * tilegroup_count, results.size());
+  for (oid_t tuple_id = 0; tuple_id < results.size(); tuple_id++) {
+    auto value = type::ValueFactory::GetIntegerValue(tuple_id);
+    EXPECT_EQ(CmpBool::CmpTrue,
+              results[tuple_id].GetValue(0).CompareEquals(value));
+  }
+
+  settings::SettingsManager::SetBool(settings::SettingId::codegen_adaptive,
+                                     false);
+}
+
 }  // namespace test
 }  // namespace peloton
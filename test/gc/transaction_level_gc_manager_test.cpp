@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <future>
+#include <thread>
+
 #include "concurrency/testing_transaction_util.h"
 #include "executor/testing_executor_util.h"
 #include "common/harness.h"
@@ -17,6 +21,9 @@
 #include "concurrency/epoch_manager.h"
 
 #include "catalog/catalog.h"
+#include "codegen/transaction_runtime.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/database.h"
@@ -493,5 +500,172 @@ TEST_F(TransactionLevelGCManagerTests, ImmutabilityTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// the garbage unlinked is recorded along with how long it waited
+TEST_F(TransactionLevelGCManagerTests, GCMetricTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  settings::SettingsManager::SetInt(settings::SettingId::stats_mode,
+                                    static_cast<int>(StatsType::ENABLE));
+  auto &gc_metric = stats::BackendStatsContext::GetInstance()->GetGCMetric();
+  gc_metric.Reset();
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto database = TestingExecutorUtil::InitializeDatabase("gcmetricdb");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      1, "TABLE2", db_id, 12348, 1234, true));
+
+  // the update ends in epoch 1 and is unlinked in epoch 3
+  auto ret = UpdateTuple(table.get(), 0);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  epoch_manager.SetCurrentEpochId(3);
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(1, gc_manager.Unlink(0, expired_eid));
+
+  EXPECT_EQ(1, gc_metric.GetUnlinkedTxns().GetCounter());
+  EXPECT_EQ(2, gc_metric.GetLagEpochs().GetCounter());
+  EXPECT_EQ(0, gc_metric.GetCooperativeTxns().GetCounter());
+
+  epoch_manager.SetCurrentEpochId(4);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(1, gc_manager.Reclaim(0, expired_eid));
+
+  settings::SettingsManager::SetInt(settings::SettingId::stats_mode,
+                                    static_cast<int>(StatsType::INVALID));
+  gc_metric.Reset();
+
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  TestingExecutorUtil::DeleteDatabase("gcmetricdb");
+}
+
+// scan the table the way compiled scans do, returning the visible tuples
+size_t ScanTable(storage::DataTable *table,
+                 concurrency::TransactionContext *txn) {
+  size_t visible_count = 0;
+  std::vector<uint32_t> selection_vector;
+  for (size_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    uint32_t tuple_count = std::min(tile_group->GetNextTupleSlot(),
+                                    tile_group->GetAllocatedTupleCount());
+    selection_vector.resize(tuple_count);
+    visible_count += codegen::TransactionRuntime::PerformVisibilityCheck(
+        *txn, *tile_group, 0, tuple_count, selection_vector.data());
+  }
+  return visible_count;
+}
+
+// a transaction that skips a lot of garbage unlinks queued garbage as it
+// ends, unless the gc thread is working on its queues
+TEST_F(TransactionLevelGCManagerTests, CooperativeGCTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  settings::SettingsManager::SetInt(settings::SettingId::stats_mode,
+                                    static_cast<int>(StatsType::ENABLE));
+  settings::SettingsManager::SetInt(
+      settings::SettingId::gc_cooperative_threshold, 5);
+  auto &gc_metric = stats::BackendStatsContext::GetInstance()->GetGCMetric();
+  gc_metric.Reset();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto database = TestingExecutorUtil::InitializeDatabase("cooperativegcdb");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      1, "TABLE3", db_id, 12349, 1234, true));
+
+  //===========================
+  // the gc thread holds the latch.
+  //===========================
+  const int num_updates = 10;
+  for (int i = 0; i < num_updates; i++) {
+    EXPECT_TRUE(UpdateTuple(table.get(), 0) == ResultType::SUCCESS);
+  }
+  epoch_manager.SetCurrentEpochId(3);
+
+  std::promise<void> latch_taken, latch_released;
+  std::thread gc_thread([&gc_manager, &latch_taken, &latch_released] {
+    std::lock_guard<std::mutex> lock(gc_manager.GetPartitionLatch(0));
+    latch_taken.set_value();
+    latch_released.get_future().wait();
+  });
+  latch_taken.get_future().wait();
+
+  // the scan skips every replaced version
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(1, ScanTable(table.get(), txn));
+  EXPECT_EQ(num_updates, txn->GetGarbageVersionCount());
+  txn_manager.CommitTransaction(txn);
+
+  latch_released.set_value();
+  gc_thread.join();
+
+  EXPECT_EQ(0, gc_metric.GetUnlinkedTxns().GetCounter());
+  EXPECT_EQ(0, gc_metric.GetCooperativeTxns().GetCounter());
+
+  // so the gc thread unlinks the garbage itself
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(num_updates, gc_manager.Unlink(0, expired_eid));
+  EXPECT_EQ(num_updates, gc_metric.GetUnlinkedTxns().GetCounter());
+  EXPECT_EQ(0, gc_metric.GetCooperativeTxns().GetCounter());
+
+  epoch_manager.SetCurrentEpochId(4);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(num_updates, gc_manager.Reclaim(0, expired_eid));
+
+  //===========================
+  // the latch is free.
+  //===========================
+  for (int i = 0; i < num_updates; i++) {
+    EXPECT_TRUE(UpdateTuple(table.get(), 0) == ResultType::SUCCESS);
+  }
+  epoch_manager.SetCurrentEpochId(6);
+  // the gc thread finds the expired epoch that the scanning transaction uses
+  epoch_manager.GetExpiredEpochId();
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(1, ScanTable(table.get(), txn));
+  EXPECT_EQ(num_updates, txn->GetGarbageVersionCount());
+  txn_manager.CommitTransaction(txn);
+
+  // the scanning transaction unlinked the garbage as it ended
+  EXPECT_EQ(2 * num_updates, gc_metric.GetUnlinkedTxns().GetCounter());
+  EXPECT_EQ(num_updates, gc_metric.GetCooperativeTxns().GetCounter());
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(0, gc_manager.Unlink(0, expired_eid));
+
+  epoch_manager.SetCurrentEpochId(7);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(num_updates, gc_manager.Reclaim(0, expired_eid));
+
+  settings::SettingsManager::SetInt(
+      settings::SettingId::gc_cooperative_threshold, 1000);
+  settings::SettingsManager::SetInt(settings::SettingId::stats_mode,
+                                    static_cast<int>(StatsType::INVALID));
+  gc_metric.Reset();
+
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  TestingExecutorUtil::DeleteDatabase("cooperativegcdb");
+}
+
 }  // namespace test
 }  // namespace peloton
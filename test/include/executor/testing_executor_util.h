@@ -73,7 +73,8 @@ class TestingExecutorUtil {
   /** @brief Creates a basic table with allocated but not populated tuples */
   static storage::DataTable *CreateTable(
       int tuples_per_tilegroup_count = TESTS_TUPLES_PER_TILEGROUP,
-      bool indexes = true, oid_t table_oid = INVALID_OID);
+      bool indexes = true, oid_t table_oid = INVALID_OID,
+      oid_t database_oid = INVALID_OID);
 
   /**
    * @brief Creates a basic table and adds its entry to the catalog
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index_test.cpp
+//
+// Identification: test/index/hash_index_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "gtest/gtest.h"
+
+#include "index/testing_index_util.h"
+#include "index/index.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Hash Index Tests
+//===--------------------------------------------------------------------===//
+
+class HashIndexTests : public PelotonTest {};
+
+TEST_F(HashIndexTests, BasicTest) {
+  TestingIndexUtil::BasicTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, MultiMapInsertTest) {
+  TestingIndexUtil::MultiMapInsertTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, UniqueKeyInsertTest) {
+  TestingIndexUtil::UniqueKeyInsertTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, UniqueKeyDeleteTest) {
+  TestingIndexUtil::UniqueKeyDeleteTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, NonUniqueKeyDeleteTest) {
+  TestingIndexUtil::NonUniqueKeyDeleteTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, MultiThreadedInsertTest) {
+  TestingIndexUtil::MultiThreadedInsertTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, UniqueKeyMultiThreadedTest) {
+  TestingIndexUtil::UniqueKeyMultiThreadedTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, NonUniqueKeyMultiThreadedTest) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, NonUniqueKeyMultiThreadedStressTest) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, MemoryFootprintTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::unique_ptr<index::Index, void (*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(IndexType::HASH, false),
+      TestingIndexUtil::DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+  key0->SetValue(0, type::ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+
+  // The empty map already has its slots
+  size_t empty_size = index->GetMemoryFootprint();
+  EXPECT_LT(0, empty_size);
+
+  // Every value of a key is counted
+  index->InsertEntry(key0.get(), TestingIndexUtil::item0.get());
+  index->InsertEntry(key0.get(), TestingIndexUtil::item1.get());
+  EXPECT_EQ(empty_size + 2 * sizeof(ItemPointer *),
+            index->GetMemoryFootprint());
+
+  // A value that is not there does not change anything
+  index->DeleteEntry(key0.get(), TestingIndexUtil::item2.get());
+  EXPECT_EQ(empty_size + 2 * sizeof(ItemPointer *),
+            index->GetMemoryFootprint());
+
+  index->DeleteEntry(key0.get(), TestingIndexUtil::item0.get());
+  index->DeleteEntry(key0.get(), TestingIndexUtil::item1.get());
+  EXPECT_EQ(empty_size, index->GetMemoryFootprint());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -14,7 +14,10 @@
 #include "gtest/gtest.h"
 
 #include "common/internal_types.h"
+#include "index/index.h"
 #include "index/testing_index_util.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace test {
@@ -26,45 +29,104 @@ namespace test {
 class SkipListIndexTests : public PelotonTest {};
 
 TEST_F(SkipListIndexTests, BasicTest) {
-  // TestingIndexUtil::BasicTest(IndexType::SKIPLIST);
-  EXPECT_EQ(2, 1+1);
+  TestingIndexUtil::BasicTest(IndexType::SKIPLIST);
 }
 
-//TEST_F(SkipListIndexTests, MultiMapInsertTest) {
-//  TestingIndexUtil::MultiMapInsertTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, UniqueKeyInsertTest) {
-//  TestingIndexUtil::UniqueKeyInsertTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, UniqueKeyDeleteTest) {
-//  TestingIndexUtil::UniqueKeyDeleteTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, NonUniqueKeyDeleteTest) {
-//  TestingIndexUtil::NonUniqueKeyDeleteTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, MultiThreadedInsertTest) {
-//  TestingIndexUtil::MultiThreadedInsertTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, UniqueKeyMultiThreadedTest) {
-//  TestingIndexUtil::UniqueKeyMultiThreadedTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedTest) {
-//  TestingIndexUtil::NonUniqueKeyMultiThreadedTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedStressTest) {
-//  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
-//  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::SKIPLIST);
-//}
+TEST_F(SkipListIndexTests, MultiMapInsertTest) {
+  TestingIndexUtil::MultiMapInsertTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, UniqueKeyInsertTest) {
+  TestingIndexUtil::UniqueKeyInsertTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, UniqueKeyDeleteTest) {
+  TestingIndexUtil::UniqueKeyDeleteTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, NonUniqueKeyDeleteTest) {
+  TestingIndexUtil::NonUniqueKeyDeleteTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, MultiThreadedInsertTest) {
+  TestingIndexUtil::MultiThreadedInsertTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, UniqueKeyMultiThreadedTest) {
+  TestingIndexUtil::UniqueKeyMultiThreadedTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedTest) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedStressTest) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::SKIPLIST);
+}
+
+// Forward scans return the keys in ascending order, backward scans in
+// descending order
+TEST_F(SkipListIndexTests, ScanDirectionTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer *> location_ptrs;
+
+  std::unique_ptr<index::Index, void (*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(IndexType::SKIPLIST, false),
+      TestingIndexUtil::DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // Insert the keys out of order, and remember the key in the item pointer
+  const int key_count = 100;
+  std::vector<std::unique_ptr<ItemPointer>> items;
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (int i = 0; i < key_count; i++) {
+    int key_value = (i * 37) % key_count;
+    items.emplace_back(new ItemPointer(key_value, 0));
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(key_value), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    EXPECT_TRUE(index->InsertEntry(key.get(), items.back().get()));
+  }
+
+  auto low_value = type::ValueFactory::GetIntegerValue(10);
+  index->ScanTest({low_value}, {0},
+                  {ExpressionType::COMPARE_GREATERTHANOREQUALTO},
+                  ScanDirectionType::FORWARD, location_ptrs);
+  EXPECT_EQ(key_count - 10, location_ptrs.size());
+  for (size_t i = 0; i < location_ptrs.size(); i++) {
+    EXPECT_EQ(10 + i, location_ptrs[i]->block);
+  }
+  location_ptrs.clear();
+
+  index->ScanTest({low_value}, {0},
+                  {ExpressionType::COMPARE_GREATERTHANOREQUALTO},
+                  ScanDirectionType::BACKWARD, location_ptrs);
+  EXPECT_EQ(key_count - 10, location_ptrs.size());
+  for (size_t i = 0; i < location_ptrs.size(); i++) {
+    EXPECT_EQ(key_count - 1 - i, location_ptrs[i]->block);
+  }
+  location_ptrs.clear();
+
+  // Deleted keys are skipped in both directions
+  for (int key_value = 0; key_value < key_count; key_value += 2) {
+    ItemPointer item(key_value, 0);
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(key_value), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    EXPECT_TRUE(index->DeleteEntry(key.get(), &item));
+  }
+
+  index->ScanTest({low_value}, {0},
+                  {ExpressionType::COMPARE_GREATERTHANOREQUALTO},
+                  ScanDirectionType::BACKWARD, location_ptrs);
+  EXPECT_EQ((key_count - 10) / 2, location_ptrs.size());
+  for (size_t i = 0; i < location_ptrs.size(); i++) {
+    EXPECT_EQ(key_count - 1 - 2 * i, location_ptrs[i]->block);
+  }
+  location_ptrs.clear();
+}
 
 }  // namespace test
 }  // namespace peloton
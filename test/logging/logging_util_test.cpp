@@ -1,35 +1,35 @@
-// //===----------------------------------------------------------------------===//
-// //
-// //                         Peloton
-// //
-// // logging_util_test.cpp
-// //
-// // Identification: test/logging/logging_util_test.cpp
-// //
-// // Copyright (c) 2015-16, Carnegie Mellon University Database Group
-// //
-// //===----------------------------------------------------------------------===//
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logging_util_test.cpp
+//
+// Identification: test/logging/logging_util_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
 
 
-// #include "common/harness.h"
+#include "common/harness.h"
 
-// #include "logging/logging_util.h"
+#include "logging/logging_util.h"
 
-// namespace peloton {
-// namespace test {
+namespace peloton {
+namespace test {
 
-// //===--------------------------------------------------------------------===//
-// // Logging Tests
-// //===--------------------------------------------------------------------===//
-// class LoggingUtilTests : public PelotonTest {};
+//===--------------------------------------------------------------------===//
+// Logging Tests
+//===--------------------------------------------------------------------===//
+class LoggingUtilTests : public PelotonTest {};
 
-// TEST_F(LoggingUtilTests, BasicLoggingUtilTest) {
-//   auto status = logging::LoggingUtil::CreateDirectory("test_dir", 0700);
-//   EXPECT_TRUE(status);
+TEST_F(LoggingUtilTests, BasicLoggingUtilTest) {
+  auto status = logging::LoggingUtil::CreateDirectory("test_dir", 0700);
+  EXPECT_TRUE(status);
 
-//   status = logging::LoggingUtil::RemoveDirectory("test_dir", true);
-//   EXPECT_TRUE(status);
-// }
+  status = logging::LoggingUtil::RemoveDirectory("test_dir", true);
+  EXPECT_TRUE(status);
+}
 
-// }  // namespace test
-// }  // namespace peloton
+}  // namespace test
+}  // namespace peloton
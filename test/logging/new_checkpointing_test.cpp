@@ -10,8 +10,21 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fstream>
+#include <iterator>
+#include <thread>
+
 #include "logging/checkpoint_manager_factory.h"
 #include "common/harness.h"
+#include "catalog/schema.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "logging/log_manager_factory.h"
+#include "logging/logging_util.h"
+#include "storage/data_table.h"
+#include "type/serializeio.h"
+#include "type/value.h"
 
 namespace peloton {
 namespace test {
@@ -22,12 +35,201 @@ namespace test {
 
 class NewCheckpointingTests : public PelotonTest {};
 
+// Count the tuples in the checkpoint file of the table.
+int CountCheckpointTuples(const std::string &file_name,
+                          const catalog::Schema *schema) {
+  std::ifstream checkpoint_file(file_name, std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(checkpoint_file)),
+                       std::istreambuf_iterator<char>());
+
+  ReferenceSerializeInput input(contents.data(), contents.size());
+  int total_tuple_count = 0;
+  while (input.getRawPointer(0) < contents.data() + contents.size()) {
+    input.ReadInt();  // tile group id
+    int tuple_count = input.ReadInt();
+    for (int tuple_itr = 0; tuple_itr < tuple_count; ++tuple_itr) {
+      input.ReadInt();  // tuple slot
+      for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+           ++column_id) {
+        type::Value::DeserializeFrom(
+            input, schema->GetColumn(column_id).GetType(), nullptr);
+      }
+    }
+    total_tuple_count += tuple_count;
+  }
+  return total_tuple_count;
+}
+
 TEST_F(NewCheckpointingTests, MyTest) {
   auto &checkpoint_manager = logging::CheckpointManagerFactory::GetInstance();
   checkpoint_manager.Reset();
-  
+
   EXPECT_TRUE(true);
 }
 
+TEST_F(NewCheckpointingTests, SnapshotTest) {
+  std::string checkpoint_dir = "new_checkpointing_test_dir";
+  std::string db_name = "checkpoint_db";
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP * 2;
+
+  logging::CheckpointManagerFactory::Configure(1);
+  auto &checkpoint_manager = logging::LogicalCheckpointManager::GetInstance();
+  checkpoint_manager.Reset();
+  checkpoint_manager.SetDirectory(checkpoint_dir);
+
+  // the snapshot only covers the epochs that have finished.
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+  // the GC moves the snapshot epoch forward once the epochs have finished.
+  auto wait_for_epochs = [&epoch_manager] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH * 3));
+    epoch_manager.GetExpiredEpochId();
+  };
+
+  // tables are registered when they are created, and so are the catalog
+  // tables of the database.
+  size_t table_count = checkpoint_manager.GetTableCount();
+  TestingExecutorUtil::InitializeDatabase(db_name);
+  size_t catalog_table_count = checkpoint_manager.GetTableCount();
+  EXPECT_LT(table_count, catalog_table_count);
+  auto table = TestingExecutorUtil::CreateTableUpdateCatalog(
+      TESTS_TUPLES_PER_TILEGROUP, db_name);
+  EXPECT_EQ(catalog_table_count + 1, checkpoint_manager.GetTableCount());
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table, tuple_count, false, false, false,
+                                     txn);
+  txn_manager.CommitTransaction(txn);
+  wait_for_epochs();
+
+  // the checkpoint neither waits for nor includes an uncommitted writer.
+  auto writer_txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table, 1, false, false, false,
+                                     writer_txn);
+
+  cid_t checkpoint_cid = checkpoint_manager.DoCheckpoint();
+  EXPECT_NE(INVALID_CID, checkpoint_cid);
+  EXPECT_EQ(checkpoint_cid, checkpoint_manager.GetLastCheckpointCommitId());
+
+  txn_manager.CommitTransaction(writer_txn);
+  wait_for_epochs();
+
+  std::string checkpoint_file =
+      checkpoint_manager.GetCheckpointDirFullPath(checkpoint_cid) + "/" +
+      logging::LogicalCheckpointManager::GetCheckpointFileName(
+          table->GetDatabaseOid(), table->GetOid());
+  EXPECT_EQ(tuple_count,
+            CountCheckpointTuples(checkpoint_file, table->GetSchema()));
+
+  // a new checkpoint replaces the old one.
+  cid_t new_checkpoint_cid = checkpoint_manager.DoCheckpoint();
+  EXPECT_LT(checkpoint_cid, new_checkpoint_cid);
+  EXPECT_FALSE(logging::LoggingUtil::CheckDirectoryExistence(
+      checkpoint_manager.GetCheckpointDirFullPath(checkpoint_cid).c_str()));
+
+  checkpoint_file =
+      checkpoint_manager.GetCheckpointDirFullPath(new_checkpoint_cid) + "/" +
+      logging::LogicalCheckpointManager::GetCheckpointFileName(
+          table->GetDatabaseOid(), table->GetOid());
+  EXPECT_EQ(tuple_count + 1,
+            CountCheckpointTuples(checkpoint_file, table->GetSchema()));
+
+  TestingExecutorUtil::DeleteDatabase(db_name);
+  EXPECT_EQ(table_count, checkpoint_manager.GetTableCount());
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  checkpoint_manager.Reset();
+  logging::CheckpointManagerFactory::Configure(0);
+  logging::LoggingUtil::RemoveDirectory(
+      checkpoint_manager.GetCheckpointDirFullPath(new_checkpoint_cid).c_str(),
+      false);
+  logging::LoggingUtil::RemoveDirectory(checkpoint_dir.c_str(), false);
+}
+
+TEST_F(NewCheckpointingTests, LogTruncationTest) {
+  std::string checkpoint_dir = "log_truncation_checkpoint_dir";
+  std::string log_dir = "log_truncation_log_dir";
+
+  // the working directory of a checkpoint that never completed is removed.
+  logging::LoggingUtil::CreateDirectory(checkpoint_dir.c_str(), 0700);
+  std::string stale_dir = checkpoint_dir + "/tmp_checkpoint_1";
+  logging::LoggingUtil::CreateDirectory(stale_dir.c_str(), 0700);
+
+  logging::CheckpointManagerFactory::Configure(1);
+  auto &checkpoint_manager = logging::LogicalCheckpointManager::GetInstance();
+  checkpoint_manager.Reset();
+  checkpoint_manager.SetDirectory(checkpoint_dir);
+  EXPECT_FALSE(
+      logging::LoggingUtil::CheckDirectoryExistence(stale_dir.c_str()));
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.StartLogging();
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+
+  // the logger starts a new file every 500 milliseconds.
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  for (int file_itr = 0; file_itr < 2; ++file_itr) {
+    auto txn = txn_manager.BeginTransaction();
+    TestingExecutorUtil::PopulateTable(table.get(), 1, false, false, false,
+                                       txn);
+    txn_manager.CommitTransaction(txn);
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  }
+
+  std::vector<std::string> log_files;
+  logging::LoggingUtil::GetDirectoryList(log_dir.c_str(), "log_", log_files);
+  EXPECT_EQ(2, log_files.size());
+
+  std::ifstream pepoch_file(log_manager.GetPepochFileFullPath(),
+                            std::ios::binary | std::ios::ate);
+  std::streamoff pepoch_size = pepoch_file.tellg();
+  pepoch_file.close();
+
+  // the GC moves the snapshot epoch forward once the epochs have finished.
+  std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH * 3));
+  epoch_manager.GetExpiredEpochId();
+
+  // the checkpoint covers the first file, but the second one is still open.
+  cid_t checkpoint_cid = checkpoint_manager.DoCheckpoint();
+  EXPECT_NE(INVALID_CID, checkpoint_cid);
+
+  log_files.clear();
+  logging::LoggingUtil::GetDirectoryList(log_dir.c_str(), "log_", log_files);
+  EXPECT_EQ(1, log_files.size());
+
+  pepoch_file.open(log_manager.GetPepochFileFullPath(),
+                   std::ios::binary | std::ios::ate);
+  EXPECT_LT(pepoch_file.tellg(), pepoch_size);
+  pepoch_file.close();
+
+  log_manager.StopLogging();
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+  checkpoint_manager.Reset();
+  logging::CheckpointManagerFactory::Configure(0);
+  logging::LoggingUtil::RemoveDirectory(
+      checkpoint_manager.GetCheckpointDirFullPath(checkpoint_cid).c_str(),
+      false);
+  logging::LoggingUtil::RemoveDirectory(checkpoint_dir.c_str(), false);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+}
+
 }
 }
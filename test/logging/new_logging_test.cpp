@@ -10,8 +10,19 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "logging/log_manager_factory.h"
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <thread>
+
 #include "common/harness.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "logging/log_manager_factory.h"
+#include "logging/logging_util.h"
+#include "storage/data_table.h"
+#include "type/serializeio.h"
 
 namespace peloton {
 namespace test {
@@ -22,12 +33,258 @@ namespace test {
 
 class NewLoggingTests : public PelotonTest {};
 
+// Count the records of each type in all the log files of the directory.
+std::map<LogRecordType, int> CountLogRecords(const std::string &log_dir) {
+  std::map<LogRecordType, int> record_counts;
+
+  std::vector<std::string> files;
+  logging::LoggingUtil::GetDirectoryList(log_dir.c_str(), "log_", files);
+
+  for (auto &file_name : files) {
+    std::ifstream log_file(log_dir + "/" + file_name, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(log_file)),
+                         std::istreambuf_iterator<char>());
+
+    ReferenceSerializeInput input(contents.data(), contents.size());
+    size_t position = 0;
+    while (position < contents.size()) {
+      int32_t length = input.ReadInt();
+      auto type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+      input.getRawPointer(length - 1);
+      record_counts[type]++;
+      position += sizeof(int32_t) + length;
+    }
+  }
+  return record_counts;
+}
+
 TEST_F(NewLoggingTests, MyTest) {
   auto &log_manager = logging::LogManagerFactory::GetInstance();
   log_manager.Reset();
-  
+
   EXPECT_TRUE(true);
-  
+
+}
+
+TEST_F(NewLoggingTests, GroupCommitTest) {
+  std::string log_dir = "group_commit_log_dir";
+  const int tuple_count = 10;
+
+  // a commit is acknowledged once its epoch is persisted, which requires the
+  // epochs to advance.
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.StartLogging();
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                     false, txn);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // the commit only returns once the records and the persistent epoch that
+  // covers them are on the disk.
+  auto record_counts = CountLogRecords(log_dir);
+  EXPECT_EQ(1, record_counts[LogRecordType::TRANSACTION_COMMIT]);
+  EXPECT_EQ(tuple_count, record_counts[LogRecordType::TUPLE_INSERT]);
+  EXPECT_LT(INVALID_EID, log_manager.GetPersistEpochId());
+
+  // read-only transactions do not produce any record.
+  txn = txn_manager.BeginTransaction();
+  txn_manager.CommitTransaction(txn);
+
+  // stopping the logger writes down everything that is still buffered.
+  log_manager.StopLogging();
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  record_counts = CountLogRecords(log_dir);
+  EXPECT_EQ(1, record_counts[LogRecordType::TRANSACTION_BEGIN]);
+  EXPECT_EQ(1, record_counts[LogRecordType::TRANSACTION_COMMIT]);
+  EXPECT_EQ(tuple_count, record_counts[LogRecordType::TUPLE_INSERT]);
+  EXPECT_EQ(record_counts[LogRecordType::EPOCH_BEGIN],
+            record_counts[LogRecordType::EPOCH_END]);
+  EXPECT_LE(1, record_counts[LogRecordType::EPOCH_BEGIN]);
+
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+}
+
+TEST_F(NewLoggingTests, SyncCommitTest) {
+  std::string log_dir = "sync_commit_log_dir";
+  const int tuple_count = 10;
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.SetSyncCommit(true);
+  log_manager.StartLogging();
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // the records are on the disk as soon as the commit returns, and so is a
+  // persistent epoch that covers them.
+  auto record_counts = CountLogRecords(log_dir);
+  EXPECT_EQ(1, record_counts[LogRecordType::TRANSACTION_COMMIT]);
+  EXPECT_EQ(tuple_count, record_counts[LogRecordType::TUPLE_INSERT]);
+  EXPECT_LT(INVALID_EID, log_manager.GetPersistEpochId());
+
+  std::ifstream pepoch_file(log_manager.GetPepochFileFullPath(),
+                            std::ios::binary);
+  EXPECT_TRUE(pepoch_file.good());
+
+  log_manager.StopLogging();
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+}
+
+TEST_F(NewLoggingTests, MultiLoggerTest) {
+  std::vector<std::string> log_dirs = {"multi_logger_log_dir_0",
+                                       "multi_logger_log_dir_1"};
+  const int tuple_count = 10;
+  const uint64_t thread_count = 2;
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories(log_dirs);
+  log_manager.StartLogging();
+
+  // one logger per directory.
+  EXPECT_EQ(log_dirs.size(), log_manager.GetLoggerCount());
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+
+  // every thread registers a worker of its own, and the workers are spread
+  // over the loggers.
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::vector<std::thread> threads;
+  for (uint64_t thread_itr = 0; thread_itr < thread_count; ++thread_itr) {
+    threads.emplace_back([&table, &txn_manager, tuple_count] {
+      auto txn = txn_manager.BeginTransaction();
+      TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false,
+                                         false, false, txn);
+      txn_manager.CommitTransaction(txn);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  log_manager.StopLogging();
+
+  for (auto &log_dir : log_dirs) {
+    auto record_counts = CountLogRecords(log_dir);
+    EXPECT_EQ(1, record_counts[LogRecordType::TRANSACTION_COMMIT]);
+    EXPECT_EQ(tuple_count, record_counts[LogRecordType::TUPLE_INSERT]);
+  }
+
+  // the last entry of the pepoch file is the persistent epoch, which covers
+  // everything that has been committed.
+  std::ifstream pepoch_file(log_manager.GetPepochFileFullPath(),
+                            std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(pepoch_file)),
+                       std::istreambuf_iterator<char>());
+  EXPECT_LE(sizeof(uint64_t), contents.size());
+  EXPECT_EQ(0UL, contents.size() % sizeof(uint64_t));
+
+  uint64_t pepoch = INVALID_EID;
+  memcpy(&pepoch, contents.data() + contents.size() - sizeof(uint64_t),
+         sizeof(uint64_t));
+  EXPECT_EQ(log_manager.GetPersistEpochId(), pepoch);
+  EXPECT_EQ(concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId(),
+            pepoch);
+
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+  for (auto &log_dir : log_dirs) {
+    logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+  }
+}
+
+TEST_F(NewLoggingTests, FailedLogTest) {
+  std::string log_dir = "failed_log_dir";
+  const int tuple_count = 10;
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.StartLogging();
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+
+  // as if writing the log had failed.
+  log_manager.SetFailed();
+  EXPECT_TRUE(log_manager.HasFailed());
+
+  // the commit is refused rather than acknowledged, and the server keeps
+  // running.
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                     false, txn);
+  EXPECT_EQ(ResultType::FAILURE, txn_manager.CommitTransaction(txn));
+
+  // read-only transactions do not need the log.
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  log_manager.StopLogging();
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  // the refused transaction was rolled back before it was logged.
+  auto record_counts = CountLogRecords(log_dir);
+  EXPECT_EQ(0, record_counts[LogRecordType::TRANSACTION_COMMIT]);
+  EXPECT_EQ(0, record_counts[LogRecordType::TUPLE_INSERT]);
+
+  // resetting the log manager clears the failure.
+  log_manager.Reset();
+  EXPECT_FALSE(log_manager.HasFailed());
+  logging::LogManagerFactory::Configure(0);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
 }
 
 }
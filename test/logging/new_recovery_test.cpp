@@ -0,0 +1,532 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// new_recovery_test.cpp
+//
+// Identification: test/logging/new_recovery_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <thread>
+
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "index/index.h"
+#include "logging/checkpoint_manager_factory.h"
+#include "logging/log_manager_factory.h"
+#include "logging/logging_util.h"
+#include "logging/logical_recovery_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Recovery Tests
+//===--------------------------------------------------------------------===//
+
+class NewRecoveryTests : public PelotonTest {};
+
+static const oid_t recovery_database_oid = 54321;
+static const oid_t recovery_table_oid = 12345;
+
+// Create the database and the table, as a restarted system would do before
+// the recovery starts.
+storage::DataTable *CreateRecoveryTable() {
+  auto database = new storage::Database(recovery_database_oid);
+  storage::StorageManager::GetInstance()->AddDatabaseToStorageManager(database);
+
+  auto table = TestingExecutorUtil::CreateTable(
+      TESTS_TUPLES_PER_TILEGROUP, true, recovery_table_oid,
+      recovery_database_oid);
+  database->AddTable(table);
+  return table;
+}
+
+// Insert every tuple in a transaction of its own.
+void InsertRecoveryTuples(storage::DataTable *table, int begin_id,
+                          int end_id) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  for (int tuple_id = begin_id; tuple_id < end_id; tuple_id++) {
+    auto txn = txn_manager.BeginTransaction();
+
+    std::unique_ptr<storage::Tuple> tuple(
+        TestingExecutorUtil::GetTuple(table, tuple_id, testing_pool));
+
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer tuple_slot_id =
+        table->InsertTuple(tuple.get(), txn, &index_entry_ptr);
+    txn_manager.PerformInsert(txn, tuple_slot_id, index_entry_ptr);
+
+    txn_manager.CommitTransaction(txn);
+  }
+}
+
+// Count the tuples of the table that a new transaction sees.
+int CountVisibleTuples(storage::DataTable *table) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  int tuple_count = 0;
+  for (size_t tile_group_offset = 0;
+       tile_group_offset < table->GetTileGroupCount(); ++tile_group_offset) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    auto tile_group_header = tile_group->GetHeader();
+    for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+         ++tuple_id) {
+      if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) ==
+          VisibilityType::OK) {
+        tuple_count++;
+      }
+    }
+  }
+
+  txn_manager.CommitTransaction(txn);
+  return tuple_count;
+}
+
+TEST_F(NewRecoveryTests, CheckpointAndLogRecoveryTest) {
+  std::string checkpoint_dir = "new_recovery_checkpoint_dir";
+  std::string log_dir = "new_recovery_log_dir";
+  const int checkpoint_tuple_count = TESTS_TUPLES_PER_TILEGROUP * 2;
+  const int log_tuple_count = TESTS_TUPLES_PER_TILEGROUP + 1;
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+  // the GC moves the snapshot epoch forward once the epochs have finished.
+  auto wait_for_epochs = [&epoch_manager] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH * 3));
+    epoch_manager.GetExpiredEpochId();
+  };
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.StartLogging();
+
+  logging::CheckpointManagerFactory::Configure(1);
+  auto &checkpoint_manager = logging::LogicalCheckpointManager::GetInstance();
+  checkpoint_manager.Reset();
+  checkpoint_manager.SetDirectory(checkpoint_dir);
+
+  // the first tuples go to the checkpoint, the others to the log only.
+  auto table = CreateRecoveryTable();
+  InsertRecoveryTuples(table, 0, checkpoint_tuple_count);
+  wait_for_epochs();
+
+  cid_t checkpoint_cid = checkpoint_manager.DoCheckpoint();
+  EXPECT_NE(INVALID_CID, checkpoint_cid);
+
+  InsertRecoveryTuples(table, checkpoint_tuple_count,
+                       checkpoint_tuple_count + log_tuple_count);
+  log_manager.StopLogging();
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+
+  // lose everything that is in memory.
+  storage::StorageManager::GetInstance()->RemoveDatabaseFromStorageManager(
+      recovery_database_oid);
+  table = CreateRecoveryTable();
+  EXPECT_EQ(0, CountVisibleTuples(table));
+
+  logging::LogicalRecoveryManager recovery_manager(checkpoint_dir, {log_dir},
+                                                   2);
+  EXPECT_TRUE(recovery_manager.DoRecovery());
+  EXPECT_EQ(checkpoint_cid, recovery_manager.GetCheckpointCommitId());
+  EXPECT_EQ((size_t)log_tuple_count, recovery_manager.GetRecoveredTxnCount());
+
+  EXPECT_EQ(checkpoint_tuple_count + log_tuple_count,
+            CountVisibleTuples(table));
+
+  // the indexes are rebuilt from the recovered tuples.
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); ++index_itr) {
+    std::vector<ItemPointer *> index_entries;
+    table->GetIndex(index_itr)->ScanAllKeys(index_entries);
+    EXPECT_EQ((size_t)(checkpoint_tuple_count + log_tuple_count),
+              index_entries.size());
+  }
+
+  // the recovered state is checkpointed, and the replayed logs are dropped.
+  // the pepoch file stays, as the next run appends to it.
+  cid_t recovered_checkpoint_cid =
+      checkpoint_manager.GetLastCheckpointCommitId();
+  EXPECT_LT(checkpoint_cid, recovered_checkpoint_cid);
+  std::vector<std::string> log_files;
+  logging::LoggingUtil::GetDirectoryList(log_dir.c_str(), "log_", log_files);
+  EXPECT_TRUE(log_files.empty());
+  std::vector<std::string> pepoch_files;
+  logging::LoggingUtil::GetDirectoryList(log_dir.c_str(), "pepoch",
+                                         pepoch_files);
+  EXPECT_EQ(1UL, pepoch_files.size());
+
+  // new transactions keep on working on top of the recovered state.
+  InsertRecoveryTuples(table, checkpoint_tuple_count + log_tuple_count,
+                       checkpoint_tuple_count + log_tuple_count + 1);
+  EXPECT_EQ(checkpoint_tuple_count + log_tuple_count + 1,
+            CountVisibleTuples(table));
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  storage::StorageManager::GetInstance()->RemoveDatabaseFromStorageManager(
+      recovery_database_oid);
+  checkpoint_manager.Reset();
+  logging::CheckpointManagerFactory::Configure(0);
+
+  logging::LoggingUtil::RemoveDirectory(
+      checkpoint_manager.GetCheckpointDirFullPath(recovered_checkpoint_cid)
+          .c_str(),
+      false);
+  logging::LoggingUtil::RemoveDirectory(checkpoint_dir.c_str(), false);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+}
+
+TEST_F(NewRecoveryTests, OverlappingLogRecoveryTest) {
+  std::string checkpoint_dir = "new_recovery_overlap_checkpoint_dir";
+  std::string log_dir = "new_recovery_overlap_log_dir";
+  const int checkpoint_tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+  const int log_tuple_count = TESTS_TUPLES_PER_TILEGROUP / 2 + 1;
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.StartLogging();
+
+  logging::CheckpointManagerFactory::Configure(1);
+  auto &checkpoint_manager = logging::LogicalCheckpointManager::GetInstance();
+  checkpoint_manager.Reset();
+  checkpoint_manager.SetDirectory(checkpoint_dir);
+
+  auto table = CreateRecoveryTable();
+  InsertRecoveryTuples(table, 0, checkpoint_tuple_count);
+
+  // the checkpoint is taken while logging is stopped, so that the logs it
+  // covers are kept and overlap with it.
+  log_manager.StopLogging();
+  std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH * 3));
+  epoch_manager.GetExpiredEpochId();
+  cid_t checkpoint_cid = checkpoint_manager.DoCheckpoint();
+  EXPECT_NE(INVALID_CID, checkpoint_cid);
+
+  log_manager.StartLogging();
+  InsertRecoveryTuples(table, checkpoint_tuple_count,
+                       checkpoint_tuple_count + log_tuple_count);
+  log_manager.StopLogging();
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+
+  std::vector<std::string> log_files;
+  logging::LoggingUtil::GetDirectoryList(log_dir.c_str(), "log_", log_files);
+  EXPECT_FALSE(log_files.empty());
+
+  storage::StorageManager::GetInstance()->RemoveDatabaseFromStorageManager(
+      recovery_database_oid);
+  table = CreateRecoveryTable();
+
+  // only the transactions that committed after the checkpoint are replayed.
+  logging::LogicalRecoveryManager recovery_manager(checkpoint_dir, {log_dir},
+                                                   2);
+  EXPECT_TRUE(recovery_manager.DoRecovery());
+  EXPECT_EQ(checkpoint_cid, recovery_manager.GetCheckpointCommitId());
+  EXPECT_EQ((size_t)log_tuple_count, recovery_manager.GetRecoveredTxnCount());
+  EXPECT_EQ(checkpoint_tuple_count + log_tuple_count,
+            CountVisibleTuples(table));
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); ++index_itr) {
+    std::vector<ItemPointer *> index_entries;
+    table->GetIndex(index_itr)->ScanAllKeys(index_entries);
+    EXPECT_EQ((size_t)(checkpoint_tuple_count + log_tuple_count),
+              index_entries.size());
+  }
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  storage::StorageManager::GetInstance()->RemoveDatabaseFromStorageManager(
+      recovery_database_oid);
+  cid_t recovered_checkpoint_cid =
+      checkpoint_manager.GetLastCheckpointCommitId();
+  checkpoint_manager.Reset();
+  logging::CheckpointManagerFactory::Configure(0);
+
+  logging::LoggingUtil::RemoveDirectory(
+      checkpoint_manager.GetCheckpointDirFullPath(recovered_checkpoint_cid)
+          .c_str(),
+      false);
+  logging::LoggingUtil::RemoveDirectory(checkpoint_dir.c_str(), false);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+}
+
+TEST_F(NewRecoveryTests, UpdateRecoveryTest) {
+  std::string checkpoint_dir = "new_recovery_update_checkpoint_dir";
+  std::string log_dir = "new_recovery_update_log_dir";
+  std::string table_name = "recovery_update_table";
+  const int tuple_count = 10;
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+  auto wait_for_epochs = [&epoch_manager] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH * 3));
+    epoch_manager.GetExpiredEpochId();
+  };
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.StartLogging();
+
+  logging::CheckpointManagerFactory::Configure(1);
+  auto &checkpoint_manager = logging::LogicalCheckpointManager::GetInstance();
+  checkpoint_manager.Reset();
+  checkpoint_manager.SetDirectory(checkpoint_dir);
+
+  // the tuples go to the checkpoint, the update and the delete to the log.
+  storage::StorageManager::GetInstance()->AddDatabaseToStorageManager(
+      new storage::Database(recovery_database_oid));
+  auto table = TestingTransactionUtil::CreateTable(
+      tuple_count, table_name, recovery_database_oid, recovery_table_oid);
+  wait_for_epochs();
+
+  cid_t checkpoint_cid = checkpoint_manager.DoCheckpoint();
+  EXPECT_NE(INVALID_CID, checkpoint_cid);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 0, 100));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table, 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  log_manager.StopLogging();
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+
+  // lose everything that is in memory.
+  storage::StorageManager::GetInstance()->RemoveDatabaseFromStorageManager(
+      recovery_database_oid);
+  storage::StorageManager::GetInstance()->AddDatabaseToStorageManager(
+      new storage::Database(recovery_database_oid));
+  table = TestingTransactionUtil::CreateTable(0, table_name,
+                                              recovery_database_oid,
+                                              recovery_table_oid);
+
+  logging::LogicalRecoveryManager recovery_manager(checkpoint_dir, {log_dir},
+                                                   2);
+  EXPECT_TRUE(recovery_manager.DoRecovery());
+  EXPECT_EQ(2UL, recovery_manager.GetRecoveredTxnCount());
+  EXPECT_EQ(tuple_count - 1, CountVisibleTuples(table));
+
+  txn = txn_manager.BeginTransaction();
+  int value = -1;
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 0, value));
+  EXPECT_EQ(100, value);
+  txn_manager.CommitTransaction(txn);
+
+  // the new version of the updated tuple is linked to the one it replaced.
+  auto storage_manager = storage::StorageManager::GetInstance();
+  size_t linked_count = 0;
+  for (size_t tile_group_offset = 0;
+       tile_group_offset < table->GetTileGroupCount(); ++tile_group_offset) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    auto tile_group_header = tile_group->GetHeader();
+    for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+         ++tuple_id) {
+      ItemPointer old_location = tile_group_header->GetNextItemPointer(tuple_id);
+      if (old_location.IsNull() == true) {
+        continue;
+      }
+      linked_count++;
+      auto old_tile_group_header =
+          storage_manager->GetTileGroup(old_location.block)->GetHeader();
+      EXPECT_EQ(tile_group_header->GetBeginCommitId(tuple_id),
+                old_tile_group_header->GetEndCommitId(old_location.offset));
+      ItemPointer new_location =
+          old_tile_group_header->GetPrevItemPointer(old_location.offset);
+      EXPECT_EQ(tile_group->GetTileGroupId(), new_location.block);
+      EXPECT_EQ(tuple_id, new_location.offset);
+    }
+  }
+  EXPECT_EQ(1UL, linked_count);
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  storage::StorageManager::GetInstance()->RemoveDatabaseFromStorageManager(
+      recovery_database_oid);
+  checkpoint_manager.Reset();
+  logging::CheckpointManagerFactory::Configure(0);
+
+  std::vector<std::string> checkpoint_dirs;
+  logging::LoggingUtil::GetDirectoryList(checkpoint_dir.c_str(), "checkpoint_",
+                                         checkpoint_dirs);
+  for (auto &dir_name : checkpoint_dirs) {
+    logging::LoggingUtil::RemoveDirectory(
+        (checkpoint_dir + "/" + dir_name).c_str(), false);
+  }
+  logging::LoggingUtil::RemoveDirectory(checkpoint_dir.c_str(), false);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+}
+
+TEST_F(NewRecoveryTests, MissingPepochTest) {
+  std::string log_dir = "new_recovery_missing_pepoch_log_dir";
+  const int log_tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.SetSyncCommit(true);
+  log_manager.StartLogging();
+
+  auto table = CreateRecoveryTable();
+  InsertRecoveryTuples(table, 0, log_tuple_count);
+  log_manager.StopLogging();
+  std::string pepoch_file = log_manager.GetPepochFileFullPath();
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  // without the pepoch file, no epoch of the log is known to be durable.
+  EXPECT_EQ(0, std::remove(pepoch_file.c_str()));
+
+  storage::StorageManager::GetInstance()->RemoveDatabaseFromStorageManager(
+      recovery_database_oid);
+  table = CreateRecoveryTable();
+
+  logging::LogicalRecoveryManager recovery_manager("", {log_dir}, 1);
+  EXPECT_TRUE(recovery_manager.DoRecovery());
+  EXPECT_EQ(0UL, recovery_manager.GetRecoveredTxnCount());
+  EXPECT_EQ(0, CountVisibleTuples(table));
+
+  storage::StorageManager::GetInstance()->RemoveDatabaseFromStorageManager(
+      recovery_database_oid);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+}
+
+TEST_F(NewRecoveryTests, SchemaRecoveryTest) {
+  std::string checkpoint_dir = "new_recovery_schema_checkpoint_dir";
+  std::string log_dir = "new_recovery_schema_log_dir";
+  std::string db_name = "recovery_schema_db";
+  std::string table_name = "test_table";
+  const int checkpoint_tuple_count = TESTS_TUPLES_PER_TILEGROUP * 2;
+  const int log_tuple_count = TESTS_TUPLES_PER_TILEGROUP + 1;
+
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+  auto wait_for_epochs = [&epoch_manager] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH * 3));
+    epoch_manager.GetExpiredEpochId();
+  };
+
+  // the catalog tables are checkpointed along with the user tables.
+  logging::CheckpointManagerFactory::Configure(1);
+  auto &checkpoint_manager = logging::LogicalCheckpointManager::GetInstance();
+  checkpoint_manager.Reset();
+  checkpoint_manager.SetDirectory(checkpoint_dir);
+
+  auto catalog = catalog::Catalog::GetInstance();
+  catalog->Bootstrap();
+
+  logging::LogManagerFactory::Configure(1);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.Reset();
+  log_manager.SetDirectories({log_dir});
+  log_manager.StartLogging();
+
+  // the table is created through the catalog, with an index of its own.
+  TestingExecutorUtil::InitializeDatabase(db_name);
+  auto table = TestingExecutorUtil::CreateTableUpdateCatalog(
+      TESTS_TUPLES_PER_TILEGROUP, db_name);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(ResultType::SUCCESS,
+            catalog->CreateIndex(txn, db_name, DEFAULT_SCHEMA_NAME, table_name,
+                                 "test_table_col_a", {0}, true,
+                                 IndexType::BWTREE));
+  txn_manager.CommitTransaction(txn);
+
+  InsertRecoveryTuples(table, 0, checkpoint_tuple_count);
+  wait_for_epochs();
+  EXPECT_NE(INVALID_CID, checkpoint_manager.DoCheckpoint());
+
+  InsertRecoveryTuples(table, checkpoint_tuple_count,
+                       checkpoint_tuple_count + log_tuple_count);
+  log_manager.StopLogging();
+  log_manager.Reset();
+  logging::LogManagerFactory::Configure(0);
+
+  // lose the database, its schema included.
+  TestingExecutorUtil::DeleteDatabase(db_name);
+
+  logging::LogicalRecoveryManager recovery_manager(checkpoint_dir, {log_dir},
+                                                   2);
+  EXPECT_TRUE(recovery_manager.DoRecovery());
+
+  // the database and the table are created again from the recovered
+  // catalog, under new oids.
+  txn = txn_manager.BeginTransaction();
+  table = catalog->GetTableWithName(txn, db_name, DEFAULT_SCHEMA_NAME,
+                                    table_name);
+  txn_manager.CommitTransaction(txn);
+  ASSERT_TRUE(table != nullptr);
+  EXPECT_EQ(checkpoint_tuple_count + log_tuple_count,
+            CountVisibleTuples(table));
+
+  ASSERT_EQ(1U, table->GetIndexCount());
+  auto index = table->GetIndex(0);
+  EXPECT_EQ("test_table_col_a", index->GetName());
+  std::vector<ItemPointer *> index_entries;
+  index->ScanAllKeys(index_entries);
+  EXPECT_EQ((size_t)(checkpoint_tuple_count + log_tuple_count),
+            index_entries.size());
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  TestingExecutorUtil::DeleteDatabase(db_name);
+  checkpoint_manager.Reset();
+  logging::CheckpointManagerFactory::Configure(0);
+
+  std::vector<std::string> checkpoint_dirs;
+  logging::LoggingUtil::GetDirectoryList(checkpoint_dir.c_str(), "checkpoint_",
+                                         checkpoint_dirs);
+  for (auto &dir_name : checkpoint_dirs) {
+    logging::LoggingUtil::RemoveDirectory(
+        (checkpoint_dir + "/" + dir_name).c_str(), false);
+  }
+  logging::LoggingUtil::RemoveDirectory(checkpoint_dir.c_str(), false);
+  logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// postgres_value_format_test.cpp
+//
+// Identification: test/network/postgres_value_format_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "function/date_functions.h"
+#include "network/postgres_value_format.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Postgres Value Format Tests
+//===--------------------------------------------------------------------===//
+
+class PostgresValueFormatTests : public PelotonTest {};
+
+using network::PostgresValueFormat;
+
+// Decode the encoded bytes of the value as a parameter of the given type
+static type::Value RoundTrip(const type::Value &val, PostgresValueType type) {
+  std::string bytes = PostgresValueFormat::EncodeBinary(val);
+  type::Value result;
+  EXPECT_TRUE(PostgresValueFormat::DecodeBinary(
+      type, reinterpret_cast<const uchar *>(bytes.data()), bytes.size(),
+      result));
+  return result;
+}
+
+TEST_F(PostgresValueFormatTests, EncodeTest) {
+  // Integers go out in network byte order
+  EXPECT_EQ(std::string("\x01\x02", 2),
+            PostgresValueFormat::EncodeBinary(
+                type::ValueFactory::GetSmallIntValue(0x0102)));
+  EXPECT_EQ(std::string("\x01\x02\x03\x04", 4),
+            PostgresValueFormat::EncodeBinary(
+                type::ValueFactory::GetIntegerValue(0x01020304)));
+  EXPECT_EQ(std::string("\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFE", 8),
+            PostgresValueFormat::EncodeBinary(
+                type::ValueFactory::GetBigIntValue(-2)));
+  EXPECT_EQ(std::string("\x3F\xF0\x00\x00\x00\x00\x00\x00", 8),
+            PostgresValueFormat::EncodeBinary(
+                type::ValueFactory::GetDecimalValue(1.0)));
+  EXPECT_EQ(std::string("\x01", 1),
+            PostgresValueFormat::EncodeBinary(
+                type::ValueFactory::GetBooleanValue(true)));
+
+  // Strings are their raw bytes, without the terminator
+  EXPECT_EQ("peloton", PostgresValueFormat::EncodeBinary(
+                           type::ValueFactory::GetVarcharValue("peloton")));
+
+  // Dates count days since 2000-01-01
+  auto date = type::ValueFactory::GetDateValue(
+      function::DateFunctions::DateToJulian(2000, 1, 2));
+  EXPECT_EQ(std::string("\x00\x00\x00\x01", 4),
+            PostgresValueFormat::EncodeBinary(date));
+
+  // The text format is the same as ToString()
+  auto val = type::ValueFactory::GetIntegerValue(42);
+  EXPECT_EQ("42", PostgresValueFormat::EncodeValue(
+                      val, PostgresValueFormat::TEXT_FORMAT));
+}
+
+TEST_F(PostgresValueFormatTests, TimestampTest) {
+  auto epoch = type::ValueFactory::CastAsTimestamp(
+      type::ValueFactory::GetVarcharValue("2000-01-01 00:00:00.000000+00"));
+  EXPECT_EQ(0, PostgresValueFormat::TimestampToPostgres(
+                   epoch.GetAs<uint64_t>()));
+
+  auto ts = type::ValueFactory::CastAsTimestamp(
+      type::ValueFactory::GetVarcharValue("1999-12-31 23:59:58.500000+00"));
+  int64_t micros =
+      PostgresValueFormat::TimestampToPostgres(ts.GetAs<uint64_t>());
+  EXPECT_EQ(-1500000, micros);
+  EXPECT_EQ(ts.GetAs<uint64_t>(),
+            PostgresValueFormat::TimestampFromPostgres(micros));
+}
+
+TEST_F(PostgresValueFormatTests, DecodeTest) {
+  std::vector<std::pair<type::Value, PostgresValueType>> values = {
+      {type::ValueFactory::GetBooleanValue(true), PostgresValueType::BOOLEAN},
+      {type::ValueFactory::GetSmallIntValue(-7), PostgresValueType::SMALLINT},
+      {type::ValueFactory::GetIntegerValue(123456), PostgresValueType::INTEGER},
+      {type::ValueFactory::GetBigIntValue(-123456789012),
+       PostgresValueType::BIGINT},
+      {type::ValueFactory::GetDecimalValue(3.25), PostgresValueType::DOUBLE},
+      {type::ValueFactory::GetVarcharValue("abc"), PostgresValueType::TEXT},
+      {type::ValueFactory::GetDateValue(
+           function::DateFunctions::DateToJulian(2017, 6, 30)),
+       PostgresValueType::DATE},
+      {type::ValueFactory::CastAsTimestamp(type::ValueFactory::GetVarcharValue(
+           "2017-06-30 12:34:56.789012+00")),
+       PostgresValueType::TIMESTAMPS}};
+
+  for (auto &value : values) {
+    auto result = RoundTrip(value.first, value.second);
+    EXPECT_EQ(value.first.GetTypeId(), result.GetTypeId());
+    EXPECT_EQ(CmpBool::CmpTrue, value.first.CompareEquals(result));
+  }
+
+  // A float4 becomes a decimal
+  uchar real_bytes[] = {0x40, 0x20, 0x00, 0x00};
+  type::Value real;
+  EXPECT_TRUE(PostgresValueFormat::DecodeBinary(PostgresValueType::REAL,
+                                                real_bytes, 4, real));
+  EXPECT_EQ(2.5, real.GetAs<double>());
+
+  // The length has to match the type
+  type::Value result;
+  EXPECT_FALSE(PostgresValueFormat::DecodeBinary(PostgresValueType::INTEGER,
+                                                 real_bytes, 2, result));
+  EXPECT_FALSE(PostgresValueFormat::DecodeBinary(PostgresValueType::DECIMAL,
+                                                 real_bytes, 4, result));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -33,6 +33,7 @@ class SelectAllTests : public PelotonTest {};
  * Select All Test
  * In this test, peloton will return the result that exceeds the 8192 bytes limits.
  * The response will be put into multiple packets and be sent back to clients.
+ * The result also spans more than one batch of streamed rows.
  */
 void *SelectAllTest(int port) {
   try {
@@ -56,6 +57,23 @@ void *SelectAllTest(int port) {
     pqxx::result R = txn2.exec("SELECT * from template;");
     txn2.commit();
     EXPECT_EQ(R.size(), 2000);
+
+    // every row arrives exactly once
+    std::vector<bool> seen(2000, false);
+    for (const auto &row : R) {
+      int id = row[0].as<int>();
+      EXPECT_TRUE(id >= 0 && id < 2000);
+      if (id < 0 || id >= 2000) continue;
+      EXPECT_FALSE(seen[id]);
+      seen[id] = true;
+    }
+
+    // the same result through a prepared statement
+    pqxx::work txn3(C);
+    txn3.exec("PREPARE selectall AS SELECT * FROM template;");
+    pqxx::result R2 = txn3.exec("EXECUTE selectall;");
+    txn3.commit();
+    EXPECT_EQ(R2.size(), 2000);
   } catch (const std::exception &e) {
     LOG_INFO("[SelectAllTest] Exception occurred: %s", e.what());
     EXPECT_TRUE(false);
@@ -163,5 +163,22 @@ TEST_F(HyperLogLogTests, DataTypeTest) {
   hll.EstimateCardinality();
 }
 
+// Two overlapping halves of 10k distinct values, merged.
+TEST_F(HyperLogLogTests, MergeTest) {
+  HyperLogLog hll1{}, hll2{};
+  int threshold = 10000;
+  double error = hll1.RelativeError();
+  for (int i = 0; i < threshold * 6 / 10; i++) {
+    hll1.Update(type::ValueFactory::GetIntegerValue(i));
+  }
+  for (int i = threshold * 4 / 10; i < threshold; i++) {
+    hll2.Update(type::ValueFactory::GetIntegerValue(i));
+  }
+  hll1.Merge(hll2);
+  uint64_t cardinality = hll1.EstimateCardinality();
+  EXPECT_LE(cardinality, threshold * (1 + error));
+  EXPECT_GE(cardinality, threshold * (1 - error));
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -13,6 +13,7 @@
 
 #include "optimizer_test_util.cpp"
 #include "planner/abstract_scan_plan.h"
+#include "planner/aggregate_plan.h"
 
 namespace peloton {
 namespace test {
@@ -282,5 +283,61 @@ TEST_F(PlanTest, PostgresThreeJoinOrderTestSmall) {
 }
 
 
+// Tests that joining on the primary keys merges two index scans, as they
+// return the tuples already sorted on the join keys
+TEST_F(PlanTest, DefaultMergeJoinOnIndexOrderTest) {
+
+  // Set cost model to default cost model
+  OptimizerTestUtil::SetCostModel(optimizer::CostModels::DEFAULT);
+
+  // Populate Tables and run Analyze
+  std::string test1_table_name = "test1";
+  std::string test2_table_name = "test2";
+  int test1_table_size = 10;
+  int test2_table_size = 100;
+  OptimizerTestUtil::CreateTable(test1_table_name, test1_table_size);
+  OptimizerTestUtil::CreateTable(test2_table_name, test2_table_size);
+  OptimizerTestUtil::AnalyzeTable(test1_table_name);
+  OptimizerTestUtil::AnalyzeTable(test2_table_name);
+
+  // Generate query
+  auto query = OptimizerTestUtil::CreateTwoWayJoinQuery(test1_table_name, test2_table_name, "a", "a");
+
+  auto plan = OptimizerTestUtil::GeneratePlan(query);
+
+  // No sort is needed below the merge join
+  EXPECT_EQ(PlanNodeType::MERGEJOIN, plan->GetPlanNodeType());
+  ASSERT_EQ(2, plan->GetChildren().size());
+  EXPECT_EQ(PlanNodeType::INDEXSCAN, plan->GetChildren()[0]->GetPlanNodeType());
+  EXPECT_EQ(0, plan->GetChildren()[0]->GetChildren().size());
+  EXPECT_EQ(PlanNodeType::INDEXSCAN, plan->GetChildren()[1]->GetPlanNodeType());
+  EXPECT_EQ(0, plan->GetChildren()[1]->GetChildren().size());
+}
+
+// Tests that grouping on the primary key aggregates the sorted output of the
+// index scan instead of hashing it
+TEST_F(PlanTest, DefaultSortGroupByOnIndexOrderTest) {
+
+  // Set cost model to default cost model
+  OptimizerTestUtil::SetCostModel(optimizer::CostModels::DEFAULT);
+
+  // Populate Table and run Analyze
+  std::string test1_table_name = "test1";
+  int test1_table_size = 100;
+  OptimizerTestUtil::CreateTable(test1_table_name, test1_table_size);
+  OptimizerTestUtil::AnalyzeTable(test1_table_name);
+
+  auto plan = OptimizerTestUtil::GeneratePlan(
+      "SELECT a, COUNT(*) FROM " + test1_table_name + " GROUP BY a;");
+
+  // No sort is needed below the aggregation
+  EXPECT_EQ(PlanNodeType::AGGREGATE_V2, plan->GetPlanNodeType());
+  auto agg_plan = dynamic_cast<peloton::planner::AggregatePlan *>(plan.get());
+  ASSERT_NE(nullptr, agg_plan);
+  EXPECT_EQ(AggregateType::SORTED, agg_plan->GetAggregateStrategy());
+  ASSERT_EQ(1, plan->GetChildren().size());
+  EXPECT_EQ(PlanNodeType::INDEXSCAN, plan->GetChildren()[0]->GetPlanNodeType());
+}
+
 }
 }
\ No newline at end of file
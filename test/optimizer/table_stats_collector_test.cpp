@@ -21,6 +21,7 @@
 #include "executor/testing_executor_util.h"
 #include "optimizer/stats/column_stats_collector.h"
 #include "optimizer/stats/table_stats_collector.h"
+#include "settings/settings_manager.h"
 #include "sql/testing_sql_util.h"
 #include "storage/data_table.h"
 #include "storage/tuple.h"
@@ -149,5 +150,93 @@ TEST_F(TableStatsCollectorTests, MultiColumnTableTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// 20 tile groups of 10 tuples, collected by several threads. The first column
+// has two values, the second is unique.
+TEST_F(TableStatsCollectorTests, ParallelCollectionTest) {
+  const int tuples_per_tilegroup = 10;
+  const int nrow = 200;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow, false, false,
+                                     true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The committed inserts count as modifications until stats are collected
+  EXPECT_EQ(data_table->GetModifiedTupleCount(), nrow);
+
+  int old_num_threads = settings::SettingsManager::GetInt(
+      settings::SettingId::analyze_num_threads);
+  settings::SettingsManager::SetInt(settings::SettingId::analyze_num_threads,
+                                    4);
+  TableStatsCollector stats{data_table.get()};
+  stats.CollectColumnStats();
+  settings::SettingsManager::SetInt(settings::SettingId::analyze_num_threads,
+                                    old_num_threads);
+  EXPECT_EQ(data_table->GetModifiedTupleCount(), 0);
+
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow);
+  EXPECT_EQ(stats.GetSampledTupleCount(), nrow);
+
+  // The stats of all threads add up to those of the whole table
+  ColumnStatsCollector *a_stats = stats.GetColumnStats(0);
+  EXPECT_EQ(a_stats->GetFracNull(), 0);
+  EXPECT_EQ(a_stats->GetCardinality(), 2);
+  auto common_values = a_stats->GetCommonValueAndFrequency();
+  ASSERT_EQ(common_values.size(), 2);
+  EXPECT_EQ(common_values[0].second, nrow / 2);
+  EXPECT_EQ(common_values[1].second, nrow / 2);
+
+  ColumnStatsCollector *b_stats = stats.GetColumnStats(1);
+  double cardinality_error = b_stats->GetCardinalityError();
+  EXPECT_GE(b_stats->GetCardinality(), nrow * (1 - cardinality_error));
+  EXPECT_LE(b_stats->GetCardinality(), nrow * (1 + cardinality_error));
+}
+
+// Only some of the tile groups are read, and the stats are scaled up to the
+// whole table.
+TEST_F(TableStatsCollectorTests, SampledCollectionTest) {
+  const int tuples_per_tilegroup = 10;
+  const int nrow = 200;
+  const int sample_size = 50;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow, false, false,
+                                     true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  int old_sample_size = settings::SettingsManager::GetInt(
+      settings::SettingId::analyze_sample_size);
+  settings::SettingsManager::SetInt(settings::SettingId::analyze_sample_size,
+                                    sample_size);
+  TableStatsCollector stats{data_table.get()};
+  stats.CollectColumnStats();
+  settings::SettingsManager::SetInt(settings::SettingId::analyze_sample_size,
+                                    old_sample_size);
+
+  // Whole tile groups are sampled until they hold enough tuples
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow);
+  EXPECT_EQ(stats.GetSampledTupleCount(), sample_size);
+
+  // The frequencies of the sampled values add up to the size of the table
+  ColumnStatsCollector *a_stats = stats.GetColumnStats(0);
+  EXPECT_GE(a_stats->GetCardinality(), 1);
+  EXPECT_LE(a_stats->GetCardinality(), 2);
+  double total_frequency = 0;
+  for (auto &common_value : a_stats->GetCommonValueAndFrequency()) {
+    total_frequency += common_value.second;
+  }
+  EXPECT_EQ(total_frequency, nrow);
+
+  // A column unique within the sample is estimated to be unique in the table
+  ColumnStatsCollector *b_stats = stats.GetColumnStats(1);
+  double cardinality_error = b_stats->GetCardinalityError();
+  EXPECT_GE(b_stats->GetCardinality(), nrow * (1 - cardinality_error));
+  EXPECT_LE(b_stats->GetCardinality(), nrow);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -165,5 +165,35 @@ TEST_F(TopKElementsTests, UniformTest) {
 
   top_k_elements.PrintAllOrderedMaxFirst();
 }
+
+TEST_F(TopKElementsTests, MergeTest) {
+  CountMinSketch sketch(10, 1000, 0);
+  const int k = 3;
+  TopKElements top_k_elements1(sketch, k);
+  TopKElements top_k_elements2(sketch, k);
+
+  top_k_elements1.Add(1, 10);
+  top_k_elements1.Add(2, 5);
+  top_k_elements1.Add(3, 1);
+
+  top_k_elements2.Add(2, 20);
+  top_k_elements2.Add("4", 7);
+  top_k_elements2.Add(5, 3);
+
+  // The counts of both are added up, and the candidates re-ranked
+  top_k_elements1.Merge(top_k_elements2);
+  EXPECT_EQ(top_k_elements1.cmsketch.EstimateItemCount(2), 25);
+  EXPECT_EQ(top_k_elements1.tkq.get_size(), k);
+
+  std::vector<TopKElements::ApproxTopEntry> entries =
+      top_k_elements1.RetrieveAllOrderedMaxFirst();
+  ASSERT_EQ(entries.size(), k);
+  EXPECT_EQ(entries[0].approx_top_elem.int_item, 2);
+  EXPECT_EQ(entries[0].approx_count, 25);
+  EXPECT_EQ(entries[1].approx_top_elem.int_item, 1);
+  EXPECT_EQ(entries[1].approx_count, 10);
+  EXPECT_EQ(entries[2].approx_top_elem.str_item, "4");
+  EXPECT_EQ(entries[2].approx_count, 7);
+}
 }
 }
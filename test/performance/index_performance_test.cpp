@@ -18,7 +18,9 @@
 
 #include "common/logger.h"
 #include "common/platform.h"
+#include "common/container_tuple.h"
 #include "common/timer.h"
+#include "index/art_index.h"
 #include "index/index_factory.h"
 #include "storage/tuple.h"
 #include "type/value_factory.h"
@@ -35,7 +37,21 @@ class IndexPerformanceTests : public PelotonTest {};
 catalog::Schema *key_schema = nullptr;
 catalog::Schema *tuple_schema = nullptr;
 
-std::shared_ptr<ItemPointer> item(new ItemPointer(120, 5));
+// One item per key. The block holds the key, so that ART can load the key of
+// an item back without a table
+std::vector<ItemPointer> items;
+
+// Load the key of an item for ART
+static void LoadArtKey(void *ctx, TID tid, art::Key &key) {
+  auto *art_index = reinterpret_cast<const index::ArtIndex *>(ctx);
+  auto *item_pointer = reinterpret_cast<const ItemPointer *>(tid);
+
+  auto key_value = type::ValueFactory::GetIntegerValue(item_pointer->block);
+  std::vector<type::Value> key_values = {key_value, key_value};
+  ContainerTuple<std::vector<type::Value>> key_tuple{&key_values};
+  art_index->ConstructArtKey(key_tuple, key);
+}
+
 
 index::Index *BuildIndex(const bool unique_keys, const IndexType index_type) {
   // Build tuple and key schema
@@ -80,6 +96,11 @@ index::Index *BuildIndex(const bool unique_keys, const IndexType index_type) {
   index::Index *index = index::IndexFactory::GetIndex(index_metadata);
   EXPECT_TRUE(index != NULL);
 
+  if (index_type == IndexType::ART) {
+    auto *art_index = static_cast<index::ArtIndex *>(index);
+    art_index->SetLoadKeyFunc(LoadArtKey, art_index);
+  }
+
   return index;
 }
 
@@ -118,7 +139,7 @@ static void InsertTest1(index::Index *index, size_t num_thread, size_t num_key,
     key->SetValue(0, key_value, nullptr);
     key->SetValue(1, key_value, nullptr);
 
-    auto status = index->InsertEntry(key.get(), item.get());
+    auto status = index->InsertEntry(key.get(), &items[i]);
     EXPECT_TRUE(status);
   }
 
@@ -160,7 +181,7 @@ static void DeleteTest1(index::Index *index, size_t num_thread, size_t num_key,
     key->SetValue(0, key_value, nullptr);
     key->SetValue(1, key_value, nullptr);
 
-    auto status = index->DeleteEntry(key.get(), item.get());
+    auto status = index->DeleteEntry(key.get(), &items[i]);
     EXPECT_TRUE(status);
   }
 
@@ -200,7 +221,7 @@ static void InsertTest2(index::Index *index, size_t num_thread, size_t num_key,
     key->SetValue(0, key_value, nullptr);
     key->SetValue(1, key_value, nullptr);
 
-    auto status = index->InsertEntry(key.get(), item.get());
+    auto status = index->InsertEntry(key.get(), &items[i]);
     EXPECT_TRUE(status);
   }
 
@@ -240,7 +261,7 @@ static void DeleteTest2(index::Index *index, size_t num_thread, size_t num_key,
     key->SetValue(0, key_value, nullptr);
     key->SetValue(1, key_value, nullptr);
 
-    auto status = index->DeleteEntry(key.get(), item.get());
+    auto status = index->DeleteEntry(key.get(), &items[i]);
     EXPECT_TRUE(status);
   }
 
@@ -268,6 +289,11 @@ static void TestIndexPerformance(const IndexType &index_type) {
   // Number of keys inserted by each thread
   size_t num_key = 1024 * 256;
 
+  items.clear();
+  for (size_t i = 0; i < num_thread * num_key; i++) {
+    items.emplace_back(i, i);
+  }
+
   Timer<> timer;
 
   ///////////////////////////////////////////////////////////////////
@@ -369,6 +395,14 @@ TEST_F(IndexPerformanceTests, BwTreeMultiThreadedTest) {
   TestIndexPerformance(IndexType::BWTREE);
 }
 
+TEST_F(IndexPerformanceTests, SkipListMultiThreadedTest) {
+  TestIndexPerformance(IndexType::SKIPLIST);
+}
+
+TEST_F(IndexPerformanceTests, ArtMultiThreadedTest) {
+  TestIndexPerformance(IndexType::ART);
+}
+
 // TEST_F(IndexPerformanceTests, BTreeMultiThreadedTest) {
 //  TestIndexPerformance(IndexType::BTREE);
 //}
@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logging_performance_test.cpp
+//
+// Identification: test/performance/logging_performance_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/timer.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "logging/log_manager_factory.h"
+#include "logging/logging_util.h"
+#include "storage/data_table.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Logging Performance Tests
+//===--------------------------------------------------------------------===//
+
+class LoggingPerformanceTests : public PelotonTest {};
+
+std::atomic<int> logging_tuple_id;
+
+//===------------------------------===//
+// Utility
+//===------------------------------===//
+
+// Every transaction inserts a single tuple and commits.
+void InsertTuplesInTxns(storage::DataTable *table, type::AbstractPool *pool,
+                        int txn_count, UNUSED_ATTRIBUTE uint64_t thread_itr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  for (int txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+    auto txn = txn_manager.BeginTransaction();
+
+    std::unique_ptr<storage::Tuple> tuple(
+        TestingExecutorUtil::GetTuple(table, ++logging_tuple_id, pool));
+
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer tuple_slot_id =
+        table->InsertTuple(tuple.get(), txn, &index_entry_ptr);
+    txn_manager.PerformInsert(txn, tuple_slot_id, index_entry_ptr);
+
+    txn_manager.CommitTransaction(txn);
+  }
+}
+
+// Run the insert workload and return the throughput in txns per second.
+// The log is striped over logger_count directories.
+double RunInsertWorkload(LoggingType logging_type, bool sync_commit,
+                         uint64_t thread_count, int txn_count,
+                         size_t logger_count = 1) {
+  std::vector<std::string> log_dirs;
+  for (size_t logger_id = 0; logger_id < logger_count; ++logger_id) {
+    log_dirs.push_back("logging_performance_test_dir_" +
+                       std::to_string(logger_id));
+  }
+
+  if (logging_type == LoggingType::ON) {
+    logging::LogManagerFactory::Configure(1);
+    auto &log_manager = logging::LogicalLogManager::GetInstance();
+    log_manager.Reset();
+    log_manager.SetDirectories(log_dirs);
+    log_manager.SetSyncCommit(sync_commit);
+    log_manager.StartLogging();
+  } else {
+    logging::LogManagerFactory::Configure(0);
+  }
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  Timer<> timer;
+  timer.Start();
+
+  LaunchParallelTest(thread_count, InsertTuplesInTxns, table.get(),
+                     testing_pool, txn_count);
+
+  // in group-commit mode the last epochs are only durable once the logger
+  // catches up, which is part of the cost of the workload.
+  if (logging_type == LoggingType::ON) {
+    logging::LogManagerFactory::GetInstance().StopLogging();
+  }
+
+  timer.Stop();
+
+  if (logging_type == LoggingType::ON) {
+    logging::LogManagerFactory::GetInstance().Reset();
+    logging::LogManagerFactory::Configure(0);
+    for (auto &log_dir : log_dirs) {
+      logging::LoggingUtil::RemoveDirectory(log_dir.c_str(), false);
+    }
+  }
+
+  return thread_count * txn_count / timer.GetDuration();
+}
+
+TEST_F(LoggingPerformanceTests, CommitThroughputTest) {
+  // both logging modes only acknowledge a commit once it is durable. group
+  // commit pays up to a few epochs of latency per commit but shares each
+  // fsync among all the concurrent committers, so it needs many of them.
+  uint64_t thread_count = 32;
+  int txn_count = 50;
+
+  // the epoch thread drives the group commit.
+  std::unique_ptr<std::thread> epoch_thread;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  double no_logging_throughput =
+      RunInsertWorkload(LoggingType::OFF, false, thread_count, txn_count);
+  double sync_throughput =
+      RunInsertWorkload(LoggingType::ON, true, thread_count, txn_count);
+  double group_commit_throughput =
+      RunInsertWorkload(LoggingType::ON, false, thread_count, txn_count);
+  double multi_logger_throughput =
+      RunInsertWorkload(LoggingType::ON, false, thread_count, txn_count, 2);
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  LOG_INFO("No logging    : %.2lf txns/s", no_logging_throughput);
+  LOG_INFO("Synchronous   : %.2lf txns/s", sync_throughput);
+  LOG_INFO("Group commit  : %.2lf txns/s", group_commit_throughput);
+  LOG_INFO("2 loggers     : %.2lf txns/s", multi_logger_throughput);
+
+  EXPECT_GT(no_logging_throughput, 0);
+  EXPECT_GT(sync_throughput, 0);
+  EXPECT_GT(group_commit_throughput, 0);
+  EXPECT_GT(multi_logger_throughput, 0);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -14,10 +14,15 @@
 
 #include "sql/testing_sql_util.h"
 #include "catalog/catalog.h"
+#include "codegen/query_compiler.h"
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/create_executor.h"
+#include "index/index.h"
+#include "optimizer/optimizer.h"
 #include "planner/create_plan.h"
+#include "planner/index_scan_plan.h"
+#include "storage/data_table.h"
 
 namespace peloton {
 namespace test {
@@ -231,5 +236,98 @@ TEST_F(IndexScanSQLTests, SQLTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(IndexScanSQLTests, RepeatedScanWithDifferentKeysTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+  TestingSQLUtil::ExecuteSQLQuery("CREATE INDEX i1 ON test(b);");
+
+  // The same query shape with different keys must not reuse stale keys
+  std::vector<ResultValue> result;
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 22;", result);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("1", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 11;", result);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("3", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // Keys on either side of the comparison
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE 22 < b;", result);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("2", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // After an update, the index still points to the old version of the tuple,
+  // which no longer carries the key
+  TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET b = 44 WHERE a = 1;");
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 22;", result);
+  EXPECT_EQ(0, result.size());
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 44;", result);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("1", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(IndexScanSQLTests, ArtIndexScanTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+  TestingSQLUtil::ExecuteSQLQuery("CREATE INDEX i1 ON test USING ART (b);");
+
+  // The scan goes through the ART index, and is compiled
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer{
+      new optimizer::Optimizer()};
+  txn = txn_manager.BeginTransaction();
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(
+      optimizer, "SELECT a FROM test WHERE b = 22;", txn);
+  txn_manager.CommitTransaction(txn);
+  ASSERT_EQ(PlanNodeType::INDEXSCAN, plan->GetPlanNodeType());
+  auto *scan_plan = static_cast<planner::IndexScanPlan *>(plan.get());
+  auto index = scan_plan->GetTable()->GetIndexWithOid(scan_plan->GetIndexId());
+  EXPECT_EQ(IndexType::ART, index->GetIndexMethodType());
+  EXPECT_TRUE(codegen::QueryCompiler::IsSupported(*plan));
+
+  // Point lookup
+  std::vector<ResultValue> result;
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 22;", result);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("1", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // Range scans come back in the order of the keys
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b > 11;", result);
+  EXPECT_EQ(2, result.size());
+  EXPECT_EQ("1", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ("2", TestingSQLUtil::GetResultValueAsString(result, 1));
+
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b < 33;", result);
+  EXPECT_EQ(2, result.size());
+  EXPECT_EQ("3", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ("1", TestingSQLUtil::GetResultValueAsString(result, 1));
+
+  // After an update, the index still points to the old version of the tuple,
+  // which no longer carries the key
+  TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET b = 44 WHERE a = 1;");
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 22;", result);
+  EXPECT_EQ(0, result.size());
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 44;", result);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("1", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
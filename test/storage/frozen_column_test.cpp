@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_column_test.cpp
+//
+// Identification: test/storage/frozen_column_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <limits>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "storage/frozen_column.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/zone_map.h"
+#include "type/ephemeral_pool.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class FrozenColumnTests : public PelotonTest {};
+
+namespace {
+
+constexpr oid_t kNumSlots = 1000;
+
+// Encode the given integers as a column of four byte tuples and decode them
+// back, checking they round-trip
+std::unique_ptr<storage::FrozenColumn> EncodeIntegers(
+    const std::vector<int32_t> &values, const std::vector<bool> &live) {
+  std::unique_ptr<storage::FrozenColumn> column{new storage::FrozenColumn(
+      type::TypeId::INTEGER, 0, sizeof(int32_t))};
+  column->Encode(reinterpret_cast<const char *>(values.data()),
+                 sizeof(int32_t), live);
+
+  std::vector<int32_t> decoded(values.size());
+  column->Decode(reinterpret_cast<char *>(decoded.data()), sizeof(int32_t),
+                 nullptr);
+  for (oid_t slot = 0; slot < values.size(); slot++) {
+    if (live[slot]) {
+      EXPECT_EQ(values[slot], decoded[slot]);
+    }
+  }
+  return column;
+}
+
+storage::PredicateRange MakeRange(int64_t low, int64_t high) {
+  return storage::PredicateRange{0, low, high};
+}
+
+}  // namespace
+
+TEST_F(FrozenColumnTests, DictionaryTest) {
+  std::vector<int32_t> values;
+  for (oid_t i = 0; i < kNumSlots; i++) {
+    values.push_back((i % 3) * 7 - 7);
+  }
+  auto column = EncodeIntegers(values, std::vector<bool>(kNumSlots, true));
+  EXPECT_EQ(storage::FrozenColumn::Encoding::DICTIONARY,
+            column->GetEncoding());
+  EXPECT_LT(column->GetSize(), kNumSlots * sizeof(int32_t));
+
+  // Values between the distinct ones are ruled out
+  EXPECT_TRUE(column->MayMatch(MakeRange(7, 7)));
+  EXPECT_TRUE(column->MayMatch(MakeRange(-10, -7)));
+  EXPECT_FALSE(column->MayMatch(MakeRange(1, 6)));
+  EXPECT_FALSE(column->MayMatch(MakeRange(8, 100)));
+}
+
+TEST_F(FrozenColumnTests, RunLengthTest) {
+  std::vector<int32_t> values;
+  for (oid_t i = 0; i < kNumSlots; i++) {
+    values.push_back(i < kNumSlots / 2 ? 100000 : -100000);
+  }
+  auto column = EncodeIntegers(values, std::vector<bool>(kNumSlots, true));
+  EXPECT_EQ(storage::FrozenColumn::Encoding::RUN_LENGTH,
+            column->GetEncoding());
+  EXPECT_TRUE(column->MayMatch(MakeRange(100000, 100000)));
+  EXPECT_FALSE(column->MayMatch(MakeRange(-99999, 99999)));
+}
+
+TEST_F(FrozenColumnTests, BitPackedTest) {
+  std::vector<int32_t> values;
+  for (oid_t i = 0; i < kNumSlots; i++) {
+    values.push_back(static_cast<int32_t>(i * 3) - 500);
+  }
+
+  // Slots without a tuple aren't read
+  std::vector<bool> live(kNumSlots, true);
+  live[0] = live[10] = false;
+  values[0] = values[10] = std::numeric_limits<int32_t>::max();
+
+  auto column = EncodeIntegers(values, live);
+  EXPECT_EQ(storage::FrozenColumn::Encoding::BIT_PACKED,
+            column->GetEncoding());
+  EXPECT_LT(column->GetSize(), kNumSlots * sizeof(int32_t) / 2);
+  EXPECT_TRUE(column->MayMatch(MakeRange(1, 1)));
+}
+
+TEST_F(FrozenColumnTests, VarlenTest) {
+  type::EphemeralPool pool;
+  std::vector<char *> values(kNumSlots);
+  for (oid_t i = 0; i < kNumSlots; i++) {
+    auto value =
+        i % 5 == 4 ? type::ValueFactory::GetNullValueByType(
+                         type::TypeId::VARCHAR)
+                   : type::ValueFactory::GetVarcharValue(std::to_string(i % 4));
+    value.SerializeTo(reinterpret_cast<char *>(&values[i]), false, &pool);
+  }
+
+  storage::FrozenColumn column{type::TypeId::VARCHAR, 0, sizeof(char *)};
+  column.Encode(reinterpret_cast<const char *>(values.data()), sizeof(char *),
+                std::vector<bool>(kNumSlots, true));
+  EXPECT_EQ(storage::FrozenColumn::Encoding::DICTIONARY, column.GetEncoding());
+
+  // The values are copied into the new pool
+  type::EphemeralPool decoded_pool;
+  std::vector<char *> decoded(kNumSlots);
+  column.Decode(reinterpret_cast<char *>(decoded.data()), sizeof(char *),
+                &decoded_pool);
+  for (oid_t i = 0; i < kNumSlots; i++) {
+    auto expected = type::Value::DeserializeFrom(
+        reinterpret_cast<const char *>(&values[i]), type::TypeId::VARCHAR,
+        false);
+    auto actual = type::Value::DeserializeFrom(
+        reinterpret_cast<const char *>(&decoded[i]), type::TypeId::VARCHAR,
+        false);
+    EXPECT_EQ(expected.IsNull(), actual.IsNull());
+    if (!expected.IsNull()) {
+      EXPECT_NE(values[i], decoded[i]);
+      EXPECT_EQ(CmpBool::CmpTrue, expected.CompareEquals(actual));
+    }
+  }
+}
+
+TEST_F(FrozenColumnTests, FreezeTileGroupTest) {
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(5, false, 1));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), 5, false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = table->GetTileGroup(0);
+  oid_t num_columns = table->GetSchema()->GetColumnCount();
+  std::vector<type::Value> values;
+  for (oid_t slot = 0; slot < 5; slot++) {
+    for (oid_t col = 0; col < num_columns; col++) {
+      values.push_back(tile_group->GetValue(slot, col));
+    }
+  }
+
+  tile_group->GetHeader()->SetImmutability();
+  EXPECT_TRUE(tile_group->Freeze());
+  EXPECT_FALSE(tile_group->Freeze());
+  EXPECT_TRUE(tile_group->IsFrozen());
+
+  std::vector<storage::RetiredTileData> retired;
+  EXPECT_FALSE(tile_group->ClearAccessed());
+  tile_group->ReleaseTupleData(retired);
+  EXPECT_EQ(tile_group->NumTiles(), retired.size());
+
+  // Reading the tuples decompresses them
+  for (oid_t slot = 0; slot < 5; slot++) {
+    for (oid_t col = 0; col < num_columns; col++) {
+      const auto &expected = values[slot * num_columns + col];
+      EXPECT_EQ(CmpBool::CmpTrue,
+                expected.CompareEquals(tile_group->GetValue(slot, col)));
+    }
+  }
+
+  // The freezer keeps the decompressed tuples for another pass
+  EXPECT_TRUE(tile_group->ClearAccessed());
+  EXPECT_FALSE(tile_group->ClearAccessed());
+
+  // Column A holds 0, 10, .., 40
+  storage::PredicateRange present{0, 10, 10};
+  EXPECT_TRUE(tile_group->ShouldScanFrozen(&present, 1));
+
+  for (auto &tile_data : retired) {
+    delete[] tile_data.data;
+    delete tile_data.pool;
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor_test.cpp
+//
+// Identification: test/storage/tile_group_compactor_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
+#include "executor/testing_executor_util.h"
+#include "gc/transaction_level_gc_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_compactor.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+class TileGroupCompactorTests : public PelotonTest {};
+
+namespace {
+
+ResultType DeleteTuple(storage::DataTable *table, const int key) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  TransactionScheduler scheduler(1, table, &txn_manager);
+  scheduler.Txn(0).Delete(key);
+  scheduler.Txn(0).Commit();
+  scheduler.Run();
+  return scheduler.schedules[0].txn_result;
+}
+
+int SelectTuple(storage::DataTable *table, const int key) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  TransactionScheduler scheduler(1, table, &txn_manager);
+  scheduler.Txn(0).Read(key);
+  scheduler.Txn(0).Commit();
+  scheduler.Run();
+  EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[0].txn_result);
+  return scheduler.schedules[0].results[0];
+}
+
+// Unlink and reclaim all garbage, moving to the epoch after next
+void CollectGarbage(eid_t &epoch_id) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  epoch_manager.SetCurrentEpochId(++epoch_id);
+  gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId());
+  epoch_manager.SetCurrentEpochId(++epoch_id);
+  gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId());
+}
+
+}  // namespace
+
+TEST_F(TileGroupCompactorTests, CompactTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+  eid_t epoch_id = 1;
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  auto database = TestingExecutorUtil::InitializeDatabase("compactiondb");
+  oid_t db_id = database->GetOid();
+
+  // Keys 0 to 19 fill the first four tile groups
+  const int num_key = 20;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE0", db_id, 12349, 1234, true, tuples_per_tilegroup));
+  auto tile_group = table->GetTileGroup(0);
+
+  // Leave one tuple in each of the first two tile groups
+  for (int key = 0; key < 10; key++) {
+    if (key % 5 != 4) {
+      EXPECT_EQ(ResultType::SUCCESS, DeleteTuple(table.get(), key));
+    }
+  }
+  CollectGarbage(epoch_id);
+
+  // The sparse tile groups are set aside first
+  auto &compactor = storage::TileGroupCompactor::GetInstance();
+  compactor.CompactTileGroups();
+  EXPECT_TRUE(tile_group->GetHeader()->GetImmutability());
+  EXPECT_TRUE(table->GetTileGroup(0) != nullptr);
+  EXPECT_FALSE(table->GetTileGroup(2)->GetHeader()->GetImmutability());
+
+  // Their tuples are moved once the transactions running then finished
+  epoch_manager.SetCurrentEpochId(++epoch_id);
+  epoch_manager.GetExpiredEpochId();
+  compactor.CompactTileGroups();
+  EXPECT_NE(MAX_CID, tile_group->GetHeader()->GetEndCommitId(4));
+  EXPECT_TRUE(table->GetTileGroup(0) != nullptr);
+
+  // And they are dropped once the old versions are reclaimed
+  CollectGarbage(epoch_id);
+  compactor.CompactTileGroups();
+  EXPECT_TRUE(table->GetTileGroup(0) == nullptr);
+  EXPECT_TRUE(table->GetTileGroup(1) == nullptr);
+  EXPECT_TRUE(table->GetTileGroup(2) != nullptr);
+
+  // The moved tuples are still found through the index
+  for (int key = 0; key < num_key; key++) {
+    if (key < 10 && key % 5 != 4) {
+      EXPECT_EQ(-1, SelectTuple(table.get(), key));
+    } else {
+      EXPECT_EQ(0, SelectTuple(table.get(), key));
+    }
+  }
+
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  TestingExecutorUtil::DeleteDatabase("compactiondb");
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -13,6 +13,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <atomic>
+#include <limits>
+#include <thread>
 #include "common/harness.h"
 
 #include "storage/data_table.h"
@@ -23,6 +26,7 @@
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 #include "storage/zone_map_manager.h"
 #include "catalog/schema.h"
 #include "catalog/catalog.h"
@@ -105,7 +109,7 @@ namespace {
    // Artwork on Sublime Text. Dated 12/08/2017 by Anonymous.
 */
 
-storage::DataTable *CreateTestTable() {
+storage::DataTable *CreatePopulatedTable() {
   std::unique_ptr<storage::DataTable> data_table(
       TestingExecutorUtil::CreateTable(5, false, 1));
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
@@ -113,6 +117,12 @@ storage::DataTable *CreateTestTable() {
   TestingExecutorUtil::PopulateTable(data_table.get(), 20, false, false, false,
                                      txn);
   txn_manager.CommitTransaction(txn);
+  return data_table.release();
+}
+
+storage::DataTable *CreateTestTable() {
+  std::unique_ptr<storage::DataTable> data_table(CreatePopulatedTable());
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   oid_t num_tile_groups = (data_table.get())->GetTileGroupCount();
   for (oid_t i = 0; i < num_tile_groups - 1; i++) {
     auto tile_group = (data_table.get())->GetTileGroup(i);
@@ -125,7 +135,7 @@ storage::DataTable *CreateTestTable() {
   storage::ZoneMapManager *zone_map_manager =
       storage::ZoneMapManager::GetInstance();
   zone_map_manager->CreateZoneMapTableInCatalog();
-  txn = txn_manager.BeginTransaction();
+  auto txn = txn_manager.BeginTransaction();
   zone_map_manager->CreateZoneMapsForTable((data_table.get()), txn);
   txn_manager.CommitTransaction(txn);
   return data_table.release();
@@ -418,6 +428,145 @@ TEST_F(ZoneMapTests, ZoneMapMultiColumnConjunctionPredicateTest) {
   pred4->ClearParsedPredicates();
   delete conj_pred;
 }
+
+TEST_F(ZoneMapTests, InMemoryZoneMapContentsTest) {
+  // The zone maps are kept up to date by the inserts, without the catalog
+  std::unique_ptr<storage::DataTable> data_table(CreatePopulatedTable());
+  oid_t num_tile_groups = data_table->GetTileGroupCount();
+  for (oid_t i = 0; i < num_tile_groups - 1; i++) {
+    auto *zone_map = data_table->GetTileGroup(i)->GetZoneMap();
+    int min = i * 50;
+    int max = i * 50 + 40;
+    EXPECT_EQ(min, zone_map->GetMinValue(0).GetAs<int>());
+    EXPECT_EQ(max, zone_map->GetMaxValue(0).GetAs<int>());
+    EXPECT_EQ(min + 1, zone_map->GetMinValue(1).GetAs<int>());
+    EXPECT_EQ(max + 1, zone_map->GetMaxValue(1).GetAs<int>());
+    EXPECT_EQ((double)(min + 2), zone_map->GetMinValue(2).GetAs<double>());
+    EXPECT_EQ((double)(max + 2), zone_map->GetMaxValue(2).GetAs<double>());
+    EXPECT_FALSE(zone_map->IsTracked(3));
+  }
+
+  // The last tile group hasn't seen any tuples
+  auto *last_zone_map =
+      data_table->GetTileGroup(num_tile_groups - 1)->GetZoneMap();
+  EXPECT_TRUE(last_zone_map->IsEmpty(0));
+}
+
+TEST_F(ZoneMapTests, InMemoryZoneMapMaintenanceTest) {
+  // Predicate A > 500
+  std::unique_ptr<storage::DataTable> data_table(CreatePopulatedTable());
+  auto constant_value = type::ValueFactory::GetIntegerValue(500);
+  auto pred = CreateSinglePredicate(0, ExpressionType::COMPARE_GREATERTHAN,
+                                    constant_value);
+  EXPECT_TRUE(pred->IsZoneMappable());
+  auto parsed_predicates = pred->GetParsedPredicates();
+  auto temp = (std::vector<storage::PredicateInfo> *)parsed_predicates;
+  storage::ZoneMapManager *zone_map_manager =
+      storage::ZoneMapManager::GetInstance();
+  oid_t num_tile_groups = data_table->GetTileGroupCount();
+  auto should_scan = [&](oid_t tile_group_idx) {
+    return zone_map_manager->ShouldScanTileGroup(temp->data(), 1,
+                                                 data_table.get(),
+                                                 tile_group_idx);
+  };
+  for (oid_t i = 0; i < num_tile_groups; i++) {
+    EXPECT_FALSE(should_scan(i));
+  }
+
+  // Overwriting a value widens the zone map of its tile group
+  auto tile_group = data_table->GetTileGroup(1);
+  auto large_value = type::ValueFactory::GetIntegerValue(1000);
+  tile_group->SetValue(large_value, 0, 0);
+  for (oid_t i = 0; i < num_tile_groups; i++) {
+    EXPECT_EQ(i == 1, should_scan(i));
+  }
+
+  // Zone maps are never narrowed by writes ...
+  auto small_value = type::ValueFactory::GetIntegerValue(50);
+  tile_group->SetValue(small_value, 0, 0);
+  EXPECT_TRUE(should_scan(1));
+
+  // ... nor once their tile group is made immutable, as writers that got a
+  // slot before may still widen them ...
+  tile_group->GetHeader()->SetImmutability();
+  EXPECT_TRUE(should_scan(1));
+
+  // ... but are rebuilt once it is frozen
+  EXPECT_TRUE(tile_group->Freeze());
+  EXPECT_FALSE(should_scan(1));
+  EXPECT_EQ(50, tile_group->GetZoneMap()->GetMinValue(0).GetAs<int>());
+
+  pred->ClearParsedPredicates();
+  delete pred;
+}
+
+TEST_F(ZoneMapTests, InMemoryZoneMapConcurrentUpdateTest) {
+  std::unique_ptr<storage::DataTable> data_table(CreatePopulatedTable());
+  auto tile_group = data_table->GetTileGroup(1);
+  auto *zone_map = tile_group->GetZoneMap();
+
+  // Writers of different slots widen the range of the column concurrently,
+  // none of the extremes they write may get lost
+  const int num_threads = 4;
+  const int num_writes = 1000;
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back([&tile_group, thread_id] {
+      for (int i = 0; i < num_writes; i++) {
+        int val = (thread_id * num_writes + i) * (i % 2 == 0 ? -1 : 1);
+        auto value = type::ValueFactory::GetIntegerValue(val);
+        tile_group->SetValue(value, thread_id, 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(-((num_threads - 1) * num_writes + num_writes - 2),
+            zone_map->GetMinValue(0).GetAs<int>());
+  EXPECT_EQ((num_threads - 1) * num_writes + num_writes - 1,
+            zone_map->GetMaxValue(0).GetAs<int>());
+
+  // The other columns are left alone
+  EXPECT_EQ(51, zone_map->GetMinValue(1).GetAs<int>());
+  EXPECT_EQ(91, zone_map->GetMaxValue(1).GetAs<int>());
+}
+
+TEST_F(ZoneMapTests, InMemoryZoneMapRebuildRaceTest) {
+  std::unique_ptr<storage::DataTable> data_table(CreatePopulatedTable());
+  auto tile_group = data_table->GetTileGroup(1);
+  auto *zone_map = tile_group->GetZoneMap();
+
+  // A writer that got its slot before the tile group was made immutable keeps
+  // widening the range while scans check it, which must not narrow it
+  tile_group->GetHeader()->SetImmutability();
+  const int num_writes = 1000;
+  std::atomic<bool> done(false);
+  std::thread writer([&tile_group, &done] {
+    for (int i = 0; i < num_writes; i++) {
+      auto value = type::ValueFactory::GetIntegerValue(1000 + i);
+      tile_group->SetValue(value, 0, 0);
+    }
+    done = true;
+  });
+  storage::PredicateRange range{0, 1000 + num_writes - 1,
+                                std::numeric_limits<int64_t>::max()};
+  while (!done) {
+    zone_map->ShouldScan(&range, 1);
+  }
+  writer.join();
+
+  EXPECT_TRUE(zone_map->ShouldScan(&range, 1));
+  EXPECT_EQ(1000 + num_writes - 1, zone_map->GetMaxValue(0).GetAs<int>());
+
+  // Once frozen, the range holds exactly the values left in the tile group
+  EXPECT_TRUE(tile_group->Freeze());
+  EXPECT_TRUE(zone_map->ShouldScan(&range, 1));
+  EXPECT_EQ(1000 + num_writes - 1, zone_map->GetMaxValue(0).GetAs<int>());
+  EXPECT_EQ(60, zone_map->GetMinValue(0).GetAs<int>());
+}
+
 }
 }  // End test namespace
 }  // End peloton namespace
\ No newline at end of file
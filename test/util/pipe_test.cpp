@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// pipe_test.cpp
+//
+// Identification: test/util/pipe_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <thread>
+
+#include "common/harness.h"
+#include "util/pipe.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Pipe Tests
+//===--------------------------------------------------------------------===//
+
+class PipeTests : public PelotonTest {};
+
+TEST_F(PipeTests, ReadWriteTest) {
+  util::Pipe pipe;
+  EXPECT_TRUE(pipe.Write("1,abc\n", 6));
+  EXPECT_TRUE(pipe.Write("2,", 2));
+  EXPECT_TRUE(pipe.Write("def\n", 4));
+  pipe.Close();
+
+  // Reads span the writes
+  char buf[8];
+  EXPECT_EQ(8u, pipe.Read(buf, sizeof(buf)));
+  EXPECT_EQ("1,abc\n2,", std::string(buf, 8));
+  EXPECT_EQ(4u, pipe.Read(buf, sizeof(buf)));
+  EXPECT_EQ("def\n", std::string(buf, 4));
+
+  // The end of the data
+  EXPECT_EQ(0u, pipe.Read(buf, sizeof(buf)));
+}
+
+TEST_F(PipeTests, CapacityTest) {
+  util::Pipe pipe(10);
+  int num_callbacks = 0;
+  pipe.SetRoomCallback([&num_callbacks] { num_callbacks++; });
+
+  EXPECT_TRUE(pipe.Write("12345", 5));
+  EXPECT_FALSE(pipe.Write("67890", 5));
+  EXPECT_FALSE(pipe.HasRoom());
+
+  // Draining the pipe below its capacity lets the writer go on, once
+  char buf[4];
+  EXPECT_EQ(4u, pipe.Read(buf, sizeof(buf)));
+  EXPECT_TRUE(pipe.HasRoom());
+  EXPECT_EQ(1, num_callbacks);
+  EXPECT_EQ(4u, pipe.Read(buf, sizeof(buf)));
+  EXPECT_EQ(1, num_callbacks);
+}
+
+TEST_F(PipeTests, ThreadTest) {
+  util::Pipe pipe(64);
+  const std::string line = "0123456789\n";
+  const int num_lines = 1000;
+
+  // The reader waits for the data
+  std::string data;
+  std::thread reader([&pipe, &data] {
+    char buf[100];
+    while (uint64_t n = pipe.Read(buf, sizeof(buf))) {
+      data.append(buf, n);
+    }
+  });
+
+  for (int i = 0; i < num_lines; i++) {
+    pipe.Write(line.data(), line.size());
+  }
+  pipe.Close();
+  reader.join();
+
+  EXPECT_EQ(line.size() * num_lines, data.size());
+}
+
+TEST_F(PipeTests, FailTest) {
+  util::Pipe pipe;
+  pipe.Write("1,abc\n", 6);
+  pipe.Fail("the client gave up");
+
+  char buf[8];
+  EXPECT_THROW(pipe.Read(buf, sizeof(buf)), Exception);
+}
+
+}  // namespace test
+}  // namespace peloton